@@ -1,5 +1,8 @@
 #include "yarchive.h"
 
+#include <library/cpp/blockcodecs/codecs.h>
+
+#include <util/generic/buffer.h>
 #include <util/generic/algorithm.h>
 #include <util/generic/hash.h>
 #include <util/generic/utility.h>
@@ -13,8 +16,24 @@
 #include <util/stream/output.h>
 #include <util/stream/zlib.h>
 #include <util/system/byteorder.h>
+#include <util/system/event.h>
+#include <util/system/guard.h>
+#include <util/system/spinlock.h>
+#include <util/thread/pool.h>
 #include <util/ysaveload.h>
 
+#include <atomic>
+#include <exception>
+
+/*
+ * Dictionary of block compressed archives starts with BlockFormatMarker instead of records count,
+ * followed by format version, codec name and block size. Each record is followed by its raw length
+ * and packed sizes of its blocks, so any block can be located without decompressing the others.
+ */
+static constexpr ui32 BlockFormatMarker = Max<ui32>();
+static constexpr ui32 BlockFormatVersion = 1;
+static constexpr size_t MaxBlockSize = 1 << 30;
+
 template <class T>
 static inline void ESSave(IOutputStream* out, const T& t_in) {
     T t = HostToLittle(t_in);
@@ -76,6 +95,15 @@ namespace {
         {
         }
 
+        inline TArchiveRecordDescriptor(const TArchiveRecordDescriptor& other, const TString& name)
+            : Off_(other.Off_)
+            , Len_(other.Len_)
+            , Name_(name)
+            , RawLen_(other.RawLen_)
+            , BlockEnds_(other.BlockEnds_)
+        {
+        }
+
         inline ~TArchiveRecordDescriptor() = default;
 
         inline void SaveTo(IOutputStream* out) const {
@@ -96,42 +124,144 @@ namespace {
             return Off_;
         }
 
+        // block compressed records only
+        inline void SaveBlockIndexTo(IOutputStream* out) const {
+            ESSave(out, RawLen_);
+
+            for (size_t i = 0; i < BlockEnds_.size(); ++i) {
+                ESSave(out, static_cast<ui32>(BlockEnd(i) - BlockBegin(i)));
+            }
+        }
+
+        inline void LoadBlockIndex(IInputStream* in, ui64 blockSize) {
+            RawLen_ = ESLoad<ui64>(in);
+            BlockEnds_.resize(RawLen_ / blockSize + (RawLen_ % blockSize != 0));
+
+            ui64 end = 0;
+            for (auto& blockEnd : BlockEnds_) {
+                end += ESLoad<ui32>(in);
+                blockEnd = end;
+            }
+
+            if (end != Len_) {
+                ythrow TSerializeException() << "malformed archive";
+            }
+        }
+
+        inline void AddRawLength(ui64 len) noexcept {
+            RawLen_ += len;
+        }
+
+        // blocks are written right after each other, offset is taken from the first one
+        inline void AddBlock(ui64 off, ui64 len) noexcept {
+            if (BlockEnds_.empty()) {
+                Off_ = off;
+            }
+
+            Len_ += len;
+            BlockEnds_.push_back(Len_);
+        }
+
+        inline ui64 RawLength() const noexcept {
+            return RawLen_;
+        }
+
+        inline size_t BlockCount() const noexcept {
+            return BlockEnds_.size();
+        }
+
+        inline ui64 BlockBegin(size_t block) const noexcept {
+            return block ? BlockEnds_[block - 1] : 0;
+        }
+
+        inline ui64 BlockEnd(size_t block) const noexcept {
+            return BlockEnds_[block];
+        }
+
     private:
         ui64 Off_;
         ui64 Len_;
         TString Name_;
+        ui64 RawLen_ = 0;
+        TVector<ui64> BlockEnds_;
     };
 
     typedef TIntrusivePtr<TArchiveRecordDescriptor> TArchiveRecordDescriptorRef;
+
+    // data is a packed record, dst must have room for the whole block
+    size_t DecompressBlock(const NBlockCodecs::ICodec* codec, ui64 blockSize, const TArchiveRecordDescriptor& descr, TStringBuf data, size_t block, void* dst) {
+        const size_t len = Min<ui64>(blockSize, descr.RawLength() - block * blockSize);
+        const TStringBuf packed = data.SubStr(descr.BlockBegin(block), descr.BlockEnd(block) - descr.BlockBegin(block));
+
+        Y_ENSURE(codec->DecompressedLength(packed) == len, "malformed archive block");
+        codec->Decompress(packed, dst);
+
+        return len;
+    }
 }
 
 class TArchiveWriter::TImpl {
     using TDict = THashMap<TString, TArchiveRecordDescriptorRef>;
 
+    struct TPendingBlock {
+        TArchiveRecordDescriptorRef Descr;
+        TBuffer Raw;
+        TBuffer Packed;
+    };
+
 public:
-    inline TImpl(IOutputStream& out, bool compress)
+    inline TImpl(IOutputStream& out, const TArchiveWriterOptions& options)
         : Off_(0)
         , Out_(&out)
-        , UseCompression(compress)
+        , UseCompression(options.Compress)
+        , Options_(options)
     {
+        Y_ENSURE(Options_.DataAlignment, "zero data alignment");
+
+        if (UseCompression && Options_.Codec) {
+            Y_ENSURE(Options_.BlockSize && Options_.BlockSize <= MaxBlockSize, "bad block size " << Options_.BlockSize);
+
+            Codec_ = NBlockCodecs::Codec(Options_.Codec);
+            // a couple of blocks per thread, so that input reading overlaps with compression
+            Batch_.resize(2 * Max<size_t>(Options_.ThreadCount, 1));
+
+            if (Options_.ThreadCount > 1) {
+                Pool_ = MakeHolder<TThreadPool>();
+                Pool_->Start(Options_.ThreadCount - 1);
+            }
+        }
     }
 
     inline ~TImpl() = default;
 
     inline void Flush() {
+        FlushBlocks();
         Out_->Flush();
     }
 
     inline void Finish() {
+        FlushBlocks();
+
         TCountingOutput out(Out_);
 
         {
             TZLibCompress compress(&out);
 
+            if (Codec_) {
+                ESSave(&compress, BlockFormatMarker);
+                ESSave(&compress, BlockFormatVersion);
+                ESSave(&compress, TString(Codec_->Name()));
+                ESSave(&compress, static_cast<ui64>(Options_.BlockSize));
+            }
+
             ESSave(&compress, (ui32)Dict_.size());
 
             for (const auto& kv : Dict_) {
                 kv.second->SaveTo(&compress);
+
+                if (Codec_) {
+                    kv.second->SaveBlockIndexTo(&compress);
+                }
             }
 
             ESSave(&compress, static_cast<ui8>(UseCompression));
@@ -147,20 +277,27 @@ public:
     inline void Add(const TString& key, IInputStream* src) {
         Y_ENSURE(!Dict_.contains(key), "key " << key.data() << " already stored");
 
+        if (Codec_) {
+            AddBlocks(key, src);
+            return;
+        }
+
         TCountingOutput out(Out_);
         if (UseCompression) {
             TZLibCompress compress(&out);
             TransferData(src, &compress);
             compress.Finish();
         } else {
-            size_t skip_size = ArchiveWriterDefaultDataAlignment - Off_ % ArchiveWriterDefaultDataAlignment;
-            if (skip_size == ArchiveWriterDefaultDataAlignment) {
+            size_t skip_size = Options_.DataAlignment - Off_ % Options_.DataAlignment;
+            if (skip_size == Options_.DataAlignment) {
                 skip_size = 0;
             }
+            static const char zeros[4096] = {};
             while(skip_size > 0) {
-                Out_->Write(char(0));
-                Off_ += 1;
-                skip_size -= 1;
+                const size_t len = Min(skip_size, sizeof(zeros));
+                Out_->Write(zeros, len);
+                Off_ += len;
+                skip_size -= len;
             }
             TransferData(src, &out);
             out.Finish();
@@ -176,21 +313,156 @@ public:
         Y_ENSURE(Dict_.contains(existingKey), "key " << existingKey.data() << " not stored yet");
         Y_ENSURE(!Dict_.contains(newKey), "key " << newKey.data() << " already stored");
 
+        // blocks of the existing record may be still pending
+        FlushBlocks();
+
         TArchiveRecordDescriptorRef existingDescr = Dict_[existingKey];
-        TArchiveRecordDescriptorRef descr(new TArchiveRecordDescriptor(existingDescr->Offset(), existingDescr->Length(), newKey));
+        TArchiveRecordDescriptorRef descr(new TArchiveRecordDescriptor(*existingDescr, newKey));
 
         Dict_[newKey] = descr;
     }
 
+private:
+    inline void AddBlocks(const TString& key, IInputStream* src) {
+        TArchiveRecordDescriptorRef descr(new TArchiveRecordDescriptor(Off_, 0, key));
+
+        for (size_t len = Options_.BlockSize; len == Options_.BlockSize;) {
+            TPendingBlock& block = Batch_[BatchSize_];
+
+            block.Raw.Resize(Options_.BlockSize);
+            len = src->Load(block.Raw.Data(), Options_.BlockSize);
+
+            if (!len) {
+                break;
+            }
+
+            block.Raw.Resize(len);
+            block.Descr = descr;
+            descr->AddRawLength(len);
+
+            if (++BatchSize_ == Batch_.size()) {
+                FlushBlocks();
+            }
+        }
+
+        if (!descr->RawLength()) {
+            // nothing is written for empty record, so its offset must not be taken before pending blocks
+            FlushBlocks();
+            descr.Reset(new TArchiveRecordDescriptor(Off_, 0, key));
+        }
+
+        Dict_[key] = descr;
+    }
+
+    // compresses pending blocks in parallel and writes them in order
+    inline void FlushBlocks() {
+        if (!BatchSize_) {
+            return;
+        }
+
+        ParallelFor(BatchSize_, [this](size_t i) {
+            TPendingBlock& block = Batch_[i];
+
+            block.Packed.Resize(Codec_->MaxCompressedLength(block.Raw));
+            block.Packed.Resize(Codec_->Compress(block.Raw, block.Packed.Data()));
+        });
+
+        for (size_t i = 0; i < BatchSize_; ++i) {
+            TPendingBlock& block = Batch_[i];
+
+            Out_->Write(block.Packed.Data(), block.Packed.Size());
+            block.Descr->AddBlock(Off_, block.Packed.Size());
+            block.Descr.Drop();
+            Off_ += block.Packed.Size();
+        }
+
+        BatchSize_ = 0;
+    }
+
+    // calling thread takes part in the work, so ThreadCount - 1 pool threads are enough
+    template <class F>
+    inline void ParallelFor(size_t count, F&& f) {
+        std::atomic<size_t> next = 0;
+        std::exception_ptr error;
+        TAdaptiveLock errorLock;
+        auto setError = [&]() {
+            with_lock (errorLock) {
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        };
+        auto work = [&]() {
+            try {
+                for (size_t i = next++; i < count; i = next++) {
+                    f(i);
+                }
+            } catch (...) {
+                setError();
+            }
+        };
+
+        const size_t helpers = Pool_ ? Min(count, Options_.ThreadCount) - 1 : 0;
+        std::atomic<size_t> running = helpers;
+        TManualEvent done;
+
+        size_t queued = 0;
+        try {
+            for (; queued < helpers; ++queued) {
+                Pool_->SafeAddFunc([&]() {
+                    work();
+
+                    if (--running == 0) {
+                        done.Signal();
+                    }
+                });
+            }
+        } catch (...) {
+            // queued tasks refer to this frame, so they are stopped and waited for before the rethrow
+            setError();
+            next = count;
+            const size_t failed = helpers - queued;
+            if (running.fetch_sub(failed) == failed) {
+                done.Signal();
+            }
+        }
+
+        work();
+
+        if (helpers) {
+            done.WaitI();
+        }
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
 private:
     ui64 Off_;
     IOutputStream* Out_;
     TDict Dict_;
     const bool UseCompression;
+    const TArchiveWriterOptions Options_;
+    const NBlockCodecs::ICodec* Codec_ = nullptr;
+    TVector<TPendingBlock> Batch_;
+    size_t BatchSize_ = 0;
+    THolder<IThreadPool> Pool_;
 };
 
+static TArchiveWriterOptions CompressOptions(bool compress) {
+    TArchiveWriterOptions options;
+    options.Compress = compress;
+    return options;
+}
+
 TArchiveWriter::TArchiveWriter(IOutputStream* out, bool compress)
-    : Impl_(new TImpl(*out, compress))
+    : Impl_(new TImpl(*out, CompressOptions(compress)))
+{
+}
+
+TArchiveWriter::TArchiveWriter(IOutputStream* out, const TArchiveWriterOptions& options)
+    : Impl_(new TImpl(*out, options))
 {
 }
 
@@ -250,6 +522,46 @@ namespace {
 
         ~TArchiveInputStream() override = default;
     };
+
+    // decompresses blocks one by one as they are read
+    class TArchiveBlockInputStream: public IInputStream {
+    public:
+        inline TArchiveBlockInputStream(const TBlob& b, TArchiveRecordDescriptorRef descr, const NBlockCodecs::ICodec* codec, ui64 blockSize)
+            : Blob_(b)
+            , Descr_(std::move(descr))
+            , Codec_(codec)
+            , BlockSize_(blockSize)
+        {
+        }
+
+    private:
+        size_t DoRead(void* buf, size_t len) override {
+            while (Pos_ == Block_.Size()) {
+                if (NextBlock_ == Descr_->BlockCount()) {
+                    return 0;
+                }
+
+                Block_.Resize(BlockSize_);
+                Block_.Resize(DecompressBlock(Codec_, BlockSize_, *Descr_, TStringBuf(Blob_.AsCharPtr(), Blob_.Size()), NextBlock_++, Block_.Data()));
+                Pos_ = 0;
+            }
+
+            len = Min(len, Block_.Size() - Pos_);
+            memcpy(buf, Block_.Data() + Pos_, len);
+            Pos_ += len;
+
+            return len;
+        }
+
+    private:
+        TBlob Blob_;
+        TArchiveRecordDescriptorRef Descr_;
+        const NBlockCodecs::ICodec* Codec_;
+        const ui64 BlockSize_;
+        TBuffer Block_;
+        size_t Pos_ = 0;
+        size_t NextBlock_ = 0;
+    };
 }
 
 class TArchiveReader::TImpl {
@@ -279,11 +591,26 @@ public:
         const char* beg = ptr - dictlen;
         TMemoryInput mi(beg, dictlen);
         TZLibDecompress d(&mi);
-        const ui32 count = ESLoad<ui32>(&d);
+        ui32 count = ESLoad<ui32>(&d);
+
+        if (count == BlockFormatMarker) {
+            const ui32 version = ESLoad<ui32>(&d);
+            Y_ENSURE(version == BlockFormatVersion, "unsupported archive version " << version);
+
+            Codec_ = NBlockCodecs::Codec(ESLoad<TString>(&d));
+            BlockSize_ = ESLoad<ui64>(&d);
+            Y_ENSURE(BlockSize_ && BlockSize_ <= MaxBlockSize, "bad block size " << BlockSize_);
+
+            count = ESLoad<ui32>(&d);
+        }
 
         for (size_t i = 0; i < count; ++i) {
             TArchiveRecordDescriptorRef descr(new TArchiveRecordDescriptor(&d));
 
+            if (Codec_) {
+                descr->LoadBlockIndex(&d, BlockSize_);
+            }
+
             Recs_.push_back(descr);
             Dict_[descr->Name()] = descr;
         }
@@ -318,7 +645,9 @@ public:
     inline TAutoPtr<IInputStream> ObjectByKey(const TStringBuf key) const {
         TBlob subBlob = BlobByKey(key);
 
-        if (UseDecompression) {
+        if (Codec_) {
+            return new TArchiveBlockInputStream(subBlob, Record(key), Codec_, BlockSize_);
+        } else if (UseDecompression) {
             return new TArchiveInputStream(subBlob);
         } else {
             return new TMemoryInput(subBlob.Data(), subBlob.Length());
@@ -328,7 +657,16 @@ public:
     inline TBlob ObjectBlobByKey(const TStringBuf key) const {
         TBlob subBlob = BlobByKey(key);
 
-        if (UseDecompression) {
+        if (Codec_) {
+            const TArchiveRecordDescriptor& descr = *Record(key);
+            TBuffer buf(descr.RawLength());
+
+            for (size_t i = 0; i < descr.BlockCount(); ++i) {
+                buf.Advance(DecompressBlock(Codec_, BlockSize_, descr, TStringBuf(subBlob.AsCharPtr(), subBlob.Size()), i, buf.Pos()));
+            }
+
+            return TBlob::FromBuffer(buf);
+        } else if (UseDecompression) {
             TArchiveInputStream st(subBlob);
             return TBlob::FromStream(st);
         } else {
@@ -336,13 +674,47 @@ public:
         }
     }
 
-    inline TBlob BlobByKey(const TStringBuf key) const {
-        const auto it = Dict_.find(key);
+    inline TBlob ObjectRangeByKey(const TStringBuf key, ui64 offset, size_t length) const {
+        TBlob subBlob = BlobByKey(key);
 
-        Y_ENSURE(it != Dict_.end(), "key " << key.data() << " not found");
+        if (Codec_) {
+            const TArchiveRecordDescriptor& descr = *Record(key);
+            offset = Min(offset, descr.RawLength());
+            length = Min<ui64>(length, descr.RawLength() - offset);
+
+            TBuffer buf(length);
+            TBuffer block;
+            block.Resize(BlockSize_);
+
+            for (ui64 pos = offset; pos < offset + length;) {
+                const size_t i = pos / BlockSize_;
+                const size_t blockOffset = pos - i * BlockSize_;
+                const size_t len = Min<ui64>(DecompressBlock(Codec_, BlockSize_, descr, TStringBuf(subBlob.AsCharPtr(), subBlob.Size()), i, block.Data()) - blockOffset, offset + length - pos);
+
+                buf.Append(block.Data() + blockOffset, len);
+                pos += len;
+            }
 
-        const size_t off = it->second->Offset();
-        const size_t len = it->second->Length();
+            return TBlob::FromBuffer(buf);
+        } else if (UseDecompression) {
+            TArchiveInputStream st(subBlob);
+            st.Skip(offset);
+            TLengthLimitedInput limited(&st, length);
+
+            return TBlob::FromStream(limited);
+        } else {
+            offset = Min<ui64>(offset, subBlob.Size());
+            length = Min<ui64>(length, subBlob.Size() - offset);
+
+            return subBlob.SubBlob(offset, offset + length);
+        }
+    }
+
+    inline TBlob BlobByKey(const TStringBuf key) const {
+        const TArchiveRecordDescriptorRef& descr = Record(key);
+
+        const size_t off = descr->Offset();
+        const size_t len = descr->Length();
 
         /*
              * TODO - overflow check
@@ -355,11 +727,22 @@ public:
         return UseDecompression;
     }
 
+private:
+    inline const TArchiveRecordDescriptorRef& Record(const TStringBuf key) const {
+        const auto it = Dict_.find(key);
+
+        Y_ENSURE(it != Dict_.end(), "key " << key.data() << " not found");
+
+        return it->second;
+    }
+
 private:
     TBlob Blob_;
     TVector<TArchiveRecordDescriptorRef> Recs_;
     TDict Dict_;
     bool UseDecompression;
+    const NBlockCodecs::ICodec* Codec_ = nullptr;
+    ui64 BlockSize_ = 0;
 };
 
 TArchiveReader::TArchiveReader(const TBlob& data)
@@ -396,3 +779,7 @@ TBlob TArchiveReader::BlobByKey(const TStringBuf key) const {
 bool TArchiveReader::Compressed() const {
     return Impl_->Compressed();
 }
+
+TBlob TArchiveReader::ObjectRangeByKey(const TStringBuf key, ui64 offset, size_t length) const {
+    return Impl_->ObjectRangeByKey(key, offset, length);
+}
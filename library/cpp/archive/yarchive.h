@@ -4,6 +4,7 @@
 
 #include <util/generic/fwd.h>
 #include <util/generic/ptr.h>
+#include <util/generic/string.h>
 
 
 class IInputStream;
@@ -14,9 +15,22 @@ class TBlob;
 //noncompressed data will be stored with default alignment DEVTOOLS-4384
 static constexpr size_t ArchiveWriterDefaultDataAlignment = 16;
 
+struct TArchiveWriterOptions {
+    bool Compress = true;
+    // blockcodecs codec name (e.g. "zstd_1", "lz4"), empty keeps the legacy zlib format.
+    // With codec entries are split into BlockSize blocks compressed by ThreadCount threads,
+    // so large entries can be decompressed partially. Such archives are not readable by old readers.
+    TString Codec;
+    size_t BlockSize = 1 << 20;
+    size_t ThreadCount = 1;
+    // alignment of noncompressed entries, set to page size to mmap them without copying
+    size_t DataAlignment = ArchiveWriterDefaultDataAlignment;
+};
+
 class TArchiveWriter {
 public:
     explicit TArchiveWriter(IOutputStream* out, bool compress = true);
+    TArchiveWriter(IOutputStream* out, const TArchiveWriterOptions& options);
     ~TArchiveWriter();
 
     void Flush();
@@ -42,6 +56,10 @@ public:
     TBlob BlobByKey(TStringBuf key) const override;
     bool Compressed() const override;
 
+    // [offset, offset + length) of the object clipped to its size, block compressed archives
+    // decompress only blocks covering the range, noncompressed ones return subblob without copying
+    TBlob ObjectRangeByKey(TStringBuf key, ui64 offset, size_t length) const;
+
 private:
     class TImpl;
     THolder<TImpl> Impl_;
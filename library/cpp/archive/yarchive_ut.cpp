@@ -6,12 +6,17 @@
 #include <util/stream/file.h>
 #include <util/system/tempfile.h>
 #include <util/memory/blob.h>
+#include <util/random/fast.h>
+#include <util/stream/str.h>
 
 class TArchiveTest: public TTestBase {
     UNIT_TEST_SUITE(TArchiveTest)
     UNIT_TEST(TestCreate);
     UNIT_TEST(TestRead);
     UNIT_TEST(TestOffsetOrder);
+    UNIT_TEST(TestBlockCodec);
+    UNIT_TEST(TestAlignedPlain);
+    UNIT_TEST(TestLegacyRange);
     UNIT_TEST_SUITE_END();
 
 private:
@@ -19,6 +24,9 @@ private:
     void TestCreate();
     void TestRead();
     void TestOffsetOrder();
+    void TestBlockCodec();
+    void TestAlignedPlain();
+    void TestLegacyRange();
 };
 
 UNIT_TEST_SUITE_REGISTRATION(TArchiveTest);
@@ -82,3 +90,127 @@ void TArchiveTest::TestOffsetOrder() {
         prevOffset = offset;
     }
 }
+
+static TStringBuf AsStringBuf(const TBlob& blob) {
+    return TStringBuf(blob.AsCharPtr(), blob.Size());
+}
+
+static TString MakeData(size_t size, ui64 seed) {
+    TFastRng<ui64> rng(seed);
+    TString data;
+    for (size_t i = 0; i < size; ++i) {
+        data.push_back(i % 7 ? 'a' + (i / 100) % 26 : rng.Uniform(256));
+    }
+    return data;
+}
+
+static TString WriteArchive(const TArchiveWriterOptions& options, const TVector<TString>& objects) {
+    TStringStream out;
+    TArchiveWriter w(&out, options);
+
+    for (size_t i = 0; i < objects.size(); ++i) {
+        TStringInput si(objects[i]);
+        w.Add("/" + ToString(i), &si);
+    }
+    w.AddSynonym("/1", "/synonym");
+
+    w.Finish();
+    return out.Str();
+}
+
+void TArchiveTest::TestBlockCodec() {
+    const TVector<TString> objects = {"", MakeData(10, 1), MakeData(1000, 2), MakeData(12345, 3), "", MakeData(100000, 4)};
+    TArchiveWriterOptions options;
+    options.Codec = "zstd_1";
+    options.BlockSize = 1000;
+
+    TString archive;
+    for (size_t threads : {1, 4}) {
+        options.ThreadCount = threads;
+        const TString data = WriteArchive(options, objects);
+        UNIT_ASSERT(archive.empty() || archive == data);
+        archive = data;
+    }
+
+    { // pending blocks are written on flush
+        TStringStream out;
+        TArchiveWriter w(&out, options);
+        TStringInput si(objects[2]);
+        w.Add("/2", &si);
+        UNIT_ASSERT(out.Str().empty());
+        w.Flush();
+        UNIT_ASSERT(!out.Str().empty());
+    }
+
+    TArchiveReader r(TBlob::FromString(archive));
+    UNIT_ASSERT(r.Compressed());
+    UNIT_ASSERT_VALUES_EQUAL(r.Count(), objects.size() + 1);
+    UNIT_ASSERT_VALUES_EQUAL(AsStringBuf(r.ObjectBlobByKey("/synonym")), objects[1]);
+
+    for (size_t i = 0; i < objects.size(); ++i) {
+        const TString key = "/" + ToString(i);
+        const TString& object = objects[i];
+
+        UNIT_ASSERT_VALUES_EQUAL(r.ObjectByKey(key)->ReadAll(), object);
+        UNIT_ASSERT_VALUES_EQUAL(AsStringBuf(r.ObjectBlobByKey(key)), object);
+        UNIT_ASSERT(r.BlobByKey(key).Size() <= object.size() / 2 + 100);
+
+        for (ui64 offset : {0, 1, 999, 1000, 5555, 99999, 200000}) {
+            for (size_t length : {0, 1, 1000, 3001, 1000000}) {
+                UNIT_ASSERT_VALUES_EQUAL(AsStringBuf(r.ObjectRangeByKey(key, offset, length)), TStringBuf(object).SubStr(offset, length));
+            }
+        }
+    }
+}
+
+void TArchiveTest::TestAlignedPlain() {
+    const TVector<TString> objects = {MakeData(10, 1), "", MakeData(5000, 2), MakeData(3, 3)};
+    TArchiveWriterOptions options;
+    options.Compress = false;
+    options.Codec = "zstd_1"; // ignored without compression
+    options.DataAlignment = 4096;
+
+    {
+        TFixedBufferFileOutput out(ARCHIVE);
+        out << WriteArchive(options, objects);
+        out.Finish();
+    }
+    TTempFile tmpFile(ARCHIVE);
+    const TBlob blob = TBlob::FromFileSingleThreaded(ARCHIVE);
+    TArchiveReader r(blob);
+    UNIT_ASSERT(!r.Compressed());
+
+    for (size_t i = 0; i < objects.size(); ++i) {
+        const TString key = "/" + ToString(i);
+        const TBlob object = r.BlobByKey(key);
+
+        UNIT_ASSERT_VALUES_EQUAL(AsStringBuf(object), objects[i]);
+        UNIT_ASSERT_VALUES_EQUAL((object.AsCharPtr() - blob.AsCharPtr()) % 4096, 0);
+        UNIT_ASSERT_VALUES_EQUAL(r.ObjectByKey(key)->ReadAll(), objects[i]);
+
+        const TBlob range = r.ObjectRangeByKey(key, 2, 3000);
+        UNIT_ASSERT_VALUES_EQUAL(AsStringBuf(range), TStringBuf(objects[i]).SubStr(2, 3000));
+        UNIT_ASSERT(range.Empty() || range.AsCharPtr() == object.AsCharPtr() + 2);
+    }
+}
+
+void TArchiveTest::TestLegacyRange() {
+    const TVector<TString> objects = {MakeData(100000, 1), ""};
+    const TString archive = WriteArchive(TArchiveWriterOptions(), objects);
+    TStringStream legacy;
+    {
+        TArchiveWriter w(&legacy);
+        for (size_t i = 0; i < objects.size(); ++i) {
+            TStringInput si(objects[i]);
+            w.Add("/" + ToString(i), &si);
+        }
+        w.AddSynonym("/1", "/synonym");
+    }
+    UNIT_ASSERT_VALUES_EQUAL(archive, legacy.Str());
+
+    TArchiveReader r(TBlob::FromString(archive));
+    UNIT_ASSERT(r.Compressed());
+    UNIT_ASSERT_VALUES_EQUAL(AsStringBuf(r.ObjectRangeByKey("/0", 5000, 12345)), TStringBuf(objects[0]).SubStr(5000, 12345));
+    UNIT_ASSERT_VALUES_EQUAL(AsStringBuf(r.ObjectRangeByKey("/0", 99990, 100)), TStringBuf(objects[0]).SubStr(99990));
+    UNIT_ASSERT(r.ObjectRangeByKey("/1", 0, 100).Empty());
+}
@@ -5,6 +5,8 @@
 #include <library/cpp/testing/unittest/registar.h>
 
 #include <util/charset/utf8.h>
+#include <util/charset/wide.h>
+#include <util/generic/vector.h>
 #include <util/system/yassert.h>
 
 #if defined(_MSC_VER)
@@ -36,6 +38,7 @@ private:
     UNIT_TEST(TestUTFFromUnknownPlane);
     UNIT_TEST(TestBrokenMultibyte);
     UNIT_TEST(TestSurrogatePairs);
+    UNIT_TEST(TestLongUTFBoundaries);
     UNIT_TEST(TestEncodingHints);
     UNIT_TEST(TestToLower);
     UNIT_TEST(TestToUpper);
@@ -49,6 +52,7 @@ public:
     void TestUTFFromUnknownPlane();
     void TestBrokenMultibyte();
     void TestSurrogatePairs();
+    void TestLongUTFBoundaries();
     void TestEncodingHints();
     void TestToLower();
     void TestToUpper();
@@ -298,6 +302,142 @@ void TCodepageTest::TestSurrogatePairs() {
     TestSurrogates(utf8NonBMP2, wNonBMPDummy2, Y_ARRAY_SIZE(wNonBMPDummy2));
 }
 
+// scalar loops of RecodeToUnicode and RecodeFromUnicode for CODES_UTF8, which the vectorized prefixes must match
+template <class TCharType>
+static RECODE_RESULT RecodeFromUTF8Scalar(const char* in, TCharType* out, size_t inSize, size_t outSize, size_t& inRead, size_t& outWritten) {
+    const unsigned char* inp = (const unsigned char*)in;
+    const unsigned char* inEnd = inp + inSize;
+    TCharType* outp = out;
+    const TCharType* outEnd = out + outSize;
+    size_t runeLen;
+    wchar32 rune;
+    RECODE_RESULT res = RECODE_OK;
+    while ((res == RECODE_OK || res == RECODE_BROKENSYMBOL) && inp < inEnd && outp < outEnd) {
+        res = SafeReadUTF8Char(rune, runeLen, inp, inEnd);
+        if (res == RECODE_BROKENSYMBOL)
+            runeLen = 1;
+        if (res == RECODE_OK || res == RECODE_BROKENSYMBOL) {
+            if (!WriteSymbol(rune, outp, outEnd)) {
+                break;
+            }
+            inp += runeLen;
+        }
+    }
+    inRead = inp - (const unsigned char*)in;
+    outWritten = outp - out;
+    if ((res == RECODE_OK || res == RECODE_BROKENSYMBOL) && inRead != inSize)
+        return RECODE_EOOUTPUT;
+    return res;
+}
+
+template <class TCharType>
+static RECODE_RESULT RecodeToUTF8Scalar(const TCharType* in, char* out, size_t inSize, size_t outSize, size_t& inRead, size_t& outWritten) {
+    const TCharType* inp = in;
+    const TCharType* inEnd = in + inSize;
+    unsigned char* outp = (unsigned char*)out;
+    const unsigned char* outEnd = outp + outSize;
+    size_t runeLen;
+    wchar32 rune;
+    RECODE_RESULT res = RECODE_OK;
+    while ((res == RECODE_OK || res == RECODE_BROKENSYMBOL) && inp != inEnd) {
+        rune = ReadSymbolAndAdvance(inp, inEnd);
+        res = SafeWriteUTF8Char(rune, runeLen, outp, outEnd);
+        if (outp >= outEnd && (res == RECODE_OK || res == RECODE_BROKENSYMBOL))
+            res = RECODE_EOOUTPUT;
+        outp += runeLen;
+    }
+    inRead = inp - in;
+    outWritten = outp - (const unsigned char*)out;
+    return res;
+}
+
+// every input prefix against every output size, the output must not be touched beyond its size
+template <class TIn, class TOut, class TRecode, class TScalar>
+static void CheckAllBoundaries(const TVector<TIn>& input, size_t maxOutSize, TRecode recode, TScalar scalar) {
+    const TOut guard = TOut(0x5A);
+    for (size_t inSize = 0; inSize <= input.size(); ++inSize) {
+        for (size_t outSize = 0; outSize <= maxOutSize; ++outSize) {
+            TVector<TOut> out(outSize + 8, guard);
+            TVector<TOut> expectedOut(outSize + 8, guard);
+            size_t inRead = 0;
+            size_t outWritten = 0;
+            size_t expectedInRead = 0;
+            size_t expectedOutWritten = 0;
+            const RECODE_RESULT res = recode(input.data(), out.data(), inSize, outSize, inRead, outWritten);
+            const RECODE_RESULT expectedRes = scalar(input.data(), expectedOut.data(), inSize, outSize, expectedInRead, expectedOutWritten);
+            UNIT_ASSERT_VALUES_EQUAL_C(int(res), int(expectedRes), "in " << inSize << " out " << outSize);
+            UNIT_ASSERT_VALUES_EQUAL_C(inRead, expectedInRead, "in " << inSize << " out " << outSize);
+            UNIT_ASSERT_VALUES_EQUAL_C(outWritten, expectedOutWritten, "in " << inSize << " out " << outSize);
+            for (size_t i = 0; i < Min(outWritten, outSize); ++i) {
+                UNIT_ASSERT_VALUES_EQUAL_C(ui32(out[i]), ui32(expectedOut[i]), "in " << inSize << " out " << outSize << " at " << i);
+            }
+            for (size_t i = outSize; i < out.size(); ++i) {
+                UNIT_ASSERT_VALUES_EQUAL_C(ui32(out[i]), ui32(guard), "in " << inSize << " out " << outSize << " at " << i);
+            }
+        }
+    }
+}
+
+template <class TCharType>
+static void CheckFromUTF8Boundaries(TStringBuf utf8) {
+    const TVector<char> input(utf8.begin(), utf8.end());
+    CheckAllBoundaries<char, TCharType>(
+        input, input.size() + 2,
+        [](const char* in, TCharType* out, size_t inSize, size_t outSize, size_t& inRead, size_t& outWritten) {
+            return RecodeToUnicode(CODES_UTF8, in, out, inSize, outSize, inRead, outWritten);
+        },
+        RecodeFromUTF8Scalar<TCharType>);
+}
+
+template <class TCharType>
+static void CheckToUTF8Boundaries(const TVector<TCharType>& input) {
+    CheckAllBoundaries<TCharType, char>(
+        input, 4 * input.size() + 4,
+        [](const TCharType* in, char* out, size_t inSize, size_t outSize, size_t& inRead, size_t& outWritten) {
+            return RecodeFromUnicode(CODES_UTF8, in, out, inSize, outSize, inRead, outWritten);
+        },
+        RecodeToUTF8Scalar<TCharType>);
+}
+
+void TCodepageTest::TestLongUTFBoundaries() {
+    // longer than the vectorized blocks, multibyte sequences cross every clip point when the sizes are swept
+    const TStringBuf utf8Texts[] = {
+        "0123456789abcdef0123456789abcdef\xd0\x9f\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82xyz",
+        "ascii prefix\xe6\x96\xb0\xe9\x9a\xb6\xe4\xbd\x93\xf0\x9f\x98\x80\xf4\x80\x89\x87 tail text!!",
+        "\xf0\x9f\x98\x80\xf0\x9f\x98\x81\xf0\x9f\x98\x82\xf0\x9f\x98\x83\xf0\x9f\x98\x84 and ascii after it",
+        // broken input after a long valid prefix: stray continuation, invalid lead, truncated sequences
+        "0123456789abcdef0123456789\x80 \xff \xd0 \xe6\x96 \xf0\x9f\x98 end of text",
+        "0123456789abcdef\xd0\x9f\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82 broken tail \xe6\x96",
+    };
+    for (TStringBuf utf8 : utf8Texts) {
+        CheckFromUTF8Boundaries<wchar16>(utf8);
+        CheckFromUTF8Boundaries<wchar32>(utf8);
+    }
+
+    // surrogate pairs at various offsets, lone surrogates after a long valid prefix
+    TVector<wchar16> utf16;
+    for (size_t i = 0; i < 12; ++i) {
+        utf16.push_back('a' + i);
+    }
+    for (wchar16 c : {0x41Fu, 0x440u, 0x65B0u, 0xD83Du, 0xDE00u, 0x20u, 0xD83Du, 0xDE01u, 0x7Fu, 0x80u, 0x7FFu, 0x800u, 0xFFFFu}) {
+        utf16.push_back(c);
+    }
+    for (size_t i = 0; i < 10; ++i) {
+        utf16.push_back('0' + i);
+    }
+    CheckToUTF8Boundaries(utf16);
+    utf16.insert(utf16.begin() + 20, 0xDC00);
+    utf16.push_back(0xD800);
+    CheckToUTF8Boundaries(utf16);
+
+    TVector<wchar32> utf32(utf16.begin(), utf16.end());
+    utf32.insert(utf32.begin() + 16, 0x1F600);
+    utf32.push_back(0x10FFFF);
+    CheckToUTF8Boundaries(utf32);
+    utf32.insert(utf32.begin() + 18, 0x110000);
+    CheckToUTF8Boundaries(utf32);
+}
+
 void TCodepageTest::TestEncodingHints() {
     UNIT_ASSERT(CODES_WIN == EncodingHintByName("windows-1251"));
     UNIT_ASSERT(CODES_WIN == EncodingHintByName("Windows1251"));
@@ -4,6 +4,7 @@
 #include <util/charset/utf8.h>
 #include <util/generic/ptr.h>
 #include <util/generic/string.h>
+#include <util/generic/utility.h>
 #include <util/system/defaults.h>
 
 #include "codepage.h"
@@ -102,12 +103,31 @@ namespace NCodepagePrivate {
         return RECODE_OK;
     }
 
+    template <class TCharType, int Size = sizeof(TCharType)>
+    struct TCharTypeSwitch;
+
+    template <class TCharType>
+    struct TCharTypeSwitch<TCharType, 2> {
+        using TRealCharType = wchar16;
+    };
+
+    template <class TCharType>
+    struct TCharTypeSwitch<TCharType, 4> {
+        using TRealCharType = wchar32;
+    };
+
     template <class TCharType>
     inline RECODE_RESULT _recodeUTF8ToUnicode(const char* in, TCharType* out, size_t in_size, size_t out_size, size_t& in_readed, size_t& out_writed) {
-        const unsigned char* inp = (const unsigned char*)in;
-        const unsigned char* in_end = inp + in_size;
-        TCharType* outp = out;
-        const TCharType* out_end = outp + out_size;
+        using TRealCharType = typename TCharTypeSwitch<TCharType>::TRealCharType;
+
+        // the valid prefix which surely fits into the output is converted by the vectorized UTF8ToWide
+        size_t fast_writed = 0;
+        const size_t fast_readed = ::UTF8ToWideImpl<false>(in, Min(in_size, out_size), reinterpret_cast<TRealCharType*>(out), fast_writed);
+
+        const unsigned char* inp = (const unsigned char*)in + fast_readed;
+        const unsigned char* in_end = (const unsigned char*)in + in_size;
+        TCharType* outp = out + fast_writed;
+        const TCharType* out_end = out + out_size;
         size_t rune_len;
         wchar32 rune;
         RECODE_RESULT res = RECODE_OK;
@@ -137,7 +157,7 @@ namespace NCodepagePrivate {
         const unsigned char* inp = (const unsigned char*)in;
         const unsigned char* in_end = inp + in_size;
         TCharType* outp = out;
-        const TCharType* out_end = outp + out_size;
+        const TCharType* out_end = out + out_size;
         while (inp < in_end && outp < out_end)
             *outp++ = static_cast<TCharType>(cp->unicode[*inp++]);
         in_readed = inp - (const unsigned char*)in;
@@ -157,6 +177,14 @@ namespace NCodepagePrivate {
         wchar32 rune;
         RECODE_RESULT res = RECODE_OK;
 
+#ifdef _sse_
+        // the symbols which surely fit into the output are converted by the vectorized WideToUTF8
+        const TCharType* fast_end = in + Min(in_size, out_size / 4);
+        if (fast_end - in >= 8 && NX86::CachedHaveSSE41()) {
+            ::NDetail::WideToUTF8ImplSSE41(inp, fast_end, outp);
+        }
+#endif
+
         while ((res == RECODE_OK || res == RECODE_BROKENSYMBOL) && inp != in_end) {
             rune = ReadSymbolAndAdvance(inp, in_end);
             res = SafeWriteUTF8Char(rune, rune_len, outp, out_end);
@@ -173,19 +201,6 @@ namespace NCodepagePrivate {
         return SafeWriteUTF8Char(rune, nwritten, (unsigned char*)out, out_size);
     }
 
-    template <class TCharType, int Size = sizeof(TCharType)>
-    struct TCharTypeSwitch;
-
-    template <class TCharType>
-    struct TCharTypeSwitch<TCharType, 2> {
-        using TRealCharType = wchar16;
-    };
-
-    template <class TCharType>
-    struct TCharTypeSwitch<TCharType, 4> {
-        using TRealCharType = wchar32;
-    };
-
     template <class TCharType>
     inline RECODE_RESULT _recodeUnicodeToUTF8(const TCharType* in, char* out, size_t in_size, size_t out_size, size_t& in_readed, size_t& out_writed) {
         static_assert(sizeof(TCharType) > 1, "expect some wide type");
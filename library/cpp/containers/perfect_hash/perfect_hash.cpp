@@ -0,0 +1,126 @@
+#include "perfect_hash.h"
+
+#include <util/generic/utility.h>
+#include <util/generic/yexception.h>
+
+#include <cmath>
+
+namespace NPerfectHash {
+    namespace {
+        void SetBit(TVector<ui64>& bits, ui32 i) {
+            bits[i / 64] |= ui64(1) << (i % 64);
+        }
+
+        void ResetBit(TVector<ui64>& bits, ui32 i) {
+            bits[i / 64] &= ~(ui64(1) << (i % 64));
+        }
+
+        bool TestBit(const TVector<ui64>& bits, ui32 i) {
+            return bits[i / 64] & (ui64(1) << (i % 64));
+        }
+    }
+
+    TLayout::TLayout(ui32 size)
+        : Size(size)
+    {
+        Y_ENSURE(size < Max<ui32>() / 2, "too many keys for perfect hash: " << size);
+        TableSize = size + (size + 49) / 50;
+        const double log2Size = Max(1.0, std::log2((double)Max<ui32>(size, 1)));
+        BucketCount = Max<ui32>(2, (ui32)std::ceil(6.0 * size / log2Size));
+        DenseBuckets = Max<ui32>(1, BucketCount * 3ULL / 10);
+    }
+
+    TLayout::TLayout(ui32 size, ui32 tableSize, ui32 bucketCount)
+        : Size(size)
+        , TableSize(tableSize)
+        , BucketCount(bucketCount)
+        , DenseBuckets(Max<ui32>(1, bucketCount * 3ULL / 10))
+    {
+        Y_ENSURE(size <= tableSize && bucketCount >= 2, "bad perfect hash layout");
+    }
+
+    bool Build(TConstArrayRef<ui64> hashes, const TLayout& layout, TVector<ui32>* pilots, TVector<ui32>* remap, TVector<ui32>* slotToKey) {
+        const ui32 size = layout.GetSize();
+        const ui32 tableSize = layout.GetTableSize();
+        const ui32 bucketCount = layout.GetBucketCount();
+        Y_ENSURE(hashes.size() == size, "expect " << size << " hashes, got " << hashes.size());
+
+        // group keys by bucket
+        TVector<ui32> bucketStart(bucketCount + 1, 0);
+        for (ui64 hash : hashes)
+            ++bucketStart[layout.Bucket(hash) + 1];
+        ui32 maxBucketSize = 0;
+        for (ui32 b = 0; b < bucketCount; ++b) {
+            maxBucketSize = Max(maxBucketSize, bucketStart[b + 1]);
+            bucketStart[b + 1] += bucketStart[b];
+        }
+        TVector<ui32> keyOrder(size);
+        {
+            TVector<ui32> fill(bucketStart.begin(), bucketStart.end() - 1);
+            for (ui32 i = 0; i < size; ++i)
+                keyOrder[fill[layout.Bucket(hashes[i])]++] = i;
+        }
+
+        // biggest buckets first
+        TVector<ui32> sizeStart(maxBucketSize + 2, 0);
+        for (ui32 b = 0; b < bucketCount; ++b)
+            ++sizeStart[maxBucketSize - (bucketStart[b + 1] - bucketStart[b]) + 1];
+        for (ui32 s = 0; s <= maxBucketSize; ++s)
+            sizeStart[s + 1] += sizeStart[s];
+        TVector<ui32> bucketOrder(bucketCount);
+        for (ui32 b = 0; b < bucketCount; ++b)
+            bucketOrder[sizeStart[maxBucketSize - (bucketStart[b + 1] - bucketStart[b])]++] = b;
+
+        // the last buckets take about tableSize / (number of free positions) attempts
+        const ui64 maxPilot = Min<ui64>(Max<ui32>(), 64 * ui64(size) + (1 << 16));
+        TVector<ui64> taken((size_t(tableSize) + 63) / 64, 0);
+        TVector<ui32> positions(size);
+        pilots->assign(bucketCount, 0);
+        for (ui32 b : bucketOrder) {
+            const ui32 begin = bucketStart[b];
+            const ui32 end = bucketStart[b + 1];
+            if (begin == end)
+                break;
+            for (ui32 i = begin; i < end; ++i) {
+                for (ui32 j = i + 1; j < end; ++j)
+                    if (hashes[keyOrder[i]] == hashes[keyOrder[j]])
+                        return false;
+            }
+            ui64 pilot = 0;
+            for (; pilot < maxPilot; ++pilot) {
+                ui32 placed = 0;
+                for (; placed < end - begin; ++placed) {
+                    const ui32 key = keyOrder[begin + placed];
+                    const ui32 pos = layout.Position(hashes[key], pilot);
+                    if (TestBit(taken, pos))
+                        break;
+                    SetBit(taken, pos);
+                    positions[key] = pos;
+                }
+                if (placed == end - begin)
+                    break;
+                for (ui32 i = 0; i < placed; ++i)
+                    ResetBit(taken, positions[keyOrder[begin + i]]);
+            }
+            if (pilot == maxPilot)
+                return false;
+            (*pilots)[b] = (ui32)pilot;
+        }
+
+        // positions past the key count are moved to the holes
+        remap->assign(tableSize - size, 0);
+        for (ui32 pos = size, hole = 0; pos < tableSize; ++pos) {
+            if (!TestBit(taken, pos))
+                continue;
+            while (TestBit(taken, hole))
+                ++hole;
+            (*remap)[pos - size] = hole++;
+        }
+        slotToKey->resize(size);
+        for (ui32 i = 0; i < size; ++i) {
+            const ui32 pos = positions[i];
+            (*slotToKey)[pos < size ? pos : (*remap)[pos - size]] = i;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <util/generic/array_ref.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+namespace NPerfectHash {
+    /* Minimal perfect hash (PTHash-like) over distinct 64-bit hashes of keys. Keys are spread over skewed
+     * buckets (60% of keys go to 30% of buckets), bigger buckets first get a pilot that moves all their keys
+     * to free positions of a table 2% larger than the key count, and positions past the key count are
+     * remapped to the holes. So a lookup reads one pilot and makes exactly one probe into an array of Size
+     * slots, 2% of keys read a remapped slot index in between.
+     *
+     *     ui32 pos = layout.Position(hash, pilots[layout.Bucket(hash)]);
+     *     if (pos >= layout.GetSize())
+     *         pos = remap[pos - layout.GetSize()];
+     */
+    class TLayout {
+    public:
+        TLayout() = default;
+
+        // the layout the builder chooses for size keys
+        explicit TLayout(ui32 size);
+
+        // the layout restored from the sizes the builder chose, throws if they are inconsistent
+        TLayout(ui32 size, ui32 tableSize, ui32 bucketCount);
+
+        ui32 GetSize() const noexcept {
+            return Size;
+        }
+
+        ui32 GetTableSize() const noexcept {
+            return TableSize;
+        }
+
+        ui32 GetBucketCount() const noexcept {
+            return BucketCount;
+        }
+
+        ui32 GetRemapSize() const noexcept {
+            return TableSize - Size;
+        }
+
+        // branchless, the dense part is chosen for random 60% of keys by the high bits of the hash
+        ui32 Bucket(ui64 hash) const noexcept {
+            const ui32 sparse = ui32(0) - ui32(hash >= DENSE_KEYS_THRESHOLD);
+            const ui32 first = DenseBuckets & sparse;
+            const ui32 count = DenseBuckets + ((BucketCount - 2 * DenseBuckets) & sparse);
+            return first + FastRange(hash << 32, count);
+        }
+
+        // all 64 bits of the hash go to the position, so keys of one bucket are told apart by some pilot
+        ui32 Position(ui64 hash, ui64 pilot) const noexcept {
+            return FastRange((hash ^ (pilot * 0x9e3779b97f4a7c15ULL)) * 0xd6e8feb86659fd93ULL, TableSize);
+        }
+
+    private:
+        static constexpr ui64 DENSE_KEYS_THRESHOLD = 0x9999999999999999ULL;
+
+        static ui32 FastRange(ui64 x, ui32 range) noexcept {
+            return (ui32)(((x >> 32) * range) >> 32);
+        }
+
+        ui32 Size = 0;
+        ui32 TableSize = 0;
+        ui32 BucketCount = 0;
+        ui32 DenseBuckets = 0;
+    };
+
+    // the high half of the hash is almost independent of the bucket and the position
+    inline ui32 Fingerprint(ui64 hash) noexcept {
+        return (ui32)(hash >> 32);
+    }
+
+    constexpr ui32 MAX_SEED_CHOICE_COUNT = 10;
+
+    /* Fills layout.GetBucketCount() pilots, layout.GetRemapSize() slot indices for positions past the key
+     * count, and slotToKey, a permutation of key indices. Returns false if some hashes are equal or a pilot
+     * isn't found, then the keys should be hashed with another seed.
+     */
+    bool Build(TConstArrayRef<ui64> hashes, const TLayout& layout, TVector<ui32>* pilots, TVector<ui32>* remap, TVector<ui32>* slotToKey);
+}
@@ -0,0 +1,67 @@
+#include <library/cpp/containers/perfect_hash/perfect_hash.h>
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <util/random/fast.h>
+
+using namespace NPerfectHash;
+
+namespace {
+    ui32 Lookup(const TLayout& layout, const TVector<ui32>& pilots, const TVector<ui32>& remap, ui64 hash) {
+        ui32 pos = layout.Position(hash, pilots[layout.Bucket(hash)]);
+        if (pos >= layout.GetSize())
+            pos = remap[pos - layout.GetSize()];
+        return pos;
+    }
+
+    void CheckBuild(const TVector<ui64>& hashes) {
+        const TLayout layout(hashes.size());
+        TVector<ui32> pilots, remap, slotToKey;
+        UNIT_ASSERT(Build(hashes, layout, &pilots, &remap, &slotToKey));
+        UNIT_ASSERT_VALUES_EQUAL(pilots.size(), layout.GetBucketCount());
+        UNIT_ASSERT_VALUES_EQUAL(remap.size(), layout.GetRemapSize());
+        UNIT_ASSERT_VALUES_EQUAL(slotToKey.size(), hashes.size());
+        for (ui32 slot : remap)
+            UNIT_ASSERT(slot < hashes.size());
+        for (ui32 key = 0; key < hashes.size(); ++key)
+            UNIT_ASSERT_VALUES_EQUAL(slotToKey[Lookup(layout, pilots, remap, hashes[key])], key);
+    }
+}
+
+Y_UNIT_TEST_SUITE(TPerfectHashTest) {
+    Y_UNIT_TEST(TestBuild) {
+        TFastRng<ui64> rng(17);
+        for (size_t size : {0, 1, 2, 3, 100, 10000, 300000}) {
+            TVector<ui64> hashes;
+            for (size_t i = 0; i < size; ++i)
+                hashes.push_back(rng());
+            CheckBuild(hashes);
+        }
+    }
+
+    Y_UNIT_TEST(TestCloseHashes) {
+        // one bucket, and the high halves of the hashes multiplied by a constant are equal
+        TVector<ui64> hashes = {0x2c3dfe2e4dc6e41bULL, 0x5542a8614d3971d4ULL};
+        TFastRng<ui64> rng(17);
+        while (hashes.size() < 1000)
+            hashes.push_back(rng());
+        CheckBuild(hashes);
+    }
+
+    Y_UNIT_TEST(TestEqualHashes) {
+        const TVector<ui64> hashes = {1, 2, 3, 2};
+        TVector<ui32> pilots, remap, slotToKey;
+        UNIT_ASSERT(!Build(hashes, TLayout(hashes.size()), &pilots, &remap, &slotToKey));
+    }
+
+    Y_UNIT_TEST(TestLayout) {
+        const TLayout layout(100000);
+        const TLayout restored(layout.GetSize(), layout.GetTableSize(), layout.GetBucketCount());
+        for (ui64 hash : {0ULL, 1ULL, 0x9999999999999999ULL, ~0ULL}) {
+            UNIT_ASSERT_VALUES_EQUAL(layout.Bucket(hash), restored.Bucket(hash));
+            UNIT_ASSERT(layout.Bucket(hash) < layout.GetBucketCount());
+            UNIT_ASSERT(layout.Position(hash, 7) < layout.GetTableSize());
+        }
+        UNIT_ASSERT_EXCEPTION(TLayout(10, 9, 2), yexception);
+        UNIT_ASSERT_EXCEPTION(TLayout(10, 10, 1), yexception);
+    }
+}
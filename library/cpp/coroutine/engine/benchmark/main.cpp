@@ -0,0 +1,39 @@
+#include <library/cpp/coroutine/engine/impl.h>
+#include <library/cpp/testing/benchmark/bench.h>
+
+// coroutine per request pattern: spawn short coroutine and wait for it
+
+namespace {
+    void Spawn(NBench::NCpu::TParams& iface, NCoro::TStack::EGuard guard, size_t maxPooledStacks) {
+        TContExecutor exec(64000, IPollerFace::Default(), nullptr, guard);
+        NCoro::TStackPool::TSettings settings;
+        settings.MaxPooledStacks = maxPooledStacks;
+        exec.StackPool()->SetSettings(settings);
+
+        auto child = [](TCont* cont) {
+            Y_DO_NOT_OPTIMIZE_AWAY(cont);
+        };
+        auto parent = [&](TCont* cont) {
+            for (size_t i = 0; i < iface.Iterations(); ++i) {
+                cont->Join(cont->Executor()->Create(child, "child"));
+            }
+        };
+        exec.Execute(parent);
+    }
+}
+
+Y_CPU_BENCHMARK(SpawnCanary, iface) {
+    Spawn(iface, NCoro::TStack::EGuard::Canary, 0);
+}
+
+Y_CPU_BENCHMARK(SpawnCanaryPooled, iface) {
+    Spawn(iface, NCoro::TStack::EGuard::Canary, NCoro::TStackPool::TSettings().MaxPooledStacks);
+}
+
+Y_CPU_BENCHMARK(SpawnPage, iface) {
+    Spawn(iface, NCoro::TStack::EGuard::Page, 0);
+}
+
+Y_CPU_BENCHMARK(SpawnPagePooled, iface) {
+    Spawn(iface, NCoro::TStack::EGuard::Page, NCoro::TStackPool::TSettings().MaxPooledStacks);
+}
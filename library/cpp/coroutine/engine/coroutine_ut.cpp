@@ -42,6 +42,7 @@ class TCoroTest: public TTestBase {
     UNIT_TEST(TestStackAlignmentLogic);
     UNIT_TEST(TestStackCanaries);
     UNIT_TEST(TestStackPages);
+    UNIT_TEST(TestStackPool);
     UNIT_TEST(TestEventQueue)
     UNIT_TEST(TestNestedExecutor)
     UNIT_TEST(TestComputeCoroutineYield)
@@ -74,6 +75,7 @@ public:
     void TestStackAlignmentLogic();
     void TestStackCanaries();
     void TestStackPages();
+    void TestStackPool();
     void TestEventQueue();
     void TestNestedExecutor();
     void TestComputeCoroutineYield();
@@ -902,6 +904,46 @@ void TCoroTest::TestStackPages() {
     memset(s.Get().data(), 0, s.Get().size());
 }
 
+void TCoroTest::TestStackPool() {
+    for (auto guard : {NCoro::TStack::EGuard::Canary, NCoro::TStack::EGuard::Page}) {
+        TContExecutor exec(32000, IPollerFace::Default(), nullptr, guard);
+        exec.SetFailOnError(true);
+        NCoro::TStackPool::TSettings settings;
+        settings.HotStacks = 1;
+        exec.StackPool()->SetSettings(settings);
+
+        size_t finished = 0;
+        auto child = [&finished](TCont* cont) {
+            // touch the whole stack to check trimmed pages are usable
+            char buf[16000];
+            memset(buf, 1, sizeof(buf));
+            cont->Yield();
+            UNIT_ASSERT_VALUES_EQUAL(buf[sizeof(buf) - 1], 1);
+            ++finished;
+        };
+        auto parent = [&](TCont* cont) {
+            for (size_t wave = 1; wave <= 10; ++wave) {
+                // finished children are deleted at once, so they can not be joined
+                for (size_t i = 0; i < 4; ++i) {
+                    cont->Executor()->Create(child, "child");
+                }
+                while (finished < 4 * wave) {
+                    cont->Yield();
+                }
+            }
+        };
+        exec.Execute(parent);
+
+        const auto& stats = exec.StackPoolStats();
+        UNIT_ASSERT_VALUES_EQUAL(stats.InUse, 0);
+        UNIT_ASSERT_LT(stats.Misses, 10);
+        UNIT_ASSERT_VALUES_EQUAL(stats.Hits + stats.Misses, 41);
+        UNIT_ASSERT_VALUES_EQUAL(stats.Pooled, stats.Misses);
+        UNIT_ASSERT_GT(stats.Trimmed, 0);
+        UNIT_ASSERT_LE(stats.ResidentBytes, exec.StackPool()->RawSize(32000) * settings.HotStacks);
+    }
+}
+
 void TCoroTest::TestEventQueue() {
     NCoro::TEventWaitQueue queue;
     UNIT_ASSERT(queue.Empty());
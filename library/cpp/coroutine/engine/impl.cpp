@@ -21,6 +21,7 @@ TCont::TCont(ui32 stackSize, NCoro::TStack::EGuard stackGuard, TContExecutor& ex
     , Trampoline_(
         stackSize,
         stackGuard,
+        executor.StackPool(),
         func,
         this,
         arg
@@ -117,6 +118,7 @@ TContExecutor::TContExecutor(
     : CallbackPtr_(callback)
     , DefaultStackSize_(defaultStackSize)
     , StackGuard_(defaultGuard)
+    , StackPool_(defaultGuard)
     , Poller_(std::move(poller))
 {}
 
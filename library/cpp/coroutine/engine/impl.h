@@ -191,6 +191,15 @@ public:
         return &Poller_;
     }
 
+    /// Stacks of finished coroutines are recycled here, see NCoro::TStackPool
+    NCoro::TStackPool* StackPool() noexcept {
+        return &StackPool_;
+    }
+
+    const NCoro::TStackPoolStats& StackPoolStats() const noexcept {
+        return StackPool_.Stats();
+    }
+
     TCont* Running() noexcept {
         return Current_;
     }
@@ -264,6 +273,7 @@ private:
     NCoro::IScheduleCallback* const CallbackPtr_ = nullptr;
     const ui32 DefaultStackSize_;
     const NCoro::TStack::EGuard StackGuard_;
+    NCoro::TStackPool StackPool_;
 
     TExceptionSafeContext SchedContext_;
 
@@ -3,12 +3,19 @@
 
 #include <util/system/info.h>
 #include <util/system/protect.h>
+#include <util/system/sanitizers.h>
 #include <util/system/valgrind.h>
 #include <util/system/yassert.h>
 
 #include <cstdlib>
 #include <util/stream/format.h>
 
+#if defined(_unix_)
+#   include <sys/mman.h>
+#endif
+
+#include <atomic>
+
 namespace NCoro {
     namespace NPrivate {
         ui32 RawStackSize(ui32 sz, ui32 guardSize) {
@@ -70,19 +77,28 @@ namespace NCoro {
     }
 
     TStack::TStack(ui32 sz, TStack::EGuard guard) noexcept
+        : TStack(sz, guard, nullptr)
+    {
+    }
+
+    TStack::TStack(ui32 sz, TStack::EGuard guard, TStackPool* pool) noexcept
         : Guard_(guard)
-        , RawSize_(NPrivate::RawStackSize(sz, GuardSize(Guard_)))
-        , RawPtr_((char*) malloc(RawSize_))
+        , Pool_(pool && pool->Enabled() ? pool : nullptr)
+        , RawSize_(Pool_ ? Pool_->RawSize(sz) : NPrivate::RawStackSize(sz, GuardSize(Guard_)))
+        , RawPtr_(Pool_ ? Pool_->Acquire(RawSize_) : (char*) malloc(RawSize_))
     {
-        const auto guardSize = GuardSize(Guard_);
-        const auto alignedRange = NPrivate::AlignedRange(RawPtr_, RawSize_, guardSize);
-        switch (Guard_) {
-        case EGuard::Canary:
-            ProtectWithCanary(alignedRange);
-            break;
-        case EGuard::Page:
-            ProtectWithPages(alignedRange, PM_NONE);
-            break;
+        if (!Pool_) {
+            // pooled stacks are guarded by the pool
+            const auto guardSize = GuardSize(Guard_);
+            const auto alignedRange = NPrivate::AlignedRange(RawPtr_, RawSize_, guardSize);
+            switch (Guard_) {
+            case EGuard::Canary:
+                ProtectWithCanary(alignedRange);
+                break;
+            case EGuard::Page:
+                ProtectWithPages(alignedRange, PM_NONE);
+                break;
+            }
         }
         StackId_ = VALGRIND_STACK_REGISTER(
             Get().data(),
@@ -92,6 +108,11 @@ namespace NCoro {
 
     TStack::~TStack()
     {
+        if (Pool_) {
+            VALGRIND_STACK_DEREGISTER(StackId_);
+            Pool_->Release(RawPtr_, RawSize_);
+            return;
+        }
         if (Guard_ == EGuard::Page) {
             const auto alignedRange = NPrivate::AlignedRange(RawPtr_, RawSize_, GuardSize(Guard_));
             ProtectWithPages(alignedRange, PM_WRITE | PM_READ);
@@ -128,8 +149,177 @@ namespace NCoro {
     }
 
 
-    TTrampoline::TTrampoline(ui32 stackSize, TStack::EGuard guard, TContFunc f, TCont* cont, void* arg) noexcept
-        : Stack_(stackSize, guard)
+    namespace {
+        void ReleasePages(char* begin, char* end) noexcept {
+#if defined(_unix_)
+            static const size_t pageSize = NSystemInfo::GetPageSize();
+            begin = AlignUp(begin, pageSize);
+            end = AlignDown(end, pageSize);
+            if (begin >= end) {
+                return;
+            }
+#   if defined(MADV_FREE)
+            // MADV_FREE is lazy and cheaper, but is not supported by old kernels
+            static std::atomic<bool> madvFree = true;
+            if (madvFree.load(std::memory_order_relaxed)) {
+                if (madvise(begin, end - begin, MADV_FREE) == 0) {
+                    return;
+                }
+                madvFree.store(false, std::memory_order_relaxed);
+            }
+#   endif
+            madvise(begin, end - begin, MADV_DONTNEED);
+#else
+            Y_UNUSED(begin, end);
+#endif
+        }
+    }
+
+    TStackPool::TStackPool(TStack::EGuard guard, const TSettings& settings) noexcept
+        : Guard_(guard)
+        , Settings_(settings)
+    {
+    }
+
+    TStackPool::~TStackPool() {
+        Y_VERIFY(!Stats_.InUse, "%u stacks are still in use", (ui32)Stats_.InUse);
+        for (auto& [rawSize, stacks] : Free_) {
+            for (auto& stack : stacks) {
+                Unmap(stack.RawPtr, rawSize);
+            }
+        }
+    }
+
+    bool TStackPool::Enabled() const noexcept {
+#if defined(_unix_)
+        return Settings_.MaxPooledStacks > 0;
+#else
+        return false;
+#endif
+    }
+
+    void TStackPool::SetSettings(const TSettings& settings) noexcept {
+        Settings_ = settings;
+        for (auto& [rawSize, stacks] : Free_) {
+            Shrink(stacks, rawSize, Settings_.MaxPooledStacks);
+            for (size_t i = 0; i + Settings_.HotStacks < stacks.size(); ++i) {
+                Trim(stacks[i], rawSize);
+            }
+        }
+    }
+
+    ui32 TStackPool::RawSize(ui32 sz) const noexcept {
+        static const ui32 pageSize = NSystemInfo::GetPageSize();
+        return AlignUp(NPrivate::RawStackSize(sz, GuardSize(Guard_)), pageSize);
+    }
+
+    char* TStackPool::Acquire(ui32 rawSize) noexcept {
+        char* rawPtr = nullptr;
+        auto* stacks = Free_.FindPtr(rawSize);
+        if (stacks && !stacks->empty()) {
+            const TPooledStack stack = stacks->back();
+            stacks->pop_back();
+            Stats_.Hits += 1;
+            Stats_.Pooled -= 1;
+            if (!stack.Trimmed) {
+                Stats_.ResidentBytes -= rawSize;
+            }
+            rawPtr = stack.RawPtr;
+        } else {
+            Stats_.Misses += 1;
+            rawPtr = Map(rawSize);
+        }
+        Stats_.InUse += 1;
+        Stats_.ResidentBytes += rawSize;
+
+        if (Guard_ == TStack::EGuard::Canary) {
+            // canary pages could have been dropped by madvise
+            ProtectWithCanary(NPrivate::AlignedRange(rawPtr, rawSize, CANARY.size()));
+        }
+        return rawPtr;
+    }
+
+    void TStackPool::Release(char* rawPtr, ui32 rawSize) noexcept {
+        Stats_.InUse -= 1;
+        Stats_.ResidentBytes -= rawSize;
+
+        auto& stacks = Free_[rawSize];
+        if (stacks.size() >= Settings_.MaxPooledStacks) {
+            Unmap(rawPtr, rawSize);
+            return;
+        }
+
+        // finished coroutine leaves its frames poisoned
+        NSan::Unpoison(rawPtr, rawSize);
+        stacks.push_back({rawPtr, false});
+        Stats_.Pooled += 1;
+        Stats_.ResidentBytes += rawSize;
+
+        // the stack dropped out of the hot set will not be reused soon
+        if (stacks.size() > Settings_.HotStacks) {
+            Trim(stacks[stacks.size() - Settings_.HotStacks - 1], rawSize);
+        }
+    }
+
+    char* TStackPool::Map(ui32 rawSize) noexcept {
+#if defined(_unix_)
+        int flags = MAP_PRIVATE | MAP_ANON;
+#   if defined(MAP_NORESERVE)
+        flags |= MAP_NORESERVE;
+#   endif
+        void* ptr = mmap(nullptr, rawSize, PROT_READ | PROT_WRITE, flags, -1, 0);
+        Y_VERIFY(ptr != MAP_FAILED, "can not map coroutine stack of %u bytes", rawSize);
+
+        char* rawPtr = (char*)ptr;
+        if (Guard_ == TStack::EGuard::Page) {
+            ProtectWithPages(NPrivate::AlignedRange(rawPtr, rawSize, GuardSize(Guard_)), PM_NONE);
+        }
+        return rawPtr;
+#else
+        Y_UNUSED(rawSize);
+        Y_FAIL("stack pool is not supported");
+#endif
+    }
+
+    void TStackPool::Unmap(char* rawPtr, ui32 rawSize) noexcept {
+#if defined(_unix_)
+        munmap(rawPtr, rawSize);
+#else
+        Y_UNUSED(rawPtr, rawSize);
+#endif
+    }
+
+    void TStackPool::Trim(TPooledStack& stack, ui32 rawSize) noexcept {
+        if (stack.Trimmed) {
+            return;
+        }
+        const auto guardSize = GuardSize(Guard_);
+        const auto alignedRange = NPrivate::AlignedRange(stack.RawPtr, rawSize, guardSize);
+        ReleasePages(alignedRange.data() + guardSize, alignedRange.end() - guardSize);
+        stack.Trimmed = true;
+        Stats_.Trimmed += 1;
+        Stats_.ResidentBytes -= rawSize;
+    }
+
+    void TStackPool::Shrink(TVector<TPooledStack>& stacks, ui32 rawSize, size_t limit) noexcept {
+        if (stacks.size() <= limit) {
+            return;
+        }
+        // the oldest stacks are at the front
+        const size_t excess = stacks.size() - limit;
+        for (size_t i = 0; i < excess; ++i) {
+            if (!stacks[i].Trimmed) {
+                Stats_.ResidentBytes -= rawSize;
+            }
+            Unmap(stacks[i].RawPtr, rawSize);
+        }
+        stacks.erase(stacks.begin(), stacks.begin() + excess);
+        Stats_.Pooled -= excess;
+    }
+
+
+    TTrampoline::TTrampoline(ui32 stackSize, TStack::EGuard guard, TStackPool* pool, TContFunc f, TCont* cont, void* arg) noexcept
+        : Stack_(stackSize, guard, pool)
         , Clo_{this, Stack_.Get(), cont->Name()}
         , Ctx_(Clo_)
         , Func_(f)
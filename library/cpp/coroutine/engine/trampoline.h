@@ -1,7 +1,9 @@
 #pragma once
 
+#include <util/generic/hash.h>
 #include <util/generic/noncopyable.h>
 #include <util/generic/ptr.h>
+#include <util/generic/vector.h>
 #include <util/system/context.h>
 #include <util/system/defaults.h>
 
@@ -21,6 +23,8 @@ namespace NCoro {
         TArrayRef<char> AlignedRange(char* data, ui32 sz, ui32 guardSize);
     }
 
+    class TStackPool;
+
     class TStack : TNonCopyable {
     public:
         enum class EGuard {
@@ -29,6 +33,8 @@ namespace NCoro {
         };
 
         explicit TStack(ui32 sz, EGuard) noexcept;
+        // takes guarded memory from the pool and returns it there on destruction
+        TStack(ui32 sz, EGuard, TStackPool* pool) noexcept;
         ~TStack();
 
         TArrayRef<char> Get() noexcept;
@@ -39,17 +45,84 @@ namespace NCoro {
 
     private:
         const EGuard Guard_;
+        TStackPool* const Pool_ = nullptr;
         const ui32 RawSize_;
         char* const RawPtr_;
         size_t StackId_ = 0;
     };
 
 
+    struct TStackPoolStats {
+        ui64 Hits = 0;          // stacks taken from the pool
+        ui64 Misses = 0;        // stacks mapped from the os
+        ui64 Trimmed = 0;       // pooled stacks returned to the os with madvise
+        size_t InUse = 0;
+        size_t Pooled = 0;
+        size_t ResidentBytes = 0;   // upper bound: stacks in use and untrimmed pooled stacks
+    };
+
+    struct TStackPoolSettings {
+        // per stack size, 0 disables pooling
+        size_t MaxPooledStacks = 256;
+        // most recently released stacks which keep their pages
+        size_t HotStacks = 16;
+    };
+
+    /// Per-executor cache of guarded stacks.
+    /// Memory is mmapped without reservation and committed on first touch, guards are set up once per mapping.
+    /// Only HotStacks most recently released stacks of every size keep their pages,
+    /// older ones are returned to the os with MADV_FREE (MADV_DONTNEED if unsupported).
+    class TStackPool : TNonCopyable {
+    public:
+        using TSettings = TStackPoolSettings;
+
+    public:
+        explicit TStackPool(TStack::EGuard guard, const TSettings& settings = TSettings()) noexcept;
+        ~TStackPool();
+
+        void SetSettings(const TSettings& settings) noexcept;
+
+        bool Enabled() const noexcept;
+
+        const TStackPoolStats& Stats() const noexcept {
+            return Stats_;
+        }
+
+        // page aligned raw size of the mapping for requested stack size
+        ui32 RawSize(ui32 sz) const noexcept;
+
+        char* Acquire(ui32 rawSize) noexcept;
+
+        void Release(char* rawPtr, ui32 rawSize) noexcept;
+
+    private:
+        struct TPooledStack {
+            char* RawPtr = nullptr;
+            bool Trimmed = false;
+        };
+
+        char* Map(ui32 rawSize) noexcept;
+
+        void Unmap(char* rawPtr, ui32 rawSize) noexcept;
+
+        void Trim(TPooledStack& stack, ui32 rawSize) noexcept;
+
+        void Shrink(TVector<TPooledStack>& stacks, ui32 rawSize, size_t limit) noexcept;
+
+    private:
+        const TStack::EGuard Guard_;
+        TSettings Settings_;
+        THashMap<ui32, TVector<TPooledStack>> Free_;
+        TStackPoolStats Stats_;
+    };
+
+
     class TTrampoline : public ITrampoLine, TNonCopyable {
     public:
         TTrampoline(
             ui32 stackSize,
             TStack::EGuard guard,
+            TStackPool* pool,
             TContFunc f,
             TCont* cont,
             void* arg
@@ -0,0 +1,51 @@
+#include <library/cpp/coroutine/runtime/runtime.h>
+#include <library/cpp/testing/benchmark/bench.h>
+
+#include <util/system/event.h>
+#include <util/system/info.h>
+
+// Skewed load: every batch of requests arrives at one executor, request costs differ by 16x.
+// Time of an iteration is the latency of the slowest request in the batch.
+
+namespace {
+    constexpr size_t BatchSize = 256;
+
+    void Burn(size_t units) {
+        ui64 x = units;
+        for (size_t i = 0; i < units * 1000; ++i) {
+            x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        }
+        Y_DO_NOT_OPTIMIZE_AWAY(x);
+    }
+
+    void Skewed(NBench::NCpu::TParams& iface, bool stealing) {
+        NCoro::TRuntimeSettings settings;
+        settings.Threads = Min<size_t>(NSystemInfo::CachedNumberOfCpus(), 8);
+        settings.Stealing = stealing;
+        settings.MaxReadyConts = 4;
+        NCoro::TRuntime runtime(settings);
+
+        for (size_t i = 0; i < iface.Iterations(); ++i) {
+            std::atomic<size_t> left = BatchSize;
+            TManualEvent done;
+            for (size_t j = 0; j < BatchSize; ++j) {
+                runtime.Spawn(0, [&, j](TCont* cont) {
+                    Burn(j % 16 == 0 ? 16 : 1);
+                    cont->Yield();
+                    if (--left == 0) {
+                        done.Signal();
+                    }
+                });
+            }
+            done.WaitI();
+        }
+    }
+}
+
+Y_CPU_BENCHMARK(SkewedNoStealing, iface) {
+    Skewed(iface, false);
+}
+
+Y_CPU_BENCHMARK(SkewedStealing, iface) {
+    Skewed(iface, true);
+}
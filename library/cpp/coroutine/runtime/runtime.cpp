@@ -0,0 +1,256 @@
+#include "runtime.h"
+
+#include <library/cpp/coroutine/engine/network.h>
+
+#include <util/network/nonblock.h>
+#include <util/random/fast.h>
+#include <util/system/tls.h>
+#include <util/system/yassert.h>
+
+namespace NCoro {
+    TRemoteEvent::TRemoteEvent() {
+        TPipeHandle::Pipe(Reader_, Writer_, CloseOnExec);
+        SetNonBlock(Reader_);
+        SetNonBlock(Writer_);
+    }
+
+    void TRemoteEvent::Signal() noexcept {
+        // pending signal has already written its byte
+        if (!Signalled_.exchange(true)) {
+            const char c = 0;
+            Writer_.Write(&c, 1);
+        }
+    }
+
+    bool TRemoteEvent::WaitD(TCont* cont, TInstant deadline) noexcept {
+        while (true) {
+            if (Signalled_.exchange(false)) {
+                return true;
+            }
+            if (NCoro::PollD(cont, Reader_, CONT_POLL_READ, deadline)) {
+                return Signalled_.exchange(false);
+            }
+            Drain();
+        }
+    }
+
+    void TRemoteEvent::Drain() noexcept {
+        char buf[64];
+        while (Reader_.Read(buf, sizeof(buf)) > 0) {
+        }
+    }
+
+    struct TRuntime::TWorker {
+        explicit TWorker(size_t index)
+            : Index(index)
+        {
+        }
+
+        const size_t Index;
+        TMutex Lock;
+        TDeque<TTask> Queue;
+        std::atomic<size_t> QueueSize = 0;
+        // the worker sleeps in Wake and may be woken to steal
+        std::atomic<bool> Idle = false;
+        // set under Lock when the worker exits, nothing can be spawned into it anymore
+        bool Finished = false;
+        TRemoteEvent Wake;
+        THolder<TThread> Thread;
+    };
+
+    namespace {
+        struct TCurrentWorker {
+            const TRuntime* Runtime;
+            size_t Index;
+            TRemoteEvent* Wake;
+        };
+
+        Y_POD_STATIC_THREAD(TCurrentWorker*) CurrentWorker_(nullptr);
+
+        void RunTask(TCont* cont, void* arg) {
+            THolder<TRuntime::TTask> task(static_cast<TRuntime::TTask*>(arg));
+            (*task)(cont);
+            // the last task wakes the dispatcher, the stopped worker exits once it is empty
+            if (cont->Executor()->TotalConts() == 2) {
+                CurrentWorker_->Wake->Signal();
+            }
+        }
+    }
+
+    TRuntime::TRuntime(const TRuntimeSettings& settings)
+        : Settings_(settings)
+    {
+        Y_VERIFY(Settings_.Threads > 0);
+        for (size_t i = 0; i < Settings_.Threads; ++i) {
+            Workers_.push_back(MakeHolder<TWorker>(i));
+        }
+        for (auto& worker : Workers_) {
+            TWorker* w = worker.Get();
+            w->Thread = MakeHolder<TThread>([this, w]() {
+                Run(*w);
+            });
+            w->Thread->Start();
+        }
+    }
+
+    TRuntime::~TRuntime() {
+        Stop();
+    }
+
+    void TRuntime::Spawn(TTask task) {
+        size_t worker = CurrentWorker();
+        if (worker == Workers_.size()) {
+            worker = NextWorker_.fetch_add(1, std::memory_order_relaxed) % Workers_.size();
+        }
+        Spawn(worker, std::move(task));
+    }
+
+    void TRuntime::Spawn(size_t index, TTask task) {
+        Y_ENSURE(index < Workers_.size(), "no worker " << index << " in the runtime of " << Workers_.size());
+        TWorker& worker = *Workers_[index];
+        with_lock (worker.Lock) {
+            Y_ENSURE(!worker.Finished, "the runtime is stopped");
+            worker.Queue.push_back(std::move(task));
+            worker.QueueSize.store(worker.Queue.size());
+        }
+        worker.Wake.Signal();
+        if (Settings_.Stealing && !worker.Idle.load()) {
+            WakeIdle(worker);
+        }
+    }
+
+    void TRuntime::Stop() {
+        Stopped_.store(true);
+        for (auto& worker : Workers_) {
+            worker->Wake.Signal();
+        }
+        for (auto& worker : Workers_) {
+            if (worker->Thread) {
+                worker->Thread->Join();
+                worker->Thread.Destroy();
+            }
+        }
+    }
+
+    size_t TRuntime::CurrentWorker() const noexcept {
+        const TCurrentWorker* current = CurrentWorker_;
+        return current && current->Runtime == this ? current->Index : Workers_.size();
+    }
+
+    void TRuntime::Run(TWorker& worker) {
+        TThread::SetCurrentThreadName("CoroRuntime");
+        TCurrentWorker current{this, worker.Index, &worker.Wake};
+        CurrentWorker_ = &current;
+
+        TContExecutor executor(Settings_.StackSize, IPollerFace::Default(), nullptr, Settings_.StackGuard);
+        auto dispatch = [this, &worker](TCont* cont) {
+            Dispatch(cont, worker);
+        };
+        executor.Execute(dispatch);
+
+        CurrentWorker_ = nullptr;
+    }
+
+    void TRuntime::Dispatch(TCont* cont, TWorker& worker) {
+        TContExecutor* executor = cont->Executor();
+        TVector<TTask> batch;
+
+        while (true) {
+            const size_t ready = executor->TotalReadyConts();
+            const size_t budget = Settings_.MaxReadyConts > ready ? Settings_.MaxReadyConts - ready : 0;
+
+            with_lock (worker.Lock) {
+                while (batch.size() < budget && !worker.Queue.empty()) {
+                    batch.push_back(std::move(worker.Queue.front()));
+                    worker.Queue.pop_front();
+                }
+                worker.QueueSize.store(worker.Queue.size());
+            }
+
+            if (batch.empty() && budget && Settings_.Stealing && Steal(worker)) {
+                continue;
+            }
+
+            for (auto& task : batch) {
+                executor->Create(RunTask, new TTask(std::move(task)), "task");
+            }
+
+            if (!batch.empty() || !budget) {
+                if (!budget && Settings_.Stealing && worker.QueueSize.load()) {
+                    WakeIdle(worker);
+                }
+                batch.clear();
+                cont->Yield();
+                continue;
+            }
+
+            // the dispatcher is the last coroutine, so only other threads can spawn into the local queue
+            if (Stopped_.load() && executor->TotalConts() == 1) {
+                with_lock (worker.Lock) {
+                    worker.Finished = worker.Queue.empty();
+                }
+                if (worker.Finished) {
+                    break;
+                }
+                continue;
+            }
+
+            // a task spawned after the flag is set either wakes this worker or is found by the last steal
+            worker.Idle.store(true);
+            if (Settings_.Stealing && Steal(worker)) {
+                worker.Idle.store(false);
+                continue;
+            }
+            worker.Wake.WaitI(cont);
+            worker.Idle.store(false);
+        }
+    }
+
+    bool TRuntime::Steal(TWorker& thief) {
+        static thread_local TReallyFastRng32 rng(thief.Index);
+        const size_t workers = Workers_.size();
+        const size_t start = rng.Uniform(workers);
+
+        TVector<TTask> stolen;
+        for (size_t i = 0; i < workers && stolen.empty(); ++i) {
+            TWorker& victim = *Workers_[(start + i) % workers];
+            if (&victim == &thief || !victim.QueueSize.load()) {
+                continue;
+            }
+
+            // take the newest half, the victim continues with the oldest tasks
+            with_lock (victim.Lock) {
+                const size_t count = (victim.Queue.size() + 1) / 2;
+                for (size_t j = 0; j < count; ++j) {
+                    stolen.push_back(std::move(victim.Queue.back()));
+                    victim.Queue.pop_back();
+                }
+                victim.QueueSize.store(victim.Queue.size());
+            }
+        }
+
+        if (stolen.empty()) {
+            return false;
+        }
+
+        Stolen_.fetch_add(stolen.size(), std::memory_order_relaxed);
+        with_lock (thief.Lock) {
+            for (auto it = stolen.rbegin(); it != stolen.rend(); ++it) {
+                thief.Queue.push_back(std::move(*it));
+            }
+            thief.QueueSize.store(thief.Queue.size());
+        }
+        return true;
+    }
+
+    void TRuntime::WakeIdle(const TWorker& busy) noexcept {
+        const size_t workers = Workers_.size();
+        for (size_t i = 1; i < workers; ++i) {
+            TWorker& worker = *Workers_[(busy.Index + i) % workers];
+            if (worker.Idle.load() && worker.Idle.exchange(false)) {
+                worker.Wake.Signal();
+                return;
+            }
+        }
+    }
+}
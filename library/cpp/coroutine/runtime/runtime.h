@@ -0,0 +1,153 @@
+#pragma once
+
+#include <library/cpp/coroutine/engine/impl.h>
+
+#include <util/datetime/base.h>
+#include <util/generic/deque.h>
+#include <util/generic/noncopyable.h>
+#include <util/generic/ptr.h>
+#include <util/generic/vector.h>
+#include <util/system/guard.h>
+#include <util/system/mutex.h>
+#include <util/system/pipe.h>
+#include <util/system/thread.h>
+
+#include <atomic>
+#include <functional>
+
+namespace NCoro {
+    /// Event which can be signalled from any thread (including other executors),
+    /// waited by a single coroutine at a time.
+    /// Signals which arrive before the wait are not lost, several signals are coalesced into one wake up.
+    class TRemoteEvent : TNonCopyable {
+    public:
+        TRemoteEvent();
+
+        // thread-safe
+        void Signal() noexcept;
+
+        /// @return false on timeout or cancellation
+        bool WaitD(TCont* cont, TInstant deadline) noexcept;
+
+        bool WaitT(TCont* cont, TDuration timeout) noexcept {
+            return WaitD(cont, timeout.ToDeadLine());
+        }
+
+        bool WaitI(TCont* cont) noexcept {
+            return WaitD(cont, TInstant::Max());
+        }
+
+    private:
+        void Drain() noexcept;
+
+    private:
+        TPipeHandle Reader_;
+        TPipeHandle Writer_;
+        std::atomic<bool> Signalled_ = false;
+    };
+
+
+    /// Multi-producer queue, consumed by coroutines of one executor.
+    template <class T>
+    class TRemoteChannel : TNonCopyable {
+    public:
+        // thread-safe
+        void Push(T t) {
+            with_lock (Lock_) {
+                Queue_.push_back(std::move(t));
+            }
+            Event_.Signal();
+        }
+
+        /// @return false on timeout or cancellation
+        bool PopD(TCont* cont, T& t, TInstant deadline) noexcept {
+            while (true) {
+                with_lock (Lock_) {
+                    if (!Queue_.empty()) {
+                        t = std::move(Queue_.front());
+                        Queue_.pop_front();
+                        return true;
+                    }
+                }
+                if (!Event_.WaitD(cont, deadline)) {
+                    return false;
+                }
+            }
+        }
+
+        bool PopT(TCont* cont, T& t, TDuration timeout) noexcept {
+            return PopD(cont, t, timeout.ToDeadLine());
+        }
+
+        bool PopI(TCont* cont, T& t) noexcept {
+            return PopD(cont, t, TInstant::Max());
+        }
+
+    private:
+        TMutex Lock_;
+        TDeque<T> Queue_;
+        TRemoteEvent Event_;
+    };
+
+
+    struct TRuntimeSettings {
+        size_t Threads = 1;
+        ui32 StackSize = 64000;
+        TStack::EGuard StackGuard = TStack::EGuard::Canary;
+        // worker does not take new tasks while it has more ready coroutines,
+        // so that excess tasks stay in its queue and may be stolen by idle workers
+        size_t MaxReadyConts = 16;
+        bool Stealing = true;
+    };
+
+    /// M:N runtime: one TContExecutor per thread, tasks are coroutines.
+    /// Tasks which have not started yet are balanced between executors by work stealing,
+    /// a started coroutine stays in its executor (its stack, timers and poll registrations belong to it).
+    /// Idle workers sleep until a task is spawned to them or a busy worker has tasks to steal.
+    class TRuntime : TNonCopyable {
+    public:
+        using TTask = std::function<void(TCont*)>;
+
+    public:
+        explicit TRuntime(const TRuntimeSettings& settings);
+        ~TRuntime();
+
+        /// Thread-safe. Task spawned from a worker goes to its own queue, otherwise workers are chosen round-robin.
+        /// Tasks may be spawned while Stop() waits for the workers, spawning into a finished worker throws.
+        void Spawn(TTask task);
+
+        void Spawn(size_t worker, TTask task);
+
+        /// Finishes all spawned tasks and joins the threads.
+        void Stop();
+
+        size_t Workers() const noexcept {
+            return Workers_.size();
+        }
+
+        /// Index of the worker running the current thread, or Workers() outside the runtime.
+        size_t CurrentWorker() const noexcept;
+
+        ui64 Stolen() const noexcept {
+            return Stolen_.load(std::memory_order_relaxed);
+        }
+
+    private:
+        struct TWorker;
+
+        void Run(TWorker& worker);
+
+        void Dispatch(TCont* cont, TWorker& worker);
+
+        bool Steal(TWorker& thief);
+
+        void WakeIdle(const TWorker& busy) noexcept;
+
+    private:
+        const TRuntimeSettings Settings_;
+        TVector<THolder<TWorker>> Workers_;
+        std::atomic<size_t> NextWorker_ = 0;
+        std::atomic<ui64> Stolen_ = 0;
+        std::atomic<bool> Stopped_ = false;
+    };
+}
@@ -0,0 +1,141 @@
+#include "runtime.h"
+
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <util/generic/hash_set.h>
+#include <util/system/spinlock.h>
+#include <util/system/thread.h>
+
+using namespace NCoro;
+
+Y_UNIT_TEST_SUITE(TCoroRuntimeTest) {
+    Y_UNIT_TEST(TestSpawn) {
+        TRuntimeSettings settings;
+        settings.Threads = 4;
+        TRuntime runtime(settings);
+
+        std::atomic<size_t> done = 0;
+        for (size_t i = 0; i < 1000; ++i) {
+            runtime.Spawn([&](TCont* cont) {
+                cont->Yield();
+                // nested spawn goes to the own queue
+                runtime.Spawn([&](TCont*) {
+                    ++done;
+                });
+            });
+        }
+        runtime.Stop();
+        UNIT_ASSERT_VALUES_EQUAL(done.load(), 1000);
+    }
+
+    Y_UNIT_TEST(TestStealing) {
+        TRuntimeSettings settings;
+        settings.Threads = 4;
+        settings.MaxReadyConts = 1;
+        TRuntime runtime(settings);
+
+        TAdaptiveLock lock;
+        THashSet<size_t> workers;
+        for (size_t i = 0; i < 64; ++i) {
+            runtime.Spawn(0, [&](TCont*) {
+                // blocks the whole executor, the rest of its queue must be stolen
+                Sleep(TDuration::MilliSeconds(5));
+                with_lock (lock) {
+                    workers.insert(runtime.CurrentWorker());
+                }
+            });
+        }
+        runtime.Stop();
+        UNIT_ASSERT_GT(runtime.Stolen(), 0);
+        UNIT_ASSERT_GT(workers.size(), 1);
+    }
+
+    Y_UNIT_TEST(TestNoStealing) {
+        TRuntimeSettings settings;
+        settings.Threads = 2;
+        settings.Stealing = false;
+        TRuntime runtime(settings);
+
+        std::atomic<size_t> foreign = 0;
+        for (size_t i = 0; i < 16; ++i) {
+            runtime.Spawn(1, [&](TCont*) {
+                foreign += runtime.CurrentWorker() != 1;
+            });
+        }
+        runtime.Stop();
+        UNIT_ASSERT_VALUES_EQUAL(runtime.Stolen(), 0);
+        UNIT_ASSERT_VALUES_EQUAL(foreign.load(), 0);
+    }
+
+    Y_UNIT_TEST(TestStop) {
+        TRuntimeSettings settings;
+        settings.Threads = 2;
+        TRuntime runtime(settings);
+
+        UNIT_ASSERT_EXCEPTION(runtime.Spawn(2, [](TCont*) {}), yexception);
+
+        std::atomic<bool> nested = false;
+        runtime.Spawn(0, [&](TCont* cont) {
+            // outlives the call to Stop, tasks it spawns are still drained
+            cont->SleepT(TDuration::MilliSeconds(50));
+            runtime.Spawn([&](TCont*) {
+                nested = true;
+            });
+        });
+        runtime.Stop();
+        UNIT_ASSERT(nested.load());
+
+        UNIT_ASSERT_EXCEPTION(runtime.Spawn([](TCont*) {}), yexception);
+        UNIT_ASSERT_EXCEPTION(runtime.Spawn(1, [](TCont*) {}), yexception);
+    }
+
+    Y_UNIT_TEST(TestRemoteEvent) {
+        TRemoteEvent event;
+        TContExecutor executor(32000);
+        bool timedOut = true;
+        bool signalled = false;
+
+        TThread thread([&]() {
+            Sleep(TDuration::MilliSeconds(50));
+            event.Signal();
+            event.Signal();
+        });
+        thread.Start();
+
+        auto wait = [&](TCont* cont) {
+            timedOut = !event.WaitT(cont, TDuration::MilliSeconds(1));
+            signalled = event.WaitT(cont, TDuration::Seconds(10));
+        };
+        executor.Execute(wait);
+        thread.Join();
+
+        UNIT_ASSERT(timedOut);
+        UNIT_ASSERT(signalled);
+    }
+
+    Y_UNIT_TEST(TestRemoteChannel) {
+        TRemoteChannel<size_t> channel;
+        TContExecutor executor(32000);
+        constexpr size_t count = 10000;
+
+        TThread thread([&]() {
+            for (size_t i = 0; i < count; ++i) {
+                channel.Push(i);
+            }
+        });
+        thread.Start();
+
+        size_t sum = 0;
+        auto consume = [&](TCont* cont) {
+            size_t value = 0;
+            for (size_t i = 0; i < count; ++i) {
+                UNIT_ASSERT(channel.PopT(cont, value, TDuration::Seconds(10)));
+                sum += value;
+            }
+        };
+        executor.Execute(consume);
+        thread.Join();
+
+        UNIT_ASSERT_VALUES_EQUAL(sum, count * (count - 1) / 2);
+    }
+}
@@ -1,8 +1,10 @@
 #include <library/cpp/dot_product/dot_product.h>
+#include <library/cpp/dot_product/dot_product_simd.h>
 
 #include <library/cpp/testing/benchmark/bench.h>
 
 #include <util/generic/singleton.h>
+#include <util/generic/strbuf.h>
 #include <util/generic/vector.h>
 #include <util/generic/xrange.h>
 #include <contrib/libs/eigen/Eigen/Core>
@@ -198,6 +200,135 @@ namespace {
     DefineBenchmarkLengths(float);
     DefineBenchmarkLengths(double);
 
+    /* per instruction set, every call reads 2 * length * sizeof(TSourceType) bytes */
+
+    const NDotProductImpl::TDotProductKernels* FindKernels(TStringBuf name) {
+        for (const NDotProductImpl::TDotProductKernels* kernels : NDotProductImpl::GetSupportedKernels()) {
+            if (name == kernels->Name) {
+                return kernels;
+            }
+        }
+        return nullptr;
+    }
+
+    // does nothing when cpu does not support the instruction set
+#define DefineIsaBenchmark(isa, name, length, TSourceType, kernel)    \
+    Y_CPU_BENCHMARK(isa##length##_##TSourceType, iface) {             \
+        if (const auto* kernels = FindKernels(name)) {                \
+            Bench##length##_##TSourceType.Do(kernels->kernel, iface); \
+        }                                                             \
+    }
+
+#define DefineIsaBenchmarkTypes(isa, name, length)                 \
+    DefineIsaBenchmark(isa, name, length, i8, DotProductI8);       \
+    DefineIsaBenchmark(isa, name, length, ui8, DotProductUi8);     \
+    DefineIsaBenchmark(isa, name, length, i32, DotProductI32);     \
+    DefineIsaBenchmark(isa, name, length, float, DotProductFloat); \
+    DefineIsaBenchmark(isa, name, length, double, DotProductDouble);
+
+#define DefineIsaBenchmarkLengths(isa, name)  \
+    DefineIsaBenchmarkTypes(isa, name, 1000); \
+    DefineIsaBenchmarkTypes(isa, name, 30000);
+
+    DefineIsaBenchmarkLengths(Sse, "sse");
+    DefineIsaBenchmarkLengths(Avx2, "avx2");
+    DefineIsaBenchmarkLengths(Avx512, "avx512");
+    DefineIsaBenchmarkLengths(Avx512Vnni, "avx512vnni");
+
+    /* one query against many rows, per-pair loop vs batched kernels */
+
+    template <typename Res, typename Number, size_t length>
+    class TBatchBenchmark {
+        static constexpr size_t QueryCount = 16;
+        static constexpr size_t RowCount = 4096;
+
+    public:
+        TBatchBenchmark()
+            : Queries_(QueryCount * length)
+            , Rows_(RowCount * length)
+            , Result_(QueryCount * RowCount)
+        {
+            TReallyFastRng32 rng(length);
+            for (Number& n : Queries_) {
+                RandomNumber(rng, n);
+            }
+            for (Number& n : Rows_) {
+                RandomNumber(rng, n);
+            }
+        }
+
+        // every iteration computes QueryCount * RowCount distances
+        void DoPairs(Res (*op)(const Number*, const Number*, ui32), const NBench::NCpu::TParams& iface) {
+            for (const auto iteration : xrange(iface.Iterations())) {
+                Y_UNUSED(iteration);
+                for (size_t i = 0; i < QueryCount; ++i) {
+                    for (size_t j = 0; j < RowCount; ++j) {
+                        Result_[i * RowCount + j] = op(Queries_.data() + i * length, Rows_.data() + j * length, length);
+                    }
+                }
+                NBench::Clobber();
+            }
+        }
+
+        void DoBatch(void (*op)(const Number*, const Number*, size_t, ui32, Res*) noexcept, const NBench::NCpu::TParams& iface) {
+            for (const auto iteration : xrange(iface.Iterations())) {
+                Y_UNUSED(iteration);
+                for (size_t i = 0; i < QueryCount; ++i) {
+                    op(Queries_.data() + i * length, Rows_.data(), RowCount, length, Result_.data() + i * RowCount);
+                }
+                NBench::Clobber();
+            }
+        }
+
+        void DoMatrix(void (*op)(const Number*, size_t, const Number*, size_t, ui32, Res*) noexcept, const NBench::NCpu::TParams& iface) {
+            for (const auto iteration : xrange(iface.Iterations())) {
+                Y_UNUSED(iteration);
+                op(Queries_.data(), QueryCount, Rows_.data(), RowCount, length, Result_.data());
+                NBench::Clobber();
+            }
+        }
+
+    private:
+        TVector<Number> Queries_;
+        TVector<Number> Rows_;
+        TVector<Res> Result_;
+    };
+
+#define DefineBatchBenchmarkAlgos(length, TSourceType)                                                                 \
+    static TBatchBenchmark<TResultType<TSourceType>::TType, TSourceType, length> BatchBench##length##_##TSourceType; \
+                                                                                                                       \
+    Y_CPU_BENCHMARK(Pairs##length##_##TSourceType, iface) {                                                            \
+        BatchBench##length##_##TSourceType.DoPairs(DotProduct, iface);                                                 \
+    }                                                                                                                  \
+    Y_CPU_BENCHMARK(Batch##length##_##TSourceType, iface) {                                                            \
+        BatchBench##length##_##TSourceType.DoBatch(DotProductBatch, iface);                                            \
+    }                                                                                                                  \
+    Y_CPU_BENCHMARK(Matrix##length##_##TSourceType, iface) {                                                           \
+        BatchBench##length##_##TSourceType.DoMatrix(DotProductMatrix, iface);                                          \
+    }
+
+#define DefineBatchBenchmarkLengths(TSourceType) \
+    DefineBatchBenchmarkAlgos(96, TSourceType);  \
+    DefineBatchBenchmarkAlgos(200, TSourceType); \
+    DefineBatchBenchmarkAlgos(1000, TSourceType);
+
+    DefineBatchBenchmarkLengths(i8);
+    DefineBatchBenchmarkLengths(ui8);
+    DefineBatchBenchmarkLengths(float);
+
+    // there is no fast per-pair UI4 dot product, the baseline is the slow one
+    static TBatchBenchmark<ui32, ui8, 100> BatchBenchUI4;
+
+    Y_CPU_BENCHMARK(Pairs100_UI4, iface) {
+        BatchBenchUI4.DoPairs(DotProductUI4Slow, iface);
+    }
+    Y_CPU_BENCHMARK(Batch100_UI4, iface) {
+        BatchBenchUI4.DoBatch(DotProductUI4Batch, iface);
+    }
+    Y_CPU_BENCHMARK(Matrix100_UI4, iface) {
+        BatchBenchUI4.DoMatrix(DotProductUI4Matrix, iface);
+    }
+
     /* combined dot-product */
 
 #define DefineCosineBenchmarkAlgos(length, TSourceType)                                                                   \
@@ -1,12 +1,14 @@
 #include "dot_product.h"
+#include "dot_product_simd.h"
 
 #include <library/cpp/sse/sse.h>
 #include <util/system/platform.h>
 #include <util/system/compiler.h>
+#include <util/system/cpu_id.h>
 #include <util/generic/utility.h>
 
 #ifdef ARCADIA_SSE
-i32 DotProduct(const i8* lhs, const i8* rhs, ui32 length) noexcept {
+static i32 DotProductSse(const i8* lhs, const i8* rhs, ui32 length) noexcept {
     const __m128i zero = _mm_setzero_si128();
     __m128i resVec = zero;
     while (length >= 16) {
@@ -42,7 +44,7 @@ i32 DotProduct(const i8* lhs, const i8* rhs, ui32 length) noexcept {
     return sum;
 }
 
-ui32 DotProduct(const ui8* lhs, const ui8* rhs, ui32 length) noexcept {
+static ui32 DotProductSse(const ui8* lhs, const ui8* rhs, ui32 length) noexcept {
     const __m128i zero = _mm_setzero_si128();
     __m128i resVec = zero;
     while (length >= 16) {
@@ -73,7 +75,7 @@ ui32 DotProduct(const ui8* lhs, const ui8* rhs, ui32 length) noexcept {
 }
 #ifdef _sse4_1_
 
-i64 DotProduct(const i32* lhs, const i32* rhs, ui32 length) noexcept {
+static i64 DotProductSse(const i32* lhs, const i32* rhs, ui32 length) noexcept {
     __m128i zero = _mm_setzero_si128();
     __m128i res = zero;
 
@@ -102,13 +104,13 @@ i64 DotProduct(const i32* lhs, const i32* rhs, ui32 length) noexcept {
 
 #else
 
-i64 DotProduct(const i32* lhs, const i32* rhs, ui32 length) noexcept {
+static i64 DotProductSse(const i32* lhs, const i32* rhs, ui32 length) noexcept {
     return DotProductSlow(lhs, rhs, length);
 }
 
 #endif
 
-float DotProduct(const float* lhs, const float* rhs, ui32 length) noexcept {
+static float DotProductSse(const float* lhs, const float* rhs, ui32 length) noexcept {
     __m128 sum1 = _mm_setzero_ps();
     __m128 sum2 = _mm_setzero_ps();
     __m128 a1, b1, a2, b2, m1, m2;
@@ -173,7 +175,7 @@ float DotProduct(const float* lhs, const float* rhs, ui32 length) noexcept {
     return res[0] + res[1] + res[2] + res[3];
 }
 
-float L2NormSquared(const float* v, ui32 length) noexcept {
+static float L2NormSquaredSse(const float* v, ui32 length) noexcept {
     __m128 sum1 = _mm_setzero_ps();
     __m128 sum2 = _mm_setzero_ps();
     __m128 a1, a2, m1, m2;
@@ -229,7 +231,7 @@ float L2NormSquared(const float* v, ui32 length) noexcept {
     return res[0] + res[1] + res[2] + res[3];
 }
 
-double DotProduct(const double* lhs, const double* rhs, ui32 length) noexcept {
+static double DotProductSse(const double* lhs, const double* rhs, ui32 length) noexcept {
     __m128d sum1 = _mm_setzero_pd();
     __m128d sum2 = _mm_setzero_pd();
     __m128d a1, b1, a2, b2;
@@ -412,22 +414,6 @@ TTriWayDotProduct<float> TriWayDotProduct(const float* lhs, const float* rhs, ui
 
 #else
 
-i32 DotProduct(const i8* lhs, const i8* rhs, ui32 length) noexcept {
-    return DotProductSlow(lhs, rhs, length);
-}
-
-float DotProduct(const float* lhs, const float* rhs, ui32 length) noexcept {
-    return DotProductSlow(lhs, rhs, length);
-}
-
-double DotProduct(const double* lhs, const double* rhs, ui32 length) noexcept {
-    return DotProductSlow(lhs, rhs, length);
-}
-
-float L2NormSquared(const float* v, ui32 length) noexcept {
-    return DotProduct(v, v, length);
-}
-
 TTriWayDotProduct<float> TriWayDotProduct(const float* lhs, const float* rhs, ui32 length, unsigned mask) noexcept {
     TTriWayDotProduct<float> result;
     if (mask & static_cast<unsigned>(ETriWayDotProductComputeMask::LL)) {
@@ -484,3 +470,207 @@ ui32 DotProductUI4Slow(const ui8* lhs, const ui8* rhs, ui32 lengtInBytes) noexce
     }
     return res;
 }
+
+#ifndef ARCADIA_SSE
+static float L2NormSquaredSlow(const float* v, ui32 length) noexcept {
+    return DotProductSlow(v, v, length);
+}
+#endif
+
+namespace NDotProductImpl {
+    namespace {
+        // kernels of one query against 4 rows for instruction sets without a dedicated implementation
+        template <typename TResult, typename TNumber, TResult (*DotProductPair)(const TNumber*, const TNumber*, ui32) noexcept>
+        void DotProductX4ByPairs(const TNumber* query, const TNumber* rows, ui32 length, TResult* result) noexcept {
+            for (ui32 k = 0; k < 4; ++k) {
+                result[k] = DotProductPair(query, rows + k * length, length);
+            }
+        }
+
+        // 2 x 4 tiles made of two 1 x 4 kernels for instruction sets without a dedicated implementation
+        template <typename TResult, typename TNumber, void (*DotProductX4)(const TNumber*, const TNumber*, ui32, TResult*) noexcept>
+        void DotProductX2X4ByX4(const TNumber* queries, const TNumber* rows, ui32 length, TResult* result, size_t resultStride) noexcept {
+            DotProductX4(queries, rows, length, result);
+            DotProductX4(queries + length, rows, length, result + resultStride);
+        }
+
+#ifdef ARCADIA_SSE
+        constexpr TDotProductKernels BaselineKernels = {
+            "sse", DotProductSse, DotProductSse, DotProductSse, DotProductSse, DotProductSse, L2NormSquaredSse,
+            DotProductX4ByPairs<i32, i8, DotProductSse>, DotProductX4ByPairs<ui32, ui8, DotProductSse>,
+            DotProductX4ByPairs<float, float, DotProductSse>, DotProductX4ByPairs<ui32, ui8, DotProductUI4Slow>,
+            DotProductX2X4ByX4<i32, i8, DotProductX4ByPairs<i32, i8, DotProductSse>>,
+            DotProductX2X4ByX4<ui32, ui8, DotProductX4ByPairs<ui32, ui8, DotProductSse>>,
+            DotProductX2X4ByX4<float, float, DotProductX4ByPairs<float, float, DotProductSse>>,
+            DotProductX2X4ByX4<ui32, ui8, DotProductX4ByPairs<ui32, ui8, DotProductUI4Slow>>};
+#else
+        constexpr TDotProductKernels BaselineKernels = {
+            "slow", DotProductSlow, DotProductSlow, DotProductSlow, DotProductSlow, DotProductSlow, L2NormSquaredSlow,
+            DotProductX4ByPairs<i32, i8, DotProductSlow>, DotProductX4ByPairs<ui32, ui8, DotProductSlow>,
+            DotProductX4ByPairs<float, float, DotProductSlow>, DotProductX4ByPairs<ui32, ui8, DotProductUI4Slow>,
+            DotProductX2X4ByX4<i32, i8, DotProductX4ByPairs<i32, i8, DotProductSlow>>,
+            DotProductX2X4ByX4<ui32, ui8, DotProductX4ByPairs<ui32, ui8, DotProductSlow>>,
+            DotProductX2X4ByX4<float, float, DotProductX4ByPairs<float, float, DotProductSlow>>,
+            DotProductX2X4ByX4<ui32, ui8, DotProductX4ByPairs<ui32, ui8, DotProductUI4Slow>>};
+#endif
+
+#if defined(_x86_64_)
+        constexpr TDotProductKernels Avx2Kernels = {
+            "avx2", NAvx2::DotProduct, NAvx2::DotProduct, NAvx2::DotProduct, NAvx2::DotProduct, NAvx2::DotProduct,
+            NAvx2::L2NormSquared, NAvx2::DotProductX4, NAvx2::DotProductX4, NAvx2::DotProductX4, NAvx2::DotProductUI4X4,
+            NAvx2::DotProductX2X4, NAvx2::DotProductX2X4, NAvx2::DotProductX2X4,
+            DotProductX2X4ByX4<ui32, ui8, NAvx2::DotProductUI4X4>};
+
+        constexpr TDotProductKernels Avx512Kernels = {
+            "avx512", NAvx512::DotProduct, NAvx512::DotProduct, NAvx512::DotProduct, NAvx512::DotProduct,
+            NAvx512::DotProduct, NAvx512::L2NormSquared, NAvx512::DotProductX4, NAvx512::DotProductX4,
+            NAvx512::DotProductX4, NAvx512::DotProductUI4X4, NAvx512::DotProductX2X4, NAvx512::DotProductX2X4,
+            NAvx512::DotProductX2X4, DotProductX2X4ByX4<ui32, ui8, NAvx512::DotProductUI4X4>};
+
+        constexpr TDotProductKernels Avx512VnniKernels = {
+            "avx512vnni", NAvx512Vnni::DotProduct, NAvx512Vnni::DotProduct, NAvx512::DotProduct, NAvx512::DotProduct,
+            NAvx512::DotProduct, NAvx512::L2NormSquared, NAvx512Vnni::DotProductX4, NAvx512Vnni::DotProductX4,
+            NAvx512::DotProductX4, NAvx512::DotProductUI4X4, NAvx512Vnni::DotProductX2X4, NAvx512Vnni::DotProductX2X4,
+            NAvx512::DotProductX2X4, DotProductX2X4ByX4<ui32, ui8, NAvx512::DotProductUI4X4>};
+#endif
+
+        struct TSupportedKernels {
+            const TDotProductKernels* Kernels[4];
+            size_t Count = 0;
+
+            TSupportedKernels() noexcept {
+                Kernels[Count++] = &BaselineKernels;
+#if defined(_x86_64_)
+                if (NX86::CachedHaveAVX2()) {
+                    Kernels[Count++] = &Avx2Kernels;
+                }
+                if (NX86::CachedHaveAVX512F() && NX86::CachedHaveAVX512BW() && NX86::CachedHaveAVX512DQ() && NX86::CachedHaveAVX512VL()) {
+                    Kernels[Count++] = &Avx512Kernels;
+                    if (NX86::CachedHaveAVX512VNNI()) {
+                        Kernels[Count++] = &Avx512VnniKernels;
+                    }
+                }
+#endif
+            }
+        };
+    }
+
+    TArrayRef<const TDotProductKernels* const> GetSupportedKernels() noexcept {
+        static const TSupportedKernels supported;
+        return {supported.Kernels, supported.Count};
+    }
+
+    const TDotProductKernels& GetBestKernels() noexcept {
+        static const TDotProductKernels* const best = GetSupportedKernels().back();
+        return *best;
+    }
+}
+
+i32 DotProduct(const i8* lhs, const i8* rhs, ui32 length) noexcept {
+    return NDotProductImpl::GetBestKernels().DotProductI8(lhs, rhs, length);
+}
+
+ui32 DotProduct(const ui8* lhs, const ui8* rhs, ui32 length) noexcept {
+    return NDotProductImpl::GetBestKernels().DotProductUi8(lhs, rhs, length);
+}
+
+i64 DotProduct(const i32* lhs, const i32* rhs, ui32 length) noexcept {
+    return NDotProductImpl::GetBestKernels().DotProductI32(lhs, rhs, length);
+}
+
+float DotProduct(const float* lhs, const float* rhs, ui32 length) noexcept {
+    return NDotProductImpl::GetBestKernels().DotProductFloat(lhs, rhs, length);
+}
+
+double DotProduct(const double* lhs, const double* rhs, ui32 length) noexcept {
+    return NDotProductImpl::GetBestKernels().DotProductDouble(lhs, rhs, length);
+}
+
+float L2NormSquared(const float* v, ui32 length) noexcept {
+    return NDotProductImpl::GetBestKernels().L2NormSquaredFloat(v, length);
+}
+
+namespace {
+    // rhs rows are processed by blocks of this size so that a block stays in cache for all lhs rows
+    constexpr size_t MatrixBlockBytes = 64 * 1024;
+
+    template <typename TResult, typename TNumber, typename TKernelX4, typename TKernel>
+    void DotProductBatchImpl(TKernelX4 kernelX4, TKernel kernel, const TNumber* query, const TNumber* rows, size_t rowCount, ui32 length, TResult* result) noexcept {
+        size_t i = 0;
+        for (; i + 4 <= rowCount; i += 4) {
+            const TNumber* next = rows + (i + 4) * length;
+            for (size_t k = 0; k < 4 && i + 4 + k < rowCount; ++k) {
+                Y_PREFETCH_READ(next + k * length, 3);
+            }
+            kernelX4(query, rows + i * length, length, result + i);
+        }
+        for (; i < rowCount; ++i) {
+            result[i] = kernel(query, rows + i * length, length);
+        }
+    }
+
+    // each rhs block is walked by 2 x 4 tiles, so every loaded lhs vector serves 4 rows and every rhs vector 2 lhs rows
+    template <typename TResult, typename TNumber, typename TKernelX2X4, typename TKernelX4, typename TKernel>
+    void DotProductMatrixImpl(TKernelX2X4 kernelX2X4, TKernelX4 kernelX4, TKernel kernel, const TNumber* lhs, size_t lhsCount, const TNumber* rhs, size_t rhsCount, ui32 length, TResult* result) noexcept {
+        const size_t blockRows = Max<size_t>(4, MatrixBlockBytes / Max<size_t>(1, length * sizeof(TNumber)) / 4 * 4);
+        for (size_t j = 0; j < rhsCount; j += blockRows) {
+            const size_t blockCount = Min(blockRows, rhsCount - j);
+            const TNumber* block = rhs + j * length;
+            size_t i = 0;
+            for (; i + 2 <= lhsCount; i += 2) {
+                const TNumber* queries = lhs + i * length;
+                TResult* tileResult = result + i * rhsCount + j;
+                size_t k = 0;
+                for (; k + 4 <= blockCount; k += 4) {
+                    kernelX2X4(queries, block + k * length, length, tileResult + k, rhsCount);
+                }
+                for (; k < blockCount; ++k) {
+                    tileResult[k] = kernel(queries, block + k * length, length);
+                    tileResult[rhsCount + k] = kernel(queries + length, block + k * length, length);
+                }
+            }
+            if (i < lhsCount) {
+                DotProductBatchImpl(kernelX4, kernel, lhs + i * length, block, blockCount, length, result + i * rhsCount + j);
+            }
+        }
+    }
+}
+
+void DotProductBatch(const i8* query, const i8* rows, size_t rowCount, ui32 length, i32* result) noexcept {
+    const auto& kernels = NDotProductImpl::GetBestKernels();
+    DotProductBatchImpl(kernels.DotProductX4I8, kernels.DotProductI8, query, rows, rowCount, length, result);
+}
+
+void DotProductBatch(const ui8* query, const ui8* rows, size_t rowCount, ui32 length, ui32* result) noexcept {
+    const auto& kernels = NDotProductImpl::GetBestKernels();
+    DotProductBatchImpl(kernels.DotProductX4Ui8, kernels.DotProductUi8, query, rows, rowCount, length, result);
+}
+
+void DotProductBatch(const float* query, const float* rows, size_t rowCount, ui32 length, float* result) noexcept {
+    const auto& kernels = NDotProductImpl::GetBestKernels();
+    DotProductBatchImpl(kernels.DotProductX4Float, kernels.DotProductFloat, query, rows, rowCount, length, result);
+}
+
+void DotProductUI4Batch(const ui8* query, const ui8* rows, size_t rowCount, ui32 lengthInBytes, ui32* result) noexcept {
+    DotProductBatchImpl(NDotProductImpl::GetBestKernels().DotProductUI4X4, DotProductUI4Slow, query, rows, rowCount, lengthInBytes, result);
+}
+
+void DotProductMatrix(const i8* lhs, size_t lhsCount, const i8* rhs, size_t rhsCount, ui32 length, i32* result) noexcept {
+    const auto& kernels = NDotProductImpl::GetBestKernels();
+    DotProductMatrixImpl(kernels.DotProductX2X4I8, kernels.DotProductX4I8, kernels.DotProductI8, lhs, lhsCount, rhs, rhsCount, length, result);
+}
+
+void DotProductMatrix(const ui8* lhs, size_t lhsCount, const ui8* rhs, size_t rhsCount, ui32 length, ui32* result) noexcept {
+    const auto& kernels = NDotProductImpl::GetBestKernels();
+    DotProductMatrixImpl(kernels.DotProductX2X4Ui8, kernels.DotProductX4Ui8, kernels.DotProductUi8, lhs, lhsCount, rhs, rhsCount, length, result);
+}
+
+void DotProductMatrix(const float* lhs, size_t lhsCount, const float* rhs, size_t rhsCount, ui32 length, float* result) noexcept {
+    const auto& kernels = NDotProductImpl::GetBestKernels();
+    DotProductMatrixImpl(kernels.DotProductX2X4Float, kernels.DotProductX4Float, kernels.DotProductFloat, lhs, lhsCount, rhs, rhsCount, length, result);
+}
+
+void DotProductUI4Matrix(const ui8* lhs, size_t lhsCount, const ui8* rhs, size_t rhsCount, ui32 lengthInBytes, ui32* result) noexcept {
+    const auto& kernels = NDotProductImpl::GetBestKernels();
+    DotProductMatrixImpl(kernels.DotProductUI4X2X4, kernels.DotProductUI4X4, DotProductUI4Slow, lhs, lhsCount, rhs, rhsCount, lengthInBytes, result);
+}
@@ -29,6 +29,35 @@ double DotProduct(const double* lhs, const double* rhs, ui32 length) noexcept;
 Y_PURE_FUNCTION
 float L2NormSquared(const float* v, ui32 length) noexcept;
 
+/**
+ * Dot products of `query` with `rowCount` rows of a row-major matrix of `length` columns:
+ * result[i] = DotProduct(query, rows + i * length, length).
+ * The query is reused from registers for 4 rows at once, the last rowCount % 4 rows are computed one by one.
+ * Float results may differ from DotProduct in the last bits: 4-row kernels add in a different order.
+ */
+void DotProductBatch(const i8* query, const i8* rows, size_t rowCount, ui32 length, i32* result) noexcept;
+
+void DotProductBatch(const ui8* query, const ui8* rows, size_t rowCount, ui32 length, ui32* result) noexcept;
+
+void DotProductBatch(const float* query, const float* rows, size_t rowCount, ui32 length, float* result) noexcept;
+
+void DotProductUI4Batch(const ui8* query, const ui8* rows, size_t rowCount, ui32 lengthInBytes, ui32* result) noexcept;
+
+/**
+ * Dot products of every row of `lhs` with every row of `rhs`, both row-major with `length` columns:
+ * result[i * rhsCount + j] = DotProduct(lhs + i * length, rhs + j * length, length).
+ * A 64 KiB block of `rhs` rows stays in cache while all `lhs` rows pass over it in 2 x 4 register tiles:
+ * 2 lhs rows against 4 rhs rows per step, an odd last lhs row is run as a batch. Results are equal to
+ * DotProductBatch of every lhs row, so float ones are not bit-identical to DotProduct either.
+ */
+void DotProductMatrix(const i8* lhs, size_t lhsCount, const i8* rhs, size_t rhsCount, ui32 length, i32* result) noexcept;
+
+void DotProductMatrix(const ui8* lhs, size_t lhsCount, const ui8* rhs, size_t rhsCount, ui32 length, ui32* result) noexcept;
+
+void DotProductMatrix(const float* lhs, size_t lhsCount, const float* rhs, size_t rhsCount, ui32 length, float* result) noexcept;
+
+void DotProductUI4Matrix(const ui8* lhs, size_t lhsCount, const ui8* rhs, size_t rhsCount, ui32 lengthInBytes, ui32* result) noexcept;
+
 // TODO(yazevnul): make `L2NormSquared` for double, this should be faster than `DotProduct`
 // where `lhs == rhs` because it will save N load instructions.
 
@@ -0,0 +1,490 @@
+#include "dot_product_simd.h"
+
+#include <immintrin.h>
+
+#include <type_traits>
+
+namespace {
+    Y_FORCE_INLINE i32 HorizontalSumI32(__m256i v) {
+        __m128i x = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+        x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+        x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(x);
+    }
+
+    Y_FORCE_INLINE i64 HorizontalSumI64(__m256i v) {
+        __m128i x = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+        x = _mm_add_epi64(x, _mm_unpackhi_epi64(x, x));
+        return _mm_cvtsi128_si64(x);
+    }
+
+    Y_FORCE_INLINE float HorizontalSum(__m256 v) {
+        __m128 x = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        x = _mm_add_ps(x, _mm_movehl_ps(x, x));
+        x = _mm_add_ss(x, _mm_movehdup_ps(x));
+        return _mm_cvtss_f32(x);
+    }
+
+    Y_FORCE_INLINE double HorizontalSum(__m256d v) {
+        __m128d x = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+        x = _mm_add_sd(x, _mm_unpackhi_pd(x, x));
+        return _mm_cvtsd_f64(x);
+    }
+
+    // mask of first `length` 32-bit lanes, length < 8
+    Y_FORCE_INLINE __m256i TailMask32(ui32 length) {
+        return _mm256_cmpgt_epi32(_mm256_set1_epi32(length), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    }
+
+    // mask of first `length` 64-bit lanes, length < 4
+    Y_FORCE_INLINE __m256i TailMask64(ui32 length) {
+        return _mm256_cmpgt_epi64(_mm256_set1_epi64x(length), _mm256_setr_epi64x(0, 1, 2, 3));
+    }
+
+    Y_FORCE_INLINE __m256i MulAddI32(__m256i sum, __m256i a, __m256i b) {
+        // products of even lanes, then of odd lanes moved to even positions
+        sum = _mm256_add_epi64(sum, _mm256_mul_epi32(a, b));
+        return _mm256_add_epi64(sum, _mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32)));
+    }
+
+    // {sum(a), sum(b), sum(c), sum(d)}
+    Y_FORCE_INLINE __m128 HorizontalSum4(__m256 a, __m256 b, __m256 c, __m256 d) {
+        const __m256 abcd = _mm256_hadd_ps(_mm256_hadd_ps(a, b), _mm256_hadd_ps(c, d));
+        return _mm_add_ps(_mm256_castps256_ps128(abcd), _mm256_extractf128_ps(abcd, 1));
+    }
+
+    Y_FORCE_INLINE __m128i HorizontalSum4I32(__m256i a, __m256i b, __m256i c, __m256i d) {
+        const __m256i abcd = _mm256_hadd_epi32(_mm256_hadd_epi32(a, b), _mm256_hadd_epi32(c, d));
+        return _mm_add_epi32(_mm256_castsi256_si128(abcd), _mm256_extracti128_si256(abcd, 1));
+    }
+
+    template <typename T>
+    Y_FORCE_INLINE __m256i LoadEpi16(const T* p) {
+        const __m128i v = _mm_loadu_si128((const __m128i*)p);
+        if constexpr (std::is_signed<T>::value) {
+            return _mm256_cvtepi8_epi16(v);
+        } else {
+            return _mm256_cvtepu8_epi16(v);
+        }
+    }
+
+    // the query is loaded once for 4 rows, each row has its own accumulator
+    template <typename TResult, typename T>
+    Y_FORCE_INLINE void DotProductX4Bytes(const T* query, const T* rows, ui32 length, TResult* result) {
+        const T* r0 = rows;
+        const T* r1 = rows + length;
+        const T* r2 = rows + 2 * length;
+        const T* r3 = rows + 3 * length;
+        __m256i sum0 = _mm256_setzero_si256();
+        __m256i sum1 = _mm256_setzero_si256();
+        __m256i sum2 = _mm256_setzero_si256();
+        __m256i sum3 = _mm256_setzero_si256();
+
+        ui32 i = 0;
+        for (; i + 16 <= length; i += 16) {
+            const __m256i q = LoadEpi16(query + i);
+            sum0 = _mm256_add_epi32(sum0, _mm256_madd_epi16(q, LoadEpi16(r0 + i)));
+            sum1 = _mm256_add_epi32(sum1, _mm256_madd_epi16(q, LoadEpi16(r1 + i)));
+            sum2 = _mm256_add_epi32(sum2, _mm256_madd_epi16(q, LoadEpi16(r2 + i)));
+            sum3 = _mm256_add_epi32(sum3, _mm256_madd_epi16(q, LoadEpi16(r3 + i)));
+        }
+
+        alignas(16) i32 sums[4];
+        _mm_store_si128((__m128i*)sums, HorizontalSum4I32(sum0, sum1, sum2, sum3));
+        for (ui32 k = 0; k < 4; ++k) {
+            const T* row = rows + k * length;
+            for (ui32 j = i; j < length; ++j) {
+                sums[k] += static_cast<i32>(query[j]) * static_cast<i32>(row[j]);
+            }
+            result[k] = static_cast<TResult>(sums[k]);
+        }
+    }
+
+    // 2 x 4 tile: both queries are loaded once for 4 rows, each row once for both queries,
+    // every pair is summed in the same order as in DotProductX4Bytes
+    template <typename TResult, typename T>
+    Y_FORCE_INLINE void DotProductX2X4Bytes(const T* queries, const T* rows, ui32 length, TResult* result, size_t resultStride) {
+        const T* q0 = queries;
+        const T* q1 = queries + length;
+        const T* r0 = rows;
+        const T* r1 = rows + length;
+        const T* r2 = rows + 2 * length;
+        const T* r3 = rows + 3 * length;
+        __m256i sum00 = _mm256_setzero_si256();
+        __m256i sum01 = _mm256_setzero_si256();
+        __m256i sum02 = _mm256_setzero_si256();
+        __m256i sum03 = _mm256_setzero_si256();
+        __m256i sum10 = _mm256_setzero_si256();
+        __m256i sum11 = _mm256_setzero_si256();
+        __m256i sum12 = _mm256_setzero_si256();
+        __m256i sum13 = _mm256_setzero_si256();
+
+        ui32 i = 0;
+        for (; i + 16 <= length; i += 16) {
+            const __m256i x0 = LoadEpi16(r0 + i);
+            const __m256i x1 = LoadEpi16(r1 + i);
+            const __m256i x2 = LoadEpi16(r2 + i);
+            const __m256i x3 = LoadEpi16(r3 + i);
+            const __m256i a = LoadEpi16(q0 + i);
+            sum00 = _mm256_add_epi32(sum00, _mm256_madd_epi16(a, x0));
+            sum01 = _mm256_add_epi32(sum01, _mm256_madd_epi16(a, x1));
+            sum02 = _mm256_add_epi32(sum02, _mm256_madd_epi16(a, x2));
+            sum03 = _mm256_add_epi32(sum03, _mm256_madd_epi16(a, x3));
+            const __m256i b = LoadEpi16(q1 + i);
+            sum10 = _mm256_add_epi32(sum10, _mm256_madd_epi16(b, x0));
+            sum11 = _mm256_add_epi32(sum11, _mm256_madd_epi16(b, x1));
+            sum12 = _mm256_add_epi32(sum12, _mm256_madd_epi16(b, x2));
+            sum13 = _mm256_add_epi32(sum13, _mm256_madd_epi16(b, x3));
+        }
+
+        alignas(16) i32 sums[2][4];
+        _mm_store_si128((__m128i*)sums[0], HorizontalSum4I32(sum00, sum01, sum02, sum03));
+        _mm_store_si128((__m128i*)sums[1], HorizontalSum4I32(sum10, sum11, sum12, sum13));
+        for (ui32 m = 0; m < 2; ++m) {
+            const T* query = queries + m * length;
+            for (ui32 k = 0; k < 4; ++k) {
+                const T* row = rows + k * length;
+                for (ui32 j = i; j < length; ++j) {
+                    sums[m][k] += static_cast<i32>(query[j]) * static_cast<i32>(row[j]);
+                }
+                result[m * resultStride + k] = static_cast<TResult>(sums[m][k]);
+            }
+        }
+    }
+
+    // nibbles fit both signed and unsigned bytes, so maddubs sums of two products are exact
+    Y_FORCE_INLINE __m256i NibbleDotProduct(__m256i queryLo, __m256i queryHi, __m256i row) {
+        const __m256i lowNibbles = _mm256_set1_epi8(0x0f);
+        const __m256i rowLo = _mm256_and_si256(row, lowNibbles);
+        const __m256i rowHi = _mm256_and_si256(_mm256_srli_epi16(row, 4), lowNibbles);
+        const __m256i pairs = _mm256_add_epi16(_mm256_maddubs_epi16(queryLo, rowLo), _mm256_maddubs_epi16(queryHi, rowHi));
+        return _mm256_madd_epi16(pairs, _mm256_set1_epi16(1));
+    }
+}
+
+namespace NDotProductImpl::NAvx2 {
+    i32 DotProduct(const i8* lhs, const i8* rhs, ui32 length) noexcept {
+        __m256i sum0 = _mm256_setzero_si256();
+        __m256i sum1 = _mm256_setzero_si256();
+
+        while (length >= 32) {
+            const __m256i l0 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)lhs));
+            const __m256i r0 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)rhs));
+            const __m256i l1 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(lhs + 16)));
+            const __m256i r1 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(rhs + 16)));
+            sum0 = _mm256_add_epi32(sum0, _mm256_madd_epi16(l0, r0));
+            sum1 = _mm256_add_epi32(sum1, _mm256_madd_epi16(l1, r1));
+            lhs += 32;
+            rhs += 32;
+            length -= 32;
+        }
+
+        if (length >= 16) {
+            const __m256i l = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)lhs));
+            const __m256i r = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)rhs));
+            sum0 = _mm256_add_epi32(sum0, _mm256_madd_epi16(l, r));
+            lhs += 16;
+            rhs += 16;
+            length -= 16;
+        }
+
+        i32 sum = HorizontalSumI32(_mm256_add_epi32(sum0, sum1));
+        for (ui32 i = 0; i < length; ++i) {
+            sum += static_cast<i32>(lhs[i]) * static_cast<i32>(rhs[i]);
+        }
+        return sum;
+    }
+
+    ui32 DotProduct(const ui8* lhs, const ui8* rhs, ui32 length) noexcept {
+        __m256i sum0 = _mm256_setzero_si256();
+        __m256i sum1 = _mm256_setzero_si256();
+
+        while (length >= 32) {
+            const __m256i l0 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)lhs));
+            const __m256i r0 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)rhs));
+            const __m256i l1 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(lhs + 16)));
+            const __m256i r1 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(rhs + 16)));
+            sum0 = _mm256_add_epi32(sum0, _mm256_madd_epi16(l0, r0));
+            sum1 = _mm256_add_epi32(sum1, _mm256_madd_epi16(l1, r1));
+            lhs += 32;
+            rhs += 32;
+            length -= 32;
+        }
+
+        if (length >= 16) {
+            const __m256i l = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)lhs));
+            const __m256i r = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)rhs));
+            sum0 = _mm256_add_epi32(sum0, _mm256_madd_epi16(l, r));
+            lhs += 16;
+            rhs += 16;
+            length -= 16;
+        }
+
+        ui32 sum = static_cast<ui32>(HorizontalSumI32(_mm256_add_epi32(sum0, sum1)));
+        for (ui32 i = 0; i < length; ++i) {
+            sum += static_cast<ui32>(lhs[i]) * static_cast<ui32>(rhs[i]);
+        }
+        return sum;
+    }
+
+    i64 DotProduct(const i32* lhs, const i32* rhs, ui32 length) noexcept {
+        __m256i sum0 = _mm256_setzero_si256();
+        __m256i sum1 = _mm256_setzero_si256();
+
+        while (length >= 16) {
+            sum0 = MulAddI32(sum0, _mm256_loadu_si256((const __m256i*)lhs), _mm256_loadu_si256((const __m256i*)rhs));
+            sum1 = MulAddI32(sum1, _mm256_loadu_si256((const __m256i*)(lhs + 8)), _mm256_loadu_si256((const __m256i*)(rhs + 8)));
+            lhs += 16;
+            rhs += 16;
+            length -= 16;
+        }
+
+        if (length >= 8) {
+            sum0 = MulAddI32(sum0, _mm256_loadu_si256((const __m256i*)lhs), _mm256_loadu_si256((const __m256i*)rhs));
+            lhs += 8;
+            rhs += 8;
+            length -= 8;
+        }
+
+        if (length) {
+            const __m256i mask = TailMask32(length);
+            sum1 = MulAddI32(sum1, _mm256_maskload_epi32(lhs, mask), _mm256_maskload_epi32(rhs, mask));
+        }
+
+        return HorizontalSumI64(_mm256_add_epi64(sum0, sum1));
+    }
+
+    float DotProduct(const float* lhs, const float* rhs, ui32 length) noexcept {
+        __m256 sum0 = _mm256_setzero_ps();
+        __m256 sum1 = _mm256_setzero_ps();
+        __m256 sum2 = _mm256_setzero_ps();
+        __m256 sum3 = _mm256_setzero_ps();
+
+        while (length >= 32) {
+            sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(_mm256_loadu_ps(lhs), _mm256_loadu_ps(rhs)));
+            sum1 = _mm256_add_ps(sum1, _mm256_mul_ps(_mm256_loadu_ps(lhs + 8), _mm256_loadu_ps(rhs + 8)));
+            sum2 = _mm256_add_ps(sum2, _mm256_mul_ps(_mm256_loadu_ps(lhs + 16), _mm256_loadu_ps(rhs + 16)));
+            sum3 = _mm256_add_ps(sum3, _mm256_mul_ps(_mm256_loadu_ps(lhs + 24), _mm256_loadu_ps(rhs + 24)));
+            lhs += 32;
+            rhs += 32;
+            length -= 32;
+        }
+
+        while (length >= 8) {
+            sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(_mm256_loadu_ps(lhs), _mm256_loadu_ps(rhs)));
+            lhs += 8;
+            rhs += 8;
+            length -= 8;
+        }
+
+        if (length) {
+            const __m256i mask = TailMask32(length);
+            sum1 = _mm256_add_ps(sum1, _mm256_mul_ps(_mm256_maskload_ps(lhs, mask), _mm256_maskload_ps(rhs, mask)));
+        }
+
+        return HorizontalSum(_mm256_add_ps(_mm256_add_ps(sum0, sum1), _mm256_add_ps(sum2, sum3)));
+    }
+
+    double DotProduct(const double* lhs, const double* rhs, ui32 length) noexcept {
+        __m256d sum0 = _mm256_setzero_pd();
+        __m256d sum1 = _mm256_setzero_pd();
+        __m256d sum2 = _mm256_setzero_pd();
+        __m256d sum3 = _mm256_setzero_pd();
+
+        while (length >= 16) {
+            sum0 = _mm256_add_pd(sum0, _mm256_mul_pd(_mm256_loadu_pd(lhs), _mm256_loadu_pd(rhs)));
+            sum1 = _mm256_add_pd(sum1, _mm256_mul_pd(_mm256_loadu_pd(lhs + 4), _mm256_loadu_pd(rhs + 4)));
+            sum2 = _mm256_add_pd(sum2, _mm256_mul_pd(_mm256_loadu_pd(lhs + 8), _mm256_loadu_pd(rhs + 8)));
+            sum3 = _mm256_add_pd(sum3, _mm256_mul_pd(_mm256_loadu_pd(lhs + 12), _mm256_loadu_pd(rhs + 12)));
+            lhs += 16;
+            rhs += 16;
+            length -= 16;
+        }
+
+        while (length >= 4) {
+            sum0 = _mm256_add_pd(sum0, _mm256_mul_pd(_mm256_loadu_pd(lhs), _mm256_loadu_pd(rhs)));
+            lhs += 4;
+            rhs += 4;
+            length -= 4;
+        }
+
+        if (length) {
+            const __m256i mask = TailMask64(length);
+            sum1 = _mm256_add_pd(sum1, _mm256_mul_pd(_mm256_maskload_pd(lhs, mask), _mm256_maskload_pd(rhs, mask)));
+        }
+
+        return HorizontalSum(_mm256_add_pd(_mm256_add_pd(sum0, sum1), _mm256_add_pd(sum2, sum3)));
+    }
+
+    float L2NormSquared(const float* v, ui32 length) noexcept {
+        __m256 sum0 = _mm256_setzero_ps();
+        __m256 sum1 = _mm256_setzero_ps();
+        __m256 sum2 = _mm256_setzero_ps();
+        __m256 sum3 = _mm256_setzero_ps();
+        __m256 a0, a1, a2, a3;
+
+        while (length >= 32) {
+            a0 = _mm256_loadu_ps(v);
+            a1 = _mm256_loadu_ps(v + 8);
+            a2 = _mm256_loadu_ps(v + 16);
+            a3 = _mm256_loadu_ps(v + 24);
+            sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(a0, a0));
+            sum1 = _mm256_add_ps(sum1, _mm256_mul_ps(a1, a1));
+            sum2 = _mm256_add_ps(sum2, _mm256_mul_ps(a2, a2));
+            sum3 = _mm256_add_ps(sum3, _mm256_mul_ps(a3, a3));
+            v += 32;
+            length -= 32;
+        }
+
+        while (length >= 8) {
+            a0 = _mm256_loadu_ps(v);
+            sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(a0, a0));
+            v += 8;
+            length -= 8;
+        }
+
+        if (length) {
+            a1 = _mm256_maskload_ps(v, TailMask32(length));
+            sum1 = _mm256_add_ps(sum1, _mm256_mul_ps(a1, a1));
+        }
+
+        return HorizontalSum(_mm256_add_ps(_mm256_add_ps(sum0, sum1), _mm256_add_ps(sum2, sum3)));
+    }
+
+    void DotProductX4(const i8* query, const i8* rows, ui32 length, i32* result) noexcept {
+        DotProductX4Bytes(query, rows, length, result);
+    }
+
+    void DotProductX4(const ui8* query, const ui8* rows, ui32 length, ui32* result) noexcept {
+        DotProductX4Bytes(query, rows, length, result);
+    }
+
+    void DotProductX4(const float* query, const float* rows, ui32 length, float* result) noexcept {
+        const float* r0 = rows;
+        const float* r1 = rows + length;
+        const float* r2 = rows + 2 * length;
+        const float* r3 = rows + 3 * length;
+        __m256 sum0 = _mm256_setzero_ps();
+        __m256 sum1 = _mm256_setzero_ps();
+        __m256 sum2 = _mm256_setzero_ps();
+        __m256 sum3 = _mm256_setzero_ps();
+
+        ui32 i = 0;
+        for (; i + 8 <= length; i += 8) {
+            const __m256 q = _mm256_loadu_ps(query + i);
+            sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(q, _mm256_loadu_ps(r0 + i)));
+            sum1 = _mm256_add_ps(sum1, _mm256_mul_ps(q, _mm256_loadu_ps(r1 + i)));
+            sum2 = _mm256_add_ps(sum2, _mm256_mul_ps(q, _mm256_loadu_ps(r2 + i)));
+            sum3 = _mm256_add_ps(sum3, _mm256_mul_ps(q, _mm256_loadu_ps(r3 + i)));
+        }
+
+        if (i < length) {
+            const __m256i mask = TailMask32(length - i);
+            const __m256 q = _mm256_maskload_ps(query + i, mask);
+            sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(q, _mm256_maskload_ps(r0 + i, mask)));
+            sum1 = _mm256_add_ps(sum1, _mm256_mul_ps(q, _mm256_maskload_ps(r1 + i, mask)));
+            sum2 = _mm256_add_ps(sum2, _mm256_mul_ps(q, _mm256_maskload_ps(r2 + i, mask)));
+            sum3 = _mm256_add_ps(sum3, _mm256_mul_ps(q, _mm256_maskload_ps(r3 + i, mask)));
+        }
+
+        _mm_storeu_ps(result, HorizontalSum4(sum0, sum1, sum2, sum3));
+    }
+
+    void DotProductX2X4(const i8* queries, const i8* rows, ui32 length, i32* result, size_t resultStride) noexcept {
+        DotProductX2X4Bytes(queries, rows, length, result, resultStride);
+    }
+
+    void DotProductX2X4(const ui8* queries, const ui8* rows, ui32 length, ui32* result, size_t resultStride) noexcept {
+        DotProductX2X4Bytes(queries, rows, length, result, resultStride);
+    }
+
+    void DotProductX2X4(const float* queries, const float* rows, ui32 length, float* result, size_t resultStride) noexcept {
+        const float* q0 = queries;
+        const float* q1 = queries + length;
+        const float* r0 = rows;
+        const float* r1 = rows + length;
+        const float* r2 = rows + 2 * length;
+        const float* r3 = rows + 3 * length;
+        __m256 sum00 = _mm256_setzero_ps();
+        __m256 sum01 = _mm256_setzero_ps();
+        __m256 sum02 = _mm256_setzero_ps();
+        __m256 sum03 = _mm256_setzero_ps();
+        __m256 sum10 = _mm256_setzero_ps();
+        __m256 sum11 = _mm256_setzero_ps();
+        __m256 sum12 = _mm256_setzero_ps();
+        __m256 sum13 = _mm256_setzero_ps();
+
+        ui32 i = 0;
+        for (; i + 8 <= length; i += 8) {
+            const __m256 x0 = _mm256_loadu_ps(r0 + i);
+            const __m256 x1 = _mm256_loadu_ps(r1 + i);
+            const __m256 x2 = _mm256_loadu_ps(r2 + i);
+            const __m256 x3 = _mm256_loadu_ps(r3 + i);
+            const __m256 a = _mm256_loadu_ps(q0 + i);
+            sum00 = _mm256_add_ps(sum00, _mm256_mul_ps(a, x0));
+            sum01 = _mm256_add_ps(sum01, _mm256_mul_ps(a, x1));
+            sum02 = _mm256_add_ps(sum02, _mm256_mul_ps(a, x2));
+            sum03 = _mm256_add_ps(sum03, _mm256_mul_ps(a, x3));
+            const __m256 b = _mm256_loadu_ps(q1 + i);
+            sum10 = _mm256_add_ps(sum10, _mm256_mul_ps(b, x0));
+            sum11 = _mm256_add_ps(sum11, _mm256_mul_ps(b, x1));
+            sum12 = _mm256_add_ps(sum12, _mm256_mul_ps(b, x2));
+            sum13 = _mm256_add_ps(sum13, _mm256_mul_ps(b, x3));
+        }
+
+        if (i < length) {
+            const __m256i mask = TailMask32(length - i);
+            const __m256 x0 = _mm256_maskload_ps(r0 + i, mask);
+            const __m256 x1 = _mm256_maskload_ps(r1 + i, mask);
+            const __m256 x2 = _mm256_maskload_ps(r2 + i, mask);
+            const __m256 x3 = _mm256_maskload_ps(r3 + i, mask);
+            const __m256 a = _mm256_maskload_ps(q0 + i, mask);
+            sum00 = _mm256_add_ps(sum00, _mm256_mul_ps(a, x0));
+            sum01 = _mm256_add_ps(sum01, _mm256_mul_ps(a, x1));
+            sum02 = _mm256_add_ps(sum02, _mm256_mul_ps(a, x2));
+            sum03 = _mm256_add_ps(sum03, _mm256_mul_ps(a, x3));
+            const __m256 b = _mm256_maskload_ps(q1 + i, mask);
+            sum10 = _mm256_add_ps(sum10, _mm256_mul_ps(b, x0));
+            sum11 = _mm256_add_ps(sum11, _mm256_mul_ps(b, x1));
+            sum12 = _mm256_add_ps(sum12, _mm256_mul_ps(b, x2));
+            sum13 = _mm256_add_ps(sum13, _mm256_mul_ps(b, x3));
+        }
+
+        _mm_storeu_ps(result, HorizontalSum4(sum00, sum01, sum02, sum03));
+        _mm_storeu_ps(result + resultStride, HorizontalSum4(sum10, sum11, sum12, sum13));
+    }
+
+    void DotProductUI4X4(const ui8* query, const ui8* rows, ui32 lengthInBytes, ui32* result) noexcept {
+        const ui8* r0 = rows;
+        const ui8* r1 = rows + lengthInBytes;
+        const ui8* r2 = rows + 2 * lengthInBytes;
+        const ui8* r3 = rows + 3 * lengthInBytes;
+        const __m256i lowNibbles = _mm256_set1_epi8(0x0f);
+        __m256i sum0 = _mm256_setzero_si256();
+        __m256i sum1 = _mm256_setzero_si256();
+        __m256i sum2 = _mm256_setzero_si256();
+        __m256i sum3 = _mm256_setzero_si256();
+
+        ui32 i = 0;
+        for (; i + 32 <= lengthInBytes; i += 32) {
+            const __m256i q = _mm256_loadu_si256((const __m256i*)(query + i));
+            const __m256i qLo = _mm256_and_si256(q, lowNibbles);
+            const __m256i qHi = _mm256_and_si256(_mm256_srli_epi16(q, 4), lowNibbles);
+            sum0 = _mm256_add_epi32(sum0, NibbleDotProduct(qLo, qHi, _mm256_loadu_si256((const __m256i*)(r0 + i))));
+            sum1 = _mm256_add_epi32(sum1, NibbleDotProduct(qLo, qHi, _mm256_loadu_si256((const __m256i*)(r1 + i))));
+            sum2 = _mm256_add_epi32(sum2, NibbleDotProduct(qLo, qHi, _mm256_loadu_si256((const __m256i*)(r2 + i))));
+            sum3 = _mm256_add_epi32(sum3, NibbleDotProduct(qLo, qHi, _mm256_loadu_si256((const __m256i*)(r3 + i))));
+        }
+
+        alignas(16) ui32 sums[4];
+        _mm_store_si128((__m128i*)sums, HorizontalSum4I32(sum0, sum1, sum2, sum3));
+        for (ui32 k = 0; k < 4; ++k) {
+            const ui8* row = rows + k * lengthInBytes;
+            for (ui32 j = i; j < lengthInBytes; ++j) {
+                sums[k] += static_cast<ui32>(query[j] & 0x0f) * static_cast<ui32>(row[j] & 0x0f);
+                sums[k] += static_cast<ui32>(query[j] >> 4) * static_cast<ui32>(row[j] >> 4);
+            }
+            result[k] = sums[k];
+        }
+    }
+}
@@ -0,0 +1,461 @@
+#include "dot_product_simd.h"
+
+#include <immintrin.h>
+
+#include <type_traits>
+
+namespace {
+    Y_FORCE_INLINE __mmask32 TailMask32(ui32 length) {
+        return (__mmask32)((1ull << length) - 1);
+    }
+
+    Y_FORCE_INLINE __m512i MulAddI32(__m512i sum, __m512i a, __m512i b) {
+        // products of even lanes, then of odd lanes moved to even positions
+        sum = _mm512_add_epi64(sum, _mm512_mul_epi32(a, b));
+        return _mm512_add_epi64(sum, _mm512_mul_epi32(_mm512_srli_epi64(a, 32), _mm512_srli_epi64(b, 32)));
+    }
+
+    Y_FORCE_INLINE __mmask64 TailMask64(ui32 length) {
+        return length ? (__mmask64)(~0ull >> (64 - length)) : 0;
+    }
+
+    template <typename T>
+    Y_FORCE_INLINE __m512i LoadEpi16(const T* p, __mmask32 mask = (__mmask32)-1) {
+        const __m256i v = _mm256_maskz_loadu_epi8(mask, p);
+        if constexpr (std::is_signed<T>::value) {
+            return _mm512_cvtepi8_epi16(v);
+        } else {
+            return _mm512_cvtepu8_epi16(v);
+        }
+    }
+
+    // the query is loaded once for 4 rows, each row has its own accumulator
+    template <typename TResult, typename T>
+    Y_FORCE_INLINE void DotProductX4Bytes(const T* query, const T* rows, ui32 length, TResult* result) {
+        const T* r0 = rows;
+        const T* r1 = rows + length;
+        const T* r2 = rows + 2 * length;
+        const T* r3 = rows + 3 * length;
+        __m512i sum0 = _mm512_setzero_si512();
+        __m512i sum1 = _mm512_setzero_si512();
+        __m512i sum2 = _mm512_setzero_si512();
+        __m512i sum3 = _mm512_setzero_si512();
+
+        ui32 i = 0;
+        for (; i + 32 <= length; i += 32) {
+            const __m512i q = LoadEpi16(query + i);
+            sum0 = _mm512_add_epi32(sum0, _mm512_madd_epi16(q, LoadEpi16(r0 + i)));
+            sum1 = _mm512_add_epi32(sum1, _mm512_madd_epi16(q, LoadEpi16(r1 + i)));
+            sum2 = _mm512_add_epi32(sum2, _mm512_madd_epi16(q, LoadEpi16(r2 + i)));
+            sum3 = _mm512_add_epi32(sum3, _mm512_madd_epi16(q, LoadEpi16(r3 + i)));
+        }
+
+        if (i < length) {
+            const __mmask32 mask = TailMask32(length - i);
+            const __m512i q = LoadEpi16(query + i, mask);
+            sum0 = _mm512_add_epi32(sum0, _mm512_madd_epi16(q, LoadEpi16(r0 + i, mask)));
+            sum1 = _mm512_add_epi32(sum1, _mm512_madd_epi16(q, LoadEpi16(r1 + i, mask)));
+            sum2 = _mm512_add_epi32(sum2, _mm512_madd_epi16(q, LoadEpi16(r2 + i, mask)));
+            sum3 = _mm512_add_epi32(sum3, _mm512_madd_epi16(q, LoadEpi16(r3 + i, mask)));
+        }
+
+        result[0] = static_cast<TResult>(_mm512_reduce_add_epi32(sum0));
+        result[1] = static_cast<TResult>(_mm512_reduce_add_epi32(sum1));
+        result[2] = static_cast<TResult>(_mm512_reduce_add_epi32(sum2));
+        result[3] = static_cast<TResult>(_mm512_reduce_add_epi32(sum3));
+    }
+
+    // 2 x 4 tile: both queries are loaded once for 4 rows, each row once for both queries,
+    // every pair is summed in the same order as in DotProductX4Bytes
+    template <typename TResult, typename T>
+    Y_FORCE_INLINE void DotProductX2X4Bytes(const T* queries, const T* rows, ui32 length, TResult* result, size_t resultStride) {
+        const T* q0 = queries;
+        const T* q1 = queries + length;
+        const T* r0 = rows;
+        const T* r1 = rows + length;
+        const T* r2 = rows + 2 * length;
+        const T* r3 = rows + 3 * length;
+        __m512i sum00 = _mm512_setzero_si512();
+        __m512i sum01 = _mm512_setzero_si512();
+        __m512i sum02 = _mm512_setzero_si512();
+        __m512i sum03 = _mm512_setzero_si512();
+        __m512i sum10 = _mm512_setzero_si512();
+        __m512i sum11 = _mm512_setzero_si512();
+        __m512i sum12 = _mm512_setzero_si512();
+        __m512i sum13 = _mm512_setzero_si512();
+
+        // zeroed lanes of the tail do not contribute
+        for (ui32 i = 0; i < length; i += 32) {
+            const __mmask32 mask = length - i >= 32 ? (__mmask32)-1 : TailMask32(length - i);
+            const __m512i x0 = LoadEpi16(r0 + i, mask);
+            const __m512i x1 = LoadEpi16(r1 + i, mask);
+            const __m512i x2 = LoadEpi16(r2 + i, mask);
+            const __m512i x3 = LoadEpi16(r3 + i, mask);
+            const __m512i a = LoadEpi16(q0 + i, mask);
+            sum00 = _mm512_add_epi32(sum00, _mm512_madd_epi16(a, x0));
+            sum01 = _mm512_add_epi32(sum01, _mm512_madd_epi16(a, x1));
+            sum02 = _mm512_add_epi32(sum02, _mm512_madd_epi16(a, x2));
+            sum03 = _mm512_add_epi32(sum03, _mm512_madd_epi16(a, x3));
+            const __m512i b = LoadEpi16(q1 + i, mask);
+            sum10 = _mm512_add_epi32(sum10, _mm512_madd_epi16(b, x0));
+            sum11 = _mm512_add_epi32(sum11, _mm512_madd_epi16(b, x1));
+            sum12 = _mm512_add_epi32(sum12, _mm512_madd_epi16(b, x2));
+            sum13 = _mm512_add_epi32(sum13, _mm512_madd_epi16(b, x3));
+        }
+
+        result[0] = static_cast<TResult>(_mm512_reduce_add_epi32(sum00));
+        result[1] = static_cast<TResult>(_mm512_reduce_add_epi32(sum01));
+        result[2] = static_cast<TResult>(_mm512_reduce_add_epi32(sum02));
+        result[3] = static_cast<TResult>(_mm512_reduce_add_epi32(sum03));
+        result[resultStride + 0] = static_cast<TResult>(_mm512_reduce_add_epi32(sum10));
+        result[resultStride + 1] = static_cast<TResult>(_mm512_reduce_add_epi32(sum11));
+        result[resultStride + 2] = static_cast<TResult>(_mm512_reduce_add_epi32(sum12));
+        result[resultStride + 3] = static_cast<TResult>(_mm512_reduce_add_epi32(sum13));
+    }
+
+    // nibbles fit both signed and unsigned bytes, so maddubs sums of two products are exact
+    Y_FORCE_INLINE __m512i NibbleDotProduct(__m512i queryLo, __m512i queryHi, __m512i row) {
+        const __m512i lowNibbles = _mm512_set1_epi8(0x0f);
+        const __m512i rowLo = _mm512_and_si512(row, lowNibbles);
+        const __m512i rowHi = _mm512_and_si512(_mm512_srli_epi16(row, 4), lowNibbles);
+        const __m512i pairs = _mm512_add_epi16(_mm512_maddubs_epi16(queryLo, rowLo), _mm512_maddubs_epi16(queryHi, rowHi));
+        return _mm512_madd_epi16(pairs, _mm512_set1_epi16(1));
+    }
+}
+
+namespace NDotProductImpl::NAvx512 {
+    i32 DotProduct(const i8* lhs, const i8* rhs, ui32 length) noexcept {
+        __m512i sum0 = _mm512_setzero_si512();
+        __m512i sum1 = _mm512_setzero_si512();
+
+        while (length >= 64) {
+            const __m512i l0 = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)lhs));
+            const __m512i r0 = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)rhs));
+            const __m512i l1 = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)(lhs + 32)));
+            const __m512i r1 = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)(rhs + 32)));
+            sum0 = _mm512_add_epi32(sum0, _mm512_madd_epi16(l0, r0));
+            sum1 = _mm512_add_epi32(sum1, _mm512_madd_epi16(l1, r1));
+            lhs += 64;
+            rhs += 64;
+            length -= 64;
+        }
+
+        if (length >= 32) {
+            const __m512i l = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)lhs));
+            const __m512i r = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)rhs));
+            sum0 = _mm512_add_epi32(sum0, _mm512_madd_epi16(l, r));
+            lhs += 32;
+            rhs += 32;
+            length -= 32;
+        }
+
+        if (length) {
+            const __mmask32 mask = TailMask32(length);
+            const __m512i l = _mm512_cvtepi8_epi16(_mm256_maskz_loadu_epi8(mask, lhs));
+            const __m512i r = _mm512_cvtepi8_epi16(_mm256_maskz_loadu_epi8(mask, rhs));
+            sum1 = _mm512_add_epi32(sum1, _mm512_madd_epi16(l, r));
+        }
+
+        return _mm512_reduce_add_epi32(_mm512_add_epi32(sum0, sum1));
+    }
+
+    ui32 DotProduct(const ui8* lhs, const ui8* rhs, ui32 length) noexcept {
+        __m512i sum0 = _mm512_setzero_si512();
+        __m512i sum1 = _mm512_setzero_si512();
+
+        while (length >= 64) {
+            const __m512i l0 = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i*)lhs));
+            const __m512i r0 = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i*)rhs));
+            const __m512i l1 = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i*)(lhs + 32)));
+            const __m512i r1 = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i*)(rhs + 32)));
+            sum0 = _mm512_add_epi32(sum0, _mm512_madd_epi16(l0, r0));
+            sum1 = _mm512_add_epi32(sum1, _mm512_madd_epi16(l1, r1));
+            lhs += 64;
+            rhs += 64;
+            length -= 64;
+        }
+
+        if (length >= 32) {
+            const __m512i l = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i*)lhs));
+            const __m512i r = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i*)rhs));
+            sum0 = _mm512_add_epi32(sum0, _mm512_madd_epi16(l, r));
+            lhs += 32;
+            rhs += 32;
+            length -= 32;
+        }
+
+        if (length) {
+            const __mmask32 mask = TailMask32(length);
+            const __m512i l = _mm512_cvtepu8_epi16(_mm256_maskz_loadu_epi8(mask, lhs));
+            const __m512i r = _mm512_cvtepu8_epi16(_mm256_maskz_loadu_epi8(mask, rhs));
+            sum1 = _mm512_add_epi32(sum1, _mm512_madd_epi16(l, r));
+        }
+
+        return static_cast<ui32>(_mm512_reduce_add_epi32(_mm512_add_epi32(sum0, sum1)));
+    }
+
+    i64 DotProduct(const i32* lhs, const i32* rhs, ui32 length) noexcept {
+        __m512i sum0 = _mm512_setzero_si512();
+        __m512i sum1 = _mm512_setzero_si512();
+
+        while (length >= 32) {
+            sum0 = MulAddI32(sum0, _mm512_loadu_si512(lhs), _mm512_loadu_si512(rhs));
+            sum1 = MulAddI32(sum1, _mm512_loadu_si512(lhs + 16), _mm512_loadu_si512(rhs + 16));
+            lhs += 32;
+            rhs += 32;
+            length -= 32;
+        }
+
+        if (length >= 16) {
+            sum0 = MulAddI32(sum0, _mm512_loadu_si512(lhs), _mm512_loadu_si512(rhs));
+            lhs += 16;
+            rhs += 16;
+            length -= 16;
+        }
+
+        if (length) {
+            const __mmask16 mask = (__mmask16)TailMask32(length);
+            sum1 = MulAddI32(sum1, _mm512_maskz_loadu_epi32(mask, lhs), _mm512_maskz_loadu_epi32(mask, rhs));
+        }
+
+        return _mm512_reduce_add_epi64(_mm512_add_epi64(sum0, sum1));
+    }
+
+    float DotProduct(const float* lhs, const float* rhs, ui32 length) noexcept {
+        __m512 sum0 = _mm512_setzero_ps();
+        __m512 sum1 = _mm512_setzero_ps();
+        __m512 sum2 = _mm512_setzero_ps();
+        __m512 sum3 = _mm512_setzero_ps();
+
+        while (length >= 64) {
+            sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(lhs), _mm512_loadu_ps(rhs), sum0);
+            sum1 = _mm512_fmadd_ps(_mm512_loadu_ps(lhs + 16), _mm512_loadu_ps(rhs + 16), sum1);
+            sum2 = _mm512_fmadd_ps(_mm512_loadu_ps(lhs + 32), _mm512_loadu_ps(rhs + 32), sum2);
+            sum3 = _mm512_fmadd_ps(_mm512_loadu_ps(lhs + 48), _mm512_loadu_ps(rhs + 48), sum3);
+            lhs += 64;
+            rhs += 64;
+            length -= 64;
+        }
+
+        while (length >= 16) {
+            sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(lhs), _mm512_loadu_ps(rhs), sum0);
+            lhs += 16;
+            rhs += 16;
+            length -= 16;
+        }
+
+        if (length) {
+            const __mmask16 mask = (__mmask16)TailMask32(length);
+            sum1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, lhs), _mm512_maskz_loadu_ps(mask, rhs), sum1);
+        }
+
+        return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(sum0, sum1), _mm512_add_ps(sum2, sum3)));
+    }
+
+    double DotProduct(const double* lhs, const double* rhs, ui32 length) noexcept {
+        __m512d sum0 = _mm512_setzero_pd();
+        __m512d sum1 = _mm512_setzero_pd();
+        __m512d sum2 = _mm512_setzero_pd();
+        __m512d sum3 = _mm512_setzero_pd();
+
+        while (length >= 32) {
+            sum0 = _mm512_fmadd_pd(_mm512_loadu_pd(lhs), _mm512_loadu_pd(rhs), sum0);
+            sum1 = _mm512_fmadd_pd(_mm512_loadu_pd(lhs + 8), _mm512_loadu_pd(rhs + 8), sum1);
+            sum2 = _mm512_fmadd_pd(_mm512_loadu_pd(lhs + 16), _mm512_loadu_pd(rhs + 16), sum2);
+            sum3 = _mm512_fmadd_pd(_mm512_loadu_pd(lhs + 24), _mm512_loadu_pd(rhs + 24), sum3);
+            lhs += 32;
+            rhs += 32;
+            length -= 32;
+        }
+
+        while (length >= 8) {
+            sum0 = _mm512_fmadd_pd(_mm512_loadu_pd(lhs), _mm512_loadu_pd(rhs), sum0);
+            lhs += 8;
+            rhs += 8;
+            length -= 8;
+        }
+
+        if (length) {
+            const __mmask8 mask = (__mmask8)TailMask32(length);
+            sum1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, lhs), _mm512_maskz_loadu_pd(mask, rhs), sum1);
+        }
+
+        return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(sum0, sum1), _mm512_add_pd(sum2, sum3)));
+    }
+
+    float L2NormSquared(const float* v, ui32 length) noexcept {
+        __m512 sum0 = _mm512_setzero_ps();
+        __m512 sum1 = _mm512_setzero_ps();
+        __m512 sum2 = _mm512_setzero_ps();
+        __m512 sum3 = _mm512_setzero_ps();
+        __m512 a0, a1, a2, a3;
+
+        while (length >= 64) {
+            a0 = _mm512_loadu_ps(v);
+            a1 = _mm512_loadu_ps(v + 16);
+            a2 = _mm512_loadu_ps(v + 32);
+            a3 = _mm512_loadu_ps(v + 48);
+            sum0 = _mm512_fmadd_ps(a0, a0, sum0);
+            sum1 = _mm512_fmadd_ps(a1, a1, sum1);
+            sum2 = _mm512_fmadd_ps(a2, a2, sum2);
+            sum3 = _mm512_fmadd_ps(a3, a3, sum3);
+            v += 64;
+            length -= 64;
+        }
+
+        while (length >= 16) {
+            a0 = _mm512_loadu_ps(v);
+            sum0 = _mm512_fmadd_ps(a0, a0, sum0);
+            v += 16;
+            length -= 16;
+        }
+
+        if (length) {
+            a1 = _mm512_maskz_loadu_ps((__mmask16)TailMask32(length), v);
+            sum1 = _mm512_fmadd_ps(a1, a1, sum1);
+        }
+
+        return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(sum0, sum1), _mm512_add_ps(sum2, sum3)));
+    }
+
+    void DotProductX4(const i8* query, const i8* rows, ui32 length, i32* result) noexcept {
+        DotProductX4Bytes(query, rows, length, result);
+    }
+
+    void DotProductX4(const ui8* query, const ui8* rows, ui32 length, ui32* result) noexcept {
+        DotProductX4Bytes(query, rows, length, result);
+    }
+
+    void DotProductX4(const float* query, const float* rows, ui32 length, float* result) noexcept {
+        const float* r0 = rows;
+        const float* r1 = rows + length;
+        const float* r2 = rows + 2 * length;
+        const float* r3 = rows + 3 * length;
+        __m512 sum0 = _mm512_setzero_ps();
+        __m512 sum1 = _mm512_setzero_ps();
+        __m512 sum2 = _mm512_setzero_ps();
+        __m512 sum3 = _mm512_setzero_ps();
+
+        ui32 i = 0;
+        for (; i + 16 <= length; i += 16) {
+            const __m512 q = _mm512_loadu_ps(query + i);
+            sum0 = _mm512_fmadd_ps(q, _mm512_loadu_ps(r0 + i), sum0);
+            sum1 = _mm512_fmadd_ps(q, _mm512_loadu_ps(r1 + i), sum1);
+            sum2 = _mm512_fmadd_ps(q, _mm512_loadu_ps(r2 + i), sum2);
+            sum3 = _mm512_fmadd_ps(q, _mm512_loadu_ps(r3 + i), sum3);
+        }
+
+        if (i < length) {
+            const __mmask16 mask = (__mmask16)TailMask32(length - i);
+            const __m512 q = _mm512_maskz_loadu_ps(mask, query + i);
+            sum0 = _mm512_fmadd_ps(q, _mm512_maskz_loadu_ps(mask, r0 + i), sum0);
+            sum1 = _mm512_fmadd_ps(q, _mm512_maskz_loadu_ps(mask, r1 + i), sum1);
+            sum2 = _mm512_fmadd_ps(q, _mm512_maskz_loadu_ps(mask, r2 + i), sum2);
+            sum3 = _mm512_fmadd_ps(q, _mm512_maskz_loadu_ps(mask, r3 + i), sum3);
+        }
+
+        result[0] = _mm512_reduce_add_ps(sum0);
+        result[1] = _mm512_reduce_add_ps(sum1);
+        result[2] = _mm512_reduce_add_ps(sum2);
+        result[3] = _mm512_reduce_add_ps(sum3);
+    }
+
+    void DotProductX2X4(const i8* queries, const i8* rows, ui32 length, i32* result, size_t resultStride) noexcept {
+        DotProductX2X4Bytes(queries, rows, length, result, resultStride);
+    }
+
+    void DotProductX2X4(const ui8* queries, const ui8* rows, ui32 length, ui32* result, size_t resultStride) noexcept {
+        DotProductX2X4Bytes(queries, rows, length, result, resultStride);
+    }
+
+    void DotProductX2X4(const float* queries, const float* rows, ui32 length, float* result, size_t resultStride) noexcept {
+        const float* q0 = queries;
+        const float* q1 = queries + length;
+        const float* r0 = rows;
+        const float* r1 = rows + length;
+        const float* r2 = rows + 2 * length;
+        const float* r3 = rows + 3 * length;
+        __m512 sum00 = _mm512_setzero_ps();
+        __m512 sum01 = _mm512_setzero_ps();
+        __m512 sum02 = _mm512_setzero_ps();
+        __m512 sum03 = _mm512_setzero_ps();
+        __m512 sum10 = _mm512_setzero_ps();
+        __m512 sum11 = _mm512_setzero_ps();
+        __m512 sum12 = _mm512_setzero_ps();
+        __m512 sum13 = _mm512_setzero_ps();
+
+        ui32 i = 0;
+        for (; i + 16 <= length; i += 16) {
+            const __m512 x0 = _mm512_loadu_ps(r0 + i);
+            const __m512 x1 = _mm512_loadu_ps(r1 + i);
+            const __m512 x2 = _mm512_loadu_ps(r2 + i);
+            const __m512 x3 = _mm512_loadu_ps(r3 + i);
+            const __m512 a = _mm512_loadu_ps(q0 + i);
+            sum00 = _mm512_fmadd_ps(a, x0, sum00);
+            sum01 = _mm512_fmadd_ps(a, x1, sum01);
+            sum02 = _mm512_fmadd_ps(a, x2, sum02);
+            sum03 = _mm512_fmadd_ps(a, x3, sum03);
+            const __m512 b = _mm512_loadu_ps(q1 + i);
+            sum10 = _mm512_fmadd_ps(b, x0, sum10);
+            sum11 = _mm512_fmadd_ps(b, x1, sum11);
+            sum12 = _mm512_fmadd_ps(b, x2, sum12);
+            sum13 = _mm512_fmadd_ps(b, x3, sum13);
+        }
+
+        if (i < length) {
+            const __mmask16 mask = (__mmask16)TailMask32(length - i);
+            const __m512 x0 = _mm512_maskz_loadu_ps(mask, r0 + i);
+            const __m512 x1 = _mm512_maskz_loadu_ps(mask, r1 + i);
+            const __m512 x2 = _mm512_maskz_loadu_ps(mask, r2 + i);
+            const __m512 x3 = _mm512_maskz_loadu_ps(mask, r3 + i);
+            const __m512 a = _mm512_maskz_loadu_ps(mask, q0 + i);
+            sum00 = _mm512_fmadd_ps(a, x0, sum00);
+            sum01 = _mm512_fmadd_ps(a, x1, sum01);
+            sum02 = _mm512_fmadd_ps(a, x2, sum02);
+            sum03 = _mm512_fmadd_ps(a, x3, sum03);
+            const __m512 b = _mm512_maskz_loadu_ps(mask, q1 + i);
+            sum10 = _mm512_fmadd_ps(b, x0, sum10);
+            sum11 = _mm512_fmadd_ps(b, x1, sum11);
+            sum12 = _mm512_fmadd_ps(b, x2, sum12);
+            sum13 = _mm512_fmadd_ps(b, x3, sum13);
+        }
+
+        result[0] = _mm512_reduce_add_ps(sum00);
+        result[1] = _mm512_reduce_add_ps(sum01);
+        result[2] = _mm512_reduce_add_ps(sum02);
+        result[3] = _mm512_reduce_add_ps(sum03);
+        result[resultStride + 0] = _mm512_reduce_add_ps(sum10);
+        result[resultStride + 1] = _mm512_reduce_add_ps(sum11);
+        result[resultStride + 2] = _mm512_reduce_add_ps(sum12);
+        result[resultStride + 3] = _mm512_reduce_add_ps(sum13);
+    }
+
+    void DotProductUI4X4(const ui8* query, const ui8* rows, ui32 lengthInBytes, ui32* result) noexcept {
+        const ui8* r0 = rows;
+        const ui8* r1 = rows + lengthInBytes;
+        const ui8* r2 = rows + 2 * lengthInBytes;
+        const ui8* r3 = rows + 3 * lengthInBytes;
+        const __m512i lowNibbles = _mm512_set1_epi8(0x0f);
+        __m512i sum0 = _mm512_setzero_si512();
+        __m512i sum1 = _mm512_setzero_si512();
+        __m512i sum2 = _mm512_setzero_si512();
+        __m512i sum3 = _mm512_setzero_si512();
+
+        // zeroed lanes of the tail do not contribute
+        for (ui32 i = 0; i < lengthInBytes; i += 64) {
+            const __mmask64 mask = lengthInBytes - i >= 64 ? ~0ull : TailMask64(lengthInBytes - i);
+            const __m512i q = _mm512_maskz_loadu_epi8(mask, query + i);
+            const __m512i qLo = _mm512_and_si512(q, lowNibbles);
+            const __m512i qHi = _mm512_and_si512(_mm512_srli_epi16(q, 4), lowNibbles);
+            sum0 = _mm512_add_epi32(sum0, NibbleDotProduct(qLo, qHi, _mm512_maskz_loadu_epi8(mask, r0 + i)));
+            sum1 = _mm512_add_epi32(sum1, NibbleDotProduct(qLo, qHi, _mm512_maskz_loadu_epi8(mask, r1 + i)));
+            sum2 = _mm512_add_epi32(sum2, NibbleDotProduct(qLo, qHi, _mm512_maskz_loadu_epi8(mask, r2 + i)));
+            sum3 = _mm512_add_epi32(sum3, NibbleDotProduct(qLo, qHi, _mm512_maskz_loadu_epi8(mask, r3 + i)));
+        }
+
+        result[0] = static_cast<ui32>(_mm512_reduce_add_epi32(sum0));
+        result[1] = static_cast<ui32>(_mm512_reduce_add_epi32(sum1));
+        result[2] = static_cast<ui32>(_mm512_reduce_add_epi32(sum2));
+        result[3] = static_cast<ui32>(_mm512_reduce_add_epi32(sum3));
+    }
+}
@@ -0,0 +1,212 @@
+#include "dot_product_simd.h"
+
+#include <immintrin.h>
+
+namespace {
+    Y_FORCE_INLINE __mmask64 TailMask64(ui32 length) {
+        return length ? (__mmask64)(~0ull >> (64 - length)) : 0;
+    }
+
+    // vpdpbusd multiplies unsigned bytes of the first operand by signed bytes of the second one,
+    // the other signedness is reduced to it by flipping the high bit of one operand:
+    //     l * r = (l ^ 0x80) * r - 128 * r       for signed l,
+    //     l * r = l * (r ^ 0x80) + 128 * l       for unsigned r,
+    // sums of r or l are accumulated by vpdpbusd with a vector of ones.
+    template <bool isSigned>
+    Y_FORCE_INLINE void DotProductStep(__m512i& sum, __m512i& correction, __m512i l, __m512i r) {
+        const __m512i signBit = _mm512_set1_epi8(-128);
+        const __m512i ones = _mm512_set1_epi8(1);
+        if constexpr (isSigned) {
+            sum = _mm512_dpbusd_epi32(sum, _mm512_xor_si512(l, signBit), r);
+            correction = _mm512_dpbusd_epi32(correction, ones, r);
+        } else {
+            sum = _mm512_dpbusd_epi32(sum, l, _mm512_xor_si512(r, signBit));
+            correction = _mm512_dpbusd_epi32(correction, l, ones);
+        }
+    }
+
+    template <bool isSigned, typename T>
+    Y_FORCE_INLINE ui32 DotProductImpl(const T* lhs, const T* rhs, ui32 length) {
+        __m512i sum0 = _mm512_setzero_si512();
+        __m512i sum1 = _mm512_setzero_si512();
+        __m512i correction0 = _mm512_setzero_si512();
+        __m512i correction1 = _mm512_setzero_si512();
+
+        while (length >= 128) {
+            DotProductStep<isSigned>(sum0, correction0, _mm512_loadu_si512(lhs), _mm512_loadu_si512(rhs));
+            DotProductStep<isSigned>(sum1, correction1, _mm512_loadu_si512(lhs + 64), _mm512_loadu_si512(rhs + 64));
+            lhs += 128;
+            rhs += 128;
+            length -= 128;
+        }
+
+        if (length >= 64) {
+            DotProductStep<isSigned>(sum0, correction0, _mm512_loadu_si512(lhs), _mm512_loadu_si512(rhs));
+            lhs += 64;
+            rhs += 64;
+            length -= 64;
+        }
+
+        if (length) {
+            // zeroed lanes do not contribute to both sums
+            const __mmask64 mask = TailMask64(length);
+            DotProductStep<isSigned>(sum1, correction1, _mm512_maskz_loadu_epi8(mask, lhs), _mm512_maskz_loadu_epi8(mask, rhs));
+        }
+
+        const ui32 sum = static_cast<ui32>(_mm512_reduce_add_epi32(_mm512_add_epi32(sum0, sum1)));
+        const ui32 correction = static_cast<ui32>(_mm512_reduce_add_epi32(_mm512_add_epi32(correction0, correction1)));
+        return isSigned ? sum - 128 * correction : sum + 128 * correction;
+    }
+
+    // the correction term is taken from the query, so it is accumulated once for all 4 rows:
+    //     q * r = (r ^ 0x80) * q - 128 * q       for signed,
+    //     q * r = q * (r ^ 0x80) + 128 * q       for unsigned.
+    template <bool isSigned, typename T, typename TResult>
+    Y_FORCE_INLINE void DotProductX4Impl(const T* query, const T* rows, ui32 length, TResult* result) {
+        const __m512i signBit = _mm512_set1_epi8(-128);
+        const __m512i ones = _mm512_set1_epi8(1);
+        const T* r0 = rows;
+        const T* r1 = rows + length;
+        const T* r2 = rows + 2 * length;
+        const T* r3 = rows + 3 * length;
+        __m512i sum0 = _mm512_setzero_si512();
+        __m512i sum1 = _mm512_setzero_si512();
+        __m512i sum2 = _mm512_setzero_si512();
+        __m512i sum3 = _mm512_setzero_si512();
+        __m512i correction = _mm512_setzero_si512();
+
+        // zeroed lanes do not contribute to the sums
+        for (ui32 i = 0; i < length; i += 64) {
+            const __mmask64 mask = length - i >= 64 ? ~0ull : TailMask64(length - i);
+            const __m512i q = _mm512_maskz_loadu_epi8(mask, query + i);
+            const __m512i x0 = _mm512_maskz_loadu_epi8(mask, r0 + i);
+            const __m512i x1 = _mm512_maskz_loadu_epi8(mask, r1 + i);
+            const __m512i x2 = _mm512_maskz_loadu_epi8(mask, r2 + i);
+            const __m512i x3 = _mm512_maskz_loadu_epi8(mask, r3 + i);
+            if constexpr (isSigned) {
+                sum0 = _mm512_dpbusd_epi32(sum0, _mm512_xor_si512(x0, signBit), q);
+                sum1 = _mm512_dpbusd_epi32(sum1, _mm512_xor_si512(x1, signBit), q);
+                sum2 = _mm512_dpbusd_epi32(sum2, _mm512_xor_si512(x2, signBit), q);
+                sum3 = _mm512_dpbusd_epi32(sum3, _mm512_xor_si512(x3, signBit), q);
+                correction = _mm512_dpbusd_epi32(correction, ones, q);
+            } else {
+                sum0 = _mm512_dpbusd_epi32(sum0, q, _mm512_xor_si512(x0, signBit));
+                sum1 = _mm512_dpbusd_epi32(sum1, q, _mm512_xor_si512(x1, signBit));
+                sum2 = _mm512_dpbusd_epi32(sum2, q, _mm512_xor_si512(x2, signBit));
+                sum3 = _mm512_dpbusd_epi32(sum3, q, _mm512_xor_si512(x3, signBit));
+                correction = _mm512_dpbusd_epi32(correction, q, ones);
+            }
+        }
+
+        const ui32 c = 128 * static_cast<ui32>(_mm512_reduce_add_epi32(correction));
+        const ui32 sums[4] = {
+            static_cast<ui32>(_mm512_reduce_add_epi32(sum0)),
+            static_cast<ui32>(_mm512_reduce_add_epi32(sum1)),
+            static_cast<ui32>(_mm512_reduce_add_epi32(sum2)),
+            static_cast<ui32>(_mm512_reduce_add_epi32(sum3))};
+        for (int k = 0; k < 4; ++k) {
+            result[k] = static_cast<TResult>(isSigned ? sums[k] - c : sums[k] + c);
+        }
+    }
+
+    // 2 x 4 tile of DotProductX4Impl: the rows are flipped once for both queries,
+    // each query keeps its own correction
+    template <bool isSigned, typename T, typename TResult>
+    Y_FORCE_INLINE void DotProductX2X4Impl(const T* queries, const T* rows, ui32 length, TResult* result, size_t resultStride) {
+        const __m512i signBit = _mm512_set1_epi8(-128);
+        const __m512i ones = _mm512_set1_epi8(1);
+        const T* q0 = queries;
+        const T* q1 = queries + length;
+        const T* r0 = rows;
+        const T* r1 = rows + length;
+        const T* r2 = rows + 2 * length;
+        const T* r3 = rows + 3 * length;
+        __m512i sum00 = _mm512_setzero_si512();
+        __m512i sum01 = _mm512_setzero_si512();
+        __m512i sum02 = _mm512_setzero_si512();
+        __m512i sum03 = _mm512_setzero_si512();
+        __m512i sum10 = _mm512_setzero_si512();
+        __m512i sum11 = _mm512_setzero_si512();
+        __m512i sum12 = _mm512_setzero_si512();
+        __m512i sum13 = _mm512_setzero_si512();
+        __m512i correction0 = _mm512_setzero_si512();
+        __m512i correction1 = _mm512_setzero_si512();
+
+        // zeroed lanes do not contribute to the sums
+        for (ui32 i = 0; i < length; i += 64) {
+            const __mmask64 mask = length - i >= 64 ? ~0ull : TailMask64(length - i);
+            const __m512i x0 = _mm512_xor_si512(_mm512_maskz_loadu_epi8(mask, r0 + i), signBit);
+            const __m512i x1 = _mm512_xor_si512(_mm512_maskz_loadu_epi8(mask, r1 + i), signBit);
+            const __m512i x2 = _mm512_xor_si512(_mm512_maskz_loadu_epi8(mask, r2 + i), signBit);
+            const __m512i x3 = _mm512_xor_si512(_mm512_maskz_loadu_epi8(mask, r3 + i), signBit);
+            const __m512i a = _mm512_maskz_loadu_epi8(mask, q0 + i);
+            const __m512i b = _mm512_maskz_loadu_epi8(mask, q1 + i);
+            if constexpr (isSigned) {
+                sum00 = _mm512_dpbusd_epi32(sum00, x0, a);
+                sum01 = _mm512_dpbusd_epi32(sum01, x1, a);
+                sum02 = _mm512_dpbusd_epi32(sum02, x2, a);
+                sum03 = _mm512_dpbusd_epi32(sum03, x3, a);
+                sum10 = _mm512_dpbusd_epi32(sum10, x0, b);
+                sum11 = _mm512_dpbusd_epi32(sum11, x1, b);
+                sum12 = _mm512_dpbusd_epi32(sum12, x2, b);
+                sum13 = _mm512_dpbusd_epi32(sum13, x3, b);
+                correction0 = _mm512_dpbusd_epi32(correction0, ones, a);
+                correction1 = _mm512_dpbusd_epi32(correction1, ones, b);
+            } else {
+                sum00 = _mm512_dpbusd_epi32(sum00, a, x0);
+                sum01 = _mm512_dpbusd_epi32(sum01, a, x1);
+                sum02 = _mm512_dpbusd_epi32(sum02, a, x2);
+                sum03 = _mm512_dpbusd_epi32(sum03, a, x3);
+                sum10 = _mm512_dpbusd_epi32(sum10, b, x0);
+                sum11 = _mm512_dpbusd_epi32(sum11, b, x1);
+                sum12 = _mm512_dpbusd_epi32(sum12, b, x2);
+                sum13 = _mm512_dpbusd_epi32(sum13, b, x3);
+                correction0 = _mm512_dpbusd_epi32(correction0, a, ones);
+                correction1 = _mm512_dpbusd_epi32(correction1, b, ones);
+            }
+        }
+
+        const ui32 c[2] = {
+            128 * static_cast<ui32>(_mm512_reduce_add_epi32(correction0)),
+            128 * static_cast<ui32>(_mm512_reduce_add_epi32(correction1))};
+        const ui32 sums[2][4] = {
+            {static_cast<ui32>(_mm512_reduce_add_epi32(sum00)),
+             static_cast<ui32>(_mm512_reduce_add_epi32(sum01)),
+             static_cast<ui32>(_mm512_reduce_add_epi32(sum02)),
+             static_cast<ui32>(_mm512_reduce_add_epi32(sum03))},
+            {static_cast<ui32>(_mm512_reduce_add_epi32(sum10)),
+             static_cast<ui32>(_mm512_reduce_add_epi32(sum11)),
+             static_cast<ui32>(_mm512_reduce_add_epi32(sum12)),
+             static_cast<ui32>(_mm512_reduce_add_epi32(sum13))}};
+        for (int m = 0; m < 2; ++m) {
+            for (int k = 0; k < 4; ++k) {
+                result[m * resultStride + k] = static_cast<TResult>(isSigned ? sums[m][k] - c[m] : sums[m][k] + c[m]);
+            }
+        }
+    }
+}
+
+namespace NDotProductImpl::NAvx512Vnni {
+    i32 DotProduct(const i8* lhs, const i8* rhs, ui32 length) noexcept {
+        return static_cast<i32>(DotProductImpl<true>(lhs, rhs, length));
+    }
+
+    ui32 DotProduct(const ui8* lhs, const ui8* rhs, ui32 length) noexcept {
+        return DotProductImpl<false>(lhs, rhs, length);
+    }
+
+    void DotProductX4(const i8* query, const i8* rows, ui32 length, i32* result) noexcept {
+        DotProductX4Impl<true>(query, rows, length, result);
+    }
+
+    void DotProductX4(const ui8* query, const ui8* rows, ui32 length, ui32* result) noexcept {
+        DotProductX4Impl<false>(query, rows, length, result);
+    }
+    void DotProductX2X4(const i8* queries, const i8* rows, ui32 length, i32* result, size_t resultStride) noexcept {
+        DotProductX2X4Impl<true>(queries, rows, length, result, resultStride);
+    }
+
+    void DotProductX2X4(const ui8* queries, const ui8* rows, ui32 length, ui32* result, size_t resultStride) noexcept {
+        DotProductX2X4Impl<false>(queries, rows, length, result, resultStride);
+    }
+}
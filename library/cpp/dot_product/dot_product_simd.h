@@ -0,0 +1,90 @@
+#pragma once
+
+#include <util/generic/array_ref.h>
+#include <util/system/compiler.h>
+#include <util/system/platform.h>
+#include <util/system/types.h>
+
+/**
+ * Instruction set specific implementations of dot_product.h functions.
+ * Public functions use the best set supported by cpu, it is chosen once on the first call.
+ */
+namespace NDotProductImpl {
+    struct TDotProductKernels {
+        const char* Name;
+        i32 (*DotProductI8)(const i8* lhs, const i8* rhs, ui32 length) noexcept;
+        ui32 (*DotProductUi8)(const ui8* lhs, const ui8* rhs, ui32 length) noexcept;
+        i64 (*DotProductI32)(const i32* lhs, const i32* rhs, ui32 length) noexcept;
+        float (*DotProductFloat)(const float* lhs, const float* rhs, ui32 length) noexcept;
+        double (*DotProductDouble)(const double* lhs, const double* rhs, ui32 length) noexcept;
+        float (*L2NormSquaredFloat)(const float* v, ui32 length) noexcept;
+
+        // `query` against 4 consecutive rows of `length` elements starting at `rows`
+        void (*DotProductX4I8)(const i8* query, const i8* rows, ui32 length, i32* result) noexcept;
+        void (*DotProductX4Ui8)(const ui8* query, const ui8* rows, ui32 length, ui32* result) noexcept;
+        void (*DotProductX4Float)(const float* query, const float* rows, ui32 length, float* result) noexcept;
+        void (*DotProductUI4X4)(const ui8* query, const ui8* rows, ui32 lengthInBytes, ui32* result) noexcept;
+
+        // 2 consecutive `queries` against 4 consecutive rows, results of the second query start at `result + resultStride`
+        void (*DotProductX2X4I8)(const i8* queries, const i8* rows, ui32 length, i32* result, size_t resultStride) noexcept;
+        void (*DotProductX2X4Ui8)(const ui8* queries, const ui8* rows, ui32 length, ui32* result, size_t resultStride) noexcept;
+        void (*DotProductX2X4Float)(const float* queries, const float* rows, ui32 length, float* result, size_t resultStride) noexcept;
+        void (*DotProductUI4X2X4)(const ui8* queries, const ui8* rows, ui32 lengthInBytes, ui32* result, size_t resultStride) noexcept;
+    };
+
+    // Kernels supported by cpu, from the baseline (SSE or plain C++) to the best one.
+    TArrayRef<const TDotProductKernels* const> GetSupportedKernels() noexcept;
+
+    const TDotProductKernels& GetBestKernels() noexcept;
+
+#if defined(_x86_64_)
+    namespace NAvx2 {
+        i32 DotProduct(const i8* lhs, const i8* rhs, ui32 length) noexcept;
+        ui32 DotProduct(const ui8* lhs, const ui8* rhs, ui32 length) noexcept;
+        i64 DotProduct(const i32* lhs, const i32* rhs, ui32 length) noexcept;
+        float DotProduct(const float* lhs, const float* rhs, ui32 length) noexcept;
+        double DotProduct(const double* lhs, const double* rhs, ui32 length) noexcept;
+        float L2NormSquared(const float* v, ui32 length) noexcept;
+
+        void DotProductX4(const i8* query, const i8* rows, ui32 length, i32* result) noexcept;
+        void DotProductX4(const ui8* query, const ui8* rows, ui32 length, ui32* result) noexcept;
+        void DotProductX4(const float* query, const float* rows, ui32 length, float* result) noexcept;
+        void DotProductUI4X4(const ui8* query, const ui8* rows, ui32 lengthInBytes, ui32* result) noexcept;
+
+        void DotProductX2X4(const i8* queries, const i8* rows, ui32 length, i32* result, size_t resultStride) noexcept;
+        void DotProductX2X4(const ui8* queries, const ui8* rows, ui32 length, ui32* result, size_t resultStride) noexcept;
+        void DotProductX2X4(const float* queries, const float* rows, ui32 length, float* result, size_t resultStride) noexcept;
+    }
+
+    // requires AVX512F, AVX512BW, AVX512DQ and AVX512VL
+    namespace NAvx512 {
+        i32 DotProduct(const i8* lhs, const i8* rhs, ui32 length) noexcept;
+        ui32 DotProduct(const ui8* lhs, const ui8* rhs, ui32 length) noexcept;
+        i64 DotProduct(const i32* lhs, const i32* rhs, ui32 length) noexcept;
+        float DotProduct(const float* lhs, const float* rhs, ui32 length) noexcept;
+        double DotProduct(const double* lhs, const double* rhs, ui32 length) noexcept;
+        float L2NormSquared(const float* v, ui32 length) noexcept;
+
+        void DotProductX4(const i8* query, const i8* rows, ui32 length, i32* result) noexcept;
+        void DotProductX4(const ui8* query, const ui8* rows, ui32 length, ui32* result) noexcept;
+        void DotProductX4(const float* query, const float* rows, ui32 length, float* result) noexcept;
+        void DotProductUI4X4(const ui8* query, const ui8* rows, ui32 lengthInBytes, ui32* result) noexcept;
+
+        void DotProductX2X4(const i8* queries, const i8* rows, ui32 length, i32* result, size_t resultStride) noexcept;
+        void DotProductX2X4(const ui8* queries, const ui8* rows, ui32 length, ui32* result, size_t resultStride) noexcept;
+        void DotProductX2X4(const float* queries, const float* rows, ui32 length, float* result, size_t resultStride) noexcept;
+    }
+
+    // byte kernels built on vpdpbusd, the rest is taken from NAvx512
+    namespace NAvx512Vnni {
+        i32 DotProduct(const i8* lhs, const i8* rhs, ui32 length) noexcept;
+        ui32 DotProduct(const ui8* lhs, const ui8* rhs, ui32 length) noexcept;
+
+        void DotProductX4(const i8* query, const i8* rows, ui32 length, i32* result) noexcept;
+        void DotProductX4(const ui8* query, const ui8* rows, ui32 length, ui32* result) noexcept;
+
+        void DotProductX2X4(const i8* queries, const i8* rows, ui32 length, i32* result, size_t resultStride) noexcept;
+        void DotProductX2X4(const ui8* queries, const ui8* rows, ui32 length, ui32* result, size_t resultStride) noexcept;
+    }
+#endif
+}
@@ -1,4 +1,5 @@
 #include "dot_product.h"
+#include "dot_product_simd.h"
 
 #include <library/cpp/testing/unittest/registar.h>
 
@@ -244,6 +245,147 @@ Y_UNIT_TEST_SUITE(TDocProductTestSuite) {
         UNIT_ASSERT_VALUES_EQUAL(res, 16420179);
     }
 
+    template <class Num, class Res>
+    void CheckKernel(const char* name, Res (*kernel)(const Num*, const Num*, ui32) noexcept, const TVector<Num>& a, const TVector<Num>& b) {
+        for (ui32 i = 0; i < 3; ++i) {
+            for (ui32 length = 0; length + i < a.size(); ++length) {
+                const Res expected = SimpleDotProduct<Res, Num>(a.data() + i, b.data(), length);
+                if constexpr (std::is_floating_point<Res>::value) {
+                    UNIT_ASSERT_DOUBLES_EQUAL_C(kernel(a.data() + i, b.data(), length), expected, EPSILON * (1 + length), name << ' ' << length);
+                } else {
+                    UNIT_ASSERT_VALUES_EQUAL_C(kernel(a.data() + i, b.data(), length), expected, name << ' ' << length);
+                }
+            }
+        }
+    }
+
+    template <class Res, class Num>
+    void CheckKernelX4(const char* name, void (*kernel)(const Num*, const Num*, ui32, Res*) noexcept, Res (*expected)(const Num*, const Num*, ui32) noexcept, const TVector<Num>& query, const TVector<Num>& rows) {
+        for (ui32 length = 0; 4 * length <= rows.size() && length <= query.size(); ++length) {
+            Res result[4];
+            kernel(query.data(), rows.data(), length, result);
+            for (ui32 k = 0; k < 4; ++k) {
+                if constexpr (std::is_floating_point<Res>::value) {
+                    UNIT_ASSERT_DOUBLES_EQUAL_C(result[k], expected(query.data(), rows.data() + k * length, length), EPSILON * (1 + length), name << ' ' << length);
+                } else {
+                    UNIT_ASSERT_VALUES_EQUAL_C(result[k], expected(query.data(), rows.data() + k * length, length), name << ' ' << length);
+                }
+            }
+        }
+    }
+
+    // a tile must give exactly the results of two 1 x 4 kernels, so the matrix does not differ from the batch
+    template <class Res, class Num>
+    void CheckKernelX2X4(const char* name, void (*kernel)(const Num*, const Num*, ui32, Res*, size_t) noexcept, void (*kernelX4)(const Num*, const Num*, ui32, Res*) noexcept, const TVector<Num>& queries, const TVector<Num>& rows) {
+        for (ui32 length = 0; 4 * length <= rows.size() && 2 * length <= queries.size(); ++length) {
+            Res result[2 * 5];
+            kernel(queries.data(), rows.data(), length, result, 5);
+            for (ui32 m = 0; m < 2; ++m) {
+                Res expected[4];
+                kernelX4(queries.data() + m * length, rows.data(), length, expected);
+                for (ui32 k = 0; k < 4; ++k) {
+                    UNIT_ASSERT_EQUAL_C(result[m * 5 + k], expected[k], name << ' ' << length << ' ' << m << ' ' << k);
+                }
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestAllInstructionSets) {
+        TVector<i8> a8(300), b8(300);
+        FillWithRandomNumbers(a8.data(), 179, a8.size());
+        FillWithRandomNumbers(b8.data(), 239, b8.size());
+        TVector<ui8> a8u(300), b8u(300);
+        FillWithRandomNumbers(a8u.data(), 179, a8u.size());
+        FillWithRandomNumbers(b8u.data(), 239, b8u.size());
+        TVector<i32> a32(300), b32(300);
+        FillWithRandomNumbers(a32.data(), 179, a32.size());
+        FillWithRandomNumbers(b32.data(), 239, b32.size());
+        TVector<float> af(300), bf(300);
+        FillWithRandomFloats(af.data(), 179, af.size());
+        FillWithRandomFloats(bf.data(), 239, bf.size());
+        TVector<double> ad(300), bd(300);
+        FillWithRandomFloats(ad.data(), 179, ad.size());
+        FillWithRandomFloats(bd.data(), 239, bd.size());
+        // extreme values for byte kernels which flip sign bits
+        a8[5] = a8[77] = b8[77] = b8[200] = -128;
+        a8u[5] = a8u[77] = b8u[77] = b8u[200] = 255;
+
+        const auto kernels = NDotProductImpl::GetSupportedKernels();
+        UNIT_ASSERT(!kernels.empty());
+        UNIT_ASSERT_EQUAL(&NDotProductImpl::GetBestKernels(), kernels.back());
+        for (const NDotProductImpl::TDotProductKernels* k : kernels) {
+            CheckKernel(k->Name, k->DotProductI8, a8, b8);
+            CheckKernel(k->Name, k->DotProductUi8, a8u, b8u);
+            CheckKernel(k->Name, k->DotProductI32, a32, b32);
+            CheckKernel(k->Name, k->DotProductFloat, af, bf);
+            CheckKernel(k->Name, k->DotProductDouble, ad, bd);
+            for (ui32 length = 0; length < af.size(); ++length) {
+                UNIT_ASSERT_DOUBLES_EQUAL_C(k->L2NormSquaredFloat(af.data(), length), DotProductSlow(af.data(), af.data(), length), EPSILON * (1 + length), k->Name);
+            }
+            CheckKernelX4<i32, i8>(k->Name, k->DotProductX4I8, DotProductSlow, a8, b8);
+            CheckKernelX4<ui32, ui8>(k->Name, k->DotProductX4Ui8, DotProductSlow, a8u, b8u);
+            CheckKernelX4<float, float>(k->Name, k->DotProductX4Float, DotProductSlow, af, bf);
+            CheckKernelX4<ui32, ui8>(k->Name, k->DotProductUI4X4, DotProductUI4Slow, a8u, b8u);
+            CheckKernelX2X4<i32, i8>(k->Name, k->DotProductX2X4I8, k->DotProductX4I8, a8, b8);
+            CheckKernelX2X4<ui32, ui8>(k->Name, k->DotProductX2X4Ui8, k->DotProductX4Ui8, a8u, b8u);
+            CheckKernelX2X4<float, float>(k->Name, k->DotProductX2X4Float, k->DotProductX4Float, af, bf);
+            CheckKernelX2X4<ui32, ui8>(k->Name, k->DotProductUI4X2X4, k->DotProductUI4X4, a8u, b8u);
+        }
+    }
+
+    template <class Res, class Num>
+    void CheckBatchAndMatrix(
+        void (*batch)(const Num*, const Num*, size_t, ui32, Res*) noexcept,
+        void (*matrix)(const Num*, size_t, const Num*, size_t, ui32, Res*) noexcept,
+        Res (*expected)(const Num*, const Num*, ui32) noexcept,
+        const TVector<Num>& lhs, const TVector<Num>& rhs, ui32 length)
+    {
+        const size_t lhsCount = lhs.size() / length;
+        const size_t rhsCount = rhs.size() / length;
+        const auto check = [&](Res actual, const Num* l, const Num* r) {
+            if constexpr (std::is_floating_point<Res>::value) {
+                UNIT_ASSERT_DOUBLES_EQUAL(actual, expected(l, r, length), EPSILON * length);
+            } else {
+                UNIT_ASSERT_VALUES_EQUAL(actual, expected(l, r, length));
+            }
+        };
+
+        TVector<Res> batchResult(rhsCount);
+        batch(lhs.data(), rhs.data(), rhsCount, length, batchResult.data());
+        for (size_t j = 0; j < rhsCount; ++j) {
+            check(batchResult[j], lhs.data(), rhs.data() + j * length);
+        }
+
+        TVector<Res> matrixResult(lhsCount * rhsCount);
+        matrix(lhs.data(), lhsCount, rhs.data(), rhsCount, length, matrixResult.data());
+        for (size_t i = 0; i < lhsCount; ++i) {
+            batch(lhs.data() + i * length, rhs.data(), rhsCount, length, batchResult.data());
+            for (size_t j = 0; j < rhsCount; ++j) {
+                check(matrixResult[i * rhsCount + j], lhs.data() + i * length, rhs.data() + j * length);
+                UNIT_ASSERT_EQUAL(matrixResult[i * rhsCount + j], batchResult[j]);
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestBatchAndMatrix) {
+        // 7 lhs rows and 4103 rhs rows, more than one cache block of rhs for the matrix
+        const ui32 length = 37;
+        TVector<i8> l8(7 * length), r8(4103 * length);
+        FillWithRandomNumbers(l8.data(), 179, l8.size());
+        FillWithRandomNumbers(r8.data(), 239, r8.size());
+        TVector<ui8> l8u(7 * length), r8u(4103 * length);
+        FillWithRandomNumbers(l8u.data(), 179, l8u.size());
+        FillWithRandomNumbers(r8u.data(), 239, r8u.size());
+        TVector<float> lf(7 * length), rf(4103 * length);
+        FillWithRandomFloats(lf.data(), 179, lf.size());
+        FillWithRandomFloats(rf.data(), 239, rf.size());
+
+        CheckBatchAndMatrix<i32, i8>(DotProductBatch, DotProductMatrix, DotProductSlow, l8, r8, length);
+        CheckBatchAndMatrix<ui32, ui8>(DotProductBatch, DotProductMatrix, DotProductSlow, l8u, r8u, length);
+        CheckBatchAndMatrix<ui32, ui8>(DotProductUI4Batch, DotProductUI4Matrix, DotProductUI4Slow, l8u, r8u, length);
+        CheckBatchAndMatrix<float, float>(DotProductBatch, DotProductMatrix, DotProductSlow, lf, rf, length);
+    }
+
     Y_UNIT_TEST(TestDotProductUI4Manual) {
         static ui8 a[4] = {1 + (3 << 4), 15 + (8 << 4), 0 + (5 << 4), 3 + (1 << 4)};
         static ui8 b[4] = {2 + (4 << 4), 1 + (8 << 4), 7 + (0 << 4), 1 + (4 << 4)};
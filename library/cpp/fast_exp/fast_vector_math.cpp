@@ -0,0 +1,173 @@
+#include "fast_vector_math.h"
+#include "fast_vector_math_kernels.h"
+#include "fast_vector_math_simd.h"
+
+#include <util/generic/cast.h>
+#include <util/system/cpu_id.h>
+
+#include <cmath>
+
+namespace {
+    // the same algorithms one value at a time, `TInt` is the integer of the same size as `T`
+    template <typename TValue, typename TInt, int mantissaBits, int exponentBias>
+    struct TScalar {
+        using T = TValue;
+        using TReg = T;
+        using TMask = bool;
+        static constexpr size_t Width = 1;
+
+        static Y_FORCE_INLINE T Load(const T* p) {
+            return *p;
+        }
+        static Y_FORCE_INLINE void Store(T* p, T v) {
+            *p = v;
+        }
+        static Y_FORCE_INLINE T Set1(T v) {
+            return v;
+        }
+        static Y_FORCE_INLINE T Add(T a, T b) {
+            return a + b;
+        }
+        static Y_FORCE_INLINE T Sub(T a, T b) {
+            return a - b;
+        }
+        static Y_FORCE_INLINE T Mul(T a, T b) {
+            return a * b;
+        }
+        static Y_FORCE_INLINE T Div(T a, T b) {
+            return a / b;
+        }
+        static Y_FORCE_INLINE T MulAdd(T a, T b, T c) {
+            return a * b + c;
+        }
+        static Y_FORCE_INLINE T Min(T a, T b) {
+            return b < a ? b : a;
+        }
+        static Y_FORCE_INLINE T Max(T a, T b) {
+            return a < b ? b : a;
+        }
+        // exact for |a| < 2^(mantissaBits - 1)
+        static Y_FORCE_INLINE T Round(T a) {
+            constexpr T magic = T(3) * (TInt(1) << (mantissaBits - 1));
+            return (a + magic) - magic;
+        }
+        static Y_FORCE_INLINE bool Less(T a, T b) {
+            return a < b;
+        }
+        static Y_FORCE_INLINE T Select(bool mask, T a, T b) {
+            return mask ? a : b;
+        }
+        static Y_FORCE_INLINE T Abs(T a) {
+            return std::abs(a);
+        }
+        static Y_FORCE_INLINE T CopySign(T magnitude, T sign) {
+            return std::copysign(magnitude, sign);
+        }
+        static Y_FORCE_INLINE T Ldexp(T x, T n) {
+            return x * BitCast<T>(static_cast<TInt>(static_cast<TInt>(n) + exponentBias) << mantissaBits);
+        }
+        static Y_FORCE_INLINE void Frexp(T x, T& m, T& e) {
+            const TInt bits = BitCast<TInt>(x);
+            constexpr TInt mantissaMask = (TInt(1) << mantissaBits) - 1;
+            e = static_cast<T>((bits >> mantissaBits) - exponentBias);
+            m = BitCast<T>((bits & mantissaMask) | (TInt(exponentBias) << mantissaBits));
+        }
+        static Y_FORCE_INLINE T ReduceAdd(T v) {
+            return v;
+        }
+        static Y_FORCE_INLINE T ReduceMax(T v) {
+            return v;
+        }
+    };
+
+    using TScalarFloat = TScalar<float, i32, 23, 127>;
+    using TScalarDouble = TScalar<double, i64, 52, 1023>;
+}
+
+namespace NFastVectorMathImpl {
+    namespace {
+        constexpr TVectorMathKernels BaselineKernels = {
+            "scalar",
+            ExpArray<TScalarFloat>, ExpArray<TScalarDouble>,
+            LogArray<TScalarFloat>, LogArray<TScalarDouble>,
+            Log2Array<TScalarFloat>, Log2Array<TScalarDouble>,
+            LogisticArray<TScalarFloat>, LogisticArray<TScalarDouble>,
+            TanhArray<TScalarFloat>, TanhArray<TScalarDouble>,
+            SoftmaxArray<TScalarFloat>, SoftmaxArray<TScalarDouble>};
+
+        struct TSupportedKernels {
+            const TVectorMathKernels* Kernels[3];
+            size_t Count = 0;
+
+            TSupportedKernels() noexcept {
+                Kernels[Count++] = &BaselineKernels;
+#if defined(_x86_64_)
+                if (NX86::CachedHaveAVX2()) {
+                    Kernels[Count++] = &NAvx2::Kernels;
+                }
+                if (NX86::CachedHaveAVX512F() && NX86::CachedHaveAVX512DQ()) {
+                    Kernels[Count++] = &NAvx512::Kernels;
+                }
+#endif
+            }
+        };
+    }
+
+    TArrayRef<const TVectorMathKernels* const> GetSupportedKernels() noexcept {
+        static const TSupportedKernels supported;
+        return {supported.Kernels, supported.Count};
+    }
+
+    const TVectorMathKernels& GetBestKernels() noexcept {
+        static const TVectorMathKernels* const best = GetSupportedKernels().back();
+        return *best;
+    }
+}
+
+void FastExp(const float* src, float* dst, size_t count) noexcept {
+    NFastVectorMathImpl::GetBestKernels().ExpFloat(src, dst, count);
+}
+
+void FastExp(const double* src, double* dst, size_t count) noexcept {
+    NFastVectorMathImpl::GetBestKernels().ExpDouble(src, dst, count);
+}
+
+void FastLog(const float* src, float* dst, size_t count) noexcept {
+    NFastVectorMathImpl::GetBestKernels().LogFloat(src, dst, count);
+}
+
+void FastLog(const double* src, double* dst, size_t count) noexcept {
+    NFastVectorMathImpl::GetBestKernels().LogDouble(src, dst, count);
+}
+
+void FastLog2(const float* src, float* dst, size_t count) noexcept {
+    NFastVectorMathImpl::GetBestKernels().Log2Float(src, dst, count);
+}
+
+void FastLog2(const double* src, double* dst, size_t count) noexcept {
+    NFastVectorMathImpl::GetBestKernels().Log2Double(src, dst, count);
+}
+
+void FastLogistic(const float* src, float* dst, size_t count) noexcept {
+    NFastVectorMathImpl::GetBestKernels().LogisticFloat(src, dst, count);
+}
+
+void FastLogistic(const double* src, double* dst, size_t count) noexcept {
+    NFastVectorMathImpl::GetBestKernels().LogisticDouble(src, dst, count);
+}
+
+void FastTanh(const float* src, float* dst, size_t count) noexcept {
+    NFastVectorMathImpl::GetBestKernels().TanhFloat(src, dst, count);
+}
+
+void FastTanh(const double* src, double* dst, size_t count) noexcept {
+    NFastVectorMathImpl::GetBestKernels().TanhDouble(src, dst, count);
+}
+
+void FastSoftmax(const float* src, float* dst, size_t count) noexcept {
+    NFastVectorMathImpl::GetBestKernels().SoftmaxFloat(src, dst, count);
+}
+
+void FastSoftmax(const double* src, double* dst, size_t count) noexcept {
+    NFastVectorMathImpl::GetBestKernels().SoftmaxDouble(src, dst, count);
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <stddef.h>
+
+/**
+ * Element-wise math over float and double arrays, using AVX2 or AVX-512 when cpu supports them.
+ * `dst` may be equal to `src` (the *Inplace variants do exactly that), other overlaps are not allowed.
+ * Results differ between instruction sets in the last bits, do not use them for canonization.
+ *
+ * Maximal errors measured on random arguments over the whole ranges (see fast_exp/vector_accuracy):
+ *                       float       double
+ *     FastExp           1e-7        2e-16       relative
+ *     FastLog           1.1e-7      2e-16       absolute, relative for |log(x)| > 1
+ *     FastLog2          1.1e-7      2e-16       absolute, relative for |log2(x)| > 1
+ *     FastLogistic      1.4e-7      3e-16       relative, for x >= -87 / -708 (normal results)
+ *     FastTanh          1.4e-7      3e-16       relative
+ *     FastSoftmax       1.2e-6      5e-15       relative, for rows with max(x) - min(x) <= 20,
+ *                                               grows linearly with that difference
+ *
+ * There is no Inf/NaN handling (as in fast_exp):
+ * - FastExp results are flushed to zero below ln(min normal) and saturate near exp(88.37) / exp(709.08);
+ * - FastLog and FastLog2 accept positive normal numbers only;
+ * - FastLogistic stops decreasing below -88.37 / -709.08, where exp(-x) saturates: it returns about
+ *   4e-39 / 1e-308 there instead of a smaller subnormal or zero.
+ */
+void FastExp(const float* src, float* dst, size_t count) noexcept;
+void FastExp(const double* src, double* dst, size_t count) noexcept;
+
+void FastLog(const float* src, float* dst, size_t count) noexcept;
+void FastLog(const double* src, double* dst, size_t count) noexcept;
+
+void FastLog2(const float* src, float* dst, size_t count) noexcept;
+void FastLog2(const double* src, double* dst, size_t count) noexcept;
+
+// 1 / (1 + exp(-x))
+void FastLogistic(const float* src, float* dst, size_t count) noexcept;
+void FastLogistic(const double* src, double* dst, size_t count) noexcept;
+
+void FastTanh(const float* src, float* dst, size_t count) noexcept;
+void FastTanh(const double* src, double* dst, size_t count) noexcept;
+
+// exp(x[i] - max(x)) / sum(exp(x[j] - max(x))) over the whole row, never overflows
+void FastSoftmax(const float* src, float* dst, size_t count) noexcept;
+void FastSoftmax(const double* src, double* dst, size_t count) noexcept;
+
+// FastExpInplace(double*, size_t) is declared in fast_exp.h
+inline void FastExpInplace(float* x, size_t count) noexcept {
+    FastExp(x, x, count);
+}
+
+inline void FastLogInplace(float* x, size_t count) noexcept {
+    FastLog(x, x, count);
+}
+
+inline void FastLogInplace(double* x, size_t count) noexcept {
+    FastLog(x, x, count);
+}
+
+inline void FastLog2Inplace(float* x, size_t count) noexcept {
+    FastLog2(x, x, count);
+}
+
+inline void FastLog2Inplace(double* x, size_t count) noexcept {
+    FastLog2(x, x, count);
+}
+
+inline void FastLogisticInplace(float* x, size_t count) noexcept {
+    FastLogistic(x, x, count);
+}
+
+inline void FastLogisticInplace(double* x, size_t count) noexcept {
+    FastLogistic(x, x, count);
+}
+
+inline void FastTanhInplace(float* x, size_t count) noexcept {
+    FastTanh(x, x, count);
+}
+
+inline void FastTanhInplace(double* x, size_t count) noexcept {
+    FastTanh(x, x, count);
+}
+
+inline void FastSoftmaxInplace(float* x, size_t count) noexcept {
+    FastSoftmax(x, x, count);
+}
+
+inline void FastSoftmaxInplace(double* x, size_t count) noexcept {
+    FastSoftmax(x, x, count);
+}
@@ -0,0 +1,167 @@
+#include "fast_vector_math_kernels.h"
+#include "fast_vector_math_simd.h"
+
+#include <immintrin.h>
+
+namespace {
+    struct TAvx2Float {
+        using T = float;
+        using TReg = __m256;
+        using TMask = __m256;
+        static constexpr size_t Width = 8;
+
+        static Y_FORCE_INLINE TReg Load(const T* p) {
+            return _mm256_loadu_ps(p);
+        }
+        static Y_FORCE_INLINE void Store(T* p, TReg v) {
+            _mm256_storeu_ps(p, v);
+        }
+        static Y_FORCE_INLINE TReg Set1(T v) {
+            return _mm256_set1_ps(v);
+        }
+        static Y_FORCE_INLINE TReg Add(TReg a, TReg b) {
+            return _mm256_add_ps(a, b);
+        }
+        static Y_FORCE_INLINE TReg Sub(TReg a, TReg b) {
+            return _mm256_sub_ps(a, b);
+        }
+        static Y_FORCE_INLINE TReg Mul(TReg a, TReg b) {
+            return _mm256_mul_ps(a, b);
+        }
+        static Y_FORCE_INLINE TReg Div(TReg a, TReg b) {
+            return _mm256_div_ps(a, b);
+        }
+        static Y_FORCE_INLINE TReg MulAdd(TReg a, TReg b, TReg c) {
+            return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+        }
+        static Y_FORCE_INLINE TReg Min(TReg a, TReg b) {
+            return _mm256_min_ps(a, b);
+        }
+        static Y_FORCE_INLINE TReg Max(TReg a, TReg b) {
+            return _mm256_max_ps(a, b);
+        }
+        static Y_FORCE_INLINE TReg Round(TReg a) {
+            return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        }
+        static Y_FORCE_INLINE TMask Less(TReg a, TReg b) {
+            return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+        }
+        static Y_FORCE_INLINE TReg Select(TMask mask, TReg a, TReg b) {
+            return _mm256_blendv_ps(b, a, mask);
+        }
+        static Y_FORCE_INLINE TReg Abs(TReg a) {
+            return _mm256_andnot_ps(_mm256_set1_ps(-0.f), a);
+        }
+        static Y_FORCE_INLINE TReg CopySign(TReg magnitude, TReg sign) {
+            return _mm256_or_ps(magnitude, _mm256_and_ps(sign, _mm256_set1_ps(-0.f)));
+        }
+        static Y_FORCE_INLINE TReg Ldexp(TReg x, TReg n) {
+            const __m256i bits = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23);
+            return _mm256_mul_ps(x, _mm256_castsi256_ps(bits));
+        }
+        static Y_FORCE_INLINE void Frexp(TReg x, TReg& m, TReg& e) {
+            const __m256i bits = _mm256_castps_si256(x);
+            e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(127)));
+            m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007fffff)), _mm256_set1_epi32(0x3f800000)));
+        }
+        static Y_FORCE_INLINE T ReduceAdd(TReg v) {
+            __m128 x = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+            x = _mm_add_ps(x, _mm_movehl_ps(x, x));
+            x = _mm_add_ss(x, _mm_movehdup_ps(x));
+            return _mm_cvtss_f32(x);
+        }
+        static Y_FORCE_INLINE T ReduceMax(TReg v) {
+            __m128 x = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+            x = _mm_max_ps(x, _mm_movehl_ps(x, x));
+            x = _mm_max_ss(x, _mm_movehdup_ps(x));
+            return _mm_cvtss_f32(x);
+        }
+    };
+
+    struct TAvx2Double {
+        using T = double;
+        using TReg = __m256d;
+        using TMask = __m256d;
+        static constexpr size_t Width = 4;
+
+        static Y_FORCE_INLINE TReg Load(const T* p) {
+            return _mm256_loadu_pd(p);
+        }
+        static Y_FORCE_INLINE void Store(T* p, TReg v) {
+            _mm256_storeu_pd(p, v);
+        }
+        static Y_FORCE_INLINE TReg Set1(T v) {
+            return _mm256_set1_pd(v);
+        }
+        static Y_FORCE_INLINE TReg Add(TReg a, TReg b) {
+            return _mm256_add_pd(a, b);
+        }
+        static Y_FORCE_INLINE TReg Sub(TReg a, TReg b) {
+            return _mm256_sub_pd(a, b);
+        }
+        static Y_FORCE_INLINE TReg Mul(TReg a, TReg b) {
+            return _mm256_mul_pd(a, b);
+        }
+        static Y_FORCE_INLINE TReg Div(TReg a, TReg b) {
+            return _mm256_div_pd(a, b);
+        }
+        static Y_FORCE_INLINE TReg MulAdd(TReg a, TReg b, TReg c) {
+            return _mm256_add_pd(_mm256_mul_pd(a, b), c);
+        }
+        static Y_FORCE_INLINE TReg Min(TReg a, TReg b) {
+            return _mm256_min_pd(a, b);
+        }
+        static Y_FORCE_INLINE TReg Max(TReg a, TReg b) {
+            return _mm256_max_pd(a, b);
+        }
+        static Y_FORCE_INLINE TReg Round(TReg a) {
+            return _mm256_round_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        }
+        static Y_FORCE_INLINE TMask Less(TReg a, TReg b) {
+            return _mm256_cmp_pd(a, b, _CMP_LT_OQ);
+        }
+        static Y_FORCE_INLINE TReg Select(TMask mask, TReg a, TReg b) {
+            return _mm256_blendv_pd(b, a, mask);
+        }
+        static Y_FORCE_INLINE TReg Abs(TReg a) {
+            return _mm256_andnot_pd(_mm256_set1_pd(-0.), a);
+        }
+        static Y_FORCE_INLINE TReg CopySign(TReg magnitude, TReg sign) {
+            return _mm256_or_pd(magnitude, _mm256_and_pd(sign, _mm256_set1_pd(-0.)));
+        }
+        // there is no double <-> i64 conversion in AVX2: adding 1.5 * 2^52 puts an integer-valued
+        // double into the low mantissa bits, the exponent of 2^52 is subtracted back for Frexp
+        static Y_FORCE_INLINE TReg Ldexp(TReg x, TReg n) {
+            const __m256i low = _mm256_castpd_si256(_mm256_add_pd(n, _mm256_set1_pd(6755399441055744.)));
+            const __m256i bits = _mm256_slli_epi64(_mm256_add_epi64(low, _mm256_set1_epi64x(1023)), 52);
+            return _mm256_mul_pd(x, _mm256_castsi256_pd(bits));
+        }
+        static Y_FORCE_INLINE void Frexp(TReg x, TReg& m, TReg& e) {
+            const __m256i bits = _mm256_castpd_si256(x);
+            const __m256d biased = _mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(bits, 52), _mm256_castpd_si256(_mm256_set1_pd(4503599627370496.))));
+            e = _mm256_sub_pd(biased, _mm256_set1_pd(4503599627370496. + 1023));
+            m = _mm256_castsi256_pd(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi64x(0x000fffffffffffffll)), _mm256_set1_epi64x(0x3ff0000000000000ll)));
+        }
+        static Y_FORCE_INLINE T ReduceAdd(TReg v) {
+            __m128d x = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+            x = _mm_add_sd(x, _mm_unpackhi_pd(x, x));
+            return _mm_cvtsd_f64(x);
+        }
+        static Y_FORCE_INLINE T ReduceMax(TReg v) {
+            __m128d x = _mm_max_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+            x = _mm_max_sd(x, _mm_unpackhi_pd(x, x));
+            return _mm_cvtsd_f64(x);
+        }
+    };
+}
+
+namespace NFastVectorMathImpl::NAvx2 {
+    const TVectorMathKernels Kernels = {
+        "avx2",
+        ExpArray<TAvx2Float>, ExpArray<TAvx2Double>,
+        LogArray<TAvx2Float>, LogArray<TAvx2Double>,
+        Log2Array<TAvx2Float>, Log2Array<TAvx2Double>,
+        LogisticArray<TAvx2Float>, LogisticArray<TAvx2Double>,
+        TanhArray<TAvx2Float>, TanhArray<TAvx2Double>,
+        SoftmaxArray<TAvx2Float>, SoftmaxArray<TAvx2Double>};
+}
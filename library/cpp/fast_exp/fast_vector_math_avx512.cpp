@@ -0,0 +1,149 @@
+#include "fast_vector_math_kernels.h"
+#include "fast_vector_math_simd.h"
+
+#include <immintrin.h>
+
+namespace {
+    struct TAvx512Float {
+        using T = float;
+        using TReg = __m512;
+        using TMask = __mmask16;
+        static constexpr size_t Width = 16;
+
+        static Y_FORCE_INLINE TReg Load(const T* p) {
+            return _mm512_loadu_ps(p);
+        }
+        static Y_FORCE_INLINE void Store(T* p, TReg v) {
+            _mm512_storeu_ps(p, v);
+        }
+        static Y_FORCE_INLINE TReg Set1(T v) {
+            return _mm512_set1_ps(v);
+        }
+        static Y_FORCE_INLINE TReg Add(TReg a, TReg b) {
+            return _mm512_add_ps(a, b);
+        }
+        static Y_FORCE_INLINE TReg Sub(TReg a, TReg b) {
+            return _mm512_sub_ps(a, b);
+        }
+        static Y_FORCE_INLINE TReg Mul(TReg a, TReg b) {
+            return _mm512_mul_ps(a, b);
+        }
+        static Y_FORCE_INLINE TReg Div(TReg a, TReg b) {
+            return _mm512_div_ps(a, b);
+        }
+        static Y_FORCE_INLINE TReg MulAdd(TReg a, TReg b, TReg c) {
+            return _mm512_fmadd_ps(a, b, c);
+        }
+        static Y_FORCE_INLINE TReg Min(TReg a, TReg b) {
+            return _mm512_min_ps(a, b);
+        }
+        static Y_FORCE_INLINE TReg Max(TReg a, TReg b) {
+            return _mm512_max_ps(a, b);
+        }
+        static Y_FORCE_INLINE TReg Round(TReg a) {
+            return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        }
+        static Y_FORCE_INLINE TMask Less(TReg a, TReg b) {
+            return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ);
+        }
+        static Y_FORCE_INLINE TReg Select(TMask mask, TReg a, TReg b) {
+            return _mm512_mask_blend_ps(mask, b, a);
+        }
+        static Y_FORCE_INLINE TReg Abs(TReg a) {
+            return _mm512_abs_ps(a);
+        }
+        static Y_FORCE_INLINE TReg CopySign(TReg magnitude, TReg sign) {
+            return _mm512_or_ps(magnitude, _mm512_and_ps(sign, _mm512_set1_ps(-0.f)));
+        }
+        static Y_FORCE_INLINE TReg Ldexp(TReg x, TReg n) {
+            return _mm512_scalef_ps(x, n);
+        }
+        static Y_FORCE_INLINE void Frexp(TReg x, TReg& m, TReg& e) {
+            m = _mm512_getmant_ps(x, _MM_MANT_NORM_1_2, _MM_MANT_SIGN_src);
+            e = _mm512_getexp_ps(x);
+        }
+        static Y_FORCE_INLINE T ReduceAdd(TReg v) {
+            return _mm512_reduce_add_ps(v);
+        }
+        static Y_FORCE_INLINE T ReduceMax(TReg v) {
+            return _mm512_reduce_max_ps(v);
+        }
+    };
+
+    struct TAvx512Double {
+        using T = double;
+        using TReg = __m512d;
+        using TMask = __mmask8;
+        static constexpr size_t Width = 8;
+
+        static Y_FORCE_INLINE TReg Load(const T* p) {
+            return _mm512_loadu_pd(p);
+        }
+        static Y_FORCE_INLINE void Store(T* p, TReg v) {
+            _mm512_storeu_pd(p, v);
+        }
+        static Y_FORCE_INLINE TReg Set1(T v) {
+            return _mm512_set1_pd(v);
+        }
+        static Y_FORCE_INLINE TReg Add(TReg a, TReg b) {
+            return _mm512_add_pd(a, b);
+        }
+        static Y_FORCE_INLINE TReg Sub(TReg a, TReg b) {
+            return _mm512_sub_pd(a, b);
+        }
+        static Y_FORCE_INLINE TReg Mul(TReg a, TReg b) {
+            return _mm512_mul_pd(a, b);
+        }
+        static Y_FORCE_INLINE TReg Div(TReg a, TReg b) {
+            return _mm512_div_pd(a, b);
+        }
+        static Y_FORCE_INLINE TReg MulAdd(TReg a, TReg b, TReg c) {
+            return _mm512_fmadd_pd(a, b, c);
+        }
+        static Y_FORCE_INLINE TReg Min(TReg a, TReg b) {
+            return _mm512_min_pd(a, b);
+        }
+        static Y_FORCE_INLINE TReg Max(TReg a, TReg b) {
+            return _mm512_max_pd(a, b);
+        }
+        static Y_FORCE_INLINE TReg Round(TReg a) {
+            return _mm512_roundscale_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        }
+        static Y_FORCE_INLINE TMask Less(TReg a, TReg b) {
+            return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ);
+        }
+        static Y_FORCE_INLINE TReg Select(TMask mask, TReg a, TReg b) {
+            return _mm512_mask_blend_pd(mask, b, a);
+        }
+        static Y_FORCE_INLINE TReg Abs(TReg a) {
+            return _mm512_abs_pd(a);
+        }
+        static Y_FORCE_INLINE TReg CopySign(TReg magnitude, TReg sign) {
+            return _mm512_or_pd(magnitude, _mm512_and_pd(sign, _mm512_set1_pd(-0.)));
+        }
+        static Y_FORCE_INLINE TReg Ldexp(TReg x, TReg n) {
+            return _mm512_scalef_pd(x, n);
+        }
+        static Y_FORCE_INLINE void Frexp(TReg x, TReg& m, TReg& e) {
+            m = _mm512_getmant_pd(x, _MM_MANT_NORM_1_2, _MM_MANT_SIGN_src);
+            e = _mm512_getexp_pd(x);
+        }
+        static Y_FORCE_INLINE T ReduceAdd(TReg v) {
+            return _mm512_reduce_add_pd(v);
+        }
+        static Y_FORCE_INLINE T ReduceMax(TReg v) {
+            return _mm512_reduce_max_pd(v);
+        }
+    };
+}
+
+namespace NFastVectorMathImpl::NAvx512 {
+    const TVectorMathKernels Kernels = {
+        "avx512",
+        ExpArray<TAvx512Float>, ExpArray<TAvx512Double>,
+        LogArray<TAvx512Float>, LogArray<TAvx512Double>,
+        Log2Array<TAvx512Float>, Log2Array<TAvx512Double>,
+        LogisticArray<TAvx512Float>, LogisticArray<TAvx512Double>,
+        TanhArray<TAvx512Float>, TanhArray<TAvx512Double>,
+        SoftmaxArray<TAvx512Float>, SoftmaxArray<TAvx512Double>};
+}
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <util/system/compiler.h>
+#include <util/system/types.h>
+
+#include <cstring>
+#include <limits>
+
+/**
+ * Algorithms of fast_vector_math.h written once over a vector type `V`. Every instruction set
+ * provides its own `V` (see fast_vector_math_avx2.cpp) and instantiates these templates in its
+ * own translation unit, so nothing here may be used outside of such a unit.
+ *
+ * `V` has: `T` (float or double), `TReg`, `TMask`, `Width`, `Load`, `Store`, `Set1`, `Add`, `Sub`,
+ * `Mul`, `Div`, `MulAdd(a, b, c) = a * b + c`, `Min`, `Max`, `Round` (to nearest integer), `Less`,
+ * `Select(mask, a, b) = mask ? a : b`, `Abs`, `CopySign(magnitude, sign)`, `Ldexp(x, n) = x * 2^n`,
+ * `Frexp(x, m, e)` (x = m * 2^e, m in [1, 2), positive normal x only), `ReduceAdd`, `ReduceMax`.
+ */
+namespace NFastVectorMathImpl {
+    template <typename T>
+    struct TConstants;
+
+    template <>
+    struct TConstants<float> {
+        // exp(ExpMax) still fits into float with 2^n scaling, exp(x) for x < ExpMin is flushed to zero
+        static constexpr float ExpMax = 88.3762626647949f;
+        static constexpr float ExpMin = -87.3365447505531f;
+        static constexpr float Log2e = 1.44269504088896341f;
+        // ln(2) = Ln2Hi + Ln2Lo, n * Ln2Hi is exact for the exponents in use
+        static constexpr float Ln2Hi = 0.693359375f;
+        static constexpr float Ln2Lo = -2.12194440e-4f;
+        static constexpr float Sqrt2 = 1.41421356237309505f;
+        // 1 / k! for k = 7..0, the remainder is below 1.2e-8 on [-ln(2) / 2, ln(2) / 2]
+        static constexpr float ExpPoly[] = {1.f / 5040, 1.f / 720, 1.f / 120, 1.f / 24, 1.f / 6, 1.f / 2, 1.f, 1.f};
+        // 1 / (2k + 1) for k = 4..0 of atanh series, |s| <= 0.1716
+        static constexpr float LogPoly[] = {1.f / 9, 1.f / 7, 1.f / 5, 1.f / 3, 1.f};
+        static constexpr float TanhSmall = 0.625f;
+        // tanh(x) = x + x^3 * P(x^2) for |x| < TanhSmall (Cephes tanhf)
+        static constexpr float TanhPoly[] = {-5.70498872745e-3f, 2.06390887954e-2f, -5.37397155531e-2f, 1.33314422036e-1f, -3.33332819422e-1f};
+    };
+
+    template <>
+    struct TConstants<double> {
+        static constexpr double ExpMax = 709.08956571282405;
+        static constexpr double ExpMin = -708.39641853226408;
+        static constexpr double Log2e = 1.44269504088896340736;
+        static constexpr double Ln2Hi = 6.93145751953125e-1;
+        static constexpr double Ln2Lo = 1.42860682030941723212e-6;
+        static constexpr double Sqrt2 = 1.41421356237309504880;
+        // 1 / k! for k = 13..0, the remainder is below 4e-18 on [-ln(2) / 2, ln(2) / 2]
+        static constexpr double ExpPoly[] = {
+            1. / 6227020800, 1. / 479001600, 1. / 39916800, 1. / 3628800, 1. / 362880, 1. / 40320, 1. / 5040,
+            1. / 720, 1. / 120, 1. / 24, 1. / 6, 1. / 2, 1., 1.};
+        // 1 / (2k + 1) for k = 9..0 of atanh series, |s| <= 0.1716
+        static constexpr double LogPoly[] = {1. / 19, 1. / 17, 1. / 15, 1. / 13, 1. / 11, 1. / 9, 1. / 7, 1. / 5, 1. / 3, 1.};
+        static constexpr double TanhSmall = 0.625;
+        // tanh(x) = x + x^3 * P(x^2) / Q(x^2) for |x| < TanhSmall, Q is monic (Cephes tanh)
+        static constexpr double TanhP[] = {-9.64399179425052238628e-1, -9.92877231001918586564e1, -1.61468768441708447952e3};
+        static constexpr double TanhQ[] = {1., 1.12811678491632931402e2, 2.23548839060100448583e3, 4.84406305325125486048e3};
+    };
+
+    template <class V, size_t N>
+    Y_FORCE_INLINE typename V::TReg Polynomial(typename V::TReg x, const typename V::T (&coefficients)[N]) {
+        typename V::TReg p = V::Set1(coefficients[0]);
+        for (size_t i = 1; i < N; ++i) {
+            p = V::MulAdd(p, x, V::Set1(coefficients[i]));
+        }
+        return p;
+    }
+
+    // exp(x) = 2^n * exp(r), |r| <= ln(2) / 2
+    template <class V>
+    Y_FORCE_INLINE typename V::TReg Exp(typename V::TReg x) {
+        using C = TConstants<typename V::T>;
+        const auto underflow = V::Less(x, V::Set1(C::ExpMin));
+        x = V::Min(V::Max(x, V::Set1(C::ExpMin)), V::Set1(C::ExpMax));
+        const auto n = V::Round(V::Mul(x, V::Set1(C::Log2e)));
+        auto r = V::MulAdd(n, V::Set1(-C::Ln2Hi), x);
+        r = V::MulAdd(n, V::Set1(-C::Ln2Lo), r);
+        const auto result = V::Ldexp(Polynomial<V>(r, C::ExpPoly), n);
+        return V::Select(underflow, V::Set1(0), result);
+    }
+
+    // x = m * 2^e with m in [sqrt(2) / 2, sqrt(2)), ln(m) = 2 * atanh((m - 1) / (m + 1))
+    template <class V>
+    Y_FORCE_INLINE void LogParts(typename V::TReg x, typename V::TReg& lnM, typename V::TReg& e) {
+        using C = TConstants<typename V::T>;
+        typename V::TReg m;
+        V::Frexp(x, m, e);
+        const auto big = V::Less(V::Set1(C::Sqrt2), m);
+        m = V::Select(big, V::Mul(m, V::Set1(0.5)), m);
+        e = V::Select(big, V::Add(e, V::Set1(1)), e);
+        const auto one = V::Set1(1);
+        const auto s = V::Div(V::Sub(m, one), V::Add(m, one));
+        lnM = V::Mul(V::Add(s, s), Polynomial<V>(V::Mul(s, s), C::LogPoly));
+    }
+
+    template <class V>
+    Y_FORCE_INLINE typename V::TReg Log(typename V::TReg x) {
+        using C = TConstants<typename V::T>;
+        typename V::TReg lnM, e;
+        LogParts<V>(x, lnM, e);
+        return V::MulAdd(e, V::Set1(C::Ln2Hi), V::MulAdd(e, V::Set1(C::Ln2Lo), lnM));
+    }
+
+    template <class V>
+    Y_FORCE_INLINE typename V::TReg Log2(typename V::TReg x) {
+        using C = TConstants<typename V::T>;
+        typename V::TReg lnM, e;
+        LogParts<V>(x, lnM, e);
+        return V::MulAdd(lnM, V::Set1(C::Log2e), e);
+    }
+
+    template <class V>
+    Y_FORCE_INLINE typename V::TReg Logistic(typename V::TReg x) {
+        const auto one = V::Set1(1);
+        return V::Div(one, V::Add(one, Exp<V>(V::Sub(V::Set1(0), x))));
+    }
+
+    template <class V>
+    Y_FORCE_INLINE typename V::TReg TanhSmall(typename V::TReg x, typename V::TReg z) {
+        using C = TConstants<typename V::T>;
+        if constexpr (sizeof(typename V::T) == sizeof(float)) {
+            return V::MulAdd(V::Mul(x, z), Polynomial<V>(z, C::TanhPoly), x);
+        } else {
+            return V::MulAdd(V::Mul(x, z), V::Div(Polynomial<V>(z, C::TanhP), Polynomial<V>(z, C::TanhQ)), x);
+        }
+    }
+
+    // tanh(|x|) = 1 - 2 / (exp(2|x|) + 1) is used where it does not lose precision
+    template <class V>
+    Y_FORCE_INLINE typename V::TReg Tanh(typename V::TReg x) {
+        using C = TConstants<typename V::T>;
+        const auto a = V::Abs(x);
+        const auto one = V::Set1(1);
+        const auto big = V::Sub(one, V::Div(V::Set1(2), V::Add(Exp<V>(V::Add(a, a)), one)));
+        return V::Select(V::Less(a, V::Set1(C::TanhSmall)), TanhSmall<V>(x, V::Mul(x, x)), V::CopySign(big, x));
+    }
+
+    // the tail is processed in a local buffer padded with `padding`
+    template <class V, class TOp>
+    Y_FORCE_INLINE void Map(const typename V::T* src, typename V::T* dst, size_t count, typename V::T padding, TOp op) {
+        size_t i = 0;
+        for (; i + V::Width <= count; i += V::Width) {
+            V::Store(dst + i, op(V::Load(src + i)));
+        }
+        if (i < count) {
+            alignas(64) typename V::T local[V::Width];
+            for (size_t j = 0; j < V::Width; ++j) {
+                local[j] = padding;
+            }
+            std::memcpy(local, src + i, (count - i) * sizeof(typename V::T));
+            V::Store(local, op(V::Load(local)));
+            std::memcpy(dst + i, local, (count - i) * sizeof(typename V::T));
+        }
+    }
+
+    template <class V, class TOp>
+    Y_FORCE_INLINE void ForEach(const typename V::T* src, size_t count, typename V::T padding, TOp op) {
+        size_t i = 0;
+        for (; i + V::Width <= count; i += V::Width) {
+            op(V::Load(src + i));
+        }
+        if (i < count) {
+            alignas(64) typename V::T local[V::Width];
+            for (size_t j = 0; j < V::Width; ++j) {
+                local[j] = padding;
+            }
+            std::memcpy(local, src + i, (count - i) * sizeof(typename V::T));
+            op(V::Load(local));
+        }
+    }
+
+    template <class V>
+    void ExpArray(const typename V::T* src, typename V::T* dst, size_t count) noexcept {
+        Map<V>(src, dst, count, 0, [](auto x) { return Exp<V>(x); });
+    }
+
+    template <class V>
+    void LogArray(const typename V::T* src, typename V::T* dst, size_t count) noexcept {
+        Map<V>(src, dst, count, 1, [](auto x) { return Log<V>(x); });
+    }
+
+    template <class V>
+    void Log2Array(const typename V::T* src, typename V::T* dst, size_t count) noexcept {
+        Map<V>(src, dst, count, 1, [](auto x) { return Log2<V>(x); });
+    }
+
+    template <class V>
+    void LogisticArray(const typename V::T* src, typename V::T* dst, size_t count) noexcept {
+        Map<V>(src, dst, count, 0, [](auto x) { return Logistic<V>(x); });
+    }
+
+    template <class V>
+    void TanhArray(const typename V::T* src, typename V::T* dst, size_t count) noexcept {
+        Map<V>(src, dst, count, 0, [](auto x) { return Tanh<V>(x); });
+    }
+
+    // exp(x - max(x)) never overflows, padding lanes give exp(lowest) = 0 and do not change the sum
+    template <class V>
+    void SoftmaxArray(const typename V::T* src, typename V::T* dst, size_t count) noexcept {
+        using T = typename V::T;
+        if (count == 0) {
+            return;
+        }
+
+        auto maxReg = V::Set1(std::numeric_limits<T>::lowest());
+        ForEach<V>(src, count, std::numeric_limits<T>::lowest(), [&maxReg](auto x) {
+            maxReg = V::Max(maxReg, x);
+        });
+        const auto max = V::Set1(V::ReduceMax(maxReg));
+
+        // partial sums are moved to a double every SoftmaxBlock steps, so long rows do not lose precision
+        constexpr size_t SoftmaxBlock = 256;
+        auto sumReg = V::Set1(0);
+        double sum = 0;
+        size_t step = 0;
+        Map<V>(src, dst, count, std::numeric_limits<T>::lowest(), [&sumReg, &sum, &step, max](auto x) {
+            const auto y = Exp<V>(V::Sub(x, max));
+            sumReg = V::Add(sumReg, y);
+            if (++step % SoftmaxBlock == 0) {
+                sum += V::ReduceAdd(sumReg);
+                sumReg = V::Set1(0);
+            }
+            return y;
+        });
+        sum += V::ReduceAdd(sumReg);
+        const auto scale = V::Set1(static_cast<T>(1 / sum));
+
+        Map<V>(dst, dst, count, 0, [scale](auto x) { return V::Mul(x, scale); });
+    }
+}
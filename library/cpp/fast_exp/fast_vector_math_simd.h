@@ -0,0 +1,46 @@
+#pragma once
+
+#include <util/generic/array_ref.h>
+#include <util/system/platform.h>
+#include <util/system/types.h>
+
+#include <stddef.h>
+
+/**
+ * Instruction set specific implementations of fast_vector_math.h functions.
+ * Public functions use the best set supported by cpu, it is chosen once on the first call.
+ */
+namespace NFastVectorMathImpl {
+    struct TVectorMathKernels {
+        const char* Name;
+        void (*ExpFloat)(const float* src, float* dst, size_t count) noexcept;
+        void (*ExpDouble)(const double* src, double* dst, size_t count) noexcept;
+        void (*LogFloat)(const float* src, float* dst, size_t count) noexcept;
+        void (*LogDouble)(const double* src, double* dst, size_t count) noexcept;
+        void (*Log2Float)(const float* src, float* dst, size_t count) noexcept;
+        void (*Log2Double)(const double* src, double* dst, size_t count) noexcept;
+        void (*LogisticFloat)(const float* src, float* dst, size_t count) noexcept;
+        void (*LogisticDouble)(const double* src, double* dst, size_t count) noexcept;
+        void (*TanhFloat)(const float* src, float* dst, size_t count) noexcept;
+        void (*TanhDouble)(const double* src, double* dst, size_t count) noexcept;
+        void (*SoftmaxFloat)(const float* src, float* dst, size_t count) noexcept;
+        void (*SoftmaxDouble)(const double* src, double* dst, size_t count) noexcept;
+    };
+
+    // Kernels supported by cpu, from the baseline (plain C++) to the best one.
+    TArrayRef<const TVectorMathKernels* const> GetSupportedKernels() noexcept;
+
+    const TVectorMathKernels& GetBestKernels() noexcept;
+
+#if defined(_x86_64_)
+    // without FMA, it is not implied by AVX2
+    namespace NAvx2 {
+        extern const TVectorMathKernels Kernels;
+    }
+
+    // requires AVX512F and AVX512DQ
+    namespace NAvx512 {
+        extern const TVectorMathKernels Kernels;
+    }
+#endif
+}
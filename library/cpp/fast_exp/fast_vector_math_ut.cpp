@@ -0,0 +1,120 @@
+#include "fast_vector_math.h"
+#include "fast_vector_math_simd.h"
+
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <util/generic/vector.h>
+#include <util/random/fast.h>
+
+#include <cmath>
+
+Y_UNIT_TEST_SUITE(TFastVectorMathTest) {
+    template <typename T>
+    using TKernel = void (*)(const T*, T*, size_t) noexcept;
+
+    template <typename T>
+    TVector<T> RandomVector(size_t count, T lo, T hi, ui32 seed) {
+        TReallyFastRng32 rng(seed);
+        TVector<T> result(count);
+        for (T& x : result) {
+            x = lo + (hi - lo) * static_cast<T>(rng.GenRandReal1());
+        }
+        return result;
+    }
+
+    // every length up to a few vectors checks both the main loop and the tail
+    template <typename T, typename TReference>
+    void CheckKernel(const char* name, TKernel<T> kernel, TReference reference, const TVector<T>& src, T relativeError) {
+        for (size_t length = 0; length <= 70; ++length) {
+            TVector<T> dst(length + 1, T(-7));
+            kernel(src.data(), dst.data(), length);
+            for (size_t i = 0; i < length; ++i) {
+                const T expected = reference(src[i]);
+                UNIT_ASSERT_DOUBLES_EQUAL_C(dst[i], expected, relativeError * std::max<T>(1, std::abs(expected)), name << ' ' << length << ' ' << src[i]);
+            }
+            UNIT_ASSERT_VALUES_EQUAL_C(dst[length], T(-7), name << ' ' << length);
+        }
+    }
+
+    template <typename T>
+    T Logistic(T x) {
+        return 1 / (1 + std::exp(-x));
+    }
+
+    template <typename T>
+    void CheckKernels(const char* name, TKernel<T> exp, TKernel<T> log, TKernel<T> log2, TKernel<T> logistic, TKernel<T> tanh, T error) {
+        const TVector<T> wide = RandomVector<T>(100, -80, 80, 17);
+        const TVector<T> positive = RandomVector<T>(100, 1e-3, 1e3, 19);
+        const TVector<T> small = RandomVector<T>(100, -2, 2, 23);
+        CheckKernel<T>(name, exp, [](T x) { return std::exp(x); }, wide, error);
+        CheckKernel<T>(name, exp, [](T x) { return std::exp(x); }, small, error);
+        CheckKernel<T>(name, log, [](T x) { return std::log(x); }, positive, error);
+        CheckKernel<T>(name, log2, [](T x) { return std::log2(x); }, positive, error);
+        CheckKernel<T>(name, logistic, Logistic<T>, wide, error);
+        CheckKernel<T>(name, tanh, [](T x) { return std::tanh(x); }, small, error);
+        CheckKernel<T>(name, tanh, [](T x) { return std::tanh(x); }, wide, error);
+    }
+
+    Y_UNIT_TEST(TestAllInstructionSets) {
+        const auto kernels = NFastVectorMathImpl::GetSupportedKernels();
+        UNIT_ASSERT(!kernels.empty());
+        UNIT_ASSERT_EQUAL(&NFastVectorMathImpl::GetBestKernels(), kernels.back());
+        for (const NFastVectorMathImpl::TVectorMathKernels* k : kernels) {
+            CheckKernels<float>(k->Name, k->ExpFloat, k->LogFloat, k->Log2Float, k->LogisticFloat, k->TanhFloat, 5e-7f);
+            CheckKernels<double>(k->Name, k->ExpDouble, k->LogDouble, k->Log2Double, k->LogisticDouble, k->TanhDouble, 1e-14);
+        }
+    }
+
+    Y_UNIT_TEST(TestExpLimits) {
+        float x[] = {-1000.f, -88.f, 0.f, 89.f, 1000.f};
+        FastExpInplace(x, Y_ARRAY_SIZE(x));
+        UNIT_ASSERT_VALUES_EQUAL(x[0], 0.f);
+        UNIT_ASSERT_VALUES_EQUAL(x[1], 0.f);
+        UNIT_ASSERT_VALUES_EQUAL(x[2], 1.f);
+        UNIT_ASSERT(std::isfinite(x[3]) && x[3] > 1e38f);
+        UNIT_ASSERT(std::isfinite(x[4]) && x[4] > 1e38f);
+
+        const double y[] = {-1000., 0., 1000.};
+        double z[3];
+        FastExp(y, z, 3);
+        UNIT_ASSERT_VALUES_EQUAL(z[0], 0.);
+        UNIT_ASSERT_VALUES_EQUAL(z[1], 1.);
+        UNIT_ASSERT(std::isfinite(z[2]) && z[2] > 1e307);
+    }
+
+    template <typename T>
+    void CheckSoftmax(const char* name, TKernel<T> softmax, T error) {
+        for (size_t length : {1, 2, 7, 17, 100, 5000}) {
+            // large values would overflow exp without subtracting the maximum
+            TVector<T> src = RandomVector<T>(length, 1000, 1010, length);
+            TVector<T> dst(length);
+            softmax(src.data(), dst.data(), length);
+
+            const T max = *std::max_element(src.begin(), src.end());
+            double sum = 0;
+            for (T x : src) {
+                sum += std::exp(double(x - max));
+            }
+            double total = 0;
+            for (size_t i = 0; i < length; ++i) {
+                const double expected = std::exp(double(src[i] - max)) / sum;
+                UNIT_ASSERT_DOUBLES_EQUAL_C(dst[i], expected, error * expected, name << ' ' << length);
+                total += dst[i];
+            }
+            UNIT_ASSERT_DOUBLES_EQUAL_C(total, 1, error * 10, name << ' ' << length);
+        }
+    }
+
+    Y_UNIT_TEST(TestSoftmax) {
+        for (const NFastVectorMathImpl::TVectorMathKernels* k : NFastVectorMathImpl::GetSupportedKernels()) {
+            CheckSoftmax<float>(k->Name, k->SoftmaxFloat, 2e-6f);
+            CheckSoftmax<double>(k->Name, k->SoftmaxDouble, 1e-13);
+        }
+
+        TVector<float> x = {1.f, 2.f, 3.f};
+        FastSoftmaxInplace(x.data(), x.size());
+        UNIT_ASSERT_DOUBLES_EQUAL(x[0] + x[1] + x[2], 1.f, 1e-6);
+        UNIT_ASSERT(x[0] < x[1] && x[1] < x[2]);
+        FastSoftmax(x.data(), x.data(), 0);
+    }
+}
@@ -0,0 +1,107 @@
+#include <library/cpp/fast_exp/fast_vector_math_simd.h>
+
+#include <util/generic/vector.h>
+#include <util/random/fast.h>
+#include <util/stream/format.h>
+#include <util/stream/output.h>
+
+#include <algorithm>
+#include <cmath>
+
+// Prints maximal errors of every kernel set against long double libm on random arguments.
+
+namespace {
+    constexpr size_t Count = 1 << 20;
+
+    enum class EError {
+        Absolute,
+        Relative,
+        // relative for |expected| > 1, absolute otherwise
+        Mixed,
+    };
+
+    template <typename T>
+    using TKernel = void (*)(const T*, T*, size_t) noexcept;
+
+    // uniform on [lo, hi] or log-uniform for logScale
+    template <typename T>
+    TVector<T> RandomArguments(T lo, T hi, bool logScale) {
+        TReallyFastRng32 rng(17);
+        TVector<T> src(Count);
+        for (T& x : src) {
+            const long double u = rng.GenRandReal1();
+            if (logScale) {
+                x = static_cast<T>(std::exp(std::log((long double)lo) + u * (std::log((long double)hi) - std::log((long double)lo))));
+            } else {
+                x = static_cast<T>(lo + u * (hi - lo));
+            }
+        }
+        return src;
+    }
+
+    template <typename T, typename TReference>
+    double MaxError(TKernel<T> kernel, const TVector<T>& src, TReference reference, EError kind) {
+        TVector<T> dst(src.size());
+        kernel(src.data(), dst.data(), src.size());
+
+        double maxError = 0;
+        for (size_t i = 0; i < src.size(); ++i) {
+            const long double expected = reference(i);
+            long double error = std::abs(dst[i] - expected);
+            if (kind == EError::Relative && expected != 0) {
+                error /= std::abs(expected);
+            } else if (kind == EError::Mixed) {
+                error /= std::max<long double>(1, std::abs(expected));
+            }
+            maxError = std::max<double>(maxError, error);
+        }
+        return maxError;
+    }
+
+    template <typename T>
+    void Report(TKernel<T> kernel, const TVector<T>& src, long double (*reference)(long double), EError kind, const char* label) {
+        const double error = MaxError<T>(kernel, src, [&src, reference](size_t i) { return reference(src[i]); }, kind);
+        Cout << "    " << RightPad(label, 12) << Prec(error, PREC_NDIGITS, 2) << Endl;
+    }
+
+    long double Logistic(long double x) {
+        return 1 / (1 + std::exp(-x));
+    }
+
+    template <typename T>
+    void Report(const char* isa, const char* name, TKernel<T> exp, TKernel<T> log, TKernel<T> log2, TKernel<T> logistic, TKernel<T> tanh, TKernel<T> softmax) {
+        const bool isFloat = sizeof(T) == sizeof(float);
+        const TVector<T> expArgs = RandomArguments<T>(isFloat ? -87 : -708, isFloat ? 88 : 709, false);
+        const TVector<T> logArgs = RandomArguments<T>(isFloat ? 1.2e-38f : 2.3e-308, isFloat ? 3.4e38f : 1.7e308, true);
+        const TVector<T> logArgsNearOne = RandomArguments<T>(0.5, 2, true);
+        const TVector<T> tanhArgs = RandomArguments<T>(-20, 20, false);
+        const TVector<T> tanhArgsSmall = RandomArguments<T>(1e-6, 1, true);
+        const TVector<T> softmaxArgs = RandomArguments<T>(-10, 10, false);
+
+        Cout << isa << ' ' << name << Endl;
+        Report<T>(exp, expArgs, std::exp, EError::Relative, "exp");
+        Report<T>(log, logArgs, std::log, EError::Mixed, "log");
+        Report<T>(log, logArgsNearOne, std::log, EError::Absolute, "log [.5, 2]");
+        Report<T>(log2, logArgs, std::log2, EError::Mixed, "log2");
+        Report<T>(logistic, expArgs, Logistic, EError::Relative, "logistic");
+        Report<T>(tanh, tanhArgs, std::tanh, EError::Absolute, "tanh");
+        Report<T>(tanh, tanhArgsSmall, std::tanh, EError::Relative, "tanh [0, 1]");
+
+        const long double max = *std::max_element(softmaxArgs.begin(), softmaxArgs.end());
+        long double sum = 0;
+        for (T x : softmaxArgs) {
+            sum += std::exp(x - max);
+        }
+        const double softmaxError = MaxError<T>(softmax, softmaxArgs, [&](size_t i) { return std::exp(softmaxArgs[i] - max) / sum; }, EError::Relative);
+        Cout << "    " << RightPad("softmax", 12) << Prec(softmaxError, PREC_NDIGITS, 2) << Endl;
+    }
+}
+
+int main() {
+    Cout << "maximal errors: relative for exp, logistic, softmax and tanh on [0, 1]," << Endl
+         << "absolute for tanh and log on [.5, 2], absolute or relative when above 1 for log and log2" << Endl;
+    for (const NFastVectorMathImpl::TVectorMathKernels* k : NFastVectorMathImpl::GetSupportedKernels()) {
+        Report<float>(k->Name, "float", k->ExpFloat, k->LogFloat, k->Log2Float, k->LogisticFloat, k->TanhFloat, k->SoftmaxFloat);
+        Report<double>(k->Name, "double", k->ExpDouble, k->LogDouble, k->Log2Double, k->LogisticDouble, k->TanhDouble, k->SoftmaxDouble);
+    }
+}
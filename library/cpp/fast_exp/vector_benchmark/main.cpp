@@ -0,0 +1,140 @@
+#include <library/cpp/fast_exp/fast_exp.h>
+#include <library/cpp/fast_exp/fast_vector_math.h>
+#include <library/cpp/fast_exp/fast_vector_math_simd.h>
+#include <library/cpp/testing/benchmark/bench.h>
+
+#include <util/generic/singleton.h>
+#include <util/generic/vector.h>
+#include <util/random/fast.h>
+
+#include <cstring>
+#include <cmath>
+
+// every iteration processes a row of Length values
+namespace {
+    constexpr size_t Length = 1024;
+
+    template <typename T>
+    struct TData {
+        TVector<T> Src;
+        TVector<T> Positive;
+        TVector<T> Dst;
+
+        TData()
+            : Src(Length)
+            , Positive(Length)
+            , Dst(Length)
+        {
+            TReallyFastRng32 rng(0);
+            for (size_t i = 0; i < Length; ++i) {
+                Src[i] = static_cast<T>(rng.GenRandReal1() * 20 - 10);
+                Positive[i] = static_cast<T>(rng.GenRandReal1() * 1000 + 1e-3);
+            }
+        }
+    };
+
+    template <typename T>
+    const TVector<T>& Source(bool positive) {
+        const auto& data = *Singleton<TData<T>>();
+        return positive ? data.Positive : data.Src;
+    }
+
+    template <typename T>
+    void RunKernels(void (*op)(const T*, T*, size_t) noexcept, bool positive, const NBench::NCpu::TParams& iface) {
+        const T* src = Source<T>(positive).data();
+        T* dst = Singleton<TData<T>>()->Dst.data();
+        for (size_t i = 0; i < iface.Iterations(); ++i) {
+            op(src, dst, Length);
+            Y_DO_NOT_OPTIMIZE_AWAY(dst[i % Length]);
+        }
+    }
+
+    template <typename T, typename TOp>
+    void RunStd(TOp op, bool positive, const NBench::NCpu::TParams& iface) {
+        const T* src = Source<T>(positive).data();
+        T* dst = Singleton<TData<T>>()->Dst.data();
+        for (size_t i = 0; i < iface.Iterations(); ++i) {
+            for (size_t j = 0; j < Length; ++j) {
+                dst[j] = op(src[j]);
+            }
+            Y_DO_NOT_OPTIMIZE_AWAY(dst[i % Length]);
+        }
+    }
+
+    template <typename T>
+    void StdSoftmax(const T* src, T* dst, size_t count) noexcept {
+        T max = src[0];
+        for (size_t i = 1; i < count; ++i) {
+            max = std::max(max, src[i]);
+        }
+        T sum = 0;
+        for (size_t i = 0; i < count; ++i) {
+            dst[i] = std::exp(src[i] - max);
+            sum += dst[i];
+        }
+        for (size_t i = 0; i < count; ++i) {
+            dst[i] /= sum;
+        }
+    }
+
+    // nullptr if the instruction set is not supported by the CPU
+    const NFastVectorMathImpl::TVectorMathKernels* FindKernels(const char* name) {
+        for (const auto* kernels : NFastVectorMathImpl::GetSupportedKernels()) {
+            if (std::strcmp(kernels->Name, name) == 0) {
+                return kernels;
+            }
+        }
+        return nullptr;
+    }
+}
+
+#define DefineStdBenchmark(Name, T, Op, positive)                              \
+    Y_CPU_BENCHMARK(Std##Name##_##T, iface) {                                  \
+        RunStd<T>([](T x) -> T { return Op; }, positive, iface);               \
+    }
+
+#define DefineKernelBenchmark(Name, T, Field, Isa, positive)                   \
+    Y_CPU_BENCHMARK(Name##_##T##_##Isa, iface) {                               \
+        if (const auto* kernels = FindKernels(#Isa)) {                         \
+            RunKernels<T>(kernels->Field, positive, iface);                    \
+        }                                                                      \
+    }
+
+#define DefineBenchmarks(Name, T, Field, Op, positive)                         \
+    DefineStdBenchmark(Name, T, Op, positive)                                  \
+    DefineKernelBenchmark(Name, T, Field, scalar, positive)                    \
+    DefineKernelBenchmark(Name, T, Field, avx2, positive)                      \
+    DefineKernelBenchmark(Name, T, Field, avx512, positive)
+
+DefineBenchmarks(Exp, float, ExpFloat, std::exp(x), false)
+DefineBenchmarks(Exp, double, ExpDouble, std::exp(x), false)
+DefineBenchmarks(Log, float, LogFloat, std::log(x), true)
+DefineBenchmarks(Log, double, LogDouble, std::log(x), true)
+DefineBenchmarks(Log2, float, Log2Float, std::log2(x), true)
+DefineBenchmarks(Log2, double, Log2Double, std::log2(x), true)
+DefineBenchmarks(Logistic, float, LogisticFloat, 1 / (1 + std::exp(-x)), false)
+DefineBenchmarks(Logistic, double, LogisticDouble, 1 / (1 + std::exp(-x)), false)
+DefineBenchmarks(Tanh, float, TanhFloat, std::tanh(x), false)
+DefineBenchmarks(Tanh, double, TanhDouble, std::tanh(x), false)
+
+#define DefineSoftmaxBenchmarks(T, Field)                                      \
+    Y_CPU_BENCHMARK(StdSoftmax_##T, iface) {                                   \
+        RunKernels<T>(StdSoftmax<T>, false, iface);                            \
+    }                                                                          \
+    DefineKernelBenchmark(Softmax, T, Field, scalar, false)                    \
+    DefineKernelBenchmark(Softmax, T, Field, avx2, false)                      \
+    DefineKernelBenchmark(Softmax, T, Field, avx512, false)
+
+DefineSoftmaxBenchmarks(float, SoftmaxFloat)
+DefineSoftmaxBenchmarks(double, SoftmaxDouble)
+
+// FastExpInplace(double*) of fast_exp.h for comparison
+Y_CPU_BENCHMARK(FastExpInplace_double, iface) {
+    const auto& src = Source<double>(false);
+    TVector<double> dst(Length);
+    for (size_t i = 0; i < iface.Iterations(); ++i) {
+        std::memcpy(dst.data(), src.data(), Length * sizeof(double));
+        FastExpInplace(dst.data(), Length);
+        Y_DO_NOT_OPTIMIZE_AWAY(dst[i % Length]);
+    }
+}
@@ -3,6 +3,8 @@
 #include <util/system/yassert.h>
 #include <util/stream/output.h>
 
+#include <cmath>
+
 namespace {
     // Generates a float32 with a given exponent and other bits set to zero
     // We do this a lot in conversion functions, so a short name helps
@@ -144,3 +146,37 @@ void NFloat16Ops::PackFloat16SequenceAuto(const float* src, TFloat16* dst, size_
         }
     }
 }
+
+float NFloat16Ops::DotProductAuto(const TFloat16* lhs, const TFloat16* rhs, size_t len) {
+    if (AreIntrinsicsAvailableOnHost()) {
+        return DotProductIntrisincs(lhs, rhs, len);
+    }
+    float res = 0;
+    for (size_t i = 0; i < len; ++i) {
+        res += lhs[i].AsFloat() * rhs[i].AsFloat();
+    }
+    return res;
+}
+
+float NFloat16Ops::L2SqrDistanceAuto(const TFloat16* lhs, const TFloat16* rhs, size_t len) {
+    if (AreIntrinsicsAvailableOnHost()) {
+        return L2SqrDistanceIntrisincs(lhs, rhs, len);
+    }
+    float res = 0;
+    for (size_t i = 0; i < len; ++i) {
+        const float delta = lhs[i].AsFloat() - rhs[i].AsFloat();
+        res += delta * delta;
+    }
+    return res;
+}
+
+float NFloat16Ops::L1DistanceAuto(const TFloat16* lhs, const TFloat16* rhs, size_t len) {
+    if (AreIntrinsicsAvailableOnHost()) {
+        return L1DistanceIntrisincs(lhs, rhs, len);
+    }
+    float res = 0;
+    for (size_t i = 0; i < len; ++i) {
+        res += std::abs(lhs[i].AsFloat() - rhs[i].AsFloat());
+    }
+    return res;
+}
@@ -110,6 +110,45 @@ namespace NFloat16Ops {
 
     void PackFloat16SequenceAuto(const float* src, TFloat16* dst, size_t len);
     void PackFloat16SequenceIntrisincs(const float* src, TFloat16* dst, size_t len);
+
+    // Distances between two float16 vectors, computed with float accumulators without
+    // unpacking the vectors into float buffers. No alignment requirements.
+    //NOTE: result depends on architecture and do not recomended for canonization
+    Y_PURE_FUNCTION
+    float DotProductAuto(const TFloat16* lhs, const TFloat16* rhs, size_t len);
+
+    Y_PURE_FUNCTION
+    float DotProductIntrisincs(const TFloat16* lhs, const TFloat16* rhs, size_t len);
+
+    Y_PURE_FUNCTION
+    float L2SqrDistanceAuto(const TFloat16* lhs, const TFloat16* rhs, size_t len);
+
+    Y_PURE_FUNCTION
+    float L2SqrDistanceIntrisincs(const TFloat16* lhs, const TFloat16* rhs, size_t len);
+
+    Y_PURE_FUNCTION
+    float L1DistanceAuto(const TFloat16* lhs, const TFloat16* rhs, size_t len);
+
+    Y_PURE_FUNCTION
+    float L1DistanceIntrisincs(const TFloat16* lhs, const TFloat16* rhs, size_t len);
+}
+
+// Overloads for float16 vectors. They are found by argument-dependent lookup from
+// NDotProduct::TDotProduct, NL2Distance::TL2SqrDistance and NL1Distance::TL1Distance,
+// so hnsw distances work for TDenseVectorItemStorage<TFloat16>.
+Y_PURE_FUNCTION
+inline float DotProduct(const TFloat16* lhs, const TFloat16* rhs, ui32 length) noexcept {
+    return NFloat16Ops::DotProductAuto(lhs, rhs, length);
+}
+
+Y_PURE_FUNCTION
+inline float L2SqrDistance(const TFloat16* lhs, const TFloat16* rhs, int length) {
+    return NFloat16Ops::L2SqrDistanceAuto(lhs, rhs, length);
+}
+
+Y_PURE_FUNCTION
+inline float L1Distance(const TFloat16* lhs, const TFloat16* rhs, int length) {
+    return NFloat16Ops::L1DistanceAuto(lhs, rhs, length);
 }
 
 namespace std {
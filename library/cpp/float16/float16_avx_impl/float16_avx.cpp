@@ -7,6 +7,82 @@
 #include <util/system/cpu_id.h>
 #include <util/system/yassert.h>
 
+#include <cstring>
+
+namespace {
+    // outputs of bulk conversions larger than this do not fit into cache anyway,
+    // so they are written with non-temporal stores
+    constexpr size_t StreamingStoreThreshold = 1 << 20;
+
+    Y_FORCE_INLINE __m256 LoadFloat16x8(const TFloat16* src) {
+        return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+    }
+
+    // lanes after `len` are zero
+    Y_FORCE_INLINE __m256 LoadFloat16Tail(const TFloat16* src, size_t len) {
+        alignas(16) TFloat16 local[8] = {};
+        memcpy(local, src, sizeof(*src) * len);
+        return _mm256_cvtph_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(local)));
+    }
+
+    Y_FORCE_INLINE __m128i StoreFloat16x8(__m256 v) {
+        return _mm256_cvtps_ph(v, (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    }
+
+    Y_FORCE_INLINE float HorizontalSum(__m256 v) {
+        __m128 x = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        x = _mm_add_ps(x, _mm_movehl_ps(x, x));
+        x = _mm_add_ss(x, _mm_movehdup_ps(x));
+        return _mm_cvtss_f32(x);
+    }
+
+    // F16C cpus are not guaranteed to have FMA, so products are added separately
+    struct TDotProductStep {
+        static Y_FORCE_INLINE __m256 Add(__m256 sum, __m256 l, __m256 r) {
+            return _mm256_add_ps(sum, _mm256_mul_ps(l, r));
+        }
+    };
+
+    struct TL2SqrDistanceStep {
+        static Y_FORCE_INLINE __m256 Add(__m256 sum, __m256 l, __m256 r) {
+            const __m256 delta = _mm256_sub_ps(l, r);
+            return _mm256_add_ps(sum, _mm256_mul_ps(delta, delta));
+        }
+    };
+
+    struct TL1DistanceStep {
+        static Y_FORCE_INLINE __m256 Add(__m256 sum, __m256 l, __m256 r) {
+            return _mm256_add_ps(sum, _mm256_andnot_ps(_mm256_set1_ps(-0.0f), _mm256_sub_ps(l, r)));
+        }
+    };
+
+    // zero lanes of the tail do not contribute to any of the sums
+    template <class TStep>
+    Y_FORCE_INLINE float Float16Distance(const TFloat16* lhs, const TFloat16* rhs, size_t len) {
+        __m256 sum0 = _mm256_setzero_ps();
+        __m256 sum1 = _mm256_setzero_ps();
+        __m256 sum2 = _mm256_setzero_ps();
+        __m256 sum3 = _mm256_setzero_ps();
+
+        for (; len >= 32; len -= 32, lhs += 32, rhs += 32) {
+            sum0 = TStep::Add(sum0, LoadFloat16x8(lhs), LoadFloat16x8(rhs));
+            sum1 = TStep::Add(sum1, LoadFloat16x8(lhs + 8), LoadFloat16x8(rhs + 8));
+            sum2 = TStep::Add(sum2, LoadFloat16x8(lhs + 16), LoadFloat16x8(rhs + 16));
+            sum3 = TStep::Add(sum3, LoadFloat16x8(lhs + 24), LoadFloat16x8(rhs + 24));
+        }
+
+        for (; len >= 8; len -= 8, lhs += 8, rhs += 8) {
+            sum0 = TStep::Add(sum0, LoadFloat16x8(lhs), LoadFloat16x8(rhs));
+        }
+
+        if (len > 0) {
+            sum1 = TStep::Add(sum1, LoadFloat16Tail(lhs, len), LoadFloat16Tail(rhs, len));
+        }
+
+        return HorizontalSum(_mm256_add_ps(_mm256_add_ps(sum0, sum1), _mm256_add_ps(sum2, sum3)));
+    }
+}
+
 bool NFloat16Impl::AreConversionIntrinsicsAvailableOnHost() {
 #ifdef _MSC_VER
     return false;
@@ -36,6 +112,26 @@ bool NFloat16Ops::AreIntrinsicsAvailableOnHost() {
 }
 
 void NFloat16Ops::UnpackFloat16SequenceIntrisincs(const TFloat16* src, float* dst, size_t len) {
+    if (len >= StreamingStoreThreshold) {
+        for (; len > 0 && size_t(dst) % 32 != 0; --len) {
+            *dst++ = _cvtsh_ss((src++)->Data);
+        }
+        for (; len >= 32; len -= 32, src += 32, dst += 32) {
+            _mm256_stream_ps(dst, LoadFloat16x8(src));
+            _mm256_stream_ps(dst + 8, LoadFloat16x8(src + 8));
+            _mm256_stream_ps(dst + 16, LoadFloat16x8(src + 16));
+            _mm256_stream_ps(dst + 24, LoadFloat16x8(src + 24));
+        }
+        _mm_sfence();
+    }
+
+    for (; len >= 32; len -= 32, src += 32, dst += 32) {
+        _mm256_storeu_ps(dst, LoadFloat16x8(src));
+        _mm256_storeu_ps(dst + 8, LoadFloat16x8(src + 8));
+        _mm256_storeu_ps(dst + 16, LoadFloat16x8(src + 16));
+        _mm256_storeu_ps(dst + 24, LoadFloat16x8(src + 24));
+    }
+
     while (len >= 8) {
         __m128i source = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
         __m256 cvt = _mm256_cvtph_ps(source);
@@ -48,12 +144,8 @@ void NFloat16Ops::UnpackFloat16SequenceIntrisincs(const TFloat16* src, float* ds
     }
 
     if (len > 0) {
-        alignas(16) ui16 local[8] = {};
-        memcpy(local, src, sizeof(*src) * len);
-        __m128i source = _mm_load_si128(reinterpret_cast<const __m128i*>(local));
-        __m256 cvt = _mm256_cvtph_ps(source);
         alignas(32) float localDst[8];
-        _mm256_store_ps(localDst, cvt);
+        _mm256_store_ps(localDst, LoadFloat16Tail(src, len));
 
         memcpy(dst, localDst, len * sizeof(float));
     }
@@ -120,6 +212,26 @@ float NFloat16Ops::DotProductOnFloatIntrisincs(const float* f32, const TFloat16*
 }
 
 void NFloat16Ops::PackFloat16SequenceIntrisincs(const float* src, TFloat16* dst, size_t len) {
+    if (len >= StreamingStoreThreshold) {
+        for (; len > 0 && size_t(dst) % 16 != 0; --len) {
+            (dst++)->Data = _cvtss_sh(*src++, _MM_FROUND_TO_NEAREST_INT);
+        }
+        for (; len >= 32; len -= 32, src += 32, dst += 32) {
+            _mm_stream_si128(reinterpret_cast<__m128i*>(dst), StoreFloat16x8(_mm256_loadu_ps(src)));
+            _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 8), StoreFloat16x8(_mm256_loadu_ps(src + 8)));
+            _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 16), StoreFloat16x8(_mm256_loadu_ps(src + 16)));
+            _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 24), StoreFloat16x8(_mm256_loadu_ps(src + 24)));
+        }
+        _mm_sfence();
+    }
+
+    for (; len >= 32; len -= 32, src += 32, dst += 32) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), StoreFloat16x8(_mm256_loadu_ps(src)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 8), StoreFloat16x8(_mm256_loadu_ps(src + 8)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), StoreFloat16x8(_mm256_loadu_ps(src + 16)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 24), StoreFloat16x8(_mm256_loadu_ps(src + 24)));
+    }
+
     while (len >= 8) {
         __m256 source = _mm256_loadu_ps(src);
         __m128i cvt = _mm256_cvtps_ph(source, (_MM_FROUND_TO_NEAREST_INT |_MM_FROUND_NO_EXC));
@@ -142,3 +254,15 @@ void NFloat16Ops::PackFloat16SequenceIntrisincs(const float* src, TFloat16* dst,
         memcpy(dst, localDst, len * sizeof(TFloat16));
     }
 }
+
+float NFloat16Ops::DotProductIntrisincs(const TFloat16* lhs, const TFloat16* rhs, size_t len) {
+    return Float16Distance<TDotProductStep>(lhs, rhs, len);
+}
+
+float NFloat16Ops::L2SqrDistanceIntrisincs(const TFloat16* lhs, const TFloat16* rhs, size_t len) {
+    return Float16Distance<TL2SqrDistanceStep>(lhs, rhs, len);
+}
+
+float NFloat16Ops::L1DistanceIntrisincs(const TFloat16* lhs, const TFloat16* rhs, size_t len) {
+    return Float16Distance<TL1DistanceStep>(lhs, rhs, len);
+}
@@ -29,3 +29,15 @@ float NFloat16Ops::DotProductOnFloatIntrisincs(const float*, const TFloat16*, si
 void NFloat16Ops::PackFloat16SequenceIntrisincs(const float*, TFloat16*, size_t) {
     Y_FAIL("NFloat16Ops::PackFloat16SequenceIntrisincs() is not implemented on this platform");
 }
+
+float NFloat16Ops::DotProductIntrisincs(const TFloat16*, const TFloat16*, size_t) {
+    Y_FAIL("NFloat16Ops::DotProductIntrisincs() is not implemented on this platform");
+}
+
+float NFloat16Ops::L2SqrDistanceIntrisincs(const TFloat16*, const TFloat16*, size_t) {
+    Y_FAIL("NFloat16Ops::L2SqrDistanceIntrisincs() is not implemented on this platform");
+}
+
+float NFloat16Ops::L1DistanceIntrisincs(const TFloat16*, const TFloat16*, size_t) {
+    Y_FAIL("NFloat16Ops::L1DistanceIntrisincs() is not implemented on this platform");
+}
@@ -1,11 +1,17 @@
 #include "float16.h"
 
+#include <library/cpp/dot_product/dot_product.h>
+#include <library/cpp/l1_distance/l1_distance.h>
+#include <library/cpp/l2_distance/l2_distance.h>
 #include <library/cpp/testing/unittest/registar.h>
 #include <util/generic/bitops.h>
 #include <util/generic/cast.h>
 #include <util/stream/format.h>
 #include <util/string/builder.h>
 #include <util/generic/ylimits.h>
+#include <util/generic/vector.h>
+
+#include <cmath>
 
 static ui32 ReintrepretFloat(float v) {
     return BitCast<ui32>(v);
@@ -224,6 +230,49 @@ Y_UNIT_TEST_SUITE(Intrisincs) {
         }
     }
 
+    Y_UNIT_TEST(Distances) {
+        TVector<TFloat16> lhs(100);
+        TVector<TFloat16> rhs(100);
+        for (size_t i = 0; i < lhs.size(); ++i) {
+            lhs[i] = float(1. / (i + 1));
+            rhs[i] = float(i % 7) - 3.f;
+        }
+
+        for (size_t len = 0; len <= lhs.size(); ++len) {
+            float dot = 0;
+            float l2 = 0;
+            float l1 = 0;
+            for (size_t i = 0; i < len; ++i) {
+                dot += float(lhs[i]) * float(rhs[i]);
+                l2 += (float(lhs[i]) - float(rhs[i])) * (float(lhs[i]) - float(rhs[i]));
+                l1 += std::abs(float(lhs[i]) - float(rhs[i]));
+            }
+            UNIT_ASSERT_DOUBLES_EQUAL(NFloat16Ops::DotProductAuto(lhs.data(), rhs.data(), len), dot, 1e-3);
+            UNIT_ASSERT_DOUBLES_EQUAL(NFloat16Ops::L2SqrDistanceAuto(lhs.data(), rhs.data(), len), l2, 1e-3);
+            UNIT_ASSERT_DOUBLES_EQUAL(NFloat16Ops::L1DistanceAuto(lhs.data(), rhs.data(), len), l1, 1e-3);
+            UNIT_ASSERT_DOUBLES_EQUAL(NDotProduct::TDotProduct<TFloat16>()(lhs.data(), rhs.data(), len), dot, 1e-3);
+            UNIT_ASSERT_DOUBLES_EQUAL(NL2Distance::TL2SqrDistance<TFloat16>()(lhs.data(), rhs.data(), len), l2, 1e-3);
+            UNIT_ASSERT_DOUBLES_EQUAL(NL1Distance::TL1Distance<TFloat16>()(lhs.data(), rhs.data(), len), l1, 1e-3);
+        }
+    }
+
+    Y_UNIT_TEST(ConvertLongSequence) {
+        // long enough for non-temporal stores, unaligned on purpose
+        constexpr size_t len = (1 << 20) + 37;
+        TVector<float> src(len + 1);
+        for (size_t i = 0; i < src.size(); ++i) {
+            src[i] = float(i % 2048);
+        }
+        TVector<TFloat16> packed(len + 1);
+        NFloat16Ops::PackFloat16SequenceAuto(src.data() + 1, packed.data() + 1, len);
+        TVector<float> unpacked(len + 1);
+        NFloat16Ops::UnpackFloat16SequenceAuto(packed.data() + 1, unpacked.data() + 1, len);
+        for (size_t i = 1; i <= len; ++i) {
+            UNIT_ASSERT_VALUES_EQUAL(packed[i], TFloat16(src[i]));
+            UNIT_ASSERT_VALUES_EQUAL(unpacked[i], src[i]);
+        }
+    }
+
     Y_UNIT_TEST(MaxValues) {
         UNIT_ASSERT_VALUES_EQUAL(65504.0f, Max<TFloat16>());
         UNIT_ASSERT_VALUES_EQUAL(-65504.0f, -Max<TFloat16>());
@@ -0,0 +1,124 @@
+#include <library/cpp/grid_creator/binarization.h>
+#include <library/cpp/grid_creator/quantile_sketch.h>
+#include <library/cpp/testing/benchmark/bench.h>
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/hash_set.h>
+#include <util/generic/singleton.h>
+#include <util/generic/vector.h>
+#include <util/generic/ymath.h>
+#include <util/random/fast.h>
+#include <util/stream/output.h>
+
+#include <cmath>
+
+// Exact BestSplit vs BestSplitBySketch on 10M values, 254 borders. Quality of the borders is printed
+// once per border selection type as sum of log(bin size) (the objective of GreedyLogSum, greater is better)
+// and maximal deviation of bin size from the ideal one for Median.
+namespace {
+    constexpr size_t ValuesCount = 10000000;
+    constexpr int MaxBordersCount = 254;
+
+    struct TData {
+        TVector<float> Values;
+        TVector<float> SortedValues;
+
+        TData()
+            : Values(ValuesCount)
+        {
+            TFastRng<ui64> rng(0);
+            for (float& value : Values) {
+                // log-normal, so that neither uniform nor quantile borders are trivial
+                value = std::exp(static_cast<float>(rng.GenRandReal1() * 4 - 2) + static_cast<float>(rng.GenRandReal1()));
+            }
+            SortedValues = Values;
+            Sort(SortedValues);
+        }
+    };
+
+    struct TExecutors {
+        NPar::TLocalExecutor Threads4;
+        NPar::TLocalExecutor Threads16;
+
+        TExecutors() {
+            Threads4.RunAdditionalThreads(3);
+            Threads16.RunAdditionalThreads(15);
+        }
+    };
+
+    TVector<ui64> BinSizes(const THashSet<float>& borders) {
+        const auto& sortedValues = Singleton<TData>()->SortedValues;
+        TVector<float> sortedBorders(borders.begin(), borders.end());
+        Sort(sortedBorders);
+        TVector<ui64> result;
+        size_t begin = 0;
+        for (size_t i = 0; i <= sortedBorders.size(); ++i) {
+            const size_t end = i < sortedBorders.size()
+                ? UpperBound(sortedValues.begin(), sortedValues.end(), sortedBorders[i]) - sortedValues.begin()
+                : sortedValues.size();
+            result.push_back(end - begin);
+            begin = end;
+        }
+        return result;
+    }
+
+    void PrintQuality(const char* name, EBorderSelectionType type, const THashSet<float>& borders) {
+        static THashSet<TString> printed;
+        if (!printed.insert(name).second) {
+            return;
+        }
+        const TVector<ui64> sizes = BinSizes(borders);
+        double sumLog = 0;
+        double maxDeviation = 0;
+        for (ui64 size : sizes) {
+            sumLog += log(size + 1e-8);
+            maxDeviation = Max(maxDeviation, Abs(double(size) * sizes.size() / ValuesCount - 1));
+        }
+        Cerr << name << ": " << sizes.size() << " bins, sum log(bin size) " << sumLog;
+        if (type == EBorderSelectionType::Median) {
+            Cerr << ", max relative bin size deviation " << maxDeviation;
+        }
+        Cerr << Endl;
+    }
+
+    void RunExact(const char* name, EBorderSelectionType type, const NBench::NCpu::TParams& iface) {
+        const auto& data = *Singleton<TData>();
+        for (size_t i = 0; i < iface.Iterations(); ++i) {
+            TVector<float> values = data.Values;
+            const THashSet<float> borders = BestSplit(values, MaxBordersCount, type);
+            Y_DO_NOT_OPTIMIZE_AWAY(borders.size());
+            PrintQuality(name, type, borders);
+        }
+    }
+
+    void RunSketch(const char* name, EBorderSelectionType type, NPar::ILocalExecutor* localExecutor, const NBench::NCpu::TParams& iface) {
+        const auto& data = *Singleton<TData>();
+        NSplitSelection::TSketchOptions options;
+        options.ChunkSize = 1 << 20;
+        for (size_t i = 0; i < iface.Iterations(); ++i) {
+            const THashSet<float> borders = BestSplitBySketch(data.Values, MaxBordersCount, type, localExecutor, options);
+            Y_DO_NOT_OPTIMIZE_AWAY(borders.size());
+            PrintQuality(name, type, borders);
+        }
+    }
+}
+
+#define DefineBenchmarks(Type)                                                                   \
+    Y_CPU_BENCHMARK(Exact_##Type, iface) {                                                       \
+        RunExact("Exact_" #Type, EBorderSelectionType::Type, iface);                             \
+    }                                                                                            \
+    Y_CPU_BENCHMARK(Sketch_##Type, iface) {                                                      \
+        RunSketch("Sketch_" #Type, EBorderSelectionType::Type, nullptr, iface);                  \
+    }                                                                                            \
+    Y_CPU_BENCHMARK(Sketch_##Type##_4Threads, iface) {                                           \
+        RunSketch("Sketch_" #Type, EBorderSelectionType::Type, &Singleton<TExecutors>()->Threads4, iface);   \
+    }                                                                                            \
+    Y_CPU_BENCHMARK(Sketch_##Type##_16Threads, iface) {                                          \
+        RunSketch("Sketch_" #Type, EBorderSelectionType::Type, &Singleton<TExecutors>()->Threads16, iface); \
+    }
+
+DefineBenchmarks(GreedyLogSum)
+DefineBenchmarks(GreedyMinEntropy)
+DefineBenchmarks(Median)
+DefineBenchmarks(UniformAndQuantiles)
@@ -0,0 +1,310 @@
+#include "quantile_sketch.h"
+
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/yexception.h>
+#include <util/generic/ymath.h>
+
+#include <utility>
+
+using namespace NSplitSelection;
+
+namespace {
+    // values and weights must be sorted by value
+    template <typename TWeight>
+    void AppendGrouped(float value, TWeight weight, TVector<float>* values, TVector<double>* weights) {
+        if (!values->empty() && values->back() == value) {
+            weights->back() += weight;
+        } else {
+            values->push_back(value);
+            weights->push_back(weight);
+        }
+    }
+
+    // border before sortedValues[idx], see RegularBorder in binarization.cpp
+    float BorderBefore(TConstArrayRef<float> sortedValues, size_t idx) {
+        const float res = (sortedValues[idx] + sortedValues[idx - 1]) * .5f;
+        return res == sortedValues[idx] ? sortedValues[idx - 1] : res;
+    }
+
+    THashSet<float> MedianBorders(const TQuantileSketch& sketch, int maxBordersCount) {
+        const auto values = sketch.GetValues();
+        const auto weights = sketch.GetWeights();
+        const double total = sketch.GetTotalWeight();
+
+        THashSet<float> result;
+        double cumulativeWeight = weights[0];
+        size_t idx = 0;
+        for (int i = 0; i < maxBordersCount; ++i) {
+            // value at position `target` of the sorted sample
+            const double target = (i + 1) * total / (maxBordersCount + 1);
+            while (idx + 1 < values.size() && cumulativeWeight <= target) {
+                cumulativeWeight += weights[++idx];
+            }
+            if (idx != 0) {
+                result.insert(BorderBefore(values, idx));
+            }
+        }
+        return result;
+    }
+
+    void AddUniformBorders(const TQuantileSketch& sketch, int bordersCount, bool snapToValues, THashSet<float>* borders) {
+        const auto values = sketch.GetValues();
+        const float minValue = sketch.GetMin();
+        const float maxValue = sketch.GetMax();
+        for (int i = 0; i < bordersCount; ++i) {
+            const double currentValue = minValue + (i + 1) * (maxValue - minValue) / (bordersCount + 1);
+            const size_t idx = LowerBound(values.begin(), values.end(), currentValue) - values.begin();
+            if (snapToValues && idx != 0 && idx != values.size()) {
+                borders->insert(BorderBefore(values, idx));
+            } else {
+                borders->insert(currentValue);
+            }
+        }
+    }
+
+    template <typename TBody>
+    void ExecRange(NPar::ILocalExecutor* localExecutor, int count, const TBody& body) {
+        if (localExecutor) {
+            localExecutor->ExecRangeWithThrow(body, 0, count, NPar::TLocalExecutor::WAIT_COMPLETE);
+        } else {
+            for (int i = 0; i < count; ++i) {
+                body(i);
+            }
+        }
+    }
+}
+
+namespace NSplitSelection {
+
+    TQuantileSketch::TQuantileSketch(
+        TConstArrayRef<float> values,
+        TConstArrayRef<float> weights,
+        size_t maxSize,
+        bool filterNans)
+        : MaxSize(maxSize)
+    {
+        Y_ENSURE(maxSize > 0, "Quantile sketch size should be positive.");
+        Y_ENSURE(weights.empty() || weights.size() == values.size(), "weights and features should have equal size.");
+
+        if (weights.empty()) {
+            TVector<float> sortedValues;
+            sortedValues.reserve(values.size());
+            for (float value : values) {
+                if (IsNan(value)) {
+                    Y_ENSURE(filterNans, "Nan value occurred");
+                    continue;
+                }
+                sortedValues.push_back(value);
+            }
+            Sort(sortedValues);
+            for (float value : sortedValues) {
+                AppendGrouped(value, 1, &Values, &Weights);
+            }
+            TotalWeight = sortedValues.size();
+        } else {
+            TVector<std::pair<float, float>> sortedValues;
+            sortedValues.reserve(values.size());
+            for (size_t i = 0; i < values.size(); ++i) {
+                if (weights[i] <= 0) {
+                    continue;
+                }
+                if (IsNan(values[i])) {
+                    Y_ENSURE(filterNans, "Nan value occurred");
+                    continue;
+                }
+                sortedValues.emplace_back(values[i], weights[i]);
+            }
+            Sort(sortedValues, [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+            for (const auto& [value, weight] : sortedValues) {
+                AppendGrouped(value, weight, &Values, &Weights);
+                TotalWeight += weight;
+            }
+        }
+
+        if (!Values.empty()) {
+            Min = Values.front();
+            Max = Values.back();
+        }
+        if (Values.size() > MaxSize) {
+            Compress();
+        }
+    }
+
+    void TQuantileSketch::Merge(const TQuantileSketch& rhs) {
+        if (rhs.Empty()) {
+            return;
+        }
+        if (Empty()) {
+            *this = rhs;
+            return;
+        }
+        Y_ENSURE(MaxSize == rhs.MaxSize, "Merged quantile sketches should have equal sizes.");
+
+        TVector<float> values;
+        TVector<double> weights;
+        values.reserve(Values.size() + rhs.Values.size());
+        weights.reserve(Values.size() + rhs.Values.size());
+        size_t i = 0;
+        size_t j = 0;
+        while (i < Values.size() || j < rhs.Values.size()) {
+            if (j == rhs.Values.size() || (i < Values.size() && Values[i] < rhs.Values[j])) {
+                AppendGrouped(Values[i], Weights[i], &values, &weights);
+                ++i;
+            } else {
+                AppendGrouped(rhs.Values[j], rhs.Weights[j], &values, &weights);
+                ++j;
+            }
+        }
+
+        Values = std::move(values);
+        Weights = std::move(weights);
+        TotalWeight += rhs.TotalWeight;
+        Min = ::Min(Min, rhs.Min);
+        Max = ::Max(Max, rhs.Max);
+        CompressionDepth = ::Max(CompressionDepth, rhs.CompressionDepth);
+        if (Values.size() > MaxSize) {
+            Compress();
+        }
+    }
+
+    void TQuantileSketch::Compress() {
+        const double step = TotalWeight / MaxSize;
+        size_t dst = 0;
+        double bucketWeight = 0.0;
+        double bucketSum = 0.0;
+
+        // the mean of a bucket lies between its first and last value, so the values stay sorted and distinct
+        const auto flushBucket = [&]() {
+            if (bucketWeight > 0.0) {
+                Values[dst] = static_cast<float>(bucketSum / bucketWeight);
+                Weights[dst] = bucketWeight;
+                ++dst;
+                bucketWeight = 0.0;
+                bucketSum = 0.0;
+            }
+        };
+
+        for (size_t i = 0; i < Values.size(); ++i) {
+            const float value = Values[i];
+            const double weight = Weights[i];
+            if (weight >= step) {
+                flushBucket();
+                Values[dst] = value;
+                Weights[dst] = weight;
+                ++dst;
+                continue;
+            }
+            if (bucketWeight + weight > step) {
+                flushBucket();
+            }
+            bucketWeight += weight;
+            bucketSum += weight * value;
+        }
+        flushBucket();
+
+        Values.resize(dst);
+        Weights.resize(dst);
+        ++CompressionDepth;
+    }
+
+    TQuantileSketch BuildQuantileSketch(
+        TConstArrayRef<float> values,
+        TConstArrayRef<float> weights,
+        NPar::ILocalExecutor* localExecutor,
+        const TSketchOptions& options,
+        bool filterNans
+    ) {
+        Y_ENSURE(options.ChunkSize > 0, "Chunk size should be positive.");
+        Y_ENSURE(weights.empty() || weights.size() == values.size(), "weights and features should have equal size.");
+
+        const size_t chunkCount = Max<size_t>(1, CeilDiv(values.size(), options.ChunkSize));
+        TVector<TQuantileSketch> sketches(chunkCount);
+        ExecRange(localExecutor, chunkCount, [&](int chunkIdx) {
+            const size_t begin = chunkIdx * options.ChunkSize;
+            const size_t size = Min(options.ChunkSize, values.size() - begin);
+            sketches[chunkIdx] = TQuantileSketch(
+                values.Slice(begin, size),
+                weights.empty() ? weights : weights.Slice(begin, size),
+                options.SketchSize,
+                filterNans);
+        });
+
+        // pairwise merges keep the depth of the merge tree logarithmic
+        for (size_t count = chunkCount; count > 1; count = CeilDiv<size_t>(count, 2)) {
+            ExecRange(localExecutor, count / 2, [&](int pairIdx) {
+                sketches[2 * pairIdx].Merge(sketches[2 * pairIdx + 1]);
+            });
+            for (size_t i = 1; i < CeilDiv<size_t>(count, 2); ++i) {
+                sketches[i] = std::move(sketches[2 * i]);
+            }
+        }
+        return std::move(sketches[0]);
+    }
+
+    THashSet<float> BestSplit(const TQuantileSketch& sketch, int maxBordersCount, EBorderSelectionType type) {
+        if (sketch.Empty() || sketch.GetMin() == sketch.GetMax()) {
+            return {};
+        }
+
+        switch (type) {
+            case EBorderSelectionType::MinEntropy:
+            case EBorderSelectionType::MaxLogSum:
+            case EBorderSelectionType::GreedyLogSum:
+            case EBorderSelectionType::GreedyMinEntropy: {
+                const auto sketchWeights = sketch.GetWeights();
+                TVector<float> weights(sketchWeights.begin(), sketchWeights.end());
+                return ::BestWeightedSplit(
+                    TVector<float>(sketch.GetValues().begin(), sketch.GetValues().end()),
+                    weights,
+                    maxBordersCount,
+                    type,
+                    /*filterNans*/ false,
+                    /*featuresAreSorted*/ true);
+            }
+            case EBorderSelectionType::Median:
+                return MedianBorders(sketch, maxBordersCount);
+            case EBorderSelectionType::Uniform: {
+                THashSet<float> borders;
+                AddUniformBorders(sketch, maxBordersCount, /*snapToValues*/ false, &borders);
+                return borders;
+            }
+            case EBorderSelectionType::UniformAndQuantiles: {
+                const int halfBorders = maxBordersCount / 2;
+                THashSet<float> borders = MedianBorders(sketch, maxBordersCount - halfBorders);
+                AddUniformBorders(sketch, halfBorders, /*snapToValues*/ true, &borders);
+                return borders;
+            }
+        }
+
+        ythrow yexception() << "got invalid enum value: " << static_cast<int>(type);
+    }
+
+}
+
+THashSet<float> BestSplitBySketch(
+    TConstArrayRef<float> features,
+    int maxBordersCount,
+    EBorderSelectionType type,
+    NPar::ILocalExecutor* localExecutor,
+    const TSketchOptions& options,
+    bool filterNans
+) {
+    const TQuantileSketch sketch = BuildQuantileSketch(features, /*weights*/ {}, localExecutor, options, filterNans);
+    return NSplitSelection::BestSplit(sketch, maxBordersCount, type);
+}
+
+THashSet<float> BestWeightedSplitBySketch(
+    TConstArrayRef<float> featureValues,
+    TConstArrayRef<float> weights,
+    int maxBordersCount,
+    EBorderSelectionType type,
+    NPar::ILocalExecutor* localExecutor,
+    const TSketchOptions& options,
+    bool filterNans
+) {
+    Y_ENSURE(featureValues.size() == weights.size(), "weights and features should have equal size.");
+    const TQuantileSketch sketch = BuildQuantileSketch(featureValues, weights, localExecutor, options, filterNans);
+    return NSplitSelection::BestSplit(sketch, maxBordersCount, type);
+}
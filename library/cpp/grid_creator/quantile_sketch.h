@@ -0,0 +1,122 @@
+#pragma once
+
+#include "binarization.h"
+
+#include <util/generic/array_ref.h>
+#include <util/generic/hash_set.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+namespace NPar {
+    class ILocalExecutor;
+}
+
+namespace NSplitSelection {
+
+    /* Mergeable summary of weighted feature values: distinct sorted values with their total weights.
+     *
+     * While the summary has at most MaxSize values it is exact. Otherwise it is compressed: runs of
+     * neighbour values with total weight below TotalWeight / MaxSize are replaced by their weighted mean,
+     * values heavier than that are kept as is. One compression shifts a rank of any point by at most
+     * TotalWeight / MaxSize, and every merge compresses at most once, so GetRankError() is bounded by
+     * (1 + depth of the merge tree) / MaxSize. Compressed summary has at most 2 * MaxSize + 1 values.
+     */
+    class TQuantileSketch {
+    public:
+        TQuantileSketch() = default;
+
+        // empty weights mean that every value has weight 1, values with non-positive weights are skipped
+        TQuantileSketch(
+            TConstArrayRef<float> values,
+            TConstArrayRef<float> weights,
+            size_t maxSize,
+            bool filterNans = false);
+
+        void Merge(const TQuantileSketch& rhs);
+
+        bool Empty() const {
+            return Values.empty();
+        }
+
+        TConstArrayRef<float> GetValues() const {
+            return Values;
+        }
+
+        TConstArrayRef<double> GetWeights() const {
+            return Weights;
+        }
+
+        double GetTotalWeight() const {
+            return TotalWeight;
+        }
+
+        // exact minimum and maximum of the values, compression does not change them
+        float GetMin() const {
+            return Min;
+        }
+
+        float GetMax() const {
+            return Max;
+        }
+
+        // upper bound of the rank error as a fraction of the total weight
+        double GetRankError() const {
+            return MaxSize ? static_cast<double>(CompressionDepth) / MaxSize : 0.0;
+        }
+
+    private:
+        void Compress();
+
+    private:
+        size_t MaxSize = 0;
+        ui32 CompressionDepth = 0;
+        TVector<float> Values;
+        TVector<double> Weights;
+        double TotalWeight = 0.0;
+        float Min = 0.0f;
+        float Max = 0.0f;
+    };
+
+    struct TSketchOptions {
+        // see TQuantileSketch, rank error for 1B values with default options is below 1.4e-4
+        size_t SketchSize = 1 << 16;
+        // values per task of the executor, sketches of chunks are merged pairwise
+        size_t ChunkSize = 1 << 22;
+    };
+
+    TQuantileSketch BuildQuantileSketch(
+        TConstArrayRef<float> values,
+        TConstArrayRef<float> weights,
+        NPar::ILocalExecutor* localExecutor,
+        const TSketchOptions& options = {},
+        bool filterNans = false);
+
+    // Borders are selected over the sketch values with their weights, as BestWeightedSplit does for
+    // MinEntropy, MaxLogSum, GreedyLogSum and GreedyMinEntropy. Median, Uniform and UniformAndQuantiles
+    // use weighted quantiles and exact min and max of the sketch.
+    THashSet<float> BestSplit(const TQuantileSketch& sketch, int maxBordersCount, EBorderSelectionType type);
+
+}
+
+/* Approximate BestSplit/BestWeightedSplit for huge features: a quantile sketch is built in parallel
+ * on localExecutor (sequentially if it is nullptr) and borders are selected over it. Cumulative weights
+ * seen by border selection differ from the exact ones by at most GetRankError() of the total weight.
+ * Features with at most options.SketchSize distinct values in every chunk and after every merge are not
+ * compressed at all and get the same borders as the exact path.
+ */
+THashSet<float> BestSplitBySketch(
+    TConstArrayRef<float> features,
+    int maxBordersCount,
+    EBorderSelectionType type,
+    NPar::ILocalExecutor* localExecutor,
+    const NSplitSelection::TSketchOptions& options = {},
+    bool filterNans = false);
+
+THashSet<float> BestWeightedSplitBySketch(
+    TConstArrayRef<float> featureValues,
+    TConstArrayRef<float> weights,
+    int maxBordersCount,
+    EBorderSelectionType type,
+    NPar::ILocalExecutor* localExecutor,
+    const NSplitSelection::TSketchOptions& options = {},
+    bool filterNans = false);
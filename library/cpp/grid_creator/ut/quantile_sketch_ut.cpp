@@ -0,0 +1,148 @@
+#include <library/cpp/grid_creator/quantile_sketch.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/hash_set.h>
+#include <util/generic/serialized_enum.h>
+#include <util/generic/vector.h>
+#include <util/generic/ymath.h>
+#include <util/random/fast.h>
+
+
+using namespace NSplitSelection;
+
+
+static TVector<float> GenerateValues(size_t size, ui32 distinctCount, ui64 seed) {
+    TFastRng<ui64> rng(seed);
+    TVector<float> values(size);
+    for (float& value : values) {
+        value = distinctCount ? static_cast<float>(rng.Uniform(distinctCount)) : static_cast<float>(rng.GenRandReal1() * 100 - 50);
+    }
+    return values;
+}
+
+static TVector<float> SortedBorders(const THashSet<float>& borders) {
+    TVector<float> result(borders.begin(), borders.end());
+    Sort(result);
+    return result;
+}
+
+static double SumLogBinSizes(TVector<float> sortedValues, const TVector<float>& borders) {
+    double result = 0;
+    size_t begin = 0;
+    for (size_t i = 0; i <= borders.size(); ++i) {
+        const size_t end = i < borders.size()
+            ? UpperBound(sortedValues.begin(), sortedValues.end(), borders[i]) - sortedValues.begin()
+            : sortedValues.size();
+        result += log(end - begin + 1e-8);
+        begin = end;
+    }
+    return result;
+}
+
+Y_UNIT_TEST_SUITE(QuantileSketchTests) {
+    Y_UNIT_TEST(TestEmpty) {
+        UNIT_ASSERT(BestSplitBySketch({}, 10, EBorderSelectionType::GreedyLogSum, nullptr).empty());
+        const TVector<float> values = {1.0f, 1.0f, 1.0f};
+        UNIT_ASSERT(BestSplitBySketch(values, 10, EBorderSelectionType::Median, nullptr).empty());
+    }
+
+    Y_UNIT_TEST(TestExactForFewDistinctValues) {
+        const TVector<float> values = GenerateValues(100000, 300, 0);
+        TSketchOptions options;
+        options.SketchSize = 1000;
+        options.ChunkSize = 7000;
+        const TQuantileSketch sketch = BuildQuantileSketch(values, {}, nullptr, options);
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetRankError(), 0.0);
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetTotalWeight(), values.size());
+
+        for (auto type : GetEnumAllValues<EBorderSelectionType>()) {
+            for (int maxBordersCount : {1, 16, 254}) {
+                TVector<float> valuesCopy = values;
+                const THashSet<float> exact = BestSplit(valuesCopy, maxBordersCount, type);
+                const THashSet<float> approximate = BestSplitBySketch(values, maxBordersCount, type, nullptr, options);
+                UNIT_ASSERT_EQUAL_C(SortedBorders(approximate), SortedBorders(exact), type << ' ' << maxBordersCount);
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestRankErrorBound) {
+        TVector<float> values = GenerateValues(1000000, 0, 1);
+        TSketchOptions options;
+        options.SketchSize = 1024;
+        options.ChunkSize = 50000;
+        const TQuantileSketch sketch = BuildQuantileSketch(values, {}, nullptr, options);
+        UNIT_ASSERT_GT(sketch.GetRankError(), 0.0);
+        UNIT_ASSERT_LE(sketch.GetValues().size(), 2 * options.SketchSize + 1);
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetMin(), *MinElement(values.begin(), values.end()));
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetMax(), *MaxElement(values.begin(), values.end()));
+
+        const int maxBordersCount = 63;
+        const TVector<float> borders = SortedBorders(BestSplit(sketch, maxBordersCount, EBorderSelectionType::Median));
+        UNIT_ASSERT_VALUES_EQUAL(borders.size(), maxBordersCount);
+        Sort(values);
+        for (size_t i = 0; i < borders.size(); ++i) {
+            const double rank = double(LowerBound(values.begin(), values.end(), borders[i]) - values.begin()) / values.size();
+            UNIT_ASSERT_DOUBLES_EQUAL(rank, double(i + 1) / (maxBordersCount + 1), sketch.GetRankError() + 1e-5);
+        }
+    }
+
+    Y_UNIT_TEST(TestGreedyQuality) {
+        TVector<float> values = GenerateValues(1000000, 0, 2);
+        TSketchOptions options;
+        options.SketchSize = 4096;
+        options.ChunkSize = 100000;
+
+        TVector<float> valuesCopy = values;
+        const TVector<float> exact = SortedBorders(BestSplit(valuesCopy, 254, EBorderSelectionType::GreedyLogSum));
+        const TVector<float> approximate = SortedBorders(
+            BestSplitBySketch(values, 254, EBorderSelectionType::GreedyLogSum, nullptr, options));
+        UNIT_ASSERT_VALUES_EQUAL(approximate.size(), exact.size());
+
+        Sort(values);
+        const double exactScore = SumLogBinSizes(values, exact);
+        const double approximateScore = SumLogBinSizes(values, approximate);
+        UNIT_ASSERT_DOUBLES_EQUAL(approximateScore, exactScore, 1e-3 * Abs(exactScore));
+    }
+
+    Y_UNIT_TEST(TestParallel) {
+        const TVector<float> values = GenerateValues(300000, 0, 3);
+        TSketchOptions options;
+        options.SketchSize = 2048;
+        options.ChunkSize = 10000;
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+        for (auto type : {EBorderSelectionType::GreedyLogSum, EBorderSelectionType::UniformAndQuantiles}) {
+            const THashSet<float> sequential = BestSplitBySketch(values, 128, type, nullptr, options);
+            const THashSet<float> parallel = BestSplitBySketch(values, 128, type, &localExecutor, options);
+            UNIT_ASSERT_EQUAL(sequential, parallel);
+        }
+    }
+
+    Y_UNIT_TEST(TestWeights) {
+        const TVector<float> values = {1.0f, 2.0f, 3.0f, 4.0f, Max<float>()};
+        const TVector<float> weights = {1.0f, 1.0f, 1.0f, 1.0f, 0.0f};
+        const TVector<float> unweighted = {1.0f, 2.0f, 3.0f, 4.0f};
+        for (auto type : GetEnumAllValues<EBorderSelectionType>()) {
+            UNIT_ASSERT_EQUAL(
+                BestWeightedSplitBySketch(values, weights, 3, type, nullptr),
+                BestSplitBySketch(unweighted, 3, type, nullptr));
+        }
+
+        const TVector<float> heavy = {1.0f, 2.0f, 3.0f, 4.0f};
+        const TVector<float> heavyWeights = {1.0f, 1.0f, 100.0f, 1.0f};
+        const THashSet<float> borders = BestWeightedSplitBySketch(heavy, heavyWeights, 1, EBorderSelectionType::Median, nullptr);
+        UNIT_ASSERT_EQUAL(borders, THashSet<float>({2.5f}));
+    }
+
+    Y_UNIT_TEST(TestNans) {
+        const TVector<float> values = {1.0f, std::numeric_limits<float>::quiet_NaN(), 2.0f};
+        UNIT_ASSERT_EXCEPTION(BestSplitBySketch(values, 2, EBorderSelectionType::Median, nullptr), yexception);
+        UNIT_ASSERT_EQUAL(
+            BestSplitBySketch(values, 2, EBorderSelectionType::Median, nullptr, {}, /*filterNans*/ true),
+            THashSet<float>({1.5f}));
+    }
+}
@@ -11,8 +11,14 @@
 #include <library/cpp/blockcodecs/stream.h>
 #include <library/cpp/blockcodecs/codecs.h>
 
-#include <util/stream/zlib.h>
+#include <contrib/libs/zlib/zlib.h>
 
+#include <util/digest/city.h>
+#include <util/generic/buffer.h>
+#include <util/stream/str.h>
+#include <util/stream/zlib.h>
+#include <util/system/info.h>
+#include <util/system/rusage.h>
 
 TCompressionCodecFactory::TCompressionCodecFactory() {
     auto gzip = [](auto s) {
@@ -64,3 +70,416 @@ void TCompressionCodecFactory::Add(TStringBuf name, TDecoderConstructor d, TEnco
     Codecs_[Strings_.back()] = TCodec{d, e};
     BestCodecs_.emplace_back(Strings_.back());
 }
+
+namespace NHttp {
+    TAdaptiveCompressionLevel::TAdaptiveCompressionLevel(int minLevel, int maxLevel, double targetLoad)
+        : MinLevel_(minLevel)
+        , MaxLevel_(Max(minLevel, maxLevel))
+        , TargetLoad_(targetLoad)
+        , Level_(MaxLevel_)
+    {
+    }
+
+    void TAdaptiveCompressionLevel::Update(double load) noexcept {
+        // hysteresis keeps the level from flapping around the target
+        const int level = Level();
+
+        if (load > TargetLoad_) {
+            Level_.store(Max(level - 1, MinLevel_), std::memory_order_relaxed);
+        } else if (load < TargetLoad_ - 0.1) {
+            Level_.store(Min(level + 1, MaxLevel_), std::memory_order_relaxed);
+        }
+    }
+
+    void TAdaptiveCompressionLevel::UpdateFromRusage(TDuration interval) {
+        const TInstant now = TInstant::Now();
+
+        if (now.MicroSeconds() < NextUpdate_.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        const TRusage usage = TRusage::Get();
+        const TDuration cpuTime = usage.Utime + usage.Stime;
+
+        with_lock (Lock_) {
+            if (LastUpdate_ && now - LastUpdate_ < interval) {
+                return;
+            }
+
+            NextUpdate_.store((now + interval).MicroSeconds(), std::memory_order_relaxed);
+
+            if (LastUpdate_ && now > LastUpdate_) {
+                const double cpus = NSystemInfo::CachedNumberOfCpus();
+                Update((cpuTime - LastCpuTime_).SecondsFloat() / ((now - LastUpdate_).SecondsFloat() * cpus));
+            }
+
+            LastUpdate_ = now;
+            LastCpuTime_ = cpuTime;
+        }
+    }
+
+    TCompressedBodyCache::TCompressedBodyCache(size_t maxBytes, size_t maxBodySize)
+        : MaxBodySize_(maxBodySize)
+        , Cache_(maxBytes)
+    {
+    }
+
+    ui64 TCompressedBodyCache::Key(TStringBuf coding, TStringBuf body) noexcept {
+        return CityHash64WithSeeds(body.data(), body.size(), CityHash64(coding.data(), coding.size()), body.size());
+    }
+
+    bool TCompressedBodyCache::Find(TStringBuf coding, TStringBuf body, TString& compressed) {
+        const ui64 key = Key(coding, body);
+
+        with_lock (Lock_) {
+            auto it = Cache_.Find(key);
+
+            if (it == Cache_.End() || it->Coding != coding || it->Body != body) {
+                ++Stats_.Misses;
+
+                return false;
+            }
+
+            ++Stats_.Hits;
+            compressed = it->Compressed;
+        }
+
+        return true;
+    }
+
+    void TCompressedBodyCache::Insert(TStringBuf coding, TStringBuf body, const TString& compressed) {
+        const ui64 key = Key(coding, body);
+
+        with_lock (Lock_) {
+            // replaces the entry of a colliding body
+            Cache_.Update(key, TEntry{TString(coding), TString(body), compressed});
+            Stats_.Bytes = Cache_.TotalSize();
+        }
+    }
+
+    TCompressedBodyCache::TStats TCompressedBodyCache::Stats() const {
+        with_lock (Lock_) {
+            return Stats_;
+        }
+    }
+
+    class TCompressionContext::TZLibState {
+    public:
+        TZLibState(ZLib::StreamType type, int level)
+            : Type_(type)
+            , Level_(level)
+            , Buf_(ZLib::ZLIB_BUF_LEN)
+        {
+            Zero(Z_);
+
+            if (deflateInit2(&Z_, level, Z_DEFLATED, type == ZLib::GZip ? 31 : 15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+                ythrow TZLibCompressorError() << "can not init deflate engine";
+            }
+
+            if (type == ZLib::GZip) {
+                // same as TZLibCompress, output does not depend on the platform
+                Zero(Header_);
+                Header_.os = 3;
+                deflateSetHeader(&Z_, &Header_);
+            }
+
+            ResetBuffer();
+        }
+
+        ~TZLibState() {
+            deflateEnd(&Z_);
+        }
+
+        ZLib::StreamType Type() const noexcept {
+            return Type_;
+        }
+
+        void Reset(int level) {
+            if (deflateReset(&Z_) != Z_OK) {
+                ythrow TZLibCompressorError() << "can not reset deflate engine";
+            }
+
+            if (Type_ == ZLib::GZip) {
+                deflateSetHeader(&Z_, &Header_);
+            }
+
+            if (level != Level_) {
+                if (deflateParams(&Z_, level, Z_DEFAULT_STRATEGY) != Z_OK) {
+                    ythrow TZLibCompressorError() << "can not change deflate level";
+                }
+
+                Level_ = level;
+            }
+
+            ResetBuffer();
+        }
+
+        void Write(IOutputStream* out, const void* buf, size_t len) {
+            Z_.next_in = (Bytef*)buf;
+            Z_.avail_in = len;
+
+            while (Z_.avail_in) {
+                Deflate(Z_NO_FLUSH);
+
+                if (!Z_.avail_out) {
+                    WriteBuffer(out);
+                }
+            }
+        }
+
+        void Flush(IOutputStream* out) {
+            Z_.next_in = nullptr;
+            Z_.avail_in = 0;
+
+            Deflate(Z_SYNC_FLUSH);
+
+            while (!Z_.avail_out) {
+                WriteBuffer(out);
+                Deflate(Z_SYNC_FLUSH);
+            }
+
+            WriteBuffer(out);
+        }
+
+        void Finish(IOutputStream* out) {
+            Z_.next_in = nullptr;
+            Z_.avail_in = 0;
+
+            while (Deflate(Z_FINISH) != Z_STREAM_END) {
+                WriteBuffer(out);
+            }
+
+            WriteBuffer(out);
+        }
+
+    private:
+        int Deflate(int flush) {
+            const int ret = deflate(&Z_, flush);
+
+            if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR) {
+                ythrow TZLibCompressorError() << "deflate error(" << (Z_.msg ? Z_.msg : "unknown") << ")";
+            }
+
+            return ret;
+        }
+
+        void WriteBuffer(IOutputStream* out) {
+            if (const size_t len = Buf_.Capacity() - Z_.avail_out) {
+                out->Write(Buf_.Data(), len);
+            }
+
+            ResetBuffer();
+        }
+
+        void ResetBuffer() noexcept {
+            Z_.next_out = (Bytef*)Buf_.Data();
+            Z_.avail_out = Buf_.Capacity();
+        }
+
+    private:
+        const ZLib::StreamType Type_;
+        int Level_;
+        z_stream Z_;
+        gz_header Header_;
+        TBuffer Buf_;
+    };
+
+    class TCompressionContext::TZLibEncoder: public IOutputStream {
+    public:
+        TZLibEncoder(TCompressionContext* context, THolder<TZLibState> state, IOutputStream* slave)
+            : Context_(context)
+            , State_(std::move(state))
+            , Slave_(slave)
+        {
+        }
+
+        ~TZLibEncoder() override {
+            try {
+                Finish();
+            } catch (...) {
+            }
+        }
+
+    private:
+        void DoWrite(const void* buf, size_t len) override {
+            if (!State_) {
+                ythrow TZLibCompressorError() << "can not write to finished zlib stream";
+            }
+
+            State_->Write(Slave_, buf, len);
+        }
+
+        void DoFlush() override {
+            if (State_) {
+                State_->Flush(Slave_);
+            }
+        }
+
+        void DoFinish() override {
+            THolder<TZLibState> state(State_.Release());
+
+            if (state) {
+                state->Finish(Slave_);
+                Context_->Release(std::move(state));
+            }
+        }
+
+    private:
+        TCompressionContext* Context_;
+        THolder<TZLibState> State_;
+        IOutputStream* Slave_;
+    };
+
+    // buffers small body to serve it from TCompressedBodyCache,
+    // switches to streaming compression on overflow or explicit flush
+    class TCompressionContext::TCachingEncoder: public IOutputStream {
+    public:
+        TCachingEncoder(TCompressionContext* context, TStringBuf coding, IOutputStream* slave)
+            : Context_(context)
+            , Coding_(coding)
+            , Slave_(slave)
+        {
+        }
+
+        ~TCachingEncoder() override {
+            try {
+                Finish();
+            } catch (...) {
+            }
+        }
+
+    private:
+        void DoWrite(const void* buf, size_t len) override {
+            if (Stream_) {
+                Stream_->Write(buf, len);
+
+                return;
+            }
+
+            Body_.append((const char*)buf, len);
+
+            if (Body_.size() > Context_->Cache_->MaxBodySize()) {
+                StartStreaming();
+            }
+        }
+
+        void DoFlush() override {
+            if (Finished_) {
+                return;
+            }
+
+            StartStreaming();
+            Stream_->Flush();
+        }
+
+        void DoFinish() override {
+            if (Finished_) {
+                return;
+            }
+
+            Finished_ = true;
+
+            if (Stream_) {
+                Stream_->Finish();
+
+                return;
+            }
+
+            TCompressedBodyCache* cache = Context_->Cache_;
+            TString compressed;
+
+            if (!cache->Find(Coding_, Body_, compressed)) {
+                {
+                    TStringOutput out(compressed);
+                    THolder<IOutputStream> encoder = Context_->CreateStreamingEncoder(Coding_, &out);
+
+                    encoder->Write(Body_);
+                    encoder->Finish();
+                }
+
+                cache->Insert(Coding_, Body_, compressed);
+            }
+
+            Slave_->Write(compressed);
+        }
+
+        void StartStreaming() {
+            if (!Stream_) {
+                Stream_ = Context_->CreateStreamingEncoder(Coding_, Slave_);
+                Stream_->Write(Body_);
+                Body_.clear();
+            }
+        }
+
+    private:
+        TCompressionContext* Context_;
+        const TString Coding_;
+        IOutputStream* Slave_;
+        TString Body_;
+        THolder<IOutputStream> Stream_;
+        bool Finished_ = false;
+    };
+
+    TCompressionContext::TCompressionContext(TAdaptiveCompressionLevel* level, TCompressedBodyCache* cache)
+        : Level_(level)
+        , Cache_(cache)
+    {
+    }
+
+    TCompressionContext::~TCompressionContext() = default;
+
+    THolder<IOutputStream> TCompressionContext::CreateEncoder(TStringBuf coding, IOutputStream* slave) {
+        if (!TCompressionCodecFactory::Instance().FindEncoder(coding)) {
+            return nullptr;
+        }
+
+        if (Level_) {
+            Level_->UpdateFromRusage();
+        }
+
+        if (Cache_) {
+            return MakeHolder<TCachingEncoder>(this, coding, slave);
+        }
+
+        return CreateStreamingEncoder(coding, slave);
+    }
+
+    THolder<IOutputStream> TCompressionContext::CreateStreamingEncoder(TStringBuf coding, IOutputStream* slave) {
+        const int level = Level_ ? Level_->Level() : 6;
+
+        if (coding == TStringBuf("gzip") || coding == TStringBuf("x-gzip") || coding == TStringBuf("deflate") || coding == TStringBuf("x-deflate")) {
+            const ZLib::StreamType type = coding.EndsWith(TStringBuf("gzip")) ? ZLib::GZip : ZLib::ZLib;
+
+            for (auto it = FreeStates_.begin(); it != FreeStates_.end(); ++it) {
+                if ((*it)->Type() == type) {
+                    THolder<TZLibState> state = std::move(*it);
+                    FreeStates_.erase(it);
+                    state->Reset(level);
+                    ++Reused_;
+
+                    return MakeHolder<TZLibEncoder>(this, std::move(state), slave);
+                }
+            }
+
+            return MakeHolder<TZLibEncoder>(this, MakeHolder<TZLibState>(type, level), slave);
+        }
+
+        if (coding == TStringBuf("br")) {
+            // brotli state can not be reset, but quality still follows the level
+            return MakeHolder<TBrotliCompress>(slave, Max(level - 2, 0));
+        }
+
+        if (auto encoder = TCompressionCodecFactory::Instance().FindEncoder(coding)) {
+            return (*encoder)(slave);
+        }
+
+        return nullptr;
+    }
+
+    void TCompressionContext::Release(THolder<TZLibState> state) {
+        // gzip and deflate are enough for any sane client
+        if (FreeStates_.size() < 2) {
+            FreeStates_.push_back(std::move(state));
+        }
+    }
+}
@@ -2,8 +2,14 @@
 
 #include "stream.h"
 
+#include <library/cpp/cache/cache.h>
+
+#include <util/datetime/base.h>
 #include <util/generic/deque.h>
 #include <util/generic/hash.h>
+#include <util/system/mutex.h>
+
+#include <atomic>
 
 class TCompressionCodecFactory {
 public:
@@ -69,4 +75,113 @@ namespace NHttp {
 
         return "identity";
     }
+
+    /// Compression effort in zlib scale (1..9) following the process cpu load:
+    /// lowered while the load is above the target, raised back when there is headroom.
+    /// One instance is usually shared by all connections of a server.
+    class TAdaptiveCompressionLevel {
+    public:
+        TAdaptiveCompressionLevel(int minLevel = 1, int maxLevel = 6, double targetLoad = 0.7);
+
+        int Level() const noexcept {
+            return Level_.load(std::memory_order_relaxed);
+        }
+
+        /// @param load fraction of all cpus used by the process, [0, 1]
+        void Update(double load) noexcept;
+
+        /// measures the process load since the previous call with getrusage,
+        /// does nothing if called more often than interval.
+        /// TCompressionContext calls it for every compressed response.
+        void UpdateFromRusage(TDuration interval = TDuration::Seconds(1));
+
+    private:
+        const int MinLevel_;
+        const int MaxLevel_;
+        const double TargetLoad_;
+        std::atomic<int> Level_;
+        std::atomic<ui64> NextUpdate_ = 0; // microseconds, lets frequent callers skip getrusage
+
+        TMutex Lock_;
+        TInstant LastUpdate_;
+        TDuration LastCpuTime_;
+    };
+
+    /// Compressed response bodies keyed by coding and body hash,
+    /// identical bodies (error pages, common json) are compressed once.
+    /// Entries keep the body too, a hit is compared with it, so a hash collision is just a miss.
+    /// Thread safe, LRU-bounded by total size of stored bodies and compressed data.
+    class TCompressedBodyCache {
+    public:
+        struct TStats {
+            ui64 Hits = 0;
+            ui64 Misses = 0;
+            size_t Bytes = 0;
+        };
+
+        TCompressedBodyCache(size_t maxBytes, size_t maxBodySize = 64 << 10);
+
+        /// bodies larger than this are compressed on the fly and not cached
+        size_t MaxBodySize() const noexcept {
+            return MaxBodySize_;
+        }
+
+        bool Find(TStringBuf coding, TStringBuf body, TString& compressed);
+        void Insert(TStringBuf coding, TStringBuf body, const TString& compressed);
+
+        TStats Stats() const;
+
+    private:
+        struct TEntry {
+            TString Coding;
+            TString Body;
+            TString Compressed;
+        };
+
+        struct TSize {
+            size_t operator()(const TEntry& entry) const noexcept {
+                return entry.Body.size() + entry.Compressed.size();
+            }
+        };
+
+        static ui64 Key(TStringBuf coding, TStringBuf body) noexcept;
+
+    private:
+        const size_t MaxBodySize_;
+        TMutex Lock_;
+        TLRUCache<ui64, TEntry, TNoopDelete, TSize> Cache_;
+        TStats Stats_;
+    };
+
+    /// Per-connection encoder state kept between responses: deflate engines are reset
+    /// instead of reallocated, so small compressed responses do not pay for setup.
+    /// Must outlive all encoders created by it. Not thread safe.
+    class TCompressionContext {
+    public:
+        TCompressionContext(TAdaptiveCompressionLevel* level = nullptr, TCompressedBodyCache* cache = nullptr);
+        ~TCompressionContext();
+
+        /// @return nullptr for unknown coding
+        THolder<IOutputStream> CreateEncoder(TStringBuf coding, IOutputStream* slave);
+
+        /// number of encoders created from pooled state
+        size_t Reused() const noexcept {
+            return Reused_;
+        }
+
+    private:
+        class TZLibState;
+
+        THolder<IOutputStream> CreateStreamingEncoder(TStringBuf coding, IOutputStream* slave);
+        void Release(THolder<TZLibState> state);
+
+    private:
+        class TZLibEncoder;
+        class TCachingEncoder;
+
+        TAdaptiveCompressionLevel* Level_;
+        TCompressedBodyCache* Cache_;
+        TVector<THolder<TZLibState>> FreeStates_;
+        size_t Reused_ = 0;
+    };
 }
@@ -4,6 +4,8 @@
 #include <library/cpp/testing/unittest/registar.h>
 #include <library/cpp/testing/unittest/tests_data.h>
 
+#include <util/stream/null.h>
+#include <util/stream/str.h>
 #include <util/stream/zlib.h>
 #include <util/generic/hash_set.h>
 
@@ -57,4 +59,94 @@ Y_UNIT_TEST_SUITE(THttpCompressionTest) {
         accepted.insert("*");
         UNIT_ASSERT_VALUES_EQUAL("gzip", NHttp::ChooseBestCompressionScheme(checkAccepted, {"gzip", "deflate"}));
     }
+
+    static TString Decode(TStringBuf coding, const TString& data) {
+        TStringInput in(data);
+        return (*TCompressionCodecFactory::Instance().FindDecoder(coding))(&in)->ReadAll();
+    }
+
+    Y_UNIT_TEST(TestContextReuse) {
+        NHttp::TCompressionContext context;
+
+        for (TStringBuf coding : {"gzip", "deflate", "gzip", "br", "deflate"}) {
+            TString buffer;
+
+            {
+                TStringOutput out(buffer);
+                auto encoder = context.CreateEncoder(coding, &out);
+                UNIT_ASSERT(encoder);
+                encoder->Write(DATA);
+                encoder->Flush();
+                encoder->Write(DATA);
+                encoder->Finish();
+            }
+
+            UNIT_ASSERT_VALUES_EQUAL(Decode(coding, buffer), DATA + DATA);
+        }
+
+        UNIT_ASSERT_VALUES_EQUAL(context.Reused(), 2);
+        UNIT_ASSERT(!context.CreateEncoder("unknown", &Cnull));
+    }
+
+    Y_UNIT_TEST(TestContextSameOutput) {
+        const TString data = TString(10000, 'x') + DATA;
+        NHttp::TCompressionContext context;
+        TString first;
+        TString second;
+
+        for (TString* buffer : {&first, &second}) {
+            TStringOutput out(*buffer);
+            context.CreateEncoder("gzip", &out)->Write(data);
+        }
+
+        UNIT_ASSERT_VALUES_EQUAL(first, second);
+        UNIT_ASSERT_VALUES_EQUAL(Decode("gzip", second), data);
+    }
+
+    Y_UNIT_TEST(TestBodyCache) {
+        NHttp::TCompressedBodyCache cache(1 << 20, 100);
+        NHttp::TCompressionContext context(nullptr, &cache);
+        const TString big(1000, 'y');
+
+        auto compress = [&](TStringBuf coding, const TString& body) {
+            TString buffer;
+            TStringOutput out(buffer);
+            auto encoder = context.CreateEncoder(coding, &out);
+            encoder->Write(body);
+            encoder->Finish();
+            UNIT_ASSERT_VALUES_EQUAL(Decode(coding, buffer), body);
+            return buffer;
+        };
+
+        const TString compressed = compress("gzip", DATA);
+        UNIT_ASSERT_VALUES_EQUAL(compress("gzip", DATA), compressed);
+        compress("deflate", DATA);
+        compress("gzip", big);
+        compress("gzip", big);
+
+        const auto stats = cache.Stats();
+        UNIT_ASSERT_VALUES_EQUAL(stats.Hits, 1);
+        UNIT_ASSERT_VALUES_EQUAL(stats.Misses, 2);
+        UNIT_ASSERT(stats.Bytes > 0);
+    }
+
+    Y_UNIT_TEST(TestAdaptiveLevel) {
+        NHttp::TAdaptiveCompressionLevel level(1, 6, 0.7);
+        UNIT_ASSERT_VALUES_EQUAL(level.Level(), 6);
+
+        for (size_t i = 0; i < 10; ++i) {
+            level.Update(0.9);
+        }
+        UNIT_ASSERT_VALUES_EQUAL(level.Level(), 1);
+
+        level.Update(0.65);
+        UNIT_ASSERT_VALUES_EQUAL(level.Level(), 1);
+
+        level.Update(0.3);
+        level.Update(0.3);
+        UNIT_ASSERT_VALUES_EQUAL(level.Level(), 3);
+
+        level.UpdateFromRusage(TDuration::Zero());
+        UNIT_ASSERT(level.Level() >= 1 && level.Level() <= 6);
+    }
 } // THttpCompressionTest suite
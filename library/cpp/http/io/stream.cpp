@@ -586,6 +586,10 @@ public:
         ComprSchemas_ = schemas;
     }
 
+    inline void SetCompressionContext(NHttp::TCompressionContext* context) {
+        CompressionContext_ = context;
+    }
+
     inline void EnableKeepAlive(bool enable) {
         KeepAliveEnabled_ = enable;
     }
@@ -807,6 +811,7 @@ private:
     inline void RebuildStream() {
         bool keepAlive = false;
         const TCompressionCodecFactory::TEncoderConstructor* encoder = nullptr;
+        TString coding;
         bool chunked = false;
         bool haveContentLength = false;
 
@@ -817,7 +822,8 @@ private:
             if (hl == TStringBuf("connection")) {
                 keepAlive = to_lower(header.Value()) == TStringBuf("keep-alive");
             } else if (IsCompressionHeaderEnabled() && hl == TStringBuf("content-encoding")) {
-                encoder = TCompressionCodecFactory::Instance().FindEncoder(to_lower(header.Value()));
+                coding = to_lower(header.Value());
+                encoder = TCompressionCodecFactory::Instance().FindEncoder(coding);
             } else if (hl == TStringBuf("transfer-encoding")) {
                 chunked = to_lower(header.Value()) == TStringBuf("chunked");
             } else if (hl == TStringBuf("content-length")) {
@@ -837,7 +843,17 @@ private:
         Output_ = Streams_.Add(new TTeeOutput(Output_, &SizeCalculator_));
 
         if (IsBodyEncodingEnabled() && encoder) {
-            Output_ = Streams_.Add((*encoder)(Output_).Release());
+            THolder<IOutputStream> stream;
+
+            if (CompressionContext_) {
+                stream = CompressionContext_->CreateEncoder(coding, Output_);
+            }
+
+            if (!stream) {
+                stream = (*encoder)(Output_);
+            }
+
+            Output_ = Streams_.Add(stream.Release());
         }
     }
 
@@ -865,6 +881,7 @@ private:
     size_t Version_;
 
     TArrayRef<const TStringBuf> ComprSchemas_;
+    NHttp::TCompressionContext* CompressionContext_ = nullptr;
 
     bool KeepAliveEnabled_;
     bool BodyEncodingEnabled_;
@@ -921,6 +938,10 @@ void THttpOutput::EnableCompression(TArrayRef<const TStringBuf> schemas) {
     Impl_->EnableCompression(schemas);
 }
 
+void THttpOutput::SetCompressionContext(NHttp::TCompressionContext* context) {
+    Impl_->SetCompressionContext(context);
+}
+
 void THttpOutput::EnableKeepAlive(bool enable) {
     Impl_->EnableKeepAlive(enable);
 }
@@ -12,6 +12,10 @@
 
 class TSocket;
 
+namespace NHttp {
+    class TCompressionContext;
+}
+
 struct THttpException: public yexception {
 };
 
@@ -112,6 +116,11 @@ public:
     void EnableCompression(bool enable);
     void EnableCompression(TArrayRef<const TStringBuf> schemas);
 
+    /// Устанавливает контекст сжатия соединения: состояние кодеков переиспользуется
+    /// между ответами, уровень и кэш сжатых тел берутся из контекста.
+    /// Контекст должен пережить поток.
+    void SetCompressionContext(NHttp::TCompressionContext* context);
+
     /// Устанавливает режим, при котором соединение с сервером не завершается
     /// после окончания транзакции.
     void EnableKeepAlive(bool enable);
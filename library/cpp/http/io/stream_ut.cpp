@@ -1,5 +1,6 @@
 #include "stream.h"
 #include "chunk.h"
+#include "compression.h"
 
 #include <library/cpp/http/server/http_ex.h>
 
@@ -487,6 +488,36 @@ Y_UNIT_TEST_SUITE(THttpStreamTest) {
         UNIT_ASSERT(result.Contains("content-encoding: gzip"));
     }
 
+    Y_UNIT_TEST(CompressionContext) {
+        NHttp::TCompressedBodyCache cache(1 << 20);
+        NHttp::TCompressionContext context(nullptr, &cache);
+        const TString answer = "Mary had a little lamb.";
+
+        for (size_t i = 0; i < 3; ++i) {
+            TMemoryInput request("GET / HTTP/1.1\r\nAccept-Encoding: gzip\r\n\r\n");
+            THttpInput in(&request);
+            TString result;
+            TStringOutput out(result);
+
+            {
+                THttpOutput httpOut(&out, &in);
+                httpOut.EnableKeepAlive(true);
+                httpOut.EnableCompression(true);
+                httpOut.SetCompressionContext(&context);
+                httpOut << "HTTP/1.1 200 OK\r\n\r\n";
+                httpOut << answer;
+                httpOut.Finish();
+            }
+
+            TStringInput response(result);
+            THttpInput httpIn(&response);
+            UNIT_ASSERT(httpIn.ContentEncoded());
+            UNIT_ASSERT_VALUES_EQUAL(httpIn.ReadAll(), answer);
+        }
+
+        UNIT_ASSERT_VALUES_EQUAL(cache.Stats().Hits, 2);
+    }
+
     Y_UNIT_TEST(HasTrailers) {
         TMemoryInput response(
             "HTTP/1.1 200 OK\r\n"
@@ -0,0 +1,129 @@
+#include <library/cpp/http/push_parser/http_head_parser.h>
+#include <library/cpp/http/push_parser/http_parser.h>
+#include <library/cpp/testing/benchmark/bench.h>
+
+#include <util/generic/singleton.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+
+// request heads as sent by browsers and http clients,
+// Whole - complete head in one buffer, Split - head arrives in 256 bytes pieces.
+
+namespace {
+    const char* const RawHeads[] = {
+        "GET /search/?text=http+parser&lr=213&clid=2186621 HTTP/1.1\r\n"
+        "Host: www.example.com\r\n"
+        "Connection: keep-alive\r\n"
+        "Upgrade-Insecure-Requests: 1\r\n"
+        "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/96.0.4664.110 Safari/537.36\r\n"
+        "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,image/apng,*/*;q=0.8\r\n"
+        "Sec-Fetch-Site: same-origin\r\n"
+        "Sec-Fetch-Mode: navigate\r\n"
+        "Sec-Fetch-User: ?1\r\n"
+        "Sec-Fetch-Dest: document\r\n"
+        "Referer: https://www.example.com/\r\n"
+        "Accept-Encoding: gzip, deflate, br\r\n"
+        "Accept-Language: ru-RU,ru;q=0.9,en-US;q=0.8,en;q=0.7\r\n"
+        "Cookie: yandexuid=1234567890123456789; i=AbCdEfGhIjKlMnOpQrStUvWxYz0123456789AbCdEfGhIjKlMnOpQrStUvWxYz==; "
+        "my=YwA=; gdpr=0; _ym_uid=1638000000123456789; _ym_d=1638000000; yp=1953360000.yrtsi.1638000000\r\n"
+        "\r\n",
+
+        "POST /api/v1/events HTTP/1.1\r\n"
+        "Host: api.example.com\r\n"
+        "User-Agent: python-requests/2.26.0\r\n"
+        "Accept-Encoding: gzip, deflate\r\n"
+        "Accept: */*\r\n"
+        "Connection: keep-alive\r\n"
+        "Content-Type: application/json\r\n"
+        "Content-Length: 1024\r\n"
+        "\r\n",
+
+        "GET /static/js/main.4f3a2b1c.chunk.js HTTP/1.1\r\n"
+        "Host: static.example.net\r\n"
+        "Connection: keep-alive\r\n"
+        "sec-ch-ua: \" Not A;Brand\";v=\"99\", \"Chromium\";v=\"96\", \"Google Chrome\";v=\"96\"\r\n"
+        "sec-ch-ua-mobile: ?0\r\n"
+        "User-Agent: Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/96.0.4664.110 Safari/537.36\r\n"
+        "sec-ch-ua-platform: \"Windows\"\r\n"
+        "Accept: */*\r\n"
+        "Sec-Fetch-Site: cross-site\r\n"
+        "Sec-Fetch-Mode: no-cors\r\n"
+        "Sec-Fetch-Dest: script\r\n"
+        "Referer: https://www.example.com/\r\n"
+        "Accept-Encoding: gzip, deflate, br\r\n"
+        "Accept-Language: en-US,en;q=0.9\r\n"
+        "If-None-Match: \"5f3a2b1c-1a2b3\"\r\n"
+        "If-Modified-Since: Mon, 13 Dec 2021 10:00:00 GMT\r\n"
+        "\r\n",
+
+        "GET /ping HTTP/1.1\r\n"
+        "Host: 127.0.0.1:8080\r\n"
+        "\r\n",
+    };
+
+    struct THeads: public TVector<TString> {
+        inline THeads() {
+            for (const char* head : RawHeads) {
+                push_back(head);
+            }
+        }
+    };
+
+    constexpr size_t SplitSize = 256;
+
+    template <class TParse>
+    inline void ParseHeads(const NBench::NCpu::TParams& iface, TParse&& parse) {
+        const THeads& heads = *Singleton<THeads>();
+
+        for (size_t i = 0; i < iface.Iterations(); ++i) {
+            for (const TString& head : heads) {
+                Y_DO_NOT_OPTIMIZE_AWAY(parse(head));
+            }
+        }
+    }
+}
+
+Y_CPU_BENCHMARK(HttpParserWhole, iface) {
+    ParseHeads(iface, [](const TString& head) {
+        THttpParser parser(THttpParser::Request);
+        parser.Parse(head.data(), head.size());
+        return parser.Headers().Count();
+    });
+}
+
+Y_CPU_BENCHMARK(HttpHeadParserWhole, iface) {
+    ParseHeads(iface, [](const TString& head) {
+        THttpHeadParser parser(THttpParser::Request);
+        parser.Parse(head);
+        return parser.HeadersCount();
+    });
+}
+
+Y_CPU_BENCHMARK(HttpParserSplit, iface) {
+    ParseHeads(iface, [](const TString& head) {
+        THttpParser parser(THttpParser::Request);
+        for (size_t pos = 0; pos < head.size(); pos += SplitSize) {
+            if (parser.Parse(head.data() + pos, Min(SplitSize, head.size() - pos))) {
+                break;
+            }
+        }
+        return parser.Headers().Count();
+    });
+}
+
+Y_CPU_BENCHMARK(HttpHeadParserSplit, iface) {
+    ParseHeads(iface, [](const TString& head) {
+        THttpHeadParser parser(THttpParser::Request);
+        for (size_t pos = SplitSize; !parser.Parse(TStringBuf(head).Head(pos)); pos += SplitSize) {
+        }
+        return parser.HeadersCount();
+    });
+}
+
+Y_CPU_BENCHMARK(HttpHeadParserFindHost, iface) {
+    ParseHeads(iface, [](const TString& head) {
+        THttpHeadParser parser(THttpParser::Request);
+        parser.Parse(head);
+        return parser.FindHeader(TStringBuf("host")).GetOrElse(TStringBuf()).size();
+    });
+}
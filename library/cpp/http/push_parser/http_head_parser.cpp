@@ -0,0 +1,228 @@
+#include "http_head_parser.h"
+
+#include <util/generic/bitops.h>
+#include <util/string/ascii.h>
+#include <util/string/cast.h>
+#include <util/string/strip.h>
+#include <util/system/cpu_id.h>
+
+#if defined(_sse2_)
+#include <emmintrin.h>
+#endif
+
+#if defined(_x86_64_) || defined(_i386_)
+namespace NHttpPrivate {
+    const char* FindCharAvx2(const char* begin, const char* end, char c) noexcept;
+}
+#endif
+
+namespace {
+    const char* FindCharSse2(const char* begin, const char* end, char c) noexcept {
+#if defined(_sse2_)
+        const __m128i pattern = _mm_set1_epi8(c);
+        for (; end - begin >= 16; begin += 16) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+            const ui32 mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, pattern));
+            if (mask) {
+                return begin + CountTrailingZeroBits(mask);
+            }
+        }
+#endif
+        for (; begin != end; ++begin) {
+            if (*begin == c) {
+                return begin;
+            }
+        }
+        return nullptr;
+    }
+
+    using TFindChar = const char* (*)(const char*, const char*, char) noexcept;
+
+    TFindChar ChooseFindChar() noexcept {
+#if defined(_x86_64_) || defined(_i386_)
+        if (NX86::CachedHaveAVX() && NX86::CachedHaveAVX2()) {
+            return NHttpPrivate::FindCharAvx2;
+        }
+#endif
+        return FindCharSse2;
+    }
+
+    inline bool IsSpace(char c) noexcept {
+        return c == ' ' || c == '\t';
+    }
+
+    inline void StripSpaces(const char*& b, const char*& e) noexcept {
+        while (b != e && IsSpace(*b)) {
+            ++b;
+        }
+        while (b != e && IsSpace(e[-1])) {
+            --e;
+        }
+    }
+}
+
+const char* NHttpPrivate::FindChar(const char* begin, const char* end, char c) noexcept {
+    static const TFindChar findChar = ChooseFindChar();
+    return findChar(begin, end, c);
+}
+
+bool THttpHeadParser::Parse(TStringBuf data) {
+    if (HeadSize_) {
+        return true;
+    }
+
+    Data_ = data;
+    // the head including its last LF must fit into MaxHeadSize_ bytes
+    const char* scanEnd = Data_.data() + Min(Data_.size(), MaxHeadSize_);
+
+    while (true) {
+        const char* lineBegin = Data_.data() + Pos_;
+        const char* lf = NHttpPrivate::FindChar(Data_.data() + ScanPos_, scanEnd, '\n');
+        if (!lf) {
+            Y_ENSURE_EX(Data_.size() < MaxHeadSize_, THttpParseException() << "http head exceeds " << MaxHeadSize_ << " bytes");
+            //input line not completed
+            ScanPos_ = Data_.size();
+            return false;
+        }
+
+        const char* lineEnd = lf;
+        if (lineEnd != lineBegin && lineEnd[-1] == '\r') {
+            --lineEnd;
+        }
+        Pos_ = ScanPos_ = lf + 1 - Data_.data();
+
+        if (Y_UNLIKELY(!FirstLineParsed_)) {
+            ParseFirstLine(lineBegin, lineEnd);
+        } else if (lineBegin == lineEnd) {
+            //end of headers
+            HeadSize_ = Pos_;
+            return true;
+        } else {
+            ParseHeaderLine(lineBegin, lineEnd);
+        }
+    }
+}
+
+void THttpHeadParser::Reset() noexcept {
+    Data_ = {};
+    Pos_ = ScanPos_ = HeadSize_ = LineEnd_ = 0;
+    FirstLineParsed_ = false;
+    FirstLine_ = Method_ = RequestUri_ = {};
+    RetCode_ = 0;
+    HttpVersion_ = {};
+    Headers_.clear();
+    Folded_.clear();
+    KeepAlive_ = HasContentLength_ = Chunked_ = false;
+    ContentLength_ = 0;
+}
+
+TMaybe<TStringBuf> THttpHeadParser::FindHeader(TStringBuf name) const noexcept {
+    for (const auto& header : Headers_) {
+        if (AsciiEqualsIgnoreCase(View(header.Name), name)) {
+            return Value(header);
+        }
+    }
+    return Nothing();
+}
+
+void THttpHeadParser::ParseFirstLine(const char* b, const char* e) {
+    FirstLine_ = Range(b, e);
+    FirstLineParsed_ = true;
+
+    const TStringBuf line(b, e);
+    try {
+        TStringBuf httpVersion;
+        if (MessageType_ == THttpParser::Response) {
+            // Status-Line = HTTP-Version SP Status-Code SP Reason-Phrase CRLF
+            TStringBuf statusCode;
+            TStringBuf rest = line;
+            httpVersion = rest.NextTok(' ');
+            statusCode = rest.NextTok(' ');
+            RetCode_ = FromString<unsigned>(statusCode);
+        } else {
+            // Request-Line   = Method SP Request-URI SP HTTP-Version CRLF
+            TStringBuf method, uri;
+            line.Split(' ', method, uri);
+            uri.RSplit(' ', uri, httpVersion);
+            Method_ = Range(method.begin(), method.end());
+            RequestUri_ = Range(uri.begin(), uri.end());
+        }
+
+        if (!httpVersion.SkipPrefix("HTTP/")) {
+            throw yexception() << "expect 'HTTP/'";
+        }
+        TStringBuf major, minor;
+        httpVersion.Split('.', major, minor);
+        HttpVersion_.Major = FromString<unsigned>(major);
+        HttpVersion_.Minor = FromString<unsigned>(minor);
+        // since HTTP/1.1 Keep-Alive is default behaviour
+        KeepAlive_ = HttpVersion_.Major > 1 || HttpVersion_.Minor > 0;
+    } catch (...) {
+        throw THttpParseException() << "Cannot parse first line: " << CurrentExceptionMessage() << " First 80 chars of line: " << TString(line.Head(80)).Quote();
+    }
+}
+
+void THttpHeadParser::ParseHeaderLine(const char* b, const char* e) {
+    if (IsSpace(*b)) {
+        //obsolete line folding, the continuation line without CRLF is appended to the value as THttpParser does
+        if (Y_UNLIKELY(Headers_.empty())) {
+            ythrow THttpParseException() << "can not parse http header(" << TString(b, e).Quote() << ")";
+        }
+        THeaderRanges& header = Headers_.back();
+        if (!header.Value.Size) {
+            const char* valueBegin = b;
+            const char* valueEnd = e;
+            StripSpaces(valueBegin, valueEnd);
+            if (valueBegin == valueEnd) {
+                return;
+            }
+            header.Value = Range(valueBegin, valueEnd);
+        } else {
+            //inner spaces are kept, trailing ones are stripped from the whole value
+            if (!header.Folded) {
+                const TStringBuf value(Data_.data() + header.Value.Begin, Data_.data() + LineEnd_);
+                header.Value.Begin = Folded_.size();
+                Folded_.append(value);
+                header.Folded = true;
+            }
+            Folded_.append(b, e);
+            const char* valueBegin = Folded_.data() + header.Value.Begin;
+            const char* valueEnd = Folded_.data() + Folded_.size();
+            while (valueEnd != valueBegin && IsSpace(valueEnd[-1])) {
+                --valueEnd;
+            }
+            header.Value.Size = valueEnd - valueBegin;
+        }
+        LineEnd_ = e - Data_.data();
+        ApplyHeader(View(header.Name), Value(header));
+        return;
+    }
+
+    const char* colon = NHttpPrivate::FindChar(b, e, ':');
+    if (Y_UNLIKELY(!colon)) {
+        ythrow THttpParseException() << "can not parse http header(" << TString(b, e).Quote() << ")";
+    }
+
+    const char* nameBegin = b;
+    const char* nameEnd = colon;
+    const char* valueBegin = colon + 1;
+    const char* valueEnd = e;
+    StripSpaces(nameBegin, nameEnd);
+    StripSpaces(valueBegin, valueEnd);
+
+    Headers_.push_back({Range(nameBegin, nameEnd), Range(valueBegin, valueEnd)});
+    LineEnd_ = e - Data_.data();
+    ApplyHeader(TStringBuf(nameBegin, nameEnd), TStringBuf(valueBegin, valueEnd));
+}
+
+void THttpHeadParser::ApplyHeader(TStringBuf name, TStringBuf value) {
+    if (AsciiEqualsIgnoreCase(name, TStringBuf("connection"))) {
+        KeepAlive_ = AsciiEqualsIgnoreCase(value, TStringBuf("keep-alive"));
+    } else if (AsciiEqualsIgnoreCase(name, TStringBuf("content-length"))) {
+        Y_ENSURE_EX(value.size(), THttpParseException() << "Content-Length cannot be empty string");
+        ContentLength_ = FromString<ui64>(value);
+        HasContentLength_ = true;
+    } else if (AsciiEqualsIgnoreCase(name, TStringBuf("transfer-encoding"))) {
+        Chunked_ = AsciiEqualsIgnoreCase(value, TStringBuf("chunked"));
+    }
+}
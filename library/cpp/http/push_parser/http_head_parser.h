@@ -0,0 +1,149 @@
+#pragma once
+
+#include "http_parser.h"
+
+#include <library/cpp/containers/stack_vector/stack_vec.h>
+
+#include <util/generic/maybe.h>
+#include <util/generic/strbuf.h>
+
+//zero-copy incremental parser of http message head (first line + headers)
+//usage: append received bytes to a buffer and call Parse() with the whole buffer every time,
+//if returned 'true' - head parsed, body starts at HeadSize().
+//parsed headers are views into the last passed buffer, nothing is copied,
+//so the buffer may be reallocated between calls but must stay alive while views are used.
+//the only exception is obsolete line folding: folded values are unfolded into an internal buffer.
+class THttpHeadParser {
+public:
+    struct THeader {
+        TStringBuf Name;
+        TStringBuf Value;
+    };
+
+    // no limit besides the 32-bit offsets of the parsed ranges, servers set their own limit
+    static constexpr size_t DefaultMaxHeadSize = Max<ui32>();
+
+    THttpHeadParser(THttpParser::TMessageType mt = THttpParser::Request, size_t maxHeadSize = DefaultMaxHeadSize)
+        : MessageType_(mt)
+        , MaxHeadSize_(Min<size_t>(maxHeadSize, Max<ui32>()))
+    {
+    }
+
+    /// @return true on end of head
+    /// throw THttpParseException on bad http format or if the head is longer than maxHeadSize
+    bool Parse(TStringBuf data);
+
+    void Reset() noexcept;
+
+    size_t HeadSize() const noexcept {
+        return HeadSize_;
+    }
+
+    TStringBuf FirstLine() const noexcept {
+        return View(FirstLine_);
+    }
+
+    // request only
+    TStringBuf Method() const noexcept {
+        return View(Method_);
+    }
+
+    // request only
+    TStringBuf RequestUri() const noexcept {
+        return View(RequestUri_);
+    }
+
+    // response only
+    unsigned RetCode() const noexcept {
+        return RetCode_;
+    }
+
+    const THttpVersion& HttpVersion() const noexcept {
+        return HttpVersion_;
+    }
+
+    size_t HeadersCount() const noexcept {
+        return Headers_.size();
+    }
+
+    THeader Header(size_t i) const noexcept {
+        return {View(Headers_[i].Name), Value(Headers_[i])};
+    }
+
+    /// first header with the name (case insensitive)
+    TMaybe<TStringBuf> FindHeader(TStringBuf name) const noexcept;
+
+    bool IsKeepAlive() const noexcept {
+        return KeepAlive_;
+    }
+
+    bool GetContentLength(ui64& value) const noexcept {
+        if (!HasContentLength_) {
+            return false;
+        }
+
+        value = ContentLength_;
+        return true;
+    }
+
+    bool IsChunked() const noexcept {
+        return Chunked_;
+    }
+
+private:
+    struct TRange {
+        ui32 Begin = 0;
+        ui32 Size = 0;
+    };
+
+    struct THeaderRanges {
+        TRange Name;
+        TRange Value;
+        bool Folded = false; // Value points into Folded_
+    };
+
+    TStringBuf View(TRange r) const noexcept {
+        return TStringBuf(Data_.data() + r.Begin, r.Size);
+    }
+
+    TStringBuf Value(const THeaderRanges& header) const noexcept {
+        return header.Folded ? TStringBuf(Folded_.data() + header.Value.Begin, header.Value.Size) : View(header.Value);
+    }
+
+    TRange Range(const char* b, const char* e) const noexcept {
+        return {static_cast<ui32>(b - Data_.data()), static_cast<ui32>(e - b)};
+    }
+
+    void ParseFirstLine(const char* b, const char* e);
+    void ParseHeaderLine(const char* b, const char* e);
+    void ApplyHeader(TStringBuf name, TStringBuf value);
+
+private:
+    const THttpParser::TMessageType MessageType_;
+    const size_t MaxHeadSize_;
+
+    TStringBuf Data_;
+    size_t Pos_ = 0;     // begin of the first not parsed line
+    size_t ScanPos_ = 0; // bytes of the current line already checked for LF
+    size_t HeadSize_ = 0;
+    bool FirstLineParsed_ = false;
+
+    TRange FirstLine_;
+    TRange Method_;
+    TRange RequestUri_;
+    unsigned RetCode_ = 0;
+    THttpVersion HttpVersion_;
+    TStackVec<THeaderRanges, 32> Headers_;
+    size_t LineEnd_ = 0; // end of the last header line, the value may be continued by folding
+    TString Folded_;
+
+    bool KeepAlive_ = false;
+    bool HasContentLength_ = false;
+    ui64 ContentLength_ = 0;
+    bool Chunked_ = false;
+};
+
+namespace NHttpPrivate {
+    // memchr analogue, vectorized with SSE2/AVX2 chosen at runtime
+    const char* FindChar(const char* begin, const char* end, char c) noexcept;
+}
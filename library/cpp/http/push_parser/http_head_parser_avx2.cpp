@@ -0,0 +1,22 @@
+#include <util/generic/bitops.h>
+
+#include <immintrin.h>
+
+namespace NHttpPrivate {
+    const char* FindCharAvx2(const char* begin, const char* end, char c) noexcept {
+        const __m256i pattern = _mm256_set1_epi8(c);
+        for (; end - begin >= 32; begin += 32) {
+            const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+            const ui32 mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, pattern));
+            if (mask) {
+                return begin + CountTrailingZeroBits(mask);
+            }
+        }
+        for (; begin != end; ++begin) {
+            if (*begin == c) {
+                return begin;
+            }
+        }
+        return nullptr;
+    }
+}
@@ -0,0 +1,133 @@
+#include "http_head_parser.h"
+
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <util/generic/string.h>
+
+namespace {
+    const TStringBuf Request =
+        "GET /yandsearch?text=test HTTP/1.1\r\n"
+        "Host: yandex.ru\r\n"
+        "User-Agent: Mozilla/5.0 (X11; Linux x86_64)\r\n"
+        "Accept-Encoding:gzip, deflate\r\n"
+        "X-Folded: first\r\n"
+        "\t second\r\n"
+        "Connection:   close  \r\n"
+        "\r\n"
+        "extra";
+}
+
+Y_UNIT_TEST_SUITE(THttpHeadParser) {
+    void CheckRequest(const THttpHeadParser& p) {
+        UNIT_ASSERT_VALUES_EQUAL(p.HeadSize(), Request.size() - 5);
+        UNIT_ASSERT_VALUES_EQUAL(p.FirstLine(), "GET /yandsearch?text=test HTTP/1.1");
+        UNIT_ASSERT_VALUES_EQUAL(p.Method(), "GET");
+        UNIT_ASSERT_VALUES_EQUAL(p.RequestUri(), "/yandsearch?text=test");
+        UNIT_ASSERT_VALUES_EQUAL(p.HttpVersion().Major, 1);
+        UNIT_ASSERT_VALUES_EQUAL(p.HttpVersion().Minor, 1);
+        UNIT_ASSERT_VALUES_EQUAL(p.HeadersCount(), 5);
+        UNIT_ASSERT_VALUES_EQUAL(p.Header(0).Name, "Host");
+        UNIT_ASSERT_VALUES_EQUAL(p.Header(0).Value, "yandex.ru");
+        UNIT_ASSERT_VALUES_EQUAL(p.Header(2).Value, "gzip, deflate");
+        UNIT_ASSERT_VALUES_EQUAL(p.Header(3).Value, "first\t second");
+        UNIT_ASSERT_VALUES_EQUAL(*p.FindHeader("user-agent"), "Mozilla/5.0 (X11; Linux x86_64)");
+        UNIT_ASSERT_VALUES_EQUAL(*p.FindHeader("CONNECTION"), "close");
+        UNIT_ASSERT(!p.FindHeader("Content-Length"));
+        UNIT_ASSERT(!p.IsKeepAlive());
+        UNIT_ASSERT(!p.IsChunked());
+    }
+
+    Y_UNIT_TEST(TWhole) {
+        THttpHeadParser p;
+        UNIT_ASSERT(p.Parse(Request));
+        CheckRequest(p);
+    }
+
+    Y_UNIT_TEST(TByteByByte) {
+        THttpHeadParser p;
+        TString buf;
+        for (size_t i = 0; i + 5 < Request.size(); ++i) {
+            UNIT_ASSERT(!p.Parse(buf));
+            // views must survive buffer reallocation
+            buf = TString(buf.data(), buf.size()) + Request[i];
+        }
+        UNIT_ASSERT(p.Parse(buf));
+        CheckRequest(p);
+
+        p.Reset();
+        UNIT_ASSERT(p.Parse(Request));
+        CheckRequest(p);
+    }
+
+    Y_UNIT_TEST(TResponse) {
+        THttpHeadParser p(THttpParser::Response);
+        UNIT_ASSERT(!p.Parse("HTTP/1.0 404 Not found\r\nContent-Length: 10\r\n"));
+        UNIT_ASSERT(p.Parse("HTTP/1.0 404 Not found\r\nContent-Length: 10\r\nTransfer-Encoding: chunked\r\nConnection: Keep-Alive\r\n\r\n"));
+        UNIT_ASSERT_VALUES_EQUAL(p.RetCode(), 404);
+        UNIT_ASSERT_VALUES_EQUAL(p.HttpVersion().Minor, 0);
+        ui64 length = 0;
+        UNIT_ASSERT(p.GetContentLength(length));
+        UNIT_ASSERT_VALUES_EQUAL(length, 10);
+        UNIT_ASSERT(p.IsChunked());
+        UNIT_ASSERT(p.IsKeepAlive());
+    }
+
+    Y_UNIT_TEST(TBadHeaders) {
+        {
+            THttpHeadParser p;
+            UNIT_ASSERT_EXCEPTION(p.Parse("GET / HTTP/1.1\r\nNoColon\r\n\r\n"), THttpParseException);
+        }
+        {
+            THttpHeadParser p;
+            UNIT_ASSERT_EXCEPTION(p.Parse("GET / HTTP/1.1\r\n folded\r\n\r\n"), THttpParseException);
+        }
+        {
+            THttpHeadParser p;
+            UNIT_ASSERT_EXCEPTION(p.Parse("GET / XTTP/1.1\r\n\r\n"), THttpParseException);
+        }
+    }
+
+    Y_UNIT_TEST(TFolding) {
+        THttpHeadParser p;
+        UNIT_ASSERT(p.Parse("GET / HTTP/1.1\r\nX-Empty:\r\n  value \r\nX-Long: a, \r\n b\r\n  \r\n\tc \r\nConnection: close\r\n\r\n"));
+        UNIT_ASSERT_VALUES_EQUAL(p.Header(0).Value, "value");
+        UNIT_ASSERT_VALUES_EQUAL(p.Header(1).Value, "a,  b  \tc");
+        UNIT_ASSERT_VALUES_EQUAL(*p.FindHeader("x-long"), "a,  b  \tc");
+        UNIT_ASSERT_VALUES_EQUAL(p.Header(2).Value, "close");
+    }
+
+    Y_UNIT_TEST(TMaxHeadSize) {
+        const TStringBuf head = "GET / HTTP/1.1\r\nHost: yandex.ru\r\n\r\n";
+        {
+            THttpHeadParser p(THttpParser::Request, head.size());
+            UNIT_ASSERT(p.Parse(head));
+        }
+        {
+            THttpHeadParser p(THttpParser::Request, head.size() - 1);
+            UNIT_ASSERT(!p.Parse(head.Head(10)));
+            UNIT_ASSERT_EXCEPTION(p.Parse(head), THttpParseException);
+        }
+        {
+            THttpHeadParser p(THttpParser::Request, 16);
+            UNIT_ASSERT_EXCEPTION(p.Parse(TString(100, 'a')), THttpParseException);
+        }
+        {
+            const TString longHead = TString("GET / HTTP/1.1\r\nX-Long: ") + TString(1 << 20, 'a') + "\r\n\r\n";
+            THttpHeadParser p;
+            UNIT_ASSERT(p.Parse(longHead));
+            UNIT_ASSERT_VALUES_EQUAL(p.HeadSize(), longHead.size());
+        }
+    }
+
+    Y_UNIT_TEST(TFindChar) {
+        TString s(100, 'a');
+        for (size_t i = 0; i < s.size(); ++i) {
+            s[i] = ':';
+            for (size_t begin = 0; begin <= i; begin += 7) {
+                UNIT_ASSERT_EQUAL(NHttpPrivate::FindChar(s.data() + begin, s.data() + s.size(), ':'), s.data() + i);
+                UNIT_ASSERT_EQUAL(NHttpPrivate::FindChar(s.data() + begin, s.data() + i, ':'), nullptr);
+            }
+            s[i] = 'a';
+        }
+    }
+}
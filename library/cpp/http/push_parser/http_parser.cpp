@@ -1,4 +1,5 @@
 #include "http_parser.h"
+#include "http_head_parser.h"
 
 #include <library/cpp/blockcodecs/stream.h>
 #include <library/cpp/blockcodecs/codecs.h>
@@ -8,8 +9,6 @@
 #include <util/stream/mem.h>
 #include <util/stream/zlib.h>
 #include <util/string/ascii.h>
-#include <util/string/split.h>
-#include <util/string/strip.h>
 
 //#define DBGOUT(args) Cout << args << Endl;
 #define DBGOUT(args)
@@ -43,66 +42,49 @@ TString THttpParser::GetBestCompressionScheme() const {
     return TString();
 }
 
-bool THttpParser::FirstLineParser() {
-    if (Y_UNLIKELY(!ReadLine())) {
-        return false;
+THttpParser::THttpParser(TMessageType mt)
+    : Parser_(&THttpParser::HeadParser)
+    , MessageType_(mt)
+    , MaxHeadSize_(THttpHeadParser::DefaultMaxHeadSize)
+{
+}
+
+THttpParser::~THttpParser() = default;
+
+bool THttpParser::HeadParser() {
+    if (!HeadParser_) {
+        HeadParser_ = MakeHolder<THttpHeadParser>(MessageType_, MaxHeadSize_);
     }
 
-    CurrentLine_.swap(FirstLine_);
-
-    try {
-        TStringBuf s(FirstLine_);
-        if (MessageType_ == Response) {
-            // Status-Line = HTTP-Version SP Status-Code SP Reason-Phrase CRLF
-            TStringBuf httpVersion, statusCode;
-            GetNext(s, ' ', httpVersion);
-            ParseHttpVersion(httpVersion);
-            GetNext(s, ' ', statusCode);
-            RetCode_ = FromString<unsigned>(statusCode);
-        } else {
-            // Request-Line   = Method SP Request-URI SP HTTP-Version CRLF
-            TStringBuf httpVersion = s.After(' ').After(' ');
-            ParseHttpVersion(httpVersion);
+    //head received in one piece is parsed in place, otherwise it is collected in HeadBuffer_
+    const size_t buffered = HeadBuffer_.size();
+    if (buffered) {
+        HeadBuffer_.append(Data_, DataEnd_);
+    }
+    if (!HeadParser_->Parse(buffered ? TStringBuf(HeadBuffer_) : TStringBuf(Data_, DataEnd_))) {
+        if (!buffered) {
+            HeadBuffer_.append(Data_, DataEnd_);
         }
-    } catch (...) {
-        throw THttpParseException() << "Cannot parse first line: " << CurrentExceptionMessage() << " First 80 chars of line: " << FirstLine_.substr(0, Min<size_t>(80ull, FirstLine_.size())).Quote();
+        Parser_ = &THttpParser::HeadParser;
+        return false;
     }
 
-    return HeadersParser();
-}
-
-bool THttpParser::HeadersParser() {
-    while (ReadLine()) {
-        if (!CurrentLine_) {
-            //end of headers
-            DBGOUT("end of headers()");
-            ParseHeaderLine();
-
-            if (HasContentLength_) {
-                if (ContentLength_ == 0) {
-                    return OnEndParsing();
-                }
-
-                if (ContentLength_ < 1000000) {
-                    Content_.reserve(ContentLength_ + 1);
-                }
-            }
+    DBGOUT("end of headers()");
+    Data_ += HeadParser_->HeadSize() - buffered;
+    OnHeadParsed();
+    HeadBuffer_.clear();
 
-            return !!ChunkInputState_ ? ChunkedContentParser() : ContentParser();
+    if (HasContentLength_) {
+        if (ContentLength_ == 0) {
+            return OnEndParsing();
         }
 
-        if (CurrentLine_[0] == ' ' || CurrentLine_[0] == '\t') {
-            //continue previous header-line
-            HeaderLine_ += CurrentLine_;
-            CurrentLine_.remove(0);
-        } else {
-            ParseHeaderLine();
-            HeaderLine_.swap(CurrentLine_);
+        if (ContentLength_ < 1000000) {
+            Content_.reserve(ContentLength_ + 1);
         }
     }
 
-    Parser_ = &THttpParser::HeadersParser;
-    return false;
+    return !!ChunkInputState_ ? ChunkedContentParser() : ContentParser();
 }
 
 bool THttpParser::ContentParser() {
@@ -212,44 +194,20 @@ bool THttpParser::ReadLine() {
     return true;
 }
 
-void THttpParser::ParseHttpVersion(TStringBuf httpVersion) {
-    if (!httpVersion.StartsWith("HTTP/", 5)) {
-        throw yexception() << "expect 'HTTP/'";
-    }
-    httpVersion.Skip(5);
-    {
-        TStringBuf major, minor;
-        Split(httpVersion, '.', major, minor);
-        HttpVersion_.Major = FromString<unsigned>(major);
-        HttpVersion_.Minor = FromString<unsigned>(minor);
-        if (Y_LIKELY(HttpVersion_.Major > 1 || HttpVersion_.Minor > 0)) {
-            // since HTTP/1.1 Keep-Alive is default behaviour
-            KeepAlive_ = true;
-        }
-    }
-}
+void THttpParser::OnHeadParsed() {
+    const THttpHeadParser& head = *HeadParser_;
+    FirstLine_ = head.FirstLine();
+    HttpVersion_ = head.HttpVersion();
+    RetCode_ = head.RetCode();
+    // since HTTP/1.1 Keep-Alive is default behaviour
+    KeepAlive_ = HttpVersion_.Major > 1 || HttpVersion_.Minor > 0;
 
-void THttpParser::ParseHeaderLine() {
-    if (!!HeaderLine_) {
+    for (size_t i = 0; i < head.HeadersCount(); ++i) {
+        const THttpHeadParser::THeader header = head.Header(i);
         if (CollectHeaders_) {
-            THttpInputHeader hdr(HeaderLine_);
-
-            Headers_.AddHeader(hdr);
-
-            ApplyHeaderLine(hdr.Name(), hdr.Value());
-        } else {
-            //some dirty optimization (avoid reallocation new strings)
-            size_t pos = HeaderLine_.find(':');
-
-            if (pos == TString::npos) {
-                ythrow THttpParseException() << "can not parse http header(" << HeaderLine_.Quote() << ")";
-            }
-
-            TStringBuf name(StripString(TStringBuf(HeaderLine_.begin(), HeaderLine_.begin() + pos)));
-            TStringBuf val(StripString(TStringBuf(HeaderLine_.begin() + pos + 1, HeaderLine_.end())));
-            ApplyHeaderLine(name, val);
+            Headers_.AddHeader(THttpInputHeader(TString(header.Name), TString(header.Value)));
         }
-        HeaderLine_.remove(0);
+        ApplyHeaderLine(header.Name, header.Value);
     }
 }
 
@@ -7,6 +7,8 @@
 #include <util/string/cast.h>
 #include <library/cpp/http/io/stream.h>
 
+class THttpHeadParser;
+
 struct THttpVersion {
     unsigned Major = 1;
     unsigned Minor = 0;
@@ -22,16 +24,18 @@ public:
         Response
     };
 
-    THttpParser(TMessageType mt = Response)
-        : Parser_(&THttpParser::FirstLineParser)
-        , MessageType_(mt)
-    {
-    }
+    THttpParser(TMessageType mt = Response);
+    ~THttpParser();
 
     inline void DisableCollectingHeaders() noexcept {
         CollectHeaders_ = false;
     }
 
+    /// longer message head is a parse error, there is no limit by default
+    inline void SetMaxHeadSize(size_t size) noexcept {
+        MaxHeadSize_ = size;
+    }
+
     /// @return true on end parsing (GetExtraDataSize() return amount not used bytes)
     /// throw exception on bad http format (unsupported encoding, etc)
     /// sz == 0 signaling end of input stream
@@ -90,7 +94,6 @@ public:
     }
 
     void Prepare() {
-        HeaderLine_.reserve(128);
         FirstLine_.reserve(128);
     }
 
@@ -105,8 +108,7 @@ private:
         return (this->*Parser_)();
     }
     // stage parsers
-    bool FirstLineParser();
-    bool HeadersParser();
+    bool HeadParser();
     bool ContentParser();
     bool ChunkedContentParser();
     bool OnEndParsing();
@@ -114,8 +116,7 @@ private:
     // continue read to CurrentLine_
     bool ReadLine();
 
-    void ParseHttpVersion(TStringBuf httpVersion);
-    void ParseHeaderLine();
+    void OnHeadParsed();
 
     void OnEof();
     bool DecodeContent();
@@ -127,12 +128,14 @@ private:
     TParser Parser_; //current parser (stage)
     TMessageType MessageType_ = Response;
     bool CollectHeaders_ = true;
+    size_t MaxHeadSize_;
 
     // parsed data
     const char* Data_ = nullptr;
     const char* DataEnd_ = nullptr;
     TString CurrentLine_;
-    TString HeaderLine_;
+    THolder<THttpHeadParser> HeadParser_;
+    TString HeadBuffer_; // head split between several Parse() calls
 
     size_t ExtraDataSize_ = 0;
 
@@ -294,6 +294,18 @@ Y_UNIT_TEST_SUITE(THttpParser) {
         UNIT_ASSERT_VALUES_EQUAL((++it)->ToString(), TString("Host: any.com"));
     }
 
+    Y_UNIT_TEST(TParsingMaxHeadSize) {
+        THttpParser p;
+        p.SetMaxHeadSize(32);
+        UNIT_ASSERT(!Parse(p, "HTTP/1.1 200 OK\r\n"));
+        UNIT_ASSERT_EXCEPTION(Parse(p, "X-Long: 0123456789abcdef\r\n\r\n"), THttpParseException);
+
+        const TString longHead = TString("HTTP/1.1 200 OK\r\nX-Long: ") + TString(1 << 20, 'a') + "\r\nContent-Length: 0\r\n\r\n";
+        THttpParser p2;
+        UNIT_ASSERT(p2.Parse(longHead.data(), longHead.size()));
+        UNIT_ASSERT_VALUES_EQUAL(p2.Headers().FindHeader("X-Long")->Value().size(), 1u << 20);
+    }
+
     Y_UNIT_TEST(THttpIoStreamInteroperability) {
         TStringBuf content = "very very very long content";
 
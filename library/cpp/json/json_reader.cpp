@@ -9,6 +9,7 @@
 #include <contrib/libs/rapidjson/include/rapidjson/stringbuffer.h>
 #include <contrib/libs/rapidjson/include/rapidjson/writer.h>
 
+#include <util/charset/utf8.h>
 #include <util/generic/stack.h>
 #include <util/string/cast.h>
 #include <util/system/yassert.h>
@@ -379,6 +380,15 @@ namespace NJson {
         template <class TData>
         bool ReadJsonTreeImpl(TData* in, const TJsonReaderConfig* config, TJsonValue* out, bool throwOnError) {
             std::conditional_t<std::is_same<TData, TStringBuf>::value, TStringBufStreamWrapper, TInputStreamWrapper> is(*in);
+            if constexpr (std::is_same<TData, TStringBuf>::value) {
+                // the whole input is validated at once with SIMD, so strings are just copied by the parser;
+                // invalid input is parsed with validation to report the same error
+                if (!config->DontValidateUtf8 && IsWellFormedUTF8(*in)) {
+                    TJsonReaderConfig validatedConfig = *config;
+                    validatedConfig.DontValidateUtf8 = true;
+                    return ReadJsonTree(is, &validatedConfig, out, throwOnError);
+                }
+            }
             return ReadJsonTree(is, config, out, throwOnError);
         }
 
@@ -372,6 +372,27 @@ Y_UNIT_TEST_SUITE(TJsonReaderTest) {
         }
     }
 
+    Y_UNIT_TEST(TJsonUtf8ValidationTest) {
+        const TString text = TString("\xD0\xBF\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82 \xE4\xB8\xAD\xE6\x96\x87 \xF0\x9F\x98\x80 ") * 4;
+        {
+            TJsonValue value;
+            UNIT_ASSERT(ReadJsonTree(TStringBuf("{\"test\":\"" + text + "\"}"), &value));
+            UNIT_ASSERT_VALUES_EQUAL(value["test"].GetString(), text);
+        }
+
+        for (const TStringBuf invalid : {TStringBuf("\xC0\x80"), TStringBuf("\xED\xA0\x80"), TStringBuf("\xF4\x90\x80\x80"), TStringBuf("\xE4\xB8")}) {
+            const TString json = "{\"test\":\"" + text + invalid + "\"}";
+            TJsonValue value;
+            UNIT_ASSERT(!ReadJsonTree(TStringBuf(json), &value));
+            TStringInput in(json);
+            UNIT_ASSERT(!ReadJsonTree(&in, &value));
+
+            TJsonReaderConfig config;
+            config.DontValidateUtf8 = true;
+            UNIT_ASSERT(ReadJsonTree(TStringBuf(json), &config, &value));
+        }
+    }
+
     Y_UNIT_TEST(TJsonMemoryLeakTest) {
         // after https://clubs.at.yandex-team.ru/stackoverflow/3691
         TString s = ".";
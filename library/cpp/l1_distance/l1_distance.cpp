@@ -1 +1,279 @@
 #include "l1_distance.h"
+#include "l1_distance_simd.h"
+
+#include <util/generic/utility.h>
+#include <util/system/compiler.h>
+#include <util/system/cpu_id.h>
+
+#ifdef ARCADIA_SSE
+
+static ui32 L1DistanceSse(const i8* lhs, const i8* rhs, int length) {
+    static const __m128i unsignedToSignedDiff = _mm_set_epi8(
+        -128, -128, -128, -128, -128, -128, -128, -128,
+        -128, -128, -128, -128, -128, -128, -128, -128);
+    __m128i resVec = _mm_setzero_si128();
+
+    while (length >= 16) {
+        __m128i lVec = _mm_sub_epi8(_mm_loadu_si128((const __m128i*)lhs), unsignedToSignedDiff);
+        __m128i rVec = _mm_sub_epi8(_mm_loadu_si128((const __m128i*)rhs), unsignedToSignedDiff);
+
+        resVec = _mm_add_epi64(_mm_sad_epu8(lVec, rVec), resVec);
+
+        lhs += 16;
+        rhs += 16;
+        length -= 16;
+    }
+
+    alignas(16) i64 res[2];
+    _mm_store_si128((__m128i*)res, resVec);
+    ui32 sum = res[0] + res[1];
+    for (int i = 0; i < length; ++i) {
+        const i32 diff = static_cast<i32>(lhs[i]) - static_cast<i32>(rhs[i]);
+        sum += (diff >= 0) ? diff : -diff;
+    }
+
+    return sum;
+}
+
+static ui32 L1DistanceSse(const ui8* lhs, const ui8* rhs, int length) {
+    if (length == 96)
+        return NL1Distance::NPrivate::L1Distance96Ui8(lhs, rhs);
+
+    int l16 = length & (~15);
+    __m128i sum = _mm_setzero_si128();
+
+    if ((reinterpret_cast<uintptr_t>(lhs) & 0x0f) || (reinterpret_cast<uintptr_t>(rhs) & 0x0f)) {
+        for (int i = 0; i < l16; i += 16) {
+            __m128i a = _mm_loadu_si128((const __m128i*)(&lhs[i]));
+            __m128i b = _mm_loadu_si128((const __m128i*)(&rhs[i]));
+
+            sum = _mm_add_epi64(sum, _mm_sad_epu8(a, b));
+        }
+    } else {
+        for (int i = 0; i < l16; i += 16) {
+            __m128i sum_ab = _mm_sad_epu8(*(const __m128i*)(&lhs[i]), *(const __m128i*)(&rhs[i]));
+            sum = _mm_add_epi64(sum, sum_ab);
+        }
+    }
+
+    if (l16 == length)
+        return _mm_cvtsi128_si32(sum) + _mm_cvtsi128_si32(_mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 2, 2, 2)));
+
+    int l4 = length & (~3);
+    for (int i = l16; i < l4; i += 4) {
+        __m128i a = _mm_set_epi32(*((const ui32*)&lhs[i]), 0, 0, 0);
+        __m128i b = _mm_set_epi32(*((const ui32*)&rhs[i]), 0, 0, 0);
+        sum = _mm_add_epi64(sum, _mm_sad_epu8(a, b));
+    }
+
+    ui32 res = _mm_cvtsi128_si32(sum) + _mm_cvtsi128_si32(_mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 2, 2, 2)));
+
+    for (int i = l4; i < length; i++)
+        res += lhs[i] < rhs[i] ? rhs[i] - lhs[i] : lhs[i] - rhs[i];
+
+    return res;
+}
+
+static float L1DistanceSse(const float* lhs, const float* rhs, int length) {
+    __m128 res = _mm_setzero_ps();
+    __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+    while (length >= 4) {
+        __m128 a = _mm_loadu_ps(lhs);
+        __m128 b = _mm_loadu_ps(rhs);
+        __m128 d = _mm_sub_ps(a, b);
+        res = _mm_add_ps(_mm_and_ps(d, absMask), res);
+        rhs += 4;
+        lhs += 4;
+        length -= 4;
+    }
+
+    alignas(16) float r[4];
+    _mm_store_ps(r, res);
+    float sum = r[0] + r[1] + r[2] + r[3];
+
+    while (length) {
+        sum += std::abs(*lhs - *rhs);
+        ++lhs;
+        ++rhs;
+        --length;
+    }
+
+    return sum;
+}
+
+static double L1DistanceSse(const double* lhs, const double* rhs, int length) {
+    __m128d res = _mm_setzero_pd();
+    __m128d absMask = _mm_castsi128_pd(_mm_set_epi32(0x7fffffff, 0xffffffff, 0x7fffffff, 0xffffffff));
+
+    while (length >= 2) {
+        __m128d a = _mm_loadu_pd(lhs);
+        __m128d b = _mm_loadu_pd(rhs);
+        __m128d d = _mm_sub_pd(a, b);
+        res = _mm_add_pd(_mm_and_pd(d, absMask), res);
+        rhs += 2;
+        lhs += 2;
+        length -= 2;
+    }
+
+    alignas(16) double r[2];
+    _mm_store_pd(r, res);
+    double sum = r[0] + r[1];
+
+    while (length) {
+        sum += std::abs(*lhs - *rhs);
+        ++lhs;
+        ++rhs;
+        --length;
+    }
+
+    return sum;
+}
+
+#endif // ARCADIA_SSE
+
+namespace NL1DistanceImpl {
+    namespace {
+        // kernels of one query against 4 rows for instruction sets without a dedicated implementation
+        template <typename TResult, typename TNumber, TResult (*L1DistancePair)(const TNumber*, const TNumber*, int)>
+        void L1DistanceX4ByPairs(const TNumber* query, const TNumber* rows, int length, TResult* result) {
+            for (int k = 0; k < 4; ++k) {
+                result[k] = L1DistancePair(query, rows + k * length, length);
+            }
+        }
+
+#ifdef ARCADIA_SSE
+        constexpr TL1DistanceKernels BaselineKernels = {
+            "sse", L1DistanceSse, L1DistanceSse, L1DistanceSse, L1DistanceSse,
+            L1DistanceX4ByPairs<ui32, i8, L1DistanceSse>, L1DistanceX4ByPairs<ui32, ui8, L1DistanceSse>,
+            L1DistanceX4ByPairs<float, float, L1DistanceSse>, L1DistanceX4ByPairs<ui32, ui8, L1DistanceUI4>};
+#else
+        constexpr TL1DistanceKernels BaselineKernels = {
+            "slow", L1DistanceSlow, L1DistanceSlow, L1DistanceSlow, L1DistanceSlow,
+            L1DistanceX4ByPairs<ui32, i8, L1DistanceSlow>, L1DistanceX4ByPairs<ui32, ui8, L1DistanceSlow>,
+            L1DistanceX4ByPairs<float, float, L1DistanceSlow>, L1DistanceX4ByPairs<ui32, ui8, L1DistanceUI4>};
+#endif
+
+#if defined(_x86_64_)
+        constexpr TL1DistanceKernels Avx2Kernels = {
+            "avx2", NAvx2::L1Distance, NAvx2::L1Distance, NAvx2::L1Distance, NAvx2::L1Distance,
+            NAvx2::L1DistanceX4, NAvx2::L1DistanceX4, NAvx2::L1DistanceX4, NAvx2::L1DistanceUI4X4};
+
+        constexpr TL1DistanceKernels Avx512Kernels = {
+            "avx512", NAvx512::L1Distance, NAvx512::L1Distance, NAvx512::L1Distance, NAvx512::L1Distance,
+            NAvx512::L1DistanceX4, NAvx512::L1DistanceX4, NAvx512::L1DistanceX4, NAvx512::L1DistanceUI4X4};
+#endif
+
+        struct TSupportedKernels {
+            const TL1DistanceKernels* Kernels[3];
+            size_t Count = 0;
+
+            TSupportedKernels() noexcept {
+                Kernels[Count++] = &BaselineKernels;
+#if defined(_x86_64_)
+                if (NX86::CachedHaveAVX2()) {
+                    Kernels[Count++] = &Avx2Kernels;
+                }
+                if (NX86::CachedHaveAVX512F() && NX86::CachedHaveAVX512BW() && NX86::CachedHaveAVX512DQ() && NX86::CachedHaveAVX512VL()) {
+                    Kernels[Count++] = &Avx512Kernels;
+                }
+#endif
+            }
+        };
+    }
+
+    TArrayRef<const TL1DistanceKernels* const> GetSupportedKernels() noexcept {
+        static const TSupportedKernels supported;
+        return {supported.Kernels, supported.Count};
+    }
+
+    const TL1DistanceKernels& GetBestKernels() noexcept {
+        static const TL1DistanceKernels* const best = GetSupportedKernels().back();
+        return *best;
+    }
+}
+
+ui32 L1Distance(const i8* lhs, const i8* rhs, int length) {
+    return NL1DistanceImpl::GetBestKernels().L1DistanceI8(lhs, rhs, length);
+}
+
+ui32 L1Distance(const ui8* lhs, const ui8* rhs, int length) {
+    return NL1DistanceImpl::GetBestKernels().L1DistanceUi8(lhs, rhs, length);
+}
+
+float L1Distance(const float* lhs, const float* rhs, int length) {
+    return NL1DistanceImpl::GetBestKernels().L1DistanceFloat(lhs, rhs, length);
+}
+
+double L1Distance(const double* lhs, const double* rhs, int length) {
+    return NL1DistanceImpl::GetBestKernels().L1DistanceDouble(lhs, rhs, length);
+}
+
+namespace {
+    // rhs rows are processed by blocks of this size so that a block stays in cache for all lhs rows
+    constexpr size_t MatrixBlockBytes = 64 * 1024;
+
+    template <typename TResult, typename TNumber, typename TKernelX4, typename TKernel>
+    void L1DistanceBatchImpl(TKernelX4 kernelX4, TKernel kernel, const TNumber* query, const TNumber* rows, size_t rowCount, int length, TResult* result) {
+        size_t i = 0;
+        for (; i + 4 <= rowCount; i += 4) {
+            const TNumber* next = rows + (i + 4) * length;
+            for (size_t k = 0; k < 4 && i + 4 + k < rowCount; ++k) {
+                Y_PREFETCH_READ(next + k * length, 3);
+            }
+            kernelX4(query, rows + i * length, length, result + i);
+        }
+        for (; i < rowCount; ++i) {
+            result[i] = kernel(query, rows + i * length, length);
+        }
+    }
+
+    template <typename TResult, typename TNumber, typename TKernelX4, typename TKernel>
+    void L1DistanceMatrixImpl(TKernelX4 kernelX4, TKernel kernel, const TNumber* lhs, size_t lhsCount, const TNumber* rhs, size_t rhsCount, int length, TResult* result) {
+        const size_t blockRows = Max<size_t>(4, MatrixBlockBytes / Max<size_t>(1, length * sizeof(TNumber)) / 4 * 4);
+        for (size_t j = 0; j < rhsCount; j += blockRows) {
+            const size_t blockCount = Min(blockRows, rhsCount - j);
+            for (size_t i = 0; i < lhsCount; ++i) {
+                L1DistanceBatchImpl(kernelX4, kernel, lhs + i * length, rhs + j * length, blockCount, length, result + i * rhsCount + j);
+            }
+        }
+    }
+}
+
+void L1DistanceBatch(const i8* query, const i8* rows, size_t rowCount, int length, ui32* result) {
+    const auto& kernels = NL1DistanceImpl::GetBestKernels();
+    L1DistanceBatchImpl(kernels.L1DistanceX4I8, kernels.L1DistanceI8, query, rows, rowCount, length, result);
+}
+
+void L1DistanceBatch(const ui8* query, const ui8* rows, size_t rowCount, int length, ui32* result) {
+    const auto& kernels = NL1DistanceImpl::GetBestKernels();
+    L1DistanceBatchImpl(kernels.L1DistanceX4Ui8, kernels.L1DistanceUi8, query, rows, rowCount, length, result);
+}
+
+void L1DistanceBatch(const float* query, const float* rows, size_t rowCount, int length, float* result) {
+    const auto& kernels = NL1DistanceImpl::GetBestKernels();
+    L1DistanceBatchImpl(kernels.L1DistanceX4Float, kernels.L1DistanceFloat, query, rows, rowCount, length, result);
+}
+
+void L1DistanceUI4Batch(const ui8* query, const ui8* rows, size_t rowCount, int lengthInBytes, ui32* result) {
+    L1DistanceBatchImpl(NL1DistanceImpl::GetBestKernels().L1DistanceUI4X4, L1DistanceUI4, query, rows, rowCount, lengthInBytes, result);
+}
+
+void L1DistanceMatrix(const i8* lhs, size_t lhsCount, const i8* rhs, size_t rhsCount, int length, ui32* result) {
+    const auto& kernels = NL1DistanceImpl::GetBestKernels();
+    L1DistanceMatrixImpl(kernels.L1DistanceX4I8, kernels.L1DistanceI8, lhs, lhsCount, rhs, rhsCount, length, result);
+}
+
+void L1DistanceMatrix(const ui8* lhs, size_t lhsCount, const ui8* rhs, size_t rhsCount, int length, ui32* result) {
+    const auto& kernels = NL1DistanceImpl::GetBestKernels();
+    L1DistanceMatrixImpl(kernels.L1DistanceX4Ui8, kernels.L1DistanceUi8, lhs, lhsCount, rhs, rhsCount, length, result);
+}
+
+void L1DistanceMatrix(const float* lhs, size_t lhsCount, const float* rhs, size_t rhsCount, int length, float* result) {
+    const auto& kernels = NL1DistanceImpl::GetBestKernels();
+    L1DistanceMatrixImpl(kernels.L1DistanceX4Float, kernels.L1DistanceFloat, lhs, lhsCount, rhs, rhsCount, length, result);
+}
+
+void L1DistanceUI4Matrix(const ui8* lhs, size_t lhsCount, const ui8* rhs, size_t rhsCount, int lengthInBytes, ui32* result) {
+    L1DistanceMatrixImpl(NL1DistanceImpl::GetBestKernels().L1DistanceUI4X4, L1DistanceUI4, lhs, lhsCount, rhs, rhsCount, lengthInBytes, result);
+}
@@ -157,76 +157,49 @@ namespace NL1Distance {
 }
 
 /**
- * L1Distance (sum(abs(l[i] - r[i]))) implementation using SSE when possible.
+ * L1Distance (sum(abs(l[i] - r[i]))) implementation using the best instruction set supported by cpu.
  */
-#ifdef ARCADIA_SSE
-
-Y_FORCE_INLINE ui32 L1Distance(const i8* lhs, const i8* rhs, int length) {
-    static const __m128i unsignedToSignedDiff = _mm_set_epi8(
-        -128, -128, -128, -128, -128, -128, -128, -128,
-        -128, -128, -128, -128, -128, -128, -128, -128);
-    __m128i resVec = _mm_setzero_si128();
+ui32 L1Distance(const i8* lhs, const i8* rhs, int length);
 
-    while (length >= 16) {
-        __m128i lVec = _mm_sub_epi8(_mm_loadu_si128((const __m128i*)lhs), unsignedToSignedDiff);
-        __m128i rVec = _mm_sub_epi8(_mm_loadu_si128((const __m128i*)rhs), unsignedToSignedDiff);
+ui32 L1Distance(const ui8* lhs, const ui8* rhs, int length);
 
-        resVec = _mm_add_epi64(_mm_sad_epu8(lVec, rVec), resVec);
-
-        lhs += 16;
-        rhs += 16;
-        length -= 16;
-    }
+float L1Distance(const float* lhs, const float* rhs, int length);
 
-    alignas(16) i64 res[2];
-    _mm_store_si128((__m128i*)res, resVec);
-    ui32 sum = res[0] + res[1];
-    for (int i = 0; i < length; ++i) {
-        const i32 diff = static_cast<i32>(lhs[i]) - static_cast<i32>(rhs[i]);
-        sum += (diff >= 0) ? diff : -diff;
-    }
-
-    return sum;
-}
+double L1Distance(const double* lhs, const double* rhs, int length);
 
-Y_FORCE_INLINE ui32 L1Distance(const ui8* lhs, const ui8* rhs, int length) {
-    if (length == 96)
-        return NL1Distance::NPrivate::L1Distance96Ui8(lhs, rhs);
+/**
+ * L1 distances from `query` to `rowCount` rows of a row-major matrix of `length` columns:
+ * result[i] = L1Distance(query, rows + i * length, length).
+ * The query is reused from registers for 4 rows at once, the last rowCount % 4 rows are computed one by one.
+ * Float results may differ from L1Distance in the last bits: 4-row kernels add in a different order.
+ */
+void L1DistanceBatch(const i8* query, const i8* rows, size_t rowCount, int length, ui32* result);
 
-    int l16 = length & (~15);
-    __m128i sum = _mm_setzero_si128();
+void L1DistanceBatch(const ui8* query, const ui8* rows, size_t rowCount, int length, ui32* result);
 
-    if ((reinterpret_cast<uintptr_t>(lhs) & 0x0f) || (reinterpret_cast<uintptr_t>(rhs) & 0x0f)) {
-        for (int i = 0; i < l16; i += 16) {
-            __m128i a = _mm_loadu_si128((const __m128i*)(&lhs[i]));
-            __m128i b = _mm_loadu_si128((const __m128i*)(&rhs[i]));
+void L1DistanceBatch(const float* query, const float* rows, size_t rowCount, int length, float* result);
 
-            sum = _mm_add_epi64(sum, _mm_sad_epu8(a, b));
-        }
-    } else {
-        for (int i = 0; i < l16; i += 16) {
-            __m128i sum_ab = _mm_sad_epu8(*(const __m128i*)(&lhs[i]), *(const __m128i*)(&rhs[i]));
-            sum = _mm_add_epi64(sum, sum_ab);
-        }
-    }
+void L1DistanceUI4Batch(const ui8* query, const ui8* rows, size_t rowCount, int lengthInBytes, ui32* result);
 
-    if (l16 == length)
-        return _mm_cvtsi128_si32(sum) + _mm_cvtsi128_si32(_mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 2, 2, 2)));
+/**
+ * L1 distances between every row of `lhs` and every row of `rhs`, both row-major with `length` columns:
+ * result[i * rhsCount + j] = L1Distance(lhs + i * length, rhs + j * length, length).
+ * Every `lhs` row is run as a batch over a 64 KiB block of `rhs` rows, so the block stays in cache;
+ * register blocking is 1 x 4 as in the batch, there is no M x N tiling. Float results are not
+ * bit-identical to L1Distance, see the batch version.
+ */
+void L1DistanceMatrix(const i8* lhs, size_t lhsCount, const i8* rhs, size_t rhsCount, int length, ui32* result);
 
-    int l4 = length & (~3);
-    for (int i = l16; i < l4; i += 4) {
-        __m128i a = _mm_set_epi32(*((const ui32*)&lhs[i]), 0, 0, 0);
-        __m128i b = _mm_set_epi32(*((const ui32*)&rhs[i]), 0, 0, 0);
-        sum = _mm_add_epi64(sum, _mm_sad_epu8(a, b));
-    }
+void L1DistanceMatrix(const ui8* lhs, size_t lhsCount, const ui8* rhs, size_t rhsCount, int length, ui32* result);
 
-    ui32 res = _mm_cvtsi128_si32(sum) + _mm_cvtsi128_si32(_mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 2, 2, 2)));
+void L1DistanceMatrix(const float* lhs, size_t lhsCount, const float* rhs, size_t rhsCount, int length, float* result);
 
-    for (int i = l4; i < length; i++)
-        res += lhs[i] < rhs[i] ? rhs[i] - lhs[i] : lhs[i] - rhs[i];
+void L1DistanceUI4Matrix(const ui8* lhs, size_t lhsCount, const ui8* rhs, size_t rhsCount, int lengthInBytes, ui32* result);
 
-    return res;
-}
+/**
+ * L1Distance (sum(abs(l[i] - r[i]))) implementation using SSE when possible.
+ */
+#ifdef ARCADIA_SSE
 
 Y_FORCE_INLINE ui32 L1DistanceUI4(const ui8* lhs, const ui8* rhs, int lengtInBytes) {
 
@@ -337,72 +310,8 @@ Y_FORCE_INLINE ui64 L1Distance(const ui32* lhs, const ui32* rhs, int length) {
     return sum;
 }
 
-Y_FORCE_INLINE float L1Distance(const float* lhs, const float* rhs, int length) {
-    __m128 res = _mm_setzero_ps();
-    __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
-
-    while (length >= 4) {
-        __m128 a = _mm_loadu_ps(lhs);
-        __m128 b = _mm_loadu_ps(rhs);
-        __m128 d = _mm_sub_ps(a, b);
-        res = _mm_add_ps(_mm_and_ps(d, absMask), res);
-        rhs += 4;
-        lhs += 4;
-        length -= 4;
-    }
-
-    alignas(16) float r[4];
-    _mm_store_ps(r, res);
-    float sum = r[0] + r[1] + r[2] + r[3];
-
-    while (length) {
-        sum += std::abs(*lhs - *rhs);
-        ++lhs;
-        ++rhs;
-        --length;
-    }
-
-    return sum;
-}
-
-Y_FORCE_INLINE double L1Distance(const double* lhs, const double* rhs, int length) {
-    __m128d res = _mm_setzero_pd();
-    __m128d absMask = _mm_castsi128_pd(_mm_set_epi32(0x7fffffff, 0xffffffff, 0x7fffffff, 0xffffffff));
-
-    while (length >= 2) {
-        __m128d a = _mm_loadu_pd(lhs);
-        __m128d b = _mm_loadu_pd(rhs);
-        __m128d d = _mm_sub_pd(a, b);
-        res = _mm_add_pd(_mm_and_pd(d, absMask), res);
-        rhs += 2;
-        lhs += 2;
-        length -= 2;
-    }
-
-    alignas(16) double r[2];
-    _mm_store_pd(r, res);
-    double sum = r[0] + r[1];
-
-    while (length) {
-        sum += std::abs(*lhs - *rhs);
-        ++lhs;
-        ++rhs;
-        --length;
-    }
-
-    return sum;
-}
-
 #else // ARCADIA_SSE
 
-inline ui32 L1Distance(const i8* lhs, const i8* rhs, int length) {
-    return NL1Distance::NPrivate::L1DistanceImpl<ui32, i8>(lhs, rhs, length);
-}
-
-inline ui32 L1Distance(const ui8* lhs, const ui8* rhs, int length) {
-    return NL1Distance::NPrivate::L1DistanceImpl<ui32, ui8>(lhs, rhs, length);
-}
-
 inline ui32 L1DistanceUI4(const ui8* lhs, const ui8* rhs, int lengtInBytes) {
     return NL1Distance::NPrivate::L1DistanceImplUI4<ui32>(lhs, rhs, lengtInBytes);
 }
@@ -415,14 +324,6 @@ inline ui64 L1Distance(const i32* lhs, const i32* rhs, int length) {
     return NL1Distance::NPrivate::L1DistanceImpl2<ui64, i32>(lhs, rhs, length);
 }
 
-inline float L1Distance(const float* lhs, const float* rhs, int length) {
-    return NL1Distance::NPrivate::L1DistanceImpl4<float, float>(lhs, rhs, length);
-}
-
-inline double L1Distance(const double* lhs, const double* rhs, int length) {
-    return NL1Distance::NPrivate::L1DistanceImpl4<double, double>(lhs, rhs, length);
-}
-
 #endif // _sse_
 
 /**
@@ -0,0 +1,264 @@
+#include "l1_distance_simd.h"
+
+#include <immintrin.h>
+
+#include <type_traits>
+
+namespace {
+    Y_FORCE_INLINE ui64 HorizontalSumI64(__m256i v) {
+        const __m128i x = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+        return static_cast<ui64>(_mm_cvtsi128_si64(x)) + static_cast<ui64>(_mm_extract_epi64(x, 1));
+    }
+
+    Y_FORCE_INLINE float HorizontalSum(__m256 v) {
+        __m128 x = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        x = _mm_add_ps(x, _mm_movehl_ps(x, x));
+        x = _mm_add_ss(x, _mm_movehdup_ps(x));
+        return _mm_cvtss_f32(x);
+    }
+
+    Y_FORCE_INLINE double HorizontalSum(__m256d v) {
+        __m128d x = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+        x = _mm_add_sd(x, _mm_unpackhi_pd(x, x));
+        return _mm_cvtsd_f64(x);
+    }
+
+    template <typename T>
+    Y_FORCE_INLINE __m256i LoadUnsigned(const T* p) {
+        const __m256i v = _mm256_loadu_si256((const __m256i*)p);
+        if constexpr (std::is_signed<T>::value) {
+            return _mm256_xor_si256(v, _mm256_set1_epi8(-128));
+        } else {
+            return v;
+        }
+    }
+
+    template <typename T>
+    Y_FORCE_INLINE ui32 L1DistanceBytes(const T* lhs, const T* rhs, int length) {
+        __m256i sum0 = _mm256_setzero_si256();
+        __m256i sum1 = _mm256_setzero_si256();
+
+        while (length >= 64) {
+            sum0 = _mm256_add_epi64(sum0, _mm256_sad_epu8(LoadUnsigned(lhs), LoadUnsigned(rhs)));
+            sum1 = _mm256_add_epi64(sum1, _mm256_sad_epu8(LoadUnsigned(lhs + 32), LoadUnsigned(rhs + 32)));
+            lhs += 64;
+            rhs += 64;
+            length -= 64;
+        }
+
+        if (length >= 32) {
+            sum0 = _mm256_add_epi64(sum0, _mm256_sad_epu8(LoadUnsigned(lhs), LoadUnsigned(rhs)));
+            lhs += 32;
+            rhs += 32;
+            length -= 32;
+        }
+
+        ui32 sum = static_cast<ui32>(HorizontalSumI64(_mm256_add_epi64(sum0, sum1)));
+        for (int i = 0; i < length; ++i) {
+            const i32 diff = static_cast<i32>(lhs[i]) - static_cast<i32>(rhs[i]);
+            sum += (diff >= 0) ? diff : -diff;
+        }
+        return sum;
+    }
+
+    // {sum(a), sum(b), sum(c), sum(d)}
+    Y_FORCE_INLINE __m128 HorizontalSum4(__m256 a, __m256 b, __m256 c, __m256 d) {
+        const __m256 abcd = _mm256_hadd_ps(_mm256_hadd_ps(a, b), _mm256_hadd_ps(c, d));
+        return _mm_add_ps(_mm256_castps256_ps128(abcd), _mm256_extractf128_ps(abcd, 1));
+    }
+
+    // the query is loaded once for 4 rows, each row has its own accumulator
+    template <typename T>
+    Y_FORCE_INLINE void L1DistanceX4Bytes(const T* query, const T* rows, int length, ui32* result) {
+        const T* r0 = rows;
+        const T* r1 = rows + length;
+        const T* r2 = rows + 2 * length;
+        const T* r3 = rows + 3 * length;
+        __m256i sum0 = _mm256_setzero_si256();
+        __m256i sum1 = _mm256_setzero_si256();
+        __m256i sum2 = _mm256_setzero_si256();
+        __m256i sum3 = _mm256_setzero_si256();
+
+        int i = 0;
+        for (; i + 32 <= length; i += 32) {
+            const __m256i q = LoadUnsigned(query + i);
+            sum0 = _mm256_add_epi64(sum0, _mm256_sad_epu8(q, LoadUnsigned(r0 + i)));
+            sum1 = _mm256_add_epi64(sum1, _mm256_sad_epu8(q, LoadUnsigned(r1 + i)));
+            sum2 = _mm256_add_epi64(sum2, _mm256_sad_epu8(q, LoadUnsigned(r2 + i)));
+            sum3 = _mm256_add_epi64(sum3, _mm256_sad_epu8(q, LoadUnsigned(r3 + i)));
+        }
+
+        ui32 sums[4] = {
+            static_cast<ui32>(HorizontalSumI64(sum0)),
+            static_cast<ui32>(HorizontalSumI64(sum1)),
+            static_cast<ui32>(HorizontalSumI64(sum2)),
+            static_cast<ui32>(HorizontalSumI64(sum3))};
+        for (int k = 0; k < 4; ++k) {
+            const T* row = rows + k * length;
+            for (int j = i; j < length; ++j) {
+                const i32 diff = static_cast<i32>(query[j]) - static_cast<i32>(row[j]);
+                sums[k] += (diff >= 0) ? diff : -diff;
+            }
+            result[k] = sums[k];
+        }
+    }
+
+    Y_FORCE_INLINE __m256i NibbleAbsDelta(__m256i queryLo, __m256i queryHi, __m256i row) {
+        const __m256i lowNibbles = _mm256_set1_epi8(0x0f);
+        const __m256i rowLo = _mm256_and_si256(row, lowNibbles);
+        const __m256i rowHi = _mm256_and_si256(_mm256_srli_epi16(row, 4), lowNibbles);
+        return _mm256_add_epi64(_mm256_sad_epu8(queryLo, rowLo), _mm256_sad_epu8(queryHi, rowHi));
+    }
+}
+
+namespace NL1DistanceImpl::NAvx2 {
+    ui32 L1Distance(const i8* lhs, const i8* rhs, int length) {
+        return L1DistanceBytes(lhs, rhs, length);
+    }
+
+    ui32 L1Distance(const ui8* lhs, const ui8* rhs, int length) {
+        return L1DistanceBytes(lhs, rhs, length);
+    }
+
+    float L1Distance(const float* lhs, const float* rhs, int length) {
+        const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+        __m256 sum0 = _mm256_setzero_ps();
+        __m256 sum1 = _mm256_setzero_ps();
+        __m256 sum2 = _mm256_setzero_ps();
+        __m256 sum3 = _mm256_setzero_ps();
+
+        while (length >= 32) {
+            sum0 = _mm256_add_ps(sum0, _mm256_and_ps(_mm256_sub_ps(_mm256_loadu_ps(lhs), _mm256_loadu_ps(rhs)), absMask));
+            sum1 = _mm256_add_ps(sum1, _mm256_and_ps(_mm256_sub_ps(_mm256_loadu_ps(lhs + 8), _mm256_loadu_ps(rhs + 8)), absMask));
+            sum2 = _mm256_add_ps(sum2, _mm256_and_ps(_mm256_sub_ps(_mm256_loadu_ps(lhs + 16), _mm256_loadu_ps(rhs + 16)), absMask));
+            sum3 = _mm256_add_ps(sum3, _mm256_and_ps(_mm256_sub_ps(_mm256_loadu_ps(lhs + 24), _mm256_loadu_ps(rhs + 24)), absMask));
+            lhs += 32;
+            rhs += 32;
+            length -= 32;
+        }
+
+        while (length >= 8) {
+            sum0 = _mm256_add_ps(sum0, _mm256_and_ps(_mm256_sub_ps(_mm256_loadu_ps(lhs), _mm256_loadu_ps(rhs)), absMask));
+            lhs += 8;
+            rhs += 8;
+            length -= 8;
+        }
+
+        if (length) {
+            const __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(length), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+            sum1 = _mm256_add_ps(sum1, _mm256_and_ps(_mm256_sub_ps(_mm256_maskload_ps(lhs, mask), _mm256_maskload_ps(rhs, mask)), absMask));
+        }
+
+        return HorizontalSum(_mm256_add_ps(_mm256_add_ps(sum0, sum1), _mm256_add_ps(sum2, sum3)));
+    }
+
+    double L1Distance(const double* lhs, const double* rhs, int length) {
+        const __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffll));
+        __m256d sum0 = _mm256_setzero_pd();
+        __m256d sum1 = _mm256_setzero_pd();
+        __m256d sum2 = _mm256_setzero_pd();
+        __m256d sum3 = _mm256_setzero_pd();
+
+        while (length >= 16) {
+            sum0 = _mm256_add_pd(sum0, _mm256_and_pd(_mm256_sub_pd(_mm256_loadu_pd(lhs), _mm256_loadu_pd(rhs)), absMask));
+            sum1 = _mm256_add_pd(sum1, _mm256_and_pd(_mm256_sub_pd(_mm256_loadu_pd(lhs + 4), _mm256_loadu_pd(rhs + 4)), absMask));
+            sum2 = _mm256_add_pd(sum2, _mm256_and_pd(_mm256_sub_pd(_mm256_loadu_pd(lhs + 8), _mm256_loadu_pd(rhs + 8)), absMask));
+            sum3 = _mm256_add_pd(sum3, _mm256_and_pd(_mm256_sub_pd(_mm256_loadu_pd(lhs + 12), _mm256_loadu_pd(rhs + 12)), absMask));
+            lhs += 16;
+            rhs += 16;
+            length -= 16;
+        }
+
+        while (length >= 4) {
+            sum0 = _mm256_add_pd(sum0, _mm256_and_pd(_mm256_sub_pd(_mm256_loadu_pd(lhs), _mm256_loadu_pd(rhs)), absMask));
+            lhs += 4;
+            rhs += 4;
+            length -= 4;
+        }
+
+        if (length) {
+            const __m256i mask = _mm256_cmpgt_epi64(_mm256_set1_epi64x(length), _mm256_setr_epi64x(0, 1, 2, 3));
+            sum1 = _mm256_add_pd(sum1, _mm256_and_pd(_mm256_sub_pd(_mm256_maskload_pd(lhs, mask), _mm256_maskload_pd(rhs, mask)), absMask));
+        }
+
+        return HorizontalSum(_mm256_add_pd(_mm256_add_pd(sum0, sum1), _mm256_add_pd(sum2, sum3)));
+    }
+
+    void L1DistanceX4(const i8* query, const i8* rows, int length, ui32* result) {
+        L1DistanceX4Bytes(query, rows, length, result);
+    }
+
+    void L1DistanceX4(const ui8* query, const ui8* rows, int length, ui32* result) {
+        L1DistanceX4Bytes(query, rows, length, result);
+    }
+
+    void L1DistanceX4(const float* query, const float* rows, int length, float* result) {
+        const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+        const float* r0 = rows;
+        const float* r1 = rows + length;
+        const float* r2 = rows + 2 * length;
+        const float* r3 = rows + 3 * length;
+        __m256 sum0 = _mm256_setzero_ps();
+        __m256 sum1 = _mm256_setzero_ps();
+        __m256 sum2 = _mm256_setzero_ps();
+        __m256 sum3 = _mm256_setzero_ps();
+
+        int i = 0;
+        for (; i + 8 <= length; i += 8) {
+            const __m256 q = _mm256_loadu_ps(query + i);
+            sum0 = _mm256_add_ps(sum0, _mm256_and_ps(_mm256_sub_ps(q, _mm256_loadu_ps(r0 + i)), absMask));
+            sum1 = _mm256_add_ps(sum1, _mm256_and_ps(_mm256_sub_ps(q, _mm256_loadu_ps(r1 + i)), absMask));
+            sum2 = _mm256_add_ps(sum2, _mm256_and_ps(_mm256_sub_ps(q, _mm256_loadu_ps(r2 + i)), absMask));
+            sum3 = _mm256_add_ps(sum3, _mm256_and_ps(_mm256_sub_ps(q, _mm256_loadu_ps(r3 + i)), absMask));
+        }
+
+        if (i < length) {
+            const __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(length - i), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+            const __m256 q = _mm256_maskload_ps(query + i, mask);
+            sum0 = _mm256_add_ps(sum0, _mm256_and_ps(_mm256_sub_ps(q, _mm256_maskload_ps(r0 + i, mask)), absMask));
+            sum1 = _mm256_add_ps(sum1, _mm256_and_ps(_mm256_sub_ps(q, _mm256_maskload_ps(r1 + i, mask)), absMask));
+            sum2 = _mm256_add_ps(sum2, _mm256_and_ps(_mm256_sub_ps(q, _mm256_maskload_ps(r2 + i, mask)), absMask));
+            sum3 = _mm256_add_ps(sum3, _mm256_and_ps(_mm256_sub_ps(q, _mm256_maskload_ps(r3 + i, mask)), absMask));
+        }
+
+        _mm_storeu_ps(result, HorizontalSum4(sum0, sum1, sum2, sum3));
+    }
+
+    void L1DistanceUI4X4(const ui8* query, const ui8* rows, int lengthInBytes, ui32* result) {
+        const ui8* r0 = rows;
+        const ui8* r1 = rows + lengthInBytes;
+        const ui8* r2 = rows + 2 * lengthInBytes;
+        const ui8* r3 = rows + 3 * lengthInBytes;
+        const __m256i lowNibbles = _mm256_set1_epi8(0x0f);
+        __m256i sum0 = _mm256_setzero_si256();
+        __m256i sum1 = _mm256_setzero_si256();
+        __m256i sum2 = _mm256_setzero_si256();
+        __m256i sum3 = _mm256_setzero_si256();
+
+        int i = 0;
+        for (; i + 32 <= lengthInBytes; i += 32) {
+            const __m256i q = _mm256_loadu_si256((const __m256i*)(query + i));
+            const __m256i qLo = _mm256_and_si256(q, lowNibbles);
+            const __m256i qHi = _mm256_and_si256(_mm256_srli_epi16(q, 4), lowNibbles);
+            sum0 = _mm256_add_epi64(sum0, NibbleAbsDelta(qLo, qHi, _mm256_loadu_si256((const __m256i*)(r0 + i))));
+            sum1 = _mm256_add_epi64(sum1, NibbleAbsDelta(qLo, qHi, _mm256_loadu_si256((const __m256i*)(r1 + i))));
+            sum2 = _mm256_add_epi64(sum2, NibbleAbsDelta(qLo, qHi, _mm256_loadu_si256((const __m256i*)(r2 + i))));
+            sum3 = _mm256_add_epi64(sum3, NibbleAbsDelta(qLo, qHi, _mm256_loadu_si256((const __m256i*)(r3 + i))));
+        }
+
+        ui32 sums[4] = {
+            static_cast<ui32>(HorizontalSumI64(sum0)),
+            static_cast<ui32>(HorizontalSumI64(sum1)),
+            static_cast<ui32>(HorizontalSumI64(sum2)),
+            static_cast<ui32>(HorizontalSumI64(sum3))};
+        for (int k = 0; k < 4; ++k) {
+            const ui8* row = rows + k * lengthInBytes;
+            for (int j = i; j < lengthInBytes; ++j) {
+                const i32 deltaLo = static_cast<i32>(query[j] & 0x0f) - static_cast<i32>(row[j] & 0x0f);
+                const i32 deltaHi = static_cast<i32>(query[j] >> 4) - static_cast<i32>(row[j] >> 4);
+                sums[k] += (deltaLo >= 0 ? deltaLo : -deltaLo) + (deltaHi >= 0 ? deltaHi : -deltaHi);
+            }
+            result[k] = sums[k];
+        }
+    }
+}
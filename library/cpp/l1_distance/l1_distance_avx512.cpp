@@ -0,0 +1,223 @@
+#include "l1_distance_simd.h"
+
+#include <immintrin.h>
+
+#include <type_traits>
+
+namespace {
+    Y_FORCE_INLINE __mmask64 TailMask(int length) {
+        return length ? (__mmask64)(~0ull >> (64 - length)) : 0;
+    }
+
+    template <typename T>
+    Y_FORCE_INLINE __m512i ToUnsigned(__m512i v) {
+        if constexpr (std::is_signed<T>::value) {
+            return _mm512_xor_si512(v, _mm512_set1_epi8(-128));
+        } else {
+            return v;
+        }
+    }
+
+    template <typename T>
+    Y_FORCE_INLINE __m512i AddAbsDelta(__m512i sum, __m512i lhs, __m512i rhs) {
+        return _mm512_add_epi64(sum, _mm512_sad_epu8(ToUnsigned<T>(lhs), ToUnsigned<T>(rhs)));
+    }
+
+    template <typename T>
+    Y_FORCE_INLINE ui32 L1DistanceBytes(const T* lhs, const T* rhs, int length) {
+        __m512i sum0 = _mm512_setzero_si512();
+        __m512i sum1 = _mm512_setzero_si512();
+
+        while (length >= 128) {
+            sum0 = AddAbsDelta<T>(sum0, _mm512_loadu_si512(lhs), _mm512_loadu_si512(rhs));
+            sum1 = AddAbsDelta<T>(sum1, _mm512_loadu_si512(lhs + 64), _mm512_loadu_si512(rhs + 64));
+            lhs += 128;
+            rhs += 128;
+            length -= 128;
+        }
+
+        if (length >= 64) {
+            sum0 = AddAbsDelta<T>(sum0, _mm512_loadu_si512(lhs), _mm512_loadu_si512(rhs));
+            lhs += 64;
+            rhs += 64;
+            length -= 64;
+        }
+
+        if (length) {
+            // zeroed lanes of both vectors give zero delta
+            const __mmask64 mask = TailMask(length);
+            sum1 = AddAbsDelta<T>(sum1, _mm512_maskz_loadu_epi8(mask, lhs), _mm512_maskz_loadu_epi8(mask, rhs));
+        }
+
+        return static_cast<ui32>(_mm512_reduce_add_epi64(_mm512_add_epi64(sum0, sum1)));
+    }
+
+    // the query is loaded once for 4 rows, each row has its own accumulator
+    template <typename T>
+    Y_FORCE_INLINE void L1DistanceX4Bytes(const T* query, const T* rows, int length, ui32* result) {
+        const T* r0 = rows;
+        const T* r1 = rows + length;
+        const T* r2 = rows + 2 * length;
+        const T* r3 = rows + 3 * length;
+        __m512i sum0 = _mm512_setzero_si512();
+        __m512i sum1 = _mm512_setzero_si512();
+        __m512i sum2 = _mm512_setzero_si512();
+        __m512i sum3 = _mm512_setzero_si512();
+
+        // zeroed lanes of the tail give zero delta
+        for (int i = 0; i < length; i += 64) {
+            const __mmask64 mask = length - i >= 64 ? ~0ull : TailMask(length - i);
+            const __m512i q = _mm512_maskz_loadu_epi8(mask, query + i);
+            sum0 = AddAbsDelta<T>(sum0, q, _mm512_maskz_loadu_epi8(mask, r0 + i));
+            sum1 = AddAbsDelta<T>(sum1, q, _mm512_maskz_loadu_epi8(mask, r1 + i));
+            sum2 = AddAbsDelta<T>(sum2, q, _mm512_maskz_loadu_epi8(mask, r2 + i));
+            sum3 = AddAbsDelta<T>(sum3, q, _mm512_maskz_loadu_epi8(mask, r3 + i));
+        }
+
+        result[0] = static_cast<ui32>(_mm512_reduce_add_epi64(sum0));
+        result[1] = static_cast<ui32>(_mm512_reduce_add_epi64(sum1));
+        result[2] = static_cast<ui32>(_mm512_reduce_add_epi64(sum2));
+        result[3] = static_cast<ui32>(_mm512_reduce_add_epi64(sum3));
+    }
+
+    Y_FORCE_INLINE __m512i NibbleAbsDelta(__m512i queryLo, __m512i queryHi, __m512i row) {
+        const __m512i lowNibbles = _mm512_set1_epi8(0x0f);
+        const __m512i rowLo = _mm512_and_si512(row, lowNibbles);
+        const __m512i rowHi = _mm512_and_si512(_mm512_srli_epi16(row, 4), lowNibbles);
+        return _mm512_add_epi64(_mm512_sad_epu8(queryLo, rowLo), _mm512_sad_epu8(queryHi, rowHi));
+    }
+}
+
+namespace NL1DistanceImpl::NAvx512 {
+    ui32 L1Distance(const i8* lhs, const i8* rhs, int length) {
+        return L1DistanceBytes(lhs, rhs, length);
+    }
+
+    ui32 L1Distance(const ui8* lhs, const ui8* rhs, int length) {
+        return L1DistanceBytes(lhs, rhs, length);
+    }
+
+    float L1Distance(const float* lhs, const float* rhs, int length) {
+        __m512 sum0 = _mm512_setzero_ps();
+        __m512 sum1 = _mm512_setzero_ps();
+        __m512 sum2 = _mm512_setzero_ps();
+        __m512 sum3 = _mm512_setzero_ps();
+
+        while (length >= 64) {
+            sum0 = _mm512_add_ps(sum0, _mm512_abs_ps(_mm512_sub_ps(_mm512_loadu_ps(lhs), _mm512_loadu_ps(rhs))));
+            sum1 = _mm512_add_ps(sum1, _mm512_abs_ps(_mm512_sub_ps(_mm512_loadu_ps(lhs + 16), _mm512_loadu_ps(rhs + 16))));
+            sum2 = _mm512_add_ps(sum2, _mm512_abs_ps(_mm512_sub_ps(_mm512_loadu_ps(lhs + 32), _mm512_loadu_ps(rhs + 32))));
+            sum3 = _mm512_add_ps(sum3, _mm512_abs_ps(_mm512_sub_ps(_mm512_loadu_ps(lhs + 48), _mm512_loadu_ps(rhs + 48))));
+            lhs += 64;
+            rhs += 64;
+            length -= 64;
+        }
+
+        while (length >= 16) {
+            sum0 = _mm512_add_ps(sum0, _mm512_abs_ps(_mm512_sub_ps(_mm512_loadu_ps(lhs), _mm512_loadu_ps(rhs))));
+            lhs += 16;
+            rhs += 16;
+            length -= 16;
+        }
+
+        if (length) {
+            const __mmask16 mask = (__mmask16)TailMask(length);
+            sum1 = _mm512_add_ps(sum1, _mm512_abs_ps(_mm512_sub_ps(_mm512_maskz_loadu_ps(mask, lhs), _mm512_maskz_loadu_ps(mask, rhs))));
+        }
+
+        return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(sum0, sum1), _mm512_add_ps(sum2, sum3)));
+    }
+
+    double L1Distance(const double* lhs, const double* rhs, int length) {
+        __m512d sum0 = _mm512_setzero_pd();
+        __m512d sum1 = _mm512_setzero_pd();
+        __m512d sum2 = _mm512_setzero_pd();
+        __m512d sum3 = _mm512_setzero_pd();
+
+        while (length >= 32) {
+            sum0 = _mm512_add_pd(sum0, _mm512_abs_pd(_mm512_sub_pd(_mm512_loadu_pd(lhs), _mm512_loadu_pd(rhs))));
+            sum1 = _mm512_add_pd(sum1, _mm512_abs_pd(_mm512_sub_pd(_mm512_loadu_pd(lhs + 8), _mm512_loadu_pd(rhs + 8))));
+            sum2 = _mm512_add_pd(sum2, _mm512_abs_pd(_mm512_sub_pd(_mm512_loadu_pd(lhs + 16), _mm512_loadu_pd(rhs + 16))));
+            sum3 = _mm512_add_pd(sum3, _mm512_abs_pd(_mm512_sub_pd(_mm512_loadu_pd(lhs + 24), _mm512_loadu_pd(rhs + 24))));
+            lhs += 32;
+            rhs += 32;
+            length -= 32;
+        }
+
+        while (length >= 8) {
+            sum0 = _mm512_add_pd(sum0, _mm512_abs_pd(_mm512_sub_pd(_mm512_loadu_pd(lhs), _mm512_loadu_pd(rhs))));
+            lhs += 8;
+            rhs += 8;
+            length -= 8;
+        }
+
+        if (length) {
+            const __mmask8 mask = (__mmask8)TailMask(length);
+            sum1 = _mm512_add_pd(sum1, _mm512_abs_pd(_mm512_sub_pd(_mm512_maskz_loadu_pd(mask, lhs), _mm512_maskz_loadu_pd(mask, rhs))));
+        }
+
+        return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(sum0, sum1), _mm512_add_pd(sum2, sum3)));
+    }
+
+    void L1DistanceX4(const i8* query, const i8* rows, int length, ui32* result) {
+        L1DistanceX4Bytes(query, rows, length, result);
+    }
+
+    void L1DistanceX4(const ui8* query, const ui8* rows, int length, ui32* result) {
+        L1DistanceX4Bytes(query, rows, length, result);
+    }
+
+    void L1DistanceX4(const float* query, const float* rows, int length, float* result) {
+        const float* r0 = rows;
+        const float* r1 = rows + length;
+        const float* r2 = rows + 2 * length;
+        const float* r3 = rows + 3 * length;
+        __m512 sum0 = _mm512_setzero_ps();
+        __m512 sum1 = _mm512_setzero_ps();
+        __m512 sum2 = _mm512_setzero_ps();
+        __m512 sum3 = _mm512_setzero_ps();
+
+        for (int i = 0; i < length; i += 16) {
+            const __mmask16 mask = length - i >= 16 ? (__mmask16)0xffff : (__mmask16)TailMask(length - i);
+            const __m512 q = _mm512_maskz_loadu_ps(mask, query + i);
+            sum0 = _mm512_add_ps(sum0, _mm512_abs_ps(_mm512_sub_ps(q, _mm512_maskz_loadu_ps(mask, r0 + i))));
+            sum1 = _mm512_add_ps(sum1, _mm512_abs_ps(_mm512_sub_ps(q, _mm512_maskz_loadu_ps(mask, r1 + i))));
+            sum2 = _mm512_add_ps(sum2, _mm512_abs_ps(_mm512_sub_ps(q, _mm512_maskz_loadu_ps(mask, r2 + i))));
+            sum3 = _mm512_add_ps(sum3, _mm512_abs_ps(_mm512_sub_ps(q, _mm512_maskz_loadu_ps(mask, r3 + i))));
+        }
+
+        result[0] = _mm512_reduce_add_ps(sum0);
+        result[1] = _mm512_reduce_add_ps(sum1);
+        result[2] = _mm512_reduce_add_ps(sum2);
+        result[3] = _mm512_reduce_add_ps(sum3);
+    }
+
+    void L1DistanceUI4X4(const ui8* query, const ui8* rows, int lengthInBytes, ui32* result) {
+        const ui8* r0 = rows;
+        const ui8* r1 = rows + lengthInBytes;
+        const ui8* r2 = rows + 2 * lengthInBytes;
+        const ui8* r3 = rows + 3 * lengthInBytes;
+        const __m512i lowNibbles = _mm512_set1_epi8(0x0f);
+        __m512i sum0 = _mm512_setzero_si512();
+        __m512i sum1 = _mm512_setzero_si512();
+        __m512i sum2 = _mm512_setzero_si512();
+        __m512i sum3 = _mm512_setzero_si512();
+
+        // zeroed lanes of the tail give zero delta
+        for (int i = 0; i < lengthInBytes; i += 64) {
+            const __mmask64 mask = lengthInBytes - i >= 64 ? ~0ull : TailMask(lengthInBytes - i);
+            const __m512i q = _mm512_maskz_loadu_epi8(mask, query + i);
+            const __m512i qLo = _mm512_and_si512(q, lowNibbles);
+            const __m512i qHi = _mm512_and_si512(_mm512_srli_epi16(q, 4), lowNibbles);
+            sum0 = _mm512_add_epi64(sum0, NibbleAbsDelta(qLo, qHi, _mm512_maskz_loadu_epi8(mask, r0 + i)));
+            sum1 = _mm512_add_epi64(sum1, NibbleAbsDelta(qLo, qHi, _mm512_maskz_loadu_epi8(mask, r1 + i)));
+            sum2 = _mm512_add_epi64(sum2, NibbleAbsDelta(qLo, qHi, _mm512_maskz_loadu_epi8(mask, r2 + i)));
+            sum3 = _mm512_add_epi64(sum3, NibbleAbsDelta(qLo, qHi, _mm512_maskz_loadu_epi8(mask, r3 + i)));
+        }
+
+        result[0] = static_cast<ui32>(_mm512_reduce_add_epi64(sum0));
+        result[1] = static_cast<ui32>(_mm512_reduce_add_epi64(sum1));
+        result[2] = static_cast<ui32>(_mm512_reduce_add_epi64(sum2));
+        result[3] = static_cast<ui32>(_mm512_reduce_add_epi64(sum3));
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <util/generic/array_ref.h>
+#include <util/system/compiler.h>
+#include <util/system/platform.h>
+#include <util/system/types.h>
+
+/**
+ * Instruction set specific implementations of l1_distance.h functions.
+ * Public functions use the best set supported by cpu, it is chosen once on the first call.
+ */
+namespace NL1DistanceImpl {
+    struct TL1DistanceKernels {
+        const char* Name;
+        ui32 (*L1DistanceI8)(const i8* lhs, const i8* rhs, int length);
+        ui32 (*L1DistanceUi8)(const ui8* lhs, const ui8* rhs, int length);
+        float (*L1DistanceFloat)(const float* lhs, const float* rhs, int length);
+        double (*L1DistanceDouble)(const double* lhs, const double* rhs, int length);
+
+        // `query` against 4 consecutive rows of `length` elements starting at `rows`
+        void (*L1DistanceX4I8)(const i8* query, const i8* rows, int length, ui32* result);
+        void (*L1DistanceX4Ui8)(const ui8* query, const ui8* rows, int length, ui32* result);
+        void (*L1DistanceX4Float)(const float* query, const float* rows, int length, float* result);
+        void (*L1DistanceUI4X4)(const ui8* query, const ui8* rows, int lengthInBytes, ui32* result);
+    };
+
+    // Kernels supported by cpu, from the baseline (SSE or plain C++) to the best one.
+    TArrayRef<const TL1DistanceKernels* const> GetSupportedKernels() noexcept;
+
+    const TL1DistanceKernels& GetBestKernels() noexcept;
+
+#if defined(_x86_64_)
+    namespace NAvx2 {
+        ui32 L1Distance(const i8* lhs, const i8* rhs, int length);
+        ui32 L1Distance(const ui8* lhs, const ui8* rhs, int length);
+        float L1Distance(const float* lhs, const float* rhs, int length);
+        double L1Distance(const double* lhs, const double* rhs, int length);
+
+        void L1DistanceX4(const i8* query, const i8* rows, int length, ui32* result);
+        void L1DistanceX4(const ui8* query, const ui8* rows, int length, ui32* result);
+        void L1DistanceX4(const float* query, const float* rows, int length, float* result);
+        void L1DistanceUI4X4(const ui8* query, const ui8* rows, int lengthInBytes, ui32* result);
+    }
+
+    // requires AVX512F, AVX512BW, AVX512DQ and AVX512VL
+    namespace NAvx512 {
+        ui32 L1Distance(const i8* lhs, const i8* rhs, int length);
+        ui32 L1Distance(const ui8* lhs, const ui8* rhs, int length);
+        float L1Distance(const float* lhs, const float* rhs, int length);
+        double L1Distance(const double* lhs, const double* rhs, int length);
+
+        void L1DistanceX4(const i8* query, const i8* rows, int length, ui32* result);
+        void L1DistanceX4(const ui8* query, const ui8* rows, int length, ui32* result);
+        void L1DistanceX4(const float* query, const float* rows, int length, float* result);
+        void L1DistanceUI4X4(const ui8* query, const ui8* rows, int lengthInBytes, ui32* result);
+    }
+#endif
+}
@@ -1,4 +1,5 @@
 #include "l1_distance.h"
+#include "l1_distance_simd.h"
 
 #include <library/cpp/testing/unittest/registar.h>
 
@@ -178,6 +179,104 @@ Y_UNIT_TEST_SUITE(TL1DistanceTestSuite) {
         UNIT_ASSERT_VALUES_EQUAL(L1DistanceUI4(n1.data(), n2.data(), 72), L1DistanceUI4Slow(n1.data(), n2.data(), 72));
     }
 
+    template <typename Res, typename IRes, typename Number>
+    void CheckKernel(const char* name, Res (*kernel)(const Number*, const Number*, int), const TVector<Number>& a, const TVector<Number>& b) {
+        for (int i = 0; i < 3; ++i) {
+            for (int length = 0; length + i < (int)a.size(); ++length) {
+                const Res expected = SimpleL1Dist<Res, IRes, Number>(a.data() + i, b.data(), length);
+                UNIT_ASSERT_C(Eq(kernel(a.data() + i, b.data(), length), expected), name << ' ' << length);
+            }
+        }
+    }
+
+    template <typename Res, typename IRes, typename Number>
+    void CheckKernelX4(const char* name, void (*kernel)(const Number*, const Number*, int, Res*), Res (*expected)(const Number*, const Number*, int), const TVector<Number>& query, const TVector<Number>& rows) {
+        for (int length = 0; 4 * length <= (int)rows.size() && length <= (int)query.size(); ++length) {
+            Res result[4];
+            kernel(query.data(), rows.data(), length, result);
+            for (int k = 0; k < 4; ++k) {
+                UNIT_ASSERT_C(Eq(result[k], expected(query.data(), rows.data() + k * length, length)), name << ' ' << length);
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestAllInstructionSets) {
+        TVector<i8> a8(300), b8(300);
+        FillWithRandomNumbers(a8.data(), 179, a8.size());
+        FillWithRandomNumbers(b8.data(), 239, b8.size());
+        TVector<ui8> a8u(300), b8u(300);
+        FillWithRandomNumbers(a8u.data(), 179, a8u.size());
+        FillWithRandomNumbers(b8u.data(), 239, b8u.size());
+        TVector<float> af(300), bf(300);
+        FillWithRandomNumbers(af.data(), 179, af.size());
+        FillWithRandomNumbers(bf.data(), 239, bf.size());
+        TVector<double> ad(300), bd(300);
+        FillWithRandomNumbers(ad.data(), 179, ad.size());
+        FillWithRandomNumbers(bd.data(), 239, bd.size());
+        a8[5] = b8[200] = -128;
+        b8[5] = a8[200] = 127;
+        a8u[5] = b8u[200] = 255;
+        b8u[5] = a8u[200] = 0;
+
+        const auto kernels = NL1DistanceImpl::GetSupportedKernels();
+        UNIT_ASSERT(!kernels.empty());
+        UNIT_ASSERT_EQUAL(&NL1DistanceImpl::GetBestKernels(), kernels.back());
+        for (const NL1DistanceImpl::TL1DistanceKernels* k : kernels) {
+            CheckKernel<ui32, i32>(k->Name, k->L1DistanceI8, a8, b8);
+            CheckKernel<ui32, i32>(k->Name, k->L1DistanceUi8, a8u, b8u);
+            CheckKernel<float, float>(k->Name, k->L1DistanceFloat, af, bf);
+            CheckKernel<double, double>(k->Name, k->L1DistanceDouble, ad, bd);
+            CheckKernelX4<ui32, i32>(k->Name, k->L1DistanceX4I8, SimpleL1Dist<ui32, i32, i8>, a8, b8);
+            CheckKernelX4<ui32, i32>(k->Name, k->L1DistanceX4Ui8, SimpleL1Dist<ui32, i32, ui8>, a8u, b8u);
+            CheckKernelX4<float, float>(k->Name, k->L1DistanceX4Float, SimpleL1Dist<float, float, float>, af, bf);
+            CheckKernelX4<ui32, i32>(k->Name, k->L1DistanceUI4X4, L1DistanceUI4Slow, a8u, b8u);
+        }
+    }
+
+    template <typename Res, typename Number>
+    void CheckBatchAndMatrix(
+        void (*batch)(const Number*, const Number*, size_t, int, Res*),
+        void (*matrix)(const Number*, size_t, const Number*, size_t, int, Res*),
+        Res (*expected)(const Number*, const Number*, int),
+        const TVector<Number>& lhs, const TVector<Number>& rhs, int length)
+    {
+        const size_t lhsCount = lhs.size() / length;
+        const size_t rhsCount = rhs.size() / length;
+
+        TVector<Res> batchResult(rhsCount);
+        batch(lhs.data(), rhs.data(), rhsCount, length, batchResult.data());
+        for (size_t j = 0; j < rhsCount; ++j) {
+            UNIT_ASSERT(Eq(batchResult[j], expected(lhs.data(), rhs.data() + j * length, length)));
+        }
+
+        TVector<Res> matrixResult(lhsCount * rhsCount);
+        matrix(lhs.data(), lhsCount, rhs.data(), rhsCount, length, matrixResult.data());
+        for (size_t i = 0; i < lhsCount; ++i) {
+            for (size_t j = 0; j < rhsCount; ++j) {
+                UNIT_ASSERT(Eq(matrixResult[i * rhsCount + j], expected(lhs.data() + i * length, rhs.data() + j * length, length)));
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestBatchAndMatrix) {
+        // 7 lhs rows and 4103 rhs rows, more than one cache block of rhs for the matrix
+        const int length = 37;
+        TVector<i8> l8(7 * length), r8(4103 * length);
+        FillWithRandomNumbers(l8.data(), 179, l8.size());
+        FillWithRandomNumbers(r8.data(), 239, r8.size());
+        TVector<ui8> l8u(7 * length), r8u(4103 * length);
+        FillWithRandomNumbers(l8u.data(), 179, l8u.size());
+        FillWithRandomNumbers(r8u.data(), 239, r8u.size());
+        TVector<float> lf(7 * length), rf(4103 * length);
+        FillWithRandomNumbers(lf.data(), 179, lf.size());
+        FillWithRandomNumbers(rf.data(), 239, rf.size());
+
+        CheckBatchAndMatrix<ui32, i8>(L1DistanceBatch, L1DistanceMatrix, SimpleL1Dist<ui32, i32, i8>, l8, r8, length);
+        CheckBatchAndMatrix<ui32, ui8>(L1DistanceBatch, L1DistanceMatrix, SimpleL1Dist<ui32, i32, ui8>, l8u, r8u, length);
+        CheckBatchAndMatrix<ui32, ui8>(L1DistanceUI4Batch, L1DistanceUI4Matrix, L1DistanceUI4Slow, l8u, r8u, length);
+        CheckBatchAndMatrix<float, float>(L1DistanceBatch, L1DistanceMatrix, SimpleL1Dist<float, float, float>, lf, rf, length);
+    }
+
     Y_UNIT_TEST(TestL1Dist_manual_i8) {
         static i8 a[4] = {0, -128, 100, 127};
         static i8 b[4] = {0, 127, -100, -128};
@@ -1,9 +1,11 @@
 #include <library/cpp/l2_distance/l2_distance.h>
+#include <library/cpp/l2_distance/l2_distance_simd.h>
 #include <library/cpp/testing/benchmark/bench.h>
 
 #include <contrib/libs/eigen/Eigen/Core>
 
 #include <util/generic/singleton.h>
+#include <util/generic/strbuf.h>
 #include <util/generic/vector.h>
 #include <util/random/fast.h>
 
@@ -126,6 +128,14 @@ namespace {
             }
         }
 
+        template <typename F>
+        void DoOnce(F&& op, const NBench::NCpu::TParams& iface) {
+            for (size_t i = 0; i < iface.Iterations(); ++i) {
+                Y_UNUSED(i);
+                Y_DO_NOT_OPTIMIZE_AWAY(op(Data1_.Data(), Data2_.Data(), Data1_.Length()));
+            }
+        }
+
     private:
         TData1 Data1_;
         TData2 Data2_;
@@ -295,4 +305,36 @@ namespace {
         Bench30000_double.Do(L2SqrDistance, iface);
     }
 
+    // One call over the whole vectors per iteration, 2 * count * sizeof(Number) bytes are read.
+    const NL2DistanceImpl::TL2DistanceKernels* FindKernels(TStringBuf name) {
+        for (const NL2DistanceImpl::TL2DistanceKernels* kernels : NL2DistanceImpl::GetSupportedKernels()) {
+            if (name == kernels->Name) {
+                return kernels;
+            }
+        }
+        return nullptr;
+    }
+
+    // does nothing when cpu does not support the instruction set
+#define L_TEST_ISA(cnt, type, isa, name, kernel)                \
+    Y_CPU_BENCHMARK(isa##cnt##_##type, iface) {                 \
+        if (const auto* kernels = FindKernels(name)) {          \
+            Bench##cnt##_##type.DoOnce(kernels->kernel, iface); \
+        }                                                       \
+    }
+
+#define L_ISA_TYPES(cnt, isa, name)                       \
+    L_TEST_ISA(cnt, i8, isa, name, L2SqrDistanceI8)       \
+    L_TEST_ISA(cnt, ui8, isa, name, L2SqrDistanceUi8)     \
+    L_TEST_ISA(cnt, float, isa, name, L2SqrDistanceFloat) \
+    L_TEST_ISA(cnt, double, isa, name, L2SqrDistanceDouble)
+
+    L_ISA_TYPES(1000, Sse, "sse")
+    L_ISA_TYPES(1000, Avx2, "avx2")
+    L_ISA_TYPES(1000, Avx512, "avx512")
+    L_ISA_TYPES(1000, Avx512Vnni, "avx512vnni")
+    L_ISA_TYPES(30000, Sse, "sse")
+    L_ISA_TYPES(30000, Avx2, "avx2")
+    L_ISA_TYPES(30000, Avx512, "avx512")
+    L_ISA_TYPES(30000, Avx512Vnni, "avx512vnni")
 }
@@ -1,9 +1,13 @@
 #include "l2_distance.h"
+#include "l2_distance_simd.h"
 
 #include <library/cpp/sse/sse.h>
 
 #include <contrib/libs/cblas/cblas.h>
 
+#include <util/generic/utility.h>
+#include <util/system/compiler.h>
+#include <util/system/cpu_id.h>
 #include <util/system/platform.h>
 
 template <typename Result, typename Number>
@@ -82,20 +86,19 @@ namespace NL2Distance {
     static const __m128i MASK_UI4_2 = _mm_set_epi8(0xf0, 0xf0, 0xf0, 0xf0, 0xf0, 0xf0, 0xf0, 0xf0, 0xf0, 0xf0, 0xf0,
                                                    0xf0, 0xf0, 0xf0, 0xf0, 0xf0);
 }
-ui32 L2SqrDistance(const i8* lhs, const i8* rhs, int length) {
+static ui32 L2SqrDistanceSse(const i8* lhs, const i8* rhs, int length) {
     const __m128i zero = _mm_setzero_si128();
+    const __m128i signBit = _mm_set1_epi8(-128);
     __m128i resVec = zero;
 
     while (length >= 16) {
-        __m128i vec = _mm_subs_epi8(_mm_loadu_si128((const __m128i*)lhs), _mm_loadu_si128((const __m128i*)rhs));
+        // shifted to unsigned, |a - b| is exact in a byte
+        __m128i lVec = _mm_xor_si128(_mm_loadu_si128((const __m128i*)lhs), signBit);
+        __m128i rVec = _mm_xor_si128(_mm_loadu_si128((const __m128i*)rhs), signBit);
+        __m128i vec = _mm_or_si128(_mm_subs_epu8(lVec, rVec), _mm_subs_epu8(rVec, lVec));
 
-#ifdef _sse4_1_
-        __m128i lo = _mm_cvtepi8_epi16(vec);
-        __m128i hi = _mm_cvtepi8_epi16(_mm_alignr_epi8(vec, vec, 8));
-#else
-        __m128i lo = _mm_srai_epi16(_mm_unpacklo_epi8(zero, vec), 8);
-        __m128i hi = _mm_srai_epi16(_mm_unpackhi_epi8(zero, vec), 8);
-#endif
+        __m128i lo = _mm_unpacklo_epi8(vec, zero);
+        __m128i hi = _mm_unpackhi_epi8(vec, zero);
 
         resVec = _mm_add_epi32(resVec,
                                _mm_add_epi32(_mm_madd_epi16(lo, lo), _mm_madd_epi16(hi, hi)));
@@ -115,7 +118,7 @@ ui32 L2SqrDistance(const i8* lhs, const i8* rhs, int length) {
     return sum;
 }
 
-ui32 L2SqrDistance(const ui8* lhs, const ui8* rhs, int length) {
+static ui32 L2SqrDistanceSse(const ui8* lhs, const ui8* rhs, int length) {
     const __m128i zero = _mm_setzero_si128();
     __m128i resVec = zero;
 
@@ -145,7 +148,7 @@ ui32 L2SqrDistance(const ui8* lhs, const ui8* rhs, int length) {
     return sum;
 }
 
-float L2SqrDistance(const float* lhs, const float* rhs, int length) {
+static float L2SqrDistanceSse(const float* lhs, const float* rhs, int length) {
     __m128 sum = _mm_setzero_ps();
 
     while (length >= 4) {
@@ -167,7 +170,7 @@ float L2SqrDistance(const float* lhs, const float* rhs, int length) {
     return res[0] + res[1] + res[2] + res[3];
 }
 
-double L2SqrDistance(const double* lhs, const double* rhs, int length) {
+static double L2SqrDistanceSse(const double* lhs, const double* rhs, int length) {
     __m128d sum = _mm_setzero_pd();
 
     while (length >= 2) {
@@ -317,14 +320,6 @@ ui32 L2SqrDistanceUI4(const ui8* lhs, const ui8* rhs, int length) {
 
 #else /* !ARCADIA_SSE */
 
-ui32 L2SqrDistance(const i8* lhs, const i8* rhs, int length) {
-    return L2SqrDistanceImpl<ui32, i8>(lhs, rhs, length);
-}
-
-ui32 L2SqrDistance(const ui8* lhs, const ui8* rhs, int length) {
-    return L2SqrDistanceImpl<ui32, ui8>(lhs, rhs, length);
-}
-
 ui64 L2SqrDistance(const i32* a, const i32* b, int length) {
     return L2SqrDistanceImpl2<ui64, i32>(a, b, length);
 }
@@ -333,14 +328,6 @@ ui64 L2SqrDistance(const ui32* a, const ui32* b, int length) {
     return L2SqrDistanceImpl2<ui64, ui32>(a, b, length);
 }
 
-float L2SqrDistance(const float* a, const float* b, int length) {
-    return L2SqrDistanceImpl4<float, float>(a, b, length);
-}
-
-double L2SqrDistance(const double* a, const double* b, int length) {
-    return L2SqrDistanceImpl2<double, double>(a, b, length);
-}
-
 ui32 L2SqrDistanceUI4(const ui8* lhs, const ui8* rhs, int length) {
     return L2SqrDistanceImplUI4(lhs, rhs, length);
 }
@@ -374,3 +361,156 @@ double L2SqrDistanceSlow(const double* a, const double* b, int length) {
 ui32 L2SqrDistanceUI4Slow(const ui8* lhs, const ui8* rhs, int length) {
     return L2SqrDistanceImplUI4(lhs, rhs, length);
 }
+
+namespace NL2DistanceImpl {
+    namespace {
+        // kernels of one query against 4 rows for instruction sets without a dedicated implementation
+        template <typename TResult, typename TNumber, TResult (*L2SqrDistancePair)(const TNumber*, const TNumber*, int)>
+        void L2SqrDistanceX4ByPairs(const TNumber* query, const TNumber* rows, int length, TResult* result) {
+            for (int k = 0; k < 4; ++k) {
+                result[k] = L2SqrDistancePair(query, rows + k * length, length);
+            }
+        }
+
+#ifdef ARCADIA_SSE
+        constexpr TL2DistanceKernels BaselineKernels = {
+            "sse", L2SqrDistanceSse, L2SqrDistanceSse, L2SqrDistanceSse, L2SqrDistanceSse,
+            L2SqrDistanceX4ByPairs<ui32, i8, L2SqrDistanceSse>, L2SqrDistanceX4ByPairs<ui32, ui8, L2SqrDistanceSse>,
+            L2SqrDistanceX4ByPairs<float, float, L2SqrDistanceSse>, L2SqrDistanceX4ByPairs<ui32, ui8, L2SqrDistanceUI4>};
+#else
+        constexpr TL2DistanceKernels BaselineKernels = {
+            "slow", L2SqrDistanceSlow, L2SqrDistanceSlow, L2SqrDistanceSlow, L2SqrDistanceSlow,
+            L2SqrDistanceX4ByPairs<ui32, i8, L2SqrDistanceSlow>, L2SqrDistanceX4ByPairs<ui32, ui8, L2SqrDistanceSlow>,
+            L2SqrDistanceX4ByPairs<float, float, L2SqrDistanceSlow>, L2SqrDistanceX4ByPairs<ui32, ui8, L2SqrDistanceUI4>};
+#endif
+
+#if defined(_x86_64_)
+        constexpr TL2DistanceKernels Avx2Kernels = {
+            "avx2", NAvx2::L2SqrDistance, NAvx2::L2SqrDistance, NAvx2::L2SqrDistance, NAvx2::L2SqrDistance,
+            NAvx2::L2SqrDistanceX4, NAvx2::L2SqrDistanceX4, NAvx2::L2SqrDistanceX4, NAvx2::L2SqrDistanceUI4X4};
+
+        constexpr TL2DistanceKernels Avx512Kernels = {
+            "avx512", NAvx512::L2SqrDistance, NAvx512::L2SqrDistance, NAvx512::L2SqrDistance, NAvx512::L2SqrDistance,
+            NAvx512::L2SqrDistanceX4, NAvx512::L2SqrDistanceX4, NAvx512::L2SqrDistanceX4, NAvx512::L2SqrDistanceUI4X4};
+
+        constexpr TL2DistanceKernels Avx512VnniKernels = {
+            "avx512vnni", NAvx512Vnni::L2SqrDistance, NAvx512Vnni::L2SqrDistance, NAvx512::L2SqrDistance, NAvx512::L2SqrDistance,
+            NAvx512::L2SqrDistanceX4, NAvx512::L2SqrDistanceX4, NAvx512::L2SqrDistanceX4, NAvx512::L2SqrDistanceUI4X4};
+#endif
+
+        struct TSupportedKernels {
+            const TL2DistanceKernels* Kernels[4];
+            size_t Count = 0;
+
+            TSupportedKernels() noexcept {
+                Kernels[Count++] = &BaselineKernels;
+#if defined(_x86_64_)
+                if (NX86::CachedHaveAVX2()) {
+                    Kernels[Count++] = &Avx2Kernels;
+                }
+                if (NX86::CachedHaveAVX512F() && NX86::CachedHaveAVX512BW() && NX86::CachedHaveAVX512DQ() && NX86::CachedHaveAVX512VL()) {
+                    Kernels[Count++] = &Avx512Kernels;
+                    if (NX86::CachedHaveAVX512VNNI()) {
+                        Kernels[Count++] = &Avx512VnniKernels;
+                    }
+                }
+#endif
+            }
+        };
+    }
+
+    TArrayRef<const TL2DistanceKernels* const> GetSupportedKernels() noexcept {
+        static const TSupportedKernels supported;
+        return {supported.Kernels, supported.Count};
+    }
+
+    const TL2DistanceKernels& GetBestKernels() noexcept {
+        static const TL2DistanceKernels* const best = GetSupportedKernels().back();
+        return *best;
+    }
+}
+
+ui32 L2SqrDistance(const i8* lhs, const i8* rhs, int length) {
+    return NL2DistanceImpl::GetBestKernels().L2SqrDistanceI8(lhs, rhs, length);
+}
+
+ui32 L2SqrDistance(const ui8* lhs, const ui8* rhs, int length) {
+    return NL2DistanceImpl::GetBestKernels().L2SqrDistanceUi8(lhs, rhs, length);
+}
+
+float L2SqrDistance(const float* lhs, const float* rhs, int length) {
+    return NL2DistanceImpl::GetBestKernels().L2SqrDistanceFloat(lhs, rhs, length);
+}
+
+double L2SqrDistance(const double* lhs, const double* rhs, int length) {
+    return NL2DistanceImpl::GetBestKernels().L2SqrDistanceDouble(lhs, rhs, length);
+}
+
+namespace {
+    // rhs rows are processed by blocks of this size so that a block stays in cache for all lhs rows
+    constexpr size_t MatrixBlockBytes = 64 * 1024;
+
+    template <typename TResult, typename TNumber, typename TKernelX4, typename TKernel>
+    void L2SqrDistanceBatchImpl(TKernelX4 kernelX4, TKernel kernel, const TNumber* query, const TNumber* rows, size_t rowCount, int length, TResult* result) {
+        size_t i = 0;
+        for (; i + 4 <= rowCount; i += 4) {
+            const TNumber* next = rows + (i + 4) * length;
+            for (size_t k = 0; k < 4 && i + 4 + k < rowCount; ++k) {
+                Y_PREFETCH_READ(next + k * length, 3);
+            }
+            kernelX4(query, rows + i * length, length, result + i);
+        }
+        for (; i < rowCount; ++i) {
+            result[i] = kernel(query, rows + i * length, length);
+        }
+    }
+
+    template <typename TResult, typename TNumber, typename TKernelX4, typename TKernel>
+    void L2SqrDistanceMatrixImpl(TKernelX4 kernelX4, TKernel kernel, const TNumber* lhs, size_t lhsCount, const TNumber* rhs, size_t rhsCount, int length, TResult* result) {
+        const size_t blockRows = Max<size_t>(4, MatrixBlockBytes / Max<size_t>(1, length * sizeof(TNumber)) / 4 * 4);
+        for (size_t j = 0; j < rhsCount; j += blockRows) {
+            const size_t blockCount = Min(blockRows, rhsCount - j);
+            for (size_t i = 0; i < lhsCount; ++i) {
+                L2SqrDistanceBatchImpl(kernelX4, kernel, lhs + i * length, rhs + j * length, blockCount, length, result + i * rhsCount + j);
+            }
+        }
+    }
+}
+
+void L2SqrDistanceBatch(const i8* query, const i8* rows, size_t rowCount, int length, ui32* result) {
+    const auto& kernels = NL2DistanceImpl::GetBestKernels();
+    L2SqrDistanceBatchImpl(kernels.L2SqrDistanceX4I8, kernels.L2SqrDistanceI8, query, rows, rowCount, length, result);
+}
+
+void L2SqrDistanceBatch(const ui8* query, const ui8* rows, size_t rowCount, int length, ui32* result) {
+    const auto& kernels = NL2DistanceImpl::GetBestKernels();
+    L2SqrDistanceBatchImpl(kernels.L2SqrDistanceX4Ui8, kernels.L2SqrDistanceUi8, query, rows, rowCount, length, result);
+}
+
+void L2SqrDistanceBatch(const float* query, const float* rows, size_t rowCount, int length, float* result) {
+    const auto& kernels = NL2DistanceImpl::GetBestKernels();
+    L2SqrDistanceBatchImpl(kernels.L2SqrDistanceX4Float, kernels.L2SqrDistanceFloat, query, rows, rowCount, length, result);
+}
+
+void L2SqrDistanceUI4Batch(const ui8* query, const ui8* rows, size_t rowCount, int lengthInBytes, ui32* result) {
+    L2SqrDistanceBatchImpl(NL2DistanceImpl::GetBestKernels().L2SqrDistanceUI4X4, L2SqrDistanceUI4, query, rows, rowCount, lengthInBytes, result);
+}
+
+void L2SqrDistanceMatrix(const i8* lhs, size_t lhsCount, const i8* rhs, size_t rhsCount, int length, ui32* result) {
+    const auto& kernels = NL2DistanceImpl::GetBestKernels();
+    L2SqrDistanceMatrixImpl(kernels.L2SqrDistanceX4I8, kernels.L2SqrDistanceI8, lhs, lhsCount, rhs, rhsCount, length, result);
+}
+
+void L2SqrDistanceMatrix(const ui8* lhs, size_t lhsCount, const ui8* rhs, size_t rhsCount, int length, ui32* result) {
+    const auto& kernels = NL2DistanceImpl::GetBestKernels();
+    L2SqrDistanceMatrixImpl(kernels.L2SqrDistanceX4Ui8, kernels.L2SqrDistanceUi8, lhs, lhsCount, rhs, rhsCount, length, result);
+}
+
+void L2SqrDistanceMatrix(const float* lhs, size_t lhsCount, const float* rhs, size_t rhsCount, int length, float* result) {
+    const auto& kernels = NL2DistanceImpl::GetBestKernels();
+    L2SqrDistanceMatrixImpl(kernels.L2SqrDistanceX4Float, kernels.L2SqrDistanceFloat, lhs, lhsCount, rhs, rhsCount, length, result);
+}
+
+void L2SqrDistanceUI4Matrix(const ui8* lhs, size_t lhsCount, const ui8* rhs, size_t rhsCount, int lengthInBytes, ui32* result) {
+    L2SqrDistanceMatrixImpl(NL2DistanceImpl::GetBestKernels().L2SqrDistanceUI4X4, L2SqrDistanceUI4, lhs, lhsCount, rhs, rhsCount, lengthInBytes, result);
+}
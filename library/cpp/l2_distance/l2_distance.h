@@ -93,6 +93,29 @@ float L2SqrDistanceSlow(const float* a, const float* b, int length);
 double L2SqrDistanceSlow(const double* a, const double* b, int length);
 ui32 L2SqrDistanceUI4Slow(const ui8* a, const ui8* b, int cnt);
 
+/**
+ * Squared l2 distances from `query` to `rowCount` rows of a row-major matrix of `length` columns:
+ * result[i] = L2SqrDistance(query, rows + i * length, length).
+ * The query is reused from registers for 4 rows at once, the last rowCount % 4 rows are computed one by one.
+ * Float results may differ from L2SqrDistance in the last bits: 4-row kernels add in a different order.
+ */
+void L2SqrDistanceBatch(const i8* query, const i8* rows, size_t rowCount, int length, ui32* result);
+void L2SqrDistanceBatch(const ui8* query, const ui8* rows, size_t rowCount, int length, ui32* result);
+void L2SqrDistanceBatch(const float* query, const float* rows, size_t rowCount, int length, float* result);
+void L2SqrDistanceUI4Batch(const ui8* query, const ui8* rows, size_t rowCount, int lengthInBytes, ui32* result);
+
+/**
+ * Squared l2 distances between every row of `lhs` and every row of `rhs`, both row-major with `length` columns:
+ * result[i * rhsCount + j] = L2SqrDistance(lhs + i * length, rhs + j * length, length).
+ * Every `lhs` row is run as a batch over a 64 KiB block of `rhs` rows, so the block stays in cache;
+ * register blocking is 1 x 4 as in the batch, there is no M x N tiling. Float results are not
+ * bit-identical to L2SqrDistance, see the batch version.
+ */
+void L2SqrDistanceMatrix(const i8* lhs, size_t lhsCount, const i8* rhs, size_t rhsCount, int length, ui32* result);
+void L2SqrDistanceMatrix(const ui8* lhs, size_t lhsCount, const ui8* rhs, size_t rhsCount, int length, ui32* result);
+void L2SqrDistanceMatrix(const float* lhs, size_t lhsCount, const float* rhs, size_t rhsCount, int length, float* result);
+void L2SqrDistanceUI4Matrix(const ui8* lhs, size_t lhsCount, const ui8* rhs, size_t rhsCount, int lengthInBytes, ui32* result);
+
 /**
  * L2 distance = sqrt(sum((a[i]-b[i])^2))
  */
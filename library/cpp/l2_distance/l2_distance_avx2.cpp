@@ -0,0 +1,298 @@
+#include "l2_distance_simd.h"
+
+#include <immintrin.h>
+
+#include <type_traits>
+
+namespace {
+    Y_FORCE_INLINE i32 HorizontalSumI32(__m256i v) {
+        __m128i x = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+        x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+        x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(x);
+    }
+
+    Y_FORCE_INLINE float HorizontalSum(__m256 v) {
+        __m128 x = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        x = _mm_add_ps(x, _mm_movehl_ps(x, x));
+        x = _mm_add_ss(x, _mm_movehdup_ps(x));
+        return _mm_cvtss_f32(x);
+    }
+
+    Y_FORCE_INLINE double HorizontalSum(__m256d v) {
+        __m128d x = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+        x = _mm_add_sd(x, _mm_unpackhi_pd(x, x));
+        return _mm_cvtsd_f64(x);
+    }
+
+    // |a - b| of unsigned bytes is exact in a byte, its square is summed as i16 pairs
+    Y_FORCE_INLINE __m256i AddSqrDelta(__m256i sum, __m256i a, __m256i b) {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i delta = _mm256_or_si256(_mm256_subs_epu8(a, b), _mm256_subs_epu8(b, a));
+        const __m256i lo = _mm256_unpacklo_epi8(delta, zero);
+        const __m256i hi = _mm256_unpackhi_epi8(delta, zero);
+        return _mm256_add_epi32(sum, _mm256_add_epi32(_mm256_madd_epi16(lo, lo), _mm256_madd_epi16(hi, hi)));
+    }
+
+    template <typename T>
+    Y_FORCE_INLINE __m256i LoadUnsigned(const T* p) {
+        const __m256i v = _mm256_loadu_si256((const __m256i*)p);
+        if constexpr (std::is_signed<T>::value) {
+            return _mm256_xor_si256(v, _mm256_set1_epi8(-128));
+        } else {
+            return v;
+        }
+    }
+
+    template <typename T>
+    Y_FORCE_INLINE ui32 L2SqrDistanceBytes(const T* a, const T* b, int length) {
+        __m256i sum0 = _mm256_setzero_si256();
+        __m256i sum1 = _mm256_setzero_si256();
+
+        while (length >= 64) {
+            sum0 = AddSqrDelta(sum0, LoadUnsigned(a), LoadUnsigned(b));
+            sum1 = AddSqrDelta(sum1, LoadUnsigned(a + 32), LoadUnsigned(b + 32));
+            a += 64;
+            b += 64;
+            length -= 64;
+        }
+
+        if (length >= 32) {
+            sum0 = AddSqrDelta(sum0, LoadUnsigned(a), LoadUnsigned(b));
+            a += 32;
+            b += 32;
+            length -= 32;
+        }
+
+        ui32 sum = static_cast<ui32>(HorizontalSumI32(_mm256_add_epi32(sum0, sum1)));
+        for (int i = 0; i < length; ++i) {
+            const i32 delta = static_cast<i32>(a[i]) - static_cast<i32>(b[i]);
+            sum += static_cast<ui32>(delta * delta);
+        }
+        return sum;
+    }
+
+    // {sum(a), sum(b), sum(c), sum(d)}
+    Y_FORCE_INLINE __m128 HorizontalSum4(__m256 a, __m256 b, __m256 c, __m256 d) {
+        const __m256 abcd = _mm256_hadd_ps(_mm256_hadd_ps(a, b), _mm256_hadd_ps(c, d));
+        return _mm_add_ps(_mm256_castps256_ps128(abcd), _mm256_extractf128_ps(abcd, 1));
+    }
+
+    Y_FORCE_INLINE __m128i HorizontalSum4I32(__m256i a, __m256i b, __m256i c, __m256i d) {
+        const __m256i abcd = _mm256_hadd_epi32(_mm256_hadd_epi32(a, b), _mm256_hadd_epi32(c, d));
+        return _mm_add_epi32(_mm256_castsi256_si128(abcd), _mm256_extracti128_si256(abcd, 1));
+    }
+
+    // the query is loaded once for 4 rows, each row has its own accumulator
+    template <typename T>
+    Y_FORCE_INLINE void L2SqrDistanceX4Bytes(const T* query, const T* rows, int length, ui32* result) {
+        const T* r0 = rows;
+        const T* r1 = rows + length;
+        const T* r2 = rows + 2 * length;
+        const T* r3 = rows + 3 * length;
+        __m256i sum0 = _mm256_setzero_si256();
+        __m256i sum1 = _mm256_setzero_si256();
+        __m256i sum2 = _mm256_setzero_si256();
+        __m256i sum3 = _mm256_setzero_si256();
+
+        int i = 0;
+        for (; i + 32 <= length; i += 32) {
+            const __m256i q = LoadUnsigned(query + i);
+            sum0 = AddSqrDelta(sum0, q, LoadUnsigned(r0 + i));
+            sum1 = AddSqrDelta(sum1, q, LoadUnsigned(r1 + i));
+            sum2 = AddSqrDelta(sum2, q, LoadUnsigned(r2 + i));
+            sum3 = AddSqrDelta(sum3, q, LoadUnsigned(r3 + i));
+        }
+
+        alignas(16) ui32 sums[4];
+        _mm_store_si128((__m128i*)sums, HorizontalSum4I32(sum0, sum1, sum2, sum3));
+        for (int k = 0; k < 4; ++k) {
+            const T* row = rows + k * length;
+            for (int j = i; j < length; ++j) {
+                const i32 delta = static_cast<i32>(query[j]) - static_cast<i32>(row[j]);
+                sums[k] += static_cast<ui32>(delta * delta);
+            }
+            result[k] = sums[k];
+        }
+    }
+
+    // squares of nibble deltas fit signed bytes, so maddubs sums of two of them are exact
+    Y_FORCE_INLINE __m256i NibbleSqrDelta(__m256i queryLo, __m256i queryHi, __m256i row) {
+        const __m256i lowNibbles = _mm256_set1_epi8(0x0f);
+        const __m256i rowLo = _mm256_and_si256(row, lowNibbles);
+        const __m256i rowHi = _mm256_and_si256(_mm256_srli_epi16(row, 4), lowNibbles);
+        const __m256i deltaLo = _mm256_or_si256(_mm256_subs_epu8(queryLo, rowLo), _mm256_subs_epu8(rowLo, queryLo));
+        const __m256i deltaHi = _mm256_or_si256(_mm256_subs_epu8(queryHi, rowHi), _mm256_subs_epu8(rowHi, queryHi));
+        const __m256i pairs = _mm256_add_epi16(_mm256_maddubs_epi16(deltaLo, deltaLo), _mm256_maddubs_epi16(deltaHi, deltaHi));
+        return _mm256_madd_epi16(pairs, _mm256_set1_epi16(1));
+    }
+}
+
+namespace NL2DistanceImpl::NAvx2 {
+    ui32 L2SqrDistance(const i8* a, const i8* b, int length) {
+        return L2SqrDistanceBytes(a, b, length);
+    }
+
+    ui32 L2SqrDistance(const ui8* a, const ui8* b, int length) {
+        return L2SqrDistanceBytes(a, b, length);
+    }
+
+    float L2SqrDistance(const float* a, const float* b, int length) {
+        __m256 sum0 = _mm256_setzero_ps();
+        __m256 sum1 = _mm256_setzero_ps();
+        __m256 sum2 = _mm256_setzero_ps();
+        __m256 sum3 = _mm256_setzero_ps();
+        __m256 d0, d1, d2, d3;
+
+        while (length >= 32) {
+            d0 = _mm256_sub_ps(_mm256_loadu_ps(a), _mm256_loadu_ps(b));
+            d1 = _mm256_sub_ps(_mm256_loadu_ps(a + 8), _mm256_loadu_ps(b + 8));
+            d2 = _mm256_sub_ps(_mm256_loadu_ps(a + 16), _mm256_loadu_ps(b + 16));
+            d3 = _mm256_sub_ps(_mm256_loadu_ps(a + 24), _mm256_loadu_ps(b + 24));
+            sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(d0, d0));
+            sum1 = _mm256_add_ps(sum1, _mm256_mul_ps(d1, d1));
+            sum2 = _mm256_add_ps(sum2, _mm256_mul_ps(d2, d2));
+            sum3 = _mm256_add_ps(sum3, _mm256_mul_ps(d3, d3));
+            a += 32;
+            b += 32;
+            length -= 32;
+        }
+
+        while (length >= 8) {
+            d0 = _mm256_sub_ps(_mm256_loadu_ps(a), _mm256_loadu_ps(b));
+            sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(d0, d0));
+            a += 8;
+            b += 8;
+            length -= 8;
+        }
+
+        if (length) {
+            const __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(length), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+            d1 = _mm256_sub_ps(_mm256_maskload_ps(a, mask), _mm256_maskload_ps(b, mask));
+            sum1 = _mm256_add_ps(sum1, _mm256_mul_ps(d1, d1));
+        }
+
+        return HorizontalSum(_mm256_add_ps(_mm256_add_ps(sum0, sum1), _mm256_add_ps(sum2, sum3)));
+    }
+
+    double L2SqrDistance(const double* a, const double* b, int length) {
+        __m256d sum0 = _mm256_setzero_pd();
+        __m256d sum1 = _mm256_setzero_pd();
+        __m256d sum2 = _mm256_setzero_pd();
+        __m256d sum3 = _mm256_setzero_pd();
+        __m256d d0, d1, d2, d3;
+
+        while (length >= 16) {
+            d0 = _mm256_sub_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b));
+            d1 = _mm256_sub_pd(_mm256_loadu_pd(a + 4), _mm256_loadu_pd(b + 4));
+            d2 = _mm256_sub_pd(_mm256_loadu_pd(a + 8), _mm256_loadu_pd(b + 8));
+            d3 = _mm256_sub_pd(_mm256_loadu_pd(a + 12), _mm256_loadu_pd(b + 12));
+            sum0 = _mm256_add_pd(sum0, _mm256_mul_pd(d0, d0));
+            sum1 = _mm256_add_pd(sum1, _mm256_mul_pd(d1, d1));
+            sum2 = _mm256_add_pd(sum2, _mm256_mul_pd(d2, d2));
+            sum3 = _mm256_add_pd(sum3, _mm256_mul_pd(d3, d3));
+            a += 16;
+            b += 16;
+            length -= 16;
+        }
+
+        while (length >= 4) {
+            d0 = _mm256_sub_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b));
+            sum0 = _mm256_add_pd(sum0, _mm256_mul_pd(d0, d0));
+            a += 4;
+            b += 4;
+            length -= 4;
+        }
+
+        if (length) {
+            const __m256i mask = _mm256_cmpgt_epi64(_mm256_set1_epi64x(length), _mm256_setr_epi64x(0, 1, 2, 3));
+            d1 = _mm256_sub_pd(_mm256_maskload_pd(a, mask), _mm256_maskload_pd(b, mask));
+            sum1 = _mm256_add_pd(sum1, _mm256_mul_pd(d1, d1));
+        }
+
+        return HorizontalSum(_mm256_add_pd(_mm256_add_pd(sum0, sum1), _mm256_add_pd(sum2, sum3)));
+    }
+
+    void L2SqrDistanceX4(const i8* query, const i8* rows, int length, ui32* result) {
+        L2SqrDistanceX4Bytes(query, rows, length, result);
+    }
+
+    void L2SqrDistanceX4(const ui8* query, const ui8* rows, int length, ui32* result) {
+        L2SqrDistanceX4Bytes(query, rows, length, result);
+    }
+
+    void L2SqrDistanceX4(const float* query, const float* rows, int length, float* result) {
+        const float* r0 = rows;
+        const float* r1 = rows + length;
+        const float* r2 = rows + 2 * length;
+        const float* r3 = rows + 3 * length;
+        __m256 sum0 = _mm256_setzero_ps();
+        __m256 sum1 = _mm256_setzero_ps();
+        __m256 sum2 = _mm256_setzero_ps();
+        __m256 sum3 = _mm256_setzero_ps();
+        __m256 d0, d1, d2, d3;
+
+        int i = 0;
+        for (; i + 8 <= length; i += 8) {
+            const __m256 q = _mm256_loadu_ps(query + i);
+            d0 = _mm256_sub_ps(q, _mm256_loadu_ps(r0 + i));
+            d1 = _mm256_sub_ps(q, _mm256_loadu_ps(r1 + i));
+            d2 = _mm256_sub_ps(q, _mm256_loadu_ps(r2 + i));
+            d3 = _mm256_sub_ps(q, _mm256_loadu_ps(r3 + i));
+            sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(d0, d0));
+            sum1 = _mm256_add_ps(sum1, _mm256_mul_ps(d1, d1));
+            sum2 = _mm256_add_ps(sum2, _mm256_mul_ps(d2, d2));
+            sum3 = _mm256_add_ps(sum3, _mm256_mul_ps(d3, d3));
+        }
+
+        if (i < length) {
+            const __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(length - i), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+            const __m256 q = _mm256_maskload_ps(query + i, mask);
+            d0 = _mm256_sub_ps(q, _mm256_maskload_ps(r0 + i, mask));
+            d1 = _mm256_sub_ps(q, _mm256_maskload_ps(r1 + i, mask));
+            d2 = _mm256_sub_ps(q, _mm256_maskload_ps(r2 + i, mask));
+            d3 = _mm256_sub_ps(q, _mm256_maskload_ps(r3 + i, mask));
+            sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(d0, d0));
+            sum1 = _mm256_add_ps(sum1, _mm256_mul_ps(d1, d1));
+            sum2 = _mm256_add_ps(sum2, _mm256_mul_ps(d2, d2));
+            sum3 = _mm256_add_ps(sum3, _mm256_mul_ps(d3, d3));
+        }
+
+        _mm_storeu_ps(result, HorizontalSum4(sum0, sum1, sum2, sum3));
+    }
+
+    void L2SqrDistanceUI4X4(const ui8* query, const ui8* rows, int lengthInBytes, ui32* result) {
+        const ui8* r0 = rows;
+        const ui8* r1 = rows + lengthInBytes;
+        const ui8* r2 = rows + 2 * lengthInBytes;
+        const ui8* r3 = rows + 3 * lengthInBytes;
+        const __m256i lowNibbles = _mm256_set1_epi8(0x0f);
+        __m256i sum0 = _mm256_setzero_si256();
+        __m256i sum1 = _mm256_setzero_si256();
+        __m256i sum2 = _mm256_setzero_si256();
+        __m256i sum3 = _mm256_setzero_si256();
+
+        int i = 0;
+        for (; i + 32 <= lengthInBytes; i += 32) {
+            const __m256i q = _mm256_loadu_si256((const __m256i*)(query + i));
+            const __m256i qLo = _mm256_and_si256(q, lowNibbles);
+            const __m256i qHi = _mm256_and_si256(_mm256_srli_epi16(q, 4), lowNibbles);
+            sum0 = _mm256_add_epi32(sum0, NibbleSqrDelta(qLo, qHi, _mm256_loadu_si256((const __m256i*)(r0 + i))));
+            sum1 = _mm256_add_epi32(sum1, NibbleSqrDelta(qLo, qHi, _mm256_loadu_si256((const __m256i*)(r1 + i))));
+            sum2 = _mm256_add_epi32(sum2, NibbleSqrDelta(qLo, qHi, _mm256_loadu_si256((const __m256i*)(r2 + i))));
+            sum3 = _mm256_add_epi32(sum3, NibbleSqrDelta(qLo, qHi, _mm256_loadu_si256((const __m256i*)(r3 + i))));
+        }
+
+        alignas(16) ui32 sums[4];
+        _mm_store_si128((__m128i*)sums, HorizontalSum4I32(sum0, sum1, sum2, sum3));
+        for (int k = 0; k < 4; ++k) {
+            const ui8* row = rows + k * lengthInBytes;
+            for (int j = i; j < lengthInBytes; ++j) {
+                const i32 deltaLo = static_cast<i32>(query[j] & 0x0f) - static_cast<i32>(row[j] & 0x0f);
+                const i32 deltaHi = static_cast<i32>(query[j] >> 4) - static_cast<i32>(row[j] >> 4);
+                sums[k] += static_cast<ui32>(deltaLo * deltaLo + deltaHi * deltaHi);
+            }
+            result[k] = sums[k];
+        }
+    }
+}
@@ -0,0 +1,250 @@
+#include "l2_distance_simd.h"
+
+#include <immintrin.h>
+
+#include <type_traits>
+
+namespace {
+    Y_FORCE_INLINE __mmask64 TailMask(int length) {
+        return length ? (__mmask64)(~0ull >> (64 - length)) : 0;
+    }
+
+    // |a - b| of unsigned bytes is exact in a byte, its square is summed as i16 pairs
+    Y_FORCE_INLINE __m512i AddSqrDelta(__m512i sum, __m512i a, __m512i b) {
+        const __m512i zero = _mm512_setzero_si512();
+        const __m512i delta = _mm512_or_si512(_mm512_subs_epu8(a, b), _mm512_subs_epu8(b, a));
+        const __m512i lo = _mm512_unpacklo_epi8(delta, zero);
+        const __m512i hi = _mm512_unpackhi_epi8(delta, zero);
+        return _mm512_add_epi32(sum, _mm512_add_epi32(_mm512_madd_epi16(lo, lo), _mm512_madd_epi16(hi, hi)));
+    }
+
+    template <typename T>
+    Y_FORCE_INLINE __m512i ToUnsigned(__m512i v) {
+        if constexpr (std::is_signed<T>::value) {
+            return _mm512_xor_si512(v, _mm512_set1_epi8(-128));
+        } else {
+            return v;
+        }
+    }
+
+    template <typename T>
+    Y_FORCE_INLINE ui32 L2SqrDistanceBytes(const T* a, const T* b, int length) {
+        __m512i sum0 = _mm512_setzero_si512();
+        __m512i sum1 = _mm512_setzero_si512();
+
+        while (length >= 128) {
+            sum0 = AddSqrDelta(sum0, ToUnsigned<T>(_mm512_loadu_si512(a)), ToUnsigned<T>(_mm512_loadu_si512(b)));
+            sum1 = AddSqrDelta(sum1, ToUnsigned<T>(_mm512_loadu_si512(a + 64)), ToUnsigned<T>(_mm512_loadu_si512(b + 64)));
+            a += 128;
+            b += 128;
+            length -= 128;
+        }
+
+        if (length >= 64) {
+            sum0 = AddSqrDelta(sum0, ToUnsigned<T>(_mm512_loadu_si512(a)), ToUnsigned<T>(_mm512_loadu_si512(b)));
+            a += 64;
+            b += 64;
+            length -= 64;
+        }
+
+        if (length) {
+            // zeroed lanes of both vectors give zero delta
+            const __mmask64 mask = TailMask(length);
+            sum1 = AddSqrDelta(sum1, ToUnsigned<T>(_mm512_maskz_loadu_epi8(mask, a)), ToUnsigned<T>(_mm512_maskz_loadu_epi8(mask, b)));
+        }
+
+        return static_cast<ui32>(_mm512_reduce_add_epi32(_mm512_add_epi32(sum0, sum1)));
+    }
+
+    // the query is loaded once for 4 rows, each row has its own accumulator
+    template <typename T>
+    Y_FORCE_INLINE void L2SqrDistanceX4Bytes(const T* query, const T* rows, int length, ui32* result) {
+        const T* r0 = rows;
+        const T* r1 = rows + length;
+        const T* r2 = rows + 2 * length;
+        const T* r3 = rows + 3 * length;
+        __m512i sum0 = _mm512_setzero_si512();
+        __m512i sum1 = _mm512_setzero_si512();
+        __m512i sum2 = _mm512_setzero_si512();
+        __m512i sum3 = _mm512_setzero_si512();
+
+        // zeroed lanes of the tail give zero delta
+        for (int i = 0; i < length; i += 64) {
+            const __mmask64 mask = length - i >= 64 ? ~0ull : TailMask(length - i);
+            const __m512i q = ToUnsigned<T>(_mm512_maskz_loadu_epi8(mask, query + i));
+            sum0 = AddSqrDelta(sum0, q, ToUnsigned<T>(_mm512_maskz_loadu_epi8(mask, r0 + i)));
+            sum1 = AddSqrDelta(sum1, q, ToUnsigned<T>(_mm512_maskz_loadu_epi8(mask, r1 + i)));
+            sum2 = AddSqrDelta(sum2, q, ToUnsigned<T>(_mm512_maskz_loadu_epi8(mask, r2 + i)));
+            sum3 = AddSqrDelta(sum3, q, ToUnsigned<T>(_mm512_maskz_loadu_epi8(mask, r3 + i)));
+        }
+
+        result[0] = static_cast<ui32>(_mm512_reduce_add_epi32(sum0));
+        result[1] = static_cast<ui32>(_mm512_reduce_add_epi32(sum1));
+        result[2] = static_cast<ui32>(_mm512_reduce_add_epi32(sum2));
+        result[3] = static_cast<ui32>(_mm512_reduce_add_epi32(sum3));
+    }
+
+    // squares of nibble deltas fit signed bytes, so maddubs sums of two of them are exact
+    Y_FORCE_INLINE __m512i NibbleSqrDelta(__m512i queryLo, __m512i queryHi, __m512i row) {
+        const __m512i lowNibbles = _mm512_set1_epi8(0x0f);
+        const __m512i rowLo = _mm512_and_si512(row, lowNibbles);
+        const __m512i rowHi = _mm512_and_si512(_mm512_srli_epi16(row, 4), lowNibbles);
+        const __m512i deltaLo = _mm512_or_si512(_mm512_subs_epu8(queryLo, rowLo), _mm512_subs_epu8(rowLo, queryLo));
+        const __m512i deltaHi = _mm512_or_si512(_mm512_subs_epu8(queryHi, rowHi), _mm512_subs_epu8(rowHi, queryHi));
+        const __m512i pairs = _mm512_add_epi16(_mm512_maddubs_epi16(deltaLo, deltaLo), _mm512_maddubs_epi16(deltaHi, deltaHi));
+        return _mm512_madd_epi16(pairs, _mm512_set1_epi16(1));
+    }
+}
+
+namespace NL2DistanceImpl::NAvx512 {
+    ui32 L2SqrDistance(const i8* a, const i8* b, int length) {
+        return L2SqrDistanceBytes(a, b, length);
+    }
+
+    ui32 L2SqrDistance(const ui8* a, const ui8* b, int length) {
+        return L2SqrDistanceBytes(a, b, length);
+    }
+
+    float L2SqrDistance(const float* a, const float* b, int length) {
+        __m512 sum0 = _mm512_setzero_ps();
+        __m512 sum1 = _mm512_setzero_ps();
+        __m512 sum2 = _mm512_setzero_ps();
+        __m512 sum3 = _mm512_setzero_ps();
+        __m512 d0, d1, d2, d3;
+
+        while (length >= 64) {
+            d0 = _mm512_sub_ps(_mm512_loadu_ps(a), _mm512_loadu_ps(b));
+            d1 = _mm512_sub_ps(_mm512_loadu_ps(a + 16), _mm512_loadu_ps(b + 16));
+            d2 = _mm512_sub_ps(_mm512_loadu_ps(a + 32), _mm512_loadu_ps(b + 32));
+            d3 = _mm512_sub_ps(_mm512_loadu_ps(a + 48), _mm512_loadu_ps(b + 48));
+            sum0 = _mm512_fmadd_ps(d0, d0, sum0);
+            sum1 = _mm512_fmadd_ps(d1, d1, sum1);
+            sum2 = _mm512_fmadd_ps(d2, d2, sum2);
+            sum3 = _mm512_fmadd_ps(d3, d3, sum3);
+            a += 64;
+            b += 64;
+            length -= 64;
+        }
+
+        while (length >= 16) {
+            d0 = _mm512_sub_ps(_mm512_loadu_ps(a), _mm512_loadu_ps(b));
+            sum0 = _mm512_fmadd_ps(d0, d0, sum0);
+            a += 16;
+            b += 16;
+            length -= 16;
+        }
+
+        if (length) {
+            const __mmask16 mask = (__mmask16)TailMask(length);
+            d1 = _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, a), _mm512_maskz_loadu_ps(mask, b));
+            sum1 = _mm512_fmadd_ps(d1, d1, sum1);
+        }
+
+        return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(sum0, sum1), _mm512_add_ps(sum2, sum3)));
+    }
+
+    double L2SqrDistance(const double* a, const double* b, int length) {
+        __m512d sum0 = _mm512_setzero_pd();
+        __m512d sum1 = _mm512_setzero_pd();
+        __m512d sum2 = _mm512_setzero_pd();
+        __m512d sum3 = _mm512_setzero_pd();
+        __m512d d0, d1, d2, d3;
+
+        while (length >= 32) {
+            d0 = _mm512_sub_pd(_mm512_loadu_pd(a), _mm512_loadu_pd(b));
+            d1 = _mm512_sub_pd(_mm512_loadu_pd(a + 8), _mm512_loadu_pd(b + 8));
+            d2 = _mm512_sub_pd(_mm512_loadu_pd(a + 16), _mm512_loadu_pd(b + 16));
+            d3 = _mm512_sub_pd(_mm512_loadu_pd(a + 24), _mm512_loadu_pd(b + 24));
+            sum0 = _mm512_fmadd_pd(d0, d0, sum0);
+            sum1 = _mm512_fmadd_pd(d1, d1, sum1);
+            sum2 = _mm512_fmadd_pd(d2, d2, sum2);
+            sum3 = _mm512_fmadd_pd(d3, d3, sum3);
+            a += 32;
+            b += 32;
+            length -= 32;
+        }
+
+        while (length >= 8) {
+            d0 = _mm512_sub_pd(_mm512_loadu_pd(a), _mm512_loadu_pd(b));
+            sum0 = _mm512_fmadd_pd(d0, d0, sum0);
+            a += 8;
+            b += 8;
+            length -= 8;
+        }
+
+        if (length) {
+            const __mmask8 mask = (__mmask8)TailMask(length);
+            d1 = _mm512_sub_pd(_mm512_maskz_loadu_pd(mask, a), _mm512_maskz_loadu_pd(mask, b));
+            sum1 = _mm512_fmadd_pd(d1, d1, sum1);
+        }
+
+        return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(sum0, sum1), _mm512_add_pd(sum2, sum3)));
+    }
+
+    void L2SqrDistanceX4(const i8* query, const i8* rows, int length, ui32* result) {
+        L2SqrDistanceX4Bytes(query, rows, length, result);
+    }
+
+    void L2SqrDistanceX4(const ui8* query, const ui8* rows, int length, ui32* result) {
+        L2SqrDistanceX4Bytes(query, rows, length, result);
+    }
+
+    void L2SqrDistanceX4(const float* query, const float* rows, int length, float* result) {
+        const float* r0 = rows;
+        const float* r1 = rows + length;
+        const float* r2 = rows + 2 * length;
+        const float* r3 = rows + 3 * length;
+        __m512 sum0 = _mm512_setzero_ps();
+        __m512 sum1 = _mm512_setzero_ps();
+        __m512 sum2 = _mm512_setzero_ps();
+        __m512 sum3 = _mm512_setzero_ps();
+        __m512 d0, d1, d2, d3;
+
+        for (int i = 0; i < length; i += 16) {
+            const __mmask16 mask = length - i >= 16 ? (__mmask16)0xffff : (__mmask16)TailMask(length - i);
+            const __m512 q = _mm512_maskz_loadu_ps(mask, query + i);
+            d0 = _mm512_sub_ps(q, _mm512_maskz_loadu_ps(mask, r0 + i));
+            d1 = _mm512_sub_ps(q, _mm512_maskz_loadu_ps(mask, r1 + i));
+            d2 = _mm512_sub_ps(q, _mm512_maskz_loadu_ps(mask, r2 + i));
+            d3 = _mm512_sub_ps(q, _mm512_maskz_loadu_ps(mask, r3 + i));
+            sum0 = _mm512_fmadd_ps(d0, d0, sum0);
+            sum1 = _mm512_fmadd_ps(d1, d1, sum1);
+            sum2 = _mm512_fmadd_ps(d2, d2, sum2);
+            sum3 = _mm512_fmadd_ps(d3, d3, sum3);
+        }
+
+        result[0] = _mm512_reduce_add_ps(sum0);
+        result[1] = _mm512_reduce_add_ps(sum1);
+        result[2] = _mm512_reduce_add_ps(sum2);
+        result[3] = _mm512_reduce_add_ps(sum3);
+    }
+
+    void L2SqrDistanceUI4X4(const ui8* query, const ui8* rows, int lengthInBytes, ui32* result) {
+        const ui8* r0 = rows;
+        const ui8* r1 = rows + lengthInBytes;
+        const ui8* r2 = rows + 2 * lengthInBytes;
+        const ui8* r3 = rows + 3 * lengthInBytes;
+        const __m512i lowNibbles = _mm512_set1_epi8(0x0f);
+        __m512i sum0 = _mm512_setzero_si512();
+        __m512i sum1 = _mm512_setzero_si512();
+        __m512i sum2 = _mm512_setzero_si512();
+        __m512i sum3 = _mm512_setzero_si512();
+
+        // zeroed lanes of the tail give zero delta
+        for (int i = 0; i < lengthInBytes; i += 64) {
+            const __mmask64 mask = lengthInBytes - i >= 64 ? ~0ull : TailMask(lengthInBytes - i);
+            const __m512i q = _mm512_maskz_loadu_epi8(mask, query + i);
+            const __m512i qLo = _mm512_and_si512(q, lowNibbles);
+            const __m512i qHi = _mm512_and_si512(_mm512_srli_epi16(q, 4), lowNibbles);
+            sum0 = _mm512_add_epi32(sum0, NibbleSqrDelta(qLo, qHi, _mm512_maskz_loadu_epi8(mask, r0 + i)));
+            sum1 = _mm512_add_epi32(sum1, NibbleSqrDelta(qLo, qHi, _mm512_maskz_loadu_epi8(mask, r1 + i)));
+            sum2 = _mm512_add_epi32(sum2, NibbleSqrDelta(qLo, qHi, _mm512_maskz_loadu_epi8(mask, r2 + i)));
+            sum3 = _mm512_add_epi32(sum3, NibbleSqrDelta(qLo, qHi, _mm512_maskz_loadu_epi8(mask, r3 + i)));
+        }
+
+        result[0] = static_cast<ui32>(_mm512_reduce_add_epi32(sum0));
+        result[1] = static_cast<ui32>(_mm512_reduce_add_epi32(sum1));
+        result[2] = static_cast<ui32>(_mm512_reduce_add_epi32(sum2));
+        result[3] = static_cast<ui32>(_mm512_reduce_add_epi32(sum3));
+    }
+}
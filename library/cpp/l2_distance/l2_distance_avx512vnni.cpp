@@ -0,0 +1,71 @@
+#include "l2_distance_simd.h"
+
+#include <immintrin.h>
+
+#include <type_traits>
+
+namespace {
+    Y_FORCE_INLINE __mmask64 TailMask(int length) {
+        return length ? (__mmask64)(~0ull >> (64 - length)) : 0;
+    }
+
+    // vpdpbusd multiplies unsigned bytes by signed ones, so the square of unsigned byte delta d is
+    // taken as d * (d ^ 0x80) + 128 * d, the sum of d is accumulated by vpdpbusd with a vector of ones
+    Y_FORCE_INLINE void AddSqrDelta(__m512i& sum, __m512i& correction, __m512i a, __m512i b) {
+        const __m512i delta = _mm512_or_si512(_mm512_subs_epu8(a, b), _mm512_subs_epu8(b, a));
+        sum = _mm512_dpbusd_epi32(sum, delta, _mm512_xor_si512(delta, _mm512_set1_epi8(-128)));
+        correction = _mm512_dpbusd_epi32(correction, delta, _mm512_set1_epi8(1));
+    }
+
+    template <typename T>
+    Y_FORCE_INLINE __m512i ToUnsigned(__m512i v) {
+        if constexpr (std::is_signed<T>::value) {
+            return _mm512_xor_si512(v, _mm512_set1_epi8(-128));
+        } else {
+            return v;
+        }
+    }
+
+    template <typename T>
+    Y_FORCE_INLINE ui32 L2SqrDistanceBytes(const T* a, const T* b, int length) {
+        __m512i sum0 = _mm512_setzero_si512();
+        __m512i sum1 = _mm512_setzero_si512();
+        __m512i correction0 = _mm512_setzero_si512();
+        __m512i correction1 = _mm512_setzero_si512();
+
+        while (length >= 128) {
+            AddSqrDelta(sum0, correction0, ToUnsigned<T>(_mm512_loadu_si512(a)), ToUnsigned<T>(_mm512_loadu_si512(b)));
+            AddSqrDelta(sum1, correction1, ToUnsigned<T>(_mm512_loadu_si512(a + 64)), ToUnsigned<T>(_mm512_loadu_si512(b + 64)));
+            a += 128;
+            b += 128;
+            length -= 128;
+        }
+
+        if (length >= 64) {
+            AddSqrDelta(sum0, correction0, ToUnsigned<T>(_mm512_loadu_si512(a)), ToUnsigned<T>(_mm512_loadu_si512(b)));
+            a += 64;
+            b += 64;
+            length -= 64;
+        }
+
+        if (length) {
+            // zeroed lanes of both vectors give zero delta
+            const __mmask64 mask = TailMask(length);
+            AddSqrDelta(sum1, correction1, ToUnsigned<T>(_mm512_maskz_loadu_epi8(mask, a)), ToUnsigned<T>(_mm512_maskz_loadu_epi8(mask, b)));
+        }
+
+        const ui32 sum = static_cast<ui32>(_mm512_reduce_add_epi32(_mm512_add_epi32(sum0, sum1)));
+        const ui32 correction = static_cast<ui32>(_mm512_reduce_add_epi32(_mm512_add_epi32(correction0, correction1)));
+        return sum + 128 * correction;
+    }
+}
+
+namespace NL2DistanceImpl::NAvx512Vnni {
+    ui32 L2SqrDistance(const i8* a, const i8* b, int length) {
+        return L2SqrDistanceBytes(a, b, length);
+    }
+
+    ui32 L2SqrDistance(const ui8* a, const ui8* b, int length) {
+        return L2SqrDistanceBytes(a, b, length);
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <util/generic/array_ref.h>
+#include <util/system/compiler.h>
+#include <util/system/platform.h>
+#include <util/system/types.h>
+
+/**
+ * Instruction set specific implementations of l2_distance.h functions.
+ * Public functions use the best set supported by cpu, it is chosen once on the first call.
+ */
+namespace NL2DistanceImpl {
+    struct TL2DistanceKernels {
+        const char* Name;
+        ui32 (*L2SqrDistanceI8)(const i8* a, const i8* b, int length);
+        ui32 (*L2SqrDistanceUi8)(const ui8* a, const ui8* b, int length);
+        float (*L2SqrDistanceFloat)(const float* a, const float* b, int length);
+        double (*L2SqrDistanceDouble)(const double* a, const double* b, int length);
+
+        // `query` against 4 consecutive rows of `length` elements starting at `rows`
+        void (*L2SqrDistanceX4I8)(const i8* query, const i8* rows, int length, ui32* result);
+        void (*L2SqrDistanceX4Ui8)(const ui8* query, const ui8* rows, int length, ui32* result);
+        void (*L2SqrDistanceX4Float)(const float* query, const float* rows, int length, float* result);
+        void (*L2SqrDistanceUI4X4)(const ui8* query, const ui8* rows, int lengthInBytes, ui32* result);
+    };
+
+    // Kernels supported by cpu, from the baseline (SSE or plain C++) to the best one.
+    TArrayRef<const TL2DistanceKernels* const> GetSupportedKernels() noexcept;
+
+    const TL2DistanceKernels& GetBestKernels() noexcept;
+
+#if defined(_x86_64_)
+    namespace NAvx2 {
+        ui32 L2SqrDistance(const i8* a, const i8* b, int length);
+        ui32 L2SqrDistance(const ui8* a, const ui8* b, int length);
+        float L2SqrDistance(const float* a, const float* b, int length);
+        double L2SqrDistance(const double* a, const double* b, int length);
+
+        void L2SqrDistanceX4(const i8* query, const i8* rows, int length, ui32* result);
+        void L2SqrDistanceX4(const ui8* query, const ui8* rows, int length, ui32* result);
+        void L2SqrDistanceX4(const float* query, const float* rows, int length, float* result);
+        void L2SqrDistanceUI4X4(const ui8* query, const ui8* rows, int lengthInBytes, ui32* result);
+    }
+
+    // requires AVX512F, AVX512BW, AVX512DQ and AVX512VL
+    namespace NAvx512 {
+        ui32 L2SqrDistance(const i8* a, const i8* b, int length);
+        ui32 L2SqrDistance(const ui8* a, const ui8* b, int length);
+        float L2SqrDistance(const float* a, const float* b, int length);
+        double L2SqrDistance(const double* a, const double* b, int length);
+
+        void L2SqrDistanceX4(const i8* query, const i8* rows, int length, ui32* result);
+        void L2SqrDistanceX4(const ui8* query, const ui8* rows, int length, ui32* result);
+        void L2SqrDistanceX4(const float* query, const float* rows, int length, float* result);
+        void L2SqrDistanceUI4X4(const ui8* query, const ui8* rows, int lengthInBytes, ui32* result);
+    }
+
+    // byte kernels built on vpdpbusd, the rest (and all X4 kernels) is taken from NAvx512
+    namespace NAvx512Vnni {
+        ui32 L2SqrDistance(const i8* a, const i8* b, int length);
+        ui32 L2SqrDistance(const ui8* a, const ui8* b, int length);
+    }
+#endif
+}
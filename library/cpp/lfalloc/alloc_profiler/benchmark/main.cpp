@@ -0,0 +1,39 @@
+#include <library/cpp/lfalloc/alloc_profiler/heap_profiler.h>
+
+#include <library/cpp/testing/benchmark/bench.h>
+
+#include <util/generic/vector.h>
+#include <util/random/fast.h>
+
+#include <stdlib.h>
+
+// Random malloc/free pairs of 16..512 bytes over a small working set, worst case for sampling overhead
+static void AllocFree(size_t iterations) {
+    TVector<void*> slots(4096, nullptr);
+    TReallyFastRng32 rng(17);
+    for (size_t i = 0; i < iterations; ++i) {
+        const size_t slot = rng() % slots.size();
+        free(slots[slot]);
+        slots[slot] = malloc(16 + rng() % 496);
+        Y_DO_NOT_OPTIMIZE_AWAY(slots[slot]);
+    }
+    for (void* ptr : slots) {
+        free(ptr);
+    }
+}
+
+Y_CPU_BENCHMARK(AllocFree, iface) {
+    AllocFree(iface.Iterations());
+}
+
+Y_CPU_BENCHMARK(AllocFreeHeapProfiling, iface) {
+    NAllocProfiler::StartHeapProfiling();
+    AllocFree(iface.Iterations());
+    NAllocProfiler::StopHeapProfiling();
+}
+
+Y_CPU_BENCHMARK(AllocFreeHeapProfilingDense, iface) {
+    NAllocProfiler::StartHeapProfiling(64 * 1024);
+    AllocFree(iface.Iterations());
+    NAllocProfiler::StopHeapProfiling();
+}
@@ -0,0 +1,389 @@
+#include "heap_profiler.h"
+
+#include <library/cpp/lfalloc/dbg_info/dbg_info.h>
+
+#include <util/datetime/base.h>
+#include <util/generic/algorithm.h>
+#include <util/generic/hash.h>
+#include <util/generic/singleton.h>
+#include <util/generic/string.h>
+#include <util/stream/format.h>
+#include <util/string/cast.h>
+#include <util/system/atomic.h>
+#include <util/system/backtrace.h>
+#include <util/system/tls.h>
+
+#include <cmath>
+
+namespace NAllocProfiler {
+
+namespace {
+
+static THeapSampleCollector& HeapSampleCollector()
+{
+    return *Singleton<THeapSampleCollector>();
+}
+
+static TAtomic SamplePeriod = 0;
+static TInstant StartTime;
+
+// allocations made by the profiler itself while it holds collector locks must not be sampled
+Y_POD_STATIC_THREAD(bool)
+InHeapProfiler(false);
+
+class TInHeapProfilerGuard {
+private:
+    const bool Prev;
+
+public:
+    TInHeapProfilerGuard()
+        : Prev(InHeapProfiler)
+    {
+        InHeapProfiler = true;
+    }
+
+    ~TInHeapProfilerGuard()
+    {
+        InHeapProfiler = Prev;
+    }
+};
+
+int HeapAllocationCallback(int tag, size_t size, int sizeIdx)
+{
+    Y_UNUSED(sizeIdx);
+
+    const size_t period = AtomicGet(SamplePeriod);
+    if (InHeapProfiler || !period || !size) {
+        return -1;
+    }
+
+    static const size_t STACK_FRAMES_COUNT = 32;
+    static const size_t STACK_FRAMES_SKIP = 1;
+
+    void* frames[STACK_FRAMES_COUNT];
+    size_t frameCount = BackTrace(frames, Y_ARRAY_SIZE(frames));
+    if (frameCount <= STACK_FRAMES_SKIP) {
+        return -1;
+    }
+
+    // allocation of this size is sampled with probability 1 - exp(-size / period)
+    const double weight = -1.0 / std::expm1(-(double)size / period);
+
+    auto& collector = HeapSampleCollector();
+    return collector.Alloc(&frames[STACK_FRAMES_SKIP], frameCount - STACK_FRAMES_SKIP, tag, size, weight);
+}
+
+void HeapDeallocationCallback(int cookie, int tag, size_t size, int sizeIdx)
+{
+    Y_UNUSED(tag);
+    Y_UNUSED(size);
+    Y_UNUSED(sizeIdx);
+
+    auto& collector = HeapSampleCollector();
+    collector.Free(cookie);
+}
+
+i64 Estimate(double value)
+{
+    return Max<i64>(0, std::llround(value));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Minimal protobuf wire format writer, enough for profile.proto
+
+class TProtoWriter {
+private:
+    TString Data;
+
+public:
+    void Varint(ui32 field, ui64 value)
+    {
+        WriteVarint(field << 3);
+        WriteVarint(value);
+    }
+
+    void Bytes(ui32 field, TStringBuf value)
+    {
+        WriteVarint((field << 3) | 2);
+        WriteVarint(value.size());
+        Data.append(value);
+    }
+
+    void Message(ui32 field, const TProtoWriter& message)
+    {
+        Bytes(field, message.Data);
+    }
+
+    template <typename T>
+    void Packed(ui32 field, const TVector<T>& values)
+    {
+        TProtoWriter packed;
+        for (T value: values) {
+            packed.WriteVarint(value);
+        }
+        Bytes(field, packed.Data);
+    }
+
+    const TString& Str() const
+    {
+        return Data;
+    }
+
+private:
+    void WriteVarint(ui64 value)
+    {
+        while (value >= 0x80) {
+            Data.push_back((char)(value | 0x80));
+            value >>= 7;
+        }
+        Data.push_back((char)value);
+    }
+};
+
+class TPprofProfileBuilder {
+private:
+    // field numbers of profile.proto messages
+    enum EProfileField {
+        PF_SAMPLE_TYPE = 1,
+        PF_SAMPLE = 2,
+        PF_LOCATION = 4,
+        PF_FUNCTION = 5,
+        PF_STRING_TABLE = 6,
+        PF_TIME_NANOS = 9,
+        PF_DURATION_NANOS = 10,
+        PF_PERIOD_TYPE = 11,
+        PF_PERIOD = 12,
+    };
+
+    TProtoWriter Profile;
+    TVector<TString> Strings;
+    THashMap<TString, ui64> StringIds;
+    THashMap<TString, ui64> FunctionIds;
+    THashMap<void*, ui64> LocationIds;
+
+public:
+    TPprofProfileBuilder()
+    {
+        String(TString());
+
+        for (auto type: {std::make_pair("alloc_objects", "count"), std::make_pair("alloc_space", "bytes"),
+                         std::make_pair("inuse_objects", "count"), std::make_pair("inuse_space", "bytes")})
+        {
+            Profile.Message(PF_SAMPLE_TYPE, ValueType(type.first, type.second));
+        }
+    }
+
+    void AddSample(const THeapProfileEntry& entry)
+    {
+        TVector<ui64> locations;
+        for (void* addr: entry.Stack) {
+            locations.push_back(Location(addr));
+        }
+        const TVector<i64> values = {
+            Estimate(entry.Stats.Allocs),
+            Estimate(entry.Stats.AllocSize),
+            Estimate(entry.Stats.LiveCount),
+            Estimate(entry.Stats.LiveSize),
+        };
+
+        TProtoWriter label;
+        label.Varint(1, String("tag"));
+        label.Varint(3, entry.Tag);
+
+        TProtoWriter sample;
+        sample.Packed(1, locations);
+        sample.Packed(2, values);
+        sample.Message(3, label);
+        Profile.Message(PF_SAMPLE, sample);
+    }
+
+    TString Finish(TInstant start, size_t period)
+    {
+        const TInstant now = TInstant::Now();
+        Profile.Varint(PF_TIME_NANOS, now.NanoSeconds());
+        Profile.Varint(PF_DURATION_NANOS, (now - start).NanoSeconds());
+        Profile.Message(PF_PERIOD_TYPE, ValueType("space", "bytes"));
+        Profile.Varint(PF_PERIOD, period);
+        for (const TString& str: Strings) {
+            Profile.Bytes(PF_STRING_TABLE, str);
+        }
+        return Profile.Str();
+    }
+
+private:
+    ui64 String(const TString& str)
+    {
+        auto it = StringIds.find(str);
+        if (it == StringIds.end()) {
+            it = StringIds.emplace(str, Strings.size()).first;
+            Strings.push_back(str);
+        }
+        return it->second;
+    }
+
+    TProtoWriter ValueType(const TString& type, const TString& unit)
+    {
+        TProtoWriter valueType;
+        valueType.Varint(1, String(type));
+        valueType.Varint(2, String(unit));
+        return valueType;
+    }
+
+    ui64 Function(const TString& name)
+    {
+        auto it = FunctionIds.find(name);
+        if (it != FunctionIds.end()) {
+            return it->second;
+        }
+        const ui64 id = FunctionIds.size() + 1;
+        FunctionIds.emplace(name, id);
+
+        TProtoWriter function;
+        function.Varint(1, id);
+        function.Varint(2, String(name));
+        function.Varint(3, String(name));
+        Profile.Message(PF_FUNCTION, function);
+        return id;
+    }
+
+    ui64 Location(void* addr)
+    {
+        auto it = LocationIds.find(addr);
+        if (it != LocationIds.end()) {
+            return it->second;
+        }
+        const ui64 id = LocationIds.size() + 1;
+        LocationIds.emplace(addr, id);
+
+        char name[1024];
+        TResolvedSymbol symbol = ResolveSymbol(addr, name, sizeof(name));
+        TString functionName = symbol.Name && TStringBuf(symbol.Name) != TStringBuf("??")
+            ? TString(symbol.Name)
+            : TString("0x") + IntToString<16>((uintptr_t)addr);
+
+        TProtoWriter line;
+        line.Varint(1, Function(functionName));
+
+        TProtoWriter location;
+        location.Varint(1, id);
+        location.Varint(3, (uintptr_t)addr);
+        location.Message(4, line);
+        Profile.Message(PF_LOCATION, location);
+        return id;
+    }
+};
+
+}   // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool StartHeapProfiling(size_t samplePeriod)
+{
+    if (!samplePeriod) {
+        return false;
+    }
+
+    auto& collector = HeapSampleCollector();
+    collector.Clear();
+    StartTime = TInstant::Now();
+    AtomicSet(SamplePeriod, samplePeriod);
+
+    NAllocDbg::SetProfileAllThreads(true);
+    NAllocDbg::SetAllocationSamplePeriod(samplePeriod);
+    NAllocDbg::SetAllocationCallback(HeapAllocationCallback);
+    NAllocDbg::SetDeallocationCallback(HeapDeallocationCallback);
+    NAllocDbg::SetAllocationSamplingEnabled(true);
+    return true;
+}
+
+bool StopHeapProfiling()
+{
+    if (!AtomicGet(SamplePeriod)) {
+        return false;
+    }
+
+    NAllocDbg::SetAllocationCallback(nullptr);
+    NAllocDbg::SetDeallocationCallback(nullptr);
+    NAllocDbg::SetAllocationSamplingEnabled(false);
+    NAllocDbg::SetAllocationSamplePeriod(0);
+    NAllocDbg::SetProfileAllThreads(false);
+    AtomicSet(SamplePeriod, 0);
+    return true;
+}
+
+bool IsHeapProfilingEnabled()
+{
+    return AtomicGet(SamplePeriod) != 0;
+}
+
+THeapStats GetHeapProfileTotal()
+{
+    TInHeapProfilerGuard guard;
+    return HeapSampleCollector().GetTotal();
+}
+
+TVector<THeapProfileEntry> GetHeapProfile(EHeapProfileType type, int count)
+{
+    TInHeapProfilerGuard guard;
+    TVector<THeapProfileEntry> entries = HeapSampleCollector().GetProfile();
+
+    auto key = [type] (const THeapProfileEntry& entry) {
+        return type == EHeapProfileType::Live ? entry.Stats.LiveSize : entry.Stats.AllocSize;
+    };
+    EraseIf(entries, [&] (const THeapProfileEntry& entry) {
+        return Estimate(key(entry)) == 0;
+    });
+    Sort(entries, [&] (const THeapProfileEntry& l, const THeapProfileEntry& r) {
+        return key(l) > key(r);
+    });
+    if (count >= 0 && entries.size() > (size_t)count) {
+        entries.resize(count);
+    }
+    return entries;
+}
+
+bool DumpHeapProfile(IAllocationStatsDumper& out, EHeapProfileType type, int count)
+{
+    TInHeapProfilerGuard guard;
+
+    auto toStats = [] (const THeapStats& heapStats) {
+        TStats stats;
+        stats.Allocs = Estimate(heapStats.Allocs);
+        stats.Frees = Estimate(heapStats.Allocs - heapStats.LiveCount);
+        stats.CurrentSize = Estimate(heapStats.LiveSize);
+        return stats;
+    };
+
+    out.DumpTotal(toStats(GetHeapProfileTotal()));
+
+    TAllocationInfo allocInfo;
+    for (const THeapProfileEntry& entry: GetHeapProfile(type, count)) {
+        allocInfo.Clear();
+        allocInfo.Tag = entry.Tag;
+        allocInfo.Stats = toStats(entry.Stats);
+        allocInfo.Stack = entry.Stack;
+        out.DumpEntry(allocInfo);
+    }
+    return true;
+}
+
+bool DumpHeapProfile(IOutputStream& out, EHeapProfileType type, int count)
+{
+    TAllocationStatsDumper dumper(out);
+    return DumpHeapProfile(dumper, type, count);
+}
+
+bool WriteHeapProfilePprof(IOutputStream& out)
+{
+    TInHeapProfilerGuard guard;
+
+    TPprofProfileBuilder builder;
+    for (const THeapProfileEntry& entry: HeapSampleCollector().GetProfile()) {
+        builder.AddSample(entry);
+    }
+    const TString profile = builder.Finish(StartTime, AtomicGet(SamplePeriod));
+    out.Write(profile.data(), profile.size());
+    return true;
+}
+
+}   // namespace NAllocProfiler
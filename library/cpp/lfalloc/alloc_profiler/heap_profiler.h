@@ -0,0 +1,41 @@
+#pragma once
+
+#include "stackcollect.h"
+
+#include <util/generic/vector.h>
+#include <util/stream/output.h>
+
+namespace NAllocProfiler {
+
+////////////////////////////////////////////////////////////////////////////////
+// Continuous heap profiling.
+//
+// Allocations of all threads are sampled as a Poisson process over allocated
+// bytes, one sample per samplePeriod bytes on average, and sampled objects are
+// tracked until they are freed. So profile of the live heap and of all
+// allocations since start could be taken at any moment, values are estimates
+// of real counts and sizes. Requires LF_DBG allocator, shares allocator
+// callbacks with StartAllocationSampling, so only one of them could be used
+// at a time.
+
+enum class EHeapProfileType {
+    Live,           // objects which are not freed yet, ordered by live size
+    Allocations,    // all allocations since start, ordered by allocated size
+};
+
+bool StartHeapProfiling(size_t samplePeriod = 2 * 1024 * 1024);
+bool StopHeapProfiling();
+bool IsHeapProfilingEnabled();
+
+THeapStats GetHeapProfileTotal();
+TVector<THeapProfileEntry> GetHeapProfile(EHeapProfileType type, int count = 100);
+
+bool DumpHeapProfile(IAllocationStatsDumper& out, EHeapProfileType type, int count = 100);
+bool DumpHeapProfile(IOutputStream& out, EHeapProfileType type, int count = 100);
+
+// Writes all stacks in pprof protobuf format (profile.proto) with alloc_objects,
+// alloc_space, inuse_objects and inuse_space sample types and resolved function
+// names. Output is not gzipped, pprof reads it as is.
+bool WriteHeapProfilePprof(IOutputStream& out);
+
+}   // namespace NAllocProfiler
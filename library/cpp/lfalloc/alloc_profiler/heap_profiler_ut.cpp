@@ -0,0 +1,154 @@
+#include "heap_profiler.h"
+
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/ptr.h>
+#include <util/stream/str.h>
+
+namespace NAllocProfiler {
+
+////////////////////////////////////////////////////////////////////////////////
+
+static const size_t OBJECT_SIZE = 1024;
+static const size_t OBJECT_COUNT = 4000;
+static const size_t SAMPLE_PERIOD = 8 * 1024;
+
+Y_NO_INLINE void HeapProfilerRetainObjects(TVector<TArrayHolder<char>>& objects)
+{
+    for (size_t i = 0; i < OBJECT_COUNT; ++i) {
+        objects.emplace_back(new char[OBJECT_SIZE]);
+    }
+}
+
+Y_NO_INLINE void HeapProfilerFreeObjects()
+{
+    TVector<TArrayHolder<char>> objects;
+    objects.reserve(2);
+    for (size_t i = 0; i < OBJECT_COUNT; ++i) {
+        objects.emplace_back(new char[OBJECT_SIZE]);
+        objects.erase(objects.begin());
+    }
+}
+
+struct TPprofFields {
+    size_t SampleCount = 0;
+    TVector<TString> Strings;
+};
+
+static ui64 ReadVarint(TStringBuf& data)
+{
+    ui64 value = 0;
+    for (int shift = 0; !data.empty(); shift += 7) {
+        const ui8 byte = data[0];
+        data.Skip(1);
+        value |= (ui64)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            break;
+        }
+    }
+    return value;
+}
+
+static TPprofFields ParsePprof(TStringBuf data)
+{
+    TPprofFields fields;
+    while (!data.empty()) {
+        const ui64 key = ReadVarint(data);
+        if ((key & 7) == 0) {
+            ReadVarint(data);
+            continue;
+        }
+        UNIT_ASSERT_VALUES_EQUAL(key & 7, 2);
+        const ui64 len = ReadVarint(data);
+        UNIT_ASSERT(len <= data.size());
+        if ((key >> 3) == 2) {
+            ++fields.SampleCount;
+        } else if ((key >> 3) == 6) {
+            fields.Strings.emplace_back(data.Head(len));
+        }
+        data.Skip(len);
+    }
+    return fields;
+}
+
+Y_UNIT_TEST_SUITE(HeapProfiler) {
+    Y_UNIT_TEST(LiveAndAllocated)
+    {
+        UNIT_ASSERT(StartHeapProfiling(SAMPLE_PERIOD));
+        UNIT_ASSERT(IsHeapProfilingEnabled());
+
+        TVector<TArrayHolder<char>> objects;
+        objects.reserve(OBJECT_COUNT);
+        HeapProfilerRetainObjects(objects);
+        HeapProfilerFreeObjects();
+
+        TStringStream live;
+        DumpHeapProfile(live, EHeapProfileType::Live);
+        TStringStream allocations;
+        DumpHeapProfile(allocations, EHeapProfileType::Allocations);
+        const THeapStats total = GetHeapProfileTotal();
+        UNIT_ASSERT(StopHeapProfiling());
+        UNIT_ASSERT(!IsHeapProfilingEnabled());
+
+#if !defined(ARCH_AARCH64)
+        // estimates are unbiased, standard deviation is about 5% here
+        const double expected = OBJECT_COUNT * OBJECT_SIZE;
+        UNIT_ASSERT(total.LiveSize > expected * 0.7 && total.LiveSize < expected * 1.3);
+        UNIT_ASSERT(total.AllocSize > expected * 1.4 && total.AllocSize < expected * 2.6);
+
+        UNIT_ASSERT_STRING_CONTAINS(live.Str(), "HeapProfilerRetainObjects");
+        UNIT_ASSERT(!live.Str().Contains("HeapProfilerFreeObjects"));
+        UNIT_ASSERT_STRING_CONTAINS(allocations.Str(), "HeapProfilerRetainObjects");
+        UNIT_ASSERT_STRING_CONTAINS(allocations.Str(), "HeapProfilerFreeObjects");
+#else
+        Y_UNUSED(total);
+#endif
+    }
+
+    Y_UNIT_TEST(Restart)
+    {
+        StartHeapProfiling(SAMPLE_PERIOD);
+        TVector<TArrayHolder<char>> objects;
+        objects.reserve(OBJECT_COUNT);
+        HeapProfilerRetainObjects(objects);
+        StopHeapProfiling();
+
+        // samples of the previous run are ignored
+        StartHeapProfiling(SAMPLE_PERIOD);
+        objects.clear();
+        const THeapStats total = GetHeapProfileTotal();
+        StopHeapProfiling();
+        UNIT_ASSERT(total.LiveSize > -1 && total.LiveSize < SAMPLE_PERIOD * 16);
+
+        UNIT_ASSERT(!StartHeapProfiling(0));
+        UNIT_ASSERT(!StopHeapProfiling());
+    }
+
+    Y_UNIT_TEST(Pprof)
+    {
+        StartHeapProfiling(SAMPLE_PERIOD);
+        TVector<TArrayHolder<char>> objects;
+        objects.reserve(OBJECT_COUNT);
+        HeapProfilerRetainObjects(objects);
+
+        TStringStream out;
+        UNIT_ASSERT(WriteHeapProfilePprof(out));
+        StopHeapProfiling();
+
+        const TPprofFields fields = ParsePprof(out.Str());
+        UNIT_ASSERT(!fields.Strings.empty());
+        UNIT_ASSERT_VALUES_EQUAL(fields.Strings[0], "");
+        for (TStringBuf name: {"alloc_objects", "alloc_space", "inuse_objects", "inuse_space", "bytes", "count", "tag"}) {
+            UNIT_ASSERT(IsIn(fields.Strings, name));
+        }
+#if !defined(ARCH_AARCH64)
+        UNIT_ASSERT(fields.SampleCount > 0);
+        UNIT_ASSERT(AnyOf(fields.Strings, [] (const TString& str) {
+            return str.Contains("HeapProfilerRetainObjects");
+        }));
+#endif
+    }
+}
+
+}   // namespace NAllocProfiler
@@ -193,6 +193,9 @@ public:
 
     void Free(int stackId, size_t size)
     {
+        if (stackId < 0 || (size_t)stackId >= TBase::GetFramesCount()) {
+            return; // cookie of another collector
+        }
         TBase::GetStats(stackId).Free(size);
         Total.Free(size);
     }
@@ -274,6 +277,148 @@ void TAllocationStackCollector::Dump(int count, IAllocationStatsDumper &out) con
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+
+class THeapSampleCollector::TImpl: public TStackCollector<THeapStats> {
+    using TBase = TStackCollector<THeapStats>;
+
+private:
+    struct TSample {
+        int StackId;
+        size_t Size;
+        double Weight;
+    };
+
+    // cookie is generation of the collector and index of the sample, both fit into 31 bits;
+    // generation wraps after 2048 restarts, so an allocation that outlives that many restarts
+    // can free the sample of another allocation with the same index
+    static const int SAMPLE_INDEX_BITS = 20;
+    static const int GENERATION_MASK = 0x7FF;
+
+    TVector<TSample> Samples;
+    TVector<int> FreeSamples;
+    THeapStats Total;
+    int Generation = 0;
+    mutable TAdaptiveLock SamplesLock;
+
+public:
+    int Alloc(void** stack, size_t frameCount, int tag, size_t size, double weight)
+    {
+        int stackId = TBase::AddStack(stack, frameCount, tag);
+        if (stackId < 0) {
+            return -1;
+        }
+
+        with_lock (SamplesLock) {
+            int index;
+            if (!FreeSamples.empty()) {
+                index = FreeSamples.back();
+                FreeSamples.pop_back();
+            } else if (Samples.size() < (1u << SAMPLE_INDEX_BITS)) {
+                index = Samples.size();
+                Samples.emplace_back();
+            } else {
+                return -1;
+            }
+            Samples[index] = {stackId, size, weight};
+            TBase::GetStats(stackId).Alloc(size, weight);
+            Total.Alloc(size, weight);
+            return (Generation << SAMPLE_INDEX_BITS) | index;
+        }
+        Y_UNREACHABLE();
+    }
+
+    void Free(int cookie)
+    {
+        const int generation = cookie >> SAMPLE_INDEX_BITS;
+        const size_t index = cookie & ((1 << SAMPLE_INDEX_BITS) - 1);
+
+        with_lock (SamplesLock) {
+            if (cookie < 0 || generation != Generation || index >= Samples.size() || Samples[index].StackId < 0) {
+                return;
+            }
+            TSample& sample = Samples[index];
+            TBase::GetStats(sample.StackId).Free(sample.Size, sample.Weight);
+            Total.Free(sample.Size, sample.Weight);
+            sample.StackId = -1;
+            FreeSamples.push_back(index);
+        }
+    }
+
+    void Clear()
+    {
+        with_lock (SamplesLock) {
+            TBase::Clear();
+            Samples.clear();
+            FreeSamples.clear();
+            Total.Clear();
+            Generation = (Generation + 1) & GENERATION_MASK;
+        }
+    }
+
+    THeapStats GetTotal() const
+    {
+        with_lock (SamplesLock) {
+            return Total;
+        }
+        Y_UNREACHABLE();
+    }
+
+    TVector<THeapProfileEntry> GetProfile() const
+    {
+        const TFrameInfo* frames = TBase::GetFrames();
+        size_t framesCount = TBase::GetFramesCount();
+
+        TVector<THeapProfileEntry> entries;
+        with_lock (SamplesLock) {
+            for (size_t i = 0; i < framesCount; ++i) {
+                if (frames[i].Stats.Allocs) {
+                    THeapProfileEntry& entry = entries.emplace_back();
+                    entry.Tag = frames[i].Tag;
+                    entry.Stats = frames[i].Stats;
+                    TBase::BackTrace(&frames[i], entry.Stack);
+                }
+            }
+        }
+        return entries;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+THeapSampleCollector::THeapSampleCollector()
+    : Impl(new TImpl())
+{}
+
+THeapSampleCollector::~THeapSampleCollector()
+{}
+
+int THeapSampleCollector::Alloc(void** stack, size_t frameCount, int tag, size_t size, double weight)
+{
+    return Impl->Alloc(stack, frameCount, tag, size, weight);
+}
+
+void THeapSampleCollector::Free(int cookie)
+{
+    Impl->Free(cookie);
+}
+
+void THeapSampleCollector::Clear()
+{
+    Impl->Clear();
+}
+
+THeapStats THeapSampleCollector::GetTotal() const
+{
+    return Impl->GetTotal();
+}
+
+TVector<THeapProfileEntry> THeapSampleCollector::GetProfile() const
+{
+    return Impl->GetProfile();
+}
+
+
 TString IAllocationStatsDumper::FormatTag(int tag) {
     return ToString(tag);
 }
@@ -5,6 +5,7 @@
 
 #include <util/generic/noncopyable.h>
 #include <util/generic/ptr.h>
+#include <util/generic/vector.h>
 #include <util/stream/output.h>
 
 namespace NAllocProfiler {
@@ -47,6 +48,43 @@ struct TAllocationInfo {
 };
 
 
+// Estimated (unsampled) allocation statistics of heap profiling
+struct THeapStats {
+    double Allocs = 0;
+    double AllocSize = 0;
+    double LiveCount = 0;
+    double LiveSize = 0;
+
+    void Clear()
+    {
+        Allocs = 0;
+        AllocSize = 0;
+        LiveCount = 0;
+        LiveSize = 0;
+    }
+
+    void Alloc(size_t size, double weight)
+    {
+        Allocs += weight;
+        AllocSize += weight * size;
+        LiveCount += weight;
+        LiveSize += weight * size;
+    }
+
+    void Free(size_t size, double weight)
+    {
+        LiveCount -= weight;
+        LiveSize -= weight * size;
+    }
+};
+
+struct THeapProfileEntry {
+    int Tag;
+    THeapStats Stats;
+    TStackVec<void*, 64> Stack;
+};
+
+
 class IAllocationStatsDumper {
 public:
     virtual ~IAllocationStatsDumper() = default;
@@ -104,4 +142,28 @@ public:
     void Dump(int count, IAllocationStatsDumper& out) const;
 };
 
+////////////////////////////////////////////////////////////////////////////////
+
+// Keeps every sampled object until it is freed, so stats of each stack are
+// aggregated both over all sampled allocations and over live ones
+class THeapSampleCollector: private TNonCopyable {
+private:
+    class TImpl;
+    THolder<TImpl> Impl;
+
+public:
+    THeapSampleCollector();
+    ~THeapSampleCollector();
+
+    // weight is the number of allocations the sample stands for, returns cookie of the sample
+    int Alloc(void** stack, size_t frameCount, int tag, size_t size, double weight);
+    // cookies of the samples made before the last Clear are ignored
+    void Free(int cookie);
+
+    void Clear();
+
+    THeapStats GetTotal() const;
+    TVector<THeapProfileEntry> GetProfile() const;
+};
+
 }   // namespace NAllocProfiler
@@ -7,6 +7,8 @@ namespace NAllocDbg {
 
     using TGetAllocationCounter = i64(int counter);
 
+    using TScavenge = void();
+
     using TSetThreadAllocTag = int(int tag);
     using TGetPerTagAllocInfo = void(
         bool flushPerThreadCounters,
@@ -20,6 +22,7 @@ namespace NAllocDbg {
 
     using TSetAllocationSampleRate = size_t(size_t newVal);
     using TSetAllocationSampleMaxSize = size_t(size_t newVal);
+    using TSetAllocationSamplePeriod = size_t(size_t newVal);
 
     using TSetAllocationCallback = TAllocationCallback*(TAllocationCallback* newVal);
     using TSetDeallocationCallback = TDeallocationCallback*(TDeallocationCallback* newVal);
@@ -28,6 +31,8 @@ namespace NAllocDbg {
         TGetAllocationCounter* GetAllocationCounterFast = nullptr;
         TGetAllocationCounter* GetAllocationCounterFull = nullptr;
 
+        TScavenge* Scavenge = nullptr;
+
         TSetThreadAllocTag* SetThreadAllocTag = nullptr;
         TGetPerTagAllocInfo* GetPerTagAllocInfo = nullptr;
 
@@ -37,6 +42,7 @@ namespace NAllocDbg {
 
         TSetAllocationSampleRate* SetAllocationSampleRate = nullptr;
         TSetAllocationSampleMaxSize* SetAllocationSampleMaxSize = nullptr;
+        TSetAllocationSamplePeriod* SetAllocationSamplePeriod = nullptr;
 
         TSetAllocationCallback* SetAllocationCallback = nullptr;
         TSetDeallocationCallback* SetDeallocationCallback = nullptr;
@@ -47,6 +53,8 @@ namespace NAllocDbg {
             GetAllocationCounterFast = (TGetAllocationCounter*)mallocInfo.GetParam("GetLFAllocCounterFast");
             GetAllocationCounterFull = (TGetAllocationCounter*)mallocInfo.GetParam("GetLFAllocCounterFull");
 
+            Scavenge = (TScavenge*)mallocInfo.GetParam("LFAllocScavenge");
+
             SetThreadAllocTag = (TSetThreadAllocTag*)mallocInfo.GetParam("SetThreadAllocTag");
             GetPerTagAllocInfo = (TGetPerTagAllocInfo*)mallocInfo.GetParam("GetPerTagAllocInfo");
 
@@ -56,6 +64,7 @@ namespace NAllocDbg {
 
             SetAllocationSampleRate = (TSetAllocationSampleRate*)mallocInfo.GetParam("SetAllocationSampleRate");
             SetAllocationSampleMaxSize = (TSetAllocationSampleMaxSize*)mallocInfo.GetParam("SetAllocationSampleMaxSize");
+            SetAllocationSamplePeriod = (TSetAllocationSamplePeriod*)mallocInfo.GetParam("SetAllocationSamplePeriod");
 
             SetAllocationCallback = (TSetAllocationCallback*)mallocInfo.GetParam("SetAllocationCallback");
             SetDeallocationCallback = (TSetDeallocationCallback*)mallocInfo.GetParam("SetDeallocationCallback");
@@ -74,6 +83,12 @@ namespace NAllocDbg {
         return AllocFn.GetAllocationCounterFull ? AllocFn.GetAllocationCounterFull(counter) : 0;
     }
 
+    void Scavenge() {
+        if (AllocFn.Scavenge) {
+            AllocFn.Scavenge();
+        }
+    }
+
     int SetThreadAllocTag(int tag) {
         return AllocFn.SetThreadAllocTag ? AllocFn.SetThreadAllocTag(tag) : 0;
     }
@@ -113,6 +128,10 @@ namespace NAllocDbg {
         return AllocFn.SetAllocationSampleMaxSize ? AllocFn.SetAllocationSampleMaxSize(newVal) : 0;
     }
 
+    size_t SetAllocationSamplePeriod(size_t newVal) {
+        return AllocFn.SetAllocationSamplePeriod ? AllocFn.SetAllocationSamplePeriod(newVal) : 0;
+    }
+
     TAllocationCallback* SetAllocationCallback(TAllocationCallback* newVal) {
         return AllocFn.SetAllocationCallback ? AllocFn.SetAllocationCallback(newVal) : nullptr;
     }
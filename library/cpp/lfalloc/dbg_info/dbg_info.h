@@ -21,12 +21,19 @@ namespace NAllocDbg {
         CT_LARGE_FREE,     // accumulated deallocated size for large blocks
         CT_SLOW_ALLOC_CNT, // number of slow (not LF) allocations
         CT_DEGRAGMENT_CNT, // number of memory defragmentations
+        CT_RELEASED,       // accumulated size of free memory returned to the OS by defragmentation and scavenger
+        CT_RETAINED,       // free memory kept in global free lists and large blocks cache at last scavenger pass
+        CT_RSS_LIMIT_CNT,  // number of scavenger passes made over soft RSS limit
         CT_MAX
     };
 
     i64 GetAllocationCounterFast(ELFAllocCounter counter);
     i64 GetAllocationCounterFull(ELFAllocCounter counter);
 
+    // Returns all free memory to the OS, see ScavengeIntervalMs and SoftRssLimit allocator params
+    // for doing it in background
+    void Scavenge();
+
     ////////////////////////////////////////////////////////////////////////////////
     // Allocation statistics could be tracked on per-tag basis
 
@@ -65,6 +72,9 @@ namespace NAllocDbg {
 
     size_t SetAllocationSampleRate(size_t newVal);
     size_t SetAllocationSampleMaxSize(size_t newVal);
+    // Nonzero period switches to sampling one allocation per period bytes on average (Poisson process),
+    // AllocationSampleRate and AllocationSampleMaxSize are ignored then
+    size_t SetAllocationSamplePeriod(size_t newVal);
 
 #define DBG_ALLOC_INVALID_COOKIE (-1)
 
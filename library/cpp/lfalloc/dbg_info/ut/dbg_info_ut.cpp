@@ -0,0 +1,101 @@
+#include <library/cpp/lfalloc/dbg_info/dbg_info.h>
+#include <library/cpp/malloc/api/malloc.h>
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <util/datetime/base.h>
+#include <util/generic/vector.h>
+#include <util/system/thread.h>
+
+using namespace NAllocDbg;
+
+namespace {
+    const size_t SMALL_COUNT = 1 << 19;
+    const size_t SMALL_SIZE = 128;
+    const size_t LARGE_COUNT = 8;
+    const size_t LARGE_SIZE = 4 << 20;
+
+    // leaves about 96 MB of free memory in global free lists and in the large blocks cache
+    void AllocationBurst() {
+        TThread thread([]() {
+            TVector<char*> ptrs;
+            for (size_t i = 0; i < SMALL_COUNT; ++i) {
+                ptrs.push_back(new char[SMALL_SIZE]);
+            }
+            for (size_t i = 0; i < LARGE_COUNT; ++i) {
+                ptrs.push_back(new char[LARGE_SIZE]);
+                memset(ptrs.back(), 1, LARGE_SIZE);
+            }
+            for (char* p : ptrs) {
+                delete[] p;
+            }
+        });
+        thread.Start();
+        thread.Join();
+    }
+
+    bool IsScavengerSupported() {
+        return NMalloc::MallocInfo().GetParam("LFAllocScavenge") != nullptr;
+    }
+
+    void SetParam(const char* param, const char* value) {
+        UNIT_ASSERT(NMalloc::MallocInfo().SetParam(param, value));
+    }
+
+    // waits for a background scavenger pass that sets the counter above `value`
+    bool WaitCounterAbove(ELFAllocCounter counter, i64 value) {
+        const TInstant deadline = TDuration::Seconds(10).ToDeadLine();
+        while (GetAllocationCounterFull(counter) <= value) {
+            if (Now() > deadline) {
+                return false;
+            }
+            Sleep(TDuration::MilliSeconds(10));
+        }
+        return true;
+    }
+}
+
+Y_UNIT_TEST_SUITE(TScavengerTest) {
+    Y_UNIT_TEST(TestScavenge) {
+        if (!IsScavengerSupported()) {
+            return;
+        }
+        const i64 burstSize = SMALL_COUNT * SMALL_SIZE + LARGE_COUNT * LARGE_SIZE;
+        AllocationBurst();
+
+        // background passes that may not release anything only measure retained memory
+        SetParam("ScavengeReleaseRate", "0");
+        SetParam("ScavengeIntervalMs", "20");
+        UNIT_ASSERT(WaitCounterAbove(CT_RETAINED, burstSize / 2));
+        SetParam("ScavengeIntervalMs", "0");
+        Sleep(TDuration::MilliSeconds(50));
+        const i64 retained = GetAllocationCounterFull(CT_RETAINED);
+        const i64 released = GetAllocationCounterFull(CT_RELEASED);
+
+        Scavenge();
+        UNIT_ASSERT_GE(GetAllocationCounterFull(CT_RELEASED) - released, burstSize / 2);
+        UNIT_ASSERT_LT(GetAllocationCounterFull(CT_RETAINED), retained / 4);
+        SetParam("ScavengeReleaseRate", "67108864");
+    }
+
+#if defined(_linux_)
+    Y_UNIT_TEST(TestSoftRssLimit) {
+        if (!IsScavengerSupported()) {
+            return;
+        }
+        const i64 burstSize = SMALL_COUNT * SMALL_SIZE + LARGE_COUNT * LARGE_SIZE;
+        const i64 limitPasses = GetAllocationCounterFull(CT_RSS_LIMIT_CNT);
+        const i64 released = GetAllocationCounterFull(CT_RELEASED);
+        AllocationBurst();
+
+        // nothing is released by rate, everything is released over the limit
+        SetParam("ScavengeReleaseRate", "0");
+        SetParam("ScavengeIntervalMs", "20");
+        SetParam("SoftRssLimit", "1");
+        UNIT_ASSERT(WaitCounterAbove(CT_RSS_LIMIT_CNT, limitPasses));
+        UNIT_ASSERT(WaitCounterAbove(CT_RELEASED, released + burstSize / 2));
+        SetParam("SoftRssLimit", "0");
+        SetParam("ScavengeIntervalMs", "0");
+        SetParam("ScavengeReleaseRate", "67108864");
+    }
+#endif
+}
@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdarg.h>
+#include <math.h>
 
 #include <library/cpp/malloc/api/malloc.h>
 
@@ -99,6 +100,8 @@ static inline long AtomicSub(TAtomic& a, long b) {
 #include <errno.h>
 
 #if defined(_linux_)
+#include <fcntl.h>
+#include <unistd.h>
 #include <linux/futex.h>
 #include <sys/syscall.h>
 #if !defined(MADV_HUGEPAGE)
@@ -290,9 +293,14 @@ enum ELFAllocCounter {
     CT_LARGE_FREE,     // accumulated deallocated size for large blocks
     CT_SLOW_ALLOC_CNT, // number of slow (not LF) allocations
     CT_DEGRAGMENT_CNT, // number of memory defragmentations
+    CT_RELEASED,       // accumulated size of free memory returned to the OS by defragmentation and scavenger
+    CT_RETAINED,       // free memory kept in global free lists and large blocks cache at last scavenger pass
+    CT_RSS_LIMIT_CNT,  // number of scavenger passes made over soft RSS limit
     CT_MAX
 };
 
+static TAtomic GlobalCounters[CT_MAX];
+
 static Y_FORCE_INLINE void IncrementCounter(ELFAllocCounter counter, size_t value);
 
 //////////////////////////////////////////////////////////////////////////
@@ -491,9 +499,11 @@ static void* LargeBlockAlloc(size_t _nSize, ELFAllocCounter counter) {
 }
 
 #ifndef _MSC_VER
-static void FreeAllLargeBlockMem() {
+// unmaps cached large blocks until maxBytes are released, returns number of released bytes
+static size_t FreeAllLargeBlockMem(size_t maxBytes = (size_t)-1) {
+    size_t released = 0;
     for (auto& lbFreePtr : lbFreePtrs) {
-        for (int i = 0; i < LB_BUF_SIZE; ++i) {
+        for (int i = 0; i < LB_BUF_SIZE && released < maxBytes; ++i) {
             void* p = lbFreePtr[i];
             if (p == nullptr)
                 continue;
@@ -501,9 +511,11 @@ static void FreeAllLargeBlockMem() {
                 int pgCount = TLargeBlk::As(p)->Pages;
                 AtomicAdd(lbFreePageCount, -pgCount);
                 LargeBlockUnmap(p, pgCount);
+                released += (pgCount + 1) * 4096ll;
             }
         }
     }
+    return released;
 }
 #endif
 
@@ -772,15 +784,11 @@ const int FREE_LIST_GROUP_SIZEIDX = 6;
 #endif
 
 //////////////////////////////////////////////////////////////////////////
-// find free chunks and reset chunk size so they can be reused by different sized allocations
+// find free chunks and reset chunk size so they can be reused by different sized allocations,
+// at most maxChunks of them are returned to the OS, freeBytes receives size of blocks left in free lists
 // do not look at blockFreeList (TFreeListGroup has same size for any allocations)
-static bool DefragmentMem() {
-    if (!EnableDefrag) {
-        return false;
-    }
-
-    IncrementCounter(CT_DEGRAGMENT_CNT, 1);
-
+// should be called under LFGlobalLock
+static size_t ReleaseFreeChunks(size_t maxChunks, i64* freeBytes) {
     int* nFreeCount = (int*)SystemAlloc(N_CHUNKS * sizeof(int));
     if (Y_UNLIKELY(!nFreeCount)) {
         //__debugbreak();
@@ -802,7 +810,8 @@ static bool DefragmentMem() {
         }
     }
 
-    bool bRes = false;
+    size_t released = 0;
+    i64 freeSize = 0;
     for (size_t nChunk = 0; nChunk < N_CHUNKS; ++nChunk) {
         int fc = nFreeCount[nChunk];
         nFreeCount[nChunk] = 0;
@@ -810,12 +819,14 @@ static bool DefragmentMem() {
             continue;
         int nEntries = N_CHUNK_SIZE / nSizeIdxToSize[static_cast<int>(chunkSizeIdx[nChunk])];
         Y_ASSERT_NOBT(fc <= nEntries); // can not have more free blocks then total count
-        if (fc == nEntries) {
-            bRes = true;
+        if (fc == nEntries && released < maxChunks) {
+            ++released;
             nFreeCount[nChunk] = 1;
+        } else {
+            freeSize += fc * (i64)nSizeIdxToSize[static_cast<int>(chunkSizeIdx[nChunk])];
         }
     }
-    if (bRes) {
+    if (released) {
         for (auto& wholeList : wholeLists) {
             TFreeListGroup** ppPtr = &wholeList;
             while (*ppPtr) {
@@ -853,13 +864,26 @@ static bool DefragmentMem() {
 #endif
             AddFreeChunk(nChunk);
         }
+        AtomicAdd(GlobalCounters[CT_RELEASED], released * N_CHUNK_SIZE);
     }
 
     for (int nSizeIdx = 0; nSizeIdx < N_SIZES; ++nSizeIdx)
         globalFreeLists[nSizeIdx].ReturnWholeList(wholeLists[nSizeIdx]);
 
     SystemFree(nFreeCount);
-    return bRes;
+    if (freeBytes)
+        *freeBytes = freeSize;
+    return released;
+}
+
+static bool DefragmentMem() {
+    if (!EnableDefrag) {
+        return false;
+    }
+
+    IncrementCounter(CT_DEGRAGMENT_CNT, 1);
+
+    return ReleaseFreeChunks(N_CHUNKS, nullptr) != 0;
 }
 
 static Y_FORCE_INLINE void* LFAllocFromCurrentChunk(int nSizeIdx, int blockSize, int count) {
@@ -1002,7 +1026,6 @@ static Y_FORCE_INLINE void PutBlocksToGlobalFreeList(ptrdiff_t nSizeIdx, char**
 }
 
 //////////////////////////////////////////////////////////////////////////
-static TAtomic GlobalCounters[CT_MAX];
 const int MAX_LOCAL_UPDATES = 100;
 const intptr_t MAX_LOCAL_DELTA = 1*1024*1024;
 
@@ -1103,6 +1126,7 @@ struct TThreadAllocInfo {
     // LastFreePtrs - pointers to last blocks in lists, may be invalid if FreePtr is zero
     char* FreePtrs[N_SIZES][THREAD_BUF];
     int FreePtrIndex[N_SIZES];
+    intptr_t TrimEpoch;
     TThreadAllocInfo* pNextInfo;
     TLocalCounter LocalCounters[CT_MAX];
 
@@ -1182,15 +1206,22 @@ static Y_FORCE_INLINE void IncrementCounter(ELFAllocCounter counter, size_t valu
 #endif
 }
 
+// scavenger counters are updated by the scavenger and defragmentation only, so they are always on
+static inline bool IsScavengerCounter(int counter) {
+    return counter == CT_RELEASED || counter == CT_RETAINED || counter == CT_RSS_LIMIT_CNT;
+}
+
 extern "C" i64 GetLFAllocCounterFast(int counter) {
 #ifdef LFALLOC_YT
     return GlobalCounters[counter];
 #else
-    return 0;
+    return IsScavengerCounter(counter) ? GlobalCounters[counter] : 0;
 #endif
 }
 
 extern "C" i64 GetLFAllocCounterFull(int counter) {
+    if (IsScavengerCounter(counter))
+        return GlobalCounters[counter];
 #ifdef LFALLOC_YT
     i64 ret = GlobalCounters[counter];
     {
@@ -1216,6 +1247,28 @@ static void MoveSingleThreadFreeToGlobal(TThreadAllocInfo* pInfo) {
     }
 }
 
+// scavenger asks threads to trim their caches by advancing the epoch, each thread does it on its next
+// allocator call, half of cached blocks are moved to global free lists or all of them over soft RSS limit
+static TAtomic ThreadCacheTrimEpoch;
+static volatile bool ThreadCacheTrimAll;
+
+static Y_NO_INLINE void TrimThreadCache(TThreadAllocInfo* pInfo) {
+    pInfo->TrimEpoch = ThreadCacheTrimEpoch;
+    const bool trimAll = ThreadCacheTrimAll;
+    for (int sizeIdx = 0; sizeIdx < N_SIZES; ++sizeIdx) {
+        int& freePtrIdx = pInfo->FreePtrIndex[sizeIdx];
+        const int cached = THREAD_BUF - freePtrIdx;
+        const int count = trimAll ? cached : cached / 2;
+        PutBlocksToGlobalFreeList(sizeIdx, pInfo->FreePtrs[sizeIdx] + freePtrIdx, count);
+        freePtrIdx += count;
+    }
+}
+
+static Y_FORCE_INLINE void CheckThreadCacheTrim(TThreadAllocInfo* pInfo) {
+    if (Y_UNLIKELY(pInfo->TrimEpoch != ThreadCacheTrimEpoch))
+        TrimThreadCache(pInfo);
+}
+
 #ifdef _win_
 static bool IsDeadThread(TThreadAllocInfo* pInfo) {
     DWORD dwExit;
@@ -1363,6 +1416,14 @@ extern "C" size_t SetAllocationSampleMaxSize(size_t newVal) {
     return prevVal;
 }
 
+// mean number of bytes between samples, 0 means sampling by AllocationSampleRate and AllocationSampleMaxSize
+static size_t AllocationSamplePeriod = 0;
+extern "C" size_t SetAllocationSamplePeriod(size_t newVal) {
+    size_t prevVal = AllocationSamplePeriod;
+    AllocationSamplePeriod = newVal;
+    return prevVal;
+}
+
 using TAllocationCallback = int(int tag, size_t size, int sizeIdx);
 static TAllocationCallback* AllocationCallback;
 extern "C" TAllocationCallback* SetAllocationCallback(TAllocationCallback* newVal) {
@@ -1381,12 +1442,44 @@ extern "C" TDeallocationCallback* SetDeallocationCallback(TDeallocationCallback*
 
 PERTHREAD TAtomic AllocationsCount;
 PERTHREAD bool InAllocationCallback;
+PERTHREAD i64 BytesUntilSample;
+PERTHREAD ui64 SampleRandomState;
+
+// Distance between samples is exponentially distributed, which makes sampling a Poisson process over
+// allocated bytes: allocation of size S is sampled with probability 1 - exp(-S / AllocationSamplePeriod).
+static i64 NextSampleInterval() {
+    if (Y_UNLIKELY(!SampleRandomState)) {
+        SampleRandomState = ((ui64)&SampleRandomState ^ (ui64)&AllocationsCount << 17) * 0x9E3779B97F4A7C15ull | 1;
+    }
+    SampleRandomState ^= SampleRandomState << 13;
+    SampleRandomState ^= SampleRandomState >> 7;
+    SampleRandomState ^= SampleRandomState << 17;
+    const double uniform = ((SampleRandomState >> 11) + 1) * (1.0 / (1ull << 53)); // (0, 1]
+    return (i64)(-log(uniform) * AllocationSamplePeriod) + 1;
+}
+
+static Y_NO_INLINE bool RestartSampleInterval() {
+    // the first countdown of a thread only starts sampling
+    const bool sampled = SampleRandomState != 0;
+    BytesUntilSample = NextSampleInterval();
+    return sampled;
+}
+
+static inline bool IsSampledAllocation(size_t size) {
+    if (AllocationSamplePeriod) {
+        if (Y_LIKELY((BytesUntilSample -= size) >= 0)) {
+            return false;
+        }
+        return RestartSampleInterval();
+    }
+    return size > AllocationSampleMaxSize || ++AllocationsCount % AllocationSampleRate == 0;
+}
 
 static const int DBG_ALLOC_INVALID_COOKIE = -1;
 static inline int SampleAllocation(TAllocHeader* p, int sizeIdx) {
     int cookie = DBG_ALLOC_INVALID_COOKIE;
     if (AllocationSamplingEnabled && (ProfileCurrentThread || ProfileAllThreads) && !InAllocationCallback) {
-        if (p->Size > AllocationSampleMaxSize || ++AllocationsCount % AllocationSampleRate == 0) {
+        if (IsSampledAllocation(p->Size)) {
             if (AllocationCallback) {
                 InAllocationCallback = true;
                 cookie = AllocationCallback(p->Tag, p->Size, sizeIdx);
@@ -1531,6 +1624,7 @@ static Y_FORCE_INLINE void* LFAllocImpl(size_t _nSize) {
             return ptr;
         }
     }
+    CheckThreadCacheTrim(thr);
     {
         int& freePtrIdx = thr->FreePtrIndex[nSizeIdx];
         if (freePtrIdx < THREAD_BUF) {
@@ -1613,6 +1707,7 @@ static Y_FORCE_INLINE void LFFree(void* p) {
     // try to store info to per thread buf
     TThreadAllocInfo* thr = pThreadInfo;
     if (thr) {
+        CheckThreadCacheTrim(thr);
         int& freePtrIdx = thr->FreePtrIndex[nSizeIdx];
         if (freePtrIdx > borderSizes[nSizeIdx]) {
             thr->FreePtrs[nSizeIdx][--freePtrIdx] = (char*)p;
@@ -1796,6 +1891,88 @@ void DumpMemoryBlockUtilization() {
     }
 }
 
+//////////////////////////////////////////////////////////////////////////
+// Scavenger returns free memory to the OS in background: every ScavengeIntervalMs it asks threads
+// to trim their caches and releases up to ScavengeReleaseRate bytes per second of fully free chunks
+// and cached large blocks. Over SoftRssLimit everything free is released at once.
+#ifndef _MSC_VER
+static volatile i64 ScavengeIntervalMs = 0; // 0 = scavenger is not running
+static volatile i64 ScavengeReleaseRate = 64 * 1024 * 1024;
+static volatile i64 SoftRssLimit = 0;
+static void* volatile ScavengerStarted;
+const i64 DEFAULT_SCAVENGE_INTERVAL_MS = 1000;
+
+static i64 GetRssBytes() {
+#if defined(_linux_)
+    int fd = open("/proc/self/statm", O_RDONLY);
+    if (fd < 0)
+        return 0;
+    char buf[128];
+    ssize_t len = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (len <= 0)
+        return 0;
+    buf[len] = 0;
+    const char* resident = strchr(buf, ' ');
+    return resident ? atoll(resident) * sysconf(_SC_PAGESIZE) : 0;
+#else
+    return 0;
+#endif
+}
+
+static void Scavenge(size_t maxBytes) {
+    if (SoftRssLimit && GetRssBytes() > SoftRssLimit) {
+        AtomicAdd(GlobalCounters[CT_RSS_LIMIT_CNT], 1);
+        maxBytes = N_MAX_WORKSET_SIZE;
+    }
+    const bool releaseAll = maxBytes >= N_MAX_WORKSET_SIZE;
+
+    ThreadCacheTrimAll = releaseAll;
+    AtomicAdd(ThreadCacheTrimEpoch, 1);
+    FlushThreadFreeList();
+
+    i64 freeBytes = 0;
+    size_t released = 0;
+    {
+        TLFLockHolder ls(&LFGlobalLock);
+        released = ReleaseFreeChunks(maxBytes / N_CHUNK_SIZE, &freeBytes) * N_CHUNK_SIZE;
+    }
+    if (released < maxBytes)
+        AtomicAdd(GlobalCounters[CT_RELEASED], FreeAllLargeBlockMem(maxBytes - released));
+
+    AtomicSet(GlobalCounters[CT_RETAINED], freeBytes + lbFreePageCount * N_PAGE_SIZE);
+}
+
+// returns all free memory to the OS, thread caches are trimmed on their next allocator call
+extern "C" void LFAllocScavenge() {
+    Scavenge(N_MAX_WORKSET_SIZE);
+}
+
+static void* ScavengerThreadProc(void*) {
+    for (;;) {
+        const i64 intervalMs = ScavengeIntervalMs ? ScavengeIntervalMs : DEFAULT_SCAVENGE_INTERVAL_MS;
+        usleep(intervalMs * 1000);
+        if (ScavengeIntervalMs)
+            Scavenge(ScavengeReleaseRate * intervalMs / 1000);
+    }
+    return nullptr;
+}
+
+static bool StartScavenger() {
+    if (DoCas(&ScavengerStarted, (void*)-1, (void*)nullptr) != (void*)nullptr)
+        return true;
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    pthread_t thread;
+    const bool started = pthread_create(&thread, &attr, ScavengerThreadProc, nullptr) == 0;
+    pthread_attr_destroy(&attr);
+    if (!started)
+        ScavengerStarted = nullptr;
+    return started;
+}
+#endif
+
 //////////////////////////////////////////////////////////////////////////
 // malloc api
 
@@ -1826,6 +2003,22 @@ static bool LFAlloc_SetParam(const char* param, const char* value) {
         EnableDefrag = !strcmp(value, "true");
         return true;
     }
+#ifndef _MSC_VER
+    if (!strcmp(param, "ScavengeIntervalMs")) {
+        ScavengeIntervalMs = atoll(value);
+        return !ScavengeIntervalMs || StartScavenger();
+    }
+    if (!strcmp(param, "ScavengeReleaseRate")) {
+        ScavengeReleaseRate = atoll(value);
+        return true;
+    }
+    if (!strcmp(param, "SoftRssLimit")) {
+        SoftRssLimit = atoll(value);
+        if (SoftRssLimit && !ScavengeIntervalMs)
+            ScavengeIntervalMs = DEFAULT_SCAVENGE_INTERVAL_MS;
+        return !SoftRssLimit || StartScavenger();
+    }
+#endif
     return false;
 };
 
@@ -1838,6 +2031,9 @@ static const char* LFAlloc_GetParam(const char* param) {
     static const TParam Params[] = {
         {"GetLFAllocCounterFast", (const char*)&GetLFAllocCounterFast},
         {"GetLFAllocCounterFull", (const char*)&GetLFAllocCounterFull},
+#ifndef _MSC_VER
+        {"LFAllocScavenge", (const char*)&LFAllocScavenge},
+#endif
 #if defined(LFALLOC_DBG)
         {"SetThreadAllocTag", (const char*)&SetThreadAllocTag},
         {"SetProfileCurrentThread", (const char*)&SetProfileCurrentThread},
@@ -1845,6 +2041,7 @@ static const char* LFAlloc_GetParam(const char* param) {
         {"SetAllocationSamplingEnabled", (const char*)&SetAllocationSamplingEnabled},
         {"SetAllocationSampleRate", (const char*)&SetAllocationSampleRate},
         {"SetAllocationSampleMaxSize", (const char*)&SetAllocationSampleMaxSize},
+        {"SetAllocationSamplePeriod", (const char*)&SetAllocationSamplePeriod},
         {"SetAllocationCallback", (const char*)&SetAllocationCallback},
         {"SetDeallocationCallback", (const char*)&SetDeallocationCallback},
         {"GetPerTagAllocInfo", (const char*)&GetPerTagAllocInfo},
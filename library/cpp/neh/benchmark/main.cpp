@@ -0,0 +1,85 @@
+#include <library/cpp/neh/http_common.h>
+#include <library/cpp/neh/neh.h>
+#include <library/cpp/neh/rpc.h>
+#include <library/cpp/testing/benchmark/bench.h>
+
+#include <util/generic/singleton.h>
+#include <util/generic/vector.h>
+#include <util/generic/yexception.h>
+#include <util/string/cast.h>
+
+// 1 MB replies over loopback, assembled from cached blobs:
+// Copy - segments are copied into single TData per request (old way),
+// Parts - segments are passed to writev as is.
+
+namespace {
+    using namespace NNeh;
+
+    constexpr size_t SegmentSize = 256 << 10;
+    constexpr size_t SegmentsCount = 4;
+
+    class TServer {
+    public:
+        TServer() {
+            for (size_t i = 0; i < SegmentsCount; ++i) {
+                Segments_.push_back(TBlob::FromString(TString(SegmentSize, 'a' + i)));
+            }
+
+            for (ui16 port = 21000; port < 40000; port += 100) {
+                try {
+                    Services_ = CreateLoop();
+                    const TString base = "http://localhost:" + ToString(port);
+                    Services_->Add(base + "/copy", [this](const IRequestRef& req) {
+                        TData data;
+                        data.reserve(SegmentSize * SegmentsCount);
+                        for (const TBlob& segment : Segments_) {
+                            data.insert(data.end(), segment.AsCharPtr(), segment.AsCharPtr() + segment.Size());
+                        }
+                        req->SendReply(data);
+                    });
+                    Services_->Add(base + "/parts", [this](const IRequestRef& req) {
+                        TDataParts parts;
+                        for (const TBlob& segment : Segments_) {
+                            parts.Append(segment);
+                        }
+                        req->SendReply(parts);
+                    });
+                    Services_->ForkLoop(4);
+                    Base_ = base;
+                    break;
+                } catch (...) {
+                    Services_.Destroy();
+                }
+            }
+            Y_ENSURE(Services_, "can not bind port for benchmark server");
+        }
+
+        ~TServer() {
+            Services_->SyncStopFork();
+        }
+
+        void Get(TStringBuf service) const {
+            TResponseRef resp = Request(Base_ + "/" + service)->Wait();
+            Y_ENSURE(resp && !resp->IsError() && resp->Data.size() == SegmentSize * SegmentsCount);
+        }
+
+    private:
+        TVector<TBlob> Segments_;
+        IServicesRef Services_;
+        TString Base_;
+    };
+}
+
+Y_CPU_BENCHMARK(Reply1MbCopy, iface) {
+    const auto& server = *Singleton<TServer>();
+    for (size_t i = 0; i < iface.Iterations(); ++i) {
+        server.Get(TStringBuf("copy"));
+    }
+}
+
+Y_CPU_BENCHMARK(Reply1MbParts, iface) {
+    const auto& server = *Singleton<TServer>();
+    for (size_t i = 0; i < iface.Iterations(); ++i) {
+        server.Get(TStringBuf("parts"));
+    }
+}
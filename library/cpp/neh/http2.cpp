@@ -1415,6 +1415,18 @@ namespace {
                 }
             }
 
+            using IHttpRequest::DoSendReply;
+
+            void DoSendReply(TDataParts& parts, const TString& headers, int httpCode) override {
+                if (CompressionScheme_) {
+                    // compression need contiguous input
+                    IHttpRequest::DoSendReply(parts, headers, httpCode);
+                } else if (!!C_) {
+                    C_->Send(Id(), parts, P_->HttpVersion(), headers, httpCode);
+                    C_.Reset();
+                }
+            }
+
             void SendError(TResponseError err, const TString& details) override {
                 static const unsigned errorToHttpCode[IRequest::MaxResponseError] =
                     {
@@ -1599,6 +1611,25 @@ namespace {
             };
             typedef TIntrusivePtr<TResponseData> TResponseDataRef;
 
+            static void PrintResponseHeader(IOutputStream& out, const THttpVersion& ver, int httpCode, const TString& contentEncoding, size_t contentLength, const TString& headers, bool closeConnection) {
+                PrintHttpVersion(out, ver);
+                out << TStringBuf(" ") << HttpCodeStrEx(httpCode);
+                if (contentEncoding) {
+                    out << TStringBuf("\r\nContent-Encoding: ") << contentEncoding;
+                }
+                out << TStringBuf("\r\nContent-Length: ") << contentLength;
+                if (closeConnection) {
+                    out << TStringBuf("\r\nConnection: close");
+                } else if (Y_LIKELY(ver.Major > 1 || ver.Minor > 0)) {
+                    // since HTTP/1.1 Keep-Alive is default behaviour
+                    out << TStringBuf("\r\nConnection: Keep-Alive");
+                }
+                if (headers) {
+                    out << headers;
+                }
+                out << TStringBuf("\r\n\r\n");
+            }
+
         public:
             //called non thread-safe (from outside thread)
             void Send(TAtomicBase requestId, TData& data, const TString& compressionScheme, const THttpVersion& ver, const TString& headers, int httpCode) {
@@ -1606,22 +1637,8 @@ namespace {
                 public:
                     THttpResponseFormatter(TData& theData, const TString& contentEncoding, const THttpVersion& theVer, const TString& theHeaders, int theHttpCode, bool closeConnection) {
                         Header.Reserve(128 + contentEncoding.size() + theHeaders.size());
-                        PrintHttpVersion(Header, theVer);
-                        Header << TStringBuf(" ") << HttpCodeStrEx(theHttpCode);
-                        if (Compress(theData, contentEncoding)) {
-                            Header << TStringBuf("\r\nContent-Encoding: ") << contentEncoding;
-                        }
-                        Header << TStringBuf("\r\nContent-Length: ") << theData.size();
-                        if (closeConnection) {
-                            Header << TStringBuf("\r\nConnection: close");
-                        } else if (Y_LIKELY(theVer.Major > 1 || theVer.Minor > 0)) {
-                            // since HTTP/1.1 Keep-Alive is default behaviour
-                            Header << TStringBuf("\r\nConnection: Keep-Alive");
-                        }
-                        if (theHeaders) {
-                            Header << theHeaders;
-                        }
-                        Header << TStringBuf("\r\n\r\n");
+                        const bool compressed = Compress(theData, contentEncoding);
+                        PrintResponseHeader(Header, theVer, theHttpCode, compressed ? contentEncoding : TString(), theData.size(), theHeaders, closeConnection);
 
                         Body.swap(theData);
 
@@ -1655,6 +1672,39 @@ namespace {
                 SendData(requestId, sd);
             }
 
+            //called non thread-safe (from outside thread)
+            //segments are passed to writev as is, without copying into single buffer
+            void Send(TAtomicBase requestId, TDataParts& parts, const THttpVersion& ver, const TString& headers, int httpCode) {
+                class TBuffers: public TTcpSocket::IBuffers {
+                public:
+                    TBuffers(TDataParts& theParts, const THttpVersion& theVer, const TString& theHeaders, int theHttpCode, bool closeConnection)
+                        : Segments(theParts.Parts())
+                    {
+                        Header.Reserve(128 + theHeaders.size());
+                        PrintResponseHeader(Header, theVer, theHttpCode, TString(), theParts.Size(), theHeaders, closeConnection);
+
+                        Parts.reserve(1 + Segments.size());
+                        Parts.push_back(IOutputStream::TPart(Header.Data(), Header.Size()));
+                        for (const TBlob& segment : Segments) {
+                            Parts.push_back(IOutputStream::TPart(segment.Data(), segment.Size()));
+                        }
+                        IOVec = TContIOVector(Parts.data(), Parts.size());
+                    }
+
+                    TContIOVector* GetIOvec() override {
+                        return &IOVec;
+                    }
+
+                    TStringStream Header;
+                    TVector<TBlob> Segments;
+                    TVector<IOutputStream::TPart> Parts;
+                    TContIOVector IOVec{nullptr, 0};
+                };
+
+                TTcpSocket::TSendedData sd(new TBuffers(parts, ver, headers, httpCode, SeenMessageWithoutKeepalive_));
+                SendData(requestId, sd);
+            }
+
             //called non thread-safe (from outside thread)
             void SendError(TAtomicBase requestId, unsigned httpCode, const TString& descr, const THttpVersion& ver) {
                 if (Canceled_) {
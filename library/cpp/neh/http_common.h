@@ -21,10 +21,25 @@ namespace NNeh {
     public:
         using IRequest::SendReply;
         virtual void SendReply(TData& data, const TString& headers, int httpCode = 200) = 0;
+
+        inline void SendReply(TDataParts& parts, const TString& headers, int httpCode = 200) {
+            DoSendReply(parts, headers, httpCode);
+        }
+
         virtual const THttpHeaders& Headers() const = 0;
         virtual TStringBuf Method() const = 0;
         virtual TStringBuf Body() const = 0;
         virtual TStringBuf Cgi() const = 0;
+
+    protected:
+        void DoSendReply(TDataParts& parts) override {
+            DoSendReply(parts, TString(), 200);
+        }
+
+        virtual void DoSendReply(TDataParts& parts, const TString& headers, int httpCode) {
+            TData data = parts.Coalesce();
+            SendReply(data, headers, httpCode);
+        }
     };
 
     namespace NHttp {
@@ -393,4 +393,22 @@ Y_UNIT_TEST_SUITE(NehHttp) {
             UNIT_ASSERT_STRING_CONTAINS(resp->FirstLine, "HTTP/1.1 503 service unavailable");
         }
     }
+
+    Y_UNIT_TEST(TSendReplyParts) {
+        const TString big(1 << 20, 'x');
+        TServ serv = CreateServices([&big](const IRequestRef& req) {
+            TDataParts parts;
+            parts.Append(TString("head:"));
+            parts.Append(TBlob::NoCopy(big.data(), big.size()));
+            parts.Append(TString(":tail"));
+            auto* httpReq = dynamic_cast<IHttpRequest*>(req.Get());
+            httpReq->SendReply(parts, "\r\nContent-Type: text/plain");
+        });
+
+        TResponseRef resp = NNeh::Request("http://localhost:" + ToString(serv.ServerPort) + "/pipeline?")->Wait();
+        UNIT_ASSERT_C(resp && !resp->IsError(), resp ? resp->GetErrorText() : TString("no response"));
+        UNIT_ASSERT_VALUES_EQUAL(resp->Data.size(), big.size() + 10);
+        UNIT_ASSERT(resp->Data == "head:" + big + ":tail");
+        UNIT_ASSERT_VALUES_EQUAL(resp->Headers.FindHeader("Content-Type")->Value(), "text/plain");
+    }
 }
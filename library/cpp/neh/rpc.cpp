@@ -7,12 +7,26 @@
 #include <library/cpp/threading/thread_local/thread_local.h>
 
 #include <util/generic/hash.h>
+#include <util/system/filemap.h>
 #include <util/thread/factory.h>
 #include <util/system/yield.h>
 #include <util/system/spinlock.h>
 
 using namespace NNeh;
 
+void TDataParts::AppendFile(const TString& path, ui64 offset, size_t length) {
+    Append(TBlob::FromMemoryMap(TMemoryMap(path), offset, length));
+}
+
+TData TDataParts::Coalesce() const {
+    TData data;
+    data.reserve(Size_);
+    for (const TBlob& part : Parts_) {
+        data.insert(data.end(), part.AsCharPtr(), part.AsCharPtr() + part.Size());
+    }
+    return data;
+}
+
 namespace {
     typedef std::pair<TString, IServiceRef> TServiceDescr;
     typedef TVector<TServiceDescr> TServicesBase;
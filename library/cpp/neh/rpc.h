@@ -5,6 +5,7 @@
 #include <util/generic/string.h>
 #include <util/generic/strbuf.h>
 #include <util/generic/maybe.h>
+#include <util/memory/blob.h>
 #include <util/stream/output.h>
 #include <util/datetime/base.h>
 #include <functional>
@@ -24,6 +25,46 @@ namespace NNeh {
         }
     };
 
+    /// List of refcounted reply segments, sent with writev without coalescing into a single TData.
+    class TDataParts {
+    public:
+        TDataParts() = default;
+
+        inline void Append(TBlob part) {
+            if (part.Size()) {
+                Size_ += part.Size();
+                Parts_.push_back(std::move(part));
+            }
+        }
+
+        inline void Append(TString part) {
+            Append(TBlob::FromString(std::move(part)));
+        }
+
+        /// Map [offset, offset + length) of file into reply (page cache is shared, no read() copy).
+        void AppendFile(const TString& path, ui64 offset, size_t length);
+
+        inline const TVector<TBlob>& Parts() const noexcept {
+            return Parts_;
+        }
+
+        /// Total bytes over all segments.
+        inline size_t Size() const noexcept {
+            return Size_;
+        }
+
+        inline bool Empty() const noexcept {
+            return !Size_;
+        }
+
+        /// Copy all segments into one contiguous buffer (for transports without scatter/gather support).
+        TData Coalesce() const;
+
+    private:
+        TVector<TBlob> Parts_;
+        size_t Size_ = 0;
+    };
+
     class IRequest {
     public:
         IRequest()
@@ -40,6 +81,13 @@ namespace NNeh {
         virtual TStringBuf RequestId() const = 0;
         virtual bool Canceled() const = 0;
         virtual void SendReply(TData& data) = 0;
+
+        /// send reply built from several segments,
+        /// transports without writev support fall back to SendReply(TData&) with coalesced data
+        inline void SendReply(TDataParts& parts) {
+            DoSendReply(parts);
+        }
+
         enum TResponseError {
             BadRequest,             // bad request data - http_code 400
             Forbidden,              // forbidden request - http_code 403
@@ -57,6 +105,12 @@ namespace NNeh {
             return ArrivalTime_;
         }
 
+    protected:
+        virtual void DoSendReply(TDataParts& parts) {
+            TData data = parts.Coalesce();
+            SendReply(data);
+        }
+
     private:
         TInstant ArrivalTime_;
     };
@@ -0,0 +1,100 @@
+#include <library/cpp/netliba/socket/socket.h>
+#include <library/cpp/netliba/socket/udp_recv_packet.h>
+#include <library/cpp/testing/benchmark/bench.h>
+
+#include <util/datetime/base.h>
+#include <util/generic/vector.h>
+#include <util/system/env.h>
+
+#include <array>
+
+using namespace NNetlibaSocket;
+
+namespace {
+    // one iteration sends a batch of datagrams over loopback and receives all of them
+    class TLoopback {
+    public:
+        static constexpr size_t PacketSize = 1400;
+        static constexpr size_t BatchSize = 64;
+
+        explicit TLoopback(bool offload) {
+            SetEnv("DISABLE_UDP_GSO", offload ? "" : "1");
+            SetEnv("DISABLE_UDP_GRO", offload ? "" : "1");
+            Sender_ = CreateSocket();
+            Receiver_ = CreateBestRecvSocket();
+            Y_VERIFY(Sender_->Open(0) == 0 && Receiver_->Open(0) == 0);
+            SetEnv("DISABLE_UDP_GSO", "");
+            SetEnv("DISABLE_UDP_GRO", "");
+
+            Addr_ = Receiver_->GetSelfAddress();
+            Addr_.sin6_addr = in6addr_loopback;
+            Data_.resize(BatchSize, TVector<char>(PacketSize, 'x'));
+            IoVecs_.resize(BatchSize);
+            Tos_.resize(BatchSize);
+            Headers_.resize(BatchSize);
+            for (size_t i = 0; i != BatchSize; ++i) {
+                IoVecs_[i] = CreateIoVec(Data_[i].data(), Data_[i].size());
+                Zero(Headers_[i]);
+                Headers_[i].msg_hdr = CreateSendMsgHdr(Addr_, IoVecs_[i], CreateTos(0, Tos_[i].data()));
+            }
+        }
+
+        bool IsSupported() const {
+            return Sender_->IsSendMMsgSupported();
+        }
+
+        size_t SendRecv() {
+            for (size_t sent = 0; sent < BatchSize;) {
+                const int rv = Sender_->SendMMsg(Headers_.data() + sent, BatchSize - sent, 0);
+                if (rv <= 0) {
+                    break;
+                }
+                sent += rv;
+            }
+
+            size_t received = 0;
+            sockaddr_in6 src;
+            sockaddr_in6 dst;
+            while (received < BatchSize * PacketSize) {
+                TUdpRecvPacket* pkt = Receiver_->Recv(&src, &dst);
+                if (!pkt) {
+                    // lost datagrams are not waited for longer
+                    Receiver_->Wait(0.01f);
+                    if (!(pkt = Receiver_->Recv(&src, &dst))) {
+                        break;
+                    }
+                }
+                received += pkt->DataSize;
+                delete pkt;
+            }
+            return received;
+        }
+
+    private:
+        TIntrusivePtr<ISocket> Sender_;
+        TIntrusivePtr<ISocket> Receiver_;
+        sockaddr_in6 Addr_;
+        TVector<TVector<char>> Data_;
+        TVector<TIoVec> IoVecs_;
+        TVector<std::array<char, TOS_BUFFER_SIZE>> Tos_;
+        TVector<TMMsgHdr> Headers_;
+    };
+
+    void RunLoopback(bool offload, const NBench::NCpu::TParams& iface) {
+        TLoopback loopback(offload);
+        if (!loopback.IsSupported()) {
+            return;
+        }
+        for (size_t i = 0; i < iface.Iterations(); ++i) {
+            Y_DO_NOT_OPTIMIZE_AWAY(loopback.SendRecv());
+        }
+    }
+}
+
+Y_CPU_BENCHMARK(LoopbackSendMMsgRecvMMsg, iface) {
+    RunLoopback(false, iface);
+}
+
+Y_CPU_BENCHMARK(LoopbackUdpGsoGro, iface) {
+    RunLoopback(true, iface);
+}
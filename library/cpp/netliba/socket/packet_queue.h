@@ -58,8 +58,7 @@ namespace NNetlibaSocket {
                 return false;
             }
             AtomicAdd(NumPackets, 1);
-            AtomicAdd(DataSize, packet->DataSize);
-            Y_ASSERT(packet->DataStart == 0);
+            AtomicAdd(DataSize, packet->GetMemorySize());
 
             Queue.Enqueue(TPacket(std::make_pair(packet, meta)));
             QueueEvent.Signal();
@@ -80,7 +79,7 @@ namespace NNetlibaSocket {
             *dstAddr = p.second.MyAddr;
 
             AtomicSub(NumPackets, 1);
-            AtomicSub(DataSize, (*packet)->DataSize);
+            AtomicSub(DataSize, (*packet)->GetMemorySize());
             Y_ASSERT(AtomicGet(NumPackets) >= 0 && AtomicGet(DataSize) >= 0);
 
             return true;
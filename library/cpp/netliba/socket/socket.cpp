@@ -30,6 +30,17 @@
 
 #ifdef _linux_
 #include <dlfcn.h> // dlsym
+#include <netinet/udp.h>
+// UDP segmentation/receive offload, linux 4.18 and 5.0, may be missing in old headers
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
 #endif
 
 template <class T>
@@ -55,6 +66,18 @@ namespace NNetlibaSocket {
     static const TSendMMsgFunc SendMMsgFunc = GetAddressOf<TSendMMsgFunc>("sendmmsg");
     static const TRecvMMsgFunc RecvMMsgFunc = GetAddressOf<TRecvMMsgFunc>("recvmmsg");
 
+#ifdef _linux_
+    // kernel limits for one UDP_SEGMENT send: UDP_MAX_SEGMENTS, ip datagram size and UIO_MAXIOV
+    constexpr size_t GSO_MAX_SEGMENTS = 64;
+    constexpr size_t GSO_MAX_BYTES = 65000;
+    constexpr size_t GSO_MAX_IOVECS = 1024;
+    constexpr size_t GSO_CTRL_BUFFER_SIZE = CTRL_BUFFER_SIZE + CMSG_SPACE(sizeof(ui16));
+    // room for UDP_GRO segment size message
+    constexpr size_t RECV_CTRL_BUFFER_SIZE = CTRL_BUFFER_SIZE + CMSG_SPACE(sizeof(int));
+#else
+    constexpr size_t RECV_CTRL_BUFFER_SIZE = CTRL_BUFFER_SIZE;
+#endif
+
     ///////////////////////////////////////////////////////////////////////////////
 
     bool ReadTos(const TMsgHdr& msgHdr, ui8* tos) {
@@ -108,6 +131,11 @@ namespace NNetlibaSocket {
         int CreateSocket(int netPort);
         int DetectSelfAddress();
 
+#ifdef _linux_
+        TAtomic GsoEnabled = 0;
+        int SendMMsgGso(TMMsgHdr* msgvec, unsigned int vlen, unsigned int flags);
+#endif
+
     protected:
         int SetSockOpt(int level, int option_name, const void* option_value, socklen_t option_len);
 
@@ -117,6 +145,8 @@ namespace NNetlibaSocket {
         void WaitImpl(float timeoutSec) const;
         void CancelWaitImpl(const sockaddr_in6* address = nullptr); // NULL means "self"
 
+        bool EnableUdpGro();
+
         ssize_t RecvMsgImpl(TMsgHdr* hdr, int flags);
         TUdpRecvPacket* RecvImpl(TUdpHostRecvBufAlloc* buf, sockaddr_in6* srcAddr, sockaddr_in6* dstAddr);
         int RecvMMsgImpl(TMMsgHdr* msgvec, unsigned int vlen, unsigned int flags, timespec* timeout);
@@ -150,6 +180,7 @@ namespace NNetlibaSocket {
         void CancelWaitHost(const sockaddr_in6 addr) override;
 
         bool IsSendMMsgSupported() const override;
+        bool IsUdpGsoEnabled() const override;
         int SendMMsg(TMMsgHdr* msgvec, unsigned int vlen, unsigned int flags) override;
         ssize_t SendMsg(const TMsgHdr* hdr, int flags, const EFragFlag frag) override;
         bool IncreaseSendBuff() override;
@@ -209,6 +240,15 @@ namespace NNetlibaSocket {
 #endif
         }
 #endif
+#ifdef _linux_
+        {
+            // raw getsockopt: GetSockOpt verifies success in debug build
+            int gsoSize = 0;
+            socklen_t sz = sizeof(gsoSize);
+            const bool supported = getsockopt(S, SOL_UDP, UDP_SEGMENT, &gsoSize, &sz) == 0;
+            AtomicSet(GsoEnabled, supported && SendMMsgFunc && !GetEnv("DISABLE_UDP_GSO"));
+        }
+#endif
 
         Poller.WaitRead(S, nullptr);
 
@@ -344,15 +384,164 @@ namespace NNetlibaSocket {
         return SendMMsgFunc != nullptr;
     }
 
+    bool TAbstractSocket::IsUdpGsoEnabled() const {
+#ifdef _linux_
+        return AtomicGet(GsoEnabled);
+#else
+        return false;
+#endif
+    }
+
     int TAbstractSocket::SendMMsg(TMMsgHdr* msgvec, unsigned int vlen, unsigned int flags) {
         Y_ASSERT(IsValid());
         Y_VERIFY(SendMMsgFunc, "sendmmsg is not supported!");
         TReadGuard rg(Mutex);
         static bool checked = 0;
         Y_VERIFY(checked || (checked = !IsFragmentationForbiden()), "Send methods of this class expect default EnableFragmentation behavior");
+#ifdef _linux_
+        if (vlen > 1 && AtomicGet(GsoEnabled)) {
+            return SendMMsgGso(msgvec, vlen, flags);
+        }
+#endif
         return SendMMsgFunc(S, msgvec, vlen, flags);
     }
 
+#ifdef _linux_
+    static size_t GetMsgDataSize(const TMsgHdr& hdr) {
+        size_t size = 0;
+        for (size_t i = 0; i != (size_t)hdr.msg_iovlen; ++i) {
+            size += hdr.msg_iov[i].iov_len;
+        }
+        return size;
+    }
+
+    static bool HaveSameSendParams(const TMsgHdr& a, const TMsgHdr& b) {
+        return a.msg_namelen == b.msg_namelen && memcmp(a.msg_name, b.msg_name, a.msg_namelen) == 0 &&
+               a.msg_controllen == b.msg_controllen && (a.msg_controllen == 0 || memcmp(a.msg_control, b.msg_control, a.msg_controllen) == 0);
+    }
+
+    namespace {
+        struct alignas(cmsghdr) TGsoCtrlBuffer {
+            char Data[GSO_CTRL_BUFFER_SIZE];
+        };
+
+        // per thread scratch space: send methods are thread safe
+        struct TGsoBatch {
+            TVector<TMMsgHdr> Headers;
+            TVector<TIoVec> IoVecs;
+            TVector<TGsoCtrlBuffer> CtrlBuffers;
+            TVector<unsigned int> Counts; // number of user messages in every header
+        };
+    }
+
+    // Consecutive datagrams with the same destination, control data and size (the last one may be shorter)
+    // are sent as one UDP_SEGMENT message. User iovecs are referenced, not copied.
+    // Returns number of user messages sent, like sendmmsg does.
+    int TAbstractSocket::SendMMsgGso(TMMsgHdr* msgvec, unsigned int vlen, unsigned int flags) {
+        static thread_local TGsoBatch batch;
+        batch.Counts.clear();
+
+        size_t numIoVecs = 0;
+        for (size_t i = 0; i < vlen;) {
+            const TMsgHdr& first = msgvec[i].msg_hdr;
+            const size_t segSize = GetMsgDataSize(first);
+            size_t total = segSize;
+            size_t iovs = first.msg_iovlen;
+            size_t j = i + 1;
+            if (segSize > 0 && first.msg_controllen <= CTRL_BUFFER_SIZE) {
+                for (; j < vlen && j - i < GSO_MAX_SEGMENTS; ++j) {
+                    const TMsgHdr& next = msgvec[j].msg_hdr;
+                    const size_t size = GetMsgDataSize(next);
+                    if (size == 0 || size > segSize || total + size > GSO_MAX_BYTES || iovs + next.msg_iovlen > GSO_MAX_IOVECS || !HaveSameSendParams(first, next)) {
+                        break;
+                    }
+                    total += size;
+                    iovs += next.msg_iovlen;
+                    if (size < segSize) {
+                        ++j;
+                        break;
+                    }
+                }
+            }
+            batch.Counts.push_back(j - i);
+            numIoVecs += j - i > 1 ? iovs : 0;
+            i = j;
+        }
+
+        const size_t numGroups = batch.Counts.size();
+        if (numGroups == vlen) {
+            return SendMMsgFunc(S, msgvec, vlen, flags);
+        }
+
+        batch.Headers.resize(numGroups);
+        batch.IoVecs.resize(numIoVecs);
+        batch.CtrlBuffers.resize(numGroups);
+
+        TMMsgHdr* src = msgvec;
+        TIoVec* iov = batch.IoVecs.data();
+        for (size_t g = 0; g != numGroups; ++g) {
+            const unsigned int count = batch.Counts[g];
+            TMMsgHdr& dst = batch.Headers[g];
+            dst = *src;
+            if (count > 1) {
+                TMsgHdr& hdr = dst.msg_hdr;
+                hdr.msg_iov = iov;
+                hdr.msg_iovlen = 0;
+                for (unsigned int k = 0; k != count; ++k) {
+                    const TMsgHdr& part = src[k].msg_hdr;
+                    memcpy(iov, part.msg_iov, part.msg_iovlen * sizeof(TIoVec));
+                    iov += part.msg_iovlen;
+                    hdr.msg_iovlen += part.msg_iovlen;
+                }
+
+                char* ctrl = batch.CtrlBuffers[g].Data;
+                memset(ctrl, 0, GSO_CTRL_BUFFER_SIZE);
+                const size_t ctrlLen = CMSG_ALIGN(src->msg_hdr.msg_controllen);
+                if (src->msg_hdr.msg_controllen) {
+                    memcpy(ctrl, src->msg_hdr.msg_control, src->msg_hdr.msg_controllen);
+                }
+                cmsghdr* cmsg = (cmsghdr*)(ctrl + ctrlLen);
+                cmsg->cmsg_level = SOL_UDP;
+                cmsg->cmsg_type = UDP_SEGMENT;
+                cmsg->cmsg_len = CMSG_LEN(sizeof(ui16));
+                const ui16 segSize = (ui16)GetMsgDataSize(src->msg_hdr);
+                memcpy(CMSG_DATA(cmsg), &segSize, sizeof(segSize));
+                hdr.msg_control = ctrl;
+                hdr.msg_controllen = ctrlLen + CMSG_SPACE(sizeof(ui16));
+            }
+            src += count;
+        }
+
+        const int sent = SendMMsgFunc(S, batch.Headers.data(), (unsigned int)numGroups, flags);
+        if (sent <= 0) {
+            const int err = LastSystemError();
+            if (batch.Counts[0] > 1 && (err == EIO || err == EINVAL)) {
+                // no checksum offload on device or segment exceeds path mtu - fall back to plain datagrams
+                const int rv = SendMMsgFunc(S, msgvec, vlen, flags);
+                if (rv > 0 && AtomicCas(&GsoEnabled, 0, 1)) {
+                    fprintf(stderr, "netliba_socket port %d: UDP_SEGMENT send failed (errno = %d), GSO disabled\n", GetPort(), err);
+                }
+                return rv;
+            }
+            return sent;
+        }
+
+        int result = 0;
+        for (int g = 0; g != sent; ++g) {
+            const unsigned int count = batch.Counts[g];
+            if (count == 1) {
+                msgvec[result].msg_len = batch.Headers[g].msg_len;
+            } else {
+                for (unsigned int k = 0; k != count; ++k) {
+                    msgvec[result + k].msg_len = (unsigned int)GetMsgDataSize(msgvec[result + k].msg_hdr);
+                }
+            }
+            result += count;
+        }
+        return result;
+    }
+#endif
+
     ssize_t TAbstractSocket::SendMsg(const TMsgHdr* hdr, int flags, const EFragFlag frag) {
         Y_ASSERT(IsValid());
 #ifdef _win32_
@@ -522,6 +711,20 @@ namespace NNetlibaSocket {
         TAbstractSocket::SendMsg(&hdr, 0, FF_ALLOW_FRAG);
     }
 
+    bool TAbstractSocket::EnableUdpGro() {
+        Y_ASSERT(IsValid());
+#ifdef _linux_
+        if (GetEnv("DISABLE_UDP_GRO")) {
+            return false;
+        }
+        // raw setsockopt: SetSockOpt verifies success in debug build
+        int flag = 1;
+        return setsockopt(S, SOL_UDP, UDP_GRO, &flag, sizeof(flag)) == 0;
+#else
+        return false;
+#endif
+    }
+
     ssize_t TAbstractSocket::RecvMsgImpl(TMsgHdr* hdr, int flags) {
         Y_ASSERT(IsValid());
 
@@ -574,6 +777,9 @@ namespace NNetlibaSocket {
         void CancelWait(int netlibaVersion) override;
 
         bool IsRecvMsgSupported() const override;
+        bool IsUdpGroEnabled() const override {
+            return false;
+        }
         ssize_t RecvMsg(TMsgHdr* hdr, int flags) override;
         TUdpRecvPacket* Recv(sockaddr_in6* srcAddr, sockaddr_in6* dstAddr, int netlibaVersion) override;
 
@@ -622,9 +828,18 @@ namespace NNetlibaSocket {
         size_t RecvPacketsBegin;      // first non returned to user
         size_t RecvPacketsHeadersEnd; // next after last one with data
         TVector<TMMsgHdr> RecvPacketsHeaders;
-        TVector<std::array<char, CTRL_BUFFER_SIZE>> RecvPacketsCtrlBuffers;
+        TVector<std::array<char, RECV_CTRL_BUFFER_SIZE>> RecvPacketsCtrlBuffers;
+
+        // UDP_GRO: coalesced datagram is returned segment by segment
+        bool GroEnabled = false;
+        size_t RecvSegmentOffset = 0; // in RecvPackets[RecvPacketsBegin]
+        size_t RecvSegmentSize = 0;   // 0 - datagram was not coalesced
+        sockaddr_in6 RecvSegmentDstAddr;
+        THolder<TUdpRecvPacket> RecvSegmentBuf; // buffer of coalesced datagram shared by its segments
 
+        void InitRecvQueue(size_t recvQueueSize, int bufSize);
         int FillRecvBuffers();
+        TUdpRecvPacket* RecvSegment(sockaddr_in6* fromAddress, sockaddr_in6* dstAddr);
 
     public:
         static bool IsRecvMMsgSupported();
@@ -634,6 +849,8 @@ namespace NNetlibaSocket {
         // Do not use lower values - for example recvmmsg with 1 element is 3% slower that recvmsg!
         // (tested with junk/f0b0s/neTBasicSocket_queue_test).
         TTryToRecvMMsgSocket(const size_t recvQueueSize = 128);
+        // With UDP_GRO every slot holds up to 64k of coalesced packets, so queue is shorter.
+        static constexpr size_t GRO_RECV_QUEUE_SIZE = 16;
         ~TTryToRecvMMsgSocket() override;
 
         int Open(int port) override;
@@ -645,6 +862,9 @@ namespace NNetlibaSocket {
         bool IsRecvMsgSupported() const override {
             return false;
         }
+        bool IsUdpGroEnabled() const override {
+            return GroEnabled;
+        }
         ssize_t RecvMsg(TMsgHdr* hdr, int flags) override {
             Y_UNUSED(hdr);
             Y_UNUSED(flags);
@@ -665,9 +885,15 @@ namespace NNetlibaSocket {
             return;
         }
 
+        InitRecvQueue(recvQueueSize, UDP_MAX_PACKET_SIZE);
+    }
+
+    void TTryToRecvMMsgSocket::InitRecvQueue(const size_t recvQueueSize, const int bufSize) {
+        Y_ASSERT(RecvPacketsBegin == RecvPacketsHeadersEnd);
+        RecvPackets.Clear();
         RecvPackets.reserve(recvQueueSize);
         for (size_t i = 0; i != recvQueueSize; ++i) {
-            RecvPackets.PushBack(new TUdpHostRecvBufAlloc);
+            RecvPackets.PushBack(new TUdpHostRecvBufAlloc(bufSize));
         }
 
         RecvPacketsSrcAddresses.resize(recvQueueSize);
@@ -681,8 +907,11 @@ namespace NNetlibaSocket {
 
             RecvPacketsIoVecs[i] = CreateIoVec(RecvPackets[i]->GetDataPtr(), RecvPackets[i]->GetBufSize());
             char* buf = RecvPacketsCtrlBuffers[i].data();
-            memset(buf, 0, CTRL_BUFFER_SIZE);
+            memset(buf, 0, RECV_CTRL_BUFFER_SIZE);
             mhdr.msg_hdr = CreateRecvMsgHdr(&RecvPacketsSrcAddresses[i], RecvPacketsIoVecs[i], buf);
+#ifndef _win_
+            mhdr.msg_hdr.msg_controllen = RECV_CTRL_BUFFER_SIZE;
+#endif
         }
     }
 
@@ -691,7 +920,18 @@ namespace NNetlibaSocket {
     }
 
     int TTryToRecvMMsgSocket::Open(int port) {
-        return OpenImpl(port);
+        if (OpenImpl(port) != 0) {
+            return -1;
+        }
+        const bool gro = IsRecvMMsgSupported() && EnableUdpGro();
+        if (gro != GroEnabled) {
+            GroEnabled = gro;
+            RecvPacketsBegin = RecvPacketsHeadersEnd = 0;
+            RecvSegmentOffset = 0;
+            RecvSegmentBuf.Destroy();
+            InitRecvQueue(gro ? Min(RecvPackets.size(), GRO_RECV_QUEUE_SIZE) : RecvPackets.size(), gro ? UDP_MAX_GRO_PACKET_SIZE : UDP_MAX_PACKET_SIZE);
+        }
+        return 0;
     }
 
     void TTryToRecvMMsgSocket::Close() {
@@ -748,6 +988,10 @@ namespace NNetlibaSocket {
             return nullptr;
         }
 
+        if (GroEnabled) {
+            return RecvSegment(fromAddress, dstAddr);
+        }
+
         TUdpRecvPacket* result = RecvPackets[RecvPacketsBegin]->ExtractPacket();
         TMMsgHdr& mmsgHdr = RecvPacketsHeaders[RecvPacketsBegin];
         result->DataSize = (ssize_t)mmsgHdr.msg_len;
@@ -757,14 +1001,69 @@ namespace NNetlibaSocket {
         *fromAddress = RecvPacketsSrcAddresses[RecvPacketsBegin];
         //we must clean ctrlbuffer to be able to use it later
 #ifndef _win_
-        memset(mmsgHdr.msg_hdr.msg_control, 0, CTRL_BUFFER_SIZE);
-        mmsgHdr.msg_hdr.msg_controllen = CTRL_BUFFER_SIZE;
+        memset(mmsgHdr.msg_hdr.msg_control, 0, RECV_CTRL_BUFFER_SIZE);
+        mmsgHdr.msg_hdr.msg_controllen = RECV_CTRL_BUFFER_SIZE;
 #endif
         RecvPacketsBegin++;
 
         return result;
     }
 
+    // Segments of coalesced datagram are views into its buffer (DataStart is the segment offset),
+    // the buffer is extracted from the queue and freed with the last of them. Each segment accounts
+    // for its share of the buffer in PinnedSize, so queues bound the memory of the whole buffer.
+    // Not coalesced datagram is copied into exactly sized packet not to pin 64k buffer for it.
+    TUdpRecvPacket* TTryToRecvMMsgSocket::RecvSegment(sockaddr_in6* fromAddress, sockaddr_in6* dstAddr) {
+        TMMsgHdr& mmsgHdr = RecvPacketsHeaders[RecvPacketsBegin];
+        const size_t totalSize = mmsgHdr.msg_len;
+
+        if (RecvSegmentOffset == 0) {
+            RecvSegmentSize = 0;
+#ifdef _linux_
+            for (cmsghdr* cmsg = CMSG_FIRSTHDR(&mmsgHdr.msg_hdr); cmsg; cmsg = CMSG_NXTHDR(&mmsgHdr.msg_hdr, cmsg)) {
+                if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+                    int segSize = 0;
+                    memcpy(&segSize, CMSG_DATA(cmsg), sizeof(segSize));
+                    RecvSegmentSize = segSize > 0 ? segSize : 0;
+                }
+            }
+#endif
+            ExtractDestinationAddress(mmsgHdr.msg_hdr, &RecvSegmentDstAddr);
+            if (RecvSegmentSize && RecvSegmentSize < totalSize) {
+                RecvSegmentBuf.Reset(RecvPackets[RecvPacketsBegin]->ExtractPacket());
+            }
+        }
+
+        const size_t size = RecvSegmentSize ? Min(RecvSegmentSize, totalSize - RecvSegmentOffset) : totalSize;
+        TUdpRecvPacket* result;
+        if (RecvSegmentBuf) {
+            result = TUdpHostRecvBufAlloc::Clone(RecvSegmentBuf.Get());
+            result->DataStart = (int)RecvSegmentOffset;
+            const size_t bufSize = RecvPackets[RecvPacketsBegin]->GetBufSize();
+            result->PinnedSize = (int)((bufSize * size + totalSize - 1) / totalSize);
+        } else {
+            result = TUdpHostRecvBufAlloc::CreateNewSmallPacket(Max<int>(size, 1));
+            memcpy(result->Data.get(), RecvPackets[RecvPacketsBegin]->GetDataPtr(), size);
+        }
+        result->DataSize = (int)size;
+        if (dstAddr) {
+            *dstAddr = RecvSegmentDstAddr;
+        }
+        *fromAddress = RecvPacketsSrcAddresses[RecvPacketsBegin];
+
+        RecvSegmentOffset += size;
+        if (RecvSegmentOffset >= totalSize) {
+            RecvSegmentOffset = 0;
+            RecvSegmentBuf.Destroy();
+#ifndef _win_
+            memset(mmsgHdr.msg_hdr.msg_control, 0, RECV_CTRL_BUFFER_SIZE);
+            mmsgHdr.msg_hdr.msg_controllen = RECV_CTRL_BUFFER_SIZE;
+#endif
+            RecvPacketsBegin++;
+        }
+        return result;
+    }
+
     ///////////////////////////////////////////////////////////////////////////////
 
     /*  TODO: too slow, needs to be optimized
@@ -904,7 +1203,7 @@ public:
             }
             ui8 Push(TUdpRecvPacket* packet, const TPacketMeta& meta) {
                 if (Queue.IsDataPartFull()) {
-                    const ui8 cmd = packet->Data.get()[CmdPos];
+                    const ui8 cmd = packet->Data.get()[packet->DataStart + CmdPos];
                     if (cmd == F1 || cmd == F2)
                         return PR_FILTERED;
                 }
@@ -1014,12 +1313,12 @@ public:
             sockaddr_in6 srcAddr;
             sockaddr_in6 dstAddr;
             while (AtomicAdd(ShouldDie, 0) == 0 && (p = TBase::Recv(&srcAddr, &dstAddr, NETLIBA_ANY_VERSION))) {
-                Y_ASSERT(p->DataStart == 0);
                 if (p->DataSize < 12) {
                     continue;
                 }
 
-                TFilteredPacketQueue& q = GetRecvQueue(p->Data.get()[8]);
+                // segments of coalesced datagram start at DataStart
+                TFilteredPacketQueue& q = GetRecvQueue(p->Data.get()[p->DataStart + 8]);
                 const ui8 res = q.Push(p, {srcAddr, dstAddr});
                 if (res == TFilteredPacketQueue::PR_OK) {
                     GetQueueEvent(q).Signal();
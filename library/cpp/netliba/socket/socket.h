@@ -107,10 +107,16 @@ namespace NNetlibaSocket {
         virtual void CancelWaitHost(const sockaddr_in6 address) = 0;
 
         virtual bool IsSendMMsgSupported() const = 0;
+        // SendMMsg merges consecutive same-sized datagrams to one destination into UDP_SEGMENT (GSO) sends.
+        // Detected on Open, disabled by DISABLE_UDP_GSO env variable.
+        virtual bool IsUdpGsoEnabled() const = 0;
         virtual int SendMMsg(struct TMMsgHdr* msgvec, unsigned int vlen, unsigned int flags) = 0;
         virtual ssize_t SendMsg(const TMsgHdr* hdr, int flags, const EFragFlag frag) = 0;
 
         virtual bool IsRecvMsgSupported() const = 0;
+        // Recv splits kernel-coalesced (UDP_GRO) datagrams back into original packets.
+        // Detected on Open, disabled by DISABLE_UDP_GRO env variable.
+        virtual bool IsUdpGroEnabled() const = 0;
         virtual ssize_t RecvMsg(TMsgHdr* hdr, int flags) = 0;
         virtual TUdpRecvPacket* Recv(sockaddr_in6* srcAddr, sockaddr_in6* dstAddr, int netlibaVersion = NETLIBA_ANY_VERSION) = 0;
         virtual bool IncreaseSendBuff() = 0;
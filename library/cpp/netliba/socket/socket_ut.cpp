@@ -1,5 +1,10 @@
 #include <library/cpp/testing/unittest/registar.h>
 #include "socket.h"
+
+#include <util/datetime/base.h>
+#include <util/generic/vector.h>
+#include <util/system/env.h>
+
 #include <string.h>
 
 Y_UNIT_TEST_SUITE(TestDarwinQuirks) {
@@ -65,6 +70,199 @@ namespace NNetlibaSocket {
         }
     };
 
+    class TNetlibaSocketOffloadTest: public TTestBase {
+        UNIT_TEST_SUITE(TNetlibaSocketOffloadTest);
+        UNIT_TEST(LoopbackBatchTest);
+        UNIT_TEST(LoopbackBatchNoOffloadTest);
+        UNIT_TEST(DualStackLoopbackTest);
+        UNIT_TEST_SUITE_END();
+
+        struct TOffloadGuard {
+            TOffloadGuard(bool enable) {
+                SetEnv("DISABLE_UDP_GSO", enable ? "" : "1");
+                SetEnv("DISABLE_UDP_GRO", enable ? "" : "1");
+            }
+            ~TOffloadGuard() {
+                SetEnv("DISABLE_UDP_GSO", "");
+                SetEnv("DISABLE_UDP_GRO", "");
+            }
+        };
+
+        struct TSendBatch: public TNonCopyable {
+            const sockaddr_in6 Addr;
+            TVector<TVector<char>> Data;
+            TVector<TIoVec> IoVecs;
+            TVector<std::array<char, TOS_BUFFER_SIZE>> Tos;
+            TVector<TMMsgHdr> Headers;
+
+            TSendBatch(const sockaddr_in6& addr, const TVector<size_t>& sizes, ui8 tos = 0)
+                : Addr(addr)
+            {
+                Data.resize(sizes.size());
+                IoVecs.resize(sizes.size());
+                Tos.resize(sizes.size());
+                Headers.resize(sizes.size());
+                for (size_t i = 0; i != sizes.size(); ++i) {
+                    Data[i].resize(sizes[i]);
+                    for (size_t j = 0; j != sizes[i]; ++j) {
+                        Data[i][j] = (char)(i * 7 + j);
+                    }
+                    IoVecs[i] = CreateIoVec(Data[i].data(), Data[i].size());
+                    Zero(Headers[i]);
+                    Headers[i].msg_hdr = CreateSendMsgHdr(Addr, IoVecs[i], CreateTos(tos, Tos[i].data()));
+                }
+            }
+        };
+
+        static sockaddr_in6 GetLoopbackAddress(const ISocket& s) {
+            sockaddr_in6 addr = s.GetSelfAddress();
+            addr.sin6_addr = in6addr_loopback;
+            return addr;
+        }
+
+        static size_t SendAll(ISocket* s, TMMsgHdr* msgs, size_t count) {
+            size_t sent = 0;
+            while (sent < count) {
+                const int rv = s->SendMMsg(msgs + sent, count - sent, 0);
+                if (rv <= 0) {
+                    break;
+                }
+                sent += rv;
+            }
+            return sent;
+        }
+
+        void CheckLoopbackBatch(bool offload) {
+            TOffloadGuard guard(offload);
+            TIntrusivePtr<ISocket> sender = CreateSocket();
+            TIntrusivePtr<ISocket> receiver = CreateBestRecvSocket();
+            UNIT_ASSERT_EQUAL(sender->Open(0), 0);
+            UNIT_ASSERT_EQUAL(receiver->Open(0), 0);
+            if (!sender->IsSendMMsgSupported()) {
+                return;
+            }
+            if (!offload) {
+                UNIT_ASSERT(!sender->IsUdpGsoEnabled());
+                UNIT_ASSERT(!receiver->IsUdpGroEnabled());
+            }
+
+            // runs of equal sizes with shorter tails, single packets and tos change in between
+            TVector<size_t> sizes;
+            for (size_t i = 0; i != 10; ++i) {
+                sizes.push_back(1400);
+            }
+            sizes.push_back(700);
+            sizes.push_back(1400);
+            sizes.push_back(1400);
+            sizes.push_back(33);
+            sizes.push_back(2000);
+            for (size_t i = 0; i != 80; ++i) {
+                sizes.push_back(1000);
+            }
+            sizes.push_back(1);
+
+            const sockaddr_in6 addr = GetLoopbackAddress(*receiver);
+            TSendBatch batch(addr, sizes);
+            TSendBatch other(addr, {1000, 1000}, 32);
+            std::swap(batch.Headers[5], other.Headers[0]);
+            std::swap(batch.Data[5], other.Data[0]);
+
+            // send by chunks to stay within default socket receive buffer
+            const size_t chunk = 32;
+            size_t received = 0;
+            const TInstant deadline = TDuration::Seconds(5).ToDeadLine();
+            for (size_t sent = 0; sent < sizes.size();) {
+                const size_t count = Min(chunk, sizes.size() - sent);
+                UNIT_ASSERT_VALUES_EQUAL(SendAll(sender.Get(), batch.Headers.data() + sent, count), count);
+                sent += count;
+
+                while (received < sent && Now() < deadline) {
+                    sockaddr_in6 src;
+                    sockaddr_in6 dst;
+                    TUdpRecvPacket* pkt = receiver->Recv(&src, &dst);
+                    if (!pkt) {
+                        receiver->Wait(0.1f);
+                        continue;
+                    }
+                    THolder<TUdpRecvPacket> holder(pkt);
+                    const TVector<char>& expected = batch.Data[received];
+                    // segments of a coalesced datagram are views into one buffer
+                    UNIT_ASSERT_VALUES_EQUAL((size_t)pkt->DataSize, expected.size());
+                    UNIT_ASSERT(memcmp(pkt->Data.get() + pkt->DataStart, expected.data(), expected.size()) == 0);
+                    UNIT_ASSERT_VALUES_EQUAL(src.sin6_port, sender->GetSelfAddress().sin6_port);
+                    ++received;
+                }
+            }
+            for (const TMMsgHdr& h : batch.Headers) {
+                UNIT_ASSERT_VALUES_EQUAL(h.msg_len, h.msg_hdr.msg_iov->iov_len);
+            }
+            UNIT_ASSERT_VALUES_EQUAL(received, sizes.size());
+        }
+
+        void LoopbackBatchTest() {
+            CheckLoopbackBatch(true);
+        }
+
+        void LoopbackBatchNoOffloadTest() {
+            CheckLoopbackBatch(false);
+        }
+
+        // equal sized packets of both netliba versions are coalesced together and must be routed by their own headers
+        void DualStackLoopbackTest() {
+            TOffloadGuard guard(true);
+            TIntrusivePtr<ISocket> sender = CreateSocket();
+            TIntrusivePtr<ISocket> receiver = CreateDualStackSocket();
+            UNIT_ASSERT_EQUAL(sender->Open(0), 0);
+            UNIT_ASSERT_EQUAL(receiver->Open(0), 0);
+            if (!sender->IsSendMMsgSupported()) {
+                return;
+            }
+
+            const size_t count = 96;
+            TSendBatch batch(GetLoopbackAddress(*receiver), TVector<size_t>(count, 1400));
+            TVector<size_t> expected[2];
+            for (size_t i = 0; i != count; ++i) {
+                const bool v12 = i % 3 == 0;
+                batch.Data[i][8] = v12 ? (char)NETLIBA_V12_VERSION : 6;
+                expected[v12].push_back(i);
+            }
+
+            const size_t chunk = 32;
+            size_t received[2] = {0, 0};
+            const TInstant deadline = TDuration::Seconds(5).ToDeadLine();
+            for (size_t sent = 0; sent < count;) {
+                const size_t n = Min(chunk, count - sent);
+                UNIT_ASSERT_VALUES_EQUAL(SendAll(sender.Get(), batch.Headers.data() + sent, n), n);
+                sent += n;
+
+                while (received[0] + received[1] < sent && Now() < deadline) {
+                    bool any = false;
+                    for (const bool v12 : {false, true}) {
+                        sockaddr_in6 src;
+                        sockaddr_in6 dst;
+                        TUdpRecvPacket* pkt = receiver->Recv(&src, &dst, v12 ? NETLIBA_V12_VERSION : NETLIBA_ANY_VERSION);
+                        if (!pkt) {
+                            continue;
+                        }
+                        THolder<TUdpRecvPacket> holder(pkt);
+                        any = true;
+                        UNIT_ASSERT(received[v12] < expected[v12].size());
+                        const TVector<char>& data = batch.Data[expected[v12][received[v12]]];
+                        UNIT_ASSERT_VALUES_EQUAL((size_t)pkt->DataSize, data.size());
+                        UNIT_ASSERT(memcmp(pkt->Data.get() + pkt->DataStart, data.data(), data.size()) == 0);
+                        ++received[v12];
+                    }
+                    if (!any) {
+                        receiver->Wait(0.01f, NETLIBA_V12_VERSION);
+                    }
+                }
+            }
+            UNIT_ASSERT_VALUES_EQUAL(received[0], expected[0].size());
+            UNIT_ASSERT_VALUES_EQUAL(received[1], expected[1].size());
+        }
+    };
+
     UNIT_TEST_SUITE_REGISTRATION(TNetlibaSocketTosTest);
     UNIT_TEST_SUITE_REGISTRATION(TNetlibaSocketAuxTest);
+    UNIT_TEST_SUITE_REGISTRATION(TNetlibaSocketOffloadTest);
 }
@@ -8,13 +8,22 @@
 
 namespace NNetlibaSocket {
     enum { UDP_MAX_PACKET_SIZE = 8900 };
+    // recv buffer size for sockets with UDP_GRO: kernel may coalesce segments up to 64k
+    enum { UDP_MAX_GRO_PACKET_SIZE = 65536 };
 
     class TUdpHostRecvBufAlloc;
     struct TUdpRecvPacket: public TWithCustomAllocator {
         friend class TUdpHostRecvBufAlloc;
         int DataStart = 0, DataSize = 0;
+        // share of the buffer held by a segment of coalesced datagram, the buffer is shared by all its segments
+        int PinnedSize = 0;
         std::shared_ptr<char> Data;
 
+        // memory accounted for the packet in receive queues
+        int GetMemorySize() const {
+            return PinnedSize ? PinnedSize : DataSize;
+        }
+
     private:
         int ArraySize_ = 0;
     };
@@ -24,6 +33,7 @@ namespace NNetlibaSocket {
     class TUdpHostRecvBufAlloc: public TNonCopyable {
     private:
         mutable TUdpRecvPacket* RecvPktBuf;
+        const int BufSize;
 
         static TUdpRecvPacket* Alloc() {
             return new TUdpRecvPacket();
@@ -37,7 +47,7 @@ namespace NNetlibaSocket {
             return result;
         }
         void SetNewPacket() const {
-            RecvPktBuf = CreateNewPacket();
+            RecvPktBuf = Create(BufSize);
         }
 
     public:
@@ -51,12 +61,15 @@ namespace NNetlibaSocket {
             TUdpRecvPacket* result = Alloc();
             result->DataStart = pkt->DataStart;
             result->DataSize = pkt->DataSize;
+            result->PinnedSize = pkt->PinnedSize;
             result->Data = pkt->Data;
             result->ArraySize_ = pkt->ArraySize_;
             return result;
         }
 
-        TUdpHostRecvBufAlloc() {
+        explicit TUdpHostRecvBufAlloc(const int bufSize = UDP_MAX_PACKET_SIZE)
+            : BufSize(bufSize)
+        {
             SetNewPacket();
         }
         ~TUdpHostRecvBufAlloc() {
@@ -12,6 +12,7 @@ namespace NNetliba_v12 {
 
     float TCongestionControl::StartWindowSize = 3;
     float TCongestionControl::MaxPacketRate = 0; // unlimited
+    ECongestionAlgorithm TCongestionControl::DefaultAlgorithm = CA_WINDOW;
 
     bool UseTOSforAcks = false; //true;//
 
@@ -46,6 +47,218 @@ namespace NNetliba_v12 {
         AvrgRTT2 *= Sqr(F_RTT_DECAY_RATE);
     }
 
+    //////////////////////////////////////////////////////////////////////////
+    ICongestionAlgorithm* CreateCongestionAlgorithm(ECongestionAlgorithm algorithm, float channelInflate, TPingTracker* pingTracker) {
+        switch (algorithm) {
+            case CA_BBR:
+                return new TBbrCongestionAlgorithm(channelInflate, pingTracker);
+            case CA_WINDOW:
+                break;
+        }
+        return new TWindowCongestionAlgorithm(channelInflate, pingTracker);
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    static const float BBR_PROBE_BW_GAINS[] = {1.25f, 0.75f, 1, 1, 1, 1, 1, 1};
+    static const int BBR_PROBE_BW_CYCLE = Y_ARRAY_SIZE(BBR_PROBE_BW_GAINS);
+
+    TBbrCongestionAlgorithm::TBbrCongestionAlgorithm(const float channelInflate, TPingTracker* pingTracker)
+        : PingTracker(pingTracker)
+        , InitialCwnd(Max(1.0f, TCongestionControl::StartWindowSize * channelInflate))
+        , Mode(STARTUP)
+        , BwSampleIdx(0)
+        , BtlBw(0)
+        , MinRTT(0)
+        , MinRTTAge(0)
+        , ProbeRTTMin(0)
+        , RoundTime(0)
+        , RoundAcked(0)
+        , RoundLost(0)
+        , RoundLimited(false)
+        , FullBw(0)
+        , FullBwRounds(0)
+        , FilledPipe(false)
+        , CycleIndex(0)
+        , ModeTime(0)
+        , LossBackoff(1)
+        , PacingGain(CONG_CTRL_BBR_HIGH_GAIN)
+        , CwndGain(CONG_CTRL_BBR_HIGH_GAIN)
+        , Cwnd(InitialCwnd)
+        , PacingRate(0)
+        , Tokens(InitialCwnd)
+        , SendLimited(false)
+    {
+        Zero(BwSamples);
+        UpdateControls();
+    }
+
+    bool TBbrCongestionAlgorithm::CanSend(float packetsInFly) {
+        // window below one packet still lets single packet through, pacing rate limits how often
+        const bool windowOk = packetsInFly + 1 <= Cwnd || packetsInFly == 0;
+        if (!windowOk || Tokens < 1) {
+            SendLimited = true;
+            RoundLimited = true;
+            return false;
+        }
+        return true;
+    }
+
+    void TBbrCongestionAlgorithm::OnLaunch() {
+        Tokens -= 1;
+    }
+
+    void TBbrCongestionAlgorithm::OnRTT(float rtt) {
+        if (MinRTT == 0 || rtt < MinRTT) {
+            MinRTT = rtt;
+            MinRTTAge = 0;
+        }
+        if (Mode == PROBE_RTT) {
+            ProbeRTTMin = ProbeRTTMin == 0 ? rtt : Min(ProbeRTTMin, rtt);
+        }
+    }
+
+    void TBbrCongestionAlgorithm::OnAck() {
+        RoundAcked += 1;
+        LossBackoff = 1;
+    }
+
+    void TBbrCongestionAlgorithm::OnLoss() {
+        RoundLost += 1;
+    }
+
+    float TBbrCongestionAlgorithm::GetRoundTime() const {
+        return Max(CONG_CTRL_BBR_MIN_ROUND, MinRTT > 0 ? MinRTT : PingTracker->GetRTT());
+    }
+
+    void TBbrCongestionAlgorithm::SetMode(EMode mode) {
+        Mode = mode;
+        ModeTime = 0;
+        switch (mode) {
+            case STARTUP:
+                PacingGain = CONG_CTRL_BBR_HIGH_GAIN;
+                CwndGain = CONG_CTRL_BBR_HIGH_GAIN;
+                break;
+            case DRAIN:
+                PacingGain = 1 / CONG_CTRL_BBR_HIGH_GAIN;
+                CwndGain = CONG_CTRL_BBR_HIGH_GAIN;
+                break;
+            case PROBE_BW:
+                // random phase desynchronizes flows, but never start with draining phase
+                CycleIndex = NetAckRnd() % (BBR_PROBE_BW_CYCLE - 1);
+                CycleIndex += CycleIndex > 0;
+                PacingGain = BBR_PROBE_BW_GAINS[CycleIndex];
+                CwndGain = CONG_CTRL_BBR_CWND_GAIN;
+                break;
+            case PROBE_RTT:
+                PacingGain = 1;
+                CwndGain = 1;
+                ProbeRTTMin = 0;
+                break;
+        }
+    }
+
+    void TBbrCongestionAlgorithm::EndRound() {
+        const float rate = RoundAcked / RoundTime;
+        // rounds where we had nothing to send underestimate bandwidth, use them only to raise the estimate
+        if (RoundLimited || rate > BtlBw) {
+            BwSamples[BwSampleIdx] = rate;
+            BwSampleIdx = (BwSampleIdx + 1) % BW_FILTER_ROUNDS;
+            BtlBw = *MaxElement(BwSamples, BwSamples + BW_FILTER_ROUNDS);
+        }
+
+        if (RoundAcked == 0 && RoundLost > 0) {
+            // nothing gets through, back off like window algorithm does for dead hosts
+            if (Cwnd <= CONG_CTRL_MIN_WINDOW) {
+                if (PingTracker->GetRTT() / CONG_CTRL_MIN_WINDOW < CONG_CTRL_MINIMAL_SEND_INTERVAL)
+                    PingTracker->IncreaseRTT();
+            } else {
+                LossBackoff *= 0.5f;
+            }
+        }
+
+        if (!FilledPipe && RoundLimited) {
+            if (BtlBw >= FullBw * CONG_CTRL_BBR_FULL_BW_GROWTH) {
+                FullBw = BtlBw;
+                FullBwRounds = 0;
+            } else if (++FullBwRounds >= CONG_CTRL_BBR_FULL_BW_ROUNDS) {
+                FilledPipe = true;
+                if (Mode == STARTUP) {
+                    SetMode(DRAIN);
+                }
+            }
+        }
+
+        RoundTime = 0;
+        RoundAcked = 0;
+        RoundLost = 0;
+        RoundLimited = false;
+    }
+
+    void TBbrCongestionAlgorithm::UpdateControls() {
+        if (BtlBw > 0 && MinRTT > 0) {
+            Cwnd = Max(CONG_CTRL_BBR_MIN_CWND, CwndGain * BtlBw * MinRTT);
+            PacingRate = PacingGain * BtlBw;
+        } else {
+            Cwnd = InitialCwnd;
+            PacingRate = PacingGain * InitialCwnd / GetRoundTime();
+        }
+        if (Mode == PROBE_RTT) {
+            Cwnd = Min(Cwnd, CONG_CTRL_BBR_MIN_CWND);
+        }
+        Cwnd = Max(CONG_CTRL_MIN_WINDOW, Cwnd * LossBackoff);
+        PacingRate *= LossBackoff;
+        if (TCongestionControl::MaxPacketRate > 0) {
+            PacingRate = Min(PacingRate, TCongestionControl::MaxPacketRate);
+        }
+    }
+
+    void TBbrCongestionAlgorithm::Update(float deltaT, float packetsInFly, float* resMaxWaitTime) {
+        MinRTTAge += deltaT;
+        RoundTime += deltaT;
+        ModeTime += deltaT;
+        if (RoundTime >= GetRoundTime()) {
+            EndRound();
+        }
+
+        switch (Mode) {
+            case STARTUP:
+                break;
+            case DRAIN:
+                if (packetsInFly <= BtlBw * MinRTT) {
+                    SetMode(PROBE_BW);
+                }
+                break;
+            case PROBE_BW:
+                if (ModeTime >= GetRoundTime()) {
+                    ModeTime = 0;
+                    CycleIndex = (CycleIndex + 1) % BBR_PROBE_BW_CYCLE;
+                    PacingGain = BBR_PROBE_BW_GAINS[CycleIndex];
+                }
+                break;
+            case PROBE_RTT:
+                if (ModeTime > Max(CONG_CTRL_BBR_PROBE_RTT_TIME, GetRoundTime())) {
+                    if (ProbeRTTMin > 0) {
+                        MinRTT = ProbeRTTMin;
+                    }
+                    MinRTTAge = 0;
+                    SetMode(FilledPipe ? PROBE_BW : STARTUP);
+                }
+                break;
+        }
+        // min RTT estimate is stale, drain queue to measure it again
+        if (Mode != PROBE_RTT && MinRTT > 0 && MinRTTAge > CONG_CTRL_BBR_MIN_RTT_WINDOW) {
+            SetMode(PROBE_RTT);
+        }
+        UpdateControls();
+
+        const float burst = Max(CONG_CTRL_ALLOWED_BURST_SIZE, PacingRate * CONG_CTRL_BBR_PACING_BURST_TIME);
+        Tokens = Min(burst, Tokens + PacingRate * deltaT);
+        if (SendLimited && Tokens < 1 && PacingRate > 0) {
+            *resMaxWaitTime = Min(*resMaxWaitTime, (1 - Tokens) / PacingRate);
+        }
+        SendLimited = false;
+    }
+
     //////////////////////////////////////////////////////////////////////////
     void TAckTracker::Resend() {
         CurrentPacket = 0;
@@ -6,6 +6,7 @@
 #include <util/generic/vector.h>
 #include "net_test.h"
 #include "net_queue_stat.h"
+#include "settings.h"
 
 #include <library/cpp/netliba/socket/allocator.h>
 
@@ -29,6 +30,16 @@ namespace NNetliba_v12 {
     const float CONG_CTRL_ALLOWED_BURST_SIZE = 3;
     const float CONG_CTRL_MIN_RTT_FOR_BURST_REDUCTION = 0.002f;
 
+    const float CONG_CTRL_BBR_HIGH_GAIN = 2.885f; // 2 / ln(2), doubles send rate every round in startup
+    const float CONG_CTRL_BBR_CWND_GAIN = 2.0f;
+    const float CONG_CTRL_BBR_FULL_BW_GROWTH = 1.25f;
+    const int CONG_CTRL_BBR_FULL_BW_ROUNDS = 3;
+    const float CONG_CTRL_BBR_MIN_RTT_WINDOW = 10.0f; // in seconds
+    const float CONG_CTRL_BBR_PROBE_RTT_TIME = 0.2f;
+    const float CONG_CTRL_BBR_MIN_CWND = 4;
+    const float CONG_CTRL_BBR_MIN_ROUND = 0.0005f;
+    const float CONG_CTRL_BBR_PACING_BURST_TIME = 0.002f;
+
     const float LAME_MTU_TIMEOUT = 0.3f;
     const float LAME_MTU_INTERVAL = 0.05f;
 
@@ -97,118 +108,73 @@ namespace NNetliba_v12 {
         }
     };
 
-    class TCongestionControl: public TThrRefBase {
-        // pretend we have multiple channels in parallel
-        // not exact approximation since N channels should have N distinct windows
-        // ex CONG_CTRL_CHANNEL_INFLATE constant.
-        float ChannelInflate;
+    // Decides how many packets may be in flight and when the next one may be sent.
+    // TCongestionControl tracks liveness, timeouts and MTU and forwards every send, ack, loss and time step here.
+    class ICongestionAlgorithm {
+    public:
+        virtual ~ICongestionAlgorithm() {
+        }
+
+        virtual bool CanSend(float packetsInFly) = 0;
+        virtual void OnLaunch() = 0;
+        virtual void OnRTT(float rtt) = 0;
+        virtual void OnAck() = 0;
+        virtual void OnLoss() = 0;
+        virtual void Update(float deltaT, float packetsInFly, float* resMaxWaitTime) = 0;
+        // CanSend() returned false since last Update()
+        virtual bool IsSendLimited() const = 0;
+        virtual void SetMTU(int mtu) = 0;
+        virtual float GetWindow() const = 0;
+        virtual float GetMaxWindow() const = 0;
+        // packets per second, 0 if sends are not paced
+        virtual float GetPacingRate() const = 0;
+    };
 
-        float Window, PacketsInFly, FailRate;
-        float MinRTT, MaxWindow;
-        bool FullSpeed, DoCountTime;
+    ICongestionAlgorithm* CreateCongestionAlgorithm(ECongestionAlgorithm algorithm, float channelInflate, TPingTracker* pingTracker);
+
+    class TCongestionControl: public TThrRefBase {
+        THolder<ICongestionAlgorithm> Algorithm;
+        float PacketsInFly, FailRate;
+        bool DoCountTime;
         TPingTracker PingTracker;
         double TimeSinceLastRecv;
         TAdaptiveLock PortTesterLock;
         TIntrusivePtr<TPortUnreachableTester> PortTester;
-        float AvrgRTT;
-        int HighRTTCounter;
-        float WindowFraction, FractionRecalc;
-        float TimeWindow;
-        double TimeSinceLastFail;
-        float VirtualPackets;
         int MTU;
         TIntrusivePtr<TLameMTUDiscovery> MTUDiscovery;
 
-        void CalcMaxWindow() {
-            if (MTU == 0)
-                return;
-            MaxWindow = 125000000 / MTU * Max(0.001f, MinRTT);
-        }
-
     public:
         static float StartWindowSize, MaxPacketRate;
+        static ECongestionAlgorithm DefaultAlgorithm;
 
     public:
-        TCongestionControl(const float channelInflate)
-            : ChannelInflate(channelInflate)
-            , Window(StartWindowSize * ChannelInflate)
-            , PacketsInFly(0)
+        TCongestionControl(const float channelInflate, ECongestionAlgorithm algorithm = DefaultAlgorithm)
+            : PacketsInFly(0)
             , FailRate(0)
-            , MinRTT(10)
-            , MaxWindow(10000)
-            , FullSpeed(false)
             , DoCountTime(false)
             , TimeSinceLastRecv(0)
-            , AvrgRTT(0)
-            , HighRTTCounter(0)
-            , WindowFraction(0)
-            , FractionRecalc(0)
-            , TimeWindow(CONG_CTRL_LARGE_TIME_WINDOW)
-            , TimeSinceLastFail(0)
             , MTU(0)
         {
-            VirtualPackets = Max(Window - CONG_CTRL_ALLOWED_BURST_SIZE, 0.f);
+            Algorithm.Reset(CreateCongestionAlgorithm(algorithm, channelInflate, &PingTracker));
         }
         bool CanSend() {
-            bool res = VirtualPackets + PacketsInFly + WindowFraction <= Window;
-            FullSpeed |= !res;
-            res &= TimeWindow > 0;
-            return res;
+            return Algorithm->CanSend(PacketsInFly);
         }
         void LaunchPacket() {
             PacketsInFly += 1.0f;
-            TimeWindow -= 1.0f;
+            Algorithm->OnLaunch();
         }
         void RegisterRTT(float RTT) {
             if (RTT < 0)
                 return;
             RTT = ClampVal(RTT, 0.0001f, 1.0f);
-            if (RTT < MinRTT && MTU != 0) {
-                MinRTT = RTT;
-                CalcMaxWindow();
-            }
-            MinRTT = Min(MinRTT, RTT);
-
             PingTracker.RegisterRTT(RTT);
-            if (AvrgRTT == 0)
-                AvrgRTT = RTT;
-            if (RTT > AvrgRTT) {
-                ++HighRTTCounter;
-                if (HighRTTCounter >= CONG_CTRL_RTT_SEQ_COUNT) {
-                    //printf("Too many high RTT in a row\n");
-                    if (FullSpeed) {
-                        float windowSubtract = Window * ((1 - CONG_CTRL_WINDOW_SHRINK_RTT) / ChannelInflate);
-                        Window = Max(CONG_CTRL_MIN_WINDOW, Window - windowSubtract);
-                        VirtualPackets = Max(0.f, VirtualPackets - windowSubtract);
-                        //printf("reducing window by RTT , new window %g\n", Window);
-                    }
-                    // reduce no more then twice per RTT
-                    HighRTTCounter = Min(0, CONG_CTRL_RTT_SEQ_COUNT - (int)(Window * 0.5));
-                }
-            } else {
-                HighRTTCounter = Min(0, HighRTTCounter);
-            }
-
-            float rttMixRate = CONG_CTRL_RTT_MIX_RATE;
-            AvrgRTT = AvrgRTT * rttMixRate + RTT * (1 - rttMixRate);
+            Algorithm->OnRTT(RTT);
         }
         void Success() {
             PacketsInFly -= 1;
             Y_ASSERT(PacketsInFly >= 0);
-            // FullSpeed should be correct at this point
-            // we assume that after UpdateAlive() we send all packets first then we listen for acks and call Success()
-            // FullSpeed is set in CanSend() during send if we are using full window
-            // do not increaese window while send rate is limited by virtual packets (ie start of transfer)
-            if (FullSpeed && VirtualPackets == 0) {
-                // there are 2 requirements for window growth
-                // 1) growth should be proportional to window size to ensure constant FailRate
-                // 2) growth should be constant to ensure fairness among different flows
-                // so lets make it square root :)
-                Window += sqrt(Window / ChannelInflate) * CONG_CTRL_WINDOW_GROW;
-                if (UseTOSforAcks) {
-                    Window = Min(Window, MaxWindow);
-                }
-            }
+            Algorithm->OnAck();
             FailRate *= 0.99f;
         }
         void FailureOnSend() {
@@ -227,21 +193,7 @@ namespace NNetliba_v12 {
             //printf("Congestion failure\n");
             PacketsInFly -= 1;
             Y_ASSERT(PacketsInFly >= 0);
-            // account limited number of fails per segment
-            if (TimeSinceLastFail > CONG_CTRL_MIN_FAIL_INTERVAL) {
-                TimeSinceLastFail = 0;
-                if (Window <= CONG_CTRL_MIN_WINDOW) {
-                    // ping dead hosts less frequently
-                    if (PingTracker.GetRTT() / CONG_CTRL_MIN_WINDOW < CONG_CTRL_MINIMAL_SEND_INTERVAL)
-                        PingTracker.IncreaseRTT();
-                    Window = CONG_CTRL_MIN_WINDOW;
-                    VirtualPackets = 0;
-                } else {
-                    float windowSubtract = Window * ((1 - CONG_CTRL_WINDOW_SHRINK) / ChannelInflate);
-                    Window = Max(CONG_CTRL_MIN_WINDOW, Window - windowSubtract);
-                    VirtualPackets = Max(0.f, VirtualPackets - windowSubtract);
-                }
-            }
+            Algorithm->OnLoss();
             if (updateFailRate)
                 FailRate = FailRate * 0.99f + 0.01f;
         }
@@ -252,7 +204,7 @@ namespace NNetliba_v12 {
             return PingTracker.GetTimeout();
         }
         float GetWindow() const {
-            return Window;
+            return Algorithm->GetWindow();
         }
         float GetRTT() const {
             return PingTracker.GetRTT();
@@ -264,7 +216,10 @@ namespace NNetliba_v12 {
             return TimeSinceLastRecv;
         }
         float GetMaxWindow() const {
-            return UseTOSforAcks ? MaxWindow : -1;
+            return Algorithm->GetMaxWindow();
+        }
+        float GetPacingRate() const {
+            return Algorithm->GetPacingRate();
         }
         void MarkAlive() {
             TimeSinceLastRecv = 0;
@@ -282,50 +237,10 @@ namespace NNetliba_v12 {
             TimeSinceLastRecv = 1e6f;
         }
         bool UpdateAlive(const TUdpAddress& toAddress, float deltaT, float timeout, float* resMaxWaitTime) {
-            if (!FullSpeed) {
-                // create virtual packets during idle to avoid burst on transmit start
-                if (AvrgRTT > CONG_CTRL_MIN_RTT_FOR_BURST_REDUCTION) {
-                    VirtualPackets = Max(VirtualPackets, Window - PacketsInFly - CONG_CTRL_ALLOWED_BURST_SIZE);
-                }
-            } else {
-                if (VirtualPackets > 0) {
-                    if (Window <= CONG_CTRL_ALLOWED_BURST_SIZE) {
-                        VirtualPackets = 0;
-                    }
-                    float xRTT = AvrgRTT == 0 ? CONG_CTRL_INITIAL_RTT : AvrgRTT;
-                    float virtualPktsPerSecond = Window / xRTT;
-                    VirtualPackets = Max(0.f, VirtualPackets - deltaT * virtualPktsPerSecond);
-                    *resMaxWaitTime = Min(*resMaxWaitTime, 0.001f); // need to update virtual packets counter regularly
-                }
-            }
-            float currentRTT = GetRTT();
-            FractionRecalc += deltaT;
-            if (FractionRecalc > currentRTT) {
-                int cycleCount = (int)(FractionRecalc / currentRTT);
-                FractionRecalc -= currentRTT * cycleCount;
-                WindowFraction = (NetAckRnd() & 1023) * (1 / 1023.0f) / cycleCount;
-            }
-
-            if (MaxPacketRate > 0 && AvrgRTT > 0) {
-                float maxTimeWindow = CONG_CTRL_TIME_WINDOW_LIMIT_PERIOD * MaxPacketRate;
-                TimeWindow = Min(maxTimeWindow, TimeWindow + MaxPacketRate * deltaT);
-            } else
-                TimeWindow = CONG_CTRL_LARGE_TIME_WINDOW;
-
-            // guarantee minimal send rate
-            if (currentRTT > CONG_CTRL_MINIMAL_SEND_INTERVAL * Window) {
-                Window = Max(CONG_CTRL_MIN_WINDOW, currentRTT / CONG_CTRL_MINIMAL_SEND_INTERVAL);
-                VirtualPackets = 0;
-            }
-
-            TimeSinceLastFail += deltaT;
+            const bool sendLimited = Algorithm->IsSendLimited();
+            Algorithm->Update(deltaT, PacketsInFly, resMaxWaitTime);
 
-            //static int n;
-            //if ((++n & 127) == 0)
-            //    printf("window = %g, fly = %g, VirtualPkts = %g, deltaT = %g, FailRate = %g FullSpeed = %d AvrgRTT = %g\n",
-            //        Window, PacketsInFly, VirtualPackets, deltaT * 1000, FailRate, (int)FullSpeed, AvrgRTT * 1000);
-
-            if (PacketsInFly > 0 || FullSpeed || DoCountTime) {
+            if (PacketsInFly > 0 || sendLimited || DoCountTime) {
                 // считаем время только когда есть пакеты в полете
                 TimeSinceLastRecv += deltaT;
                 if (TimeSinceLastRecv > START_CHECK_PORT_DELAY) {
@@ -365,7 +280,6 @@ namespace NNetliba_v12 {
                 }
             }
 
-            FullSpeed = false;
             DoCountTime = false;
 
             if (MTUDiscovery.Get())
@@ -387,8 +301,260 @@ namespace NNetliba_v12 {
         void SetMTU(int sz) {
             MTU = sz;
             MTUDiscovery = nullptr;
+            Algorithm->SetMTU(sz);
+        }
+    };
+
+    class TWindowCongestionAlgorithm: public ICongestionAlgorithm {
+        // pretend we have multiple channels in parallel
+        // not exact approximation since N channels should have N distinct windows
+        // ex CONG_CTRL_CHANNEL_INFLATE constant.
+        float ChannelInflate;
+        TPingTracker* PingTracker;
+
+        float Window;
+        float MinRTT, MaxWindow;
+        bool FullSpeed;
+        float AvrgRTT;
+        int HighRTTCounter;
+        float WindowFraction, FractionRecalc;
+        float TimeWindow;
+        double TimeSinceLastFail;
+        float VirtualPackets;
+        int MTU;
+
+        void CalcMaxWindow() {
+            if (MTU == 0)
+                return;
+            MaxWindow = 125000000 / MTU * Max(0.001f, MinRTT);
+        }
+
+    public:
+        TWindowCongestionAlgorithm(const float channelInflate, TPingTracker* pingTracker)
+            : ChannelInflate(channelInflate)
+            , PingTracker(pingTracker)
+            , Window(TCongestionControl::StartWindowSize * ChannelInflate)
+            , MinRTT(10)
+            , MaxWindow(10000)
+            , FullSpeed(false)
+            , AvrgRTT(0)
+            , HighRTTCounter(0)
+            , WindowFraction(0)
+            , FractionRecalc(0)
+            , TimeWindow(CONG_CTRL_LARGE_TIME_WINDOW)
+            , TimeSinceLastFail(0)
+            , MTU(0)
+        {
+            VirtualPackets = Max(Window - CONG_CTRL_ALLOWED_BURST_SIZE, 0.f);
+        }
+        bool CanSend(float packetsInFly) override {
+            bool res = VirtualPackets + packetsInFly + WindowFraction <= Window;
+            FullSpeed |= !res;
+            res &= TimeWindow > 0;
+            return res;
+        }
+        void OnLaunch() override {
+            TimeWindow -= 1.0f;
+        }
+        void OnRTT(float RTT) override {
+            if (RTT < MinRTT && MTU != 0) {
+                MinRTT = RTT;
+                CalcMaxWindow();
+            }
+            MinRTT = Min(MinRTT, RTT);
+
+            if (AvrgRTT == 0)
+                AvrgRTT = RTT;
+            if (RTT > AvrgRTT) {
+                ++HighRTTCounter;
+                if (HighRTTCounter >= CONG_CTRL_RTT_SEQ_COUNT) {
+                    //printf("Too many high RTT in a row\n");
+                    if (FullSpeed) {
+                        float windowSubtract = Window * ((1 - CONG_CTRL_WINDOW_SHRINK_RTT) / ChannelInflate);
+                        Window = Max(CONG_CTRL_MIN_WINDOW, Window - windowSubtract);
+                        VirtualPackets = Max(0.f, VirtualPackets - windowSubtract);
+                        //printf("reducing window by RTT , new window %g\n", Window);
+                    }
+                    // reduce no more then twice per RTT
+                    HighRTTCounter = Min(0, CONG_CTRL_RTT_SEQ_COUNT - (int)(Window * 0.5));
+                }
+            } else {
+                HighRTTCounter = Min(0, HighRTTCounter);
+            }
+
+            float rttMixRate = CONG_CTRL_RTT_MIX_RATE;
+            AvrgRTT = AvrgRTT * rttMixRate + RTT * (1 - rttMixRate);
+        }
+        void OnAck() override {
+            // FullSpeed should be correct at this point
+            // we assume that after UpdateAlive() we send all packets first then we listen for acks and call Success()
+            // FullSpeed is set in CanSend() during send if we are using full window
+            // do not increaese window while send rate is limited by virtual packets (ie start of transfer)
+            if (FullSpeed && VirtualPackets == 0) {
+                // there are 2 requirements for window growth
+                // 1) growth should be proportional to window size to ensure constant FailRate
+                // 2) growth should be constant to ensure fairness among different flows
+                // so lets make it square root :)
+                Window += sqrt(Window / ChannelInflate) * CONG_CTRL_WINDOW_GROW;
+                if (UseTOSforAcks) {
+                    Window = Min(Window, MaxWindow);
+                }
+            }
+        }
+        void OnLoss() override {
+            // account limited number of fails per segment
+            if (TimeSinceLastFail > CONG_CTRL_MIN_FAIL_INTERVAL) {
+                TimeSinceLastFail = 0;
+                if (Window <= CONG_CTRL_MIN_WINDOW) {
+                    // ping dead hosts less frequently
+                    if (PingTracker->GetRTT() / CONG_CTRL_MIN_WINDOW < CONG_CTRL_MINIMAL_SEND_INTERVAL)
+                        PingTracker->IncreaseRTT();
+                    Window = CONG_CTRL_MIN_WINDOW;
+                    VirtualPackets = 0;
+                } else {
+                    float windowSubtract = Window * ((1 - CONG_CTRL_WINDOW_SHRINK) / ChannelInflate);
+                    Window = Max(CONG_CTRL_MIN_WINDOW, Window - windowSubtract);
+                    VirtualPackets = Max(0.f, VirtualPackets - windowSubtract);
+                }
+            }
+        }
+        void Update(float deltaT, float packetsInFly, float* resMaxWaitTime) override {
+            if (!FullSpeed) {
+                // create virtual packets during idle to avoid burst on transmit start
+                if (AvrgRTT > CONG_CTRL_MIN_RTT_FOR_BURST_REDUCTION) {
+                    VirtualPackets = Max(VirtualPackets, Window - packetsInFly - CONG_CTRL_ALLOWED_BURST_SIZE);
+                }
+            } else {
+                if (VirtualPackets > 0) {
+                    if (Window <= CONG_CTRL_ALLOWED_BURST_SIZE) {
+                        VirtualPackets = 0;
+                    }
+                    float xRTT = AvrgRTT == 0 ? CONG_CTRL_INITIAL_RTT : AvrgRTT;
+                    float virtualPktsPerSecond = Window / xRTT;
+                    VirtualPackets = Max(0.f, VirtualPackets - deltaT * virtualPktsPerSecond);
+                    *resMaxWaitTime = Min(*resMaxWaitTime, 0.001f); // need to update virtual packets counter regularly
+                }
+            }
+            float currentRTT = PingTracker->GetRTT();
+            FractionRecalc += deltaT;
+            if (FractionRecalc > currentRTT) {
+                int cycleCount = (int)(FractionRecalc / currentRTT);
+                FractionRecalc -= currentRTT * cycleCount;
+                WindowFraction = (NetAckRnd() & 1023) * (1 / 1023.0f) / cycleCount;
+            }
+
+            const float maxPacketRate = TCongestionControl::MaxPacketRate;
+            if (maxPacketRate > 0 && AvrgRTT > 0) {
+                float maxTimeWindow = CONG_CTRL_TIME_WINDOW_LIMIT_PERIOD * maxPacketRate;
+                TimeWindow = Min(maxTimeWindow, TimeWindow + maxPacketRate * deltaT);
+            } else
+                TimeWindow = CONG_CTRL_LARGE_TIME_WINDOW;
+
+            // guarantee minimal send rate
+            if (currentRTT > CONG_CTRL_MINIMAL_SEND_INTERVAL * Window) {
+                Window = Max(CONG_CTRL_MIN_WINDOW, currentRTT / CONG_CTRL_MINIMAL_SEND_INTERVAL);
+                VirtualPackets = 0;
+            }
+
+            TimeSinceLastFail += deltaT;
+
+            //static int n;
+            //if ((++n & 127) == 0)
+            //    printf("window = %g, fly = %g, VirtualPkts = %g, deltaT = %g, AvrgRTT = %g FullSpeed = %d\n",
+            //        Window, packetsInFly, VirtualPackets, deltaT * 1000, AvrgRTT * 1000, (int)FullSpeed);
+
+            FullSpeed = false;
+        }
+        bool IsSendLimited() const override {
+            return FullSpeed;
+        }
+        void SetMTU(int mtu) override {
+            MTU = mtu;
             CalcMaxWindow();
         }
+        float GetWindow() const override {
+            return Window;
+        }
+        float GetMaxWindow() const override {
+            return UseTOSforAcks ? MaxWindow : -1;
+        }
+        float GetPacingRate() const override {
+            return 0;
+        }
+    };
+
+    // Delay based controller in the spirit of BBR: estimates bottleneck bandwidth (max delivery rate
+    // over last rounds) and propagation RTT (min RTT over CONG_CTRL_BBR_MIN_RTT_WINDOW), paces sends at
+    // gain * bandwidth and caps packets in flight at gain * bandwidth * minRTT. Losses are not a congestion
+    // signal unless nothing gets through at all. Round is one min RTT of wall time.
+    class TBbrCongestionAlgorithm: public ICongestionAlgorithm {
+    public:
+        TBbrCongestionAlgorithm(const float channelInflate, TPingTracker* pingTracker);
+
+        bool CanSend(float packetsInFly) override;
+        void OnLaunch() override;
+        void OnRTT(float rtt) override;
+        void OnAck() override;
+        void OnLoss() override;
+        void Update(float deltaT, float packetsInFly, float* resMaxWaitTime) override;
+        bool IsSendLimited() const override {
+            return SendLimited;
+        }
+        void SetMTU(int mtu) override {
+            Y_UNUSED(mtu);
+        }
+        float GetWindow() const override {
+            return Cwnd;
+        }
+        float GetMaxWindow() const override {
+            return -1;
+        }
+        float GetPacingRate() const override {
+            return PacingRate;
+        }
+        float GetBandwidth() const {
+            return BtlBw;
+        }
+        float GetMinRTT() const {
+            return MinRTT;
+        }
+
+    private:
+        enum EMode {
+            STARTUP,
+            DRAIN,
+            PROBE_BW,
+            PROBE_RTT,
+        };
+        enum { BW_FILTER_ROUNDS = 10 };
+
+        void EndRound();
+        void SetMode(EMode mode);
+        void UpdateControls();
+        float GetRoundTime() const;
+
+        TPingTracker* PingTracker;
+        float InitialCwnd;
+        EMode Mode;
+
+        float BwSamples[BW_FILTER_ROUNDS];
+        size_t BwSampleIdx;
+        float BtlBw; // packets per second
+        float MinRTT, MinRTTAge, ProbeRTTMin;
+
+        float RoundTime;
+        float RoundAcked, RoundLost;
+        bool RoundLimited;
+        float FullBw;
+        int FullBwRounds;
+        bool FilledPipe;
+        int CycleIndex;
+        float ModeTime;
+        float LossBackoff;
+
+        float PacingGain, CwndGain;
+        float Cwnd, PacingRate, Tokens;
+        bool SendLimited;
     };
 
     class TAckTracker {
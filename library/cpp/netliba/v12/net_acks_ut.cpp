@@ -0,0 +1,175 @@
+#include <library/cpp/testing/unittest/registar.h>
+#include "net_acks.h"
+#include "udp_address.h"
+
+#include <util/generic/deque.h>
+#include <util/generic/vector.h>
+#include <util/random/fast.h>
+
+namespace NNetliba_v12 {
+    namespace {
+        // Bottleneck link: drop-tail queue served at fixed packet rate, constant propagation delay
+        // and random loss before the queue. Acks are never lost or delayed by queueing.
+        struct TLinkParams {
+            float PacketRate; // packets per second
+            float BaseRTT;
+            size_t QueueLimit; // packets
+            float LossRate;
+        };
+
+        struct TSimResult {
+            double Goodput = 0;      // fraction of link capacity delivered to receivers
+            double RTTInflation = 0; // average RTT / base RTT
+            double LossRate = 0;     // fraction of sent packets dropped
+        };
+
+        struct TSimFlow {
+            TIntrusivePtr<TCongestionControl> Congestion;
+            TAckTracker Tracker;
+            size_t Delivered = 0;
+        };
+
+        struct TSimPacket {
+            size_t Flow;
+            int Id;
+            double SendTime;
+            double AckTime;
+        };
+
+        TSimResult Simulate(ECongestionAlgorithm algorithm, const TLinkParams& link, size_t numFlows, double duration) {
+            const double dt = 0.0001;
+            const TUdpAddress address;
+            TFastRng<ui64> rng(17);
+
+            TVector<THolder<TSimFlow>> flows;
+            for (size_t i = 0; i != numFlows; ++i) {
+                flows.emplace_back(new TSimFlow);
+                TSimFlow& flow = *flows.back();
+                flow.Congestion = new TCongestionControl(1, algorithm);
+                flow.Congestion->SetMTU(1400);
+                flow.Tracker.AttachCongestionControl(flow.Congestion.Get());
+                flow.Tracker.SetPacketCount((int)(link.PacketRate * duration * 2) + 100);
+            }
+
+            TDeque<TSimPacket> queue, acks;
+            double credit = 0;
+            size_t sent = 0, dropped = 0, rttCount = 0;
+            double rttSum = 0;
+
+            for (double now = 0; now < duration; now += dt) {
+                while (!acks.empty() && acks.front().AckTime <= now) {
+                    const TSimPacket& pkt = acks.front();
+                    TSimFlow& flow = *flows[pkt.Flow];
+                    if (!flow.Tracker.GetAckReceived()[pkt.Id]) {
+                        ++flow.Delivered;
+                    }
+                    flow.Tracker.Ack(pkt.Id, 0, true);
+                    rttSum += now - pkt.SendTime;
+                    ++rttCount;
+                    acks.pop_front();
+                }
+
+                for (size_t f = 0; f != numFlows; ++f) {
+                    TSimFlow& flow = *flows[f];
+                    float maxWaitTime = 1;
+                    flow.Congestion->MarkAlive(); // liveness is not simulated
+                    flow.Congestion->UpdateAlive(address, dt, 100, &maxWaitTime);
+                    flow.Tracker.Step(dt);
+                    while (flow.Tracker.CanSend()) {
+                        bool isCanceled = false;
+                        const int id = flow.Tracker.GetPacketToSend(0, &isCanceled);
+                        if (id < 0) {
+                            break;
+                        }
+                        ++sent;
+                        if (rng.GenRandReal1() < link.LossRate || queue.size() >= link.QueueLimit) {
+                            ++dropped;
+                            continue;
+                        }
+                        queue.push_back({f, id, now, 0});
+                    }
+                }
+
+                credit += link.PacketRate * dt;
+                while (credit >= 1 && !queue.empty()) {
+                    credit -= 1;
+                    TSimPacket pkt = queue.front();
+                    queue.pop_front();
+                    pkt.AckTime = now + link.BaseRTT;
+                    acks.push_back(pkt);
+                }
+                if (queue.empty()) {
+                    credit = Min(credit, 1.0);
+                }
+            }
+
+            TSimResult result;
+            size_t delivered = 0;
+            for (const auto& flow : flows) {
+                delivered += flow->Delivered;
+            }
+            result.Goodput = delivered / (link.PacketRate * duration);
+            result.RTTInflation = rttCount ? rttSum / rttCount / link.BaseRTT : 0;
+            result.LossRate = sent ? (double)dropped / sent : 0;
+            return result;
+        }
+    }
+
+    class TNetliba_v12CongestionTest: public TTestBase {
+        UNIT_TEST_SUITE(TNetliba_v12CongestionTest)
+        UNIT_TEST(DefaultAlgorithmTest)
+        UNIT_TEST(DeepBufferTest)
+        UNIT_TEST(RandomLossTest)
+        UNIT_TEST(IncastTest)
+        UNIT_TEST_SUITE_END();
+
+        void DefaultAlgorithmTest() {
+            UNIT_ASSERT_EQUAL(TCongestionControl::DefaultAlgorithm, CA_WINDOW);
+            TCongestionControl window(1);
+            UNIT_ASSERT_VALUES_EQUAL(window.GetWindow(), TCongestionControl::StartWindowSize);
+            UNIT_ASSERT_VALUES_EQUAL(window.GetPacingRate(), 0.0f);
+
+            TCongestionControl bbr(1, CA_BBR);
+            UNIT_ASSERT(bbr.GetPacingRate() > 0);
+            UNIT_ASSERT(bbr.CanSend());
+        }
+
+        // single flow, queue of 10 BDP: bbr should reach link rate without filling the queue
+        void DeepBufferTest() {
+            const TLinkParams link = {10000, 0.01f, 1000, 0};
+            const TSimResult window = Simulate(CA_WINDOW, link, 1, 5);
+            const TSimResult bbr = Simulate(CA_BBR, link, 1, 5);
+            UNIT_ASSERT(window.Goodput > 0.3);
+            UNIT_ASSERT(bbr.Goodput > 0.9);
+            UNIT_ASSERT(bbr.Goodput > window.Goodput * 1.5);
+            UNIT_ASSERT(bbr.RTTInflation < 1.5);
+            UNIT_ASSERT(bbr.LossRate < 0.001);
+        }
+
+        // 1% random (non congestion) loss
+        void RandomLossTest() {
+            const TLinkParams link = {10000, 0.01f, 200, 0.01f};
+            const TSimResult window = Simulate(CA_WINDOW, link, 1, 5);
+            const TSimResult bbr = Simulate(CA_BBR, link, 1, 5);
+            UNIT_ASSERT(window.Goodput > 0.05);
+            UNIT_ASSERT(bbr.Goodput > 0.9);
+            UNIT_ASSERT(bbr.Goodput > window.Goodput * 4);
+            // no queue overflow on top of the random loss
+            UNIT_ASSERT(bbr.LossRate < 0.015);
+        }
+
+        // 8 flows into half BDP queue
+        void IncastTest() {
+            const TLinkParams link = {10000, 0.01f, 50, 0};
+            const TSimResult window = Simulate(CA_WINDOW, link, 8, 5);
+            const TSimResult bbr = Simulate(CA_BBR, link, 8, 5);
+            UNIT_ASSERT(window.Goodput > 0.5);
+            UNIT_ASSERT(bbr.Goodput > 0.9);
+            UNIT_ASSERT(bbr.Goodput > window.Goodput);
+            UNIT_ASSERT(bbr.RTTInflation < 2);
+            UNIT_ASSERT(bbr.LossRate < 0.2);
+        }
+    };
+
+    UNIT_TEST_SUITE_REGISTRATION(TNetliba_v12CongestionTest);
+}
@@ -14,6 +14,11 @@ namespace NNetliba_v12 {
         PP_SYSTEM // It is HIGHEST priority for system
     };
 
+    enum ECongestionAlgorithm {
+        CA_WINDOW, // loss and RTT growth driven window, default
+        CA_BBR,    // bottleneck bandwidth and min RTT model, paced sends
+    };
+
     inline bool IsValidTos(const int tos) {
         return tos == TOS_DEFAULT || 0 <= tos && tos <= 0xFF;
     }
@@ -1858,6 +1858,10 @@ namespace NNetliba_v12 {
         TCongestionControl::StartWindowSize = enable ? 0.5f : 3;
     }
 
+    void SetUdpCongestionAlgorithm(ECongestionAlgorithm algorithm) {
+        TCongestionControl::DefaultAlgorithm = algorithm;
+    }
+
     void DisableIBDetection() {
         IBDetection = false;
     }
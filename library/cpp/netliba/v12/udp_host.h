@@ -77,6 +77,8 @@ namespace NNetliba_v12 {
 
     void SetUdpMaxBandwidthPerIP(float f);
     void SetUdpSlowStart(bool enable);
+    // applies to connections created after the call
+    void SetUdpCongestionAlgorithm(ECongestionAlgorithm algorithm);
     void DisableIBDetection();
 }
 
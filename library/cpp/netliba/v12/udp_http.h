@@ -268,6 +268,7 @@ namespace NNetliba_v12 {
 
     void SetUdpMaxBandwidthPerIP(float f);
     void SetUdpSlowStart(bool enable);
+    void SetUdpCongestionAlgorithm(ECongestionAlgorithm algorithm);
 
     void EnableUseTOSforAcks(bool enable);
     void EnableROCE(bool f);
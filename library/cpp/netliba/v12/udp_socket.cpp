@@ -561,12 +561,12 @@ namespace NNetliba_v12 {
 
     ///////////////////////////////////////////////////////////////////////////////
 
-    void TUdpSocket::CacheContinuationUdpPacket(const TUdpRecvPacket& pkt, const size_t pktSize, const TSockAddrPair& addr) {
+    void TUdpSocket::CacheContinuationUdpPacket(const TUdpRecvPacket& pkt, const size_t pktEnd, const TSockAddrPair& addr) {
         Y_ASSERT(!RecvContUdpPacket);
-        Y_ASSERT((size_t)(pkt.DataStart + pkt.DataSize) < pktSize);
+        Y_ASSERT((size_t)(pkt.DataStart + pkt.DataSize) < pktEnd);
 
         RecvContUdpPacket.Reset(TUdpHostRecvBufAlloc::Clone(&pkt));
-        RecvContUdpPacketSize = pktSize;
+        RecvContUdpPacketSize = pktEnd;
         RecvContAddress = addr;
     }
 
@@ -610,18 +610,19 @@ namespace NNetliba_v12 {
                 return nullptr;
             }
 
-            Y_ASSERT(result->DataStart == 0);
+            // packet may be a segment of a coalesced datagram sharing its buffer
+            const char* recvData = result->Data.get() + result->DataStart;
             const size_t recvSize = result->DataSize;
 
             // skip whole corrupted packet even with small packet optimization
-            if (!CheckPacketIntegrity(result->Data.get(), recvSize, *addr)) {
+            if (!CheckPacketIntegrity(recvData, recvSize, *addr)) {
                 continue;
             }
 
-            result->DataSize = UDP_LOW_LEVEL_HEADER_SIZE + ReadPacketDataSize(result->Data.get());
+            result->DataSize = UDP_LOW_LEVEL_HEADER_SIZE + ReadPacketDataSize(recvData);
 
             if ((size_t)result->DataSize != recvSize) {
-                CacheContinuationUdpPacket(*result, recvSize, *addr);
+                CacheContinuationUdpPacket(*result, result->DataStart + recvSize, *addr);
             }
             break;
         }
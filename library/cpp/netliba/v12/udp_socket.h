@@ -62,7 +62,7 @@ namespace NNetliba_v12 {
 
         // used for small packet optimization
         THolder<TUdpRecvPacket> RecvContUdpPacket;
-        int RecvContUdpPacketSize;
+        int RecvContUdpPacketSize; // end of the datagram in RecvContUdpPacket buffer
         TSockAddrPair RecvContAddress;
 
         struct TSendPacketsStat {
@@ -80,7 +80,7 @@ namespace NNetliba_v12 {
         void ForgetHeadUdpPackets(const size_t numPackets);
 
         TUdpRecvPacket* RecvContinuationPacket(TSockAddrPair* addr);
-        void CacheContinuationUdpPacket(const TUdpRecvPacket& pkt, const size_t pktSize, const TSockAddrPair& addr);
+        void CacheContinuationUdpPacket(const TUdpRecvPacket& pkt, const size_t pktEnd, const TSockAddrPair& addr);
 
     public:
         TUdpSocket(const size_t maxUdpPacketsInQueue, const bool useSmallPacketsOptimization);
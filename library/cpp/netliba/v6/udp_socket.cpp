@@ -207,7 +207,7 @@ namespace NNetliba {
             } else {
                 sockaddr_in6 dummy;
                 TAutoPtr<NNetlibaSocket::TUdpRecvPacket> pkt = s->Recv(fromAddress, &dummy, -1);
-                rv = !!pkt ? pkt->DataSize - pkt->DataStart : -1;
+                rv = !!pkt ? pkt->DataSize : -1;
                 if (rv > 0) {
                     memcpy(buf, pkt->Data.get() + pkt->DataStart, rv);
                 }
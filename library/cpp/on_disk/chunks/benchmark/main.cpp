@@ -0,0 +1,223 @@
+#include <library/cpp/on_disk/chunks/chunked_helpers.h>
+#include <library/cpp/testing/benchmark/bench.h>
+
+#include <util/generic/buffer.h>
+#include <util/generic/ptr.h>
+#include <util/generic/singleton.h>
+#include <util/random/fast.h>
+#include <util/stream/buffer.h>
+#include <util/stream/file.h>
+#include <util/stream/output.h>
+#include <util/string/cast.h>
+#include <util/system/env.h>
+#include <util/system/mktemp.h>
+#include <util/system/tempfile.h>
+
+namespace {
+    // set CHUNKS_BENCHMARK_KEYS to run on machines with less than ~6Gb of memory
+    size_t GetKeyCount() {
+        return FromString<size_t>(GetEnv("CHUNKS_BENCHMARK_KEYS", "100000000"));
+    }
+
+    constexpr size_t QUERY_COUNT = 1 << 20;
+
+    // distinct keys, Shift zero low bits make TPlainHash buckets skewed
+    template <ui32 Shift>
+    ui64 GetKey(size_t i) {
+        return (i * 0x9e3779b97f4a7c15ULL) << Shift;
+    }
+
+    template <ui32 Shift>
+    struct TLookupData {
+        TTempFile PlainFile;
+        TTempFile PerfectFile;
+        TBlob PlainBlob;
+        TBlob PerfectBlob;
+        THolder<TPlainHash<ui64, ui32>> Plain;
+        THolder<TPerfectHash<ui64, ui32>> Perfect;
+        TVector<ui64> Queries;
+
+        TLookupData()
+            : PlainFile(MakeTempName())
+            , PerfectFile(MakeTempName())
+        {
+            const size_t keyCount = GetKeyCount();
+            {
+                TPlainHashWriter<ui64, ui32> writer;
+                for (size_t i = 0; i < keyCount; ++i)
+                    writer.Add(GetKey<Shift>(i), (ui32)i);
+                TFixedBufferFileOutput out(PlainFile.Name());
+                writer.Save(out);
+            }
+            {
+                TPerfectHashWriter<ui64, ui32> writer(1);
+                for (size_t i = 0; i < keyCount; ++i)
+                    writer.Add(GetKey<Shift>(i), (ui32)i);
+                TFixedBufferFileOutput out(PerfectFile.Name());
+                writer.Save(out);
+            }
+            PlainBlob = TBlob::PrechargedFromFile(PlainFile.Name());
+            PerfectBlob = TBlob::PrechargedFromFile(PerfectFile.Name());
+            Plain = MakeHolder<TPlainHash<ui64, ui32>>(PlainBlob);
+            Perfect = MakeHolder<TPerfectHash<ui64, ui32>>(PerfectBlob);
+
+            TFastRng<ui64> rng(17);
+            for (size_t i = 0; i < QUERY_COUNT; ++i)
+                Queries.push_back(GetKey<Shift>(rng.Uniform(keyCount)));
+
+            Cerr << keyCount << " keys, low " << Shift << " bits zero: TPlainHash " << PlainBlob.Size() << " bytes ("
+                 << (double)PlainBlob.Size() / keyCount << " per key), TPerfectHash " << PerfectBlob.Size() << " bytes ("
+                 << (double)PerfectBlob.Size() / keyCount << " per key)" << Endl;
+        }
+    };
+
+    constexpr size_t VECTOR_SIZE = 1 << 24;
+    constexpr size_t DECODE_BATCH = 1024; // values per iteration, decoded GB/s = 4.096 / ns per iteration
+
+    // sorted ids with gaps up to 30 and counters mostly below 4
+    template <bool Ids>
+    struct TVectorData {
+        TBuffer PlainBuffer;
+        TBuffer PackedBuffer;
+        THolder<TYVector<ui32>> Plain;
+        THolder<TBitPackedVector<ui32>> Packed;
+        TVector<ui32> Positions;
+
+        TVectorData() {
+            TFastRng<ui64> rng(19);
+            TYVectorWriter<ui32> plainWriter;
+            TBitPackedVectorWriter<ui32> packedWriter;
+            ui32 id = 0;
+            for (size_t i = 0; i < VECTOR_SIZE; ++i) {
+                id += 1 + rng.Uniform(30);
+                const ui32 value = Ids ? id : (rng.Uniform(100) < 90 ? rng.Uniform(4) : rng.Uniform(1000));
+                plainWriter.PushBack(value);
+                packedWriter.PushBack(value);
+            }
+            TBufferOutput plainOut(PlainBuffer);
+            plainWriter.Save(plainOut);
+            TBufferOutput packedOut(PackedBuffer);
+            packedWriter.Save(packedOut);
+            Plain = MakeHolder<TYVector<ui32>>(TBlob::NoCopy(PlainBuffer.Data(), PlainBuffer.Size()));
+            Packed = MakeHolder<TBitPackedVector<ui32>>(TBlob::NoCopy(PackedBuffer.Data(), PackedBuffer.Size()));
+            for (size_t i = 0; i < QUERY_COUNT; ++i)
+                Positions.push_back(rng.Uniform(VECTOR_SIZE));
+
+            Cerr << (Ids ? "sorted ids" : "counters") << ": TYVector " << Plain->RealSize() << " bytes, TBitPackedVector "
+                 << Packed->RealSize() << " bytes (" << (double)Plain->RealSize() / Packed->RealSize() << "x smaller)" << Endl;
+        }
+    };
+
+    template <bool Ids, bool Packed>
+    void RunDecode(::NBench::NCpu::TParams& iface) {
+        const auto& data = *Singleton<TVectorData<Ids>>();
+        ui32 values[DECODE_BATCH];
+        for (size_t i = 0; i < iface.Iterations(); ++i) {
+            const size_t begin = i * DECODE_BATCH % VECTOR_SIZE;
+            if (Packed) {
+                data.Packed->Decode(begin, DECODE_BATCH, values);
+            } else {
+                for (size_t j = 0; j < DECODE_BATCH; ++j)
+                    data.Plain->Get(begin + j, values[j]);
+            }
+            ::NBench::Escape(values);
+            ::NBench::Clobber();
+        }
+    }
+
+    template <bool Ids, bool Packed>
+    void RunRandomGet(::NBench::NCpu::TParams& iface) {
+        const auto& data = *Singleton<TVectorData<Ids>>();
+        ui32 value = 0;
+        for (size_t i = 0; i < iface.Iterations(); ++i) {
+            const size_t pos = data.Positions[i % QUERY_COUNT];
+            if (Packed)
+                data.Packed->Get(pos, value);
+            else
+                data.Plain->Get(pos, value);
+            ::NBench::Escape(&value);
+            ::NBench::Clobber();
+        }
+    }
+
+    // independent lookups measure throughput, dependent ones (next key depends on found value) latency
+    template <bool Dependent, class THash>
+    void RunLookups(const THash& hash, const TVector<ui64>& queries, ::NBench::NCpu::TParams& iface) {
+        ui32 value = 0;
+        for (size_t i = 0; i < iface.Iterations(); ++i) {
+            Y_DO_NOT_OPTIMIZE_AWAY(hash.Find(queries[(i + (Dependent ? value : 0)) % QUERY_COUNT], &value));
+        }
+    }
+}
+
+Y_CPU_BENCHMARK(PlainHash_Uniform, iface) {
+    const auto& data = *Singleton<TLookupData<0>>();
+    RunLookups<false>(*data.Plain, data.Queries, iface);
+}
+
+Y_CPU_BENCHMARK(PerfectHash_Uniform, iface) {
+    const auto& data = *Singleton<TLookupData<0>>();
+    RunLookups<false>(*data.Perfect, data.Queries, iface);
+}
+
+Y_CPU_BENCHMARK(PlainHash_Uniform_Latency, iface) {
+    const auto& data = *Singleton<TLookupData<0>>();
+    RunLookups<true>(*data.Plain, data.Queries, iface);
+}
+
+Y_CPU_BENCHMARK(PerfectHash_Uniform_Latency, iface) {
+    const auto& data = *Singleton<TLookupData<0>>();
+    RunLookups<true>(*data.Perfect, data.Queries, iface);
+}
+
+Y_CPU_BENCHMARK(PlainHash_LowBitsZero, iface) {
+    const auto& data = *Singleton<TLookupData<4>>();
+    RunLookups<false>(*data.Plain, data.Queries, iface);
+}
+
+Y_CPU_BENCHMARK(PerfectHash_LowBitsZero, iface) {
+    const auto& data = *Singleton<TLookupData<4>>();
+    RunLookups<false>(*data.Perfect, data.Queries, iface);
+}
+
+Y_CPU_BENCHMARK(PlainHash_LowBitsZero_Latency, iface) {
+    const auto& data = *Singleton<TLookupData<4>>();
+    RunLookups<true>(*data.Plain, data.Queries, iface);
+}
+
+Y_CPU_BENCHMARK(PerfectHash_LowBitsZero_Latency, iface) {
+    const auto& data = *Singleton<TLookupData<4>>();
+    RunLookups<true>(*data.Perfect, data.Queries, iface);
+}
+
+Y_CPU_BENCHMARK(YVector_Ids_Decode, iface) {
+    RunDecode<true, false>(iface);
+}
+
+Y_CPU_BENCHMARK(BitPackedVector_Ids_Decode, iface) {
+    RunDecode<true, true>(iface);
+}
+
+Y_CPU_BENCHMARK(YVector_Ids_RandomGet, iface) {
+    RunRandomGet<true, false>(iface);
+}
+
+Y_CPU_BENCHMARK(BitPackedVector_Ids_RandomGet, iface) {
+    RunRandomGet<true, true>(iface);
+}
+
+Y_CPU_BENCHMARK(YVector_Counters_Decode, iface) {
+    RunDecode<false, false>(iface);
+}
+
+Y_CPU_BENCHMARK(BitPackedVector_Counters_Decode, iface) {
+    RunDecode<false, true>(iface);
+}
+
+Y_CPU_BENCHMARK(YVector_Counters_RandomGet, iface) {
+    RunRandomGet<false, false>(iface);
+}
+
+Y_CPU_BENCHMARK(BitPackedVector_Counters_RandomGet, iface) {
+    RunRandomGet<false, true>(iface);
+}
@@ -3,6 +3,7 @@
 #include <util/generic/vector.h>
 #include <util/generic/buffer.h>
 #include <util/generic/hash_set.h>
+#include <util/generic/bitops.h>
 #include <util/generic/cast.h>
 #include <util/generic/ymath.h>
 #include <util/memory/blob.h>
@@ -14,8 +15,14 @@
 #include "reader.h"
 #include "writer.h"
 
+#include <library/cpp/containers/perfect_hash/perfect_hash.h>
+#include <library/cpp/pop_count/popcount.h>
+
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
+#include <type_traits>
+#include <utility>
 
 template <typename T>
 class TYVector {
@@ -109,6 +116,365 @@ struct TYVectorG<X, true> {
     typedef TYVectorWriter<X> T;
 };
 
+/// Integer vector stored in blocks of 128 values. Each block keeps a linear model base + slope * i (slope is 0
+/// for unsorted data) and residuals from it, bit-packed with a width chosen for the block. Residuals wider than
+/// that are patched: a 128 bit mask marks them and their high bits are packed after the low ones. Sorted ids and
+/// small counters take a few bits per value, Get is O(1) and Decode unpacks whole blocks with loops specialized
+/// for each width.
+class TBitPackedVectorCommon {
+protected:
+    static const ui32 BLOCK_SIZE = 128;
+    static const ui32 SLOPE_SHIFT = 8; // fixed point slope
+    static const ui32 EXCEPTION_MASK_WORDS = BLOCK_SIZE / 64;
+
+#pragma pack(push, 8)
+    struct TBlockHeader {
+        ui64 Base;
+        ui64 Slope;
+        ui32 Offset; // in ui64 words
+        ui8 Bits;
+        ui8 HighBits; // 0 if block has no exceptions
+        ui16 Reserved;
+    };
+#pragma pack(pop)
+    static_assert(24 == sizeof(TBlockHeader), "expect 24 == sizeof(TBlockHeader)");
+
+    using TUnpacker = void (*)(const char* words, ui32 count, ui64* dst);
+
+    /// order preserving, so that sorted signed values get a slope too
+    template <typename T>
+    static ui64 ToUnsigned(T value) {
+        return std::is_signed<T>::value ? ui64(i64(value)) ^ (ui64(1) << 63) : ui64(value);
+    }
+
+    template <typename T>
+    static T FromUnsigned(ui64 value) {
+        return std::is_signed<T>::value ? T(i64(value ^ (ui64(1) << 63))) : T(value);
+    }
+
+    static ui32 BitLength(ui64 value) {
+        return value ? GetValueBitCount(value) : 0;
+    }
+
+    static size_t WordCount(size_t count, ui32 bits) {
+        return (count * bits + 63) / 64;
+    }
+
+    static ui64 Predict(const TBlockHeader& header, ui32 i) {
+        return header.Base + ((i * header.Slope) >> SLOPE_SHIFT);
+    }
+
+    static ui64 ReadBits(const char* words, ui64 bit, ui32 bits) {
+        if (!bits)
+            return 0;
+        const char* word = words + bit / 64 * sizeof(ui64);
+        const ui32 shift = bit % 64;
+        ui64 value = ReadUnaligned<ui64>(word) >> shift;
+        if (shift + bits > 64)
+            value |= ReadUnaligned<ui64>(word + sizeof(ui64)) << (64 - shift);
+        return bits == 64 ? value : value & ((ui64(1) << bits) - 1);
+    }
+
+    template <ui32 Bits, ui64 Bit>
+    static ui64 ReadBits(const char* words) {
+        constexpr ui32 shift = Bit % 64;
+        ui64 value = ReadUnaligned<ui64>(words + Bit / 64 * sizeof(ui64)) >> shift;
+        if constexpr (shift + Bits > 64)
+            value |= ReadUnaligned<ui64>(words + (Bit / 64 + 1) * sizeof(ui64)) << (64 - shift);
+        if constexpr (Bits < 64)
+            value &= (ui64(1) << Bits) - 1;
+        return value;
+    }
+
+    /// 64 values take exactly Bits words, all shifts are known at compile time
+    template <ui32 Bits, size_t... I>
+    static void Unpack64(const char* words, ui64* dst, std::index_sequence<I...>) {
+        ((dst[I] = ReadBits<Bits, I * Bits>(words)), ...);
+    }
+
+    template <ui32 Bits>
+    static void UnpackBits(const char* words, ui32 count, ui64* dst) {
+        if constexpr (Bits == 0) {
+            std::fill(dst, dst + count, 0);
+        } else {
+            ui32 i = 0;
+            for (; i + 64 <= count; i += 64)
+                Unpack64<Bits>(words + i / 64 * Bits * sizeof(ui64), dst + i, std::make_index_sequence<64>());
+            for (; i < count; ++i)
+                dst[i] = ReadBits(words, ui64(i) * Bits, Bits);
+        }
+    }
+
+    template <size_t... Bits>
+    static const TUnpacker* MakeUnpackers(std::index_sequence<Bits...>) {
+        static const TUnpacker unpackers[] = {&UnpackBits<Bits>...};
+        return unpackers;
+    }
+
+    static const TUnpacker* GetUnpackers() {
+        return MakeUnpackers(std::make_index_sequence<65>());
+    }
+
+    static void PackBits(const ui64* values, ui32 count, ui32 bits, TVector<ui64>& words) {
+        const size_t begin = words.size();
+        words.resize(begin + WordCount(count, bits), 0);
+        ui64* dst = words.data() + begin;
+        for (ui32 i = 0; i < count && bits; ++i) {
+            const ui64 value = bits == 64 ? values[i] : values[i] & ((ui64(1) << bits) - 1);
+            const ui64 bit = ui64(i) * bits;
+            const ui32 shift = bit % 64;
+            dst[bit / 64] |= value << shift;
+            if (shift + bits > 64)
+                dst[bit / 64 + 1] |= value >> (64 - shift);
+        }
+    }
+
+    /// picks low width minimizing block size given residual bit lengths
+    static void ChooseWidth(const ui32* lengthCounts, ui32 count, ui8* bits, ui8* highBits, size_t* size) {
+        ui32 maxBits = 64;
+        while (maxBits && !lengthCounts[maxBits])
+            --maxBits;
+        *bits = (ui8)maxBits;
+        *highBits = 0;
+        *size = size_t(count) * maxBits;
+        ui32 exceptions = 0;
+        for (ui32 b = maxBits; b-- > 0;) {
+            exceptions += lengthCounts[b + 1];
+            const size_t size2 = size_t(count) * b + 64 * EXCEPTION_MASK_WORDS + size_t(exceptions) * (maxBits - b);
+            if (size2 < *size) {
+                *bits = (ui8)b;
+                *highBits = (ui8)(maxBits - b);
+                *size = size2;
+            }
+        }
+    }
+
+    /// header and residuals of values[0..count), tries both linear model and plain frame of reference
+    static TBlockHeader EncodeBlock(const ui64* values, ui32 count, ui64* residuals) {
+        TBlockHeader best = {0, 0, 0, 0, 0, 0};
+        size_t bestSize = Max<size_t>();
+        ui64 slopes[2] = {0, 0};
+        const ui64 range = values[count - 1] - values[0];
+        if (count > 1 && values[count - 1] > values[0] && range < (ui64(1) << 55))
+            slopes[1] = (range << SLOPE_SHIFT) / (count - 1);
+        for (size_t k = 0; k < 2; ++k) {
+            const ui64 slope = slopes[k];
+            if (k && !slope)
+                continue;
+            TBlockHeader header = {0, slope, 0, 0, 0, 0};
+            // offsets from the first value are exact unless the block spans almost all ui64 range
+            i64 minOffset = 0;
+            bool fits = true;
+            const ui64 first = values[0];
+            for (ui32 i = 0; i < count; ++i) {
+                const i64 offset = i64(values[i] - ((i * slope) >> SLOPE_SHIFT) - first);
+                minOffset = Min(minOffset, offset);
+                fits = fits && offset > -(i64(1) << 62) && offset < (i64(1) << 62);
+            }
+            if (fits)
+                header.Base = first + ui64(minOffset);
+            else if (slope == 0)
+                header.Base = *std::min_element(values, values + count);
+            else
+                continue;
+            ui32 lengthCounts[65] = {};
+            for (ui32 i = 0; i < count; ++i)
+                ++lengthCounts[BitLength(values[i] - Predict(header, i))];
+            size_t size;
+            ChooseWidth(lengthCounts, count, &header.Bits, &header.HighBits, &size);
+            if (size < bestSize) {
+                best = header;
+                bestSize = size;
+            }
+        }
+        for (ui32 i = 0; i < count; ++i)
+            residuals[i] = values[i] - Predict(best, i);
+        return best;
+    }
+};
+
+template <typename T>
+class TBitPackedVector : TBitPackedVectorCommon {
+private:
+    static_assert(std::is_integral<T>::value && sizeof(T) <= sizeof(ui64), "expect integral T");
+
+    ui64 Size;
+    const char* Headers;
+    const char* Words;
+    ui64 WordsSize;
+
+    TBlockHeader GetHeader(size_t block) const {
+        return ReadUnaligned<TBlockHeader>(Headers + block * sizeof(TBlockHeader));
+    }
+
+    ui32 GetBlockCount(size_t block) const {
+        return (ui32)Min<ui64>(BLOCK_SIZE, Size - block * BLOCK_SIZE);
+    }
+
+public:
+    TBitPackedVector(const TBlob& blob)
+        : Size(ReadUnaligned<ui64>(blob.Data()))
+        , Headers((const char*)blob.Data() + 2 * sizeof(ui64))
+        , Words(Headers + (Size + BLOCK_SIZE - 1) / BLOCK_SIZE * sizeof(TBlockHeader))
+        , WordsSize(ReadUnaligned<ui64>((const char*)blob.Data() + sizeof(ui64)))
+    {
+    }
+
+    void Get(size_t idx, T& t) const {
+        assert(idx < Size);
+        const size_t block = idx / BLOCK_SIZE;
+        const TBlockHeader header = GetHeader(block);
+        const ui32 i = idx % BLOCK_SIZE;
+        const char* words = Words + header.Offset * sizeof(ui64);
+        ui64 residual = ReadBits(words, ui64(i) * header.Bits, header.Bits);
+        if (header.HighBits) {
+            const char* mask = words + WordCount(GetBlockCount(block), header.Bits) * sizeof(ui64);
+            const ui64 lo = ReadUnaligned<ui64>(mask);
+            const ui64 hi = ReadUnaligned<ui64>(mask + sizeof(ui64));
+            const ui64 word = i < 64 ? lo : hi;
+            if ((word >> (i % 64)) & 1) {
+                const ui32 rank = (i < 64 ? 0 : PopCount(lo)) + PopCount(word & ((ui64(1) << (i % 64)) - 1));
+                const char* high = mask + EXCEPTION_MASK_WORDS * sizeof(ui64);
+                residual |= ReadBits(high, ui64(rank) * header.HighBits, header.HighBits) << header.Bits;
+            }
+        }
+        t = FromUnsigned<T>(Predict(header, i) + residual);
+    }
+
+    T At(size_t idx) const {
+        T t;
+        Get(idx, t);
+        return t;
+    }
+
+    /// sequential decoding of values [begin, begin + count)
+    void Decode(size_t begin, size_t count, T* dst) const {
+        assert(begin + count <= Size);
+        const TUnpacker* unpackers = GetUnpackers();
+        ui64 residuals[BLOCK_SIZE];
+        while (count) {
+            const size_t block = begin / BLOCK_SIZE;
+            const ui32 first = begin % BLOCK_SIZE;
+            const ui32 blockCount = GetBlockCount(block);
+            const ui32 n = (ui32)Min<size_t>(count, blockCount - first);
+            const TBlockHeader header = GetHeader(block);
+            const char* words = Words + header.Offset * sizeof(ui64);
+            unpackers[header.Bits](words, first + n, residuals);
+            if (header.HighBits) {
+                const char* mask = words + WordCount(blockCount, header.Bits) * sizeof(ui64);
+                const char* high = mask + EXCEPTION_MASK_WORDS * sizeof(ui64);
+                ui64 bit = 0;
+                for (ui32 w = 0; w < EXCEPTION_MASK_WORDS; ++w) {
+                    for (ui64 m = ReadUnaligned<ui64>(mask + w * sizeof(ui64)); m; m &= m - 1, bit += header.HighBits) {
+                        const ui32 i = w * 64 + CountTrailingZeroBits(m);
+                        residuals[i] |= ReadBits(high, bit, header.HighBits) << header.Bits;
+                    }
+                }
+            }
+            ui64 slope = first * header.Slope;
+            for (ui32 i = first; i < first + n; ++i, slope += header.Slope)
+                *dst++ = FromUnsigned<T>(header.Base + (slope >> SLOPE_SHIFT) + residuals[i]);
+            begin += n;
+            count -= n;
+        }
+    }
+
+    size_t GetSize() const {
+        return Size;
+    }
+
+    size_t RealSize() const {
+        return 2 * sizeof(ui64) + (Words - Headers) + WordsSize * sizeof(ui64);
+    }
+};
+
+template <typename T>
+class TBitPackedVectorWriter : TBitPackedVectorCommon {
+private:
+    static_assert(std::is_integral<T>::value && sizeof(T) <= sizeof(ui64), "expect integral T");
+
+    TVector<T> Vector;
+
+public:
+    TBitPackedVectorWriter() = default;
+
+    void PushBack(const T& value) {
+        Vector.push_back(value);
+    }
+
+    void Save(IOutputStream& out) const {
+        const size_t blockCount = (Vector.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        TVector<TBlockHeader> headers(blockCount);
+        TVector<ui64> words;
+        ui64 values[BLOCK_SIZE];
+        ui64 residuals[BLOCK_SIZE];
+        for (size_t block = 0; block < blockCount; ++block) {
+            const ui32 count = (ui32)Min<size_t>(BLOCK_SIZE, Vector.size() - block * BLOCK_SIZE);
+            for (ui32 i = 0; i < count; ++i)
+                values[i] = ToUnsigned(Vector[block * BLOCK_SIZE + i]);
+            TBlockHeader& header = headers[block];
+            header = EncodeBlock(values, count, residuals);
+            header.Offset = IntegerCast<ui32>(words.size());
+            PackBits(residuals, count, header.Bits, words);
+            if (header.HighBits) {
+                ui64 mask[EXCEPTION_MASK_WORDS] = {};
+                ui32 exceptions = 0;
+                for (ui32 i = 0; i < count; ++i) {
+                    if (residuals[i] >> header.Bits) {
+                        mask[i / 64] |= ui64(1) << (i % 64);
+                        values[exceptions++] = residuals[i] >> header.Bits;
+                    }
+                }
+                words.insert(words.end(), mask, mask + EXCEPTION_MASK_WORDS);
+                PackBits(values, exceptions, header.HighBits, words);
+            }
+        }
+        WriteBin<ui64>(&out, Vector.size());
+        WriteBin<ui64>(&out, words.size());
+        out.Write(headers.data(), headers.size() * sizeof(TBlockHeader));
+        out.Write(words.data(), words.size() * sizeof(ui64));
+    }
+
+    const T& At(size_t idx) const {
+        assert(idx < Size());
+        return Vector[idx];
+    }
+
+    T& At(size_t idx) {
+        assert(idx < Size());
+        return Vector[idx];
+    }
+
+    void Clear() {
+        Vector.clear();
+    }
+
+    size_t Size() const {
+        return Vector.size();
+    }
+
+    void Resize(size_t size) {
+        Vector.resize(size);
+    }
+
+    void Resize(size_t size, const T& value) {
+        Vector.resize(size, value);
+    }
+};
+
+template <typename T, bool>
+struct TBitPackedVectorG;
+
+template <typename X>
+struct TBitPackedVectorG<X, false> {
+    typedef TBitPackedVector<X> T;
+};
+
+template <typename X>
+struct TBitPackedVectorG<X, true> {
+    typedef TBitPackedVectorWriter<X> T;
+};
+
 template <typename T>
 struct TIsMemsetThisWithZeroesSupported {
     enum {
@@ -400,6 +766,242 @@ struct TPlainHashG<Key, Value, true> {
     typedef TPlainHashWriter<Key, Value> T;
 };
 
+/// Minimal perfect hash (NPerfectHash::TLayout) of integer keys: a lookup reads one bit-packed pilot and
+/// makes exactly one probe into the packed slot array. Keys are not stored: each slot keeps the value
+/// prefixed with an optional 1, 2 or 4 byte fingerprint of the key, without it Find succeeds for any key.
+class TPerfectHashCommon {
+protected:
+    static const ui16 VERSION_ID = 1;
+    static const size_t HEADER_SIZE = 32;
+
+    static ui64 Mix(ui64 x) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+    /// bijective, so distinct keys never collide
+    template <typename TKey>
+    static ui64 KeyHash(typename TTypeTraits<TKey>::TFuncParam key, ui64 seed) {
+        static_assert(std::is_integral<TKey>::value || std::is_enum<TKey>::value, "expect integral key");
+        return Mix(ui64(key) ^ seed);
+    }
+
+    static size_t PilotsByteSize(ui32 bucketCount, ui8 pilotBits) {
+        // padded so that any pilot can be read with a single unaligned ui64 load
+        return ((size_t(bucketCount) * pilotBits + 7) / 8 + 2 * sizeof(ui64)) & ~(sizeof(ui64) - 1);
+    }
+
+    static size_t RemapByteSize(ui32 size, ui32 tableSize) {
+        return (sizeof(ui32) * size_t(tableSize - size) + sizeof(ui64) - 1) & ~(sizeof(ui64) - 1);
+    }
+};
+
+template <typename TKey, typename TValue>
+class TPerfectHashWriter : TPerfectHashCommon {
+private:
+    static_assert(TIsMemsetThisWithZeroesSupported<TValue>::Result, "expect TIsMemsetThisWithZeroesSupported<TValue>::Result");
+
+    TVector<TKey> Keys;
+    TVector<TValue> Values;
+    ui16 FingerprintBytes;
+    ui64 Seed;
+
+public:
+    explicit TPerfectHashWriter(ui16 fingerprintBytes = 1, ui64 seed = 0)
+        : FingerprintBytes(fingerprintBytes)
+        , Seed(seed)
+    {
+        if (fingerprintBytes != 0 && fingerprintBytes != 1 && fingerprintBytes != 2 && fingerprintBytes != 4)
+            ythrow yexception() << "bad fingerprint size " << fingerprintBytes;
+    }
+
+    void Add(const TKey& key, const TValue& value) {
+        Keys.push_back(key);
+        Values.push_back(value);
+    }
+
+    size_t Size() const {
+        return Keys.size();
+    }
+
+    void Save(IOutputStream& out) const {
+        if (Keys.size() >= Max<ui32>() / 2)
+            ythrow yexception() << "too many keys: " << Keys.size();
+
+        const ui32 size = (ui32)Keys.size();
+        const NPerfectHash::TLayout layout(size);
+        TVector<ui64> hashes(size);
+        TVector<ui32> pilots;
+        TVector<ui32> remap;
+        TVector<ui32> slotKeys;
+        /// the key hash is bijective, so equal keys fail with any seed
+        ui64 seed = Seed;
+        for (;; ++seed) {
+            if (seed - Seed == NPerfectHash::MAX_SEED_CHOICE_COUNT)
+                ythrow yexception() << "key clash";
+            for (ui32 i = 0; i < size; ++i)
+                hashes[i] = KeyHash<TKey>(Keys[i], seed);
+            if (NPerfectHash::Build(hashes, layout, &pilots, &remap, &slotKeys))
+                break;
+        }
+
+        ui32 maxPilot = 0;
+        for (ui32 pilot : pilots)
+            maxPilot = Max(maxPilot, pilot);
+        ui8 pilotBits = 1;
+        while (pilotBits < 32 && (maxPilot >> pilotBits))
+            ++pilotBits;
+        TVector<char> packedPilots(PilotsByteSize(layout.GetBucketCount(), pilotBits), 0);
+        for (ui32 b = 0; b < layout.GetBucketCount(); ++b) {
+            const size_t bit = size_t(b) * pilotBits;
+            char* word = packedPilots.data() + bit / 8;
+            WriteUnaligned<ui64>(word, ReadUnaligned<ui64>(word) | (ui64(pilots[b]) << (bit % 8)));
+        }
+
+        WriteBin<ui16>(&out, VERSION_ID);
+        WriteBin<ui16>(&out, FingerprintBytes);
+        WriteBin<ui32>(&out, sizeof(TValue));
+        WriteBin<ui64>(&out, seed);
+        WriteBin<ui32>(&out, size);
+        WriteBin<ui32>(&out, layout.GetTableSize());
+        WriteBin<ui32>(&out, layout.GetBucketCount());
+        WriteBin<ui32>(&out, pilotBits);
+        out.Write(packedPilots.data(), packedPilots.size());
+        remap.resize(RemapByteSize(size, layout.GetTableSize()) / sizeof(ui32), 0);
+        out.Write(remap.data(), remap.size() * sizeof(ui32));
+
+        TVector<char> slot(FingerprintBytes + sizeof(TValue));
+        for (ui32 i = 0; i < size; ++i) {
+            const ui32 key = slotKeys[i];
+            const ui32 fingerprint = NPerfectHash::Fingerprint(hashes[key]);
+            memcpy(slot.data(), &fingerprint, FingerprintBytes);
+            /// to avoid uninitialized bytes
+            TValue value;
+            memset(&value, 0, sizeof(value));
+            value = Values[key];
+            memcpy(slot.data() + FingerprintBytes, &value, sizeof(value));
+            out.Write(slot.data(), slot.size());
+        }
+    }
+};
+
+template <typename TKey, typename TValue>
+class TPerfectHash : TPerfectHashCommon {
+private:
+    const char* P;
+    const char* Pilots;
+    const ui32* Remap;
+    const char* Slots;
+    ui64 Seed;
+    NPerfectHash::TLayout Layout;
+    ui64 PilotMask;
+    ui16 FingerprintBytes;
+    ui8 PilotBits;
+
+    template <typename T>
+    void Init(const T* p) {
+        static_assert(sizeof(T) == 1, "expect sizeof(T) == 1");
+        P = reinterpret_cast<const char*>(p);
+        const ui16 version = ReadUnaligned<ui16>(P);
+        if (version != VERSION_ID)
+            ythrow yexception() << "bad version: " << version;
+        FingerprintBytes = ReadUnaligned<ui16>(P + 2);
+        const ui32 valueSize = ReadUnaligned<ui32>(P + 4);
+        if (valueSize != sizeof(TValue))
+            ythrow yexception() << "bad size " << valueSize << " instead of " << sizeof(TValue);
+        Seed = ReadUnaligned<ui64>(P + 8);
+        Layout = NPerfectHash::TLayout(ReadUnaligned<ui32>(P + 16), ReadUnaligned<ui32>(P + 20), ReadUnaligned<ui32>(P + 24));
+        PilotBits = (ui8)ReadUnaligned<ui32>(P + 28);
+        PilotMask = (ui64(1) << PilotBits) - 1;
+        Pilots = P + HEADER_SIZE;
+        Remap = (const ui32*)(Pilots + PilotsByteSize(Layout.GetBucketCount(), PilotBits));
+        Slots = (const char*)Remap + RemapByteSize(Layout.GetSize(), Layout.GetTableSize());
+    }
+
+    size_t SlotSize() const {
+        return FingerprintBytes + sizeof(TValue);
+    }
+
+    ui64 GetPilot(ui32 bucket) const {
+        const size_t bit = size_t(bucket) * PilotBits;
+        return (ReadUnaligned<ui64>(Pilots + bit / 8) >> (bit % 8)) & PilotMask;
+    }
+
+    bool CheckFingerprint(const char* slot, ui32 fingerprint) const {
+        switch (FingerprintBytes) {
+            case 0:
+                return true;
+            case 1:
+                return ReadUnaligned<ui8>(slot) == (ui8)fingerprint;
+            case 2:
+                return ReadUnaligned<ui16>(slot) == (ui16)fingerprint;
+            default:
+                return ReadUnaligned<ui32>(slot) == fingerprint;
+        }
+    }
+
+public:
+    TPerfectHash(const char* p) {
+        Init(p);
+    }
+
+    TPerfectHash(const TBlob& blob) {
+        Init(blob.Begin());
+    }
+
+    bool Find(typename TTypeTraits<TKey>::TFuncParam key, TValue* res) const {
+        const ui32 size = Layout.GetSize();
+        if (!size)
+            return false;
+        const ui64 keyHash = KeyHash<TKey>(key, Seed);
+        ui32 pos = Layout.Position(keyHash, GetPilot(Layout.Bucket(keyHash)));
+        if (pos >= size)
+            pos = ReadUnaligned<ui32>(Remap + (pos - size));
+        const char* slot = Slots + pos * SlotSize();
+        if (!CheckFingerprint(slot, NPerfectHash::Fingerprint(keyHash)))
+            return false;
+        *res = ReadUnaligned<TValue>(slot + FingerprintBytes);
+        return true;
+    }
+
+    TValue Get(typename TTypeTraits<TKey>::TFuncParam key) const {
+        TValue res;
+        if (Find(key, &res))
+            return res;
+        else
+            ythrow yexception() << "key not found";
+    }
+
+    size_t GetSize() const {
+        return Layout.GetSize();
+    }
+
+    const char* ByteEnd() const {
+        return Slots + Layout.GetSize() * SlotSize();
+    }
+
+    size_t ByteSize() const {
+        return ByteEnd() - P;
+    }
+};
+
+template <typename Key, typename Value, bool>
+struct TPerfectHashG;
+
+template <typename Key, typename Value>
+struct TPerfectHashG<Key, Value, false> {
+    typedef TPerfectHash<Key, Value> T;
+};
+
+template <typename Key, typename Value>
+struct TPerfectHashG<Key, Value, true> {
+    typedef TPerfectHashWriter<Key, Value> T;
+};
+
 template <typename T>
 class TSingleValue {
 private:
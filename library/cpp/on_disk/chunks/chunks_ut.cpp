@@ -1,5 +1,6 @@
 #include <library/cpp/testing/unittest/registar.h>
 
+#include <util/random/fast.h>
 #include <util/stream/file.h>
 #include <util/system/filemap.h>
 #include <util/system/mktemp.h>
@@ -36,6 +37,8 @@ struct TSaveLoadVectorNonPodElement<TPodStruct> {
 class TChunkedHelpersTest: public TTestBase {
     UNIT_TEST_SUITE(TChunkedHelpersTest);
     UNIT_TEST(TestHash)
+    UNIT_TEST(TestPerfectHash)
+    UNIT_TEST(TestBitPackedVector)
     UNIT_TEST(TestGeneralVector)
     UNIT_TEST(TestStrings);
     UNIT_TEST(TestNamedChunkedData);
@@ -80,6 +83,156 @@ public:
         }
     }
 
+    template <typename TKey, typename TValue>
+    void CheckPerfectHash(const TVector<std::pair<TKey, TValue>>& data, ui16 fingerprintBytes) {
+        TBufferStream stream;
+        {
+            TPerfectHashWriter<TKey, TValue> writer(fingerprintBytes);
+            for (const auto& kv : data)
+                writer.Add(kv.first, kv.second);
+            writer.Save(stream);
+        }
+        TBlob temp = TBlob::FromStreamSingleThreaded(stream);
+        TPerfectHash<TKey, TValue> reader(temp);
+        UNIT_ASSERT_VALUES_EQUAL(reader.GetSize(), data.size());
+        UNIT_ASSERT_VALUES_EQUAL(reader.ByteSize(), temp.Size());
+        for (const auto& kv : data) {
+            TValue value = TValue();
+            UNIT_ASSERT(reader.Find(kv.first, &value));
+            UNIT_ASSERT_EQUAL(value, kv.second);
+        }
+        if (data.empty()) {
+            TValue value;
+            UNIT_ASSERT(!reader.Find(TKey(), &value));
+        }
+    }
+
+    void TestPerfectHash() {
+        for (ui16 fingerprintBytes : {0, 1, 2, 4}) {
+            for (size_t size : {0, 1, 2, 3, 100, 10000, 300000}) {
+                TVector<std::pair<ui64, ui32>> data;
+                for (size_t i = 0; i < size; ++i)
+                    data.push_back({i << 20, (ui32)(i * 7)}); // keys with empty low bits are bad for TPlainHash
+                CheckPerfectHash(data, fingerprintBytes);
+            }
+        }
+
+        {
+            TVector<std::pair<i32, ui16>> negative;
+            for (i32 i = -1000; i < 1000; ++i)
+                negative.push_back({i * 3, (ui16)i});
+            CheckPerfectHash(negative, 2);
+            TVector<std::pair<wchar16, void*>> chars = {{'a', nullptr}, {'b', &negative}};
+            CheckPerfectHash(chars, 1);
+        }
+
+        { // fingerprints reject absent keys
+            const size_t size = 100000;
+            TBufferStream stream;
+            {
+                TPerfectHashG<ui64, ui64, true>::T writer(2);
+                for (size_t i = 0; i < size; ++i)
+                    writer.Add(i * 2, i);
+                writer.Save(stream);
+            }
+            TBlob temp = TBlob::FromStreamSingleThreaded(stream);
+            TPerfectHashG<ui64, ui64, false>::T reader(temp);
+            size_t falsePositives = 0;
+            for (size_t i = 0; i < size; ++i) {
+                ui64 value;
+                falsePositives += reader.Find(i * 2 + 1, &value);
+            }
+            UNIT_ASSERT(falsePositives < size / 65536 * 3 + 10);
+            UNIT_ASSERT_VALUES_EQUAL(reader.Get(20), 10);
+            UNIT_ASSERT_EXCEPTION(reader.Get(21), yexception);
+        }
+
+        { // these keys are in one bucket and used to get one position with any pilot
+            TVector<std::pair<ui64, ui32>> data = {{0xbd8612ac3973160fULL, 1}, {0x3ec6d3d239bacd13ULL, 2}};
+            for (ui32 i = 0; data.size() < 1000; ++i)
+                data.push_back({i, i});
+            CheckPerfectHash(data, 0);
+        }
+
+        {
+            TBufferStream stream;
+            TPerfectHashWriter<ui32, ui32> writer;
+            writer.Add(1, 1);
+            writer.Add(2, 2);
+            writer.Add(1, 3);
+            UNIT_ASSERT_EXCEPTION(writer.Save(stream), yexception);
+            UNIT_ASSERT_EXCEPTION((TPerfectHashWriter<ui32, ui32>(3)), yexception);
+        }
+    }
+
+    template <typename T>
+    size_t CheckBitPackedVector(const TVector<T>& data) {
+        TBufferStream stream;
+        {
+            TBitPackedVectorWriter<T> writer;
+            for (T value : data)
+                writer.PushBack(value);
+            writer.Save(stream);
+        }
+        TBlob temp = TBlob::FromStreamSingleThreaded(stream);
+        TBitPackedVector<T> reader(temp);
+        UNIT_ASSERT_VALUES_EQUAL(reader.GetSize(), data.size());
+        UNIT_ASSERT_VALUES_EQUAL(reader.RealSize(), temp.Size());
+        for (size_t i = 0; i < data.size(); ++i)
+            UNIT_ASSERT_VALUES_EQUAL(reader.At(i), data[i]);
+
+        TVector<T> decoded(data.size());
+        reader.Decode(0, data.size(), decoded.data());
+        UNIT_ASSERT(decoded == data);
+        for (size_t begin : {1, 127, 128, 300}) {
+            for (size_t count : {1, 2, 129, 1000}) {
+                if (begin + count > data.size())
+                    continue;
+                decoded.assign(count, 0);
+                reader.Decode(begin, count, decoded.data());
+                UNIT_ASSERT(std::equal(decoded.begin(), decoded.end(), data.begin() + begin));
+            }
+        }
+        return temp.Size();
+    }
+
+    void TestBitPackedVector() {
+        TFastRng<ui64> rng(3);
+        CheckBitPackedVector(TVector<ui32>());
+        CheckBitPackedVector(TVector<ui32>(1, 5));
+        CheckBitPackedVector(TVector<ui16>(1000, 7));
+
+        TVector<ui32> ids;
+        for (ui32 id = 0; ids.size() < 100000; id += 1 + rng.Uniform(30))
+            ids.push_back(id);
+        const size_t idsSize = CheckBitPackedVector(ids);
+        UNIT_ASSERT(idsSize * 3 < ids.size() * sizeof(ui32));
+
+        TVector<ui32> counters;
+        for (size_t i = 0; i < 10000; ++i)
+            counters.push_back(rng.Uniform(100) < 90 ? rng.Uniform(4) : rng.Uniform(1000));
+        const size_t countersSize = CheckBitPackedVector(counters);
+        UNIT_ASSERT(countersSize * 5 < counters.size() * sizeof(ui32));
+
+        TVector<ui64> wide;
+        for (size_t i = 0; i < 1000; ++i)
+            wide.push_back(i % 3 ? rng.GenRand() : (i % 2 ? Max<ui64>() : 0));
+        CheckBitPackedVector(wide);
+        TVector<ui64> sortedWide;
+        for (size_t i = 0; i < 1000; ++i)
+            sortedWide.push_back((ui64(1) << 54) + i * (ui64(1) << 40) + rng.Uniform(1000));
+        CheckBitPackedVector(sortedWide);
+
+        TVector<i64> signedValues;
+        for (size_t i = 0; i < 1000; ++i)
+            signedValues.push_back(i % 5 == 0 ? (i % 2 ? Min<i64>() : Max<i64>()) : i64(i) * 3 - 1500);
+        CheckBitPackedVector(signedValues);
+        TVector<i32> sortedSigned;
+        for (i32 i = -700; i < 700; ++i)
+            sortedSigned.push_back(i * 5);
+        UNIT_ASSERT(CheckBitPackedVector(sortedSigned) < 16 + 11 * 24 + 64);
+    }
+
     void TestGeneralVector() {
         { /// ui32
             const size_t N = 3;
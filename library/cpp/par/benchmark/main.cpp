@@ -0,0 +1,127 @@
+#include <library/cpp/blockcodecs/codecs.h>
+#include <library/cpp/digest/crc32c/crc32c.h>
+#include <library/cpp/par/compression.h>
+#include <library/cpp/testing/benchmark/bench.h>
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/singleton.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/random/fast.h>
+#include <util/string/cast.h>
+
+using namespace NPar;
+
+namespace {
+    // compressible, but not trivially; 8 blocks of QuickLZCompress
+    struct TPayload {
+        TVector<char> Data;
+        TVector<char> Packed;
+
+        TPayload() {
+            TFastRng<ui64> rng(9);
+            Data.resize(32 << 20);
+            for (size_t i = 0; i < Data.size(); ++i) {
+                Data[i] = (char)(i % 251 < 200 ? 'a' + (i / 4096) % 26 : rng.Uniform(256));
+            }
+            Packed = Data;
+            QuickLZCompress(&Packed);
+        }
+
+        TStringBuf Src() const {
+            return TStringBuf(Data.data(), Data.size());
+        }
+    };
+
+    void UseThreads(size_t count) {
+        if (LocalExecutor().GetThreadCount() < count) {
+            LocalExecutor().RunAdditionalThreads(count - LocalExecutor().GetThreadCount());
+        }
+    }
+}
+
+// whole buffer compression as done before streaming
+Y_CPU_BENCHMARK(WholeBufferCompress, iface) {
+    const TPayload& payload = *Singleton<TPayload>();
+    const NBlockCodecs::ICodec* codec = NBlockCodecs::Codec("lz4fast");
+    TVector<char> packed(codec->MaxCompressedLength(payload.Src()));
+    for (size_t i = 0; i < iface.Iterations(); ++i) {
+        Y_DO_NOT_OPTIMIZE_AWAY(codec->Compress(payload.Src(), packed.data()));
+    }
+}
+
+Y_CPU_BENCHMARK(StreamedCompress, iface) {
+    const TPayload& payload = *Singleton<TPayload>();
+    UseThreads(3);
+    TVector<char> packed;
+    packed.reserve(QuickLZMaxPackedSize(payload.Src()));
+    for (size_t i = 0; i < iface.Iterations(); ++i) {
+        packed.clear();
+        QuickLZCompress(payload.Src(), [&packed](TStringBuf piece) {
+            packed.insert(packed.end(), piece.begin(), piece.end());
+        });
+        Y_DO_NOT_OPTIMIZE_AWAY(packed.size());
+    }
+}
+
+Y_CPU_BENCHMARK(StreamedDecompress, iface) {
+    const TPayload& payload = *Singleton<TPayload>();
+    UseThreads(3);
+    TVector<char> unpacked;
+    for (size_t i = 0; i < iface.Iterations(); ++i) {
+        QuickLZDecompress(TStringBuf(payload.Packed.data(), payload.Packed.size()), &unpacked);
+        Y_DO_NOT_OPTIMIZE_AWAY(unpacked.size());
+    }
+}
+
+/* requester and receiver sides of a neh message, crc and message copies included */
+
+// as before streaming: the payload is packed in place, then the crc is taken and the packed copy is appended
+Y_CPU_BENCHMARK(WholeBufferMessage, iface) {
+    const TPayload& payload = *Singleton<TPayload>();
+    UseThreads(3);
+    for (size_t i = 0; i < iface.Iterations(); ++i) {
+        TVector<char> data = payload.Data;
+        QuickLZCompress(&data);
+        TString msg = ToString(Crc32c(data.data(), data.size()));
+        msg.AppendNoAlias(data.data(), data.size());
+        Y_DO_NOT_OPTIMIZE_AWAY(msg.size());
+    }
+}
+
+Y_CPU_BENCHMARK(StreamedMessage, iface) {
+    const TPayload& payload = *Singleton<TPayload>();
+    UseThreads(3);
+    for (size_t i = 0; i < iface.Iterations(); ++i) {
+        TVector<char> data = payload.Data;
+        TString msg;
+        msg.reserve(QuickLZMaxPackedSize(payload.Src()));
+        ui32 crc = 0;
+        QuickLZCompress(TStringBuf(data.data(), data.size()), [&](TStringBuf piece) {
+            crc = Crc32cExtend(crc, piece.data(), piece.size());
+            msg.AppendNoAlias(piece.data(), piece.size());
+        });
+        Y_DO_NOT_OPTIMIZE_AWAY(msg.size() + crc);
+    }
+}
+
+// as before streaming: the request body is copied out of the message, then unpacked
+Y_CPU_BENCHMARK(CopiedMessageDecompress, iface) {
+    const TPayload& payload = *Singleton<TPayload>();
+    UseThreads(3);
+    for (size_t i = 0; i < iface.Iterations(); ++i) {
+        TVector<char> data(payload.Packed.begin(), payload.Packed.end());
+        QuickLZDecompress(&data);
+        Y_DO_NOT_OPTIMIZE_AWAY(data.size());
+    }
+}
+
+Y_CPU_BENCHMARK(MessageDecompress, iface) {
+    const TPayload& payload = *Singleton<TPayload>();
+    UseThreads(3);
+    for (size_t i = 0; i < iface.Iterations(); ++i) {
+        TVector<char> data;
+        QuickLZDecompress(TStringBuf(payload.Packed.data(), payload.Packed.size()), &data);
+        Y_DO_NOT_OPTIMIZE_AWAY(data.size());
+    }
+}
@@ -1,8 +1,11 @@
+#include "compression.h"
 #include "par_log.h"
 
 #include <library/cpp/blockcodecs/codecs.h>
 #include <library/cpp/logger/global/global.h>
+#include <library/cpp/threading/local_executor/local_executor.h>
 #include <util/system/env.h>
+#include <util/system/unaligned_mem.h>
 #include <util/generic/singleton.h>
 #include <util/generic/utility.h>
 
@@ -22,59 +25,102 @@ namespace NPar {
     const int N_SIGNATURE = 0x21a9e395;
     const int SIZEOF_SIGNATURE = sizeof(int);
 
-    const unsigned int BLOCK_SIZE = 2000000000;
+    /* Stream format:
+       | signature 4 bytes | LengthOfBlock1 4 bytes | Block1 compressed data | LengthOfBlock2 4 bytes| Block2 compressed data | ... |
+       Blocks used to be up to 2Gb (most codecs don't support bigger chunks), readers accept any block size.
+       Small blocks let us compress and decompress in parallel and keep only a few of them in flight.
+    */
+    const size_t BLOCK_SIZE = 1 << 22;
     using TBlockLen = unsigned int;
 
     static const ICodec* GetCodec() {
         return Singleton<TCompressionHolder>()->CodecPtr;
     }
 
-    void QuickLZCompress(TVector<char>* dst) {
-        if (!dst || dst->empty())
+    static bool NeedPack(TStringBuf src) {
+        return src.size() > MIN_SIZE_TO_PACK || (src.size() >= SIZEOF_SIGNATURE && ReadUnaligned<int>(src.data()) == N_SIGNATURE);
+    }
+
+    void QuickLZCompress(TStringBuf src, const TPackedDataConsumer& consumer) {
+        if (!NeedPack(src)) {
+            if (!src.empty()) {
+                consumer(src);
+            }
             return;
-        TStringBuf srcdata{dst->data(), dst->size()};
-        if (srcdata.size() > MIN_SIZE_TO_PACK || (srcdata.size() >= SIZEOF_SIGNATURE && *(int*)srcdata.data() == N_SIGNATURE)) {
-            const ICodec* usedCodec = GetCodec();
-            TVector<char> packed;
-            packed.yresize(SIZEOF_SIGNATURE);
-            *(int*)(packed.data()) = N_SIGNATURE;
-            /* Blocking for data >2Gb as most codecs don't support such big data chunks.
-               Stream format as follows:
-               | signature 4 bytes | LengthOfBlock1 4 bytes | Block1 compressed data | LengthOfBlock2 4 bytes| Block2 compressed data | ... |
-            */
-            for (size_t i = 0; i < srcdata.size(); i += BLOCK_SIZE) {
-                TStringBuf srcDataBlock{dst->data() + i, Min((size_t)(dst->size() - i), (size_t)BLOCK_SIZE)};
-                size_t packedPreviousSize = packed.size();
-                packed.yresize(packedPreviousSize + sizeof(TBlockLen) + usedCodec->MaxCompressedLength(srcDataBlock));
-                TBlockLen packedBlockSize = usedCodec->Compress(srcDataBlock, (packed.data() + packedPreviousSize + sizeof(TBlockLen)));
-                *(TBlockLen*)(packed.data() + packedPreviousSize) = packedBlockSize;
-                packed.yresize(packedPreviousSize + sizeof(TBlockLen) + packedBlockSize);
+        }
+        const ICodec* usedCodec = GetCodec();
+        const int signature = N_SIGNATURE;
+        consumer(TStringBuf((const char*)&signature, SIZEOF_SIGNATURE));
+
+        const size_t blockCount = (src.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        const size_t batchSize = Min<size_t>(blockCount, LocalExecutor().GetThreadCount() + 1);
+        TVector<TVector<char>> packed(batchSize);
+        for (size_t batchStart = 0; batchStart < blockCount; batchStart += batchSize) {
+            const size_t batchEnd = Min(batchStart + batchSize, blockCount);
+            LocalExecutor().ExecRange([&](int i) {
+                const size_t blockId = batchStart + i;
+                TStringBuf block = src.SubStr(blockId * BLOCK_SIZE, BLOCK_SIZE);
+                TVector<char>& dst = packed[i];
+                dst.yresize(sizeof(TBlockLen) + usedCodec->MaxCompressedLength(block));
+                const TBlockLen packedBlockSize = usedCodec->Compress(block, dst.data() + sizeof(TBlockLen));
+                WriteUnaligned<TBlockLen>(dst.data(), packedBlockSize);
+                dst.yresize(sizeof(TBlockLen) + packedBlockSize);
+            }, 0, batchEnd - batchStart, TLocalExecutor::WAIT_COMPLETE);
+            for (size_t i = 0; i < batchEnd - batchStart; ++i) {
+                consumer(TStringBuf(packed[i].data(), packed[i].size()));
             }
-            dst->swap(packed);
         }
     }
 
-    void QuickLZDecompress(TVector<char>* dst) {
-        if (!dst) {
+    size_t QuickLZMaxPackedSize(TStringBuf src) {
+        if (!NeedPack(src)) {
+            return src.size();
+        }
+        const size_t blockCount = (src.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        const size_t maxBlockSize = GetCodec()->MaxCompressedLength(src.SubStr(0, BLOCK_SIZE));
+        return SIZEOF_SIGNATURE + blockCount * (sizeof(TBlockLen) + maxBlockSize);
+    }
+
+    void QuickLZDecompress(TStringBuf src, TVector<char>* dst) {
+        if (src.size() < SIZEOF_SIGNATURE || ReadUnaligned<int>(src.data()) != N_SIGNATURE) {
+            dst->assign(src.begin(), src.end());
             return;
         }
-        int srcSize = dst->ysize();
-        if (srcSize < SIZEOF_SIGNATURE) {
+        const ICodec* usedCodec = GetCodec();
+        TVector<TStringBuf> blocks;
+        TVector<size_t> offsets;
+        size_t unpackedSize = 0;
+        for (size_t i = SIZEOF_SIGNATURE; i < src.size();) {
+            const TBlockLen packedBlockSize = ReadUnaligned<TBlockLen>(src.data() + i);
+            blocks.push_back(src.SubStr(i + sizeof(TBlockLen), packedBlockSize));
+            offsets.push_back(unpackedSize);
+            unpackedSize += usedCodec->DecompressedLength(blocks.back());
+            i += packedBlockSize + sizeof(TBlockLen);
+        }
+        dst->yresize(unpackedSize);
+        LocalExecutor().ExecRange([&](int i) {
+            usedCodec->Decompress(blocks[i], dst->data() + offsets[i]);
+        }, 0, blocks.ysize(), TLocalExecutor::WAIT_COMPLETE);
+    }
+
+    void QuickLZCompress(TVector<char>* dst) {
+        if (!dst || !NeedPack(TStringBuf(dst->data(), dst->size()))) {
             return;
         }
-        if (*(int*)dst->data() != N_SIGNATURE) {
+        TVector<char> packed;
+        packed.reserve(QuickLZMaxPackedSize(TStringBuf(dst->data(), dst->size())));
+        QuickLZCompress(TStringBuf(dst->data(), dst->size()), [&packed](TStringBuf piece) {
+            packed.insert(packed.end(), piece.begin(), piece.end());
+        });
+        dst->swap(packed);
+    }
+
+    void QuickLZDecompress(TVector<char>* dst) {
+        if (!dst || dst->size() < SIZEOF_SIGNATURE || ReadUnaligned<int>(dst->data()) != N_SIGNATURE) {
             return;
         }
         TVector<char> unpacked;
-        const ICodec* usedCodec = GetCodec();
-        for (size_t i = SIZEOF_SIGNATURE; i < (*dst).size();) {
-            TBlockLen packedBlockSize = *(TBlockLen*)(dst->data() + i);
-            TStringBuf srcDataBlock{dst->data() + i + sizeof(TBlockLen), packedBlockSize};
-            size_t unpackedPreviousSize = unpacked.size();
-            unpacked.yresize(unpackedPreviousSize + usedCodec->DecompressedLength(srcDataBlock));
-            unpacked.yresize(unpackedPreviousSize + usedCodec->Decompress(srcDataBlock, unpacked.data() + unpackedPreviousSize));
-            i += packedBlockSize + sizeof(TBlockLen);
-        }
+        QuickLZDecompress(TStringBuf(dst->data(), dst->size()), &unpacked);
         dst->swap(unpacked);
     }
 }
@@ -1,9 +1,22 @@
 #pragma once
 
+#include <util/generic/strbuf.h>
 #include <util/generic/vector.h>
 
+#include <functional>
+
 namespace NPar {
     // pack small packets, for packed add signature
     void QuickLZCompress(TVector<char>* dst);
     void QuickLZDecompress(TVector<char>* dst);
+
+    // Streaming versions. Data is split into blocks which are compressed in parallel batches, so at most
+    // one batch of compressed blocks is held besides the source and packed pieces are handed to consumer
+    // in order as soon as the batch is ready. Output format is the same as of in-place functions.
+    using TPackedDataConsumer = std::function<void(TStringBuf packedPiece)>;
+    void QuickLZCompress(TStringBuf src, const TPackedDataConsumer& consumer);
+    // upper bound of streamed output size, to reserve destination buffer
+    size_t QuickLZMaxPackedSize(TStringBuf src);
+    // decompresses blocks in parallel directly into presized dst, unpacked data is copied as is
+    void QuickLZDecompress(TStringBuf src, TVector<char>* dst);
 }
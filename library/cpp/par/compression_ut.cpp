@@ -0,0 +1,84 @@
+#include <library/cpp/testing/unittest/registar.h>
+
+#include "compression.h"
+
+#include <library/cpp/blockcodecs/codecs.h>
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/random/fast.h>
+#include <util/system/unaligned_mem.h>
+
+using namespace NPar;
+
+namespace {
+    TVector<char> MakeData(size_t size, ui64 seed) {
+        TFastRng<ui64> rng(seed);
+        TVector<char> data(size);
+        for (size_t i = 0; i < size; ++i) {
+            // compressible, but not trivially
+            data[i] = (char)(i % 251 < 200 ? 'a' + (i / 4096) % 26 : rng.Uniform(256));
+        }
+        return data;
+    }
+
+    TVector<char> StreamCompress(const TVector<char>& src) {
+        TVector<char> packed;
+        QuickLZCompress(TStringBuf(src.data(), src.size()), [&packed](TStringBuf piece) {
+            packed.insert(packed.end(), piece.begin(), piece.end());
+        });
+        return packed;
+    }
+
+    void CheckRoundTrip(const TVector<char>& src) {
+        TVector<char> inplace = src;
+        QuickLZCompress(&inplace);
+        const TVector<char> streamed = StreamCompress(src);
+        UNIT_ASSERT(inplace == streamed);
+        UNIT_ASSERT(streamed.size() <= QuickLZMaxPackedSize(TStringBuf(src.data(), src.size())));
+
+        TVector<char> unpacked;
+        QuickLZDecompress(TStringBuf(streamed.data(), streamed.size()), &unpacked);
+        UNIT_ASSERT(unpacked == src);
+        QuickLZDecompress(&inplace);
+        UNIT_ASSERT(inplace == src);
+    }
+}
+
+Y_UNIT_TEST_SUITE(TParCompressionTest) {
+    Y_UNIT_TEST(TestSmall) {
+        CheckRoundTrip({});
+        CheckRoundTrip(MakeData(100, 1));
+        TVector<char> small = MakeData(100, 2);
+        QuickLZCompress(&small);
+        UNIT_ASSERT(small == MakeData(100, 2)); // small packets are not packed
+
+        TVector<char> withSignature = StreamCompress(MakeData(5000, 3));
+        withSignature.resize(10);
+        CheckRoundTrip(withSignature);
+    }
+
+    Y_UNIT_TEST(TestBlocks) {
+        CheckRoundTrip(MakeData(4001, 4));
+        CheckRoundTrip(MakeData(1 << 22, 5));
+        CheckRoundTrip(MakeData((3 << 22) + 17, 6));
+    }
+
+    Y_UNIT_TEST(TestParallel) {
+        LocalExecutor().RunAdditionalThreads(3);
+        CheckRoundTrip(MakeData((9 << 22) + 1, 7));
+    }
+
+    Y_UNIT_TEST(TestLegacyFormat) {
+        // single block stream as produced by the old whole-buffer compressor
+        const TVector<char> src = MakeData(10 << 20, 8);
+        const NBlockCodecs::ICodec* codec = NBlockCodecs::Codec("lz4fast");
+        TVector<char> packed(sizeof(int) + sizeof(ui32) + codec->MaxCompressedLength(TStringBuf(src.data(), src.size())));
+        WriteUnaligned<int>(packed.data(), 0x21a9e395);
+        const ui32 len = codec->Compress(TStringBuf(src.data(), src.size()), packed.data() + sizeof(int) + sizeof(ui32));
+        WriteUnaligned<ui32>(packed.data() + sizeof(int), len);
+        packed.resize(sizeof(int) + sizeof(ui32) + len);
+
+        QuickLZDecompress(&packed);
+        UNIT_ASSERT(packed == src);
+    }
+}
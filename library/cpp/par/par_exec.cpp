@@ -6,6 +6,7 @@
 namespace NPar {
     TAtomic TMRCommandExec::LocalMapWins = 0;
     TAtomic TMRCommandExec::RemoteMapWins = 0;
+    TAtomic TMRCommandExec::SpeculativeLaunches = 0;
 
     static void CheckSchedule(const TJobRequest& src) {
         for (int i = 0; i < src.Descr.ExecList.ysize(); ++i) {
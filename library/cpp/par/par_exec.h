@@ -1,6 +1,7 @@
 #pragma once
 
 #include "par.h"
+#include "par_host_stats.h"
 #include "par_jobreq.h"
 #include "par_remote.h"
 #include "par_log.h"
@@ -197,10 +198,15 @@ namespace NPar {
             TVector<TVector<char>> ResultData;
             TVector<bool> ResultHasData;
         };
+        struct TPartLaunch {
+            int CompId;
+            TInstant Time;
+        };
         struct TRemoteMapInfo {
             TVector<int> ResultMap;
             TIntrusivePtr<TJobRequest> JobRequest;
             int DstHost;
+            TVector<TPartLaunch> Launches; // query id of launch k is partId + k * partCount
         };
 
         TIntrusivePtr<TRemoteQueryProcessor> QueryProc;
@@ -220,7 +226,10 @@ namespace NPar {
         TVector<bool> PartCompleted;
         TVector<int> MapJob2PartId;
         TAtomic RemoteJobCount;
+        TAtomic AllPartsLaunched;
         int LocalPartId;
+        TVector<int> IdleComps; // finished their parts and got nothing else yet, no duplicates
+        TCompThroughputStats ThroughputStats;
 
         TLockFreeStack<TGUID> AllReqList;
         TQueryCancelCallback<TMRCommandExec> CancelCallback;
@@ -304,11 +313,13 @@ namespace NPar {
                         TVector<char> buf;
                         SerializeToMem(&buf, *jr);
                         const char* mrCmd = JobRequest->IsLowPriority ? "mr_low" : "mr";
+                        part->Launches.push_back({part->DstHost, TInstant::Now()});
                         TGUID req = QueryProc->SendQuery(part->DstHost, mrCmd, &buf, this, i);
                         RegisterRemoteQuery(req);
                     }
                 }
                 //Y_ASSERT(LocalPartId >= 0); // can happen
+                AtomicSet(AllPartsLaunched, 1); // parts may be relaunched from GotResponse() from now on
                 AtomicAdd(RemoteJobCount, -FAKE_REMOTE_JOB_COUNT);
                 DoneRemoteMapTask();
                 if (LocalPartId == -1)
@@ -371,11 +382,12 @@ namespace NPar {
                     Y_ASSERT(0 && "Notify ptr is lost");
             }
         }
+        // part goes to idle computer if some of them has the data
         void ReschedulePartRequest(int partId) {
             CHROMIUM_TRACE_FUNCTION();
             TRemoteMapInfo* part = &MapParts[partId];
 
-            PAR_DEBUG_LOG << "Try to reschedule part " << partId << Endl;
+            PAR_DEBUG_LOG << "Try to reschedule part " << partId << " from comp " << part->DstHost << Endl;
             TJobRequest* src = part->JobRequest.Get();
             QueryProc->IncLastCount(part->DstHost);
 
@@ -385,14 +397,58 @@ namespace NPar {
             if (!RescheduleJobRequest(src, JobRequest->ExecPlan, localCompId, ignoreCompId))
                 return;
 
-            int execCompId = SelectRandomHost(src->ExecPlan);
+            // prefer fastest idle computer which has the data
+            const TCompThroughputStats& stats = ThroughputStats;
+            int idlePlace = -1;
+            for (int i = 0; i < IdleComps.ysize(); ++i) {
+                int compId = IdleComps[i];
+                if (compId == ignoreCompId || !IsIn(src->ExecPlan, compId))
+                    continue;
+                if (idlePlace == -1 || stats.GetSecondsPerJob(compId) < stats.GetSecondsPerJob(IdleComps[idlePlace]))
+                    idlePlace = i;
+            }
+            int execCompId;
+            if (idlePlace != -1) {
+                execCompId = IdleComps[idlePlace];
+                IdleComps.erase(IdleComps.begin() + idlePlace);
+            } else {
+                execCompId = SelectRandomHost(src->ExecPlan);
+            }
             Y_ASSERT(execCompId != ignoreCompId && "ignoreCompId is supposed to be excluded from execution?");
 
             TVector<char> buf;
             SerializeToMem(&buf, *src);
-            TGUID req = QueryProc->SendQuery(execCompId, "mr_low", &buf, this, partId);
+            const int queryId = partId + part->Launches.ysize() * MapParts.ysize();
+            part->DstHost = execCompId;
+            part->Launches.push_back({execCompId, TInstant::Now()});
+            TGUID req = QueryProc->SendQuery(execCompId, "mr_low", &buf, this, queryId);
             RegisterRemoteQuery(req);
-            PAR_DEBUG_LOG << "Part " << partId << " reasked" << Endl;
+            PAR_DEBUG_LOG << "Part " << partId << " reasked at comp " << execCompId << Endl;
+        }
+        // launch copy of the slowest part if it straggles and there is idle computer to run it
+        void TrySpeculativeLaunch() {
+            if (IdleComps.empty() || !AtomicGet(AllPartsLaunched) || AtomicGet(MapResult) != nullptr)
+                return;
+            const TInstant now = TInstant::Now();
+            TVector<TPartLaunchState> parts(MapParts.ysize());
+            for (int i = 0; i < MapParts.ysize(); ++i) {
+                const TRemoteMapInfo& part = MapParts[i];
+                TPartLaunchState& state = parts[i];
+                state.Completed = i == LocalPartId || PartCompleted[i] || part.Launches.empty();
+                if (state.Completed) {
+                    continue;
+                }
+                state.CompId = part.Launches.back().CompId;
+                state.JobCount = part.JobRequest->Descr.ExecList.ysize();
+                state.LaunchCount = part.Launches.ysize();
+                state.Elapsed = (now - part.Launches.back().Time).SecondsFloat();
+            }
+            int partId = SelectSpeculativePart(parts, ThroughputStats);
+            if (partId >= 0) {
+                PAR_DEBUG_LOG << "Part " << partId << " straggles on comp " << parts[partId].CompId << " for " << parts[partId].Elapsed << "s" << Endl;
+                AtomicAdd(SpeculativeLaunches, 1);
+                ReschedulePartRequest(partId);
+            }
         }
         void CopyRemoteTaskResults(int partId, TVector<TVector<char>>* result) {
             if (PartCompleted[partId])
@@ -406,9 +462,18 @@ namespace NPar {
             }
             PartCompleted[partId] = true;
         }
-        void GotResponse(int id, TVector<char>* response) override {
+        void GotResponse(int queryId, TVector<char>* response) override {
             CHROMIUM_TRACE_FUNCTION();
 
+            const int id = queryId % MapParts.ysize();
+            const int launchId = queryId / MapParts.ysize();
+            if (launchId < MapParts[id].Launches.ysize()) {
+                // late duplicates are samples too, they tell how slow the host is
+                const TPartLaunch& launch = MapParts[id].Launches[launchId];
+                if (!IsIn(IdleComps, launch.CompId))
+                    IdleComps.push_back(launch.CompId);
+                ThroughputStats.AddSample(launch.CompId, MapParts[id].JobRequest->Descr.ExecList.ysize(), (TInstant::Now() - launch.Time).SecondsFloat());
+            }
             if (!NeedResult())
                 return;
             if (PartCompleted[id]) {
@@ -435,9 +500,16 @@ namespace NPar {
                 //Y_ASSERT(partId != -1); // possible since RemoteJobCount is modified from LaunchOps() in different thread
                 if (partId >= 0 && AtomicGet(MapResult) == nullptr)
                     ReschedulePartRequest(partId);
+            } else {
+                // finished comp is idle now, let it take over straggling part
+                TrySpeculativeLaunch();
             }
             DoneRemoteMapTask();
         }
+        void CheckRunningQueries() override {
+            if (NeedResult())
+                TrySpeculativeLaunch();
+        }
         void MRCommandComplete(bool isCanceled, TVector<TVector<char>>* res) override {
             if (isCanceled) {
                 Cancel();
@@ -558,6 +630,7 @@ namespace NPar {
             , RemoteMapReqCount(0)
             , UserContext(userContext)
             , RemoteJobCount(0)
+            , AllPartsLaunched(0)
             , LocalPartId(-1)
         {
             if (completeNotify->MRNeedCheckCancel())
@@ -574,7 +647,7 @@ namespace NPar {
         }
 
     public:
-        static TAtomic LocalMapWins, RemoteMapWins;
+        static TAtomic LocalMapWins, RemoteMapWins, SpeculativeLaunches;
 
         static void Launch(TJobRequest* jobRequest,
                            TRemoteQueryProcessor* queryProc,
@@ -0,0 +1,74 @@
+#include "par_host_stats.h"
+
+#include <util/generic/algorithm.h>
+
+namespace NPar {
+    static const double THROUGHPUT_EWMA_WEIGHT = 0.3;
+    static const double SPECULATION_SLOWDOWN = 2.0;
+    static const double TAIL_SPECULATION_SLOWDOWN = 1.25; // most computers are idle, copies are cheap
+    static const int TAIL_PART_FRACTION = 4;               // tail is when at most 1/4 of parts run
+    static const int MAX_PART_LAUNCHES = 3;
+
+    void TCompThroughputStats::AddSample(int compId, int jobCount, double seconds) {
+        if (compId < 0 || jobCount <= 0 || seconds <= 0) {
+            return;
+        }
+        const double secondsPerJob = seconds / jobCount;
+        with_lock (Lock) {
+            if (compId >= SecondsPerJob.ysize()) {
+                SecondsPerJob.resize(compId + 1, 0);
+            }
+            double& avg = SecondsPerJob[compId];
+            avg = avg == 0 ? secondsPerJob : avg + THROUGHPUT_EWMA_WEIGHT * (secondsPerJob - avg);
+        }
+    }
+
+    double TCompThroughputStats::GetSecondsPerJob(int compId) const {
+        with_lock (Lock) {
+            return compId >= 0 && compId < SecondsPerJob.ysize() ? SecondsPerJob[compId] : 0;
+        }
+    }
+
+    double TCompThroughputStats::GetMedianSecondsPerJob() const {
+        TVector<double> known;
+        with_lock (Lock) {
+            for (double x : SecondsPerJob) {
+                if (x > 0) {
+                    known.push_back(x);
+                }
+            }
+        }
+        if (known.empty()) {
+            return 0;
+        }
+        NthElement(known.begin(), known.begin() + known.size() / 2, known.end());
+        return known[known.size() / 2];
+    }
+
+    int SelectSpeculativePart(const TVector<TPartLaunchState>& parts, const TCompThroughputStats& stats) {
+        const double medianSecondsPerJob = stats.GetMedianSecondsPerJob();
+        if (medianSecondsPerJob == 0) {
+            return -1;
+        }
+        int runningCount = 0;
+        for (const TPartLaunchState& part : parts) {
+            runningCount += !part.Completed;
+        }
+        int res = -1;
+        double bestScore = runningCount * TAIL_PART_FRACTION <= parts.ysize() ? TAIL_SPECULATION_SLOWDOWN : SPECULATION_SLOWDOWN;
+        for (int i = 0; i < parts.ysize(); ++i) {
+            const TPartLaunchState& part = parts[i];
+            if (part.Completed || part.LaunchCount >= MAX_PART_LAUNCHES || part.JobCount == 0) {
+                continue;
+            }
+            const double expected = part.JobCount * medianSecondsPerJob;
+            const double slowness = Max(1.0, stats.GetSecondsPerJob(part.CompId) / medianSecondsPerJob);
+            const double score = part.Elapsed / expected * slowness;
+            if (score > bestScore) {
+                bestScore = score;
+                res = i;
+            }
+        }
+        return res;
+    }
+}
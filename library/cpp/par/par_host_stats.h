@@ -3,6 +3,8 @@
 #include <library/cpp/binsaver/bin_saver.h>
 
 #include <util/generic/singleton.h>
+#include <util/generic/vector.h>
+#include <util/system/spinlock.h>
 #include <util/system/types.h>
 #include <util/system/yassert.h>
 
@@ -108,4 +110,30 @@ namespace NPar {
             return *Singleton<TParHostStats>()->ParTimings.Timings[static_cast<size_t>(timingTag)];
         }
     };
+
+    // Map job throughput of computers as seen by the query sender, keeps moving average of seconds per job
+    // for each computer parts were sent to. Job costs differ between map functions, so every map query keeps
+    // its own stats.
+    class TCompThroughputStats {
+        mutable TAdaptiveLock Lock;
+        TVector<double> SecondsPerJob; // 0 if unknown
+
+    public:
+        void AddSample(int compId, int jobCount, double seconds);
+        double GetSecondsPerJob(int compId) const;
+        double GetMedianSecondsPerJob() const; // over computers with samples, 0 if none
+    };
+
+    struct TPartLaunchState {
+        int CompId = -1; // destination of the latest launch
+        int JobCount = 0;
+        int LaunchCount = 0;
+        double Elapsed = 0; // seconds since the latest launch
+        bool Completed = false;
+    };
+
+    // Part to launch a speculative copy of or -1. Expected part time is its job count times median seconds
+    // per job, part is a straggler if it runs SPECULATION_SLOWDOWN times longer (less when only a few parts
+    // are left). Parts on computers known to be slow are picked earlier in proportion to their slowness.
+    int SelectSpeculativePart(const TVector<TPartLaunchState>& parts, const TCompThroughputStats& stats);
 }
@@ -0,0 +1,157 @@
+#include <library/cpp/testing/unittest/registar.h>
+
+#include "par_host_stats.h"
+
+#include <util/generic/algorithm.h>
+#include <util/stream/output.h>
+
+using namespace NPar;
+
+namespace {
+    // Event driven model of one map command: part i is sent to comp i, comp finishes it in jobCount * compSpeed[comp].
+    // Like TMRCommandExec, on part completion and every checkInterval a straggling part is given to the fastest idle comp.
+    double SimulateMakespan(const TVector<double>& compSpeed, int jobCount, bool speculate, int* launchCount) {
+        const double checkInterval = 0.01;
+        TCompThroughputStats stats;
+        const int partCount = compSpeed.ysize();
+        struct TCopy {
+            int Part;
+            int Comp;
+            double Start;
+            double Finish;
+        };
+        TVector<TCopy> running;
+        TVector<TPartLaunchState> parts(partCount);
+        TVector<double> lastLaunch(partCount, 0);
+        for (int i = 0; i < partCount; ++i) {
+            running.push_back({i, i, 0, jobCount * compSpeed[i]});
+            parts[i].CompId = i;
+            parts[i].JobCount = jobCount;
+            parts[i].LaunchCount = 1;
+        }
+        TVector<int> idleComps;
+        int partsLeft = partCount;
+        double now = 0;
+        double nextCheck = checkInterval;
+        *launchCount = 0;
+        while (partsLeft > 0) {
+            auto first = MinElementBy(running, [](const TCopy& c) { return c.Finish; });
+            if (first->Finish <= nextCheck) {
+                const TCopy done = *first;
+                running.erase(first);
+                now = done.Finish;
+                stats.AddSample(done.Comp, jobCount, done.Finish - done.Start);
+                idleComps.push_back(done.Comp);
+                if (!parts[done.Part].Completed) {
+                    parts[done.Part].Completed = true;
+                    --partsLeft;
+                }
+            } else {
+                now = nextCheck;
+                nextCheck += checkInterval;
+            }
+            if (!speculate || idleComps.empty()) {
+                continue;
+            }
+            for (int i = 0; i < partCount; ++i) {
+                parts[i].Elapsed = now - lastLaunch[i];
+            }
+            const int partId = SelectSpeculativePart(parts, stats);
+            if (partId < 0) {
+                continue;
+            }
+            auto idle = MinElementBy(idleComps, [&](int comp) {
+                return comp == parts[partId].CompId ? 1e9 : stats.GetSecondsPerJob(comp);
+            });
+            const int comp = *idle;
+            idleComps.erase(idle);
+            ++*launchCount;
+            ++parts[partId].LaunchCount;
+            parts[partId].CompId = comp;
+            lastLaunch[partId] = now;
+            running.push_back({partId, comp, now, now + jobCount * compSpeed[comp]});
+        }
+        return now;
+    }
+}
+
+Y_UNIT_TEST_SUITE(TParHostStatsTest) {
+    Y_UNIT_TEST(TestThroughput) {
+        TCompThroughputStats stats;
+        UNIT_ASSERT_VALUES_EQUAL(stats.GetSecondsPerJob(3), 0);
+        UNIT_ASSERT_VALUES_EQUAL(stats.GetMedianSecondsPerJob(), 0);
+        stats.AddSample(3, 10, 1);
+        UNIT_ASSERT_DOUBLES_EQUAL(stats.GetSecondsPerJob(3), 0.1, 1e-9);
+        stats.AddSample(3, 10, 2);
+        UNIT_ASSERT(stats.GetSecondsPerJob(3) > 0.1 && stats.GetSecondsPerJob(3) < 0.2);
+        stats.AddSample(0, 1, 0.01);
+        stats.AddSample(1, 1, 0.02);
+        UNIT_ASSERT_DOUBLES_EQUAL(stats.GetMedianSecondsPerJob(), 0.02, 1e-9);
+        stats.AddSample(-1, 1, 1);
+        stats.AddSample(2, 0, 1);
+        UNIT_ASSERT_VALUES_EQUAL(stats.GetSecondsPerJob(2), 0);
+    }
+
+    Y_UNIT_TEST(TestSelectSpeculativePart) {
+        TCompThroughputStats stats;
+        TVector<TPartLaunchState> parts(3);
+        parts.resize(10); // completed ones, keep it out of tail mode
+        for (int i = 3; i < 10; ++i) {
+            parts[i].Completed = true;
+        }
+        for (int i = 0; i < 3; ++i) {
+            parts[i].CompId = i;
+            parts[i].JobCount = 10;
+            parts[i].LaunchCount = 1;
+            parts[i].Elapsed = 1.2;
+        }
+        UNIT_ASSERT_VALUES_EQUAL(SelectSpeculativePart(parts, stats), -1); // nothing known yet
+
+        stats.AddSample(0, 10, 1);
+        stats.AddSample(1, 10, 1);
+        UNIT_ASSERT_VALUES_EQUAL(SelectSpeculativePart(parts, stats), -1); // not slow enough
+        parts[2].Elapsed = 2.5;
+        UNIT_ASSERT_VALUES_EQUAL(SelectSpeculativePart(parts, stats), 2);
+        parts[2].Completed = true;
+        UNIT_ASSERT_VALUES_EQUAL(SelectSpeculativePart(parts, stats), -1);
+
+        // comp known to be 4x slower is taken over early
+        stats.AddSample(2, 10, 4);
+        stats.AddSample(3, 10, 1);
+        parts[2].Completed = false;
+        parts[2].Elapsed = 0.6;
+        UNIT_ASSERT_VALUES_EQUAL(SelectSpeculativePart(parts, stats), 2);
+        parts[2].LaunchCount = 3;
+        UNIT_ASSERT_VALUES_EQUAL(SelectSpeculativePart(parts, stats), -1);
+
+        // in the tail smaller slowdown is enough
+        parts[0].Completed = parts[1].Completed = true;
+        parts[2].LaunchCount = 1;
+        parts[2].CompId = 3;
+        parts[2].Elapsed = 1.3;
+        UNIT_ASSERT_VALUES_EQUAL(SelectSpeculativePart(parts, stats), 2);
+    }
+
+    Y_UNIT_TEST(TestSlowedWorker) {
+        for (double slowdown : {3.0, 10.0}) {
+            for (int slowCount : {1, 3}) {
+                TVector<double> compSpeed(16, 0.001);
+                for (int i = 0; i < slowCount; ++i) {
+                    compSpeed[5 + i] *= slowdown;
+                }
+                int plainLaunches = 0, launches = 0;
+                const double plain = SimulateMakespan(compSpeed, 100, false, &plainLaunches);
+                const double speculative = SimulateMakespan(compSpeed, 100, true, &launches);
+                Cerr << "16 comps, " << slowCount << " of them " << slowdown << "x slower: makespan " << plain << "s -> " << speculative << "s, "
+                     << launches << " speculative launches" << Endl;
+                UNIT_ASSERT(speculative < plain * 0.9);
+                UNIT_ASSERT(launches <= 2 * slowCount);
+            }
+        }
+
+        TVector<double> uniform(16, 0.001);
+        int launches = 0;
+        SimulateMakespan(uniform, 100, true, &launches);
+        UNIT_ASSERT_VALUES_EQUAL(launches, 0);
+    }
+}
@@ -27,6 +27,7 @@
 namespace NPar {
     class TNehRequester: public IRequester {
         static const int DefaultRetries = 40;
+        static const size_t CRC_FIELD_WIDTH = 10; // decimal ui32, zero padded
 
     public:
         struct TSentNetQueryInfo: public TThrRefBase {
@@ -125,9 +126,8 @@ namespace NPar {
                     req->SendError(NNeh::IRequest::BadRequest, errorString);
                     return;
                 }
-                Data.assign(req->Data().begin() + del3pos + 1, req->Data().end());
+                QuickLZDecompress(req->Data().substr(del3pos + 1), &Data);
             }
-            QuickLZDecompress(&Data);
             PAR_DEBUG_LOG << "At " << GetHostAndPort() << " got request " << GetGuidAsString(reqId) << " service: " << Url << " data len: " << Data.size() << Endl;
             NNeh::TData ok = {'O', 'K'};
             req->SendReply(ok);
@@ -306,12 +306,21 @@ namespace NPar {
             messageStream << GetGuidAsString(requestId) << '\xff';
             messageStream << url << '\xff';
             if (data) {
+                // data is packed straight into the message, crc is patched into fixed width field afterwards
                 const size_t origLen = data->size();
-                QuickLZCompress(data);
-                const size_t compressedLen = data->size();
-                auto val = Crc32c(data->data(), data->size());
-                messageStream << val << '\xff';
-                msg.Data.AppendNoAlias(data->data(), data->size());
+                const TStringBuf src(data->data(), data->size());
+                const size_t crcPos = msg.Data.size();
+                messageStream << TString(CRC_FIELD_WIDTH, '0') << '\xff';
+                const size_t dataPos = msg.Data.size();
+                msg.Data.reserve(dataPos + QuickLZMaxPackedSize(src));
+                ui32 val = 0;
+                QuickLZCompress(src, [&](TStringBuf piece) {
+                    val = Crc32cExtend(val, piece.data(), piece.size());
+                    msg.Data.AppendNoAlias(piece.data(), piece.size());
+                });
+                const size_t compressedLen = msg.Data.size() - dataPos;
+                const TString crc = ToString(val);
+                msg.Data.replace(crcPos + CRC_FIELD_WIDTH - crc.size(), crc.size(), crc);
 
                 TVector<char>().swap(*data);
                 PAR_DEBUG_LOG << "From " << GetHostAndPort() << " sending request " << GetGuidAsString(requestId) << " to " << address.GetNehAddr() << " service " << url << " data len: " << origLen << " (compressed: " << compressedLen << ")" << Endl;
@@ -7,6 +7,7 @@
 #include <library/cpp/binsaver/util_stream_io.h>
 #include <library/cpp/chromium_trace/interface.h>
 
+#include <util/generic/hash_set.h>
 #include <util/random/random.h>
 #include <util/system/atomic.h>
 #include <util/system/atomic_ops.h>
@@ -19,6 +20,7 @@
 namespace NPar {
     const char* DELAY_MATRIX_NAME = "delay_matrix.bin";
     const float PING_ITERATION_TIME = 30;
+    const TDuration RunningQueriesCheckInterval = TDuration::MilliSeconds(100);
 
     struct TDelayData {
         TArray2D<TVector<float>> DelayMatrixData;
@@ -463,6 +465,7 @@ namespace NPar {
     }
 
     void TRemoteQueryProcessor::MetaThreadFunction() {
+        TInstant lastRunningQueriesCheck = TInstant::Now();
         while (DoRun) {
             TNetworkEvent netEvent;
             while (NetworkEventsQueue.Dequeue(&netEvent)) {
@@ -507,7 +510,24 @@ namespace NPar {
             if (!NetworkEventsQueue.IsEmpty()) {
                 continue;
             }
-            NetworkEvent.WaitT(TDuration::MilliSeconds(500));
+            if (TInstant::Now() - lastRunningQueriesCheck >= RunningQueriesCheckInterval) {
+                CheckRunningQueries();
+                lastRunningQueriesCheck = TInstant::Now();
+            }
+            NetworkEvent.WaitT(RunningQueriesCheckInterval);
+        }
+    }
+
+    void TRemoteQueryProcessor::CheckRunningQueries() {
+        THashSet<IRemoteQueryResponseNotify*> procs;
+        TVector<TIntrusivePtr<IRemoteQueryResponseNotify>> procsToCheck;
+        RequestsData.LockedIterateValues([&](const TGUID&, TIntrusivePtr<TQueryResultDst>& dst) {
+            if (dst->Proc && procs.insert(dst->Proc.Get()).second) {
+                procsToCheck.push_back(dst->Proc);
+            }
+        });
+        for (auto& proc : procsToCheck) {
+            proc->CheckRunningQueries();
         }
     }
 }
@@ -53,6 +53,9 @@ namespace NPar {
     struct IRemoteQueryResponseNotify : virtual public TThrRefBase {
         // calls of this function are guaranteed to come from single thread
         virtual void GotResponse(int id, TVector<char>* response) = 0;
+        // called periodically from the same thread while some of the queries are not answered
+        virtual void CheckRunningQueries() {
+        }
     };
 
     struct IRemoteQueryCancelNotify: public TThrRefBase {
@@ -164,6 +167,8 @@ namespace NPar {
         void ReplyCallback(TAutoPtr<TNetworkResponse> response);
         void ReplyCallbackImpl(TAutoPtr<TNetworkResponse> response);
 
+        void CheckRunningQueries();
+
     public:
         TRemoteQueryProcessor();
         ~TRemoteQueryProcessor() override;
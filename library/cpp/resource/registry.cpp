@@ -3,10 +3,16 @@
 #include <library/cpp/blockcodecs/codecs.h>
 
 #include <util/system/yassert.h>
+#include <util/generic/algorithm.h>
 #include <util/generic/hash.h>
 #include <util/generic/deque.h>
 #include <util/generic/singleton.h>
 #include <util/system/env.h>
+#include <util/system/guard.h>
+#include <util/system/spinlock.h>
+#include <util/system/unaligned_mem.h>
+
+#include <mutex>
 
 using namespace NResource;
 using namespace NBlockCodecs;
@@ -18,15 +24,85 @@ namespace {
         return ret;
     }
 
-    typedef std::pair<TStringBuf, TStringBuf> TDescriptor;
+    /*
+     * Stored data is either codec output, which starts with ui64 data length,
+     * or the same length with RawFlag set followed by data as is.
+     */
+    static constexpr ui64 RawFlag = 1ull << 63;
+
+    // small resources do not compress well and are not worth decompressing
+    static constexpr size_t UncompressedSizeThreshold = 1024;
+
+    static inline bool IsRaw(const TStringBuf data) noexcept {
+        return data.size() >= sizeof(ui64) && (ReadUnaligned<ui64>(data.data()) & RawFlag);
+    }
+
+    static inline TStringBuf RawData(const TStringBuf data) {
+        Y_ENSURE(data.size() - sizeof(ui64) == (ReadUnaligned<ui64>(data.data()) & ~RawFlag), "malformed raw resource");
+
+        return data.SubStr(sizeof(ui64));
+    }
+
+    static inline size_t DataLength(const TStringBuf data) {
+        return IsRaw(data) ? RawData(data).size() : GetCodec()->DecompressedLength(data);
+    }
+
+    static inline TString StoreRaw(const TStringBuf data) {
+        TString ret;
+        ret.ReserveAndResize(sizeof(ui64) + data.size());
+        WriteUnaligned<ui64>(ret.begin(), RawFlag | data.size());
+        memcpy(ret.begin() + sizeof(ui64), data.data(), data.size());
+
+        return ret;
+    }
+
+    struct TDescriptor {
+        inline TDescriptor(const TStringBuf key, const TStringBuf data)
+            : Key(key)
+            , Data(data)
+        {
+        }
+
+        // raw data is referenced in place, compressed one is decompressed once on first use
+        inline TStringBuf Ref() const {
+            if (IsRaw(Data)) {
+                return RawData(Data);
+            }
+
+            std::call_once(Once, [this]() {
+                Unpacked = Decompress(Data);
+            });
+
+            return Unpacked;
+        }
+
+        TStringBuf Key;
+        TStringBuf Data;
+        mutable std::once_flag Once;
+        mutable TString Unpacked;
+    };
+
+    template <class F>
+    static inline auto WithDiag(const TStringBuf key, F&& f) {
+        // temporary
+        // https://st.yandex-team.ru/DEVTOOLS-3985
+        try {
+            return f();
+        } catch (const yexception& e) {
+            if (GetEnv("RESOURCE_DECOMPRESS_DIAG")) {
+                Cerr << "Can't decompress resource " << key << Endl << e.what() << Endl;
+            }
+            throw e;
+        }
+    }
 
     struct TStore: public IStore, public THashMap<TStringBuf, TDescriptor*> {
         void Store(const TStringBuf key, const TStringBuf data) override {
             if (contains(key)) {
-                const TStringBuf value = (*this)[key]->second;
+                const TStringBuf value = (*this)[key]->Data;
                 if (value != data) {
-                    size_t vsize = GetCodec()->DecompressedLength(value);
-                    size_t dsize = GetCodec()->DecompressedLength(data);
+                    size_t vsize = DataLength(value);
+                    size_t dsize = DataLength(data);
                     if (vsize + dsize < 1000) {
                         Y_VERIFY(false, "Redefinition of key %s:\n"
                                  "  old value: %s,\n"
@@ -42,7 +118,7 @@ namespace {
                     }
                 }
             } else {
-                D_.push_back(TDescriptor(key, data));
+                D_.emplace_back(key, data);
                 (*this)[key] = &D_.back();
             }
 
@@ -51,16 +127,21 @@ namespace {
 
         bool FindExact(const TStringBuf key, TString* out) const override {
             if (TDescriptor* const* res = FindPtr(key)) {
-                // temporary
-                // https://st.yandex-team.ru/DEVTOOLS-3985
-                try {
-                    *out = Decompress((*res)->second);
-                } catch (const yexception& e) {
-                    if (GetEnv("RESOURCE_DECOMPRESS_DIAG")) {
-                        Cerr << "Can't decompress resource " << key << Endl << e.what() << Endl;
-                    }
-                    throw e;
-                }
+                *out = WithDiag(key, [res]() {
+                    return Decompress((*res)->Data);
+                });
+
+                return true;
+            }
+
+            return false;
+        }
+
+        bool FindExactRef(const TStringBuf key, TStringBuf* out) const override {
+            if (TDescriptor* const* res = FindPtr(key)) {
+                *out = WithDiag(key, [res]() {
+                    return (*res)->Ref();
+                });
 
                 return true;
             }
@@ -69,21 +150,34 @@ namespace {
         }
 
         void FindMatch(const TStringBuf subkey, IMatch& cb) const override {
-            for (const auto& it : *this) {
-                if (it.first.StartsWith(subkey)) {
-                    // temporary
-                    // https://st.yandex-team.ru/DEVTOOLS-3985
-                    try {
-                        const TResource res = {
-                            it.first, Decompress(it.second->second)};
-                        cb.OnMatch(res);
-                    } catch (const yexception& e) {
-                        if (GetEnv("RESOURCE_DECOMPRESS_DIAG")) {
-                            Cerr << "Can't decompress resource " << it.first << Endl << e.what() << Endl;
-                        }
-                        throw e;
+            TVector<const TDescriptor*> matches;
+
+            with_lock (IndexLock_) {
+                // resources are registered during static initialization, so the index is built once
+                if (Index_.size() != D_.size()) {
+                    Index_.clear();
+                    for (const auto& d : D_) {
+                        Index_.push_back(&d);
                     }
+                    Sort(Index_, [](const TDescriptor* l, const TDescriptor* r) {
+                        return l->Key < r->Key;
+                    });
                 }
+
+                auto it = LowerBound(Index_.begin(), Index_.end(), subkey, [](const TDescriptor* d, const TStringBuf k) {
+                    return d->Key < k;
+                });
+                for (; it != Index_.end() && (*it)->Key.StartsWith(subkey); ++it) {
+                    matches.push_back(*it);
+                }
+            }
+
+            for (const TDescriptor* d : matches) {
+                const TResource res = {
+                    d->Key, WithDiag(d->Key, [d]() {
+                        return Decompress(d->Data);
+                    })};
+                cb.OnMatch(res);
             }
         }
 
@@ -92,19 +186,36 @@ namespace {
         }
 
         TStringBuf KeyByIndex(size_t idx) const override {
-            return D_.at(idx).first;
+            return D_.at(idx).Key;
         }
 
         typedef TDeque<TDescriptor> TDescriptors;
         TDescriptors D_;
+        mutable TAdaptiveLock IndexLock_;
+        mutable TVector<const TDescriptor*> Index_;
     };
 }
 
 TString NResource::Compress(const TStringBuf data) {
-    return GetCodec()->Encode(data);
+    if (data.size() < UncompressedSizeThreshold) {
+        return StoreRaw(data);
+    }
+
+    TString compressed = GetCodec()->Encode(data);
+
+    // incompressible data is kept as is
+    if (compressed.size() >= data.size()) {
+        return StoreRaw(data);
+    }
+
+    return compressed;
 }
 
 TString NResource::Decompress(const TStringBuf data) {
+    if (IsRaw(data)) {
+        return TString(RawData(data));
+    }
+
     return GetCodec()->Decode(data);
 }
 
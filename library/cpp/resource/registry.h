@@ -6,6 +6,7 @@
 #include "resource.h"
 
 namespace NResource {
+    // data smaller than 1Kb or not compressible is stored as is, so it can be referenced without copying
     TString Compress(const TStringBuf data);
     TString Decompress(const TStringBuf data);
 
@@ -18,6 +19,7 @@ namespace NResource {
     public:
         virtual void Store(const TStringBuf key, const TStringBuf data) = 0;
         virtual bool FindExact(const TStringBuf key, TString* out) const = 0;
+        virtual bool FindExactRef(const TStringBuf key, TStringBuf* out) const = 0;
         virtual void FindMatch(const TStringBuf subkey, IMatch& cb) const = 0;
         virtual size_t Count() const noexcept = 0;
         virtual TStringBuf KeyByIndex(size_t idx) const = 0;
@@ -11,6 +11,10 @@ bool NResource::FindExact(const TStringBuf key, TString* out) {
     return CommonStore()->FindExact(key, out);
 }
 
+bool NResource::FindExactRef(const TStringBuf key, TStringBuf* out) {
+    return CommonStore()->FindExactRef(key, out);
+}
+
 void NResource::FindMatch(const TStringBuf subkey, TResources* out) {
     struct TMatch: public IMatch {
         inline TMatch(TResources* r)
@@ -40,6 +44,22 @@ TString NResource::Find(const TStringBuf key) {
     ythrow yexception() << "can not find resource with path " << key;
 }
 
+TStringBuf NResource::FindRef(const TStringBuf key) {
+    TStringBuf ret;
+
+    if (FindExactRef(key, &ret)) {
+        return ret;
+    }
+
+    ythrow yexception() << "can not find resource with path " << key;
+}
+
+TBlob NResource::FindBlob(const TStringBuf key) {
+    const TStringBuf data = FindRef(key);
+
+    return TBlob::NoCopy(data.data(), data.size());
+}
+
 size_t NResource::Count() noexcept {
     return CommonStore()->Count();
 }
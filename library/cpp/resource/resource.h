@@ -3,6 +3,7 @@
 #include <util/generic/string.h>
 #include <util/generic/strbuf.h>
 #include <util/generic/vector.h>
+#include <util/memory/blob.h>
 
 namespace NResource {
     struct TResource {
@@ -14,7 +15,12 @@ namespace NResource {
 
     TString Find(const TStringBuf key);
     bool FindExact(const TStringBuf key, TString* out);
-    //perform full scan for now
+    // data is decompressed at most once (lazily, thread-safe) and kept till program exit,
+    // small resources are referenced in place
+    TStringBuf FindRef(const TStringBuf key);
+    bool FindExactRef(const TStringBuf key, TStringBuf* out);
+    TBlob FindBlob(const TStringBuf key);
+    //binary search in sorted keys
     void FindMatch(const TStringBuf subkey, TResources* out);
     size_t Count() noexcept;
     TStringBuf KeyByIndex(size_t idx);
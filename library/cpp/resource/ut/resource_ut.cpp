@@ -1,8 +1,65 @@
+#include <library/cpp/resource/registry.h>
 #include <library/cpp/resource/resource.h>
 #include <library/cpp/testing/unittest/registar.h>
 
+#include <util/generic/deque.h>
+
 Y_UNIT_TEST_SUITE(TestResource) {
     Y_UNIT_TEST(Test1) {
         UNIT_ASSERT_VALUES_EQUAL(NResource::Find("/x"), "na gorshke sidel korol\n");
     }
+
+    Y_UNIT_TEST(TestCompress) {
+        for (size_t size : {0, 10, 1023, 1024, 100000}) {
+            TString data;
+            for (size_t i = 0; i < size; ++i) {
+                data.push_back('a' + i % 3);
+            }
+            const TString stored = NResource::Compress(data);
+            UNIT_ASSERT_VALUES_EQUAL(NResource::Decompress(stored), data);
+            if (size < 1024) {
+                UNIT_ASSERT(stored.EndsWith(data));
+            } else {
+                UNIT_ASSERT(stored.size() < size / 10);
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestRef) {
+        // small resources are referenced in place
+        const TStringBuf x = NResource::FindRef("/x");
+        UNIT_ASSERT_VALUES_EQUAL(x, "na gorshke sidel korol\n");
+        UNIT_ASSERT_EQUAL(NResource::FindRef("/x").data(), x.data());
+
+        const TString big(100000, 'z');
+        static const TString packed = NResource::Compress(big);
+        NResource::TRegHelper reg("/test/big", packed);
+        const TStringBuf ref = NResource::FindRef("/test/big");
+        UNIT_ASSERT_VALUES_EQUAL(ref, big);
+        UNIT_ASSERT_EQUAL(NResource::FindRef("/test/big").data(), ref.data());
+        UNIT_ASSERT_EQUAL(NResource::FindBlob("/test/big").Data(), ref.data());
+
+        TStringBuf missing;
+        UNIT_ASSERT(!NResource::FindExactRef("/test/missing", &missing));
+        UNIT_ASSERT_EXCEPTION(NResource::FindRef("/test/missing"), yexception);
+    }
+
+    Y_UNIT_TEST(TestFindMatch) {
+        static TDeque<TString> stored;
+        for (const TStringBuf key : {"/match/b", "/match/a", "/matc", "/match/c/d", "/matching"}) {
+            stored.push_back(NResource::Compress(TString("data") + key));
+            NResource::TRegHelper reg(key, stored.back());
+        }
+
+        NResource::TResources found;
+        NResource::FindMatch("/match/", &found);
+        UNIT_ASSERT_VALUES_EQUAL(found.size(), 3);
+        UNIT_ASSERT_VALUES_EQUAL(found[0].Key, "/match/a");
+        UNIT_ASSERT_VALUES_EQUAL(found[0].Data, "data/match/a");
+        UNIT_ASSERT_VALUES_EQUAL(found[2].Key, "/match/c/d");
+
+        found.clear();
+        NResource::FindMatch("/matc", &found);
+        UNIT_ASSERT_VALUES_EQUAL(found.size(), 5);
+    }
 }
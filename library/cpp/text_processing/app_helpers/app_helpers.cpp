@@ -5,6 +5,7 @@
 #include <library/cpp/text_processing/dictionary/options.h>
 #include <library/cpp/text_processing/tokenizer/tokenizer.h>
 #include <library/cpp/containers/flat_hash/flat_hash.h>
+#include <library/cpp/threading/local_executor/local_executor.h>
 
 #include <util/generic/xrange.h>
 #include <util/string/join.h>
@@ -26,6 +27,7 @@ using NTextProcessing::NDictionary::TBpeDictionaryBuilder;
 using NTextProcessing::NDictionary::TDictionaryBuilder;
 using NTextProcessing::NDictionary::TDictionaryBuilderOptions;
 using NTextProcessing::NDictionary::TDictionaryOptions;
+using NTextProcessing::NDictionary::TParallelDictionaryBuilder;
 using NTextProcessing::NDictionary::TDictionary;
 using NTextProcessing::NDictionary::TTokenId;
 using NTextProcessing::NTokenizer::ETokenType;
@@ -33,17 +35,40 @@ using NTextProcessing::NTokenizer::TTokenizer;
 using NTextProcessing::NTokenizer::TTokenizerOptions;
 
 constexpr double REPORT_PROGRESS_INTERVAL_SECONDS = 1.0;
+constexpr size_t LINES_BATCH_SIZE = 1 << 14;
 
+// lines are read by batches, every batch is tokenized in parallel on localExecutor (if it is not nullptr)
 template <typename TVisitor>
-static void ApplyFuncTotokenizedText(
+static void ApplyFuncToTokenizedTextBatches(
     const TString& inputPath,
     const TTokenizerOptions& tokenizerOptions,
     bool useTokenizer,
     bool verbose,
+    NPar::ILocalExecutor* localExecutor,
     const TVisitor& visitor
 ) {
     TTokenizer tokenizer(tokenizerOptions);
-    TVector<TString> tokens;
+    TVector<TString> lines;
+    TVector<TVector<TString>> sentences;
+    const auto flushBatch = [&]() {
+        sentences.resize(lines.size());
+        const auto tokenize = [&](int lineId) {
+            if (useTokenizer) {
+                tokenizer.Tokenize(lines[lineId], &sentences[lineId]);
+            } else {
+                sentences[lineId] = {lines[lineId]};
+            }
+        };
+        if (localExecutor) {
+            NPar::ParallelFor(*localExecutor, 0, lines.size(), tokenize);
+        } else {
+            for (size_t lineId : xrange(lines.size())) {
+                tokenize(lineId);
+            }
+        }
+        visitor(TConstArrayRef<TVector<TString>>(sentences));
+        lines.clear();
+    };
 
 
     ui32 dataSize = 0;
@@ -58,12 +83,11 @@ static void ApplyFuncTotokenizedText(
     THPTimer watch;
     double lastReportProgressTime = watch.Passed();
     while (countingInput.ReadLine(line)) {
-        if (useTokenizer) {
-            tokenizer.Tokenize(line, &tokens);
-            visitor(tokens);
-        } else {
-            visitor({line});
+        lines.push_back(std::move(line));
+        if (lines.size() < LINES_BATCH_SIZE) {
+            continue;
         }
+        flushBatch();
 
         if (verbose) {
             const double passedTime = watch.Passed();
@@ -78,28 +102,54 @@ static void ApplyFuncTotokenizedText(
         }
     }
 
+    flushBatch();
+
     const double passedTime = watch.Passed();
     if (verbose) {
         Cerr << "Time passed: " << HumanReadable(TDuration::Seconds(passedTime)) << "\n";
     }
 }
 
+template <typename TVisitor>
+static void ApplyFuncTotokenizedText(
+    const TString& inputPath,
+    const TTokenizerOptions& tokenizerOptions,
+    bool useTokenizer,
+    bool verbose,
+    const TVisitor& visitor
+) {
+    ApplyFuncToTokenizedTextBatches(
+        inputPath,
+        tokenizerOptions,
+        useTokenizer,
+        verbose,
+        /*localExecutor*/ nullptr,
+        [&](TConstArrayRef<TVector<TString>> sentences) {
+            for (const auto& tokens : sentences) {
+                visitor(tokens);
+            }
+        }
+    );
+}
+
 TIntrusivePtr<TDictionary> NTextProcessing::NDictionary::BuildDictionary(
     const TString& inputFilePath,
     const TDictionaryBuilderOptions& dictionaryBuilderOptions,
     const TDictionaryOptions& dictionaryOptions,
     const TTokenizerOptions& tokenizerOptions,
     bool useTokenizer,
-    bool verbose
+    bool verbose,
+    NPar::ILocalExecutor* localExecutor
 ) {
-    TDictionaryBuilder dictionaryBuilder(dictionaryBuilderOptions, dictionaryOptions);
-    ApplyFuncTotokenizedText(
+    TParallelDictionaryBuilder dictionaryBuilder(dictionaryBuilderOptions, dictionaryOptions, localExecutor);
+    ApplyFuncToTokenizedTextBatches(
         inputFilePath,
         tokenizerOptions,
         useTokenizer,
         verbose,
-        [&](const TVector<TString>& tokens) {
-            dictionaryBuilder.Add(tokens, /*weight*/1);
+        localExecutor,
+        [&](TConstArrayRef<TVector<TString>> sentences) {
+            dictionaryBuilder.Add(sentences, /*weight*/1);
         }
     );
     return dictionaryBuilder.FinishBuilding();
@@ -112,7 +162,8 @@ static TIntrusivePtr<TBpeDictionary> BuildBpeWord(
     const TString& inputFilePath,
     const TTokenizerOptions& tokenizerOptions,
     bool useTokenizer,
-    bool verbose
+    bool verbose,
+    NPar::ILocalExecutor* localExecutor
 ) {
     if (verbose) {
         Cerr << "Stage [1/2]: Dictionary building\n";
@@ -124,7 +175,8 @@ static TIntrusivePtr<TBpeDictionary> BuildBpeWord(
         dictionaryOptions,
         tokenizerOptions,
         useTokenizer,
-        verbose
+        verbose,
+        localExecutor
     );
 
     TBpeDictionaryBuilder bpeBuilder(bpeOptions.NumUnits, bpeOptions.SkipUnknown, dictionary);
@@ -133,13 +185,14 @@ static TIntrusivePtr<TBpeDictionary> BuildBpeWord(
         Cerr << "Stage [2/2]: Bpe building\n";
     }
 
-    ApplyFuncTotokenizedText(
+    ApplyFuncToTokenizedTextBatches(
         inputFilePath,
         tokenizerOptions,
         useTokenizer,
         verbose,
-        [&](const TVector<TString>& tokens) {
-            bpeBuilder.Add(tokens, /*weight*/1);
+        localExecutor,
+        [&](TConstArrayRef<TVector<TString>> sentences) {
+            bpeBuilder.Add(sentences, localExecutor, /*weight*/1);
         }
     );
 
@@ -153,24 +206,28 @@ static TIntrusivePtr<TBpeDictionary> BuildBpeLetter(
     const TString& inputFilePath,
     const TTokenizerOptions& tokenizerOptions,
     bool useTokenizer,
-    bool verbose
+    bool verbose,
+    NPar::ILocalExecutor* localExecutor
 ) {
     if (verbose) {
         Cerr << "Stage [1/2]: Dictionary building\n";
     }
 
     NFH::TFlatHashMap<TString, ui64> tokenCounts;
-    TDictionaryBuilder dictionaryBuilder(dictionaryBuilderOptions, dictionaryOptions);
+    TParallelDictionaryBuilder dictionaryBuilder(dictionaryBuilderOptions, dictionaryOptions, localExecutor);
 
-    ApplyFuncTotokenizedText(
+    ApplyFuncToTokenizedTextBatches(
         inputFilePath,
         tokenizerOptions,
         useTokenizer,
         verbose,
-        [&](const TVector<TString>& tokens) {
-            dictionaryBuilder.Add(tokens, /*weight*/1);
-            for (const auto& token : tokens) {
-                ++tokenCounts[token];
+        localExecutor,
+        [&](TConstArrayRef<TVector<TString>> sentences) {
+            dictionaryBuilder.Add(sentences, /*weight*/1);
+            for (const auto& tokens : sentences) {
+                for (const auto& token : tokens) {
+                    ++tokenCounts[token];
+                }
             }
         }
     );
@@ -200,7 +257,8 @@ TIntrusivePtr<TBpeDictionary> NTextProcessing::NDictionary::BuildBpe(
     const TBpeDictionaryOptions& bpeOptions,
     const TTokenizerOptions& tokenizerOptions,
     bool useTokenizer,
-    bool verbose
+    bool verbose,
+    NPar::ILocalExecutor* localExecutor
 ) {
     if (dictionaryOptions.TokenLevelType == ETokenLevelType::Word || bpeOptions.ContextLevel == EContextLevel::Sentence) {
         return BuildBpeWord(
@@ -210,7 +268,8 @@ TIntrusivePtr<TBpeDictionary> NTextProcessing::NDictionary::BuildBpe(
             inputFilePath,
             tokenizerOptions,
             useTokenizer,
-            verbose
+            verbose,
+            localExecutor
         );
     } else {
         Y_ASSERT(dictionaryOptions.TokenLevelType == ETokenLevelType::Letter);
@@ -221,7 +280,8 @@ TIntrusivePtr<TBpeDictionary> NTextProcessing::NDictionary::BuildBpe(
             inputFilePath,
             tokenizerOptions,
             useTokenizer,
-            verbose
+            verbose,
+            localExecutor
         );
     }
 }
@@ -3,15 +3,21 @@
 #include <library/cpp/text_processing/dictionary/bpe_dictionary.h>
 #include <library/cpp/text_processing/tokenizer/options.h>
 
+namespace NPar {
+    class ILocalExecutor;
+}
+
 namespace NTextProcessing::NDictionary {
 
+    // lines are tokenized and counted in parallel on localExecutor if it is not nullptr
     TIntrusivePtr<TDictionary> BuildDictionary(
         const TString& inputFilePath,
         const TDictionaryBuilderOptions& dictionaryBuilderOptions,
         const TDictionaryOptions& dictionaryOptions,
         const NTokenizer::TTokenizerOptions& tokenizerOptions,
         bool useTokenizer,
-        bool verbose
+        bool verbose,
+        NPar::ILocalExecutor* localExecutor = nullptr
     );
 
     TIntrusivePtr<TBpeDictionary> BuildBpe(
@@ -21,7 +27,8 @@ namespace NTextProcessing::NDictionary {
         const TBpeDictionaryOptions& bpeOptions,
         const NTokenizer::TTokenizerOptions& tokenizerOptions,
         bool useTokenizer,
-        bool verbose
+        bool verbose,
+        NPar::ILocalExecutor* localExecutor = nullptr
     );
 
     void ApplyDictionaryToFile(
@@ -0,0 +1,315 @@
+#include <library/cpp/testing/benchmark/bench.h>
+#include <library/cpp/text_processing/dictionary/bpe_builder.h>
+#include <library/cpp/text_processing/dictionary/dictionary_builder.h>
+#include <library/cpp/text_processing/dictionary/mmap_frequency_based_dictionary.h>
+#include <library/cpp/text_processing/dictionary/mmap_perfect_hash_dictionary.h>
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/hash_set.h>
+#include <util/generic/singleton.h>
+#include <util/generic/vector.h>
+#include <util/memory/blob.h>
+#include <util/random/fast.h>
+#include <util/random/shuffle.h>
+#include <util/stream/file.h>
+#include <util/stream/length.h>
+#include <util/stream/null.h>
+#include <util/stream/output.h>
+#include <util/string/cast.h>
+#include <util/string/strip.h>
+#include <util/system/tempfile.h>
+
+#if defined(_linux_)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace NTextProcessing::NDictionary;
+
+// End-to-end dictionary and BPE building on a synthetic corpus: 10^5 sentences of 1..20 words drawn from
+// a Zipf distribution over 10^5 words. Sizes of the built dictionaries are printed once per benchmark.
+namespace {
+    constexpr ui32 WordCount = 100000;
+    constexpr size_t SentenceCount = 100000;
+    constexpr ui32 BpeUnitCount = 5000;
+    constexpr double MaxCountError = 1e-5;
+
+    struct TCorpus {
+        TVector<TVector<TString>> Sentences;
+
+        TCorpus()
+            : Sentences(SentenceCount)
+        {
+            TVector<double> cumulativeWeights(WordCount);
+            double sum = 0;
+            for (ui32 i = 0; i < WordCount; ++i) {
+                sum += 1.0 / (i + 1);
+                cumulativeWeights[i] = sum;
+            }
+
+            TFastRng<ui64> rng(0);
+            for (auto& sentence : Sentences) {
+                sentence.resize(1 + rng.Uniform(20));
+                for (auto& word : sentence) {
+                    const double point = rng.GenRandReal1() * sum;
+                    word = "w" + ToString(LowerBound(cumulativeWeights.begin(), cumulativeWeights.end(), point) - cumulativeWeights.begin());
+                }
+            }
+        }
+    };
+
+    struct TExecutors {
+        NPar::TLocalExecutor Threads4;
+        NPar::TLocalExecutor Threads16;
+
+        TExecutors() {
+            Threads4.RunAdditionalThreads(3);
+            Threads16.RunAdditionalThreads(15);
+        }
+    };
+
+    TDictionaryOptions GetDictionaryOptions(ui32 gramOrder) {
+        TDictionaryOptions dictionaryOptions;
+        dictionaryOptions.TokenLevelType = ETokenLevelType::Word;
+        dictionaryOptions.GramOrder = gramOrder;
+        return dictionaryOptions;
+    }
+
+    TDictionaryBuilderOptions GetDictionaryBuilderOptions() {
+        TDictionaryBuilderOptions dictionaryBuilderOptions;
+        dictionaryBuilderOptions.OccurrenceLowerBound = 3;
+        return dictionaryBuilderOptions;
+    }
+
+    void PrintSize(const char* name, ui32 size) {
+        static THashSet<TString> printed;
+        if (printed.insert(name).second) {
+            Cerr << name << ": dictionary size " << size << Endl;
+        }
+    }
+
+    void RunSequential(const char* name, ui32 gramOrder, const NBench::NCpu::TParams& iface) {
+        const auto& sentences = Singleton<TCorpus>()->Sentences;
+        for (size_t i = 0; i < iface.Iterations(); ++i) {
+            TDictionaryBuilder dictionaryBuilder(GetDictionaryBuilderOptions(), GetDictionaryOptions(gramOrder));
+            for (const auto& sentence : sentences) {
+                dictionaryBuilder.Add(sentence);
+            }
+            PrintSize(name, dictionaryBuilder.FinishBuilding()->Size());
+        }
+    }
+
+    void RunParallel(
+        const char* name,
+        ui32 gramOrder,
+        double maxCountError,
+        NPar::ILocalExecutor* localExecutor,
+        const NBench::NCpu::TParams& iface
+    ) {
+        const auto& sentences = Singleton<TCorpus>()->Sentences;
+        for (size_t i = 0; i < iface.Iterations(); ++i) {
+            TParallelDictionaryBuilder dictionaryBuilder(
+                GetDictionaryBuilderOptions(),
+                GetDictionaryOptions(gramOrder),
+                localExecutor,
+                maxCountError);
+            dictionaryBuilder.Add(sentences);
+            PrintSize(name, dictionaryBuilder.FinishBuilding()->Size());
+        }
+    }
+
+    // localExecutor == nullptr means that sentences are added to the BPE builder one by one
+    void RunBpe(const char* name, NPar::ILocalExecutor* localExecutor, const NBench::NCpu::TParams& iface) {
+        const auto& sentences = Singleton<TCorpus>()->Sentences;
+        for (size_t i = 0; i < iface.Iterations(); ++i) {
+            TParallelDictionaryBuilder dictionaryBuilder(GetDictionaryBuilderOptions(), GetDictionaryOptions(1), localExecutor);
+            dictionaryBuilder.Add(sentences);
+            TBpeDictionaryBuilder bpeBuilder(BpeUnitCount, /*skipUnknown*/ true, dictionaryBuilder.FinishBuilding());
+            if (localExecutor) {
+                bpeBuilder.Add(sentences, localExecutor);
+            } else {
+                for (const auto& sentence : sentences) {
+                    bpeBuilder.Add(sentence);
+                }
+            }
+            PrintSize(name, bpeBuilder.FinishBuilding()->Size());
+        }
+    }
+}
+
+// Lookups of all corpus words (about 3% of them are unknown) in the unigram dictionary of the corpus.
+// Sizes of the serialized mmap dictionaries and, on linux, the memory their mapped files take are printed once.
+namespace {
+    TIntrusivePtr<TDictionary> BuildLookupDictionary(TVector<TStringBuf>* tokens) {
+        const auto& sentences = Singleton<TCorpus>()->Sentences;
+        TDictionaryBuilder dictionaryBuilder(GetDictionaryBuilderOptions(), GetDictionaryOptions(1));
+        for (const auto& sentence : sentences) {
+            dictionaryBuilder.Add(sentence);
+            tokens->insert(tokens->end(), sentence.begin(), sentence.end());
+        }
+        Shuffle(tokens->begin(), tokens->end(), TFastRng<ui64>(0));
+        return dictionaryBuilder.FinishBuilding();
+    }
+
+#if defined(_linux_)
+    struct TMappingFootprint {
+        ui64 RssKb = 0;
+        ui64 PssKb = 0;
+    };
+
+    // Rss and Pss of the mapping which contains `address`, Pss divides every page by the number of its sharers
+    TMappingFootprint GetMappingFootprint(const void* address) {
+        const uintptr_t target = reinterpret_cast<uintptr_t>(address);
+        TFileInput smaps("/proc/self/smaps");
+        TMappingFootprint footprint;
+        bool isTarget = false;
+        TString line;
+        while (smaps.ReadLine(line)) {
+            TStringBuf begin, end;
+            uintptr_t beginAddress, endAddress;
+            if (TStringBuf(line).Before(' ').TrySplit('-', begin, end) &&
+                TryIntFromString<16>(begin, beginAddress) && TryIntFromString<16>(end, endAddress))
+            {
+                isTarget = beginAddress <= target && target < endAddress;
+            } else if (isTarget) {
+                TStringBuf name, value;
+                if (TStringBuf(line).TrySplit(':', name, value)) {
+                    const TStringBuf kilobytes = StripString(value).Before(' ');
+                    if (name == "Rss") {
+                        footprint.RssKb = FromString<ui64>(kilobytes);
+                    } else if (name == "Pss") {
+                        footprint.PssKb = FromString<ui64>(kilobytes);
+                    }
+                }
+            }
+        }
+        return footprint;
+    }
+
+    /*
+     * Two processes map the saved dictionary each on its own and look up all tokens, then the footprint
+     * of the mapping is taken in the first one. Rss is what one process keeps resident, Pss is its share
+     * of the page cache, so Rss - Pss is what the second process gets for free.
+     * */
+    template <typename TMMapDictionaryType>
+    TMappingFootprint MeasureSharedFootprint(const IDictionary& dictionary, const TVector<TStringBuf>& tokens) {
+        TTempFileHandle file;
+        {
+            TUnbufferedFileOutput output(file);
+            dictionary.Save(&output);
+        }
+        const auto lookUpAll = [&](const TBlob& blob) {
+            const TMMapDictionaryType mappedDictionary(blob.Data(), blob.Size());
+            for (TStringBuf token : tokens) {
+                Y_DO_NOT_OPTIMIZE_AWAY(mappedDictionary.Apply(token));
+            }
+        };
+
+        int ready[2];
+        int done[2];
+        Y_ENSURE(pipe(ready) == 0 && pipe(done) == 0);
+        char byte = 0;
+        const pid_t child = fork();
+        Y_ENSURE(child >= 0);
+        if (child == 0) {
+            const TBlob blob = TBlob::FromFile(file.Name());
+            lookUpAll(blob);
+            Y_UNUSED(write(ready[1], &byte, 1));
+            Y_UNUSED(read(done[0], &byte, 1));
+            _exit(0);
+        }
+        const TBlob blob = TBlob::FromFile(file.Name());
+        lookUpAll(blob);
+        Y_ENSURE(read(ready[0], &byte, 1) == 1);
+        const TMappingFootprint footprint = GetMappingFootprint(blob.Data());
+        Y_ENSURE(write(done[1], &byte, 1) == 1);
+        waitpid(child, nullptr, 0);
+        for (int fd : {ready[0], ready[1], done[0], done[1]}) {
+            close(fd);
+        }
+        return footprint;
+    }
+#endif
+
+    struct TLookupData {
+        TVector<TStringBuf> Tokens;
+        TIntrusivePtr<TDictionary> Dictionary;
+        TMMapDictionary MMapDictionary;
+        TMMapPerfectHashDictionary MMapPerfectHashDictionary;
+
+        TLookupData()
+            : Dictionary(BuildLookupDictionary(&Tokens))
+            , MMapDictionary(Dictionary)
+            , MMapPerfectHashDictionary(Dictionary)
+        {
+            TCountingOutput mmapSize(&Cnull);
+            MMapDictionary.Save(&mmapSize);
+            TCountingOutput perfectHashSize(&Cnull);
+            MMapPerfectHashDictionary.Save(&perfectHashSize);
+            Cerr << "dictionary size " << Dictionary->Size() << ", TMMapDictionary " << mmapSize.Counter()
+                << " bytes, TMMapPerfectHashDictionary " << perfectHashSize.Counter() << " bytes" << Endl;
+#if defined(_linux_)
+            const auto mmapFootprint = MeasureSharedFootprint<TMMapDictionary>(MMapDictionary, Tokens);
+            const auto perfectHashFootprint = MeasureSharedFootprint<TMMapPerfectHashDictionary>(MMapPerfectHashDictionary, Tokens);
+            Cerr << "mapped by two processes, Rss/Pss per process: TMMapDictionary " << mmapFootprint.RssKb << "/"
+                << mmapFootprint.PssKb << " KiB, TMMapPerfectHashDictionary " << perfectHashFootprint.RssKb << "/"
+                << perfectHashFootprint.PssKb << " KiB" << Endl;
+#endif
+        }
+    };
+
+    void RunLookup(const IDictionary& dictionary, const NBench::NCpu::TParams& iface) {
+        const auto& tokens = Singleton<TLookupData>()->Tokens;
+        for (size_t i = 0; i < iface.Iterations(); ++i) {
+            Y_DO_NOT_OPTIMIZE_AWAY(dictionary.Apply(tokens[i % tokens.size()]));
+        }
+    }
+}
+
+Y_CPU_BENCHMARK(Lookup_Dictionary, iface) {
+    RunLookup(*Singleton<TLookupData>()->Dictionary, iface);
+}
+
+Y_CPU_BENCHMARK(Lookup_MMapDictionary, iface) {
+    RunLookup(Singleton<TLookupData>()->MMapDictionary, iface);
+}
+
+Y_CPU_BENCHMARK(Lookup_MMapPerfectHashDictionary, iface) {
+    RunLookup(Singleton<TLookupData>()->MMapPerfectHashDictionary, iface);
+}
+
+#define DefineBenchmarks(Name, GramOrder)                                                                           \
+    Y_CPU_BENCHMARK(Name##_Sequential, iface) {                                                                     \
+        RunSequential(#Name, GramOrder, iface);                                                                     \
+    }                                                                                                               \
+    Y_CPU_BENCHMARK(Name##_Parallel_1Thread, iface) {                                                               \
+        RunParallel(#Name, GramOrder, 0.0, nullptr, iface);                                                         \
+    }                                                                                                               \
+    Y_CPU_BENCHMARK(Name##_Parallel_4Threads, iface) {                                                              \
+        RunParallel(#Name, GramOrder, 0.0, &Singleton<TExecutors>()->Threads4, iface);                              \
+    }                                                                                                               \
+    Y_CPU_BENCHMARK(Name##_Parallel_16Threads, iface) {                                                             \
+        RunParallel(#Name, GramOrder, 0.0, &Singleton<TExecutors>()->Threads16, iface);                             \
+    }                                                                                                               \
+    Y_CPU_BENCHMARK(Name##_Pruned_1Thread, iface) {                                                                 \
+        RunParallel(#Name "_Pruned", GramOrder, MaxCountError, nullptr, iface);                                     \
+    }                                                                                                               \
+    Y_CPU_BENCHMARK(Name##_Pruned_16Threads, iface) {                                                               \
+        RunParallel(#Name "_Pruned", GramOrder, MaxCountError, &Singleton<TExecutors>()->Threads16, iface);         \
+    }
+
+DefineBenchmarks(Unigram, 1)
+DefineBenchmarks(Bigram, 2)
+
+Y_CPU_BENCHMARK(Bpe_Sequential, iface) {
+    RunBpe("Bpe", nullptr, iface);
+}
+
+Y_CPU_BENCHMARK(Bpe_Parallel_4Threads, iface) {
+    RunBpe("Bpe", &Singleton<TExecutors>()->Threads4, iface);
+}
+
+Y_CPU_BENCHMARK(Bpe_Parallel_16Threads, iface) {
+    RunBpe("Bpe", &Singleton<TExecutors>()->Threads16, iface);
+}
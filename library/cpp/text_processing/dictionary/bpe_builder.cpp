@@ -1,5 +1,9 @@
 #include "bpe_builder.h"
 
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/hash.h>
+
 using NTextProcessing::NDictionary::EEndOfWordTokenPolicy;
 using namespace NTextProcessing::NDictionary;
 
@@ -21,14 +25,14 @@ static void AddToken(
     }
 }
 
-template <typename TStringVector>
+template <typename TStringVector, typename TPairStatsMap>
 static void AddImpl(
     TStringVector tokens,
     ui64 weight,
     bool skipUnknown,
     const TDictionary& alphabet,
     TVector<TEraseList<TTokenId>>* tokenIdsLists,
-    TPairStats* pairStats,
+    TPairStatsMap* pairStats,
     TVector<ui64>* counts
 ) {
     const TTokenId eosId = alphabet.GetEndOfSentenceTokenId();
@@ -79,6 +83,127 @@ void TBpeDictionaryBuilder::Add(TConstArrayRef<TString> tokens, ui64 weight) {
     AddImpl(tokens, weight, SkipUnknown, *Alphabet, &TokenIdsLists, &PairStats, &Counts);
 }
 
+namespace {
+    // pair statistics of a block of sentences split into shards by pair, so that shards are merged in parallel
+    struct TShardedPairStats {
+        TVector<THashMap<TPair, TPairStat>> Shards;
+
+        explicit TShardedPairStats(size_t shardCount)
+            : Shards(shardCount)
+        {
+        }
+
+        size_t GetShardId(const TPair& pair) const {
+            return (pair.first * 0x9E3779B1u + pair.second) % Shards.size();
+        }
+
+        TPairStat& operator[](const TPair& pair) {
+            return Shards[GetShardId(pair)][pair];
+        }
+    };
+
+    void AppendPairStat(TPairStat&& from, TPairStat* to) {
+        if (to->Positions.empty()) {
+            *to = std::move(from);
+        } else {
+            to->Count += from.Count;
+            to->Positions.insert(to->Positions.end(), from.Positions.begin(), from.Positions.end());
+        }
+    }
+}
+
+template <typename TTokenType>
+void TBpeDictionaryBuilder::AddBatchImpl(
+    TConstArrayRef<TVector<TTokenType>> sentences,
+    NPar::ILocalExecutor* localExecutor,
+    ui64 weight
+) {
+    struct TBlock {
+        TVector<TEraseList<TTokenId>> TokenIdsLists;
+        TShardedPairStats PairStats;
+        TVector<ui64> Counts;
+
+        explicit TBlock(size_t shardCount)
+            : PairStats(shardCount)
+        {
+        }
+    };
+
+    if (!localExecutor || localExecutor->GetThreadCount() == 0) {
+        for (const auto& sentence : sentences) {
+            AddImpl(TConstArrayRef<TTokenType>(sentence), weight, SkipUnknown, *Alphabet, &TokenIdsLists, &PairStats, &Counts);
+        }
+        return;
+    }
+
+    const int blockCount = localExecutor->GetThreadCount() + 1;
+    const auto execRange = [&](const auto& body, int count) {
+        localExecutor->ExecRangeWithThrow(body, 0, count, NPar::TLocalExecutor::WAIT_COMPLETE);
+    };
+
+    const size_t blockSize = CeilDiv<size_t>(sentences.size(), blockCount);
+    TVector<TBlock> blocks(blockCount, TBlock(blockCount));
+    execRange([&](int blockId) {
+        TBlock& block = blocks[blockId];
+        const size_t begin = Min(blockId * blockSize, sentences.size());
+        const size_t end = Min(begin + blockSize, sentences.size());
+        for (size_t i = begin; i < end; ++i) {
+            AddImpl(
+                TConstArrayRef<TTokenType>(sentences[i]),
+                weight,
+                SkipUnknown,
+                *Alphabet,
+                &block.TokenIdsLists,
+                &block.PairStats,
+                &block.Counts);
+        }
+    }, blockCount);
+
+    TVector<int> lineIdOffsets(blockCount);
+    for (int blockId = 0; blockId < blockCount; ++blockId) {
+        lineIdOffsets[blockId] = TokenIdsLists.size();
+        for (auto& tokenIdsList : blocks[blockId].TokenIdsLists) {
+            TokenIdsLists.push_back(std::move(tokenIdsList));
+        }
+        Counts.insert(Counts.end(), blocks[blockId].Counts.begin(), blocks[blockId].Counts.end());
+    }
+
+    // blocks are merged in order, so positions of every pair are in the same order as after sequential adding
+    execRange([&](int shardId) {
+        auto& mergedShard = blocks[0].PairStats.Shards[shardId];
+        for (int blockId = 0; blockId < blockCount; ++blockId) {
+            auto& shard = blocks[blockId].PairStats.Shards[shardId];
+            for (auto& [pair, stat] : shard) {
+                if (lineIdOffsets[blockId] != 0) {
+                    for (auto& position : stat.Positions) {
+                        position.first += lineIdOffsets[blockId];
+                    }
+                }
+                if (blockId != 0) {
+                    AppendPairStat(std::move(stat), &mergedShard[pair]);
+                }
+            }
+            if (blockId != 0) {
+                shard.clear();
+            }
+        }
+    }, blockCount);
+
+    for (auto& shard : blocks[0].PairStats.Shards) {
+        for (auto& [pair, stat] : shard) {
+            AppendPairStat(std::move(stat), &PairStats[pair]);
+        }
+    }
+}
+
+void TBpeDictionaryBuilder::Add(TConstArrayRef<TVector<TString>> sentences, NPar::ILocalExecutor* localExecutor, ui64 weight) {
+    AddBatchImpl(sentences, localExecutor, weight);
+}
+
+void TBpeDictionaryBuilder::Add(TConstArrayRef<TVector<TStringBuf>> sentences, NPar::ILocalExecutor* localExecutor, ui64 weight) {
+    AddBatchImpl(sentences, localExecutor, weight);
+}
+
 TIntrusivePtr<TBpeDictionary> TBpeDictionaryBuilder::FinishBuilding() {
     Y_ENSURE(!IsBuildingFinish, "FinishBuilding method should be called only once.");
     IsBuildingFinish = true;
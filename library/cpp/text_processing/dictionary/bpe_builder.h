@@ -9,6 +9,10 @@
 #include <util/generic/array_ref.h>
 #include <util/generic/fwd.h>
 
+namespace NPar {
+    class ILocalExecutor;
+}
+
 namespace NTextProcessing::NDictionary {
     using TPairStats = THeapDict<TPair, TPairStat>;
 
@@ -26,9 +30,18 @@ namespace NTextProcessing::NDictionary {
         void Add(TConstArrayRef<TString> tokens, ui64 weight = 1);
         void Add(TConstArrayRef<TStringBuf> tokens, ui64 weight = 1);
 
+        /*
+         * Sentences are converted to token ids and their pairs are counted in parallel on localExecutor,
+         * the result is the same as of adding them one by one.
+         * */
+        void Add(TConstArrayRef<TVector<TString>> sentences, NPar::ILocalExecutor* localExecutor, ui64 weight = 1);
+        void Add(TConstArrayRef<TVector<TStringBuf>> sentences, NPar::ILocalExecutor* localExecutor, ui64 weight = 1);
+
         TIntrusivePtr<TBpeDictionary> FinishBuilding();
 
     private:
+        template <typename TTokenType>
+        void AddBatchImpl(TConstArrayRef<TVector<TTokenType>> sentences, NPar::ILocalExecutor* localExecutor, ui64 weight);
         void CalcMostFrequentUnits();
 
         ui32 NumUnits;
@@ -1,124 +1,254 @@
 #include "bpe_builder.h"
-#include "bpe_helpers.h"
 #include "serialization_helpers.h"
 
-#include <library/cpp/containers/dense_hash/dense_hash.h>
+#include <library/cpp/cache/cache.h>
 
 #include <util/digest/murmur.h>
+#include <util/generic/algorithm.h>
 #include <util/generic/array_ref.h>
 #include <util/generic/hash_set.h>
 #include <util/generic/maybe.h>
-#include <util/generic/queue.h>
+#include <util/generic/ymath.h>
 #include <util/string/split.h>
+#include <util/system/guard.h>
+#include <util/system/spinlock.h>
+
+#include <array>
+#include <tuple>
 
 using namespace NTextProcessing::NDictionary;
 using NTextProcessing::NDictionary::EUnknownTokenPolicy;
 using TUnit = std::pair<TTokenId, TTokenId>;
-using TTokenToUnit = std::pair<TTokenId, TUnit>;
-using TUnitQueue = TPriorityQueue<TTokenToUnit, TVector<TTokenToUnit>, std::greater<TTokenToUnit>>;
-
-using TPositionsMap = TDenseHash<TTokenId, TVector<int>, THash<TTokenId>, 100>;
 
 static const char BPE_MAGIC[] = "MMapBpeDict";
 static const size_t BPE_MAGIC_SIZE = Y_ARRAY_SIZE(BPE_MAGIC);  // yes, with terminating zero
 
-template <typename TUnitToTokenId>
-static void AddPair(
-    int firstPosition,
-    const TUnitToTokenId& unitToTokenId,
-    TEraseList<TTokenId>* tokenIdsList,
-    TPositionsMap* positions,
-    TUnitQueue* minIds
-) {
-    if (tokenIdsList->IsLastElement(firstPosition)) {
-        return;
-    }
-    auto unit = tokenIdsList->GetPair(firstPosition);
-    auto unitId = unitToTokenId(unit);
-    if (!unitId) {
-        return;
-    }
-    minIds->push({*unitId, unit});
-    (*positions)[*unitId].push_back(firstPosition);
+static constexpr int ERASED_POSITION = -2;
+
+namespace {
+    struct TMergeCandidate {
+        TTokenId TokenId;
+        int Position;
+        TUnit Unit;
+
+        bool operator>(const TMergeCandidate& rhs) const {
+            return std::tie(TokenId, Position) > std::tie(rhs.TokenId, rhs.Position);
+        }
+    };
+}
+
+namespace NTextProcessing::NDictionary {
+    // Linked list over token positions and a min-heap of merges ordered by (unit id, position).
+    struct TBpeApplyScratch {
+        TVector<int> Prev;
+        TVector<int> Next;
+        TVector<TMergeCandidate> Heap;
+        TVector<TTokenId> WordTokenIds;
+    };
+
+    class TBpeWordCache {
+    public:
+        explicit TBpeWordCache(size_t maxSize) {
+            for (auto& shard : Shards) {
+                shard.Reset(new TShard(CeilDiv(maxSize, ShardCount)));
+            }
+        }
+
+        // Appends cached encoding of the word to tokenIds.
+        bool Find(TStringBuf word, EUnknownTokenPolicy unknownTokenPolicy, TVector<TTokenId>* tokenIds) const {
+            const ui64 hash = Hash(word, unknownTokenPolicy);
+            TShard& shard = *Shards[hash % ShardCount];
+            with_lock (shard.Lock) {
+                auto it = shard.Cache.Find(hash);
+                if (it == shard.Cache.End() || it->Word != word || it->UnknownTokenPolicy != unknownTokenPolicy) {
+                    return false;
+                }
+                tokenIds->insert(tokenIds->end(), it->TokenIds.begin(), it->TokenIds.end());
+            }
+            return true;
+        }
+
+        void Insert(TStringBuf word, EUnknownTokenPolicy unknownTokenPolicy, TConstArrayRef<TTokenId> tokenIds) const {
+            const ui64 hash = Hash(word, unknownTokenPolicy);
+            TCachedWord value{TString(word), unknownTokenPolicy, TVector<TTokenId>(tokenIds.begin(), tokenIds.end())};
+            TShard& shard = *Shards[hash % ShardCount];
+            with_lock (shard.Lock) {
+                shard.Cache.Update(hash, value);
+            }
+        }
+
+    private:
+        struct TCachedWord {
+            TString Word;
+            EUnknownTokenPolicy UnknownTokenPolicy;
+            TVector<TTokenId> TokenIds;
+        };
+
+        struct TShard {
+            explicit TShard(size_t maxSize)
+                : Cache(maxSize)
+            {
+            }
+
+            TAdaptiveLock Lock;
+            TLRUCache<ui64, TCachedWord> Cache;
+        };
+
+        static ui64 Hash(TStringBuf word, EUnknownTokenPolicy unknownTokenPolicy) {
+            return MurmurHash<ui64>(word.data(), word.size(), static_cast<ui64>(unknownTokenPolicy));
+        }
+
+        // shards reduce lock contention between threads applying the same dictionary
+        static constexpr size_t ShardCount = 16;
+        std::array<THolder<TShard>, ShardCount> Shards;
+    };
 }
 
-// TODO(annaveronika): more efficient apply.
-template <typename TStringVector, typename TUnitToTokenId>
-static void ApplyImpl(
-    TStringVector tokens,
+// Merges units of tokenIds in place: the unit with the smallest id is merged first,
+// equal units are merged from left to right.
+template <typename TUnitToTokenId>
+static void MergeUnits(
     TVector<TTokenId>* tokenIds,
-    const IDictionary* alphabet,
     const TUnitToTokenId& unitToTokenId,
-    EUnknownTokenPolicy unknownTokenPolicy
+    TBpeApplyScratch* scratch
 ) {
-    tokenIds->clear();
-    alphabet->Apply(tokens, tokenIds, unknownTokenPolicy);
-
-    if (tokenIds->size() <= 1) {
+    const int size = tokenIds->size();
+    if (size <= 1) {
         return;
     }
 
-    TUnitQueue minIds;
-    TEraseList<TTokenId> tokenIdsList(*tokenIds);
-    TPositionsMap positions(Max<TTokenId>(), tokenIds->size());
+    auto& tokens = *tokenIds;
+    auto& prev = scratch->Prev;
+    auto& next = scratch->Next;
+    auto& heap = scratch->Heap;
+    prev.resize(size);
+    next.resize(size);
+    heap.clear();
+    for (int i = 0; i < size; ++i) {
+        prev[i] = i - 1;
+        next[i] = i + 1;
+    }
 
-    for (size_t i = 0; i + 1 < tokenIds->size(); ++i) {
-        auto unit = TUnit((*tokenIds)[i], (*tokenIds)[i + 1]);
-        auto maybeTokenId = unitToTokenId(unit);
-        if (!maybeTokenId) {
-            continue;
+    const auto addCandidate = [&](int position) {
+        const TUnit unit(tokens[position], tokens[next[position]]);
+        if (const TMaybe<TTokenId> unitId = unitToTokenId(unit)) {
+            heap.push_back({*unitId, position, unit});
+            return true;
         }
-        auto unitId = *maybeTokenId;
-        minIds.push({unitId, unit});
-        positions[unitId].push_back(i);
-    }
+        return false;
+    };
 
-    while (!minIds.empty()) {
-        auto bestIdWithUnit = minIds.top();
-        auto bestId = bestIdWithUnit.first;
-        auto bestUnit = bestIdWithUnit.second;
+    for (int i = 0; i + 1 < size; ++i) {
+        addCandidate(i);
+    }
+    MakeHeap(heap.begin(), heap.end(), std::greater<TMergeCandidate>());
+
+    while (!heap.empty()) {
+        PopHeap(heap.begin(), heap.end(), std::greater<TMergeCandidate>());
+        const TMergeCandidate candidate = heap.back();
+        heap.pop_back();
+
+        const int position = candidate.Position;
+        const int nextPosition = next[position];
+        if (
+            prev[position] == ERASED_POSITION ||
+            nextPosition == size ||
+            tokens[position] != candidate.Unit.first ||
+            tokens[nextPosition] != candidate.Unit.second
+        ) {
+            continue;
+        }
 
-        while (!minIds.empty() && minIds.top() == bestIdWithUnit) {
-            minIds.pop();
+        tokens[position] = candidate.TokenId;
+        next[position] = next[nextPosition];
+        if (next[position] != size) {
+            prev[next[position]] = position;
         }
+        prev[nextPosition] = ERASED_POSITION;
 
-        for (int firstPosition : positions[bestId]) {
-            if (
-                !tokenIdsList.IsValidElement(firstPosition) ||
-                tokenIdsList.IsLastElement(firstPosition) ||
-                tokenIdsList.GetPair(firstPosition) != bestUnit
-            ) {
-                continue;
-            }
-            tokenIdsList.Erase(tokenIdsList.GetNextPosition(firstPosition));
-            tokenIdsList.UpdateToken(firstPosition, bestId);
-            if (!tokenIdsList.IsFirstElement(firstPosition)) {
-                int prevPosition = tokenIdsList.GetPrevPosition(firstPosition);
-                AddPair(prevPosition, unitToTokenId, &tokenIdsList, &positions, &minIds);
-            }
-            AddPair(firstPosition, unitToTokenId, &tokenIdsList, &positions, &minIds);
+        if (prev[position] >= 0 && addCandidate(prev[position])) {
+            PushHeap(heap.begin(), heap.end(), std::greater<TMergeCandidate>());
+        }
+        if (next[position] != size && addCandidate(position)) {
+            PushHeap(heap.begin(), heap.end(), std::greater<TMergeCandidate>());
         }
     }
 
-    (*tokenIds) = tokenIdsList.GetValidElements();
+    // the first position is never erased
+    int resultSize = 0;
+    for (int position = 0; position != size; position = next[position]) {
+        tokens[resultSize++] = tokens[position];
+    }
+    tokens.resize(resultSize);
 }
 
+template <typename TTokenType, typename TUnitToTokenId>
+static void ApplyWithoutCache(
+    TConstArrayRef<TTokenType> tokens,
+    TVector<TTokenId>* tokenIds,
+    const IDictionary* alphabet,
+    const TUnitToTokenId& unitToTokenId,
+    EUnknownTokenPolicy unknownTokenPolicy,
+    TBpeApplyScratch* scratch
+) {
+    tokenIds->clear();
+    alphabet->Apply(tokens, tokenIds, unknownTokenPolicy);
+    MergeUnits(tokenIds, unitToTokenId, scratch);
+}
+
+template <typename TUnitToTokenIdMap>
+static auto GetUnitToTokenIdFunc(const TUnitToTokenIdMap& sourceTokenIdsToTokenId) {
+    return [&](const TUnit& unit) {
+        auto it = sourceTokenIdsToTokenId.find(unit);
+        return it == sourceTokenIdsToTokenId.end() ? Nothing() : TMaybe<TTokenId>(it->second);
+    };
+}
+
+TBpeDictionary::TBpeDictionary() = default;
+TBpeDictionary::~TBpeDictionary() = default;
+TBpeDictionary::TBpeDictionary(TBpeDictionary&&) = default;
+TBpeDictionary& TBpeDictionary::operator=(TBpeDictionary&&) = default;
+
 TBpeDictionary::TBpeDictionary(TIntrusivePtr<TDictionary> alphabet)
     : Alphabet(alphabet)
 {
 }
 
+TBpeDictionary::TBpeDictionary(TIntrusivePtr<TDictionary> alphabet, TVector<TBpeUnit> bpeUnits)
+    : Alphabet(alphabet)
+    , BpeUnits(std::move(bpeUnits))
+{
+    InitBpeTokens();
+}
+
 TTokenId TBpeDictionary::Apply(TStringBuf) const {
     Y_ENSURE(false, "This method is unimplemented for TBpeDictionary.");
 }
 
-static std::function<TMaybe<TTokenId>(const TUnit& unit)> GetUnitToTokenIdFunc(
-    const THashMap<std::pair<TTokenId, TTokenId>, TTokenId>& sourceTokenIdsToTokenId
-) {
-    return [&](const TUnit& unit) {
-        auto it = sourceTokenIdsToTokenId.find(unit);
-        return it == sourceTokenIdsToTokenId.end() ? Nothing() : TMaybe<TTokenId>(it->second);
-    };
+template <typename TTokenType>
+void TBpeDictionary::ApplyImpl(
+    TConstArrayRef<TTokenType> tokens,
+    TVector<TTokenId>* tokenIds,
+    EUnknownTokenPolicy unknownTokenPolicy,
+    TBpeApplyScratch* scratch
+) const {
+    const auto unitToTokenId = GetUnitToTokenIdFunc(SourceTokenIdsToTokenId);
+    if (!WordCache) {
+        ApplyWithoutCache(tokens, tokenIds, Alphabet.Get(), unitToTokenId, unknownTokenPolicy, scratch);
+        return;
+    }
+
+    // no unit spans the end of word token, so every word is merged separately
+    tokenIds->clear();
+    for (const auto& token : tokens) {
+        if (WordCache->Find(token, unknownTokenPolicy, tokenIds)) {
+            continue;
+        }
+        auto& wordTokenIds = scratch->WordTokenIds;
+        ApplyWithoutCache(MakeArrayRef(&token, 1), &wordTokenIds, Alphabet.Get(), unitToTokenId, unknownTokenPolicy, scratch);
+        WordCache->Insert(token, unknownTokenPolicy, wordTokenIds);
+        tokenIds->insert(tokenIds->end(), wordTokenIds.begin(), wordTokenIds.end());
+    }
 }
 
 void TBpeDictionary::Apply(
@@ -126,13 +256,8 @@ void TBpeDictionary::Apply(
     TVector<TTokenId>* tokensIds,
     EUnknownTokenPolicy unknownTokenPolicy
 ) const {
-    ApplyImpl(
-        tokens,
-        tokensIds,
-        Alphabet.Get(),
-        GetUnitToTokenIdFunc(SourceTokenIdsToTokenId),
-        unknownTokenPolicy
-    );
+    TBpeApplyScratch scratch;
+    ApplyImpl(tokens, tokensIds, unknownTokenPolicy, &scratch);
 }
 
 void TBpeDictionary::Apply(
@@ -140,13 +265,41 @@ void TBpeDictionary::Apply(
     TVector<TTokenId>* tokensIds,
     EUnknownTokenPolicy unknownTokenPolicy
 ) const {
-    ApplyImpl(
-        tokens,
-        tokensIds,
-        Alphabet.Get(),
-        GetUnitToTokenIdFunc(SourceTokenIdsToTokenId),
-        unknownTokenPolicy
-    );
+    TBpeApplyScratch scratch;
+    ApplyImpl(tokens, tokensIds, unknownTokenPolicy, &scratch);
+}
+
+void TBpeDictionary::Apply(
+    TConstArrayRef<TVector<TString>> sentences,
+    TVector<TVector<TTokenId>>* sentencesTokenIds,
+    EUnknownTokenPolicy unknownTokenPolicy
+) const {
+    TBpeApplyScratch scratch;
+    sentencesTokenIds->resize(sentences.size());
+    for (size_t i = 0; i < sentences.size(); ++i) {
+        ApplyImpl(MakeArrayRef(sentences[i]), &(*sentencesTokenIds)[i], unknownTokenPolicy, &scratch);
+    }
+}
+
+void TBpeDictionary::Apply(
+    TConstArrayRef<TVector<TStringBuf>> sentences,
+    TVector<TVector<TTokenId>>* sentencesTokenIds,
+    EUnknownTokenPolicy unknownTokenPolicy
+) const {
+    TBpeApplyScratch scratch;
+    sentencesTokenIds->resize(sentences.size());
+    for (size_t i = 0; i < sentences.size(); ++i) {
+        ApplyImpl(MakeArrayRef(sentences[i]), &(*sentencesTokenIds)[i], unknownTokenPolicy, &scratch);
+    }
+}
+
+void TBpeDictionary::SetWordCacheSize(size_t wordCacheSize) {
+    WordCacheSize = wordCacheSize;
+    InitWordCache();
+}
+
+bool TBpeDictionary::HasWordCache() const {
+    return WordCache.Get() != nullptr;
 }
 
 ui32 TBpeDictionary::Size() const {
@@ -193,6 +346,7 @@ TTokenId TBpeDictionary::GetMinUnusedTokenId() const {
 
 void TBpeDictionary::SetAlphabet(TIntrusivePtr<TDictionary> alphabet) {
     Alphabet = alphabet;
+    InitWordCache();
 }
 
 TIntrusiveConstPtr<TDictionary> TBpeDictionary::GetAlphabet() const {
@@ -247,6 +401,41 @@ void TBpeDictionary::InitBpeTokens() {
         SourceTokenIdsToTokenId[std::pair<TTokenId, TTokenId>(unit.Left, unit.Right)] = curTokenId++;
         StringTokens.push_back(GetBpeToken(unit.Left, unit.Right));
     }
+    InitWordCache();
+}
+
+void TBpeDictionary::InitWordCache() {
+    WordCache.Destroy();
+    if (WordCacheSize == 0 || !Alphabet) {
+        return;
+    }
+    const auto& options = Alphabet->GetDictionaryOptionsRef();
+    if (
+        options.TokenLevelType != ETokenLevelType::Letter ||
+        options.GramOrder != 1 ||
+        options.EndOfWordTokenPolicy != EEndOfWordTokenPolicy::Insert
+    ) {
+        return;
+    }
+    const TTokenId endOfWordTokenId = Alphabet->Apply(" ");
+    if (endOfWordTokenId == Alphabet->GetUnknownTokenId()) {
+        return;
+    }
+
+    // A unit spans the end of word token if it is not the last token of the unit.
+    // Units refer only to the alphabet and to the previous units.
+    const TTokenId minId = GetMinTokenIdForUnits();
+    TVector<bool> hasEndOfWord(BpeUnits.size());
+    const auto containsEndOfWord = [&](TTokenId tokenId) {
+        return tokenId < minId ? tokenId == endOfWordTokenId : hasEndOfWord[tokenId - minId];
+    };
+    for (size_t i = 0; i < BpeUnits.size(); ++i) {
+        if (containsEndOfWord(BpeUnits[i].Left)) {
+            return;
+        }
+        hasEndOfWord[i] = containsEndOfWord(BpeUnits[i].Right);
+    }
+    WordCache.Reset(new TBpeWordCache(WordCacheSize));
 }
 
 static ui64 MurmurHashFromUnit(const TUnit& unit, ui64 seed) {
@@ -289,7 +478,7 @@ TTokenId TMMapBpeDictionary::Apply(TStringBuf) const {
     Y_ENSURE(false, "This method is unimplemented for TMMapBpeDictionary.");
 }
 
-static std::function<TMaybe<TTokenId>(const TUnit& unit)> GetUnitToTokenIdFuncForMMap(
+static auto GetUnitToTokenIdFuncForMMap(
     TConstArrayRef<TBucket> sourceTokenIdsToTokenId,
     ui64 sourceTokenIdsToTokenIdSeed
 ) {
@@ -305,12 +494,14 @@ void TMMapBpeDictionary::Apply(
     TVector<TTokenId>* tokensIds,
     EUnknownTokenPolicy unknownTokenPolicy
 ) const {
-    ApplyImpl(
+    TBpeApplyScratch scratch;
+    ApplyWithoutCache(
         tokens,
         tokensIds,
         Alphabet.Get(),
         GetUnitToTokenIdFuncForMMap(SourceTokenIdsToTokenId, SourceTokenIdsToTokenIdSeed),
-        unknownTokenPolicy
+        unknownTokenPolicy,
+        &scratch
     );
 }
 
@@ -319,12 +510,14 @@ void TMMapBpeDictionary::Apply(
     TVector<TTokenId>* tokensIds,
     EUnknownTokenPolicy unknownTokenPolicy
 ) const {
-    ApplyImpl(
+    TBpeApplyScratch scratch;
+    ApplyWithoutCache(
         tokens,
         tokensIds,
         Alphabet.Get(),
         GetUnitToTokenIdFuncForMMap(SourceTokenIdsToTokenId, SourceTokenIdsToTokenIdSeed),
-        unknownTokenPolicy
+        unknownTokenPolicy,
+        &scratch
     );
 }
 
@@ -5,6 +5,9 @@
 #include "mmap_frequency_based_dictionary.h"
 #include "mmap_hash_table.h"
 
+#include <library/cpp/containers/flat_hash/flat_hash.h>
+
+#include <util/generic/ptr.h>
 #include <util/generic/vector.h>
 #include <util/stream/output.h>
 
@@ -12,10 +15,17 @@ namespace NTextProcessing::NDictionary {
 
     class TBpeDictionaryBuilder;
     class TMMapBpeDictionary;
+    class TBpeWordCache;
+    struct TBpeApplyScratch;
+
+    inline constexpr size_t DEFAULT_BPE_WORD_CACHE_SIZE = 1 << 16;
 
     class TBpeDictionary final : public IDictionary, public TMoveOnly {
     public:
-        TBpeDictionary() = default;
+        TBpeDictionary();
+        ~TBpeDictionary();
+        TBpeDictionary(TBpeDictionary&&);
+        TBpeDictionary& operator=(TBpeDictionary&&);
 
         explicit TBpeDictionary(TIntrusivePtr<TDictionary> alphabet);
 
@@ -33,6 +43,25 @@ namespace NTextProcessing::NDictionary {
             EUnknownTokenPolicy unknownTokenPolicy = EUnknownTokenPolicy::Skip
         ) const override;
 
+        // Applies the dictionary to every sentence, merge buffers are shared between sentences.
+        void Apply(
+            TConstArrayRef<TVector<TString>> sentences,
+            TVector<TVector<TTokenId>>* sentencesTokenIds,
+            EUnknownTokenPolicy unknownTokenPolicy = EUnknownTokenPolicy::Skip
+        ) const;
+
+        void Apply(
+            TConstArrayRef<TVector<TStringBuf>> sentences,
+            TVector<TVector<TTokenId>>* sentencesTokenIds,
+            EUnknownTokenPolicy unknownTokenPolicy = EUnknownTokenPolicy::Skip
+        ) const;
+
+        // Maximum number of words with memoized encodings, 0 disables the cache.
+        // Encodings are memoized only for letter level alphabets with end of word tokens
+        // if no bpe unit spans the end of word token, otherwise words are merged together.
+        void SetWordCacheSize(size_t wordCacheSize);
+        bool HasWordCache() const;
+
         ui32 Size() const override;
 
         TString GetToken(TTokenId tokenId) const override;
@@ -67,11 +96,7 @@ namespace NTextProcessing::NDictionary {
         friend class NTextProcessing::NDictionary::TBpeDictionaryBuilder;
         friend class NTextProcessing::NDictionary::TMMapBpeDictionary;
 
-        explicit TBpeDictionary(TIntrusivePtr<TDictionary> alphabet, TVector<TBpeUnit> bpeUnits)
-            : Alphabet(alphabet)
-            , BpeUnits(std::move(bpeUnits)) {
-            InitBpeTokens();
-        }
+        explicit TBpeDictionary(TIntrusivePtr<TDictionary> alphabet, TVector<TBpeUnit> bpeUnits);
 
         TTokenId GetMinTokenIdForUnits() const {
             return Alphabet->GetMinUnusedTokenId();
@@ -80,11 +105,22 @@ namespace NTextProcessing::NDictionary {
         TString GetBpeToken(TTokenId leftId, TTokenId rightId) const ;
 
         void InitBpeTokens();
+        void InitWordCache();
+
+        template <typename TTokenType>
+        void ApplyImpl(
+            TConstArrayRef<TTokenType> tokens,
+            TVector<TTokenId>* tokenIds,
+            EUnknownTokenPolicy unknownTokenPolicy,
+            TBpeApplyScratch* scratch
+        ) const;
 
         TIntrusivePtr<TDictionary> Alphabet;
         TVector<TBpeUnit> BpeUnits;
         TVector<TString> StringTokens;
-        THashMap<std::pair<TTokenId, TTokenId>, TTokenId> SourceTokenIdsToTokenId;
+        NFH::TFlatHashMap<std::pair<TTokenId, TTokenId>, TTokenId> SourceTokenIdsToTokenId;
+        size_t WordCacheSize = DEFAULT_BPE_WORD_CACHE_SIZE;
+        THolder<TBpeWordCache> WordCache;
     };
 
     class TMMapBpeDictionary final : public IDictionary, public TMoveOnly {
@@ -3,6 +3,8 @@
 #include "frequency_based_dictionary_impl.h"
 #include "util.h"
 
+#include <library/cpp/threading/local_executor/local_executor.h>
+
 #include <util/charset/utf8.h>
 #include <util/generic/deque.h>
 #include <util/generic/hash_set.h>
@@ -27,11 +29,75 @@ namespace NTextProcessing::NDictionary {
         virtual void Add(TConstArrayRef<TStringBuf> tokens, ui64 weight) = 0;
         virtual TIntrusivePtr<TDictionary> FinishBuilding() = 0;
 
+        // rhs must have the same type and options, it is left in an unspecified state
+        virtual void Merge(IDictionaryBuilderImpl* rhs) = 0;
+
+        void SetMaxCountError(double maxCountError) {
+            Y_ENSURE(maxCountError >= 0.0 && maxCountError < 1.0, "maxCountError should be in [0, 1).");
+            MaxCountError = maxCountError;
+        }
+
         virtual ~IDictionaryBuilderImpl() = default;
     protected:
+        /*
+         * Lossy counting: every stored count is an upper bound of the exact one, a token which is absent
+         * has exact count of at most CountErrorBound, new entries start from CountErrorBound.
+         * So count - CountErrorBound is a lower bound of the exact count, it is compared with OccurrenceLowerBound.
+         * Returns true if entries with counts not greater than CountErrorBound should be pruned.
+         * */
+        bool UpdateCountErrorBound(ui64 addedWeight) {
+            TotalWeight += addedWeight;
+            const ui64 countErrorBound = MaxCountError * TotalWeight;
+            if (countErrorBound <= CountErrorBound) {
+                return false;
+            }
+            CountErrorBound = countErrorBound;
+            return true;
+        }
+
+        void AddCount(ui64 weight, ui64* count) const {
+            if (*count == 0) {
+                *count = CountErrorBound;
+            }
+            *count += weight;
+        }
+
+        // absent entries of both sides get the bound of the other side, present ones are summed
+        template <typename TCountMap, typename TGetKey>
+        void MergeCounts(const TCountMap& rhsCounts, ui64 rhsCountErrorBound, const TGetKey& getKey, TCountMap* counts) {
+            for (const auto& [rhsKey, rhsCount] : rhsCounts) {
+                AddCount(rhsCount - rhsCountErrorBound, &(*counts)[getKey(rhsKey)]);
+            }
+            if (rhsCountErrorBound > 0) {
+                for (auto& [key, count] : *counts) {
+                    count += rhsCountErrorBound;
+                }
+            }
+        }
+
+        void MergeCountErrorBounds(const IDictionaryBuilderImpl& rhs) {
+            TotalWeight += rhs.TotalWeight;
+            CountErrorBound += rhs.CountErrorBound;
+        }
+
+        template <typename TCountMap>
+        void Prune(TCountMap* counts) const {
+            TCountMap survivedCounts;
+            for (const auto& [key, count] : *counts) {
+                if (count > CountErrorBound) {
+                    survivedCounts.emplace(key, count);
+                }
+            }
+            *counts = std::move(survivedCounts);
+        }
+
         TDictionaryBuilderOptions DictionaryBuilderOptions;
         TDictionaryOptions DictionaryOptions;
         bool IsBuildingFinish = false;
+
+        double MaxCountError = 0.0;
+        ui64 TotalWeight = 0;
+        ui64 CountErrorBound = 0;
     };
 
     class TUnigramDictionaryBuilderImpl final : public IDictionaryBuilderImpl {
@@ -55,6 +121,7 @@ namespace NTextProcessing::NDictionary {
         }
 
         TIntrusivePtr<TDictionary> FinishBuilding() override;
+        void Merge(IDictionaryBuilderImpl* rhs) override;
     private:
         template <typename TTokenType>
         void AddImpl(TConstArrayRef<TTokenType> tokens, ui64 weight);
@@ -88,9 +155,11 @@ namespace NTextProcessing::NDictionary {
         }
 
         TIntrusivePtr<TDictionary> FinishBuilding() override;
+        void Merge(IDictionaryBuilderImpl* rhs) override;
     private:
         template <typename TTokenType>
         void AddImpl(TConstArrayRef<TTokenType> tokens, ui64 weight);
+        void PruneCounts();
         void Filter();
         void FilterInternalIdToTokenMapping();
 
@@ -109,13 +178,16 @@ namespace NTextProcessing::NDictionary {
 
     template <typename TTokenType>
     void TUnigramDictionaryBuilderImpl::AddImpl(TConstArrayRef<TTokenType> tokens, ui64 weight) {
+        ui64 addedTokenCount = 0;
         if (DictionaryOptions.TokenLevelType == ETokenLevelType::Word) {
             for (const auto& token : tokens) {
-                TokenToCount[token] += weight;
+                AddCount(weight, &TokenToCount[token]);
             }
+            addedTokenCount = tokens.size();
         } else {
             auto updateTokenToCountFunc = [&] (TStringBuf token) {
-                TokenToCount[token] += weight;
+                AddCount(weight, &TokenToCount[token]);
+                ++addedTokenCount;
             };
             ApplyFuncToLetterNGrams(
                 tokens,
@@ -124,6 +196,16 @@ namespace NTextProcessing::NDictionary {
                 updateTokenToCountFunc
             );
         }
+        if (UpdateCountErrorBound(addedTokenCount * weight)) {
+            Prune(&TokenToCount);
+        }
+    }
+
+    void TUnigramDictionaryBuilderImpl::Merge(IDictionaryBuilderImpl* rhs) {
+        auto* rhsImpl = static_cast<TUnigramDictionaryBuilderImpl*>(rhs);
+        MergeCounts(rhsImpl->TokenToCount, rhsImpl->CountErrorBound, [](const TString& token) -> const TString& { return token; }, &TokenToCount);
+        MergeCountErrorBounds(*rhsImpl);
+        rhsImpl->TokenToCount.clear();
     }
 
     TIntrusivePtr<TDictionary> TUnigramDictionaryBuilderImpl::FinishBuilding() {
@@ -133,7 +215,7 @@ namespace NTextProcessing::NDictionary {
         TVector<ui64> counts;
         TVector<TString> tokens;
         for (const auto& [key, value] : TokenToCount) {
-            if (value < DictionaryBuilderOptions.OccurrenceLowerBound) {
+            if (value < DictionaryBuilderOptions.OccurrenceLowerBound + CountErrorBound) {
                 continue;
             }
             counts.push_back(value);
@@ -209,11 +291,15 @@ namespace NTextProcessing::NDictionary {
                 const auto& token = tokens[gramIndex];
                 key[gramIndex] = GetInternalWordTokenId(token, &TokenToInternalId);
             }
-            InternalIdsToCount[key] += weight;
+            AddCount(weight, &InternalIdsToCount[key]);
 
             for (ui32 tokenIndex = GramOrder; tokenIndex < tokenCount; ++tokenIndex) {
                 ShiftAndAddId(GetInternalWordTokenId(tokens[tokenIndex], &TokenToInternalId), &key);
-                InternalIdsToCount[key] += weight;
+                AddCount(weight, &InternalIdsToCount[key]);
+            }
+            if (UpdateCountErrorBound((tokenCount - GramOrder + 1) * weight)) {
+                PruneCounts();
+                NeedToFilterInternalIdToTokenMapping = true;
             }
         } else {
             const auto endTokenIndex = GetEndTokenIndex(tokenCount, GramOrder, skipStep);
@@ -222,11 +308,74 @@ namespace NTextProcessing::NDictionary {
                     const auto& token = tokens[tokenIndex + gramIndex * (skipStep + 1)];
                     key[gramIndex] = GetInternalWordTokenId(token, &TokenToInternalId);
                 }
-                InternalIdsToCount[key] += weight;
+                AddCount(weight, &InternalIdsToCount[key]);
+            }
+            if (UpdateCountErrorBound(endTokenIndex * weight)) {
+                PruneCounts();
+                NeedToFilterInternalIdToTokenMapping = true;
             }
         }
     }
 
+    /*
+     * Drops n-grams with counts not greater than CountErrorBound together with the words which are left
+     * without n-grams. The surviving words are renumbered densely in the order of their first surviving
+     * n-gram, so new words still get TokenToInternalId.size() as their id.
+     * */
+    template <ui32 GramOrder>
+    void TMultigramDictionaryBuilderImpl<GramOrder>::PruneCounts() {
+        constexpr TInternalTokenId unusedId = Max<TInternalTokenId>();
+        TVector<TInternalTokenId> oldIdToNewId(TokenToInternalId.size(), unusedId);
+        TInternalTokenId newIdCount = 0;
+
+        TInternalIdsMap<GramOrder, ui64> survivedCounts;
+        for (const auto& [key, count] : InternalIdsToCount) {
+            if (count <= CountErrorBound) {
+                continue;
+            }
+            TMultiInternalTokenId<GramOrder> newKey;
+            for (ui32 gramIndex = 0; gramIndex < GramOrder; ++gramIndex) {
+                TInternalTokenId& newId = oldIdToNewId[key[gramIndex]];
+                if (newId == unusedId) {
+                    newId = newIdCount++;
+                }
+                newKey[gramIndex] = newId;
+            }
+            survivedCounts.emplace(newKey, count);
+        }
+        InternalIdsToCount = std::move(survivedCounts);
+
+        NFH::TFlatHashMap<TString, TInternalTokenId> survivedTokens;
+        survivedTokens.reserve(newIdCount);
+        for (auto& [token, id] : TokenToInternalId) {
+            if (oldIdToNewId[id] != unusedId) {
+                survivedTokens.emplace(token, oldIdToNewId[id]);
+            }
+        }
+        TokenToInternalId = std::move(survivedTokens);
+    }
+
+    // words dropped by Filter are removed from the mapping in FinishBuilding
+    template <ui32 GramOrder>
+    void TMultigramDictionaryBuilderImpl<GramOrder>::Merge(IDictionaryBuilderImpl* rhs) {
+        auto* rhsImpl = static_cast<TMultigramDictionaryBuilderImpl<GramOrder>*>(rhs);
+        TVector<TInternalTokenId> rhsIdToId(rhsImpl->TokenToInternalId.size());
+        for (const auto& [token, rhsId] : rhsImpl->TokenToInternalId) {
+            rhsIdToId[rhsId] = GetInternalWordTokenId(token, &TokenToInternalId);
+        }
+        const auto getKey = [&](const TMultiInternalTokenId<GramOrder>& rhsKey) {
+            TMultiInternalTokenId<GramOrder> key;
+            for (ui32 gramIndex = 0; gramIndex < GramOrder; ++gramIndex) {
+                key[gramIndex] = rhsIdToId[rhsKey[gramIndex]];
+            }
+            return key;
+        };
+        MergeCounts(rhsImpl->InternalIdsToCount, rhsImpl->CountErrorBound, getKey, &InternalIdsToCount);
+        MergeCountErrorBounds(*rhsImpl);
+        NeedToFilterInternalIdToTokenMapping |= rhsImpl->NeedToFilterInternalIdToTokenMapping;
+        rhsImpl->InternalIdsToCount.clear();
+    }
+
     template <ui32 GramOrder>
     static bool CompareNGram(
         const TMultiInternalTokenId<GramOrder>& leftNGram,
@@ -247,7 +396,7 @@ namespace NTextProcessing::NDictionary {
         TVector<ui64> counts;
         TVector<const TMultiInternalTokenId<GramOrder>*> keys;
         for (const auto& it : InternalIdsToCount) {
-            if (it.second < DictionaryBuilderOptions.OccurrenceLowerBound) {
+            if (it.second < DictionaryBuilderOptions.OccurrenceLowerBound + CountErrorBound) {
                 continue;
             }
             counts.push_back(it.second);
@@ -334,10 +483,7 @@ namespace NTextProcessing::NDictionary {
         return MakeIntrusive<TDictionary>(std::move(dictionaryImpl));
     }
 
-    TDictionaryBuilder::TDictionaryBuilder(TDictionaryBuilder&&) = default;
-    TDictionaryBuilder::~TDictionaryBuilder() = default;
-
-    TDictionaryBuilder::TDictionaryBuilder(
+    static THolder<IDictionaryBuilderImpl> MakeDictionaryBuilderImpl(
         const TDictionaryBuilderOptions& dictionaryBuilderOptions,
         const TDictionaryOptions& dictionaryOptions
     ) {
@@ -349,28 +495,34 @@ namespace NTextProcessing::NDictionary {
         );
 
         if (dictionaryOptions.GramOrder == 1 || dictionaryOptions.TokenLevelType == ETokenLevelType::Letter) {
-            DictionaryBuilderImpl = MakeHolder<TUnigramDictionaryBuilderImpl>(dictionaryBuilderOptions, dictionaryOptions);
-            return;
+            return MakeHolder<TUnigramDictionaryBuilderImpl>(dictionaryBuilderOptions, dictionaryOptions);
         }
 
         switch (dictionaryOptions.GramOrder) {
             case 2:
-                DictionaryBuilderImpl = MakeHolder<TMultigramDictionaryBuilderImpl<2>>(dictionaryBuilderOptions, dictionaryOptions);
-                break;
+                return MakeHolder<TMultigramDictionaryBuilderImpl<2>>(dictionaryBuilderOptions, dictionaryOptions);
             case 3:
-                DictionaryBuilderImpl = MakeHolder<TMultigramDictionaryBuilderImpl<3>>(dictionaryBuilderOptions, dictionaryOptions);
-                break;
+                return MakeHolder<TMultigramDictionaryBuilderImpl<3>>(dictionaryBuilderOptions, dictionaryOptions);
             case 4:
-                DictionaryBuilderImpl = MakeHolder<TMultigramDictionaryBuilderImpl<4>>(dictionaryBuilderOptions, dictionaryOptions);
-                break;
+                return MakeHolder<TMultigramDictionaryBuilderImpl<4>>(dictionaryBuilderOptions, dictionaryOptions);
             case 5:
-                DictionaryBuilderImpl = MakeHolder<TMultigramDictionaryBuilderImpl<5>>(dictionaryBuilderOptions, dictionaryOptions);
-                break;
+                return MakeHolder<TMultigramDictionaryBuilderImpl<5>>(dictionaryBuilderOptions, dictionaryOptions);
             default:
                 Y_ENSURE(false, "Unsupported gram order: " << dictionaryOptions.GramOrder << ".");
         }
     }
 
+    TDictionaryBuilder::TDictionaryBuilder(TDictionaryBuilder&&) = default;
+    TDictionaryBuilder::~TDictionaryBuilder() = default;
+
+    TDictionaryBuilder::TDictionaryBuilder(
+        const TDictionaryBuilderOptions& dictionaryBuilderOptions,
+        const TDictionaryOptions& dictionaryOptions
+    )
+        : DictionaryBuilderImpl(MakeDictionaryBuilderImpl(dictionaryBuilderOptions, dictionaryOptions))
+    {
+    }
+
     void TDictionaryBuilder::Add(TStringBuf token, ui64 weight) {
         DictionaryBuilderImpl->Add(token, weight);
     }
@@ -386,4 +538,59 @@ namespace NTextProcessing::NDictionary {
     TIntrusivePtr<TDictionary> TDictionaryBuilder::FinishBuilding() {
         return DictionaryBuilderImpl->FinishBuilding();
     }
+
+    TParallelDictionaryBuilder::TParallelDictionaryBuilder(TParallelDictionaryBuilder&&) = default;
+    TParallelDictionaryBuilder::~TParallelDictionaryBuilder() = default;
+
+    TParallelDictionaryBuilder::TParallelDictionaryBuilder(
+        const TDictionaryBuilderOptions& dictionaryBuilderOptions,
+        const TDictionaryOptions& dictionaryOptions,
+        NPar::ILocalExecutor* localExecutor,
+        double maxCountError
+    )
+        : LocalExecutor(localExecutor)
+    {
+        const int blockCount = localExecutor ? localExecutor->GetThreadCount() + 1 : 1;
+        for (int blockId = 0; blockId < blockCount; ++blockId) {
+            DictionaryBuilderImpls.push_back(MakeDictionaryBuilderImpl(dictionaryBuilderOptions, dictionaryOptions));
+            DictionaryBuilderImpls.back()->SetMaxCountError(maxCountError);
+        }
+    }
+
+    template <typename TTokenType>
+    void TParallelDictionaryBuilder::AddImpl(TConstArrayRef<TVector<TTokenType>> sentences, ui64 weight) {
+        const int blockCount = DictionaryBuilderImpls.size();
+        const size_t blockSize = CeilDiv<size_t>(sentences.size(), blockCount);
+        const auto addBlock = [&](int blockId) {
+            const size_t begin = Min(blockId * blockSize, sentences.size());
+            const size_t end = Min(begin + blockSize, sentences.size());
+            for (size_t i = begin; i < end; ++i) {
+                DictionaryBuilderImpls[blockId]->Add(TConstArrayRef<TTokenType>(sentences[i]), weight);
+            }
+        };
+        if (LocalExecutor && blockCount > 1) {
+            LocalExecutor->ExecRangeWithThrow(addBlock, 0, blockCount, NPar::TLocalExecutor::WAIT_COMPLETE);
+        } else {
+            addBlock(0);
+        }
+    }
+
+    void TParallelDictionaryBuilder::Add(TConstArrayRef<TVector<TString>> sentences, ui64 weight) {
+        AddImpl(sentences, weight);
+    }
+
+    void TParallelDictionaryBuilder::Add(TConstArrayRef<TVector<TStringBuf>> sentences, ui64 weight) {
+        AddImpl(sentences, weight);
+    }
+
+    TIntrusivePtr<TDictionary> TParallelDictionaryBuilder::FinishBuilding() {
+        Y_ENSURE(!DictionaryBuilderImpls.empty(), "FinishBuilding method should be called only once.");
+        for (size_t blockId = 1; blockId < DictionaryBuilderImpls.size(); ++blockId) {
+            DictionaryBuilderImpls[0]->Merge(DictionaryBuilderImpls[blockId].Get());
+            DictionaryBuilderImpls[blockId].Reset();
+        }
+        auto dictionary = DictionaryBuilderImpls[0]->FinishBuilding();
+        DictionaryBuilderImpls.clear();
+        return dictionary;
+    }
 }
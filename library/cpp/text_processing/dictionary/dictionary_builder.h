@@ -5,6 +5,10 @@
 
 #include <util/generic/array_ref.h>
 
+namespace NPar {
+    class ILocalExecutor;
+}
+
 namespace NTextProcessing::NDictionary {
     class IDictionaryBuilderImpl;
 
@@ -41,4 +45,46 @@ namespace NTextProcessing::NDictionary {
     private:
         THolder<IDictionaryBuilderImpl> DictionaryBuilderImpl;
     };
+
+    /*
+     * Builds the same dictionary as TDictionaryBuilder on all threads of localExecutor:
+     * every batch of sentences is split into blocks, every block is counted by its own
+     * partial builder, partial builders are merged in FinishBuilding.
+     *
+     * maxCountError > 0 bounds memory with lossy counting: every partial builder drops the entries
+     * with counts below maxCountError * (total weight of its tokens) from time to time, so it keeps
+     * O(log(maxCountError * totalWeight) / maxCountError) entries. Counts of the resulting dictionary
+     * are upper bounds which exceed exact counts by at most maxCountError * (total weight of all tokens),
+     * a token gets into the dictionary only if its exact count is guaranteed to reach OccurrenceLowerBound,
+     * so a token with exact count of at least OccurrenceLowerBound + that bound is never lost.
+     * maxCountError = 0 means exact counting.
+     * Example:
+     *      TParallelDictionaryBuilder dictionaryBuilder(builderOptions, dictionaryOptions, &localExecutor);
+     *      TVector<TVector<TString>> sentences = {{"he", "likes", "apples"}, {"she", "does", "not"}};
+     *      dictionaryBuilder.Add(sentences);
+     * */
+    class TParallelDictionaryBuilder: public TMoveOnly {
+    public:
+        TParallelDictionaryBuilder(TParallelDictionaryBuilder&&);
+        ~TParallelDictionaryBuilder();
+
+        TParallelDictionaryBuilder(
+            const TDictionaryBuilderOptions& dictionaryBuilderOptions,
+            const TDictionaryOptions& dictionaryOptions,
+            NPar::ILocalExecutor* localExecutor,
+            double maxCountError = 0.0
+        );
+
+        void Add(TConstArrayRef<TVector<TString>> sentences, ui64 weight = 1);
+        void Add(TConstArrayRef<TVector<TStringBuf>> sentences, ui64 weight = 1);
+
+        TIntrusivePtr<TDictionary> FinishBuilding();
+
+    private:
+        template <typename TTokenType>
+        void AddImpl(TConstArrayRef<TVector<TTokenType>> sentences, ui64 weight);
+
+        NPar::ILocalExecutor* LocalExecutor;
+        TVector<THolder<IDictionaryBuilderImpl>> DictionaryBuilderImpls;
+    };
 }
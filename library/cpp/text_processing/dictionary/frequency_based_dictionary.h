@@ -46,6 +46,7 @@ namespace NTextProcessing::NDictionary {
 
     private:
         friend class TMMapDictionary;
+        friend class TMMapPerfectHashDictionary;
 
         THolder<IDictionaryImpl> DictionaryImpl;
     };
@@ -218,6 +218,14 @@ void TUnigramDictionaryImpl::Load(IInputStream* stream, bool isNewFormat) {
     InitializeSpecialTokenIds();
 }
 
+void TUnigramDictionaryImpl::GetIdToToken(TVector<TStringBuf>* idToToken) const {
+    if (IdToToken.empty()) {
+        GetIdToTokenMapping(TokenToId, idToToken);
+    } else {
+        *idToToken = IdToToken;
+    }
+}
+
 THolder<IMMapDictionaryImpl> TUnigramDictionaryImpl::CreateMMapDictionaryImpl() const {
     TVector<TStringBuf> idToToken;
     if (IdToToken.empty()) {
@@ -62,6 +62,9 @@ namespace NTextProcessing::NDictionary {
 
         virtual THolder<IMMapDictionaryImpl> CreateMMapDictionaryImpl() const = 0;
 
+        // Tokens in the order of their ids, only for dictionaries of single tokens.
+        virtual void GetIdToToken(TVector<TStringBuf>* idToToken) const = 0;
+
         virtual ~IDictionaryImpl() = default;
 
     protected:
@@ -121,6 +124,8 @@ namespace NTextProcessing::NDictionary {
 
         THolder<IMMapDictionaryImpl> CreateMMapDictionaryImpl() const override;
 
+        void GetIdToToken(TVector<TStringBuf>* idToToken) const override;
+
     private:
         void InitializeSpecialTokenIds() {
             UnknownTokenId = TokenToId.size() + DictionaryOptions.StartTokenId;
@@ -366,6 +371,10 @@ namespace NTextProcessing::NDictionary {
             InitializeSpecialTokenIds();
         }
 
+        void GetIdToToken(TVector<TStringBuf>* /*idToToken*/) const override {
+            Y_ENSURE(false, "Unsupported for Word Multigram dictionary.");
+        }
+
         THolder<IMMapDictionaryImpl> CreateMMapDictionaryImpl() const override {
             TVector<TBucket> tokenToInternalIdBuckets;
             ui64 tokenToInternalIdBucketsSeed;
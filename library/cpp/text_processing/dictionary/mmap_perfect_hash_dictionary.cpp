@@ -0,0 +1,350 @@
+#include "fbs_helpers.h"
+#include "frequency_based_dictionary_impl.h"
+#include "mmap_perfect_hash_dictionary.h"
+#include "serialization_helpers.h"
+#include "util.h"
+
+#include <library/cpp/text_processing/dictionary/idl/dictionary_meta_info.fbs.h>
+
+#include <util/digest/murmur.h>
+#include <util/generic/buffer.h>
+#include <util/generic/xrange.h>
+#include <util/stream/buffer.h>
+#include <util/system/align.h>
+#include <util/system/compiler.h>
+
+using namespace NTextProcessing::NDictionary;
+
+static const char PERFECT_HASH_MAGIC[] = "PHashDictionary";
+static const size_t PERFECT_HASH_MAGIC_SIZE = Y_ARRAY_SIZE(PERFECT_HASH_MAGIC);  // with terminating zero
+static_assert(PERFECT_HASH_MAGIC_SIZE == 16);
+
+static const size_t LOOKUP_GROUP_SIZE = 16;
+
+// all arrays are aligned to 8 bytes relative to the beginning of the data
+static void WriteArray(const void* data, ui64 size, IOutputStream* stream) {
+    stream->Write(data, size);
+    AddPadding(AlignUpSpace<ui64>(size, 8), stream);
+}
+
+// every length is checked against the rest of the data before anything is read
+static void Skip(ui64 size, const ui8** ptr, const ui8* end) {
+    Y_ENSURE(size <= static_cast<ui64>(end - *ptr) && AlignUp<ui64>(size, 8) <= static_cast<ui64>(end - *ptr), "Incorrect data");
+    *ptr += AlignUp<ui64>(size, 8);
+}
+
+template <typename T>
+static TConstArrayRef<T> ReadArray(ui64 count, const ui8** ptr, const ui8* end) {
+    const T* begin = reinterpret_cast<const T*>(*ptr);
+    Y_ENSURE(count <= static_cast<ui64>(end - *ptr) / sizeof(T), "Incorrect data");
+    Skip(count * sizeof(T), ptr, end);
+    return MakeArrayRef(begin, count);
+}
+
+static ui64 ReadValue(const ui8** ptr, const ui8* end) {
+    const ui8* value = *ptr;
+    Skip(8, ptr, end);
+    return *reinterpret_cast<const ui64*>(value);
+}
+
+TMMapPerfectHashDictionary::TMMapPerfectHashDictionary() = default;
+
+TMMapPerfectHashDictionary::TMMapPerfectHashDictionary(TIntrusiveConstPtr<TDictionary> dictionary) {
+    TVector<TStringBuf> idToToken;
+    dictionary->DictionaryImpl->GetIdToToken(&idToToken);
+
+    const NPerfectHash::TLayout layout(idToToken.size());
+    TVector<ui64> hashes(idToToken.size());
+    TVector<ui32> pilots;
+    TVector<ui32> remap;
+    TVector<ui32> slotToTokenIndex;
+    ui64 seed = 0;
+    for (; seed < NPerfectHash::MAX_SEED_CHOICE_COUNT; ++seed) {
+        for (auto tokenIndex : xrange(idToToken.size())) {
+            hashes[tokenIndex] = MurmurHash<ui64>(idToToken[tokenIndex].data(), idToToken[tokenIndex].size(), seed);
+        }
+        if (NPerfectHash::Build(hashes, layout, &pilots, &remap, &slotToTokenIndex)) {
+            break;
+        }
+    }
+    Y_ENSURE(seed < NPerfectHash::MAX_SEED_CHOICE_COUNT, "Couldn't find a perfect hash.");
+
+    const auto& dictionaryOptions = dictionary->GetDictionaryOptionsRef();
+    TVector<TPerfectHashSlot> slots(slotToTokenIndex.size());
+    for (auto slot : xrange(slots.size())) {
+        const ui32 tokenIndex = slotToTokenIndex[slot];
+        slots[slot] = {NPerfectHash::Fingerprint(hashes[tokenIndex]), dictionaryOptions.StartTokenId + tokenIndex};
+    }
+
+    TVector<ui32> tokenOffsets(1, 0);
+    tokenOffsets.reserve(idToToken.size() + 1);
+    for (TStringBuf token : idToToken) {
+        Y_ENSURE(tokenOffsets.back() + token.size() <= Max<ui32>(), "Tokens are too long for perfect hash dictionary.");
+        tokenOffsets.push_back(tokenOffsets.back() + token.size());
+    }
+
+    TVector<ui8> dictionaryMetaInfoBuffer;
+    BuildDictionaryMetaInfo(idToToken.size(), dictionaryOptions, &dictionaryMetaInfoBuffer);
+
+    TBufferOutput body;
+    WriteLittleEndian<ui64>(dictionaryMetaInfoBuffer.size(), &body);
+    WriteArray(dictionaryMetaInfoBuffer.data(), dictionaryMetaInfoBuffer.size(), &body);
+    WriteLittleEndian<ui64>(seed, &body);
+    WriteLittleEndian<ui64>(slots.size(), &body);
+    WriteLittleEndian<ui64>(layout.GetTableSize(), &body);
+    WriteLittleEndian<ui64>(pilots.size(), &body);
+    WriteLittleEndian<ui64>(tokenOffsets.back(), &body);
+    WriteArray(pilots.data(), pilots.size() * sizeof(ui32), &body);
+    WriteArray(remap.data(), remap.size() * sizeof(ui32), &body);
+    WriteArray(slots.data(), slots.size() * sizeof(TPerfectHashSlot), &body);
+    WriteArray(tokenOffsets.data(), tokenOffsets.size() * sizeof(ui32), &body);
+    for (TStringBuf token : idToToken) {
+        body.Write(token.data(), token.size());
+    }
+    AddPadding(AlignUpSpace<ui64>(tokenOffsets.back(), 8), &body);
+
+    TBufferOutput output;
+    output.Write(PERFECT_HASH_MAGIC, PERFECT_HASH_MAGIC_SIZE);
+    WriteLittleEndian<ui64>(8 + body.Buffer().Size(), &output);
+    output.Write(body.Buffer().Data(), body.Buffer().Size());
+    Data = TBlob::FromBuffer(output.Buffer());
+    InitFromData();
+}
+
+TMMapPerfectHashDictionary::TMMapPerfectHashDictionary(const void* data, size_t size) {
+    InitFromMemory(data, size);
+}
+
+TMMapPerfectHashDictionary::TMMapPerfectHashDictionary(TBlob data)
+    : Data(std::move(data))
+{
+    InitFromData();
+}
+
+const TPerfectHashSlot& TMMapPerfectHashDictionary::GetSlot(ui64 hash, ui32 pilot) const {
+    const ui32 position = Layout.Position(hash, pilot);
+    return Slots[position < Slots.size() ? position : Remap[position - Slots.size()]];
+}
+
+TTokenId TMMapPerfectHashDictionary::FindTokenId(TStringBuf token) const {
+    if (Slots.empty()) {
+        return UnknownTokenId;
+    }
+    const ui64 hash = MurmurHash<ui64>(token.data(), token.size(), Seed);
+    const auto& slot = GetSlot(hash, Pilots[Layout.Bucket(hash)]);
+    return slot.Fingerprint == NPerfectHash::Fingerprint(hash) ? slot.TokenId : UnknownTokenId;
+}
+
+TTokenId TMMapPerfectHashDictionary::Apply(TStringBuf token) const {
+    return FindTokenId(token);
+}
+
+template <typename TTokenType>
+void TMMapPerfectHashDictionary::ApplyImpl(
+    TConstArrayRef<TTokenType> tokens,
+    EUnknownTokenPolicy unknownTokenPolicy,
+    TVector<TTokenId>* tokenIds
+) const {
+    tokenIds->clear();
+
+    auto applyFunc = [&](TStringBuf token) {
+        const TTokenId tokenId = FindTokenId(token);
+        if (tokenId != UnknownTokenId || unknownTokenPolicy == EUnknownTokenPolicy::Insert) {
+            tokenIds->push_back(tokenId);
+        }
+    };
+
+    if (DictionaryOptions.TokenLevelType == ETokenLevelType::Word) {
+        tokenIds->reserve(tokens.size() + 1);
+        if (Slots.empty()) {
+            for (const auto& token : tokens) {
+                applyFunc(token);
+            }
+        } else {
+            // pilots and slots of a group are prefetched before they are read,
+            // so the cache misses of independent tokens overlap
+            ui64 hashes[LOOKUP_GROUP_SIZE];
+            const TPerfectHashSlot* slots[LOOKUP_GROUP_SIZE];
+            for (size_t groupBegin = 0; groupBegin < tokens.size(); groupBegin += LOOKUP_GROUP_SIZE) {
+                const size_t groupSize = Min(LOOKUP_GROUP_SIZE, tokens.size() - groupBegin);
+                for (auto i : xrange(groupSize)) {
+                    const TStringBuf token = tokens[groupBegin + i];
+                    hashes[i] = MurmurHash<ui64>(token.data(), token.size(), Seed);
+                    Y_PREFETCH_READ(&Pilots[Layout.Bucket(hashes[i])], 3);
+                }
+                for (auto i : xrange(groupSize)) {
+                    slots[i] = &GetSlot(hashes[i], Pilots[Layout.Bucket(hashes[i])]);
+                    Y_PREFETCH_READ(slots[i], 3);
+                }
+                for (auto i : xrange(groupSize)) {
+                    const TTokenId tokenId = slots[i]->Fingerprint == NPerfectHash::Fingerprint(hashes[i])
+                        ? slots[i]->TokenId
+                        : UnknownTokenId;
+                    if (tokenId != UnknownTokenId || unknownTokenPolicy == EUnknownTokenPolicy::Insert) {
+                        tokenIds->push_back(tokenId);
+                    }
+                }
+            }
+        }
+        if (DictionaryOptions.EndOfSentenceTokenPolicy == EEndOfSentenceTokenPolicy::Insert) {
+            tokenIds->push_back(EndOfSentenceTokenId);
+        }
+    } else {
+        ApplyFuncToLetterNGrams(
+            tokens,
+            DictionaryOptions.GramOrder,
+            DictionaryOptions.EndOfWordTokenPolicy == EEndOfWordTokenPolicy::Insert,
+            applyFunc
+        );
+    }
+}
+
+void TMMapPerfectHashDictionary::Apply(
+    TConstArrayRef<TString> tokens,
+    TVector<TTokenId>* tokenIds,
+    EUnknownTokenPolicy unknownTokenPolicy
+) const {
+    ApplyImpl(tokens, unknownTokenPolicy, tokenIds);
+}
+
+void TMMapPerfectHashDictionary::Apply(
+    TConstArrayRef<TStringBuf> tokens,
+    TVector<TTokenId>* tokenIds,
+    EUnknownTokenPolicy unknownTokenPolicy
+) const {
+    ApplyImpl(tokens, unknownTokenPolicy, tokenIds);
+}
+
+ui32 TMMapPerfectHashDictionary::Size() const {
+    return DictionarySize;
+}
+
+TString TMMapPerfectHashDictionary::GetToken(TTokenId tokenId) const {
+    if (tokenId == GetEndOfSentenceTokenId()) {
+        return "_EOS_";
+    } else if (tokenId == GetUnknownTokenId()) {
+        return "_UNK_";
+    }
+
+    Y_ENSURE(DictionaryOptions.StartTokenId <= tokenId && tokenId < GetMinUnusedTokenId(), "Invalid tokenId.");
+    const ui32 tokenIndex = tokenId - DictionaryOptions.StartTokenId;
+    const ui32 begin = TokenOffsets[tokenIndex];
+    const ui32 end = TokenOffsets[tokenIndex + 1];
+    Y_ENSURE(begin <= end && end <= TokenOffsets.back(), "Incorrect data");
+    return TString(TokenPool + begin, end - begin);
+}
+
+ui64 TMMapPerfectHashDictionary::GetCount(TTokenId) const {
+    Y_ENSURE(false, "Unsupported method");
+}
+
+TVector<TString> TMMapPerfectHashDictionary::GetTopTokens(ui32 topSize) const {
+    TVector<TString> result;
+    for (auto tokenIndex : xrange(Min(topSize, DictionarySize))) {
+        result.push_back(GetToken(DictionaryOptions.StartTokenId + tokenIndex));
+    }
+    return result;
+}
+
+void TMMapPerfectHashDictionary::ClearStatsData() {
+    Y_ENSURE(false, "Unsupported method");
+}
+
+TTokenId TMMapPerfectHashDictionary::GetUnknownTokenId() const {
+    return UnknownTokenId;
+}
+
+TTokenId TMMapPerfectHashDictionary::GetEndOfSentenceTokenId() const {
+    return EndOfSentenceTokenId;
+}
+
+TTokenId TMMapPerfectHashDictionary::GetMinUnusedTokenId() const {
+    return EndOfSentenceTokenId + 1;
+}
+
+const TDictionaryOptions& TMMapPerfectHashDictionary::GetDictionaryOptionsRef() const {
+    return DictionaryOptions;
+}
+
+void TMMapPerfectHashDictionary::Save(IOutputStream* stream) const {
+    stream->Write(Data.Data(), Data.Size());
+}
+
+void TMMapPerfectHashDictionary::Load(IInputStream* stream) {
+    char magic[PERFECT_HASH_MAGIC_SIZE];
+    stream->LoadOrFail(magic, PERFECT_HASH_MAGIC_SIZE);
+    Y_ENSURE(!std::memcmp(magic, PERFECT_HASH_MAGIC, PERFECT_HASH_MAGIC_SIZE));
+    ui64 totalSize;
+    ReadLittleEndian(&totalSize, stream);
+    Y_ENSURE(totalSize >= 8, "Incorrect data");
+
+    TBuffer buffer(PERFECT_HASH_MAGIC_SIZE + totalSize);
+    buffer.Append(magic, PERFECT_HASH_MAGIC_SIZE);
+    buffer.Append(reinterpret_cast<const char*>(&totalSize), sizeof(totalSize));
+    buffer.Advance(totalSize - 8);
+    stream->LoadOrFail(buffer.Data() + PERFECT_HASH_MAGIC_SIZE + 8, totalSize - 8);
+    Data = TBlob::FromBuffer(buffer);
+    InitFromData();
+}
+
+void TMMapPerfectHashDictionary::InitFromMemory(const void* data, size_t size) {
+    Data = TBlob::NoCopy(data, size);
+    InitFromData();
+}
+
+void TMMapPerfectHashDictionary::InitFromData() {
+    const ui8* const begin = reinterpret_cast<const ui8*>(Data.Data());
+    Y_ENSURE(reinterpret_cast<uintptr_t>(begin) % 8 == 0, "Perfect hash dictionary data should be aligned to 8 bytes.");
+    Y_ENSURE(CalculateExpectedSize(begin, Data.Size()) == Data.Size(), "Incorrect data");
+    const ui8* const end = begin + Data.Size();
+    const ui8* ptr = begin + PERFECT_HASH_MAGIC_SIZE + 8;
+
+    const ui64 dictionaryMetaInfoBufferSize = ReadValue(&ptr, end);
+    const ui8* dictionaryMetaInfoBuffer = ptr;
+    Skip(dictionaryMetaInfoBufferSize, &ptr, end);
+    flatbuffers::Verifier verifier(dictionaryMetaInfoBuffer, dictionaryMetaInfoBufferSize);
+    Y_ENSURE(NTextProcessingFbs::VerifyTDictionaryMetaInfoBuffer(verifier), "Incorrect data");
+    const auto* dictionaryMetaInfo = NTextProcessingFbs::GetTDictionaryMetaInfo(dictionaryMetaInfoBuffer);
+    const auto* dictionaryOptions = dictionaryMetaInfo->DictionaryOptions();
+    Y_ENSURE(dictionaryOptions, "Incorrect data");
+    DictionaryOptions.TokenLevelType = FromFbs(dictionaryOptions->TokenLevelType());
+    DictionaryOptions.GramOrder = dictionaryOptions->GramOrder();
+    DictionaryOptions.SkipStep = dictionaryOptions->SkipStep();
+    DictionaryOptions.StartTokenId = dictionaryOptions->StartTokenId();
+    DictionaryOptions.EndOfWordTokenPolicy = FromFbs(dictionaryOptions->EndOfWordTokenPolicy());
+    DictionaryOptions.EndOfSentenceTokenPolicy = FromFbs(dictionaryOptions->EndOfSentenceTokenPolicy());
+    DictionarySize = dictionaryMetaInfo->DictionarySize();
+    UnknownTokenId = dictionaryMetaInfo->UnknownTokenId();
+    EndOfSentenceTokenId = dictionaryMetaInfo->EndOfSentenceTokenId();
+    Y_ENSURE(
+        UnknownTokenId == ui64(DictionaryOptions.StartTokenId) + DictionarySize && EndOfSentenceTokenId == ui64(UnknownTokenId) + 1,
+        "Incorrect data"
+    );
+
+    Seed = ReadValue(&ptr, end);
+    const ui64 slotCount = ReadValue(&ptr, end);
+    const ui64 tableSize = ReadValue(&ptr, end);
+    const ui64 bucketCount = ReadValue(&ptr, end);
+    const ui64 tokenPoolSize = ReadValue(&ptr, end);
+    Y_ENSURE(slotCount == DictionarySize && tableSize <= Max<ui32>() && bucketCount <= Max<ui32>(), "Incorrect data");
+    Layout = NPerfectHash::TLayout(slotCount, tableSize, bucketCount);
+    Pilots = ReadArray<ui32>(bucketCount, &ptr, end);
+    Remap = ReadArray<ui32>(Layout.GetRemapSize(), &ptr, end);
+    Slots = ReadArray<TPerfectHashSlot>(slotCount, &ptr, end);
+    TokenOffsets = ReadArray<ui32>(slotCount + 1, &ptr, end);
+    TokenPool = reinterpret_cast<const char*>(ptr);
+    Skip(tokenPoolSize, &ptr, end);
+    Y_ENSURE(ptr == end && TokenOffsets.back() == tokenPoolSize, "Incorrect data");
+    for (ui32 slot : Remap) {
+        Y_ENSURE(slot < slotCount, "Incorrect data");
+    }
+}
+
+size_t TMMapPerfectHashDictionary::CalculateExpectedSize(const void* data, size_t size) {
+    const ui8* ptr = reinterpret_cast<const ui8*>(data);
+    Y_ENSURE(size >= PERFECT_HASH_MAGIC_SIZE + 8);
+    Y_ENSURE(!std::memcmp(ptr, PERFECT_HASH_MAGIC, PERFECT_HASH_MAGIC_SIZE));
+    const ui64 totalSize = *reinterpret_cast<const ui64*>(ptr + PERFECT_HASH_MAGIC_SIZE);
+    Y_ENSURE(totalSize >= 8 && totalSize <= size - PERFECT_HASH_MAGIC_SIZE);
+    return totalSize + PERFECT_HASH_MAGIC_SIZE;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "frequency_based_dictionary.h"
+#include "options.h"
+
+#include <library/cpp/containers/perfect_hash/perfect_hash.h>
+
+#include <util/memory/blob.h>
+
+namespace NTextProcessing::NDictionary {
+
+    struct TPerfectHashSlot {
+        ui32 Fingerprint = 0;
+        TTokenId TokenId = 0;
+    };
+
+    /* Read-only dictionary of words or letter n-grams which is used right from its serialized data.
+     *
+     * Tokens are found with a minimal perfect hash: Apply computes one hash of a token and reads one pilot
+     * and one slot with a 32-bit fingerprint of the token, so an unknown token is mistaken for a known one
+     * with probability 2^-32. Tokens are kept in a contiguous string pool ordered by id for GetToken.
+     * Nothing is built on loading from memory, so a file mapped with TBlob::FromFile is shared by all
+     * processes that map it. Word multigram dictionaries aren't supported.
+     */
+    class TMMapPerfectHashDictionary final : public IDictionary, public TMoveOnly {
+    public:
+        TMMapPerfectHashDictionary();
+        explicit TMMapPerfectHashDictionary(TIntrusiveConstPtr<TDictionary> dictionary);
+        // data isn't copied and must outlive the dictionary
+        TMMapPerfectHashDictionary(const void* data, size_t size);
+        explicit TMMapPerfectHashDictionary(TBlob data);
+
+        TTokenId Apply(const TStringBuf token) const override;
+
+        void Apply(
+            TConstArrayRef<TString> tokens,
+            TVector<TTokenId>* tokenIds,
+            EUnknownTokenPolicy unknownTokenPolicy = EUnknownTokenPolicy::Skip
+        ) const override;
+        void Apply(
+            TConstArrayRef<TStringBuf> tokens,
+            TVector<TTokenId>* tokenIds,
+            EUnknownTokenPolicy unknownTokenPolicy = EUnknownTokenPolicy::Skip
+        ) const override;
+
+        ui32 Size() const override;
+
+        TString GetToken(TTokenId tokenId) const override;
+        ui64 GetCount(TTokenId tokenId) const override;
+        TVector<TString> GetTopTokens(ui32 topSize = 10) const override;
+
+        void ClearStatsData() override;
+
+        TTokenId GetUnknownTokenId() const override;
+        TTokenId GetEndOfSentenceTokenId() const override;
+        TTokenId GetMinUnusedTokenId() const override;
+
+        const TDictionaryOptions& GetDictionaryOptionsRef() const;
+
+        void Save(IOutputStream* stream) const override;
+        void Load(IInputStream* stream);
+
+        void InitFromMemory(const void* data, size_t size);
+
+        static size_t CalculateExpectedSize(const void* data, size_t size);
+
+    private:
+        void InitFromData();
+
+        TTokenId FindTokenId(TStringBuf token) const;
+        const TPerfectHashSlot& GetSlot(ui64 hash, ui32 pilot) const;
+
+        template <typename TTokenType>
+        void ApplyImpl(
+            TConstArrayRef<TTokenType> tokens,
+            EUnknownTokenPolicy unknownTokenPolicy,
+            TVector<TTokenId>* tokenIds
+        ) const;
+
+        TBlob Data;
+        TDictionaryOptions DictionaryOptions;
+        ui32 DictionarySize = 0;
+        TTokenId UnknownTokenId = 0;
+        TTokenId EndOfSentenceTokenId = 0;
+        ui64 Seed = 0;
+        NPerfectHash::TLayout Layout;
+        TConstArrayRef<ui32> Pilots;
+        TConstArrayRef<ui32> Remap;
+        TConstArrayRef<TPerfectHashSlot> Slots;
+        TConstArrayRef<ui32> TokenOffsets;
+        const char* TokenPool = nullptr;
+    };
+
+}
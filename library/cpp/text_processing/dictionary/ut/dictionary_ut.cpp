@@ -2,11 +2,17 @@
 #include <library/cpp/text_processing/dictionary/dictionary_builder.h>
 #include <library/cpp/text_processing/dictionary/frequency_based_dictionary.h>
 #include <library/cpp/text_processing/dictionary/mmap_frequency_based_dictionary.h>
+#include <library/cpp/text_processing/dictionary/mmap_perfect_hash_dictionary.h>
 
 #include <library/cpp/threading/local_executor/local_executor.h>
 #include <library/cpp/testing/unittest/registar.h>
 
+#include <util/generic/hash.h>
 #include <util/memory/blob.h>
+#include <util/random/fast.h>
+#include <util/stream/str.h>
+#include <util/string/cast.h>
+#include <util/string/split.h>
 
 using NTextProcessing::NDictionary::IDictionary;
 using NTextProcessing::NDictionary::TBpeDictionary;
@@ -14,9 +20,11 @@ using NTextProcessing::NDictionary::TBpeDictionaryBuilder;
 using NTextProcessing::NDictionary::TDictionary;
 using NTextProcessing::NDictionary::TMMapBpeDictionary;
 using NTextProcessing::NDictionary::TMMapDictionary;
+using NTextProcessing::NDictionary::TMMapPerfectHashDictionary;
 using NTextProcessing::NDictionary::TDictionaryOptions;
 using NTextProcessing::NDictionary::TDictionaryBuilderOptions;
 using NTextProcessing::NDictionary::TDictionaryBuilder;
+using NTextProcessing::NDictionary::TParallelDictionaryBuilder;
 using NTextProcessing::NDictionary::ETokenLevelType;
 using NTextProcessing::NDictionary::TTokenId;
 using NTextProcessing::NDictionary::EUnknownTokenPolicy;
@@ -44,6 +52,24 @@ static auto GetApplyToAllDictsFunc(TDictionaryBuilder dictionaryBuilder, TBlob*
     dicts->emplace_back(restoredMmapDictionary);
     dicts->emplace_back(restoredFromMemoryMmapDictionary);
 
+    const auto& dictionaryOptions = dictionary->GetDictionaryOptionsRef();
+    if (dictionaryOptions.TokenLevelType == ETokenLevelType::Letter || dictionaryOptions.GramOrder == 1) {
+        auto perfectHashDictionary = MakeIntrusive<TMMapPerfectHashDictionary>(dictionary);
+        TStringStream perfectHashStream;
+        perfectHashDictionary->Save(&perfectHashStream);
+        auto restoredPerfectHashDictionary = MakeIntrusive<TMMapPerfectHashDictionary>();
+        restoredPerfectHashDictionary->Load(&perfectHashStream);
+
+        restoredPerfectHashDictionary->Save(&perfectHashStream);
+        auto restoredFromBlobPerfectHashDictionary = MakeIntrusive<TMMapPerfectHashDictionary>(
+            TBlob::FromStream(perfectHashStream)
+        );
+
+        dicts->emplace_back(perfectHashDictionary);
+        dicts->emplace_back(restoredPerfectHashDictionary);
+        dicts->emplace_back(restoredFromBlobPerfectHashDictionary);
+    }
+
     return [=] (const std::function<void(IDictionary*)>& callback) {
         for (const auto& d : *dicts) {
             callback(d.Get());
@@ -90,6 +116,64 @@ static auto GetApplyToAllBpeDictsFunc(
     };
 }
 
+// sentences of words with skewed frequencies: word i occurs roughly as often as 1 / sqrt(i)
+static TVector<TVector<TString>> GenerateSentences(size_t sentenceCount, ui32 wordCount, ui64 seed) {
+    TFastRng<ui64> rng(seed);
+    TVector<TVector<TString>> sentences(sentenceCount);
+    for (auto& sentence : sentences) {
+        sentence.resize(1 + rng.Uniform(20));
+        for (auto& word : sentence) {
+            const ui64 index = rng.Uniform(wordCount);
+            word = "w" + ToString(index * index / wordCount);
+        }
+    }
+    return sentences;
+}
+
+static void AssertEqualDictionaries(const IDictionary& expected, const IDictionary& actual) {
+    UNIT_ASSERT_VALUES_EQUAL(expected.Size(), actual.Size());
+    for (TTokenId tokenId = 0; tokenId < expected.Size(); ++tokenId) {
+        UNIT_ASSERT_VALUES_EQUAL(expected.GetToken(tokenId), actual.GetToken(tokenId));
+        UNIT_ASSERT_VALUES_EQUAL(expected.GetCount(tokenId), actual.GetCount(tokenId));
+    }
+}
+
+// merges the leftmost occurrence of the unit with the smallest id until no unit is left
+static TVector<TTokenId> ApplyBpeNaively(
+    const TBpeDictionary& bpeDictionary,
+    const TVector<TString>& sentence,
+    EUnknownTokenPolicy unknownTokenPolicy
+) {
+    THashMap<std::pair<TTokenId, TTokenId>, TTokenId> units;
+    TStringStream stream;
+    bpeDictionary.Save(&stream);
+    TString line;
+    TTokenId unitId = bpeDictionary.GetAlphabet()->GetMinUnusedTokenId();
+    while (stream.ReadLine(line)) {
+        TVector<TString> fields = StringSplitter(line).Split('\t').Limit(4);
+        units[std::make_pair(FromString<TTokenId>(fields[0]), FromString<TTokenId>(fields[1]))] = unitId++;
+    }
+
+    TVector<TTokenId> tokenIds;
+    bpeDictionary.GetAlphabet()->Apply(sentence, &tokenIds, unknownTokenPolicy);
+    while (true) {
+        size_t bestPosition = tokenIds.size();
+        TTokenId bestId = Max<TTokenId>();
+        for (size_t i = 0; i + 1 < tokenIds.size(); ++i) {
+            const auto it = units.find(std::make_pair(tokenIds[i], tokenIds[i + 1]));
+            if (it != units.end() && it->second < bestId) {
+                bestId = it->second;
+                bestPosition = i;
+            }
+        }
+        if (bestPosition == tokenIds.size()) {
+            return tokenIds;
+        }
+        tokenIds[bestPosition] = bestId;
+        tokenIds.erase(tokenIds.begin() + bestPosition + 1);
+    }
+}
+
 Y_UNIT_TEST_SUITE(DictionaryTests) {
 
     Y_UNIT_TEST(DictionaryMainTest) {
@@ -431,6 +515,103 @@ Y_UNIT_TEST_SUITE(DictionaryTests) {
 
     }
 
+    Y_UNIT_TEST(ParallelDictionaryBuilderTest) {
+        const auto sentences = GenerateSentences(/*sentenceCount*/ 3000, /*wordCount*/ 500, /*seed*/ 0);
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        TDictionaryBuilderOptions dictionaryBuilderOptions;
+        dictionaryBuilderOptions.OccurrenceLowerBound = 2;
+
+        for (auto [tokenLevelType, gramOrder, skipStep] : {
+            std::make_tuple(ETokenLevelType::Word, 1u, 0u),
+            std::make_tuple(ETokenLevelType::Letter, 3u, 0u),
+            std::make_tuple(ETokenLevelType::Word, 2u, 0u),
+            std::make_tuple(ETokenLevelType::Word, 2u, 1u)
+        }) {
+            TDictionaryOptions dictionaryOptions;
+            dictionaryOptions.TokenLevelType = tokenLevelType;
+            dictionaryOptions.GramOrder = gramOrder;
+            dictionaryOptions.SkipStep = skipStep;
+
+            TDictionaryBuilder dictionaryBuilder(dictionaryBuilderOptions, dictionaryOptions);
+            for (const auto& sentence : sentences) {
+                dictionaryBuilder.Add(sentence);
+            }
+            const auto expectedDictionary = dictionaryBuilder.FinishBuilding();
+
+            TParallelDictionaryBuilder parallelDictionaryBuilder(dictionaryBuilderOptions, dictionaryOptions, &localExecutor);
+            const TConstArrayRef<TVector<TString>> allSentences(sentences);
+            parallelDictionaryBuilder.Add(allSentences.Slice(0, 1000));
+            parallelDictionaryBuilder.Add(allSentences.Slice(1000));
+            const auto dictionary = parallelDictionaryBuilder.FinishBuilding();
+            UNIT_ASSERT_EXCEPTION(parallelDictionaryBuilder.FinishBuilding(), yexception);
+
+            UNIT_ASSERT(expectedDictionary->Size() > 0);
+            AssertEqualDictionaries(*expectedDictionary, *dictionary);
+        }
+    }
+
+    Y_UNIT_TEST(ParallelDictionaryBuilderPruningTest) {
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        TDictionaryBuilderOptions exactDictionaryBuilderOptions;
+        exactDictionaryBuilderOptions.OccurrenceLowerBound = 0;
+        TDictionaryBuilderOptions dictionaryBuilderOptions;
+        dictionaryBuilderOptions.OccurrenceLowerBound = 5;
+
+        // n-grams are compared by their words, the ids of the words differ after pruning
+        const auto getTokenId = [](const IDictionary& dictionary, const TString& token) {
+            const TVector<TString> words = StringSplitter(token).Split(' ');
+            TVector<TTokenId> tokenIds;
+            dictionary.Apply(words, &tokenIds, EUnknownTokenPolicy::Insert);
+            UNIT_ASSERT_VALUES_EQUAL(tokenIds.size(), 1);
+            return tokenIds[0];
+        };
+
+        // bigrams are rarer, so they are taken over fewer words and pruned with a smaller error
+        for (auto [gramOrder, wordCount, maxCountError] : {
+            std::make_tuple(1u, 20000u, 1e-3),
+            std::make_tuple(2u, 500u, 1e-4)
+        }) {
+            const auto sentences = GenerateSentences(/*sentenceCount*/ 20000, wordCount, /*seed*/ 1);
+            TDictionaryOptions dictionaryOptions;
+            dictionaryOptions.TokenLevelType = ETokenLevelType::Word;
+            dictionaryOptions.GramOrder = gramOrder;
+
+            TDictionaryBuilder dictionaryBuilder(exactDictionaryBuilderOptions, dictionaryOptions);
+            ui64 totalCount = 0;
+            for (const auto& sentence : sentences) {
+                dictionaryBuilder.Add(sentence);
+                totalCount += sentence.size() >= gramOrder ? sentence.size() - gramOrder + 1 : 0;
+            }
+            const auto exactDictionary = dictionaryBuilder.FinishBuilding();
+
+            TParallelDictionaryBuilder parallelDictionaryBuilder(dictionaryBuilderOptions, dictionaryOptions, &localExecutor, maxCountError);
+            const TConstArrayRef<TVector<TString>> allSentences(sentences);
+            for (size_t begin = 0; begin < sentences.size(); begin += 1000) {
+                parallelDictionaryBuilder.Add(allSentences.Slice(begin, 1000));
+            }
+            const auto dictionary = parallelDictionaryBuilder.FinishBuilding();
+            UNIT_ASSERT(dictionary->Size() > 0);
+
+            const double countErrorBound = maxCountError * totalCount;
+            for (TTokenId tokenId = 0; tokenId < dictionary->Size(); ++tokenId) {
+                const ui64 exactCount = exactDictionary->GetCount(getTokenId(*exactDictionary, dictionary->GetToken(tokenId)));
+                UNIT_ASSERT(exactCount >= dictionaryBuilderOptions.OccurrenceLowerBound);
+                UNIT_ASSERT(dictionary->GetCount(tokenId) >= exactCount);
+                UNIT_ASSERT(dictionary->GetCount(tokenId) <= exactCount + countErrorBound);
+            }
+            for (TTokenId tokenId = 0; tokenId < exactDictionary->Size(); ++tokenId) {
+                const ui64 exactCount = exactDictionary->GetCount(tokenId);
+                const bool isPresent = getTokenId(*dictionary, exactDictionary->GetToken(tokenId)) != dictionary->GetUnknownTokenId();
+                UNIT_ASSERT(isPresent || exactCount < dictionaryBuilderOptions.OccurrenceLowerBound + countErrorBound);
+            }
+        }
+    }
+
     Y_UNIT_TEST(BpeDictionaryMainTest) {
 
         TVector<TString> firstSentence = {"abc", "bcd", "bcd", "abc", "bcd"};
@@ -483,4 +664,218 @@ Y_UNIT_TEST_SUITE(DictionaryTests) {
         });
 
     }
+
+    Y_UNIT_TEST(BpeDictionaryParallelAddTest) {
+        const auto sentences = GenerateSentences(/*sentenceCount*/ 2000, /*wordCount*/ 200, /*seed*/ 2);
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        TDictionaryOptions dictionaryOptions;
+        dictionaryOptions.TokenLevelType = ETokenLevelType::Word;
+        dictionaryOptions.GramOrder = 1;
+        TDictionaryBuilderOptions dictionaryBuilderOptions;
+        dictionaryBuilderOptions.OccurrenceLowerBound = 5;
+
+        TDictionaryBuilder dictionaryBuilder(dictionaryBuilderOptions, dictionaryOptions);
+        for (const auto& sentence : sentences) {
+            dictionaryBuilder.Add(sentence);
+        }
+        const auto dictionary = dictionaryBuilder.FinishBuilding();
+
+        TBpeDictionaryBuilder bpeBuilder(/*numUnits*/ 100, /*skipUnknown*/ true, dictionary);
+        for (const auto& sentence : sentences) {
+            bpeBuilder.Add(sentence);
+        }
+        const auto expectedBpeDictionary = bpeBuilder.FinishBuilding();
+
+        TBpeDictionaryBuilder parallelBpeBuilder(/*numUnits*/ 100, /*skipUnknown*/ true, dictionary);
+        const TConstArrayRef<TVector<TString>> allSentences(sentences);
+        parallelBpeBuilder.Add(allSentences.Slice(0, 500), &localExecutor);
+        parallelBpeBuilder.Add(allSentences.Slice(500), &localExecutor);
+        const auto bpeDictionary = parallelBpeBuilder.FinishBuilding();
+
+        UNIT_ASSERT_VALUES_EQUAL(expectedBpeDictionary->Size(), dictionary->Size() + 100);
+        UNIT_ASSERT_VALUES_EQUAL(expectedBpeDictionary->Size(), bpeDictionary->Size());
+        for (TTokenId tokenId = dictionary->GetMinUnusedTokenId(); tokenId < bpeDictionary->GetMinUnusedTokenId(); ++tokenId) {
+            UNIT_ASSERT_VALUES_EQUAL(expectedBpeDictionary->GetToken(tokenId), bpeDictionary->GetToken(tokenId));
+            UNIT_ASSERT_VALUES_EQUAL(expectedBpeDictionary->GetCount(tokenId), bpeDictionary->GetCount(tokenId));
+        }
+    }
+
+    Y_UNIT_TEST(BpeDictionaryLetterApplyTest) {
+        auto sentences = GenerateSentences(/*sentenceCount*/ 500, /*wordCount*/ 1000, /*seed*/ 3);
+        sentences.push_back({"w11111", "w1w", "", "w\xff", "wx1", "w1 1"});
+
+        TDictionaryOptions dictionaryOptions;
+        dictionaryOptions.TokenLevelType = ETokenLevelType::Letter;
+        dictionaryOptions.GramOrder = 1;
+        TDictionaryBuilderOptions dictionaryBuilderOptions;
+        dictionaryBuilderOptions.OccurrenceLowerBound = 0;
+
+        TDictionaryBuilder dictionaryBuilder(dictionaryBuilderOptions, dictionaryOptions);
+        for (const auto& sentence : sentences) {
+            dictionaryBuilder.Add(sentence);
+        }
+        const auto dictionary = dictionaryBuilder.FinishBuilding();
+
+        // units learned from separate words never span the end of word token
+        TBpeDictionaryBuilder bpeBuilder(/*numUnits*/ 200, /*skipUnknown*/ true, dictionary);
+        for (const auto& sentence : sentences) {
+            for (const auto& word : sentence) {
+                bpeBuilder.Add(TVector<TString>{word});
+            }
+        }
+        const auto bpeDictionary = bpeBuilder.FinishBuilding();
+        const auto mmapDictionary = MakeIntrusive<TMMapBpeDictionary>(bpeDictionary);
+        UNIT_ASSERT(bpeDictionary->HasWordCache());
+
+        TBpeDictionaryBuilder sentenceBpeBuilder(/*numUnits*/ 200, /*skipUnknown*/ true, dictionary);
+        for (const auto& sentence : sentences) {
+            sentenceBpeBuilder.Add(sentence);
+        }
+        const auto sentenceBpeDictionary = sentenceBpeBuilder.FinishBuilding();
+        UNIT_ASSERT(!sentenceBpeDictionary->HasWordCache());
+
+        sentences.push_back({"xyz", "w1x", "y"});
+        for (auto unknownTokenPolicy : {EUnknownTokenPolicy::Skip, EUnknownTokenPolicy::Insert}) {
+            TVector<TVector<TTokenId>> batchTokenIds;
+            bpeDictionary->Apply(sentences, &batchTokenIds, unknownTokenPolicy);
+            UNIT_ASSERT_VALUES_EQUAL(batchTokenIds.size(), sentences.size());
+            for (size_t i = 0; i < sentences.size(); ++i) {
+                const auto expected = ApplyBpeNaively(*bpeDictionary, sentences[i], unknownTokenPolicy);
+                TVector<TTokenId> tokenIds;
+                bpeDictionary->Apply(sentences[i], &tokenIds, unknownTokenPolicy);
+                UNIT_ASSERT_VALUES_EQUAL(tokenIds, expected);
+                UNIT_ASSERT_VALUES_EQUAL(batchTokenIds[i], expected);
+                mmapDictionary->Apply(sentences[i], &tokenIds, unknownTokenPolicy);
+                UNIT_ASSERT_VALUES_EQUAL(tokenIds, expected);
+                sentenceBpeDictionary->Apply(sentences[i], &tokenIds, unknownTokenPolicy);
+                UNIT_ASSERT_VALUES_EQUAL(tokenIds, ApplyBpeNaively(*sentenceBpeDictionary, sentences[i], unknownTokenPolicy));
+            }
+        }
+
+        bpeDictionary->SetWordCacheSize(0);
+        UNIT_ASSERT(!bpeDictionary->HasWordCache());
+        for (const auto& sentence : sentences) {
+            TVector<TTokenId> tokenIds;
+            bpeDictionary->Apply(sentence, &tokenIds, EUnknownTokenPolicy::Insert);
+            UNIT_ASSERT_VALUES_EQUAL(tokenIds, ApplyBpeNaively(*bpeDictionary, sentence, EUnknownTokenPolicy::Insert));
+        }
+    }
+
+    Y_UNIT_TEST(BpeDictionaryWordApplyTest) {
+        const auto sentences = GenerateSentences(/*sentenceCount*/ 500, /*wordCount*/ 30, /*seed*/ 4);
+
+        TDictionaryOptions dictionaryOptions;
+        dictionaryOptions.TokenLevelType = ETokenLevelType::Word;
+        dictionaryOptions.GramOrder = 1;
+        TDictionaryBuilderOptions dictionaryBuilderOptions;
+        dictionaryBuilderOptions.OccurrenceLowerBound = 2;
+
+        TDictionaryBuilder dictionaryBuilder(dictionaryBuilderOptions, dictionaryOptions);
+        for (const auto& sentence : sentences) {
+            dictionaryBuilder.Add(sentence);
+        }
+        const auto dictionary = dictionaryBuilder.FinishBuilding();
+
+        TBpeDictionaryBuilder bpeBuilder(/*numUnits*/ 100, /*skipUnknown*/ true, dictionary);
+        for (const auto& sentence : sentences) {
+            bpeBuilder.Add(sentence);
+        }
+        const auto bpeDictionary = bpeBuilder.FinishBuilding();
+        UNIT_ASSERT(!bpeDictionary->HasWordCache());
+
+        TVector<TVector<TTokenId>> batchTokenIds;
+        bpeDictionary->Apply(sentences, &batchTokenIds, EUnknownTokenPolicy::Insert);
+        for (size_t i = 0; i < sentences.size(); ++i) {
+            UNIT_ASSERT_VALUES_EQUAL(batchTokenIds[i], ApplyBpeNaively(*bpeDictionary, sentences[i], EUnknownTokenPolicy::Insert));
+        }
+    }
+    Y_UNIT_TEST(PerfectHashDictionaryTest) {
+        const auto sentences = GenerateSentences(2000, 20000, 0);
+        for (auto tokenLevelType : {ETokenLevelType::Word, ETokenLevelType::Letter}) {
+            TDictionaryOptions dictionaryOptions;
+            dictionaryOptions.TokenLevelType = tokenLevelType;
+            dictionaryOptions.GramOrder = tokenLevelType == ETokenLevelType::Word ? 1 : 3;
+            dictionaryOptions.StartTokenId = 10;
+            TDictionaryBuilderOptions dictionaryBuilderOptions;
+            dictionaryBuilderOptions.OccurrenceLowerBound = 2;
+
+            TDictionaryBuilder dictionaryBuilder(dictionaryBuilderOptions, dictionaryOptions);
+            for (const auto& sentence : sentences) {
+                dictionaryBuilder.Add(sentence);
+            }
+            auto dictionary = dictionaryBuilder.FinishBuilding();
+            const auto perfectHashDictionary = MakeIntrusive<TMMapPerfectHashDictionary>(dictionary);
+
+            UNIT_ASSERT_VALUES_EQUAL(perfectHashDictionary->Size(), dictionary->Size());
+            UNIT_ASSERT_VALUES_EQUAL(perfectHashDictionary->GetUnknownTokenId(), dictionary->GetUnknownTokenId());
+            UNIT_ASSERT_VALUES_EQUAL(perfectHashDictionary->GetMinUnusedTokenId(), dictionary->GetMinUnusedTokenId());
+            UNIT_ASSERT_VALUES_EQUAL(perfectHashDictionary->GetTopTokens(20), dictionary->GetTopTokens(20));
+            for (TTokenId tokenId = 10; tokenId < dictionary->GetMinUnusedTokenId(); ++tokenId) {
+                const TString token = dictionary->GetToken(tokenId);
+                UNIT_ASSERT_VALUES_EQUAL(perfectHashDictionary->GetToken(tokenId), token);
+                if (tokenId < dictionary->GetUnknownTokenId()) {
+                    UNIT_ASSERT_VALUES_EQUAL(perfectHashDictionary->Apply(token), tokenId);
+                }
+            }
+            for (ui32 i = 0; i < 1000; ++i) {
+                UNIT_ASSERT_VALUES_EQUAL(perfectHashDictionary->Apply("unknown" + ToString(i)), dictionary->GetUnknownTokenId());
+            }
+
+            const auto unknownSentences = GenerateSentences(100, 40000, 1);
+            for (const auto& sentence : unknownSentences) {
+                TVector<TTokenId> expected;
+                TVector<TTokenId> actual;
+                for (auto policy : {EUnknownTokenPolicy::Skip, EUnknownTokenPolicy::Insert}) {
+                    dictionary->Apply(sentence, &expected, policy);
+                    perfectHashDictionary->Apply(sentence, &actual, policy);
+                    UNIT_ASSERT_VALUES_EQUAL(expected, actual);
+                }
+            }
+        }
+
+        TDictionaryBuilder emptyDictionaryBuilder(TDictionaryBuilderOptions{}, TDictionaryOptions{});
+        const TMMapPerfectHashDictionary emptyDictionary(emptyDictionaryBuilder.FinishBuilding());
+        UNIT_ASSERT_VALUES_EQUAL(emptyDictionary.Size(), 0);
+        UNIT_ASSERT_VALUES_EQUAL(emptyDictionary.Apply("a"), emptyDictionary.GetUnknownTokenId());
+    }
+
+    Y_UNIT_TEST(PerfectHashDictionaryCorruptedDataTest) {
+        TDictionaryBuilderOptions dictionaryBuilderOptions;
+        dictionaryBuilderOptions.OccurrenceLowerBound = 1;
+        TDictionaryBuilder dictionaryBuilder(dictionaryBuilderOptions, TDictionaryOptions{});
+        for (TStringBuf token : {"a", "b", "c", "a"}) {
+            dictionaryBuilder.Add(token);
+        }
+        TStringStream stream;
+        TMMapPerfectHashDictionary(dictionaryBuilder.FinishBuilding()).Save(&stream);
+        const TString& serialized = stream.Str();
+        TVector<ui64> data((serialized.size() + 7) / 8);
+        std::memcpy(data.data(), serialized.data(), serialized.size());
+
+        // the size of the dictionary meta info
+        data[3] = Max<ui64>() - 7;
+        UNIT_ASSERT_EXCEPTION(TMMapPerfectHashDictionary(data.data(), serialized.size()), yexception);
+
+        // no length may make the dictionary read past the data
+        for (size_t i = 2; i < data.size(); ++i) {
+            std::memcpy(data.data(), serialized.data(), serialized.size());
+            for (ui64 value : {ui64(1) << 33, Max<ui64>() / 2, ui64(9)}) {
+                data[i] = value;
+                try {
+                    const TMMapPerfectHashDictionary dictionary(data.data(), serialized.size());
+                    for (TStringBuf token : {"a", "b", "c", "d"}) {
+                        Y_UNUSED(dictionary.Apply(token));
+                    }
+                    for (TTokenId tokenId = 0; tokenId < dictionary.GetMinUnusedTokenId(); ++tokenId) {
+                        Y_UNUSED(dictionary.GetToken(tokenId));
+                    }
+                } catch (const yexception&) {
+                }
+            }
+        }
+    }
+
 }
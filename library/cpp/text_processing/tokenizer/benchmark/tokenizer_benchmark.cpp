@@ -1,12 +1,16 @@
+#include <library/cpp/text_processing/dictionary/bpe_builder.h>
+#include <library/cpp/text_processing/dictionary/dictionary_builder.h>
 #include <library/cpp/text_processing/tokenizer/tokenizer.h>
 #include <util/generic/size_literals.h>
 #include <util/generic/vector.h>
 #include <util/stream/file.h>
+#include <util/stream/str.h>
 
 #include <contrib/libs/benchmark/include/benchmark/benchmark.h>
 #include <library/cpp/testing/common/env.h>
 
 
+using namespace NTextProcessing::NDictionary;
 using namespace NTextProcessing::NTokenizer;
 
 class TTokenizerFixture: public ::benchmark::Fixture {
@@ -36,11 +40,15 @@ static void BMTokenize(benchmark::State& st, const TVector<TString>& queries, bo
     options.SeparatorType = ESeparatorType::BySense;
     TTokenizer tokenizer(options);
 
+    size_t tokenCount = 0;
     for (auto _ : st) {
         for (auto& q : queries) {
-            benchmark::DoNotOptimize(tokenizer.Tokenize(q));
+            auto tokens = tokenizer.Tokenize(q);
+            tokenCount += tokens.size();
+            benchmark::DoNotOptimize(tokens);
         }
     }
+    st.counters["tokens/s"] = benchmark::Counter(tokenCount, benchmark::Counter::kIsRate);
 }
 
 BENCHMARK_DEFINE_F(TTokenizerFixture, TokenizeWithCache)(benchmark::State& st) {
@@ -53,3 +61,134 @@ BENCHMARK_DEFINE_F(TTokenizerFixture, TokenizeWithoutCache)(benchmark::State& st
 
 BENCHMARK_REGISTER_F(TTokenizerFixture, TokenizeWithCache)->Threads(5)->Threads(25);
 BENCHMARK_REGISTER_F(TTokenizerFixture, TokenizeWithoutCache)->Threads(5)->Threads(25);
+
+static TTokenizerOptions MakeLowercasingOptions(ESeparatorType separatorType) {
+    TTokenizerOptions options;
+    options.SeparatorType = separatorType;
+    options.TokenTypes = {ETokenType::Word, ETokenType::Number, ETokenType::Punctuation, ETokenType::Unknown};
+    options.Lowercasing = true;
+    return options;
+}
+
+static void BMTokenizePerQuery(benchmark::State& st, const TVector<TString>& queries, ESeparatorType separatorType) {
+    TTokenizer tokenizer(MakeLowercasingOptions(separatorType));
+
+    size_t tokenCount = 0;
+    TVector<TString> tokens;
+    for (auto _ : st) {
+        for (auto& q : queries) {
+            tokenizer.Tokenize(q, &tokens);
+            tokenCount += tokens.size();
+            benchmark::DoNotOptimize(tokens);
+        }
+    }
+    st.counters["tokens/s"] = benchmark::Counter(tokenCount, benchmark::Counter::kIsRate);
+}
+
+static void BMTokenizeBatch(benchmark::State& st, const TVector<TString>& queries, ESeparatorType separatorType) {
+    TTokenizer tokenizer(MakeLowercasingOptions(separatorType));
+    const TVector<TStringBuf> documents(queries.begin(), queries.end());
+    const size_t batchSize = 256;
+
+    size_t tokenCount = 0;
+    TTokenizedBatch batch;
+    for (auto _ : st) {
+        for (size_t begin = 0; begin < documents.size(); begin += batchSize) {
+            const size_t size = Min(batchSize, documents.size() - begin);
+            tokenizer.TokenizeBatch(TConstArrayRef<TStringBuf>(documents).Slice(begin, size), &batch);
+            tokenCount += batch.GetTokenCount();
+            benchmark::DoNotOptimize(batch);
+        }
+    }
+    st.counters["tokens/s"] = benchmark::Counter(tokenCount, benchmark::Counter::kIsRate);
+}
+
+BENCHMARK_DEFINE_F(TTokenizerFixture, TokenizePerQueryBySense)(benchmark::State& st) {
+    BMTokenizePerQuery(st, Queries, ESeparatorType::BySense);
+}
+
+BENCHMARK_DEFINE_F(TTokenizerFixture, TokenizeBatchBySense)(benchmark::State& st) {
+    BMTokenizeBatch(st, Queries, ESeparatorType::BySense);
+}
+
+BENCHMARK_DEFINE_F(TTokenizerFixture, TokenizePerQueryByDelimiter)(benchmark::State& st) {
+    BMTokenizePerQuery(st, Queries, ESeparatorType::ByDelimiter);
+}
+
+BENCHMARK_DEFINE_F(TTokenizerFixture, TokenizeBatchByDelimiter)(benchmark::State& st) {
+    BMTokenizeBatch(st, Queries, ESeparatorType::ByDelimiter);
+}
+
+BENCHMARK_REGISTER_F(TTokenizerFixture, TokenizePerQueryBySense)->Threads(1)->Threads(5);
+BENCHMARK_REGISTER_F(TTokenizerFixture, TokenizeBatchBySense)->Threads(1)->Threads(5);
+BENCHMARK_REGISTER_F(TTokenizerFixture, TokenizePerQueryByDelimiter)->Threads(1)->Threads(5);
+BENCHMARK_REGISTER_F(TTokenizerFixture, TokenizeBatchByDelimiter)->Threads(1)->Threads(5);
+
+// Letter level BPE over the tokenized queries. Units are learned from separate words,
+// so the dictionary memoizes word encodings unless the cache is disabled.
+class TBpeFixture: public TTokenizerFixture {
+public:
+    TBpeFixture() {
+        TTokenizerOptions options;
+        options.SeparatorType = ESeparatorType::BySense;
+        options.TokenTypes = {ETokenType::Word, ETokenType::Number};
+        options.Lowercasing = true;
+        TTokenizer tokenizer(options);
+        for (const auto& q : Queries) {
+            Sentences.push_back(tokenizer.Tokenize(q));
+        }
+
+        TDictionaryOptions dictionaryOptions;
+        dictionaryOptions.TokenLevelType = ETokenLevelType::Letter;
+        dictionaryOptions.GramOrder = 1;
+        TDictionaryBuilderOptions dictionaryBuilderOptions;
+        dictionaryBuilderOptions.OccurrenceLowerBound = 0;
+        TDictionaryBuilder alphabetBuilder(dictionaryBuilderOptions, dictionaryOptions);
+        for (const auto& sentence : Sentences) {
+            alphabetBuilder.Add(sentence);
+        }
+        auto alphabet = alphabetBuilder.FinishBuilding();
+
+        TBpeDictionaryBuilder bpeBuilder(/*numUnits*/ 3000, /*skipUnknown*/ true, alphabet);
+        for (const auto& sentence : Sentences) {
+            for (const auto& word : sentence) {
+                bpeBuilder.Add(TVector<TString>{word});
+            }
+        }
+        BpeDictionary = bpeBuilder.FinishBuilding();
+
+        TStringStream stream;
+        BpeDictionary->Save(&stream);
+        BpeDictionaryWithoutCache = MakeIntrusive<TBpeDictionary>(alphabet);
+        BpeDictionaryWithoutCache->SetWordCacheSize(0);
+        BpeDictionaryWithoutCache->Load(&stream);
+    }
+
+protected:
+    TVector<TVector<TString>> Sentences;
+    TIntrusivePtr<TBpeDictionary> BpeDictionary;
+    TIntrusivePtr<TBpeDictionary> BpeDictionaryWithoutCache;
+};
+
+static void BMBpeApply(benchmark::State& st, const TBpeDictionary& bpeDictionary, const TVector<TVector<TString>>& sentences) {
+    size_t tokenCount = 0;
+    TVector<TVector<TTokenId>> tokenIds;
+    for (auto _ : st) {
+        bpeDictionary.Apply(sentences, &tokenIds);
+        for (const auto& sentenceTokenIds : tokenIds) {
+            tokenCount += sentenceTokenIds.size();
+        }
+    }
+    st.counters["tokens/s"] = benchmark::Counter(tokenCount, benchmark::Counter::kIsRate);
+}
+
+BENCHMARK_DEFINE_F(TBpeFixture, BpeApplyWithCache)(benchmark::State& st) {
+    BMBpeApply(st, *BpeDictionary, Sentences);
+}
+
+BENCHMARK_DEFINE_F(TBpeFixture, BpeApplyWithoutCache)(benchmark::State& st) {
+    BMBpeApply(st, *BpeDictionaryWithoutCache, Sentences);
+}
+
+BENCHMARK_REGISTER_F(TBpeFixture, BpeApplyWithCache)->Threads(1)->Threads(5);
+BENCHMARK_REGISTER_F(TBpeFixture, BpeApplyWithoutCache)->Threads(1)->Threads(5);
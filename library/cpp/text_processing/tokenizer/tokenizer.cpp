@@ -3,13 +3,24 @@
 #include <library/cpp/cache/cache.h>
 #include <library/cpp/tokenizer/tokenizer.h>
 
+#include <util/charset/wide.h>
+#include <util/generic/bitops.h>
 #include <util/generic/maybe.h>
+#include <util/generic/mem_copy.h>
+#include <util/string/ascii.h>
 #include <util/string/split.h>
 #include <util/string/join.h>
 #include <util/string/strip.h>
 #include <util/string/type.h>
 #include <util/system/spinlock.h>
 #include <util/system/guard.h>
+#include <util/system/platform.h>
+
+#include <array>
+
+#ifdef _sse2_
+#include <emmintrin.h>
+#endif
 
 using namespace NTextProcessing;
 using NTextProcessing::NTokenizer::ESubTokensPolicy;
@@ -96,18 +107,112 @@ static bool IsWordChanged(const NTokenizer::TTokenizerOptions& options) {
     return options.Lemmatizing || options.Lowercasing;
 }
 
+static void AppendWideToUTF8(const wchar16* text, size_t len, TString* buffer) {
+    const size_t start = buffer->size();
+    buffer->ReserveAndResize(start + WideToUTF8BufferSize(len));
+    size_t written = 0;
+    WideToUTF8(text, len, buffer->begin() + start, written);
+    buffer->resize(start + written);
+}
+
+// same as UTF8ToWide(TStringBuf), but reuses the memory of wideText
+static void DecodeUTF8(TStringBuf text, TUtf16String* wideText) {
+    wideText->ReserveAndResize(text.size());
+    size_t written = 0;
+    Y_ENSURE(UTF8ToWide(text.data(), text.size(), wideText->begin(), written), "failed to decode UTF-8 string");
+    wideText->resize(written);
+}
+
 namespace {
 
+    class TVectorTokenSink {
+    public:
+        TVectorTokenSink(TVector<TString>* tokens, TVector<NTokenizer::ETokenType>* tokenTypes)
+            : Tokens(tokens)
+            , TokenTypes(tokenTypes)
+        {
+        }
+
+        void AddToken(TStringBuf token, NTokenizer::ETokenType tokenType) {
+            AddTokenInfo(TString(token), tokenType);
+        }
+
+        void AddWideToken(const wchar16* token, size_t len, NTokenizer::ETokenType tokenType) {
+            AddTokenInfo(WideToUTF8(token, len), tokenType);
+        }
+
+        void AddStrippedWideToken(const wchar16* token, size_t len, NTokenizer::ETokenType tokenType) {
+            TString strippedToken(WideToUTF8(token, len));
+            StripInPlace(strippedToken);
+            if (!strippedToken.empty()) {
+                AddTokenInfo(std::move(strippedToken), tokenType);
+            }
+        }
+
+    private:
+        void AddTokenInfo(TString token, NTokenizer::ETokenType tokenType) {
+            Tokens->emplace_back(std::move(token));
+            if (TokenTypes) {
+                TokenTypes->emplace_back(tokenType);
+            }
+        }
+
+        TVector<TString>* Tokens;
+        TVector<NTokenizer::ETokenType>* TokenTypes;
+    };
+
+    class TBatchTokenSink {
+    public:
+        explicit TBatchTokenSink(NTokenizer::TTokenizedBatch* batch)
+            : Batch(batch)
+        {
+        }
+
+        void AddToken(TStringBuf token, NTokenizer::ETokenType tokenType) {
+            Batch->Buffer.append(token);
+            FinishToken(tokenType);
+        }
+
+        void AddWideToken(const wchar16* token, size_t len, NTokenizer::ETokenType tokenType) {
+            AppendWideToUTF8(token, len, &Batch->Buffer);
+            FinishToken(tokenType);
+        }
+
+        void AddStrippedWideToken(const wchar16* token, size_t len, NTokenizer::ETokenType tokenType) {
+            TString& buffer = Batch->Buffer;
+            const size_t start = Batch->TokenOffsets.back();
+            AppendWideToUTF8(token, len, &buffer);
+            const TStringBuf strippedToken = StripString(TStringBuf(buffer).SubStr(start));
+            if (strippedToken.empty()) {
+                buffer.resize(start);
+                return;
+            }
+            const size_t strippedStart = strippedToken.data() - buffer.data();
+            if (strippedStart != start) {
+                MemMove(buffer.begin() + start, buffer.data() + strippedStart, strippedToken.size());
+            }
+            buffer.resize(start + strippedToken.size());
+            FinishToken(tokenType);
+        }
+
+        void FinishToken(NTokenizer::ETokenType tokenType) {
+            Batch->TokenOffsets.push_back(Batch->Buffer.size());
+            Batch->TokenTypes.push_back(tokenType);
+        }
+
+    private:
+        NTokenizer::TTokenizedBatch* Batch;
+    };
+
+    template <typename TTokenSink>
     class TTokenHandler : public ITokenHandler {
     public:
         TTokenHandler(
-            TVector<TString>* tokens,
-            TVector<NTokenizer::ETokenType>* tokenTypes,
+            TTokenSink* sink,
             const NTokenizer::TTokenizerOptions& options,
             ILemmerImplementation* lemmer
         )
-            : Tokens(tokens)
-            , TokenTypes(tokenTypes)
+            : Sink(sink)
             , Options(options)
             , Lemmer(lemmer)
         {
@@ -120,56 +225,43 @@ namespace {
                     if (Options.SubTokensPolicy == ESubTokensPolicy::SeveralTokens) {
                         for (const auto& subTokenInfo : rawToken.SubTokens) {
                             auto [subTokenData, subTokenLen] = BuildSubToken(rawToken, subTokenInfo);
-                            if (IsWordChanged(Options)) {
-                                TUtf16String subToken(subTokenData, subTokenLen);
-                                ProcessWordToken(Options, Lemmer, &subToken);
-                                AddTokenInfo(WideToUTF8(subToken), tokenType);
-                            } else {
-                                AddTokenInfo(WideToUTF8(subTokenData, subTokenLen), tokenType);
-                            }
+                            AddWordToken(subTokenData, subTokenLen);
                         }
 
                     } else {
                         Y_ENSURE(Options.SubTokensPolicy == ESubTokensPolicy::SingleToken,
                             "Unsupported ESubTokensPolicy.");
-                        if (IsWordChanged(Options)) {
-                            TUtf16String token(rawToken.Token, rawToken.Leng);
-                            ProcessWordToken(Options, Lemmer, &token);
-                            AddTokenInfo(WideToUTF8(token), tokenType);
-                        } else {
-                            AddTokenInfo(WideToUTF8(rawToken.Token, rawToken.Leng), tokenType);
-                        }
+                        AddWordToken(rawToken.Token, rawToken.Leng);
                     }
                 } else if (tokenType == NTokenizer::ETokenType::Number) {
                     if (Options.NumberProcessPolicy == NTokenizer::ETokenProcessPolicy::Replace) {
-                        AddTokenInfo(Options.NumberToken, tokenType);
+                        Sink->AddToken(Options.NumberToken, tokenType);
                     } else if (Options.NumberProcessPolicy == NTokenizer::ETokenProcessPolicy::LeaveAsIs) {
-                        AddTokenInfo(WideToUTF8(rawToken.Token, rawToken.Leng), tokenType);
+                        Sink->AddWideToken(rawToken.Token, rawToken.Leng, tokenType);
                     }
                 } else if (tokenType == NTokenizer::ETokenType::Punctuation) {
-                    TString token(WideToUTF8(rawToken.Token, rawToken.Leng));
-                    StripInPlace(token);
-                    if (!token.empty()) {
-                        AddTokenInfo(std::move(token), tokenType);
-                    }
+                    Sink->AddStrippedWideToken(rawToken.Token, rawToken.Leng, tokenType);
                 } else {
-                    AddTokenInfo(WideToUTF8(rawToken.Token, rawToken.Leng), tokenType);
+                    Sink->AddWideToken(rawToken.Token, rawToken.Leng, tokenType);
                 }
             }
         }
 
     private:
-        void AddTokenInfo(TString token, NTokenizer::ETokenType tokenType) {
-            Tokens->emplace_back(std::move(token));
-            if (TokenTypes) {
-                TokenTypes->emplace_back(tokenType);
+        void AddWordToken(const wchar16* token, size_t len) {
+            if (IsWordChanged(Options)) {
+                WordBuffer.assign(token, len);
+                ProcessWordToken(Options, Lemmer, &WordBuffer);
+                Sink->AddWideToken(WordBuffer.data(), WordBuffer.size(), NTokenizer::ETokenType::Word);
+            } else {
+                Sink->AddWideToken(token, len, NTokenizer::ETokenType::Word);
             }
         }
 
-        TVector<TString>* Tokens;
-        TVector<NTokenizer::ETokenType>* TokenTypes;
-        NTokenizer::TTokenizerOptions Options;
+        TTokenSink* Sink;
+        const NTokenizer::TTokenizerOptions& Options;
         ILemmerImplementation* Lemmer;
+        TUtf16String WordBuffer;
     };
 
 }
@@ -181,11 +273,30 @@ static void SplitBySense(
     TVector<TString>* tokens,
     TVector<NTokenizer::ETokenType>* tokenTypes
 ) {
-    TTokenHandler handler(tokens, tokenTypes, options, lemmer);
+    TVectorTokenSink sink(tokens, tokenTypes);
+    TTokenHandler<TVectorTokenSink> handler(&sink, options, lemmer);
     TNlpTokenizer tokenizer(handler);
     tokenizer.Tokenize(UTF8ToWide(inputString));
 }
 
+static void SplitBatchBySense(
+    TConstArrayRef<TStringBuf> documents,
+    const NTokenizer::TTokenizerOptions& options,
+    ILemmerImplementation* lemmer,
+    NTokenizer::TTokenizedBatch* batch
+) {
+    static thread_local TUtf16String wideDocument;
+
+    TBatchTokenSink sink(batch);
+    TTokenHandler<TBatchTokenSink> handler(&sink, options, lemmer);
+    TNlpTokenizer tokenizer(handler);
+    for (TStringBuf document : documents) {
+        DecodeUTF8(document, &wideDocument);
+        tokenizer.Tokenize(wideDocument);
+        batch->DocumentOffsets.push_back(batch->TokenTypes.size());
+    }
+}
+
 template <typename StringType>
 static void SplitByDelimiter(
     TStringBuf inputString,
@@ -254,6 +365,145 @@ static void SplitByDelimiter(
     }
 }
 
+namespace {
+
+    // SplitBySet of StringSplitter splits by single bytes as well, so this is the same split
+    class TDelimiterSet {
+    public:
+        explicit TDelimiterSet(TStringBuf delimiters) {
+            for (char delimiter : delimiters) {
+                if (!IsDelimiter[static_cast<ui8>(delimiter)]) {
+                    IsDelimiter[static_cast<ui8>(delimiter)] = true;
+                    Delimiters.push_back(delimiter);
+                }
+            }
+        }
+
+        // calls onDelimiter(position) for every delimiter of text in increasing order
+        template <typename TOnDelimiter>
+        void ForEachDelimiter(TStringBuf text, TOnDelimiter&& onDelimiter) const {
+            const char* const begin = text.data();
+            const char* const end = text.data() + text.size();
+            const char* ptr = begin;
+#ifdef _sse2_
+            if (!Delimiters.empty() && Delimiters.size() <= MaxVectorDelimiters) {
+                __m128i delimiters[MaxVectorDelimiters];
+                for (size_t i = 0; i < MaxVectorDelimiters; ++i) {
+                    delimiters[i] = _mm_set1_epi8(Delimiters[Min(i, Delimiters.size() - 1)]);
+                }
+                for (; ptr + sizeof(__m128i) <= end; ptr += sizeof(__m128i)) {
+                    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+                    __m128i matches = _mm_cmpeq_epi8(block, delimiters[0]);
+                    for (size_t i = 1; i < MaxVectorDelimiters; ++i) {
+                        matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, delimiters[i]));
+                    }
+                    for (ui32 mask = _mm_movemask_epi8(matches); mask != 0; mask &= mask - 1) {
+                        onDelimiter(ptr - begin + CountTrailingZeroBits(mask));
+                    }
+                }
+            }
+#endif
+            for (; ptr < end; ++ptr) {
+                if (IsDelimiter[static_cast<ui8>(*ptr)]) {
+                    onDelimiter(ptr - begin);
+                }
+            }
+        }
+
+    private:
+        static constexpr size_t MaxVectorDelimiters = 4;
+
+        std::array<bool, 256> IsDelimiter = {};
+        TVector<char> Delimiters;
+    };
+
+}
+
+static void AppendDelimitedToken(
+    TStringBuf token,
+    const NTokenizer::TTokenizerOptions& options,
+    ILemmerImplementation* lemmer,
+    NTokenizer::TTokenizedBatch* batch
+) {
+    static thread_local TUtf16String wideToken;
+
+    TString& buffer = batch->Buffer;
+    const size_t start = buffer.size();
+    if (!IsWordChanged(options)) {
+        buffer.append(token);
+    } else if (!options.Lemmatizing && IsStringASCII(token.begin(), token.end())) {
+        buffer.ReserveAndResize(start + token.size());
+        char* dst = buffer.begin() + start;
+        for (char c : token) {
+            *dst++ = AsciiToLower(c);
+        }
+    } else {
+        DecodeUTF8(token, &wideToken);
+        ProcessWordToken(options, lemmer, &wideToken);
+        AppendWideToUTF8(wideToken.data(), wideToken.size(), &buffer);
+    }
+
+    if (options.NumberProcessPolicy != NTokenizer::ETokenProcessPolicy::LeaveAsIs
+        && IsNumber(TStringBuf(buffer).SubStr(start)))
+    {
+        buffer.resize(start);
+        if (options.NumberProcessPolicy == NTokenizer::ETokenProcessPolicy::Skip) {
+            return;
+        }
+        buffer.append(options.NumberToken);
+    }
+    batch->TokenOffsets.push_back(buffer.size());
+    batch->TokenTypes.push_back(NTokenizer::ETokenType::Unknown);
+}
+
+static void SplitBatchByDelimiter(
+    TConstArrayRef<TStringBuf> documents,
+    const NTokenizer::TTokenizerOptions& options,
+    ILemmerImplementation* lemmer,
+    NTokenizer::TTokenizedBatch* batch
+) {
+    const auto addToken = [&](TStringBuf token) {
+        if (!options.SkipEmpty || !token.empty()) {
+            AppendDelimitedToken(token, options, lemmer, batch);
+        }
+    };
+
+    const TStringBuf delimiter = options.SplitBySet ? TStringBuf(options.Delimiter.c_str()) : TStringBuf(options.Delimiter);
+    const TDelimiterSet delimiterSet(delimiter.size() == 1 || options.SplitBySet ? delimiter : TStringBuf());
+    for (TStringBuf document : documents) {
+        if (delimiter.empty()) {
+            static thread_local TVector<TStringBuf> tokens;
+            SplitByDelimiter(document, options.Delimiter, options.SplitBySet, options.SkipEmpty, &tokens);
+            for (TStringBuf token : tokens) {
+                AppendDelimitedToken(token, options, lemmer, batch);
+            }
+        } else if (delimiter.size() == 1 || options.SplitBySet) {
+            size_t tokenStart = 0;
+            delimiterSet.ForEachDelimiter(document, [&](size_t position) {
+                addToken(document.SubStr(tokenStart, position - tokenStart));
+                tokenStart = position + 1;
+            });
+            addToken(document.SubStr(tokenStart));
+        } else {
+            size_t tokenStart = 0;
+            for (size_t position; (position = document.find(delimiter, tokenStart)) != TStringBuf::npos;) {
+                addToken(document.SubStr(tokenStart, position - tokenStart));
+                tokenStart = position + delimiter.size();
+            }
+            addToken(document.SubStr(tokenStart));
+        }
+        batch->DocumentOffsets.push_back(batch->TokenTypes.size());
+    }
+}
+
+void NTokenizer::TTokenizedBatch::Clear() {
+    Buffer.clear();
+    TokenOffsets.assign(1, 0);
+    DocumentOffsets.assign(1, 0);
+    TokenTypes.clear();
+    Tokens.clear();
+}
+
 NTokenizer::TTokenizer::TTokenizer()
     : Lemmer(TLemmerImplementationFactory::Construct(EImplementationType::Trivial, {}))
 {
@@ -322,6 +572,29 @@ TVector<TStringBuf> NTokenizer::TTokenizer::TokenizeWithoutCopy(TStringBuf input
     return tokens;
 }
 
+void NTokenizer::TTokenizer::TokenizeBatch(TConstArrayRef<TStringBuf> documents, TTokenizedBatch* batch) const {
+    batch->Clear();
+    size_t totalSize = 0;
+    for (TStringBuf document : documents) {
+        totalSize += document.size();
+    }
+    batch->Buffer.reserve(totalSize);
+
+    if (Options.SeparatorType == NTokenizer::ESeparatorType::BySense) {
+        SplitBatchBySense(documents, Options, Lemmer.Get(), batch);
+    } else {
+        Y_ENSURE(Options.SeparatorType == NTokenizer::ESeparatorType::ByDelimiter, "Unsupported SeparatorType");
+        SplitBatchByDelimiter(documents, Options, Lemmer.Get(), batch);
+    }
+
+    batch->Tokens.resize(batch->GetTokenCount());
+    const char* buffer = batch->Buffer.data();
+    for (size_t tokenIdx = 0; tokenIdx < batch->Tokens.size(); ++tokenIdx) {
+        const size_t begin = batch->TokenOffsets[tokenIdx];
+        batch->Tokens[tokenIdx] = TStringBuf(buffer + begin, batch->TokenOffsets[tokenIdx + 1] - begin);
+    }
+}
+
 NTokenizer::TTokenizerOptions NTokenizer::TTokenizer::GetOptions() const {
     return Options;
 }
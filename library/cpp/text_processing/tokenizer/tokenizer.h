@@ -3,10 +3,50 @@
 #include "lemmer_impl.h"
 #include "options.h"
 
+#include <util/generic/array_ref.h>
 #include <util/generic/ptr.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
 
 namespace NTextProcessing::NTokenizer {
 
+    /* Tokens of several documents in CSR layout: bytes of all tokens are stored one after another in Buffer,
+     * token i is Buffer[TokenOffsets[i], TokenOffsets[i + 1]) and tokens of document j are
+     * [DocumentOffsets[j], DocumentOffsets[j + 1]). Tokens holds views into Buffer, so GetTokens(j)
+     * can be passed to IDictionary::Apply without materializing strings.
+     * Reusing one batch for many calls of TTokenizer::TokenizeBatch doesn't allocate memory once
+     * its buffers are large enough.
+     */
+    struct TTokenizedBatch {
+        TString Buffer;
+        TVector<size_t> TokenOffsets = {0};
+        TVector<size_t> DocumentOffsets = {0};
+        TVector<ETokenType> TokenTypes;
+        TVector<TStringBuf> Tokens;
+
+        size_t GetDocumentCount() const {
+            return DocumentOffsets.size() - 1;
+        }
+
+        size_t GetTokenCount() const {
+            return TokenOffsets.size() - 1;
+        }
+
+        TConstArrayRef<TStringBuf> GetTokens(size_t documentIdx) const {
+            return TConstArrayRef<TStringBuf>(Tokens).Slice(
+                DocumentOffsets[documentIdx],
+                DocumentOffsets[documentIdx + 1] - DocumentOffsets[documentIdx]);
+        }
+
+        TConstArrayRef<ETokenType> GetTokenTypes(size_t documentIdx) const {
+            return TConstArrayRef<ETokenType>(TokenTypes).Slice(
+                DocumentOffsets[documentIdx],
+                DocumentOffsets[documentIdx + 1] - DocumentOffsets[documentIdx]);
+        }
+
+        void Clear();
+    };
+
     class TTokenizer : public TMoveOnly {
     public:
         TTokenizer();
@@ -22,6 +62,9 @@ namespace NTextProcessing::NTokenizer {
         void TokenizeWithoutCopy(TStringBuf inputString, TVector<TStringBuf>* tokens) const;
         TVector<TStringBuf> TokenizeWithoutCopy(TStringBuf inputString) const;
 
+        // Same tokens as Tokenize for every document, batch is cleared first.
+        void TokenizeBatch(TConstArrayRef<TStringBuf> documents, TTokenizedBatch* batch) const;
+
         TTokenizerOptions GetOptions() const;
 
         bool NeedToModifyTokens() const;
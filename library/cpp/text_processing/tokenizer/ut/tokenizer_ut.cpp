@@ -7,6 +7,7 @@
 
 using NTextProcessing::NTokenizer::TTokenizerOptions;
 using NTextProcessing::NTokenizer::TTokenizer;
+using NTextProcessing::NTokenizer::TTokenizedBatch;
 using NTextProcessing::NTokenizer::ETokenType;
 using NTextProcessing::NTokenizer::ESeparatorType;
 using NTextProcessing::NTokenizer::ETokenProcessPolicy;
@@ -14,6 +15,24 @@ using NTextProcessing::NTokenizer::ESubTokensPolicy;
 using NTextProcessing::NTokenizer::TokenizerOptionsToJson;
 using NTextProcessing::NTokenizer::JsonToTokenizerOptions;
 
+static void AssertBatchEqualsTokenize(const TTokenizer& tokenizer, const TVector<TStringBuf>& documents) {
+    TTokenizedBatch batch;
+    tokenizer.TokenizeBatch(documents, &batch);
+    UNIT_ASSERT_VALUES_EQUAL(batch.GetDocumentCount(), documents.size());
+    for (auto documentIdx : xrange(documents.size())) {
+        TVector<TString> tokens;
+        TVector<ETokenType> tokenTypes;
+        tokenizer.Tokenize(documents[documentIdx], &tokens, &tokenTypes);
+        const auto batchTokens = batch.GetTokens(documentIdx);
+        const auto batchTokenTypes = batch.GetTokenTypes(documentIdx);
+        UNIT_ASSERT_VALUES_EQUAL_C(batchTokens.size(), tokens.size(), documents[documentIdx]);
+        for (auto i : xrange(tokens.size())) {
+            UNIT_ASSERT_VALUES_EQUAL(batchTokens[i], tokens[i]);
+            UNIT_ASSERT_EQUAL(batchTokenTypes[i], tokenTypes[i]);
+        }
+    }
+}
+
 static void AssertTokensEqual(const TVector<TString>& canonicalTokens, const TVector<TString>& tokens) {
     for (auto i : xrange(canonicalTokens.size())) {
         UNIT_ASSERT_VALUES_EQUAL(canonicalTokens[i], tokens[i]);
@@ -238,4 +257,61 @@ Y_UNIT_TEST_SUITE(TokenizerTests) {
 
     }
 
+    Y_UNIT_TEST(TokenizerBatchByDelimiterTest) {
+
+        TVector<TTokenizerOptions> options(7);
+        options[1].Lowercasing = true;
+        options[1].NumberProcessPolicy = ETokenProcessPolicy::Replace;
+        options[2].SplitBySet = true;
+        options[2].Delimiter = ",; ";
+        options[2].SkipEmpty = false;
+        options[2].NumberProcessPolicy = ETokenProcessPolicy::Skip;
+        options[3].SplitBySet = true;
+        options[3].Delimiter = ",;.!? ";
+        options[3].Lowercasing = true;
+        options[4].Delimiter = ", ";
+        options[4].SkipEmpty = false;
+        options[5].Delimiter = "\t";
+        options[5].SkipEmpty = false;
+        options[5].Lowercasing = true;
+        options[6].Delimiter = "";
+
+        const TVector<TStringBuf> documents = {
+            "i love catboost",
+            "",
+            " He has 649 apples,  and 7 pears; \t!",
+            "Very long document with many separators, numbers 1 2 3, and UPPER CASE WORDS...",
+            "Кириллица И ЛАТИНИЦА, mixed;Вместе 42",
+            ",,;; , ",
+            "a\tb\t\tc\t"
+        };
+        for (auto& option : options) {
+            option.SeparatorType = ESeparatorType::ByDelimiter;
+            AssertBatchEqualsTokenize(TTokenizer(option), documents);
+        }
+
+    }
+
+    Y_UNIT_TEST(TokenizerBatchBySenseTest) {
+
+        TVector<TTokenizerOptions> options(3);
+        options[0].TokenTypes = {ETokenType::Word, ETokenType::Number, ETokenType::Punctuation};
+        options[1].Lowercasing = true;
+        options[1].NumberProcessPolicy = ETokenProcessPolicy::Replace;
+        options[2].SubTokensPolicy = ESubTokensPolicy::SeveralTokens;
+        options[2].NumberProcessPolicy = ETokenProcessPolicy::Skip;
+
+        const TVector<TStringBuf> documents = {
+            "i love catboost",
+            "",
+            "He has 649 apples, and 7 pears!",
+            "Кириллица И ЛАТИНИЦА: mixed-case well-known words"
+        };
+        for (auto& option : options) {
+            option.SeparatorType = ESeparatorType::BySense;
+            AssertBatchEqualsTokenize(TTokenizer(option), documents);
+        }
+
+    }
+
 }
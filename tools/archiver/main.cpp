@@ -276,9 +276,9 @@ namespace {
     };
 
     struct TDeduplicationArchiveWriter {
-        TDeduplicationArchiveWriter(const TDuplicatesMap& duplicatesMap, IOutputStream* out, bool compress)
+        TDeduplicationArchiveWriter(const TDuplicatesMap& duplicatesMap, IOutputStream* out, const TArchiveWriterOptions& options)
             : DuplicatesMap(duplicatesMap)
-            , Writer(out, compress)
+            , Writer(out, options)
         {}
 
         void Finish() {
@@ -510,6 +510,26 @@ int main(int argc, char** argv) {
         .Optional()
         .StoreValue(&doNotZip, true);
 
+    TArchiveWriterOptions writerOptions;
+    opts.AddLongOption("codec", "Compress files by blocks with given blockcodecs codec, e.g. zstd_1 (not readable by old readers)")
+        .RequiredArgument("<codec>")
+        .StoreResult(&writerOptions.Codec);
+
+    opts.AddLongOption("block-size", "Block size for --codec")
+        .RequiredArgument("<size>")
+        .DefaultValue(ToString(writerOptions.BlockSize))
+        .StoreResult(&writerOptions.BlockSize);
+
+    opts.AddLongOption("threads", "Number of compression threads for --codec")
+        .RequiredArgument("<count>")
+        .DefaultValue(ToString(writerOptions.ThreadCount))
+        .StoreResult(&writerOptions.ThreadCount);
+
+    opts.AddLongOption("align", "Alignment of files stored with --plain, e.g. 4096 to mmap them")
+        .RequiredArgument("<bytes>")
+        .DefaultValue(ToString(writerOptions.DataAlignment))
+        .StoreResult(&writerOptions.DataAlignment);
+
     bool deduplicate = false;
     opts.AddLongOption("deduplicate", "Turn on file-wise deduplication")
         .NoArgument()
@@ -667,7 +687,8 @@ int main(int argc, char** argv) {
                     }
                 }
                 duplicatesMap.Finish();
-                TDeduplicationArchiveWriter w(duplicatesMap, out, !doNotZip);
+                writerOptions.Compress = !doNotZip;
+                TDeduplicationArchiveWriter w(duplicatesMap, out, writerOptions);
                 for (const auto& rec: recs) {
                     rec.Recurse(w);
                 }
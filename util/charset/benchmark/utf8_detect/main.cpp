@@ -0,0 +1,101 @@
+#include <library/cpp/testing/benchmark/bench.h>
+
+#include <util/random/random.h>
+#include <util/generic/singleton.h>
+#include <util/generic/vector.h>
+#include <util/charset/utf8.h>
+
+namespace {
+    // mostly ascii with one cyrillic symbol in twenty
+    template <size_t N>
+    struct TRandomAsciiHeavyString: public TVector<char> {
+        inline TRandomAsciiHeavyString() {
+            TVector<unsigned char> data(N * 2);
+            unsigned char* textEnd = data.data();
+            for (size_t i = 0; i < N; ++i) {
+                size_t runeLen;
+                WriteUTF8Char(RandomNumber<ui32>(20) ? RandomNumber<ui32>(0x5F) + 0x20 : RandomNumber<ui32>(0x40) + 0x410, runeLen, textEnd);
+                textEnd += runeLen;
+            }
+            assign(reinterpret_cast<const char*>(data.data()), reinterpret_cast<const char*>(textEnd));
+        }
+    };
+
+    // cjk ideographs with one ascii symbol in ten
+    template <size_t N>
+    struct TRandomCjkHeavyString: public TVector<char> {
+        inline TRandomCjkHeavyString() {
+            TVector<unsigned char> data(N * 3);
+            unsigned char* textEnd = data.data();
+            for (size_t i = 0; i < N; ++i) {
+                size_t runeLen;
+                WriteUTF8Char(RandomNumber<ui32>(10) ? RandomNumber<ui32>(0x5000) + 0x4E00 : RandomNumber<ui32>(0x5F) + 0x20, runeLen, textEnd);
+                textEnd += runeLen;
+            }
+            assign(reinterpret_cast<const char*>(data.data()), reinterpret_cast<const char*>(textEnd));
+        }
+    };
+
+    using RAS10 = TRandomAsciiHeavyString<10>;
+    using RAS1000 = TRandomAsciiHeavyString<1000>;
+    using RAS1000000 = TRandomAsciiHeavyString<1000000>;
+
+    using RCS10 = TRandomCjkHeavyString<10>;
+    using RCS1000 = TRandomCjkHeavyString<1000>;
+    using RCS1000000 = TRandomCjkHeavyString<1000000>;
+}
+
+static EUTF8Detect UTF8DetectScalar(const char* s, size_t len) {
+    const unsigned char* cur = reinterpret_cast<const unsigned char*>(s);
+    const unsigned char* last = cur + len;
+    EUTF8Detect res = ASCII;
+    while (cur < last) {
+        wchar32 rune;
+        size_t runeLen;
+        if (SafeReadUTF8Char(rune, runeLen, cur, last) != RECODE_OK) {
+            return NotUTF8;
+        }
+        if (runeLen > 1) {
+            res = UTF8;
+        }
+        cur += runeLen;
+    }
+    return res;
+}
+
+static EUTF8Detect UTF8DetectSSE(const char* s, size_t len) {
+    return UTF8Detect(s, len);
+}
+
+static EUTF8Detect UTF8DetectStrict(const char* s, size_t len) {
+    return IsWellFormedUTF8(s, len) ? UTF8 : NotUTF8;
+}
+
+#define UTF8_DETECT_BENCHMARK(impl, text, length)                                \
+    Y_CPU_BENCHMARK(UTF8Detect##text##impl##length, iface) {                     \
+        const auto& data = *Singleton<R##text##S##length>();                     \
+        for (size_t x = 0; x < iface.Iterations(); ++x) {                        \
+            NBench::Clobber();                                                   \
+            Y_DO_NOT_OPTIMIZE_AWAY(UTF8Detect##impl(data.data(), data.size()));  \
+        }                                                                        \
+    }
+
+UTF8_DETECT_BENCHMARK(Scalar, A, 10);
+UTF8_DETECT_BENCHMARK(SSE, A, 10);
+UTF8_DETECT_BENCHMARK(Strict, A, 10);
+UTF8_DETECT_BENCHMARK(Scalar, A, 1000);
+UTF8_DETECT_BENCHMARK(SSE, A, 1000);
+UTF8_DETECT_BENCHMARK(Strict, A, 1000);
+UTF8_DETECT_BENCHMARK(Scalar, A, 1000000);
+UTF8_DETECT_BENCHMARK(SSE, A, 1000000);
+UTF8_DETECT_BENCHMARK(Strict, A, 1000000);
+
+UTF8_DETECT_BENCHMARK(Scalar, C, 10);
+UTF8_DETECT_BENCHMARK(SSE, C, 10);
+UTF8_DETECT_BENCHMARK(Strict, C, 10);
+UTF8_DETECT_BENCHMARK(Scalar, C, 1000);
+UTF8_DETECT_BENCHMARK(SSE, C, 1000);
+UTF8_DETECT_BENCHMARK(Strict, C, 1000);
+UTF8_DETECT_BENCHMARK(Scalar, C, 1000000);
+UTF8_DETECT_BENCHMARK(SSE, C, 1000000);
+UTF8_DETECT_BENCHMARK(Strict, C, 1000000);
@@ -33,6 +33,23 @@ namespace {
         }
     };
 
+    // cjk ideographs with some ascii and a supplementary plane symbol in fifty
+    template <size_t N>
+    struct TRandomCjkString: public TVector<char> {
+        inline TRandomCjkString() {
+            TVector<unsigned char> data(N * 4);
+            unsigned char* textEnd = data.begin();
+            for (size_t i = 0; i < N; ++i) {
+                const ui32 kind = RandomNumber<ui32>(50);
+                const wchar32 rune = kind == 0 ? RandomNumber<ui32>(0xA000) + 0x20000 : kind < 6 ? RandomNumber<ui32>(0x5F) + 0x20 : RandomNumber<ui32>(0x5000) + 0x4E00;
+                size_t runeLen;
+                WriteUTF8Char(rune, runeLen, textEnd);
+                textEnd += runeLen;
+            }
+            assign(reinterpret_cast<const char*>(data.begin()), reinterpret_cast<const char*>(textEnd));
+        }
+    };
+
     using RAS1 = TRandomAsciiString<1>;
     using RAS10 = TRandomAsciiString<10>;
     using RAS50 = TRandomAsciiString<50>;
@@ -43,6 +60,10 @@ namespace {
     using RRS10 = TRandomRuString<10>;
     using RRS1000 = TRandomRuString<1000>;
     using RRS1000000 = TRandomRuString<1000000>;
+
+    using RCS10 = TRandomCjkString<10>;
+    using RCS1000 = TRandomCjkString<1000>;
+    using RCS1000000 = TRandomCjkString<1000000>;
 }
 
 #ifdef _sse2_
@@ -124,6 +145,15 @@ static wchar32 WBUF_UTF32[10000000];
         }                                                                                                       \
     }
 
+#define UTF8_TO_WIDE_SCALAR_BENCHMARK_CJK(impl, length, to)                                                     \
+    Y_CPU_BENCHMARK(UTF8ToWideCJK##impl##length##to, iface) {                                                   \
+        const auto& data = *Singleton<RCS##length>();                                                           \
+        for (size_t x = 0; x < iface.Iterations(); ++x) {                                                       \
+            size_t written = 0;                                                                                 \
+            Y_DO_NOT_OPTIMIZE_AWAY(UTF8ToWideImpl##impl<false>(data.begin(), data.size(), WBUF_##to, written)); \
+        }                                                                                                       \
+    }
+
 UTF8_TO_WIDE_SCALAR_BENCHMARK_ASCII(Scalar, 1, UTF16);
 UTF8_TO_WIDE_SCALAR_BENCHMARK_ASCII(SSE, 1, UTF16);
 UTF8_TO_WIDE_SCALAR_BENCHMARK_ASCII(Scalar, 10, UTF16);
@@ -159,3 +189,17 @@ UTF8_TO_WIDE_SCALAR_BENCHMARK_RU(Scalar, 1000, UTF32);
 UTF8_TO_WIDE_SCALAR_BENCHMARK_RU(SSE, 1000, UTF32);
 UTF8_TO_WIDE_SCALAR_BENCHMARK_RU(Scalar, 1000000, UTF32);
 UTF8_TO_WIDE_SCALAR_BENCHMARK_RU(SSE, 1000000, UTF32);
+
+UTF8_TO_WIDE_SCALAR_BENCHMARK_CJK(Scalar, 10, UTF16);
+UTF8_TO_WIDE_SCALAR_BENCHMARK_CJK(SSE, 10, UTF16);
+UTF8_TO_WIDE_SCALAR_BENCHMARK_CJK(Scalar, 1000, UTF16);
+UTF8_TO_WIDE_SCALAR_BENCHMARK_CJK(SSE, 1000, UTF16);
+UTF8_TO_WIDE_SCALAR_BENCHMARK_CJK(Scalar, 1000000, UTF16);
+UTF8_TO_WIDE_SCALAR_BENCHMARK_CJK(SSE, 1000000, UTF16);
+
+UTF8_TO_WIDE_SCALAR_BENCHMARK_CJK(Scalar, 10, UTF32);
+UTF8_TO_WIDE_SCALAR_BENCHMARK_CJK(SSE, 10, UTF32);
+UTF8_TO_WIDE_SCALAR_BENCHMARK_CJK(Scalar, 1000, UTF32);
+UTF8_TO_WIDE_SCALAR_BENCHMARK_CJK(SSE, 1000, UTF32);
+UTF8_TO_WIDE_SCALAR_BENCHMARK_CJK(Scalar, 1000000, UTF32);
+UTF8_TO_WIDE_SCALAR_BENCHMARK_CJK(SSE, 1000000, UTF32);
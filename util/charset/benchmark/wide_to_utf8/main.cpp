@@ -0,0 +1,97 @@
+#include <library/cpp/testing/benchmark/bench.h>
+
+#include <util/random/random.h>
+#include <util/generic/singleton.h>
+#include <util/generic/vector.h>
+#include <util/charset/wide.h>
+
+namespace {
+    // mostly ascii with one cyrillic symbol in twenty
+    template <typename TCharType, size_t N>
+    struct TRandomAsciiHeavyString: public TVector<TCharType> {
+        inline TRandomAsciiHeavyString() {
+            this->reserve(N);
+            for (size_t i = 0; i < N; ++i) {
+                this->push_back(RandomNumber<ui32>(20) ? RandomNumber<ui32>(0x5F) + 0x20 : RandomNumber<ui32>(0x40) + 0x410);
+            }
+        }
+    };
+
+    // cjk ideographs with one ascii symbol in ten
+    template <typename TCharType, size_t N>
+    struct TRandomCjkHeavyString: public TVector<TCharType> {
+        inline TRandomCjkHeavyString() {
+            this->reserve(N);
+            for (size_t i = 0; i < N; ++i) {
+                this->push_back(RandomNumber<ui32>(10) ? RandomNumber<ui32>(0x5000) + 0x4E00 : RandomNumber<ui32>(0x5F) + 0x20);
+            }
+        }
+    };
+
+    template <size_t N>
+    using RAS_UTF16 = TRandomAsciiHeavyString<wchar16, N>;
+    template <size_t N>
+    using RAS_UTF32 = TRandomAsciiHeavyString<wchar32, N>;
+    template <size_t N>
+    using RCS_UTF16 = TRandomCjkHeavyString<wchar16, N>;
+    template <size_t N>
+    using RCS_UTF32 = TRandomCjkHeavyString<wchar32, N>;
+}
+
+template <typename TCharType>
+inline void WideToUTF8Scalar(const TCharType* text, size_t len, char* dest, size_t& written) {
+    const TCharType* cur = text;
+    const TCharType* last = text + len;
+    unsigned char* p = reinterpret_cast<unsigned char*>(dest);
+    while (cur != last) {
+        size_t runeLen;
+        WriteUTF8Char(ReadSymbolAndAdvance(cur, last), runeLen, p);
+        p += runeLen;
+    }
+    written = p - reinterpret_cast<unsigned char*>(dest);
+}
+
+template <typename TCharType>
+inline void WideToUTF8SSE(const TCharType* text, size_t len, char* dest, size_t& written) {
+    WideToUTF8(text, len, dest, written);
+}
+
+static char BUF_UTF8[4000000];
+
+#define WIDE_TO_UTF8_BENCHMARK(impl, text, length, from)                   \
+    Y_CPU_BENCHMARK(WideToUTF8##text##impl##length##from, iface) {         \
+        const auto& data = *Singleton<R##text##S_##from<length>>();        \
+        for (size_t x = 0; x < iface.Iterations(); ++x) {                  \
+            size_t written = 0;                                            \
+            WideToUTF8##impl(data.data(), data.size(), BUF_UTF8, written); \
+            Y_DO_NOT_OPTIMIZE_AWAY(written);                               \
+        }                                                                  \
+    }
+
+WIDE_TO_UTF8_BENCHMARK(Scalar, A, 10, UTF16);
+WIDE_TO_UTF8_BENCHMARK(SSE, A, 10, UTF16);
+WIDE_TO_UTF8_BENCHMARK(Scalar, A, 1000, UTF16);
+WIDE_TO_UTF8_BENCHMARK(SSE, A, 1000, UTF16);
+WIDE_TO_UTF8_BENCHMARK(Scalar, A, 1000000, UTF16);
+WIDE_TO_UTF8_BENCHMARK(SSE, A, 1000000, UTF16);
+
+WIDE_TO_UTF8_BENCHMARK(Scalar, C, 10, UTF16);
+WIDE_TO_UTF8_BENCHMARK(SSE, C, 10, UTF16);
+WIDE_TO_UTF8_BENCHMARK(Scalar, C, 1000, UTF16);
+WIDE_TO_UTF8_BENCHMARK(SSE, C, 1000, UTF16);
+WIDE_TO_UTF8_BENCHMARK(Scalar, C, 1000000, UTF16);
+WIDE_TO_UTF8_BENCHMARK(SSE, C, 1000000, UTF16);
+
+WIDE_TO_UTF8_BENCHMARK(Scalar, A, 10, UTF32);
+WIDE_TO_UTF8_BENCHMARK(SSE, A, 10, UTF32);
+WIDE_TO_UTF8_BENCHMARK(Scalar, A, 1000, UTF32);
+WIDE_TO_UTF8_BENCHMARK(SSE, A, 1000, UTF32);
+WIDE_TO_UTF8_BENCHMARK(Scalar, A, 1000000, UTF32);
+WIDE_TO_UTF8_BENCHMARK(SSE, A, 1000000, UTF32);
+
+WIDE_TO_UTF8_BENCHMARK(Scalar, C, 10, UTF32);
+WIDE_TO_UTF8_BENCHMARK(SSE, C, 10, UTF32);
+WIDE_TO_UTF8_BENCHMARK(Scalar, C, 1000, UTF32);
+WIDE_TO_UTF8_BENCHMARK(SSE, C, 1000, UTF32);
+WIDE_TO_UTF8_BENCHMARK(Scalar, C, 1000000, UTF32);
+WIDE_TO_UTF8_BENCHMARK(SSE, C, 1000000, UTF32);
@@ -1,6 +1,8 @@
 #include "unidata.h"
 #include "utf8.h"
 
+#include <util/system/cpu_id.h>
+
 namespace {
     enum class ECaseConversion {
         ToUpper,
@@ -105,13 +107,23 @@ TStringBuf SubstrUTF8(const TStringBuf str, size_t pos, size_t len) {
     return TStringBuf(start, end - start);
 }
 
-EUTF8Detect UTF8Detect(const char* s, size_t len) {
+static EUTF8Detect UTF8DetectImpl(const char* s, size_t len, bool rejectSurrogates) {
     const unsigned char* s0 = (const unsigned char*)s;
     const unsigned char* send = s0 + len;
     wchar32 rune;
     size_t rune_len;
     EUTF8Detect res = ASCII;
 
+#ifdef _sse_
+    if (len >= 16 && NX86::CachedHaveSSE41()) {
+        bool ascii = true;
+        ::NDetail::UTF8DetectImplSSE41(s0, send, rejectSurrogates, ascii);
+        if (!ascii) {
+            res = UTF8;
+        }
+    }
+#endif
+
     while (s0 < send) {
         RECODE_RESULT rr = SafeReadUTF8Char(rune, rune_len, s0, send);
 
@@ -121,6 +133,9 @@ EUTF8Detect UTF8Detect(const char* s, size_t len) {
 
         if (rune_len > 1) {
             res = UTF8;
+            if (rejectSurrogates && rune >= 0xD800 && rune <= 0xDFFF) {
+                return NotUTF8;
+            }
         }
 
         s0 += rune_len;
@@ -129,6 +144,14 @@ EUTF8Detect UTF8Detect(const char* s, size_t len) {
     return res;
 }
 
+EUTF8Detect UTF8Detect(const char* s, size_t len) {
+    return UTF8DetectImpl(s, len, false);
+}
+
+bool IsWellFormedUTF8(const char* input, size_t len) {
+    return UTF8DetectImpl(input, len, true) != NotUTF8;
+}
+
 bool ToLowerUTF8Impl(const char* beg, size_t n, TString& newString) {
     return ConvertCaseUTF8Impl(ECaseConversion::ToLower, beg, n, newString);
 }
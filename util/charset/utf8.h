@@ -355,6 +355,11 @@ enum EUTF8Detect {
 
 EUTF8Detect UTF8Detect(const char* s, size_t len);
 
+namespace NDetail {
+    //! skips the valid prefix of the text up to a symbol boundary, @c ascii is cleared if there are non-ascii symbols in it
+    void UTF8DetectImplSSE41(const unsigned char*& cur, const unsigned char* last, bool rejectSurrogates, bool& ascii) noexcept;
+}
+
 inline EUTF8Detect UTF8Detect(const TStringBuf input) {
     return UTF8Detect(input.data(), input.size());
 }
@@ -367,6 +372,13 @@ inline bool IsUtf(const TStringBuf input) {
     return IsUtf(input.data(), input.size());
 }
 
+//! checks that the text is UTF-8 as RFC 3629 defines it, unlike @c IsUtf encoded surrogates (U+D800..U+DFFF) are rejected
+bool IsWellFormedUTF8(const char* input, size_t len);
+
+inline bool IsWellFormedUTF8(const TStringBuf input) {
+    return IsWellFormedUTF8(input.data(), input.size());
+}
+
 //! returns true, if result is not the same as input, and put it in newString
 //! returns false, if result is unmodified
 bool ToLowerUTF8Impl(const char* beg, size_t n, TString& newString);
@@ -0,0 +1,132 @@
+#include <util/charset/utf8.h>
+
+#ifdef SSE41_STUB
+
+namespace NDetail {
+    void UTF8DetectImplSSE41(const unsigned char*&, const unsigned char*, bool, bool&) noexcept {
+    }
+}
+
+#else
+
+#include <util/system/compiler.h>
+
+#include <smmintrin.h>
+
+//checks 16 bytes at a time, stops before the first error or less then 16 bytes left
+//the lookup algorithm is from "Validating UTF-8 In Less Than One Instruction Per Byte" by J. Keiser and D. Lemire:
+//errors of two adjacent bytes are found by three nibble lookups (the high and the low nibble of the previous byte
+//and the high nibble of the current one), expected third and fourth bytes of long sequences are checked separately
+
+namespace {
+    constexpr char TOO_SHORT = 1 << 0;         // 11______ 0_______ or 11______ 11______
+    constexpr char TOO_LONG = 1 << 1;          // 0_______ 10______
+    constexpr char OVERLONG_3 = 1 << 2;        // 11100000 100_____
+    constexpr char TOO_LARGE = 1 << 3;         // 11110100 1001____ or 101_____, 11110101+ 1001____ or 101_____
+    constexpr char SURROGATE = 1 << 4;         // 11101101 101_____
+    constexpr char OVERLONG_2 = 1 << 5;        // 1100000_ 10______
+    constexpr char TOO_LARGE_1000 = 1 << 6;    // 11110101+ 1000____
+    constexpr char OVERLONG_4 = 1 << 6;        // 11110000 1000____
+    constexpr char TWO_CONTS = (char)(1 << 7); // 10______ 10______
+    constexpr char CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+    Y_FORCE_INLINE __m128i HighNibbles(__m128i bytes) {
+        return _mm_and_si128(_mm_srli_epi16(bytes, 4), _mm_set1_epi8(0x0f));
+    }
+
+    Y_FORCE_INLINE __m128i LowNibbles(__m128i bytes) {
+        return _mm_and_si128(bytes, _mm_set1_epi8(0x0f));
+    }
+
+    //nonzero bytes mark errors of the sequences which end in input
+    Y_FORCE_INLINE __m128i CheckUTF8Chunk(__m128i input, __m128i prevInput, __m128i byte1HighTable) {
+        const __m128i byte1LowTable = _mm_setr_epi8(
+            CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+            CARRY | OVERLONG_2,
+            CARRY,
+            CARRY,
+            CARRY | TOO_LARGE,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000);
+        const __m128i byte2HighTable = _mm_setr_epi8(
+            TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+            TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+            TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT);
+
+        const __m128i prev1 = _mm_alignr_epi8(input, prevInput, 15);
+        const __m128i specialCases = _mm_and_si128(
+            _mm_and_si128(
+                _mm_shuffle_epi8(byte1HighTable, HighNibbles(prev1)),
+                _mm_shuffle_epi8(byte1LowTable, LowNibbles(prev1))),
+            _mm_shuffle_epi8(byte2HighTable, HighNibbles(input)));
+
+        //the third byte after 1110____ and the fourth byte after 11110___ must be continuations,
+        //they are exactly the continuations which aren't marked as errors by the lookup
+        const __m128i prev2 = _mm_alignr_epi8(input, prevInput, 14);
+        const __m128i prev3 = _mm_alignr_epi8(input, prevInput, 13);
+        const __m128i isThirdByte = _mm_subs_epu8(prev2, _mm_set1_epi8(0xe0 - 0x80));
+        const __m128i isFourthByte = _mm_subs_epu8(prev3, _mm_set1_epi8(0xf0 - 0x80));
+        const __m128i mustBeContinuation = _mm_and_si128(_mm_or_si128(isThirdByte, isFourthByte), _mm_set1_epi8((char)0x80));
+        return _mm_xor_si128(mustBeContinuation, specialCases);
+    }
+}
+
+namespace NDetail {
+    void UTF8DetectImplSSE41(const unsigned char*& cur, const unsigned char* last, bool rejectSurrogates, bool& ascii) noexcept {
+        const __m128i byte1HighTable = _mm_setr_epi8(
+            TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+            TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+            TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+            TOO_SHORT | OVERLONG_2,
+            TOO_SHORT,
+            rejectSurrogates ? TOO_SHORT | OVERLONG_3 | SURROGATE : TOO_SHORT | OVERLONG_3,
+            TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4);
+
+        const unsigned char* const begin = cur;
+        __m128i prevInput = _mm_setzero_si128();
+        __m128i nonAscii = _mm_setzero_si128();
+        while (cur + 16 <= last) {
+            const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur));
+            //an ascii chunk after an ascii chunk has nothing to check
+            if (_mm_movemask_epi8(_mm_or_si128(input, prevInput))) {
+                const __m128i error = CheckUTF8Chunk(input, prevInput, byte1HighTable);
+                if (!_mm_testz_si128(error, error)) {
+                    break;
+                }
+                nonAscii = _mm_or_si128(nonAscii, input);
+            }
+            prevInput = input;
+            cur += 16;
+        }
+        if (_mm_movemask_epi8(nonAscii)) {
+            ascii = false;
+        }
+
+        //the last symbol may be incomplete or followed by an error, it's left for the scalar processing
+        if (cur != begin) {
+            const unsigned char* symbolBegin = cur;
+            while (symbolBegin != begin && cur - symbolBegin < 3 && IsUTF8ContinuationByte(symbolBegin[-1])) {
+                --symbolBegin;
+            }
+            if (symbolBegin != begin && symbolBegin[-1] >= 0xc0) {
+                --symbolBegin;
+            }
+            cur = symbolBegin;
+        }
+    }
+}
+
+#endif
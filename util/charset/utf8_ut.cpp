@@ -109,6 +109,49 @@ Y_UNIT_TEST_SUITE(TUtfUtilTest) {
         }
     }
 
+    Y_UNIT_TEST(TestUTF8Detect) {
+        UNIT_ASSERT_EQUAL(UTF8Detect(""), ASCII);
+        UNIT_ASSERT_EQUAL(UTF8Detect("hello, world! hello, world!"), ASCII);
+        UNIT_ASSERT_EQUAL(UTF8Detect("hello, world! привет, мир!"), UTF8);
+        UNIT_ASSERT_EQUAL(UTF8Detect("\xED\xA0\x80"), UTF8); // encoded surrogate
+
+        // texts longer than a vector register with broken symbols at every position
+        const TStringBuf brokenSymbols[] = {"\x80", "\xC0\x80", "\xE0\x9F\xBF", "\xF0\x8F\xBF\xBF", "\xF4\x90\x80\x80", "\xF8\x88\x80\x80\x80", "\xE4\xB8", "\xFF"};
+        const TStringBuf fillers[] = {"a", "я", "中", "\xF0\x9F\x98\x80"};
+        for (const auto& filler : fillers) {
+            for (size_t pos = 0; pos <= 40; ++pos) {
+                TString text;
+                for (size_t i = 0; i < 40; ++i) {
+                    text += filler;
+                }
+                UNIT_ASSERT_EQUAL(UTF8Detect(text), filler.size() == 1 ? ASCII : UTF8);
+                for (const auto& broken : brokenSymbols) {
+                    TString brokenText = text;
+                    brokenText.insert(Min(pos * filler.size(), brokenText.size()), broken);
+                    UNIT_ASSERT_EQUAL(UTF8Detect(brokenText), NotUTF8);
+                    UNIT_ASSERT(!IsWellFormedUTF8(brokenText));
+                }
+            }
+        }
+        // incomplete symbol at the end
+        UNIT_ASSERT_EQUAL(UTF8Detect("abcdefghijklmno\xE4"), NotUTF8);
+        UNIT_ASSERT_EQUAL(UTF8Detect("abcdefghijklmnopqrstuvwxyz01234\xF0\x9F\x98"), NotUTF8);
+    }
+
+    Y_UNIT_TEST(TestIsWellFormedUTF8) {
+        UNIT_ASSERT(IsWellFormedUTF8(""));
+        UNIT_ASSERT(IsWellFormedUTF8("hello, world! привет, мир! 你好，世界！\xF0\x9F\x98\x80\xF4\x8F\xBF\xBF"));
+        for (TStringBuf surrogate : {"\xED\xA0\x80", "\xED\xBF\xBF"}) {
+            for (size_t pos = 0; pos <= 20; ++pos) {
+                TString text = TString(20, 'a').insert(pos, surrogate);
+                UNIT_ASSERT(IsUtf(text));
+                UNIT_ASSERT(!IsWellFormedUTF8(text));
+            }
+        }
+        UNIT_ASSERT(IsWellFormedUTF8(TString(20, 'a') + "\xED\x9F\xBF"));
+        UNIT_ASSERT(IsWellFormedUTF8(TString(20, 'a') + "\xEE\x80\x80"));
+    }
+
     Y_UNIT_TEST(TestUTF8ToWideScalar) {
         TFileInput in(ArcadiaSourceRoot() + TStringBuf("/util/charset/ut/utf8/test1.txt"));
 
@@ -296,6 +296,14 @@ namespace NDetail {
     void UTF8ToWideImplSSE41(const unsigned char*& cur, const unsigned char* last, wchar16*& dest) noexcept;
 
     void UTF8ToWideImplSSE41(const unsigned char*& cur, const unsigned char* last, wchar32*& dest) noexcept;
+
+    template <class TCharType>
+    inline void WideToUTF8ImplSSE41(const TCharType*& /*cur*/, const TCharType* /*last*/, unsigned char*& /*dest*/) noexcept {
+    }
+
+    void WideToUTF8ImplSSE41(const wchar16*& cur, const wchar16* last, unsigned char*& dest) noexcept;
+
+    void WideToUTF8ImplSSE41(const wchar32*& cur, const wchar32* last, unsigned char*& dest) noexcept;
 }
 
 //! @return len if robust and position where encoding stopped if not
@@ -378,10 +386,17 @@ inline TUtf16String UTF8ToWide(const TStringBuf s) {
 //!            destination buffer must have length equal to <tt> len * 4 </tt>
 template <typename TCharType>
 inline void WideToUTF8(const TCharType* text, size_t len, char* dest, size_t& written) {
+    const TCharType* cur = text;
     const TCharType* const last = text + len;
     unsigned char* p = reinterpret_cast<unsigned char*>(dest);
+#ifdef _sse_
+    if (len >= 8 && NX86::CachedHaveSSE41()) {
+        ::NDetail::WideToUTF8ImplSSE41(cur, last, p);
+    }
+#endif
+
     size_t runeLen;
-    for (const TCharType* cur = text; cur != last;) {
+    while (cur != last) {
         WriteUTF8Char(ReadSymbolAndAdvance(cur, last), runeLen, p);
         Y_ASSERT(runeLen <= 4);
         p += runeLen;
@@ -8,6 +8,10 @@ namespace NDetail {
     }
     void UTF8ToWideImplSSE41(const unsigned char*&, const unsigned char*, wchar32*&) noexcept {
     }
+    void WideToUTF8ImplSSE41(const wchar16*&, const wchar16*, unsigned char*&) noexcept {
+    }
+    void WideToUTF8ImplSSE41(const wchar32*&, const wchar32*, unsigned char*&) noexcept {
+    }
 }
 
 #else
@@ -36,8 +40,13 @@ static Y_FORCE_INLINE ui32 Unpack16BytesIntoUtf16IfNoSurrogats(const unsigned ch
         return 16;
     }
 
+    // 0xc0 and 0xc1 are neither begins nor continuations, the scalar processing reports them
+    if (Y_UNLIKELY(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(chunk, _mm_set1_epi8((char)0xfe)), _mm_set1_epi8((char)0xc0))))) {
+        return 0;
+    }
+
     __m128i chunkSigned = _mm_add_epi8(chunk, _mm_set1_epi8(0x80));
-    __m128i isAsciiMask = _mm_cmpgt_epi8(chunk, _mm_set1_epi8(0));
+    __m128i isAsciiMask = _mm_cmpgt_epi8(chunk, _mm_set1_epi8(-1));
 
     __m128i cond2 = _mm_cmplt_epi8(_mm_set1_epi8(0xc2 - 1 - 0x80), chunkSigned);
     __m128i state = _mm_set1_epi8(0x0 | (char)0x80);
@@ -114,6 +123,13 @@ static Y_FORCE_INLINE ui32 Unpack16BytesIntoUtf16IfNoSurrogats(const unsigned ch
             return 0;
         }
 
+        // overlong encoding: 0xe0 followed by 0x80..0x9f, the scalar processing reports it
+        __m128i overlong3 = _mm_and_si128(_mm_slli_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8((char)0xe0)), 1),
+                                          _mm_cmplt_epi8(chunkSigned, _mm_set1_epi8(0xa0 - 0x80)));
+        if (Y_UNLIKELY(_mm_movemask_epi8(overlong3))) {
+            return 0;
+        }
+
         //rune len for start of multi-byte sequences (0 for b0... and b10..., 2 for b110..., etc.)
         __m128i count = _mm_and_si128(state, _mm_set1_epi8(0x7));
 
@@ -190,6 +206,132 @@ static Y_FORCE_INLINE ui32 Unpack16BytesIntoUtf16IfNoSurrogats(const unsigned ch
     return destAdvance;
 }
 
+//decodes symbols of the chunk which can't be vectorized, returns false on a broken symbol
+template <typename TCharType>
+static Y_FORCE_INLINE bool DecodeChunkScalar(const unsigned char*& cur, const unsigned char* last, TCharType*& dest) noexcept {
+    const unsigned char* const chunkEnd = cur + 16;
+    wchar32 rune;
+    while (cur < chunkEnd) {
+        if (ReadUTF8CharAndAdvance(rune, cur, last) != RECODE_OK) {
+            return false;
+        }
+        WriteSymbol(rune, dest);
+    }
+    return true;
+}
+
+//shuffles 2-byte words into ascii bytes and 2-byte sequences by the mask of ascii units
+struct TUtf16ToUtf8ShuffleTable {
+    alignas(16) ui8 Shuffle[256][16] = {};
+    ui8 Size[256] = {};
+
+    constexpr TUtf16ToUtf8ShuffleTable() {
+        for (ui32 mask = 0; mask < 256; ++mask) {
+            ui32 size = 0;
+            for (ui32 unit = 0; unit < 8; ++unit) {
+                Shuffle[mask][size++] = 2 * unit;
+                if (!(mask & (1 << unit))) {
+                    Shuffle[mask][size++] = 2 * unit + 1;
+                }
+            }
+            Size[mask] = size;
+            for (; size < 16; ++size) {
+                Shuffle[mask][size] = 0x80;
+            }
+        }
+    }
+};
+
+static constexpr TUtf16ToUtf8ShuffleTable UTF16_TO_UTF8_SHUFFLES;
+
+//the bytes of 4 symbols of 1 to 3 bytes long are compacted by a shuffle for the masks of 2 and 3 bytes long symbols
+struct TBmpToUtf8ShuffleTable {
+    alignas(16) ui8 Shuffle[256][16] = {};
+    ui8 Size[256] = {};
+
+    constexpr TBmpToUtf8ShuffleTable() {
+        for (ui32 mask = 0; mask < 256; ++mask) {
+            ui32 size = 0;
+            for (ui32 symbol = 0; symbol < 4; ++symbol) {
+                const ui32 runeLen = 1 + ((mask >> symbol) & 1) + ((mask >> (symbol + 4)) & 1);
+                for (ui32 byte = 0; byte < runeLen; ++byte) {
+                    Shuffle[mask][size++] = 4 * symbol + byte;
+                }
+            }
+            Size[mask] = size;
+            for (; size < 16; ++size) {
+                Shuffle[mask][size] = 0x80;
+            }
+        }
+    }
+};
+
+static constexpr TBmpToUtf8ShuffleTable BMP_TO_UTF8_SHUFFLES;
+
+//writes 4 symbols less then 0x10000 which aren't surrogates, 16 bytes are stored
+static Y_FORCE_INLINE ui32 Pack4BmpSymbolsIntoUtf8(__m128i symbols, unsigned char* dest) {
+    __m128i isTwoBytes = _mm_cmpgt_epi32(symbols, _mm_set1_epi32(0x7f));
+    __m128i isThreeBytes = _mm_cmpgt_epi32(symbols, _mm_set1_epi32(0x7ff));
+
+    __m128i first = _mm_blendv_epi8(symbols, _mm_or_si128(_mm_srli_epi32(symbols, 6), _mm_set1_epi32(0xc0)), isTwoBytes);
+    first = _mm_blendv_epi8(first, _mm_or_si128(_mm_srli_epi32(symbols, 12), _mm_set1_epi32(0xe0)), isThreeBytes);
+    __m128i second = _mm_blendv_epi8(symbols, _mm_srli_epi32(symbols, 6), isThreeBytes);
+    second = _mm_or_si128(_mm_and_si128(second, _mm_set1_epi32(0x3f)), _mm_set1_epi32(0x80));
+    __m128i third = _mm_or_si128(_mm_and_si128(symbols, _mm_set1_epi32(0x3f)), _mm_set1_epi32(0x80));
+    __m128i bytes = _mm_or_si128(first, _mm_or_si128(_mm_slli_epi32(second, 8), _mm_slli_epi32(third, 16)));
+
+    ui32 mask = _mm_movemask_ps(_mm_castsi128_ps(isTwoBytes)) | (_mm_movemask_ps(_mm_castsi128_ps(isThreeBytes)) << 4);
+    __m128i shuffle = _mm_load_si128(reinterpret_cast<const __m128i*>(BMP_TO_UTF8_SHUFFLES.Shuffle[mask]));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_shuffle_epi8(bytes, shuffle));
+    return BMP_TO_UTF8_SHUFFLES.Size[mask];
+}
+
+//writes 8 utf16 units, all of them are ascii or less then 0x800 in the most common cases
+//return written bytes count, 0 in case of surrogates
+static Y_FORCE_INLINE ui32 Pack8Utf16UnitsIntoUtf8(__m128i units, unsigned char* dest) {
+    if (_mm_testz_si128(units, _mm_set1_epi16((short)0xff80))) {
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dest), _mm_packus_epi16(units, units));
+        return 8;
+    }
+
+    if (_mm_testz_si128(units, _mm_set1_epi16((short)0xf800))) {
+
+        __m128i lead = _mm_or_si128(_mm_srli_epi16(units, 6), _mm_set1_epi16(0xc0));
+        __m128i trail = _mm_or_si128(_mm_and_si128(units, _mm_set1_epi16(0x3f)), _mm_set1_epi16(0x80));
+        __m128i isAscii = _mm_cmplt_epi16(units, _mm_set1_epi16(0x80));
+        __m128i words = _mm_blendv_epi8(_mm_or_si128(lead, _mm_slli_epi16(trail, 8)), units, isAscii);
+        ui32 mask = _mm_movemask_epi8(_mm_packs_epi16(isAscii, _mm_setzero_si128()));
+        __m128i shuffle = _mm_load_si128(reinterpret_cast<const __m128i*>(UTF16_TO_UTF8_SHUFFLES.Shuffle[mask]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_shuffle_epi8(words, shuffle));
+        return UTF16_TO_UTF8_SHUFFLES.Size[mask];
+    }
+
+    __m128i isSurrogate = _mm_cmpeq_epi16(_mm_and_si128(units, _mm_set1_epi16((short)0xf800)), _mm_set1_epi16((short)0xd800));
+    if (!_mm_testz_si128(isSurrogate, isSurrogate)) {
+        return 0;
+    }
+
+    ui32 size = Pack4BmpSymbolsIntoUtf8(_mm_unpacklo_epi16(units, _mm_setzero_si128()), dest);
+    return size + Pack4BmpSymbolsIntoUtf8(_mm_unpackhi_epi16(units, _mm_setzero_si128()), dest + size);
+}
+
+//encodes symbols of the chunk which can't be vectorized, returns false if the last unit may be a part of a surrogate pair
+template <typename TCharType>
+static Y_FORCE_INLINE bool EncodeChunkScalar(const TCharType*& cur, const TCharType* last, unsigned char*& dest) noexcept {
+    const TCharType* const chunkEnd = cur + 8;
+    size_t runeLen;
+    while (cur < chunkEnd) {
+        if constexpr (sizeof(TCharType) == 2) {
+            if (cur + 1 == last && IsW16SurrogateLead(*cur)) {
+                return false;
+            }
+        }
+        WriteUTF8Char(ReadSymbolAndAdvance(cur, last), runeLen, dest);
+        dest += runeLen;
+    }
+    return true;
+}
+
 namespace NDetail {
     void UTF8ToWideImplSSE41(const unsigned char*& cur, const unsigned char* last, wchar16*& dest) noexcept {
         alignas(16) wchar16 destAligned[16];
@@ -200,7 +342,11 @@ namespace NDetail {
             ui32 dstAdvance = Unpack16BytesIntoUtf16IfNoSurrogats(cur, utf16Low, utf16High);
 
             if (dstAdvance == 0) {
-                break;
+                //4 bytes sequences and errors are processed sequencially, the rest is handled by the caller after an error
+                if (!DecodeChunkScalar(cur, last, dest)) {
+                    break;
+                }
+                continue;
             }
 
             _mm_store_si128(reinterpret_cast<__m128i*>(destAligned), utf16Low);
@@ -209,7 +355,6 @@ namespace NDetail {
             dest += dstAdvance;
         }
         //The rest will be handled sequencially.
-        // Possible improvement: go back to the vectorized processing after the error or the 4 byte sequence
     }
 
     void UTF8ToWideImplSSE41(const unsigned char*& cur, const unsigned char* last, wchar32*& dest) noexcept {
@@ -221,7 +366,11 @@ namespace NDetail {
             ui32 dstAdvance = Unpack16BytesIntoUtf16IfNoSurrogats(cur, utf16Low, utf16High);
 
             if (dstAdvance == 0) {
-                break;
+                //4 bytes sequences and errors are processed sequencially, the rest is handled by the caller after an error
+                if (!DecodeChunkScalar(cur, last, dest)) {
+                    break;
+                }
+                continue;
             }
 
             //NOTE: we only work in case without surrogat pairs, so we can make simple copying with zeroes in 2 high bytes
@@ -239,7 +388,48 @@ namespace NDetail {
             dest += dstAdvance;
         }
         //The rest will be handled sequencially.
-        // Possible improvement: go back to the vectorized processing after the error or the 4 byte sequence
+    }
+
+    void WideToUTF8ImplSSE41(const wchar16*& cur, const wchar16* last, unsigned char*& dest) noexcept {
+        while (cur + 8 <= last) {
+            __m128i units = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur));
+            ui32 dstAdvance = Pack8Utf16UnitsIntoUtf8(units, dest);
+
+            if (dstAdvance == 0) {
+                if (!EncodeChunkScalar(cur, last, dest)) {
+                    break;
+                }
+                continue;
+            }
+
+            cur += 8;
+            dest += dstAdvance;
+        }
+        //The rest will be handled sequencially.
+    }
+
+    void WideToUTF8ImplSSE41(const wchar32*& cur, const wchar32* last, unsigned char*& dest) noexcept {
+        while (cur + 8 <= last) {
+            __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur));
+            __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur) + 1);
+            ui32 dstAdvance = 0;
+
+            //symbols out of BMP are written as 4 bytes, their utf16 units aren't used
+            if (_mm_testz_si128(_mm_or_si128(low, high), _mm_set1_epi32((int)0xffff0000))) {
+                dstAdvance = Pack8Utf16UnitsIntoUtf8(_mm_packus_epi32(low, high), dest);
+            }
+
+            if (dstAdvance == 0) {
+                if (!EncodeChunkScalar(cur, last, dest)) {
+                    break;
+                }
+                continue;
+            }
+
+            cur += 8;
+            dest += dstAdvance;
+        }
+        //The rest will be handled sequencially.
     }
 }
 
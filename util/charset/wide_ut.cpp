@@ -173,6 +173,8 @@ private:
     UNIT_TEST(TestWriteUTF8Char);
     UNIT_TEST(TestUTF8ToWide);
     UNIT_TEST(TestWideToUTF8);
+    UNIT_TEST(TestUTF8ToWideLongText);
+    UNIT_TEST(TestWideToUTF8LongText);
     UNIT_TEST(TestGetNumOfUTF8Chars);
     UNIT_TEST(TestSubstrUTF8);
     UNIT_TEST(TestUnicodeCase);
@@ -192,6 +194,8 @@ public:
     void TestWriteUTF8Char();
     void TestUTF8ToWide();
     void TestWideToUTF8();
+    void TestUTF8ToWideLongText();
+    void TestWideToUTF8LongText();
     void TestGetNumOfUTF8Chars();
     void TestSubstrUTF8();
     void TestUnicodeCase();
@@ -529,6 +533,83 @@ void TConversionTest::TestWideToUTF8() {
     }
 }
 
+// texts longer than a vector register with every kind of symbols at every position
+void TConversionTest::TestUTF8ToWideLongText() {
+    const TStringBuf surrogate = "\xED\xA0\x80";
+    const TStringBuf symbols[] = {"a", "\xD0\xAF", "\xE4\xB8\xAD", "\xF0\x9F\x98\x80", surrogate};
+    const TStringBuf brokenSymbols[] = {"\xE0\x80\x80", "\xE0\x9F\xBF", "\xC0\x80", "\x80", "\xF4\x90\x80\x80", "\xE4\xB8", "\xD0\xC1", "\xED\xC1\xBF", TStringBuf("\xE4\xB8\0", 3)};
+    for (const auto& filler : symbols) {
+        for (const auto& symbol : symbols) {
+            for (size_t pos = 0; pos < 20; ++pos) {
+                TString text;
+                TUtf16String expected;
+                for (size_t i = 0; i < 20; ++i) {
+                    text += i == pos ? symbol : filler;
+                    expected += UTF8ToWide(i == pos ? symbol : filler);
+                }
+                UNIT_ASSERT(UTF8ToWide(text) == expected);
+                // encoded surrogates are decoded, but a lone surrogate is encoded as a broken rune
+                if (filler != surrogate && symbol != surrogate) {
+                    UNIT_ASSERT(WideToUTF8(expected) == text);
+                }
+            }
+        }
+        for (const auto& broken : brokenSymbols) {
+            for (size_t pos = 0; pos < 20; ++pos) {
+                TString text;
+                size_t brokenPos = 0;
+                for (size_t i = 0; i < 20; ++i) {
+                    if (i == pos) {
+                        brokenPos = text.size();
+                    }
+                    text += i == pos ? broken : filler;
+                }
+                TUtf16String wide = TUtf16String::Uninitialized(text.size());
+                size_t written = 0;
+                UNIT_ASSERT_VALUES_EQUAL(UTF8ToWideImpl(text.data(), text.size(), wide.begin(), written), brokenPos);
+                UNIT_ASSERT_EXCEPTION(UTF8ToWide(text), yexception);
+                UNIT_ASSERT_VALUES_EQUAL(UTF8ToWide<true>(text).size(), UTF8ToWide(text.substr(0, brokenPos)).size() + broken.size() + UTF8ToWide(text.substr(brokenPos + broken.size())).size());
+            }
+        }
+    }
+}
+
+void TConversionTest::TestWideToUTF8LongText() {
+    const wchar32 symbols[] = {'a', 0x42F, 0x7FF, 0x800, 0x4E2D, 0xFFFD, 0xFFFF, 0x1F600, 0xD800, 0xDFFF};
+    for (wchar32 filler : symbols) {
+        for (wchar32 symbol : symbols) {
+            for (size_t pos = 0; pos < 20; ++pos) {
+                TUtf32String text32;
+                for (size_t i = 0; i < 20; ++i) {
+                    text32.push_back(i == pos ? symbol : filler);
+                }
+                TString expected;
+                for (wchar32 c : text32) {
+                    unsigned char buffer[4];
+                    size_t runeLen = 0;
+                    WriteUTF8Char(c, runeLen, buffer);
+                    expected.append(reinterpret_cast<const char*>(buffer), runeLen);
+                }
+                UNIT_ASSERT(WideToUTF8(text32) == expected);
+
+                TUtf16String text16;
+                for (wchar32 c : text32) {
+                    WriteSymbol(c, text16);
+                }
+                TString expected16;
+                const wchar16* cur = text16.data();
+                while (cur != text16.data() + text16.size()) {
+                    unsigned char buffer[4];
+                    size_t runeLen = 0;
+                    WriteUTF8Char(ReadSymbolAndAdvance(cur, text16.data() + text16.size()), runeLen, buffer);
+                    expected16.append(reinterpret_cast<const char*>(buffer), runeLen);
+                }
+                UNIT_ASSERT(WideToUTF8(text16) == expected16);
+            }
+        }
+    }
+}
+
 void TConversionTest::TestGetNumOfUTF8Chars() {
     size_t n = 0;
     bool result = GetNumberOfUTF8Chars(UTF8Text.c_str(), UTF8Text.size(), n);
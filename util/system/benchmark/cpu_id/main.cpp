@@ -39,6 +39,7 @@ DEFINE_BENCHMARK_PAIR(AVX512CD)
 DEFINE_BENCHMARK_PAIR(AVX512BW)
 DEFINE_BENCHMARK_PAIR(AVX512VL)
 DEFINE_BENCHMARK_PAIR(AVX512VBMI)
+DEFINE_BENCHMARK_PAIR(AVX512VNNI)
 DEFINE_BENCHMARK_PAIR(PREFETCHWT1)
 DEFINE_BENCHMARK_PAIR(SHA)
 DEFINE_BENCHMARK_PAIR(ADX)
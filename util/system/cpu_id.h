@@ -29,6 +29,7 @@
     F(AVX512BW)               \
     F(AVX512VL)               \
     F(AVX512VBMI)             \
+    F(AVX512VNNI)             \
     F(PREFETCHWT1)            \
     F(SHA)                    \
     F(ADX)                    \
@@ -59,6 +60,7 @@
     F(AVX512BW)               \
     F(AVX512VL)               \
     F(AVX512VBMI)             \
+    F(AVX512VNNI)             \
     F(PREFETCHWT1)            \
     F(SHA)                    \
     F(ADX)                    \
@@ -37,6 +37,7 @@ static void ExecuteAVX512CDInstruction();
 static void ExecuteAVX512BWInstruction();
 static void ExecuteAVX512VLInstruction();
 static void ExecuteAVX512VBMIInstruction();
+static void ExecuteAVX512VNNIInstruction();
 static void ExecutePREFETCHWT1Instruction();
 static void ExecuteSHAInstruction();
 static void ExecuteADXInstruction();
@@ -217,6 +218,9 @@ void ExecuteAVX512VLInstruction() {
 void ExecuteAVX512VBMIInstruction() {
 }
 
+void ExecuteAVX512VNNIInstruction() {
+}
+
 void ExecutePREFETCHWT1Instruction() {
 }
 
@@ -327,6 +331,9 @@ void ExecuteAVX512VLInstruction() {
 void ExecuteAVX512VBMIInstruction() {
 }
 
+void ExecuteAVX512VNNIInstruction() {
+}
+
 void ExecutePREFETCHWT1Instruction() {
 }
 
@@ -424,6 +431,9 @@ void ExecuteAVX512VLInstruction() {
 void ExecuteAVX512VBMIInstruction() {
 }
 
+void ExecuteAVX512VNNIInstruction() {
+}
+
 void ExecutePREFETCHWT1Instruction() {
 }
 